@@ -123,6 +123,15 @@
 #define  QUADSPI_BK1_IO3_AF                     GPIO_AF9_QUADSPI
 #define  GPIO_QUADSPI_BK1_IO3_ENABLE            __HAL_RCC_GPIOF_CLK_ENABLE()
 
+/* QSPI 间接读 MDMA（FIFO 阈值触发） */
+#define  QUADSPI_MDMA_INSTANCE                  MDMA_Channel0
+#define  QUADSPI_MDMA_IRQn_PRIO                 6u
+#define  QUADSPI_IRQn_PRIO                      6u
+
+/* QSPI 地址段 MPU：BANK 覆盖 0x90000000 起 256MB 禁止访问，WINDOW 为 8MB 映射窗口（编号大的覆盖编号小的） */
+#define  QUADSPI_MPU_REGION_BANK                MPU_REGION_NUMBER1
+#define  QUADSPI_MPU_REGION_WINDOW              MPU_REGION_NUMBER2
+
 /* ================= SPI LCD (ST7789) ================= */
 #define ST7789_WIDTH                            320u
 #define ST7789_HEIGHT                           172u
@@ -158,6 +167,17 @@
 #define SPIST7789_BL_TIM_AF                     GPIO_AF2_TIM12
 
 #define SPIST7789_DMA_CHUNK_BYTES               1024u
+#define ST7789_DIRTY_MAX_RECTS                  8u          // 帧缓冲脏区矩形数量上限
+#define ST7789_DIRTY_WINDOW_COST_PX             64u         // 每个刷新窗口的固定开销（窗口命令 + DMA 启动）折算成的像素数，合并矩形的判断依据
+#define ST7789_GIF_DECODE_ROWS_PER_SLICE        16u         // GIF 播放器每次主循环最多解码的行数
+#define ST7789_GIF_CACHE_BYTES                  65536u      // GIF 已解码帧缓存（AXI SRAM），整段动画放得下时后续循环直接拷贝，0 表示关闭
+#define ST7789_GIF_CACHE_MAX_FRAMES             32u         // GIF 帧缓存最多帧数
+#define ST7789_FONT_CACHE_BYTES                 16384u      // 字形缓存：与背景色预混合好的 RGB565 像素
+#define ST7789_FONT_CACHE_SLOTS                 128u        // 字形缓存槽位数，必须是 2 的幂
+#define ST7789_FONT_MAX_LINE_GLYPHS             96u         // 单行文本最多绘制的字形数
+#define ST7789_DMA2D_ENABLE                     1u          // 位图、资源图与 GIF 帧拷贝交给 DMA2D，0 表示全部由 CPU 完成
+#define ST7789_DMA2D_MIN_PIXELS                 4096u       // 位图 / 资源图面积达到此值才交给 DMA2D：整块计入脏区，不再逐像素比较
+#define SPIST7789_FLUSH_MAX_DMA_BYTES           65280u      // 帧缓冲刷新单次 DMA 的最大字节数（SPI TSIZE / DMA NDTR 上限为 65535，取整行）
 #define SPIST7789_Y_OFFSET                      34u
 
 /* ================= WS2812B LEDs (TIM4 PWM + DMA) ================= */
@@ -248,6 +268,9 @@
 
 // 用户配置区固定地址（独立于槽，两个槽共享）
 #define CONFIG_ADDR                         0x90590000      // 用户配置区固定地址
+#ifndef CONFIG_STORE_SIZE
+#define CONFIG_STORE_SIZE                   0x00010000      // 64KB：16 个扇区组成的配置日志
+#endif
 
 // 日志/资源区（独立于槽，两个槽共享）
 #ifndef LOG_STORAGE_ADDR
@@ -268,7 +291,13 @@
 #define USER_IMAGE_RESOURCES_ADDR           0x905F0000
 #endif
 #ifndef USER_IMAGE_RESOURCES_SIZE
-#define USER_IMAGE_RESOURCES_SIZE           0x00210000      // 2.0625MB
+#define USER_IMAGE_RESOURCES_SIZE           0x00200000      // 2MB
+#endif
+
+// 文件系统（自定义灯效等用户内容），由几段空闲扇区拼成，{ 映射地址, 长度 }，均按 4KB 对齐
+// 0x90560000：bootloader 侧预留的用户配置区，两边都没有使用；0x907F0000：用户图片区之后的 64KB
+#ifndef FLASH_FS_REGIONS
+#define FLASH_FS_REGIONS                    { { 0x90560000, 0x00010000 }, { 0x907F0000, 0x00010000 } }
 #endif
 
 
@@ -401,6 +430,21 @@ uint32_t get_current_slot_base_address(void);
 #define LEDS_BRIGHTNESS_RATIO       0.8             //默认led 亮度系数 会以实际亮度乘以这个系数
 #define LEDS_ANIMATION_CYCLE        10000            //LED 动画长度 ms
 #define LEDS_ANIMATION_INTERVAL         16          //LED 动画间隔，影响性能和效果 ms
+#define LEDS_RIPPLE_POOL_SIZE           32          //涟漪效果：同时存在的涟漪数量上限，超出时替换最老的涟漪
+#define LEDS_RIPPLE_WIDTH               80          //涟漪效果：环带半宽，单位与 HITBOX_LED_POS_LIST 坐标一致
+#define LEDS_REACTIVE_FADE_MS           0           //按键反馈图层：新建配置文件的余辉渐隐时长 ms，0 表示关闭，保持原有灯效外观；可在网页端按配置文件调整
+#define LEDS_REACTIVE_FADE_MAX_MS       1000        //按键反馈图层：余辉渐隐时长上限 ms
+#define LEDS_NOTIFY_PROFILE_SWITCH_MS   600         //通知图层：切换配置提示时长 ms
+#define LEDS_NOTIFY_LOW_LATENCY_MS      1500        //通知图层：低延迟模式警告时长 ms
+#define LEDS_NOTIFY_WARNING_COLOR       0xFF8000    //通知图层：警告颜色
+#define LEDS_STREAM_TIMEOUT_MS          1000        //灯光流：超过该时长未收到帧则退出流模式，恢复本地灯效 ms
+#define LEDS_STREAM_MIN_INTERVAL_MS     8           //灯光流：两帧之间的最小间隔，更密集的帧被丢弃并要求重发关键帧 ms
+#define LEDS_STREAM_MAX_PACKET_SIZE     (8 + NUM_LED * 5)  //灯光流：单个数据包最大长度，超出则拒绝解码
+#define LEDS_VM_MAX_CODE_SIZE           1024        //自定义灯效：字节码最大长度
+#define LEDS_VM_MAX_STEPS_PER_LED       128         //自定义灯效：单个 LED 的指令预算上限
+#define LEDS_VM_FRAME_BUDGET            4096        //自定义灯效：每帧全部 LED 的指令预算，超出则本帧保持上一帧
+#define LEDS_VM_MAX_OVERRUN_FRAMES      30          //自定义灯效：超预算的帧累计到该数量后程序失效，每个正常帧抵消一次
+#define LED_PROGRAM_MAX_SLOTS           8           //自定义灯效：QSPI 中可保存的程序数量
 
 #define WEBCONFIG_BUTTON_PERFORMANCE_MONITORING_INTERVAL_MS 100 // 按键性能监控间隔 ms
 
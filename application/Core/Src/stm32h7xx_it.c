@@ -29,6 +29,7 @@
 #include "rotary-encoder.h"
 #include "st7789.h"
 #include "spi-st7789.h"
+#include "qspi-w25q64.h"
 #include <stdio.h>
 /* USER CODE END Includes */
 
@@ -406,6 +407,16 @@ void SPI5_IRQHandler(void)
   SPIST7789_SPI_IRQHandler();
 }
 
+void QUADSPI_IRQHandler(void)
+{
+  QSPI_W25Qxx_IRQHandler();
+}
+
+void MDMA_IRQHandler(void)
+{
+  QSPI_W25Qxx_MDMA_IRQHandler();
+}
+
 /**
   * @brief This function handles EXTI line[9:5] interrupts.
   */
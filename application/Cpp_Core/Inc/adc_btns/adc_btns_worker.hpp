@@ -12,6 +12,7 @@
 #include "adc_manager.hpp"
 #include "micro_timer.hpp"
 #include "board_cfg.h"
+#include "profile_runtime.hpp"
 
 #define NUM_MAPPING_INDEX_WINDOW_SIZE 32
 
@@ -60,12 +61,12 @@ struct ADCBtn {
     bool initCompleted;  // 初始化完成标志
 
     // 新的基于距离和ADC值的字段
-    float pressAccuracyMm = 0.0f;        // 按下精度（mm）
-    float releaseAccuracyMm = 0.0f;      // 释放精度（mm）
-    float highPrecisionReleaseAccuracyMm = 0.0f; // 高精度释放精度（mm）
-    float topDeadzoneMm = 0.0f;          // 顶部死区（mm）
-    float bottomDeadzoneMm = 0.0f;       // 底部死区（mm）
-    float halfwayDistanceMm = 0.0f;      // 中点距离（mm），用于高精度判断
+    int32_t pressAccuracyUm = 0;         // 按下精度（微米）
+    int32_t releaseAccuracyUm = 0;       // 释放精度（微米）
+    int32_t highPrecisionReleaseAccuracyUm = 0; // 高精度释放精度（微米）
+    int32_t topDeadzoneUm = 0;           // 顶部死区（微米）
+    int32_t bottomDeadzoneUm = 0;        // 底部死区（微米）
+    int32_t halfwayDistanceUm = 0;       // 中点距离（微米），用于高精度判断
 
     uint16_t currentValue = 0;      // 当前值
     uint16_t pressStartValue = 0;  // 按下开始值
@@ -162,8 +163,8 @@ class ADCBtnsWorker {
         void initButtonMapping(ADCBtn* btn, const uint16_t releaseValue);
 
         
-        float getCurrentPressAccuracy(ADCBtn* btn, const float currentDistance);
-        float getCurrentReleaseAccuracy(ADCBtn* btn, const float currentDistance);
+        int32_t getCurrentPressAccuracyUm(ADCBtn* btn, const int32_t currentDistanceUm);
+        int32_t getCurrentReleaseAccuracyUm(ADCBtn* btn, const int32_t currentDistanceUm);
         void updateLimitValue(ADCBtn* btn, const uint16_t currentValue);
         void resetLimitValue(ADCBtn* btn, const uint16_t currentValue);
 
@@ -189,6 +190,13 @@ class ADCBtnsWorker {
          */
         void calculateThresholdMapping(ADCBtn* btn);
 
+        /**
+         * 应用配置文件镜像里的启用按键和触发参数
+         * @param runtime 配置文件镜像
+         * @param rebuildThresholds 是否为已初始化的按键重新计算阈值映射表
+         */
+        void applyRuntime(const ProfileRuntime& runtime, bool rebuildThresholds);
+
         /**
          * 根据ADC值获取插值计算的按下阈值
          * @param btn 按钮指针
@@ -220,6 +228,9 @@ class ADCBtnsWorker {
         uint16_t minValueDiff;                      // 最小值差值
         uint32_t enabledKeysMask = 0x0;             // 启用按键掩码
         float maxTravelDistance;                    // 最大行程距离
+        int32_t stepUm = 0;                         // 映射步长（微米）
+        int32_t maxTravelUm = 0;                    // 最大行程距离（微米）
+        uint32_t appliedRuntimeCrc = 0;             // 已应用的配置文件镜像
         
         
         // virtualPin到buttonIndex的映射表
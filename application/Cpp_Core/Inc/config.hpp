@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <string.h>
+#include <stddef.h>
 #include <map>
 #include "enums.hpp"
 #include "stm32h750xx.h"
@@ -107,8 +108,22 @@ typedef struct
     uint32_t aroundLedColor3;    // 0x000000-0xFFFFFF
     uint8_t aroundLedBrightness; // 0-100
     uint8_t aroundLedAnimationSpeed; // 1-5
+
+    uint16_t ledReactiveFadeMs;  // 按键释放后余辉渐隐时长 ms，0 关闭
 } LEDProfile;
 
+/**
+ * 配置文件的名片：列表、屏幕和按 ID 查找只用到这几项，常驻 Config；
+ * 完整的 GamepadProfile 由 Storage 按需从 flash 读入。两者开头的布局必须一致
+ */
+typedef struct
+{
+    char id[16];
+    char name[24];
+    bool enabled;
+    bool isCompetitionProfile;
+} GamepadProfileHeader;
+
 typedef struct
 {
     char id[16];
@@ -120,6 +135,12 @@ typedef struct
     LEDProfile ledsConfigs;
 } GamepadProfile;
 
+static_assert(offsetof(GamepadProfile, id) == offsetof(GamepadProfileHeader, id)
+    && offsetof(GamepadProfile, name) == offsetof(GamepadProfileHeader, name)
+    && offsetof(GamepadProfile, enabled) == offsetof(GamepadProfileHeader, enabled)
+    && offsetof(GamepadProfile, isCompetitionProfile) == offsetof(GamepadProfileHeader, isCompetitionProfile),
+    "GamepadProfile must start with GamepadProfileHeader");
+
 #define SCREEN_FEATURE_INPUT_MODE_SWITCH          (1u << 0)
 #define SCREEN_FEATURE_PROFILES_SWITCH            (1u << 1)
 #define SCREEN_FEATURE_SOCD_MODE_SWITCH           (1u << 2)
@@ -132,13 +153,15 @@ typedef struct
 #define SCREEN_FEATURE_WEB_CONFIG_ENTRY           (1u << 9)
 #define SCREEN_FEATURE_CALIBRATION_MODE_SWITCH    (1u << 10)
 #define SCREEN_FEATURE_BUTTONS_PERFORMANCE_QUICK_SET (1u << 11)
-#define SCREEN_FEATURE_COUNT                      12u
+#define SCREEN_FEATURE_INPUT_MONITOR              (1u << 12)
+#define SCREEN_FEATURE_COUNT                      13u
 
 typedef struct
 {
     uint8_t brightness;              // 屏幕亮度（0-100）
     uint8_t standbyDisplay;          // 待机显示：0 None, 1 BackgroundImage, 2 ButtonLayout
-    uint8_t reserved0[2];            // 保留字节（对齐）
+    uint8_t tournamentScreenOff;     // 比赛配置文件游戏中关闭屏幕（熄灭背光且不再刷新，旋钮唤醒）
+    uint8_t reserved0[1];            // 保留字节（对齐）
     uint32_t backgroundColor;        // 背景颜色（RGB888：0x000000-0xFFFFFF）
     uint32_t textColor;              // 文字颜色（RGB888：0x000000-0xFFFFFF）
     char backgroundImageId[32];      // 背景图片资源ID（对应 assets 索引名）
@@ -156,19 +179,42 @@ typedef struct
     InputMode inputMode;
     char defaultProfileId[16];
     uint8_t numProfilesMax;
-    GamepadProfile profiles[NUM_PROFILES];
+    GamepadProfileHeader profiles[NUM_PROFILES];     // 完整内容见 Storage::getProfileAt
+    uint8_t profileSlots[NUM_PROFILES];              // 第 i 个配置文件存放在配置日志的第几组分区，整理顺序时只改这张表
     GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
     bool autoCalibrationEnabled;
     uint8_t reserved0[3];
     ScreenControlConfig screenControl;
 } Config;
 
+/**
+ * 配置分区：修改配置时标记涉及的分区，保存时只比较、写入这些分区覆盖的存储块
+ */
+typedef uint64_t ConfigSectionMask;
+
+#define CONFIG_SECTION_GLOBAL           ((ConfigSectionMask)1u << 0)    // 版本、启动 / 输入模式、默认配置文件、自动校准
+#define CONFIG_SECTION_HOTKEYS          ((ConfigSectionMask)1u << 1)
+#define CONFIG_SECTION_SCREEN           ((ConfigSectionMask)1u << 2)
+#define CONFIG_SECTION_PROFILE(i)       ((ConfigSectionMask)1u << (8 + (i)))                    // 配置文件中灯效以外的部分
+#define CONFIG_SECTION_PROFILE_LEDS(i)  ((ConfigSectionMask)1u << (8 + NUM_PROFILES + (i)))     // 配置文件的灯效
+#define CONFIG_SECTION_ALL              (~(ConfigSectionMask)0)
+
+static_assert(8 + 2 * NUM_PROFILES <= 64, "ConfigSectionMask has no room for all profiles");
+
 namespace ConfigUtils {
     bool load(Config& config);
-    bool save(Config& config);
+    /**
+     * @brief 保存 sections 标记的分区
+     * @param profiles 按下标排列的完整配置文件，为 nullptr 或某项为 nullptr 时跳过对应配置文件的分区（flash 里已是最新）
+     */
+    bool save(Config& config, GamepadProfile* const* profiles, ConfigSectionMask sections = CONFIG_SECTION_ALL);
     bool reset(Config& config);
     bool fromStorage(Config& config);
     void makeDefaultProfile(GamepadProfile& profile, const char* id, bool isEnabled);
+    void makeDefaultProfileAt(GamepadProfile& profile, uint8_t index);
+    void makeDefaultScreenControl(ScreenControlConfig& screen);
+    void makeDefaultHotkeys(GamepadHotkeyEntry* hotkeys);
+    void makeDefaultConfig(Config& config);
 
     // JSON serialization/deserialization
     cJSON* toJSON(Config& config);
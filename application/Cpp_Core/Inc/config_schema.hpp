@@ -0,0 +1,59 @@
+#ifndef _CONFIG_SCHEMA_HPP_
+#define _CONFIG_SCHEMA_HPP_
+
+#include <stdint.h>
+#include "config.hpp"
+
+/**
+ * 配置的带标签二进制格式
+ *
+ * 配置按分区（CONFIG_SECTION_*）各自编码。分区编码 = 4 字节分区头（格式版本、分区编号、正文长度）
+ * + 若干字段记录：标签(1) + 元素下标(1) + 长度(1~2) + 数据。数组按元素记录，和默认值完全相同的元素不写出，
+ * 其余写出完整数据；读取时先填默认值，再把记录覆盖上去。
+ *
+ * 兼容规则：
+ *  - 标签一经使用不再改作他用，删除字段只删表项，标签留空；
+ *  - 读到不认识的标签或超出数组长度的下标直接跳过（新格式降级到旧固件）；
+ *  - 缺少的字段保持默认值，字段变长时旧数据作为前缀、其余为默认值（旧格式升级到新固件）；
+ *  - 字段含义变化时提高 CONFIG_SCHEMA_VERSION，并在迁移表里加一步；
+ *  - 省略的字段取决于默认值，改动 ConfigUtils::makeDefault* 的默认值时提高 CONFIG_SCHEMA_DEFAULTS_VERSION，
+ *    并在默认值回退表里加一步。格式标记记录日志按哪一版默认值编码，读到旧版本时按当时的默认值解码后整份重写。
+ *
+ * 分区编码按 CONFIG_STORE_PAYLOAD_SIZE 切成若干部分存进配置日志，每个分区占一段固定的键，
+ * 段长按所有字段都不是默认值估算。键 0 是格式标记，没有它的日志是旧的整块格式。
+ *
+ * 配置文件的分区按存放位置（分区组）编号，第 i 个配置文件在哪一组由全局分区里的 Config::profileSlots 决定；
+ * 整理顺序只改这张表，不搬动配置文件的内容。分区的默认值也按分区组取。
+ */
+
+#define CONFIG_SCHEMA_VERSION           1
+#define CONFIG_SCHEMA_DEFAULTS_VERSION  1
+#define CONFIG_SCHEMA_MAGIC             0x53474643      // "CFGS"
+
+namespace ConfigSchema {
+    /**
+     * @brief 配置日志里是否是本格式（有格式标记）
+     */
+    bool isPresent();
+
+    /**
+     * @brief 把日志里的全局、快捷键、屏幕分区叠加到 config 上，各配置文件只读名片（config.profiles）
+     * config 应已填好默认值；缺少或损坏的分区保持默认值，存储的分区版本较旧时按迁移表升级
+     * @return 本格式且至少读到一个分区
+     */
+    bool load(Config& config);
+
+    /**
+     * @brief 读出第 slot 组分区里的配置文件（slot 取 Config::profileSlots[下标]）：先填默认值，再叠加两个分区
+     * @return 日志中至少有它的一个分区
+     */
+    bool loadProfile(uint8_t slot, GamepadProfile& profile);
+
+    /**
+     * @brief 编码 sections 标记的分区，只写和日志中不同的部分
+     * sections、profiles 都按配置文件的下标，写入 config.profileSlots 对应的分区组；为 nullptr 的配置文件跳过；日志里还没有格式标记时随第一批记录一起写入
+     */
+    bool save(const Config& config, const GamepadProfile* const* profiles, ConfigSectionMask sections);
+};
+
+#endif // _CONFIG_SCHEMA_HPP_
@@ -0,0 +1,158 @@
+#ifndef _CONFIG_STORE_HPP_
+#define _CONFIG_STORE_HPP_
+
+#include <stdint.h>
+#include "board_cfg.h"
+#include "qspi-w25q64.h"
+
+/**
+ * 配置日志存储（CONFIG_ADDR 起 CONFIG_STORE_SIZE 字节）
+ *
+ * 区域按 4KB 扇区组成环形日志。每个扇区第一页是扇区头（魔数、扇区序号、擦除次数、CRC），
+ * 其余每页保存一条记录：20 字节记录头（键、全局序号、事务号、长度、标志、CRC）+ 最多
+ * CONFIG_STORE_PAYLOAD_SIZE 字节数据。记录只追加，同一个键的新记录覆盖旧记录。
+ *
+ * 事务：同一事务的记录带相同的事务号（首条记录的序号），commit() 写入带 COMMIT 标志的
+ * 最后一条记录时整个事务才生效。挂载时没有等到 COMMIT 的事务（掉电中断的保存）整体丢弃，
+ * CRC 不对的页跳过。
+ *
+ * 空间回收：始终保留 CONFIG_STORE_RESERVE_SECTORS 个空扇区给整理使用。整理把旧扇区中
+ * 仍然有效的记录搬到日志头部后擦除该扇区；平时由 service() 在主循环空闲时逐步进行，
+ * 保存时空间不够才同步整理。擦除含 COMMIT 记录的扇区前，同一事务中确认标记没写成功的
+ * 记录也一并搬走，否则下次挂载时它们找不到 COMMIT 而被丢弃。
+ *
+ * 擦写经 FlashWriter 后台队列按顺序执行，函数返回时数据可能还在队列里，读取会叠加上尚未执行的擦写。
+ * 掉电只会丢掉队列末尾的记录，与同步写入时在同一位置断电的结果相同。
+ */
+
+#define CONFIG_STORE_SECTOR_MAGIC       0x4C474643      // "CFGL"
+#define CONFIG_STORE_RECORD_MAGIC       0x5243          // "CR"
+#define CONFIG_STORE_SECTORS            (CONFIG_STORE_SIZE / W25Qxx_SECTOR_SIZE)
+#define CONFIG_STORE_PAGES_PER_SECTOR   (W25Qxx_SECTOR_SIZE / W25Qxx_PageSize)
+#define CONFIG_STORE_RECORDS_PER_SECTOR (CONFIG_STORE_PAGES_PER_SECTOR - 1)
+#define CONFIG_STORE_RECORD_HEADER_SIZE 20
+#define CONFIG_STORE_PAYLOAD_SIZE       (W25Qxx_PageSize - CONFIG_STORE_RECORD_HEADER_SIZE)
+#define CONFIG_STORE_MAX_KEYS           256
+#define CONFIG_STORE_RESERVE_SECTORS    1
+#define CONFIG_STORE_FLAG_COMMIT        0x01
+#define CONFIG_STORE_NO_PAGE            0xFFFF
+#define CONFIG_STORE_NO_SECTOR          0xFF
+
+class ConfigStore {
+    public:
+        ConfigStore(ConfigStore const&) = delete;
+        void operator=(ConfigStore const&) = delete;
+        static ConfigStore& getInstance() {
+            static ConfigStore instance;
+            return instance;
+        }
+
+        /**
+         * @brief 扫描日志重建索引
+         * @return 区域内有合法的日志扇区；全新或旧格式的区域返回 false，需要 format() 后再写
+         */
+        bool mount();
+        bool isMounted() const { return mounted; }
+
+        /**
+         * @brief 擦除整个区域并建立空日志
+         */
+        bool format();
+
+        /**
+         * @brief 读取键的当前值
+         * @return 键存在且长度一致
+         */
+        bool read(uint16_t key, void* out, uint16_t len);
+
+        /**
+         * @brief 读取长度可变的键，outLen 返回实际长度
+         * @return 键存在且长度不超过 maxLen
+         */
+        bool read(uint16_t key, void* out, uint16_t maxLen, uint16_t* outLen);
+
+        /**
+         * @brief 键的当前值是否与 data 完全一致，用于跳过没有变化的记录
+         */
+        bool matches(uint16_t key, const void* data, uint16_t len);
+
+        /**
+         * @brief 为接下来的一次事务腾出空间，必要时同步整理
+         * @return 当前可以在一次事务里写入的记录数，可能小于 records
+         */
+        uint16_t reserve(uint16_t records);
+
+        bool begin();
+        bool write(uint16_t key, const void* data, uint16_t len);
+        bool commit();
+
+        /**
+         * @brief 主循环调用：空闲一段时间、后台队列清空后每次最多排一步整理（擦一个扇区或搬一条记录）
+         */
+        void service();
+
+        uint16_t getFreeRecords() const;
+        uint32_t getMaxEraseCount() const;
+
+    private:
+        ConfigStore() {}
+
+        enum SectorState : uint8_t {
+            SECTOR_DIRTY = 0,   // 没有合法扇区头，使用前需要擦除
+            SECTOR_ERASED,      // 已擦除，可以直接作为日志头部
+            SECTOR_USED,        // 已写满或曾经作为日志头部
+            SECTOR_HEAD,        // 当前追加位置
+        };
+
+        struct SectorInfo {
+            uint32_t seq;
+            uint32_t eraseCount;
+            SectorState state;
+        };
+
+        static uint32_t sectorAddress(uint8_t sector) {
+            return CONFIG_ADDR + (uint32_t)sector * W25Qxx_SECTOR_SIZE;
+        }
+        static uint32_t pageAddress(uint16_t page) {
+            return CONFIG_ADDR + (uint32_t)page * W25Qxx_PageSize;
+        }
+
+        bool eraseSector(uint8_t sector);
+        bool openHead();
+        bool appendRecord(uint16_t key, const uint8_t* data, uint16_t len, uint32_t txn, uint8_t flags, uint16_t* outPage);
+        bool flushHeld(uint8_t flags);
+        void abortTxn();
+        bool moveRecord(uint16_t key);
+        bool moveOneRecord(uint8_t sector);
+        int16_t unconfirmedRecord(uint8_t sector);
+        bool collectVictim(uint8_t sector);
+        int8_t pickVictim(bool forSpace) const;
+        uint8_t countSectors(SectorState state) const;
+        uint16_t liveRecords(uint8_t sector) const;
+
+        bool mounted = false;
+        bool txnOpen = false;
+        bool held = false;              // write() 的最后一条记录先留在内存里，commit() 时带 COMMIT 标志写出
+        uint16_t heldKey = 0;
+        uint16_t heldLen = 0;
+        uint32_t txnId = 0;
+        int8_t gcVictim = -1;           // 正在整理的扇区
+        uint8_t head = 0;
+        uint8_t headNext = CONFIG_STORE_PAGES_PER_SECTOR;   // 头部扇区中下一条记录的页号
+        uint32_t nextSectorSeq = 1;
+        uint32_t nextRecordSeq = 1;
+        uint32_t lastWriteMs = 0;
+        SectorInfo sectors[CONFIG_STORE_SECTORS];
+        uint16_t index[CONFIG_STORE_MAX_KEYS];      // 键 -> 全局页号
+        uint16_t pending[CONFIG_STORE_MAX_KEYS];    // 未提交事务中的键 -> 全局页号
+        uint8_t commitSector[CONFIG_STORE_MAX_KEYS];  // 键的当前记录靠后补的确认标记生效时，其 COMMIT 记录所在扇区
+};
+
+static_assert(CONFIG_STORE_SIZE % W25Qxx_SECTOR_SIZE == 0, "CONFIG_STORE_SIZE must be a whole number of sectors");
+static_assert(CONFIG_STORE_SECTORS * CONFIG_STORE_PAGES_PER_SECTOR < CONFIG_STORE_NO_PAGE, "config store page index overflow");
+static_assert(CONFIG_STORE_SECTORS < CONFIG_STORE_NO_SECTOR, "config store sector index overflow");
+static_assert(CONFIG_STORE_SECTORS > CONFIG_STORE_RESERVE_SECTORS + 1, "config store needs more sectors than the reserve");
+
+#define CONFIG_STORE ConfigStore::getInstance()
+
+#endif // _CONFIG_STORE_HPP_
@@ -54,6 +54,7 @@ private:
     LEDProfile previewConfig;   // 预览配置
     uint32_t lastButtonMask;    // 上次按键状态，用于动画更新
     uint32_t enabledKeysMask;   // 启用按键掩码，控制只有启用的按键才点亮
+    bool streamActive;          // 上次更新时是否处于灯光流模式
 }; 
 
 #define WEBCONFIG_LEDS_MANAGER WebConfigLedsManager::getInstance()
\ No newline at end of file
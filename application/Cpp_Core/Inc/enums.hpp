@@ -68,7 +68,8 @@ enum LEDEffect
     FLOWING             = 3,        //流光
     RIPPLE              = 4,        //涟漪
     TRANSFORM           = 5,        //变换
-    NUM_EFFECTS         = 6,        //效果总数
+    CUSTOM              = 6,        //自定义（字节码程序）
+    NUM_EFFECTS         = 7,        //效果总数
 };
 
 enum AroundLEDEffect
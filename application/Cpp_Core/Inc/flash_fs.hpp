@@ -0,0 +1,180 @@
+#ifndef _FLASH_FS_HPP_
+#define _FLASH_FS_HPP_
+
+#include <stdint.h>
+#include "board_cfg.h"
+
+/**
+ * QSPI flash 上的小型文件系统
+ *
+ * 由 FLASH_FS_REGIONS 列出的几段空闲扇区拼成，每个 4KB 扇区是一块。块头记录擦除次数，
+ * 分配时写入文件名、版本号和块序号，数据紧随其后；一个文件占一块或多块，块之间不要求连续。
+ *
+ * 写文件总是写一个新版本：beginWrite/write 把数据写进新分配的块，commit() 等数据落盘后
+ * 在第 0 块写入长度和块数，这一下写入就是替换的提交点。挂载时每个文件名取版本号最大、
+ * 块齐全的已提交版本；掉电时没提交的新版本被丢弃，旧版本原样保留。删除在第 0 块上打标记。
+ *
+ * 不再使用的块在分配时才擦除。分配取擦除次数最少的块（动态磨损均衡）；长期不动的文件
+ * 占着擦除次数低的块时，擦除次数差超过 FLASH_FS_WEAR_LEVEL_DELTA 就把它搬到别处（静态磨损均衡）。
+ *
+ * 读写都经过 FlashWriter，读到的内容包含队列里还没执行的擦写；commit()/remove() 返回前等写入完成。
+ */
+
+#ifndef FLASH_FS_NAME_LEN
+#define FLASH_FS_NAME_LEN               24      // 含结尾 '\0'
+#endif
+
+#ifndef FLASH_FS_WEAR_LEVEL_DELTA
+#define FLASH_FS_WEAR_LEVEL_DELTA       32
+#endif
+
+#define FLASH_FS_MAGIC                  0x31534646      // "FFS1"
+#define FLASH_FS_BLOCK_SIZE             0x1000
+#define FLASH_FS_HEADER_SIZE            64
+#define FLASH_FS_BLOCK_PAYLOAD          (FLASH_FS_BLOCK_SIZE - FLASH_FS_HEADER_SIZE)
+
+struct FlashFsRegion {
+    uint32_t addr;
+    uint32_t size;
+};
+
+namespace FlashFsLayout {
+    static constexpr FlashFsRegion REGIONS[] = FLASH_FS_REGIONS;
+    static constexpr uint8_t NUM_REGIONS = sizeof(REGIONS) / sizeof(REGIONS[0]);
+
+    constexpr uint16_t countBlocks() {
+        uint32_t blocks = 0;
+        for (uint8_t i = 0; i < NUM_REGIONS; i++) {
+            blocks += REGIONS[i].size / FLASH_FS_BLOCK_SIZE;
+        }
+        return (uint16_t)blocks;
+    }
+    static constexpr uint16_t NUM_BLOCKS = countBlocks();
+};
+
+static_assert(FlashFsLayout::NUM_BLOCKS >= 2, "FLASH_FS_REGIONS needs at least two sectors");
+
+/**
+ * @brief 读文件的句柄，由 open() 填写；文件被替换或删除后读取返回 0
+ */
+struct FlashFsFile {
+    uint32_t seq;
+    uint32_t size;
+    uint32_t pos;
+};
+
+class FlashFs {
+    public:
+        FlashFs(FlashFs const&) = delete;
+        void operator=(FlashFs const&) = delete;
+        static FlashFs& getInstance() {
+            static FlashFs instance;
+            return instance;
+        }
+
+        /**
+         * @brief 打开文件读取
+         * @return 文件存在
+         */
+        bool open(const char* name, FlashFsFile& file);
+
+        /**
+         * @brief 从当前位置读取，返回实际读到的字节数
+         */
+        uint32_t read(FlashFsFile& file, void* out, uint32_t len);
+
+        bool seek(FlashFsFile& file, uint32_t pos);
+
+        /**
+         * @brief 文件是否存在，size 可为空
+         */
+        bool stat(const char* name, uint32_t* size);
+
+        /**
+         * @brief 开始写 name 的新版本，之前没提交的写入被放弃
+         * 同一时间只有一个写入；commit() 之前读到的仍是旧内容
+         */
+        bool beginWrite(const char* name);
+
+        /**
+         * @brief 追加数据，空间不足时放弃整个写入并返回 false
+         */
+        bool write(const void* data, uint32_t len);
+
+        /**
+         * @brief 提交新版本，旧版本随之作废
+         */
+        bool commit();
+        void abort();
+
+        bool isWriting() const {
+            return writing;
+        }
+
+        /**
+         * @brief 一次写入整个文件
+         */
+        bool writeFile(const char* name, const void* data, uint32_t len);
+
+        bool remove(const char* name);
+
+        /**
+         * @brief 逐个列出文件
+         */
+        void list(void (*callback)(const char* name, uint32_t size, void* context), void* context);
+
+        /**
+         * @brief 可以写入新内容的字节数（替换文件时旧版本在提交前仍占用空间）
+         */
+        uint32_t freeBytes();
+
+    private:
+        FlashFs() {}
+
+        enum BlockState : uint8_t {
+            BLOCK_FREE = 0,         // 已擦除并写好块头，可直接分配
+            BLOCK_STALE,            // 不再使用，分配前要擦除
+            BLOCK_LIVE,             // 属于文件的当前版本
+            BLOCK_WRITING,          // 属于正在写入的版本
+        };
+
+        struct BlockInfo {
+            uint32_t seq;
+            uint32_t eraseCount;
+            uint32_t nameHash;
+            uint32_t size;          // 第 0 块：文件长度
+            uint16_t index;
+            uint16_t count;         // 第 0 块：提交的块数，0 表示没有提交
+            BlockState state;
+            bool removed;
+        };
+
+        bool mount();
+        static uint32_t blockAddress(uint16_t block);
+        bool programBytes(uint32_t addr, const void* data, uint32_t len);
+        bool readName(uint16_t block, char* name);
+        bool nameMatches(uint16_t block, const char* name, uint32_t hash);
+        int16_t findHead(const char* name);
+        int16_t findBlock(uint32_t seq, uint16_t index, BlockState state) const;
+        bool isComplete(uint16_t head) const;
+        void setVersionState(uint32_t seq, BlockState state);
+        int16_t allocBlock(uint16_t index);
+        void levelWear();
+
+        BlockInfo blocks[FlashFsLayout::NUM_BLOCKS];
+        bool mounted = false;
+        uint32_t nextSeq = 1;
+        uint16_t allocCursor = 0;
+
+        bool writing = false;
+        bool leveling = false;
+        char writeName[FLASH_FS_NAME_LEN];
+        uint32_t writeSeq = 0;
+        uint32_t writeSize = 0;
+        uint16_t writeBlocks = 0;
+        int16_t writeBlock = -1;    // 正在写的块
+};
+
+#define FLASH_FS FlashFs::getInstance()
+
+#endif // _FLASH_FS_HPP_
@@ -0,0 +1,125 @@
+#ifndef _FLASH_WRITER_HPP_
+#define _FLASH_WRITER_HPP_
+
+#include <stdint.h>
+#include "qspi-w25q64.h"
+
+/**
+ * QSPI flash 后台擦写队列
+ *
+ * erase()/program() 只把操作排进队列。主循环里的 poll() 每次最多发出一条命令后立即返回，
+ * 之后的循环读一次状态寄存器确认结束，扇区擦除的几十毫秒不再阻塞输入。
+ * 低延迟模式下新命令只在本帧的回报发出之后、下一个 SOF 之前发出（onSof/onFrameDone）。
+ *
+ * 队列按顺序执行。read() 先等正在执行的一条结束，再把队列里还没执行的擦写叠加到读出的数据上，
+ * 调用者读到的总是自己写入之后的内容。
+ *
+ * 从发出第一条命令到队列清空持有一个 QSPI 间接模式会话，isBusy() 期间不能访问 0x90000000 映射区；
+ * 清空后结束会话，由驱动恢复映射并失效擦写过的缓存行。后台模式关闭时（网页配置、校准），poll() 直接把队列执行完。
+ */
+
+#ifndef FLASH_WRITER_QUEUE_DEPTH
+#define FLASH_WRITER_QUEUE_DEPTH    16
+#endif
+
+class FlashWriter {
+    public:
+        FlashWriter(FlashWriter const&) = delete;
+        void operator=(FlashWriter const&) = delete;
+        static FlashWriter& getInstance() {
+            static FlashWriter instance;
+            return instance;
+        }
+
+        /**
+         * @brief 排入一次 4KB 扇区擦除，addr 为扇区内任意地址（映射地址或 flash 偏移均可）
+         * 队列满时先同步执行最早的操作腾出位置；执行中的错误由 flush() 报告
+         */
+        bool erase(uint32_t addr);
+
+        /**
+         * @brief 排入一次页编程，数据复制进队列
+         * @return 跨 256 字节页或长度为 0 时返回 false
+         */
+        bool program(uint32_t addr, const void* data, uint16_t len);
+
+        /**
+         * @brief 读取 flash，结果包含队列中尚未执行的擦写
+         */
+        bool read(uint32_t addr, void* out, uint32_t len);
+
+        /**
+         * @brief 同步执行完队列并恢复内存映射
+         * @return 上次 flush() 以来所有操作都成功
+         */
+        bool flush();
+
+        /**
+         * @brief 主循环调用：确认当前操作是否结束，时机合适时发出下一条
+         */
+        void poll();
+
+        /**
+         * @brief 队列非空或仍占用 QSPI（映射区不可访问）
+         */
+        bool isBusy() const {
+            return holdingBus || count > 0;
+        }
+
+        /**
+         * @brief 是否在后台执行；关闭时 poll() 一次执行完队列
+         */
+        void setBackground(bool enable) {
+            background = enable;
+        }
+
+        /**
+         * @brief SOF 中断里调用，记录帧起点
+         */
+        void onSof();
+
+        /**
+         * @brief 本帧回报已经处理完
+         */
+        void onFrameDone() {
+            frameDone = true;
+        }
+
+    private:
+        FlashWriter() {}
+
+        enum JobType : uint8_t {
+            JOB_ERASE = 0,
+            JOB_PROGRAM,
+        };
+
+        struct Job {
+            uint32_t addr;          // flash 偏移
+            uint16_t len;
+            JobType type;
+            uint8_t data[W25Qxx_PageSize];
+        };
+
+        bool submit(JobType type, uint32_t addr, const void* data, uint16_t len);
+        bool acquireBus();
+        void releaseBus();
+        bool issueHead();
+        bool waitInFlight();
+        void finishHead(bool ok);
+        bool inSofSlice() const;
+        void overlay(uint32_t addr, uint8_t* out, uint32_t len) const;
+
+        Job jobs[FLASH_WRITER_QUEUE_DEPTH];
+        uint8_t first = 0;              // 最早的操作；inFlight 时就是正在执行的那条
+        uint8_t count = 0;
+        bool inFlight = false;
+        bool holdingBus = false;        // 持有 QSPI 间接模式会话
+        bool background = false;
+        bool failed = false;
+        volatile uint32_t sofUs = 0;
+        volatile bool frameDone = false;
+};
+
+#define FLASH_WRITER FlashWriter::getInstance()
+
+#endif // _FLASH_WRITER_HPP_
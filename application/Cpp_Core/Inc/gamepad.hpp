@@ -7,19 +7,7 @@
 #include "gamepad/GamepadState.hpp"
 #include "leds/leds_manager.hpp"
 #include "micro_timer.hpp"
-
-struct GamepadButtonMapping
-{
-    GamepadButtonMapping(Mask_t pm, Mask_t bm):
-        virtualPinMask(pm),
-        buttonMask(bm)
-    {}
-
-    Mask_t virtualPinMask;
-    Mask_t buttonMask;
-    
-};
-
+#include "profile_runtime.hpp"
 
 class Gamepad {
     public:
@@ -40,8 +28,7 @@ class Gamepad {
         }
 
         void setSOCDMode(SOCDMode socdMode);
-        void refreshDefaultProfile();
-        const GamepadProfile* getOptions() const { return options; }
+        const GamepadProfile* getOptions() const { return STORAGE_MANAGER.getDefaultGamepadProfile(); }
 
         /**
          * @brief Check for a button press. Used by `pressed[Button]` helper methods.
@@ -85,39 +72,11 @@ class Gamepad {
         
         GamepadState rawState;
         GamepadState state;
-        GamepadButtonMapping *mapDpadUp;
-        GamepadButtonMapping *mapDpadDown;
-        GamepadButtonMapping *mapDpadLeft;
-        GamepadButtonMapping *mapDpadRight;
-        GamepadButtonMapping *mapButtonB1;
-        GamepadButtonMapping *mapButtonB2;
-        GamepadButtonMapping *mapButtonB3;
-        GamepadButtonMapping *mapButtonB4;
-        GamepadButtonMapping *mapButtonL1;
-        GamepadButtonMapping *mapButtonR1;
-        GamepadButtonMapping *mapButtonL2;
-        GamepadButtonMapping *mapButtonR2;
-        GamepadButtonMapping *mapButtonS1;
-        GamepadButtonMapping *mapButtonS2;
-        GamepadButtonMapping *mapButtonL3;
-        GamepadButtonMapping *mapButtonR3;
-        GamepadButtonMapping *mapButtonA1;
-        GamepadButtonMapping *mapButtonA2;
-        GamepadButtonMapping *mapButtonFn;
-
-        // These are special to SOCD
-        inline static const SOCDMode resolveSOCDMode(const GamepadProfile& options) {
-            return (options.keysConfig.socdMode == SOCD_MODE_BYPASS &&
-                    (STORAGE_MANAGER.getInputMode() == INPUT_MODE_SWITCH ||
-                    STORAGE_MANAGER.getInputMode() == INPUT_MODE_PS4)) ?
-                SOCD_MODE_NEUTRAL : options.keysConfig.socdMode;
-        };
-    
+
     private:
         Gamepad();
 
-        GamepadProfile* options;
-        uint32_t macroTriggerMask[MAX_NUM_MACROS] = { 0 };
+        const ProfileRuntime* runtime;     // 当前帧使用的配置文件镜像，切换配置文件时在帧开始处更新
         bool macroTriggerLatched[MAX_NUM_MACROS] = { false };
         bool macroPlaying = false;
         bool macroFinishPending = false;
@@ -0,0 +1,80 @@
+#ifndef _INPUT_SNAPSHOT_HPP_
+#define _INPUT_SNAPSHOT_HPP_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board_cfg.h"
+
+/**
+ * 输入快照
+ *
+ * 输入流水线每处理完一次采样就调用 publish，把各按键的原始 ADC 值、当前触发 / 重置阈值、
+ * 按键掩码和 SOCD 处理后的方向写入后台缓冲，再翻转前台索引。读取方（屏幕输入监视页）
+ * 只拷贝前台缓冲，换算行程等耗时工作都在读取方完成。
+ *
+ * 没有读取方时 publish 只累计回报计数：读取方每次 read 续租，租约过期后不再拷贝按键数据，
+ * 平时对输入路径的开销只有一次计数。
+ */
+
+#define INPUT_SNAPSHOT_LEASE_MS      500u    // 读取方续租时长，超时后停止拷贝
+#define INPUT_SNAPSHOT_RATE_WINDOW_MS 1000u  // 回报率统计窗口
+
+#define INPUT_SNAPSHOT_KEY_ANALOG    (1u << 0)   // 有 ADC 数据（否则只有按下状态）
+#define INPUT_SNAPSHOT_KEY_PRESSED   (1u << 1)
+
+struct InputSnapshotKey {
+    uint16_t value;             // ADC 原始值
+    uint16_t pressThreshold;    // 当前触发阈值（ADC 值）
+    uint16_t releaseThreshold;  // 当前重置阈值（ADC 值）
+    uint8_t buttonIndex;        // ADC 按键索引，用于换算行程
+    uint8_t flags;              // INPUT_SNAPSHOT_KEY_*
+};
+
+struct InputSnapshotFrame {
+    uint32_t seq;               // 发布序号，从 1 开始
+    uint32_t virtualPinMask;    // ADC 与 GPIO 合并后的按键掩码
+    uint8_t dpad;               // SOCD 处理后的方向（GAMEPAD_MASK_UP/DOWN/LEFT/RIGHT）
+    InputSnapshotKey keys[NUM_ADC_BUTTONS];   // 按虚拟引脚排列
+};
+
+class InputSnapshot {
+public:
+    static InputSnapshot& getInstance() {
+        static InputSnapshot instance;
+        return instance;
+    }
+
+    /**
+     * @brief 输入流水线处理完一次采样后调用
+     * @param virtualPinMask 本次采样的按键掩码
+     * @param dpad SOCD 处理后的方向
+     */
+    void publish(uint32_t virtualPinMask, uint8_t dpad);
+
+    /**
+     * @brief 拷贝最新一帧快照并续租
+     * @return 还没有发布过快照时返回 false
+     */
+    bool read(InputSnapshotFrame* out, uint32_t nowMs);
+
+    /** @brief 最近一个统计窗口的回报率（Hz），输入停止超过一个窗口时为 0 */
+    uint32_t getReportRateHz(uint32_t nowMs) const;
+
+private:
+    InputSnapshot() {}
+
+    InputSnapshotFrame frames[2] = {};
+    volatile uint8_t front = 0;
+    uint32_t seq = 0;
+    uint32_t leaseUntilMs = 0;
+    bool leased = false;
+
+    uint32_t windowStartMs = 0;
+    uint32_t windowCount = 0;
+    uint32_t lastPublishMs = 0;
+    uint32_t reportRateHz = 0;
+};
+
+#define INPUT_SNAPSHOT InputSnapshot::getInstance()
+
+#endif // _INPUT_SNAPSHOT_HPP_
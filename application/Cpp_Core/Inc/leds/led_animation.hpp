@@ -23,9 +23,7 @@ struct LedAnimationParams {
     
     // 全局动画参数
     struct {
-        uint8_t rippleCount;            // 涟漪数量
-        uint8_t rippleCenters[5];       // 涟漪中心索引 (最多5个)
-        float rippleProgress[5];        // 涟漪进度
+        const uint8_t* rippleIntensity; // 每个 LED 的涟漪强度 0-255 (LedRipplePool)
         bool aroundLedSyncMode;         // 环绕灯是否同步到主LED
     } global;
 };
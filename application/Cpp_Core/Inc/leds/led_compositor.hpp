@@ -0,0 +1,117 @@
+#ifndef _LED_COMPOSITOR_HPP_
+#define _LED_COMPOSITOR_HPP_
+
+#include "stm32h750xx.h"
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+#include "board_cfg.h"
+
+/**
+ * LED 图层合成器
+ *
+ * 底层效果（LEDsManager 中按 LEDEffect / AroundLEDEffect 计算的颜色）先写入帧缓冲，
+ * 随后按图层顺序将处于激活状态的叠加图层混合到帧缓冲上。
+ * 每个图层拥有独立的 LED 掩码、不透明度和混合模式，未激活的图层不会被求值，
+ * 因此每帧开销只与激活图层数量成正比。
+ */
+
+// 混合模式
+enum LedBlendMode : uint8_t
+{
+    LED_BLEND_NORMAL    = 0,        // 覆盖
+    LED_BLEND_ADD       = 1,        // 相加（饱和）
+    LED_BLEND_MULTIPLY  = 2,        // 相乘
+    LED_BLEND_SCREEN    = 3,        // 滤色
+    LED_BLEND_LIGHTEN   = 4,        // 取亮
+};
+
+// 叠加图层，数值越大越靠上。底层效果不占用图层槽位
+enum LedLayerId : uint8_t
+{
+    LED_LAYER_REACTIVE      = 0,    // 按键反馈（按键释放后的余辉）
+    LED_LAYER_NOTIFICATION  = 1,    // 通知（切换配置、低延迟模式警告等）
+    LED_LAYER_HOTKEY        = 2,    // 快捷键反馈（FN 按下时提示可用快捷键）
+    NUM_LED_LAYERS,
+};
+
+#define LED_MASK_WORDS  ((NUM_LED + 31) / 32)
+
+// 覆盖全部 LED 的位掩码，NUM_LED 超过 32 个，因此使用多个字
+struct LedMask {
+    uint32_t bits[LED_MASK_WORDS];
+
+    void clear() {
+        for (uint8_t i = 0; i < LED_MASK_WORDS; i++) bits[i] = 0;
+    }
+    void setRange(uint8_t start, uint8_t count) {
+        for (uint8_t i = start; i < start + count && i < NUM_LED; i++) set(i);
+    }
+    void set(uint8_t index) {
+        bits[index >> 5] |= (1u << (index & 31));
+    }
+    bool test(uint8_t index) const {
+        return (bits[index >> 5] >> (index & 31)) & 1u;
+    }
+};
+
+// 图层每帧的输入
+struct LedLayerFrame {
+    uint32_t now;                   // 当前时间 ms
+    uint32_t virtualPinMask;        // 当前按键状态
+};
+
+/**
+ * 图层渲染函数
+ * @param frame 当前帧输入
+ * @param index LED 索引（已通过图层掩码过滤）
+ * @param out 输出颜色
+ * @param userData 注册图层时传入的上下文
+ * @return 该 LED 的覆盖度 0-255，会与图层不透明度相乘；0 表示本帧透明，不参与混合
+ */
+typedef uint8_t (*LedLayerRenderer)(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData);
+
+struct LedLayer {
+    bool active;
+    LedBlendMode blendMode;
+    uint8_t opacity;                // 0-255
+    LedMask mask;
+    LedLayerRenderer render;
+    void* userData;
+    uint32_t expireTime;            // 到期自动失活的时间，0 表示常驻
+};
+
+class LedCompositor {
+    public:
+        LedCompositor();
+
+        void reset();
+
+        void configureLayer(LedLayerId id, LedLayerRenderer render, void* userData,
+                            LedBlendMode blendMode, uint8_t opacity);
+        void setLayerMask(LedLayerId id, const LedMask& mask);
+        void setLayerOpacity(LedLayerId id, uint8_t opacity);
+        void setLayerBlendMode(LedLayerId id, LedBlendMode blendMode);
+
+        /**
+         * @brief 激活/关闭图层
+         * @param durationMs 激活持续时间，0 表示直到手动关闭
+         */
+        void setLayerActive(LedLayerId id, bool active, uint32_t durationMs = 0);
+        bool isLayerActive(LedLayerId id) const;
+        uint8_t getActiveLayerCount() const;
+
+        /**
+         * @brief 将激活的图层依次混合到帧缓冲上
+         * @param frame 当前帧输入
+         * @param buffer 已写入底层效果的帧缓冲，长度 NUM_LED
+         */
+        void compose(const LedLayerFrame& frame, RGBColor* buffer);
+
+        static RGBColor blend(const RGBColor& dst, const RGBColor& src, LedBlendMode mode, uint8_t opacity);
+
+    private:
+        LedLayer layers[NUM_LED_LAYERS];
+        uint8_t activeMask;         // 激活图层位图，位 n 对应 LedLayerId n
+};
+
+#endif // _LED_COMPOSITOR_HPP_
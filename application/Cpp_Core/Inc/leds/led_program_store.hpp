@@ -0,0 +1,58 @@
+#ifndef _LED_PROGRAM_STORE_HPP_
+#define _LED_PROGRAM_STORE_HPP_
+
+#include "leds/led_vm.hpp"
+#include "flash_fs.hpp"
+
+/**
+ * 自定义灯效程序的存储
+ *
+ * 每个槽位的程序（程序头 + 字节码）是文件系统里的一个文件 "led/<槽位>"，
+ * 当前使用的槽位记在 "led/active"。替换程序由文件系统保证原子性，掉电时保留旧程序。
+ * 写入前统一经过 LedVm::verify 校验，读出后加载时会再次校验。
+ */
+
+#define LED_PROGRAM_NO_SLOT         0xFF
+
+class LedProgramStore {
+    public:
+        LedProgramStore(LedProgramStore const&) = delete;
+        void operator=(LedProgramStore const&) = delete;
+        static LedProgramStore& getInstance() {
+            static LedProgramStore instance;
+            return instance;
+        }
+
+        /**
+         * @brief 校验并保存程序到指定槽位
+         * @return 校验结果，写入失败返回 LED_VM_ERR_STORAGE
+         */
+        LedVmError save(uint8_t slot, const uint8_t* blob, size_t length);
+        bool remove(uint8_t slot);
+
+        /**
+         * @brief 设置当前使用的程序槽位，LED_PROGRAM_NO_SLOT 表示不使用
+         */
+        bool select(uint8_t slot);
+        uint8_t getActiveSlot();
+
+        /**
+         * @brief 读取槽位中的程序头
+         * @return 槽位中是否有合法的程序头
+         */
+        bool readHeader(uint8_t slot, LedVmProgramHeader& header);
+
+        /**
+         * @brief 加载当前使用的程序
+         */
+        LedVmError loadActive(LedVm& vm);
+
+    private:
+        LedProgramStore() {}
+};
+
+static_assert(sizeof(LedVmProgramHeader) + LEDS_VM_MAX_CODE_SIZE <= FLASH_FS_BLOCK_PAYLOAD, "LED program does not fit in one file system block");
+
+#define LED_PROGRAM_STORE LedProgramStore::getInstance()
+
+#endif // _LED_PROGRAM_STORE_HPP_
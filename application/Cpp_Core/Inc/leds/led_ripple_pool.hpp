@@ -0,0 +1,63 @@
+#ifndef _LED_RIPPLE_POOL_HPP_
+#define _LED_RIPPLE_POOL_HPP_
+
+#include "stm32h750xx.h"
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+#include "board_cfg.h"
+
+/**
+ * 涟漪发射器池
+ *
+ * 每次按键在固定大小的池中登记一个发射器，池满时替换最老的发射器，因此连按时每次按下都会显示。
+ * 启动时按 HITBOX_LED_POS_LIST 预计算每个按键到所有 LED 的整数距离，以及按距离排序的 LED 列表：
+ * 每帧每个发射器只用二分查找定位落在当前环带内的 LED，其余 LED 不参与计算，
+ * 单帧开销上限为 LEDS_RIPPLE_POOL_SIZE * NUM_LED 次查表，与按键频率无关。
+ */
+
+#define LED_RIPPLE_NUM_CENTERS      (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)
+#define LED_RIPPLE_DIST_SHIFT       2       // 距离定点数小数位，1/4 坐标单位
+#define LED_RIPPLE_FALLOFF_STEPS    64      // 衰减表长度
+
+class LedRipplePool {
+    public:
+        LedRipplePool();
+
+        void clear();
+
+        /**
+         * @brief 添加一个涟漪
+         * @param centerIndex 按键 LED 索引
+         * @param now 当前时间 ms
+         */
+        void emit(uint8_t centerIndex, uint32_t now);
+
+        /**
+         * @brief 移除过期涟漪并计算每个 LED 的涟漪强度
+         * @param now 当前时间 ms
+         * @param duration 涟漪持续时间 ms
+         */
+        void update(uint32_t now, uint32_t duration);
+
+        /**
+         * @brief 每个 LED 的涟漪强度 0-255，长度 NUM_LED
+         */
+        const uint8_t* getIntensities() const { return intensity; }
+        uint8_t getActiveCount() const { return count; }
+        uint32_t getReplacedCount() const { return replacedCount; }
+
+    private:
+        struct Emitter {
+            uint32_t startTime;
+            uint8_t centerIndex;
+        };
+
+        Emitter emitters[LEDS_RIPPLE_POOL_SIZE];    // 按开始时间排列，0 为最老
+        uint8_t count;
+        uint32_t replacedCount;                     // 池满被替换的涟漪数
+        uint8_t intensity[NUM_LED];
+
+        static void buildTables();
+};
+
+#endif // _LED_RIPPLE_POOL_HPP_
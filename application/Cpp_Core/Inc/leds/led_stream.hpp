@@ -0,0 +1,113 @@
+#ifndef _LED_STREAM_HPP_
+#define _LED_STREAM_HPP_
+
+#include "stm32h750xx.h"
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+#include "board_cfg.h"
+#include <cstddef>
+
+/**
+ * LED 实时灯光流
+ *
+ * 上位机按帧推送整条灯带的颜色（网页配置模式下的 WebSocket 二进制通道），
+ * 固件不做任何动画计算，只在下一个 LED 刷新周期把收到的帧显示出来。
+ * 游戏模式不提供通道：各手柄模式的 HID 描述符都没有可用的 Feature 报告，整帧也超过 64 字节的端点缓冲。
+ *
+ * 帧格式（不含传输层的命令字节）：
+ *   LedStreamFrameHeader + N 个颜色段
+ *   颜色段：start(1) + count(1) + count * RGB(3)
+ * 关键帧：先清空为黑色再写入颜色段；增量帧：在上一帧的基础上只写入变化的颜色段。
+ *
+ * 双缓冲：解码写入后台缓冲，LED 刷新时 swapBuffers() 交换到前台，
+ * 同一刷新周期内收到的多个增量帧会累积到同一个后台缓冲上。
+ */
+
+// 帧标志位
+#define LED_STREAM_FLAG_KEYFRAME    0x01
+
+// 帧头亮度字段取该值时保持当前亮度
+#define LED_STREAM_BRIGHTNESS_KEEP  0xFF
+
+enum LedStreamResult : uint8_t
+{
+    LED_STREAM_OK                   = 0,
+    LED_STREAM_ERR_LENGTH           = 1,    // 数据包长度非法
+    LED_STREAM_ERR_RANGE            = 2,    // 颜色段超出 LED 数量
+    LED_STREAM_ERR_NEED_KEYFRAME    = 3,    // 增量帧序号不连续或之前有帧被丢弃，需要重发关键帧
+    LED_STREAM_ERR_RATE             = 4,    // 帧间隔过短被丢弃
+};
+
+#pragma pack(push, 1)
+struct LedStreamFrameHeader {
+    uint8_t flags;          // LED_STREAM_FLAG_*
+    uint16_t seq;           // 帧序号，增量帧必须连续
+    uint8_t brightness;     // 0-100，LED_STREAM_BRIGHTNESS_KEEP 表示不变
+    uint8_t segmentCount;   // 颜色段数量
+    uint8_t reserved;
+};
+#pragma pack(pop)
+
+class LedStream {
+    public:
+        LedStream(LedStream const&) = delete;
+        void operator=(LedStream const&) = delete;
+        static LedStream& getInstance() {
+            static LedStream instance;
+            return instance;
+        }
+
+        /**
+         * @brief 开始灯光流，下一帧必须是关键帧
+         * @param brightness 亮度 0-100
+         */
+        void begin(uint8_t brightness);
+        void end();
+
+        /**
+         * @brief 解码一帧到后台缓冲
+         * @param payload 帧头 + 颜色段
+         * @param length 长度
+         * @return 解码结果。处于非活动状态时关键帧会自动开始灯光流
+         */
+        LedStreamResult submitFrame(const uint8_t* payload, size_t length);
+
+        /**
+         * @brief 是否处于灯光流模式，超时未收到帧会自动结束
+         */
+        bool isActive(uint32_t now);
+
+        /**
+         * @brief LED 刷新时调用，有新帧时交换前后台缓冲
+         * @return 是否有新帧
+         */
+        bool swapBuffers();
+
+        const RGBColor* getFrontBuffer() const { return buffers[frontIndex]; }
+        uint8_t getBrightness() const { return brightness; }
+        bool isBrightnessChanged() const { return brightnessChanged; }
+        void clearBrightnessChanged() { brightnessChanged = false; }
+
+        uint16_t getExpectedSeq() const { return expectedSeq; }
+        uint32_t getReceivedFrames() const { return receivedFrames; }
+        uint32_t getDroppedFrames() const { return droppedFrames; }
+
+    private:
+        LedStream();
+
+        RGBColor buffers[2][NUM_LED];
+        uint8_t frontIndex;
+        bool pending;               // 后台缓冲中有尚未显示的帧
+        bool active;
+        bool needKeyframe;
+        bool brightnessChanged;
+        uint8_t brightness;
+        uint16_t expectedSeq;
+        uint32_t lastFrameTime;
+        uint32_t receivedFrames;
+        uint32_t droppedFrames;
+};
+
+#define LED_STREAM LedStream::getInstance()
+
+#endif // _LED_STREAM_HPP_
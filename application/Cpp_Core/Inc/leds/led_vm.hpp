@@ -0,0 +1,206 @@
+#ifndef _LED_VM_HPP_
+#define _LED_VM_HPP_
+
+#include "stm32h750xx.h"
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+#include "board_cfg.h"
+#include <cstddef>
+
+/**
+ * 自定义灯效字节码虚拟机
+ *
+ * 每个 LED 独立执行一次程序，程序以 OUT 指令输出颜色。只使用 32 位整数运算，
+ * 加载时做静态校验（操作码、操作数、跳转目标、每条路径的栈深度），
+ * 运行时只检查指令预算，因此程序无法越界访问，也无法卡死灯效循环。
+ *
+ * 加载时把字节码译成定长指令：操作数解码好、跳转换成指令下标，并给每条指令记下从它开始
+ * 到下一条跳转/结束指令的指令数。运行时只在程序开始和跳转时按这个数扣预算，不再逐条检查；
+ * 指令分派用 GCC 的标签地址表，每条指令处理完直接跳到下一条的处理代码。
+ *
+ * 一帧超出预算时本帧作废（由调用者保持上一帧），超预算的帧累计到 LEDS_VM_MAX_OVERRUN_FRAMES
+ * 后程序才失效。
+ *
+ * 程序格式：LedVmProgramHeader + 字节码，多字节操作数为小端。
+ */
+
+#define LED_VM_MAGIC            0x314D564C      // "LVM1"
+#define LED_VM_VERSION          1
+#define LED_VM_STACK_SIZE       16
+#define LED_VM_NUM_REGS         8
+
+// 操作码，注释格式：出栈 -> 入栈
+enum LedVmOpcode : uint8_t
+{
+    LED_OP_END      = 0x00,     // 结束，输出黑色
+    LED_OP_PUSH8    = 0x01,     // imm8 无符号            -> v
+    LED_OP_PUSH16   = 0x02,     // imm16 有符号           -> v
+    LED_OP_PUSH32   = 0x03,     // imm32                  -> v
+    LED_OP_IN       = 0x04,     // imm8 输入编号          -> v
+    LED_OP_LOAD     = 0x05,     // imm8 寄存器            -> v
+    LED_OP_STORE    = 0x06,     // imm8 寄存器       v    ->
+    LED_OP_DUP      = 0x07,     //                   a    -> a a
+    LED_OP_DROP     = 0x08,     //                   a    ->
+    LED_OP_SWAP     = 0x09,     //                   a b  -> b a
+    LED_OP_OVER     = 0x0A,     //                   a b  -> a b a
+
+    LED_OP_ADD      = 0x10,     //                   a b  -> a+b
+    LED_OP_SUB      = 0x11,     //                   a b  -> a-b
+    LED_OP_MUL      = 0x12,     //                   a b  -> a*b
+    LED_OP_DIV      = 0x13,     //                   a b  -> a/b，b 为 0 时结果为 0
+    LED_OP_MOD      = 0x14,     //                   a b  -> a%b，b 为 0 时结果为 0
+    LED_OP_NEG      = 0x15,     //                   a    -> -a
+    LED_OP_ABS      = 0x16,     //                   a    -> |a|
+    LED_OP_MIN      = 0x17,     //                   a b  -> min
+    LED_OP_MAX      = 0x18,     //                   a b  -> max
+    LED_OP_AND      = 0x19,     //                   a b  -> a&b
+    LED_OP_OR       = 0x1A,     //                   a b  -> a|b
+    LED_OP_XOR      = 0x1B,     //                   a b  -> a^b
+    LED_OP_SHL      = 0x1C,     //                   a b  -> a<<(b&31)
+    LED_OP_SHR      = 0x1D,     //                   a b  -> a>>(b&31)，算术右移
+    LED_OP_NOT      = 0x1E,     //                   a    -> a==0
+
+    LED_OP_LT       = 0x20,     //                   a b  -> a<b
+    LED_OP_LE       = 0x21,     //                   a b  -> a<=b
+    LED_OP_EQ       = 0x22,     //                   a b  -> a==b
+
+    LED_OP_JMP      = 0x28,     // imm16 相对下一条指令的偏移
+    LED_OP_JZ       = 0x29,     // imm16 偏移         v    -> ，v 为 0 时跳转
+
+    LED_OP_SIN8     = 0x30,     //                   a    -> 正弦 0-255，周期 256
+    LED_OP_TRI8     = 0x31,     //                   a    -> 三角波 0-255，周期 256
+    LED_OP_SCALE8   = 0x32,     //                   a b  -> a*b/256
+    LED_OP_LERP8    = 0x33,     //                a b t   -> a+(b-a)*t/256
+    LED_OP_CLAMP8   = 0x34,     //                   a    -> 限制到 0-255
+    LED_OP_HSV      = 0x35,     //                h s v   -> r g b
+    LED_OP_RAND8    = 0x36,     //                        -> 0-255 伪随机
+    LED_OP_DIST8    = 0x37,     //                  dx dy -> 近似距离，限制到 0-255
+    LED_OP_COLOR    = 0x38,     // imm8 配置颜色 0-2      -> r g b
+
+    LED_OP_OUT      = 0x3F,     //                r g b   -> 输出颜色并结束
+};
+
+// 输入编号
+enum LedVmInput : uint8_t
+{
+    LED_IN_TIME         = 0,    // 效果开始后的毫秒数
+    LED_IN_INDEX        = 1,    // LED 索引
+    LED_IN_X            = 2,    // 横坐标，按整块面板归一化到 0-255
+    LED_IN_Y            = 3,    // 纵坐标，按整块面板归一化到 0-255
+    LED_IN_PRESSED      = 4,    // 对应按键是否按下 0/1，环绕灯恒为 0
+    LED_IN_TRAVEL       = 5,    // 对应按键行程 0-255
+    LED_IN_SPEED        = 6,    // 动画速度 1-5
+    LED_IN_FRAME        = 7,    // 帧计数
+    LED_IN_IS_AROUND    = 8,    // 是否为环绕灯 0/1
+    LED_IN_NUM_PRESSED  = 9,    // 当前按下的按键数量
+    LED_IN_NUM_LED      = 10,   // LED 总数
+    NUM_LED_VM_INPUTS,
+};
+
+enum LedVmError : uint8_t
+{
+    LED_VM_OK               = 0,
+    LED_VM_ERR_HEADER       = 1,    // 魔数或版本不匹配
+    LED_VM_ERR_SIZE         = 2,    // 长度非法或超过 LEDS_VM_MAX_CODE_SIZE
+    LED_VM_ERR_CHECKSUM     = 3,    // 代码校验失败
+    LED_VM_ERR_OPCODE       = 4,    // 未知操作码或操作数越界
+    LED_VM_ERR_JUMP         = 5,    // 跳转目标不在指令边界上
+    LED_VM_ERR_STACK        = 6,    // 栈溢出、栈下溢或汇合点栈深度不一致
+    LED_VM_ERR_FALLTHROUGH  = 7,    // 执行路径没有以 OUT/END/JMP 结束
+    LED_VM_ERR_STORAGE      = 8,    // QSPI 读写失败
+};
+
+#pragma pack(push, 1)
+struct LedVmProgramHeader {
+    uint32_t magic;         // LED_VM_MAGIC
+    uint8_t version;        // LED_VM_VERSION
+    uint8_t flags;          // 保留，当前为 0
+    uint16_t codeSize;      // 字节码长度
+    uint16_t stepBudget;    // 单个 LED 的指令预算，0 表示使用 LEDS_VM_MAX_STEPS_PER_LED
+    uint16_t reserved;
+    uint32_t checksum;      // 字节码 FNV-1a
+    char name[16];
+};
+#pragma pack(pop)
+
+// 每帧的公共输入
+struct LedVmFrameInputs {
+    uint32_t time;                  // 效果开始后的毫秒数
+    uint32_t frame;                 // 帧计数
+    uint32_t virtualPinMask;        // 按键状态
+    const uint8_t* travel;          // 每个按键的行程 0-255，长度 NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS，可为空
+    uint8_t speed;                  // 动画速度
+    RGBColor colors[3];             // 配置中的三种颜色
+};
+
+class LedVm {
+    public:
+        LedVm();
+
+        /**
+         * @brief 校验并加载程序
+         * @param blob 程序头 + 字节码
+         * @param length 长度
+         */
+        LedVmError load(const uint8_t* blob, size_t length);
+        void unload();
+
+        /**
+         * @brief 只校验不加载
+         */
+        static LedVmError verify(const uint8_t* blob, size_t length);
+        static uint32_t checksum(const uint8_t* data, size_t length);
+
+        bool isLoaded() const { return loaded; }
+        bool isFaulted() const { return faulted; }
+        const char* getName() const { return name; }
+
+        /**
+         * @brief 开始新的一帧，重置帧预算
+         */
+        void beginFrame(const LedVmFrameInputs& inputs);
+
+        /**
+         * @brief 对单个 LED 执行程序
+         * @param index LED 索引
+         * @param out 输出颜色
+         * @return false 表示未加载、已失效或本帧已超出预算，out 为黑色
+         */
+        bool run(uint8_t index, RGBColor& out);
+
+        /**
+         * @brief 结束一帧，统计超预算的帧
+         * @return 本帧所有 LED 都在预算内执行完；false 时调用者应保持上一帧
+         */
+        bool endFrame();
+
+        uint32_t getFrameSteps() const { return frameSteps; }
+
+    private:
+        // 译码后的指令
+        struct Insn {
+            int32_t imm;            // 立即数；跳转为目标指令下标
+            uint8_t op;
+            uint8_t arg;            // IN/LOAD/STORE/COLOR 的编号
+            uint16_t runLength;     // 从本条到下一条跳转/结束指令（含）的指令数
+        };
+
+        Insn insns[LEDS_VM_MAX_CODE_SIZE];
+        uint16_t numInsns;
+        uint16_t stepBudget;
+        char name[17];
+        bool loaded;
+        bool faulted;               // 超预算的帧过多，程序失效，直到重新加载
+        bool frameOverrun;          // 本帧已超出预算
+        uint8_t overrunScore;       // 超预算的帧加一，正常的帧减一
+
+        LedVmFrameInputs frameInputs;
+        uint32_t frameSteps;
+        int32_t inputValues[NUM_LED_VM_INPUTS];     // IN 指令直接按编号取值
+        uint32_t randState;
+
+        uint8_t posX[NUM_LED];      // 归一化坐标
+        uint8_t posY[NUM_LED];
+};
+
+#endif // _LED_VM_HPP_
@@ -9,8 +9,27 @@
 #include "config.hpp"
 #include "leds/gradient_color.hpp"
 #include "leds/led_animation.hpp"
+#include "leds/led_ripple_pool.hpp"
+#include "leds/led_compositor.hpp"
+#include "leds/led_stream.hpp"
+#include "leds/led_vm.hpp"
 #include "board_cfg.h"
 
+/**
+ * 按键行程回调，供自定义灯效读取按键行程
+ * @param virtualPin 虚拟引脚
+ * @return 行程 0-255，0 表示完全释放
+ */
+typedef uint8_t (*LedTravelProvider)(uint8_t virtualPin);
+
+// 通知图层显示的事件
+enum LedNotification : uint8_t
+{
+    LED_NOTIFY_NONE                 = 0,
+    LED_NOTIFY_PROFILE_SWITCHED     = 1,    // 切换了默认配置
+    LED_NOTIFY_LOW_LATENCY_WARNING  = 2,    // 输入模式下 ADC 未运行在低延迟模式
+};
+
 class LEDsManager {
     public:
         LEDsManager(LEDsManager const&) = delete;
@@ -43,12 +62,24 @@ class LEDsManager {
         void setTemporaryConfig(const LEDProfile& tempConfig, uint32_t enabledKeysMask);
         void restoreDefaultConfig();
         bool isUsingTemporaryConfig() const;
+
+        // 图层合成
+        void notify(LedNotification notification);
+        LedCompositor& getCompositor() { return compositor; }
+
+        // 自定义灯效
+        void setTravelProvider(LedTravelProvider provider) { travelProvider = provider; }
+        void reloadCustomProgram();
+
+        // 灯光流
+        void stopStream();
         
         // 测试函数
         // void testAnimation(LEDEffect effect, float progress = 0.5f, uint32_t buttonMask = 0);
         // void previewAnimation(LEDEffect effect, uint32_t duration = 5000);
     private:
         LEDsManager();
+        void saveOptions();
         uint32_t t;
         GradientColor gtc;
         LEDProfile* opts;
@@ -65,8 +96,7 @@ class LEDsManager {
         // 新增动画系统相关成员
         uint32_t animationStartTime;
         uint32_t lastButtonState;
-        Ripple ripples[5];
-        uint8_t rippleCount;
+        LedRipplePool ripplePool;
         
         // 环绕灯动画系统相关成员
         uint32_t aroundLedAnimationStartTime;
@@ -89,6 +119,38 @@ class LEDsManager {
         
         // 内部配置管理
         void updateColorsFromConfig();
+
+        // 图层合成相关成员
+        LedCompositor compositor;
+        RGBColor frameBuffer[NUM_LED];                              // 底层效果 + 叠加图层的合成结果
+        uint32_t releaseTimes[NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS];  // 按键释放时间，用于按键反馈图层
+        LedNotification notification;
+        uint32_t notificationStartTime;
+        char notifiedProfileId[sizeof(GamepadProfile::id)];        // 上次提示切换时的配置 ID，重新保存同一配置不提示
+        uint32_t hotkeyPinMask;                                     // 已绑定快捷键的虚拟引脚掩码（含FN）
+
+        void setupLayers();
+        void updateLayers(uint32_t virtualPinMask);
+        void flushFrame(uint32_t virtualPinMask);
+
+        // 灯光流模式：底层效果由上位机推送的帧代替
+        bool streaming;
+        void enterStream();
+        void exitStream();
+        void processStreamFrame(uint32_t virtualPinMask);
+
+        // 自定义灯效（字节码虚拟机）相关成员
+        LedVm ledVm;
+        uint32_t ledVmFrame;
+        uint8_t keyTravel[NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS];
+        LedTravelProvider travelProvider;
+        RGBColor customFrame[NUM_LED];                              // 程序最近一次完整执行的结果，超预算的帧保持它
+
+        bool renderCustomFrame(uint32_t virtualPinMask, uint32_t now, uint8_t numLeds);
+
+        static uint8_t renderReactiveLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData);
+        static uint8_t renderNotificationLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData);
+        static uint8_t renderHotkeyLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData);
 };
 
 #define LEDS_MANAGER LEDsManager::getInstance()
@@ -0,0 +1,106 @@
+#ifndef _PROFILE_RUNTIME_HPP_
+#define _PROFILE_RUNTIME_HPP_
+
+#include <stdint.h>
+#include "types.hpp"
+#include "config.hpp"
+
+/**
+ * 配置文件运行时镜像
+ *
+ * 输入路径每帧要用的东西在切换配置文件时一次算好，放进一块连续的内存：
+ * 虚拟引脚到手柄按键的查找表（组合键已并入）、生效的 SOCD 模式和方向处理开关、
+ * 宏的触发掩码和步骤、每个 ADC 按键换算成整数微米的触发参数。
+ *
+ * 镜像有两份：request() 在后台那份里编译，commit() 在帧之间把当前镜像指针换过去，
+ * 同一帧的回报不会混用两个配置文件。镜像以源配置文件的 CRC32 为键，
+ * 切回刚用过的配置文件或内容没变时不重新编译。
+ */
+
+#define PROFILE_RUNTIME_NUM_PINS        32
+
+/**
+ * @brief 一个虚拟引脚按下时产生的手柄输出
+ */
+typedef struct
+{
+    uint32_t buttons;
+    uint16_t aux;
+    uint8_t dpad;
+} ProfileRuntimePin;
+
+/**
+ * @brief ADC 按键的触发参数，单位微米，最小值约束已经应用
+ */
+typedef struct
+{
+    uint16_t pressAccuracyUm;
+    uint16_t releaseAccuracyUm;             // 行程后段使用，不小于 MIN_ADC_RELEASE_ACCURACY
+    uint16_t highPrecisionReleaseAccuracyUm; // 行程前段使用，即配置值
+    uint16_t topDeadzoneUm;
+    uint16_t bottomDeadzoneUm;
+} ProfileRuntimeTrigger;
+
+typedef struct
+{
+    uint32_t sourceCrc;                     // 源配置文件的 CRC32
+    Mask_t mappedPinMask;                   // 查找表里有输出的虚拟引脚
+    ProfileRuntimePin pins[PROFILE_RUNTIME_NUM_PINS];
+    SOCDMode socdMode;                      // 已按输入模式处理过 BYPASS
+    bool invertXAxis;
+    bool invertYAxis;
+    bool fourWayMode;
+    uint32_t enabledKeysMask;               // 启用的 ADC 按键
+    uint32_t macroTriggerMask[MAX_NUM_MACROS];
+    MacroConfig macros[MAX_NUM_MACROS];     // numSteps 已限制在 MAX_MACRO_STEPS 以内
+    ProfileRuntimeTrigger triggers[NUM_ADC_BUTTONS];
+} ProfileRuntime;
+
+namespace ProfileCompiler {
+    /**
+     * @brief 把配置文件编译成运行时镜像
+     */
+    void compile(const GamepadProfile& profile, ProfileRuntime& image);
+};
+
+class ProfileRuntimeManager {
+    public:
+        ProfileRuntimeManager(ProfileRuntimeManager const&) = delete;
+        void operator=(ProfileRuntimeManager const&) = delete;
+        static ProfileRuntimeManager& getInstance() {
+            static ProfileRuntimeManager instance;
+            return instance;
+        }
+
+        /**
+         * @brief 准备切换到 profile：在后台镜像里编译，等 commit() 生效
+         * 和当前镜像内容相同时撤销挂起的切换
+         */
+        void request(const GamepadProfile& profile);
+
+        /**
+         * @brief 帧之间调用：有挂起的镜像时换成当前镜像
+         * @return 当前镜像发生了变化
+         */
+        bool commit();
+
+        /**
+         * @brief 当前帧使用的镜像
+         */
+        const ProfileRuntime& current() const {
+            return images[active];
+        }
+
+    private:
+        ProfileRuntimeManager() {}
+
+        ProfileRuntime images[2] = {};
+        uint8_t active = 0;
+        bool pending = false;
+        bool activeValid = false;
+        bool backValid = false;                 // 后台镜像里是一份编译过的配置文件
+};
+
+#define PROFILE_RUNTIME ProfileRuntimeManager::getInstance()
+
+#endif // _PROFILE_RUNTIME_HPP_
@@ -73,7 +73,13 @@ void ScreenDetailButtonsPerformance_Render(ST7789_Handle* lcd, uint8_t index, co
 bool ScreenDetailButtonsPerformance_OnConfirm(uint8_t index);
 bool ScreenDetailButtonsPerformance_OnBack(void);
 
-void ScreenUI_RequestDeferredSave(uint32_t delayMs);
+uint8_t ScreenDetailInputMonitor_InitIndex(void);
+void ScreenDetailInputMonitor_Rotate(uint8_t* ioIndex, int8_t det);
+void ScreenDetailInputMonitor_Render(ST7789_Handle* lcd, uint8_t index, const ScreenUiStyle& style);
+bool ScreenDetailInputMonitor_OnConfirm(uint8_t index);
+
+/** @brief 请求在 dueMs 时刻至少渲染一帧（屏幕只在有变化时出帧，定时变化的内容需要提前登记） */
+void ScreenUI_RequestFrameAt(uint32_t dueMs);
 void ScreenUI_RequestRebootTo(uint8_t menuId, uint8_t index);
 
 #endif
@@ -3,6 +3,15 @@
 
 #include <stdint.h>
 
+// 屏幕主循环各阶段耗时（微秒）
+struct SPIScreenPerf {
+    uint32_t preUs;         // SPI / GIF 服务
+    uint32_t frameBeginUs;  // ST7789_FrameBegin
+    uint32_t prepUs;        // 输入、待机、配置处理
+    uint32_t renderUs;      // 绘制到帧缓冲
+    uint32_t flushUs;       // ST7789_FrameEnd（合并脏区并启动 DMA）
+};
+
 class SPIScreenManager {
 public:
     SPIScreenManager(SPIScreenManager const&) = delete;
@@ -18,6 +27,13 @@ public:
     bool menuPrev();
     bool menuNext();
 
+    /**
+     * @brief 最近一次实际渲染的帧的各阶段耗时
+     * @param frames 输出累计渲染帧数，可为空
+     * @param blocked 输出 FrameBegin 因 DMA 忙或帧率限制拒绝的累计次数，可为空
+     */
+    const SPIScreenPerf& getLastFramePerf(uint32_t* frames = nullptr, uint32_t* blocked = nullptr) const;
+
 private:
     SPIScreenManager() = default;
 
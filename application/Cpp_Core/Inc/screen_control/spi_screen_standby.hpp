@@ -12,6 +12,13 @@ void ScreenStandby_Configure(uint8_t standbyDisplay, const char* backgroundImage
 void ScreenStandby_NotifyInput(uint32_t nowMs, uint32_t inputMask, bool activityEvent, bool wakeEvent);
 void ScreenStandby_Tick(uint32_t nowMs);
 bool ScreenStandby_IsActive(void);
+/** @brief 待机画面有待绘制的内容（刚进入待机、配置变化或按键布局需要更新） */
+bool ScreenStandby_NeedsRender(void);
+/**
+ * @brief 下一次需要处理待机的时间点：未待机时为进入待机的时刻，待机中为序列图下一帧的时刻
+ * @return 没有定时事件时返回 false
+ */
+bool ScreenStandby_NextEventMs(uint32_t* outDueMs);
 bool ScreenStandby_Deactivate(void);
 void ScreenStandby_Render(ST7789_Handle* lcd, uint32_t inputMask);
 
@@ -15,6 +15,8 @@ uint32_t ScreenUI_MutedTextForBg(uint32_t fg, uint32_t bg, uint8_t amount);
 
 uint16_t ScreenUI_CharCellW(uint8_t scale);
 uint16_t ScreenUI_CharCellH(uint8_t scale);
+/** @brief 查找与该缩放字符格同高的字体资源（名为 "font<像素高>"，如 font16），没有时界面退回 5x7 点阵字体 */
+bool ScreenUI_FontForScale(uint8_t scale, ST7789_Font* out);
 uint16_t ScreenUI_TextPxW(const char* s, uint8_t scale);
 uint16_t ScreenUI_TextPxH(uint8_t scale);
 
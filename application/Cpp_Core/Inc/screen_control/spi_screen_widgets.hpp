@@ -0,0 +1,179 @@
+#ifndef SPI_SCREEN_WIDGETS_HPP
+#define SPI_SCREEN_WIDGETS_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "screen_control/spi_screen_layout.hpp"
+
+extern "C" {
+#include "st7789.h"
+}
+
+/**
+ * 保留模式控件树
+ *
+ * 页面每帧按固定顺序声明控件（标签、面板、进度条、行程条、列表、图标），控件树把声明与上一帧画过的属性逐个比较：
+ * 只有属性变化的控件，以及与本帧已重绘区域重叠的后续控件才会重新画进帧缓冲；
+ * 位置变化或不再声明的控件先用树背景色擦除原区域。帧缓冲只记录真正改变的像素，
+ * 因此内容不变的帧既不画也不刷屏。
+ *
+ * 控件按声明顺序从底到顶叠放，每个控件都完整覆盖自己的矩形。
+ */
+
+#define SCREEN_WIDGET_TEXT_MAX 48u
+#define SCREEN_WIDGET_ERASE_MAX 16u   // 单帧待擦除矩形上限，超出时整块区域重画
+
+enum ScreenWidgetKind : uint8_t {
+    SCREEN_WIDGET_NONE = 0u,
+    SCREEN_WIDGET_PANEL = 1u,
+    SCREEN_WIDGET_LABEL = 2u,
+    SCREEN_WIDGET_PROGRESS = 3u,
+    SCREEN_WIDGET_LIST = 4u,
+    SCREEN_WIDGET_ICON = 5u,
+    SCREEN_WIDGET_METER = 6u,
+};
+
+enum ScreenWidgetAlign : uint8_t {
+    SCREEN_ALIGN_LEFT = 0u,
+    SCREEN_ALIGN_CENTER = 1u,
+};
+
+struct ScreenWidgetRect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+};
+
+// 控件属性，整体按字节比较，未用字段保持为 0
+struct ScreenWidget {
+    ScreenWidgetRect rect;
+    const char* const* items;   // 列表：各项文字，需在 ScreenWidgetTree_End 之前保持有效
+    uint8_t kind;
+    uint8_t scale;
+    uint8_t align;
+    uint8_t count;              // 列表：项数
+    uint8_t index;              // 列表：光标
+    uint8_t selected;           // 列表：当前生效项
+    uint16_t itemH;             // 列表：行高
+    int16_t offsetPx;           // 列表：滚动动画偏移
+    uint16_t value;             // 进度条 / 行程条：当前值
+    uint16_t min;
+    uint16_t max;
+    uint16_t marks[2];          // 行程条：触发、重置位置（0 表示不画）
+    uint32_t fg;                // 文字 / 进度条填充色
+    uint32_t bg;                // 矩形底色 / 进度条轨道色
+    uint32_t accent;            // 标签：字符格底色；列表：选中行底色
+    uint32_t muted;             // 列表：非生效项文字色；行程条：轨道色
+    uint32_t markColors[2];     // 行程条：触发、重置标记色
+    uint32_t itemsHash;         // 列表：各项文字的哈希
+    char text[SCREEN_WIDGET_TEXT_MAX]; // 标签文字 / 图标资源名
+};
+
+struct ScreenWidgetSlot {
+    ScreenWidget props;
+    bool dirty;
+};
+
+struct ScreenWidgetTree {
+    ScreenWidgetSlot* slots;
+    uint8_t capacity;
+    uint8_t count;              // 本帧已声明的控件数
+    uint8_t paintedCount;       // 上一帧画过的控件数
+    uint8_t eraseCount;
+    bool valid;
+    bool clearPending;
+    ST7789_Handle* lcd;
+    ScreenWidgetRect area;
+    uint32_t key;
+    uint32_t bg;
+    ScreenWidgetRect erase[SCREEN_WIDGET_ERASE_MAX];
+};
+
+/** @brief 绑定控件存储，slots 由调用方提供 */
+void ScreenWidgetTree_Init(ScreenWidgetTree* tree, ScreenWidgetSlot* slots, uint8_t capacity);
+/** @brief 整块区域在下一次 End 时重画（整屏被其他代码覆盖后调用） */
+void ScreenWidgetTree_Invalidate(ScreenWidgetTree* tree);
+/**
+ * @brief 开始声明一帧控件
+ * @param key 页面标识，与上一帧不同时清空区域并重画全部控件
+ * @param bg 区域背景色，控件擦除时使用
+ */
+void ScreenWidgetTree_Begin(ScreenWidgetTree* tree, ST7789_Handle* lcd, ScreenWidgetRect area, uint32_t key, uint32_t bg);
+/** @brief 擦除消失的控件并重画有变化的控件，返回本帧重画的控件数 */
+uint8_t ScreenWidgetTree_End(ScreenWidgetTree* tree);
+
+/** @brief 当前页面内容区使用的控件树，由屏幕管理器在渲染页面前后调用 Begin / End */
+ScreenWidgetTree* ScreenWidgets_Content(void);
+
+void ScreenWidget_Panel(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint32_t bg);
+/** @brief 文字标签，textBg 为字符格底色（通常与 bg 相同） */
+void ScreenWidget_Label(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* text, uint32_t fg, uint32_t bg, uint32_t textBg, uint8_t scale, ScreenWidgetAlign align);
+void ScreenWidget_Progress(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint16_t value, uint16_t min, uint16_t max, uint32_t fill, uint32_t track);
+/**
+ * @brief 纵向行程条：从顶部向下填充 value / max，触发与重置位置画成横贯整个矩形的刻线
+ * 轨道左右各缩进 2 像素，刻线伸出轨道，填充色与轨道色相同时仍可辨认
+ */
+void ScreenWidget_Meter(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint16_t value, uint16_t max, uint16_t pressMark, uint16_t releaseMark, uint32_t fill, uint32_t track, uint32_t bg, uint32_t pressColor, uint32_t releaseColor);
+/** @brief 纵向列表，光标行居中，offsetPx 为滚动动画偏移 */
+void ScreenWidget_List(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* const* items, uint8_t count, uint8_t index, uint8_t selected, uint16_t itemH, int16_t offsetPx, const ScreenUiStyle& style, uint32_t muted);
+/** @brief 资源分区中的图片，居左上绘制 */
+void ScreenWidget_Icon(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* assetName, uint32_t bg);
+
+/**
+ * 数值滑条的旋钮编辑
+ *
+ * 滚动越快每格改动越多；快速滚动停下后按递增的间隔继续补步，形成惯性减速。
+ */
+struct ScreenValueEditTuning {
+    uint8_t mulBase;                // 基础步进倍率：慢慢滚动时使用
+    uint16_t accelDtFastMs;         // dt 小于此值视为“很快”，更容易触发大倍率（调大=更容易加速）
+    uint16_t accelDtMedMs;          // dt 小于此值视为“较快”
+    uint16_t accelDtSlowMs;         // dt 小于此值视为“略快”
+    uint8_t mulFast;                // 很快滚动时的倍率（调大=每次 det 改得更多）
+    uint8_t mulMed;
+    uint8_t mulSlow;
+    uint16_t inertiaDtFastMs;       // dt 小于此值视为“快速滚动”，惯性更强（调大=更容易出强惯性）
+    uint16_t inertiaDtMedMs;        // dt 小于此值视为“中速滚动”
+    uint8_t inertiaStepsMaxFast;    // 快速滚动时惯性最大补步数（调大=惯性更长）
+    uint8_t inertiaStepsAddFast;    // 快速滚动时每次增加的惯性补步数（调大=惯性更猛）
+    uint16_t inertiaIntervalFastMs; // 快速滚动时惯性起始间隔（调小=惯性更快）
+    uint8_t inertiaStepsMaxMed;
+    uint8_t inertiaStepsAddMed;
+    uint16_t inertiaIntervalMedMs;
+    uint16_t inertiaIntervalSlowMs; // 慢速滚动（或不连续）时的惯性起始间隔
+    uint8_t inertiaAppliedPerFrameMax; // 每帧最多补几步（调大=更快更猛，但会跳得更厉害）
+    uint16_t inertiaIntervalAddMs;  // 每次补步后间隔增加（调小=减速更慢、更滑）
+    uint16_t inertiaIntervalMaxMs;  // 惯性最大间隔（调大=能滑更久）
+    uint16_t mulDecayIntervalMs;    // 当惯性减速到这个间隔后开始降低倍率（调大=倍率保持更久）
+};
+
+/** @brief 按 det 方向和倍率改动一次数值 */
+typedef void (*ScreenValueEditStepFn)(int8_t det, uint8_t mul);
+
+struct ScreenValueEdit {
+    const ScreenValueEditTuning* tuning;
+    int8_t inertiaDir;          // 惯性方向：+1 向上加值，-1 向下减值
+    uint8_t inertiaSteps;       // 惯性剩余“补步”次数：越大惯性越长
+    uint8_t mul;                // 编辑加速倍率：滚得越快倍率越大
+    uint32_t inertiaNextMs;     // 下一次执行惯性补步的时间点（ms）
+    uint32_t inertiaIntervalMs; // 惯性补步间隔（ms）：越小越快；后续会逐步变大实现减速
+    uint32_t lastDetMs;         // 上一次滚轮 det 的时间戳（ms），用来判断“滚得快不快”
+};
+
+extern const ScreenValueEditTuning kScreenValueEditDefaultTuning;
+
+/** @brief tuning 为空时使用默认参数 */
+void ScreenValueEdit_Init(ScreenValueEdit* edit, const ScreenValueEditTuning* tuning);
+/** @brief 停止惯性并恢复基础倍率 */
+void ScreenValueEdit_Stop(ScreenValueEdit* edit);
+/**
+ * @brief 处理一次旋钮转动
+ * @param accelerate 是否按滚动速度放大倍率并启用惯性
+ */
+void ScreenValueEdit_Rotate(ScreenValueEdit* edit, int8_t det, bool accelerate, uint32_t nowMs, ScreenValueEditStepFn step);
+/** @brief 每帧调用，执行到期的惯性补步，返回本帧补步数 */
+uint8_t ScreenValueEdit_Tick(ScreenValueEdit* edit, uint32_t nowMs, ScreenValueEditStepFn step);
+
+#endif
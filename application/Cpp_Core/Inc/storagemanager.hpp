@@ -3,6 +3,19 @@
 
 #include "config.hpp"
 
+/**
+ * 配置文件缓存：Config 只常驻各配置文件的名片，完整内容按需从 flash 读进这几个槽位。
+ * 当前默认配置文件所在的槽位不会被换出，输入、灯效等模块缓存的指针一直有效；
+ * 其余槽位按最近使用换出。修改缓存里的配置文件后要用 requestSave / saveConfig 标记分区：
+ * 换出时还有挂起分区的内容放进写回缓冲，由 loop() 和其他挂起的分区一起写入，切换配置文件时不等擦写。
+ * 固定的是槽位而不是 ID：moveProfile() 整理顺序后调用 refreshDefaultProfile() 重新固定并通知各模块。
+ */
+#ifndef STORAGE_PROFILE_CACHE_SLOTS
+#define STORAGE_PROFILE_CACHE_SLOTS		2
+#endif
+
+static_assert(STORAGE_PROFILE_CACHE_SLOTS >= 2, "the default profile is pinned, at least one more slot is needed");
+
 // Forward declarations
 class ADCValuesCalibrator;
 class ADCValuesMarker;
@@ -22,17 +35,67 @@ public:
 	Config config;
 	
 	void initConfig();
+
+	/**
+	 * @brief 立即保存：全部分区，或只保存指定分区；之前 requestSave 挂起的分区一并写入
+	 * 之后马上重启或需要向网页端返回保存结果时使用
+	 */
 	bool saveConfig();
+	bool saveConfig(ConfigSectionMask sections);
+
+	/**
+	 * @brief 合并保存：标记分区，停止修改 CONFIG_SAVE_COALESCE_MS 后由 loop() 统一写入一次
+	 * 写入交给 FlashWriter 在后台执行，不阻塞输入；连续调节亮度、切换灯效和配置文件等场景使用
+	 */
+	void requestSave(ConfigSectionMask sections);
+	bool hasPendingSave() const {
+		return pendingSections != 0;
+	}
+	void loop();
+
+	/**
+	 * @brief 配置文件对应的分区，profile 不是 getProfileAt 返回的缓存时返回全部分区
+	 */
+	ConfigSectionMask getProfileSections(const GamepadProfile* profile, bool leds);
+
+	/**
+	 * @brief 第 index 个配置文件的完整内容，不在缓存中时从 flash 读入
+	 * 默认配置文件的指针一直有效；其余的在读入另一个不在缓存中的配置文件之前有效
+	 */
+	GamepadProfile* getProfileAt(uint8_t index);
+
+	/**
+	 * @brief 把 profile 的内容存为第 index 个配置文件（名片随之更新），写入交给 FlashWriter
+	 * profile 可以是另一个配置文件的缓存，用于整理配置文件的顺序
+	 */
+	bool storeProfileAt(uint8_t index, const GamepadProfile& profile);
+
+	/**
+	 * @brief 把第 from 个配置文件移到第 to 个，中间的依次挪一位
+	 * 只调整名片和分区组对应表（Config::profileSlots），不读写配置文件的内容；
+	 * 新顺序随 CONFIG_SECTION_GLOBAL 保存，之后调用 refreshDefaultProfile()
+	 */
+	void moveProfile(uint8_t from, uint8_t to);
+
+	/**
+	 * @brief 按 ID 查找配置文件的下标，找不到时返回 -1
+	 */
+	int8_t findProfileIndex(const char* id) const;
+
 	bool resetConfig();
 	void setInputMode(InputMode inputMode);
 	const InputMode getInputMode() {
 		return config.inputMode;
 	}
 	GamepadProfile* getGamepadProfile(char* id);
-	GamepadProfile* getDefaultGamepadProfile() {
-		return getGamepadProfile(config.defaultProfileId);
-	}
+	GamepadProfile* getDefaultGamepadProfile();
 	bool setDefaultProfileId(const char* id);
+
+	/**
+	 * @brief 配置文件的顺序被 moveProfile 整理过之后调用：重新固定默认配置文件，
+	 * 重新编译运行时镜像并通知各模块，即使默认配置文件的 ID 没有变化
+	 */
+	void refreshDefaultProfile();
 	void registerDefaultProfileChangedCallback(DefaultProfileChangedCallback cb);
 	GamepadHotkeyEntry* getGamepadHotkeyEntry() {
 		return config.hotkeys;
@@ -43,8 +106,39 @@ public:
 		return config.bootMode;
 	}
 
+	/**
+	 * @brief 配置版本号，每次保存或切换模式/配置文件时递增
+	 * 屏幕等模块空闲时只需比较版本号即可知道配置是否被其他模块修改
+	 */
+	uint32_t getConfigRevision() const {
+		return configRevision;
+	}
+
 private:
-	Storage() {}  // 私有构造函数
+	Storage() {  // 私有构造函数
+		memset(profileCacheIndex, 0xFF, sizeof(profileCacheIndex));
+	}
+
+	int8_t findCachedSlot(uint8_t index) const;
+	uint8_t evictProfileSlot();
+	bool flushWriteBack();
+	void notifyDefaultProfileChanged();
+	void syncProfileHeaders();
+	void getCachedProfiles(GamepadProfile** profiles);
+
+	uint32_t configRevision = 0;
+	ConfigSectionMask pendingSections = 0;
+	uint32_t pendingSinceMs = 0;
+	uint32_t pendingDueMs = 0;
+
+	GamepadProfile profileCache[STORAGE_PROFILE_CACHE_SLOTS];
+	int8_t profileCacheIndex[STORAGE_PROFILE_CACHE_SLOTS];		// 槽位里是第几个配置文件，-1 为空
+	uint32_t profileCacheUse[STORAGE_PROFILE_CACHE_SLOTS] = {0};
+	uint32_t profileCacheClock = 0;
+	int8_t defaultSlot = -1;		// 默认配置文件所在的槽位，不会被换出
+
+	GamepadProfile writeBack;			// 换出时还有挂起分区的配置文件，loop() 保存后释放
+	int8_t writeBackIndex = -1;			// 写回缓冲里是第几个配置文件，-1 为空
 
 };
 
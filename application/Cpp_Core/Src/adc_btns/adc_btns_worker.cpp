@@ -1,5 +1,6 @@
 #include "adc_btns/adc_btns_worker.hpp"
 #include "board_cfg.h"
+#include "profile_runtime.hpp"
 #include "stm32h7xx_hal.h" // 为HAL_GetTick()
 
 /*
@@ -107,22 +108,22 @@ ADCBtnsError ADCBtnsWorker::setup()
         return ADCBtnsError::GAMEPAD_PROFILE_NOT_FOUND;
     }
 
+    // 屏幕、网页端可能刚改过默认配置文件，先编译进后台镜像，内容没变时 request() 只比较 CRC；
+    // 触发参数取当前镜像，新镜像在下一帧开始 commit() 后由 read() 换上，和手柄输出同一帧切换
+    PROFILE_RUNTIME.request(*profile);
+
     if (mapping == nullptr)
     {
         return ADCBtnsError::MAPPING_NOT_FOUND;
     }
 
-    // 初始化启用按键掩码
-    const bool *enabledKeys = profile->keysConfig.keysEnableTag;
-    enabledKeysMask = 0;
-    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++)
-    {
-        enabledKeysMask |= (enabledKeys[i] ? (1 << i) : 0);
-    }
-
     this->mapping = mapping;
 
     maxTravelDistance = (mapping->length - 1) * mapping->step;
+    stepUm = (int32_t)(mapping->step * 1000.0f + 0.5f);
+    maxTravelUm = (int32_t)(mapping->length - 1) * stepUm;
+
+    applyRuntime(PROFILE_RUNTIME.current(), false);
 
     // 获取校准模式配置
     bool isAutoCalibrationEnabled = STORAGE_MANAGER.config.autoCalibrationEnabled;
@@ -132,39 +133,7 @@ ADCBtnsError ADCBtnsWorker::setup()
     {
         const ADCButtonValueInfo &adcBtnInfo = adcBtnInfos[i];
 
-        // 先从storage读取默认配置
-        RapidTriggerProfile *triggerConfig = &profile->triggerConfigs.triggerConfigs[i];
-
-        // 准备最终配置，初始值来自storage
-        float_t pressAccuracy = triggerConfig->pressAccuracy;
-        float_t releaseAccuracy = triggerConfig->releaseAccuracy;
-        float_t topDeadzone = triggerConfig->topDeadzone;
-        float_t bottomDeadzone = triggerConfig->bottomDeadzone;
-
-
-        // 应用最小值约束
-        if (topDeadzone < MIN_ADC_TOP_DEADZONE)
-        {
-            topDeadzone = MIN_ADC_TOP_DEADZONE;
-        }
-
-        if (bottomDeadzone < MIN_ADC_BOTTOM_DEADZONE)
-        {
-            bottomDeadzone = MIN_ADC_BOTTOM_DEADZONE;
-        }
-
-        // 使用最终配置初始化按钮
         buttonPtrs[i]->virtualPin = adcBtnInfo.virtualPin;
-        buttonPtrs[i]->pressAccuracyMm = pressAccuracy;
-        // 弹起精度 在行程前端使用高精度，后端使用低精度，低精度最小为0.1f
-        buttonPtrs[i]->releaseAccuracyMm = std::max<float_t>(releaseAccuracy, MIN_ADC_RELEASE_ACCURACY);
-        buttonPtrs[i]->highPrecisionReleaseAccuracyMm = releaseAccuracy; // 默认与释放精度相同
-        buttonPtrs[i]->topDeadzoneMm = topDeadzone;
-        buttonPtrs[i]->bottomDeadzoneMm = bottomDeadzone;
-
-        // 计算中点距离（用于高精度判断）
-        float totalTravelMm = (this->mapping->length - 1) * this->mapping->step;
-        buttonPtrs[i]->halfwayDistanceMm = totalTravelMm / 2.0f;
 
         // 根据校准模式初始化按键映射
         uint16_t topValue, bottomValue;
@@ -230,6 +199,13 @@ ADCBtn* ADCBtnsWorker::getButtonState(uint8_t buttonIndex) const
  */
 uint32_t ADCBtnsWorker::read()
 {
+    // 配置文件镜像在帧开始时 commit()，镜像换了就在这一帧开始前换上新的触发参数
+    const ProfileRuntime &runtime = PROFILE_RUNTIME.current();
+    if (runtime.sourceCrc != appliedRuntimeCrc)
+    {
+        applyRuntime(runtime, true);
+    }
+
     // 使用引用避免拷贝
     const std::array<ADCButtonValueInfo, NUM_ADC_BUTTONS> &adcValues = ADC_MANAGER.readADCValues();
 
@@ -664,15 +640,15 @@ uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn *btn, const uint16_t baseAdcVa
  * @param currentDistance 当前行程距离（mm）
  * @return 当前应使用的按下精度（mm）
  */
-float ADCBtnsWorker::getCurrentPressAccuracy(ADCBtn *btn, const float currentDistance)
+int32_t ADCBtnsWorker::getCurrentPressAccuracyUm(ADCBtn *btn, const int32_t currentDistanceUm)
 {
     if (!btn)
     {
-        return 0.1f; // 默认精度
+        return 100; // 默认精度
     }
 
     // 目前简单返回配置的按下精度，后续可根据需要添加动态精度逻辑
-    return btn->pressAccuracyMm;
+    return btn->pressAccuracyUm;
 }
 
 /**
@@ -681,21 +657,21 @@ float ADCBtnsWorker::getCurrentPressAccuracy(ADCBtn *btn, const float currentDis
  * @param currentDistance 当前行程距离（mm）
  * @return 当前应使用的弹起精度（mm）
  */
-float ADCBtnsWorker::getCurrentReleaseAccuracy(ADCBtn *btn, const float currentDistance)
+int32_t ADCBtnsWorker::getCurrentReleaseAccuracyUm(ADCBtn *btn, const int32_t currentDistanceUm)
 {
     if (!btn)
     {
-        return 0.1f; // 默认精度
+        return 100; // 默认精度
     }
 
     // 如果在前半段行程内，使用高精度弹起精度
-    if (currentDistance <= btn->halfwayDistanceMm)
+    if (currentDistanceUm <= btn->halfwayDistanceUm)
     {
-        return btn->highPrecisionReleaseAccuracyMm;
+        return btn->highPrecisionReleaseAccuracyUm;
     }
 
     // 后半段使用常规弹起精度
-    return btn->releaseAccuracyMm;
+    return btn->releaseAccuracyUm;
 }
 
 /**
@@ -851,37 +827,68 @@ void ADCBtnsWorker::calculateThresholdMapping(ADCBtn* btn)
     {
         uint16_t baseValue = btn->valueMapping[i];
 
-        // 计算当前距离
-        float currentDistance = i * mapping->step;
+        // 计算当前距离，精度和死区的判断都用整数微米
+        int32_t currentDistanceUm = i * stepUm;
 
         // 获取当前位置的按下和释放精度
-        float pressAccuracy = getCurrentPressAccuracy(btn, currentDistance);
-        float releaseAccuracy = getCurrentReleaseAccuracy(btn, currentDistance);
+        int32_t pressAccuracyUm = getCurrentPressAccuracyUm(btn, currentDistanceUm);
+        int32_t releaseAccuracyUm = getCurrentReleaseAccuracyUm(btn, currentDistanceUm);
 
         // 计算按下阈值：从当前位置向按下方向移动pressAccuracy距离
-        if(currentDistance - pressAccuracy >= maxTravelDistance - btn->topDeadzoneMm) {
-            float edgeDistance = maxTravelDistance - btn->topDeadzoneMm;
-            btn->thresholdMap.pressThresholds[i] = getValueByDistance(btn, baseValue, edgeDistance - currentDistance);
+        int32_t topEdgeUm = maxTravelUm - btn->topDeadzoneUm;
+        if(currentDistanceUm - pressAccuracyUm >= topEdgeUm) {
+            btn->thresholdMap.pressThresholds[i] = getValueByDistance(btn, baseValue, (topEdgeUm - currentDistanceUm) / 1000.0f);
         } else {
-            btn->thresholdMap.pressThresholds[i] = getValueByDistance(btn, baseValue, -pressAccuracy);
+            btn->thresholdMap.pressThresholds[i] = getValueByDistance(btn, baseValue, -pressAccuracyUm / 1000.0f);
         }
 
         // 计算释放阈值：从当前位置向释放方向移动releaseAccuracy距离
-        if (currentDistance + releaseAccuracy <= btn->bottomDeadzoneMm)
+        if (currentDistanceUm + releaseAccuracyUm <= btn->bottomDeadzoneUm)
         {
             // 底部死区：设置释放阈值为死区边缘的值
-            float edgeDistance = btn->bottomDeadzoneMm;
-            btn->thresholdMap.releaseThresholds[i] = getValueByDistance(btn, baseValue, -(currentDistance - edgeDistance));
+            btn->thresholdMap.releaseThresholds[i] = getValueByDistance(btn, baseValue, (btn->bottomDeadzoneUm - currentDistanceUm) / 1000.0f);
         }
         else
         {
-            btn->thresholdMap.releaseThresholds[i] = getValueByDistance(btn, baseValue, releaseAccuracy);
+            btn->thresholdMap.releaseThresholds[i] = getValueByDistance(btn, baseValue, releaseAccuracyUm / 1000.0f);
         }
     }
 
     btn->thresholdMap.isValid = true;
 }
 
+/**
+ * 应用配置文件镜像里的启用按键和触发参数
+ * @param runtime 配置文件镜像，最小值约束已在编译时应用
+ * @param rebuildThresholds 是否为已初始化的按键重新计算阈值映射表
+ */
+void ADCBtnsWorker::applyRuntime(const ProfileRuntime &runtime, bool rebuildThresholds)
+{
+    enabledKeysMask = runtime.enabledKeysMask;
+    appliedRuntimeCrc = runtime.sourceCrc;
+
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++)
+    {
+        ADCBtn *const btn = buttonPtrs[i];
+        const ProfileRuntimeTrigger &trigger = runtime.triggers[i];
+
+        btn->pressAccuracyUm = trigger.pressAccuracyUm;
+        // 弹起精度 在行程前端使用高精度，后端使用低精度，低精度最小为 MIN_ADC_RELEASE_ACCURACY
+        btn->releaseAccuracyUm = trigger.releaseAccuracyUm;
+        btn->highPrecisionReleaseAccuracyUm = trigger.highPrecisionReleaseAccuracyUm;
+        btn->topDeadzoneUm = trigger.topDeadzoneUm;
+        btn->bottomDeadzoneUm = trigger.bottomDeadzoneUm;
+        btn->halfwayDistanceUm = maxTravelUm / 2;
+
+        if (rebuildThresholds && btn->initCompleted && mapping)
+        {
+            calculateThresholdMapping(btn);
+            btn->cachedPressThreshold = calculatePressThreshold(btn, btn->pressStartValue);
+            btn->cachedReleaseThreshold = calculateReleaseThreshold(btn, btn->releaseStartValue);
+        }
+    }
+}
+
 /**
  * 根据ADC值获取插值计算的按下阈值
  * @param btn 按钮指针
@@ -3,6 +3,7 @@
 #include "cJSON.h"
 #include "utils.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include "board_cfg.h"
@@ -10,8 +11,12 @@
 #include <string>
 #include "configs/websocket_command_handler.hpp" // For ProfileCommandHandler
 #include "system_logger.h"
+#include "config_store.hpp"
+#include "config_schema.hpp"
+#include "storagemanager.hpp"
 
 #define CONFIG_ADDR_ORIGIN  CONFIG_ADDR
+#define CONFIG_DEFAULT_PROFILE_NAME "Profile-1"
 
 // ============================================================================
 // ConfigUtils Mappings
@@ -138,9 +143,10 @@ static void sanitize_competition_profile(GamepadProfile& profile) {
     memset(profile.keysConfig.macros, 0, sizeof(profile.keysConfig.macros));
 }
 
-static void sanitize_competition_profiles(Config& config) {
+static void sanitize_competition_profiles(GamepadProfile* const* profiles) {
+    if (!profiles) return;
     for (uint32_t i = 0; i < NUM_PROFILES; i++) {
-        sanitize_competition_profile(config.profiles[i]);
+        if (profiles[i]) sanitize_competition_profile(*profiles[i]);
     }
 }
 
@@ -158,6 +164,7 @@ cJSON* buildScreenControlConfigJSON(Config& config) {
     cJSON_AddNumberToObject(screenControlJSON, "textColor", config.screenControl.textColor);
     cJSON_AddStringToObject(screenControlJSON, "backgroundImageId", config.screenControl.backgroundImageId);
     cJSON_AddNumberToObject(screenControlJSON, "currentPageId", config.screenControl.currentPageId);
+    cJSON_AddBoolToObject(screenControlJSON, "tournamentScreenOff", config.screenControl.tournamentScreenOff != 0);
     cJSON* featuresJSON = cJSON_CreateObject();
     struct { uint8_t id; const char* key; uint32_t bit; } map[] = {
         {0, "inputModeSwitch", SCREEN_FEATURE_INPUT_MODE_SWITCH},
@@ -171,6 +178,7 @@ cJSON* buildScreenControlConfigJSON(Config& config) {
         {8, "screenBrightnessAdjust", SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST},
         {9, "webConfigEntry", SCREEN_FEATURE_WEB_CONFIG_ENTRY},
         {10, "calibrationModeSwitch", SCREEN_FEATURE_CALIBRATION_MODE_SWITCH},
+        {12, "inputMonitor", SCREEN_FEATURE_INPUT_MONITOR},
     };
     for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
         cJSON_AddBoolToObject(featuresJSON, map[i].key, (config.screenControl.featuresMask & map[i].bit) != 0);
@@ -213,7 +221,7 @@ cJSON* toJSON(Config& config) {
     cJSON* profilesJSON = cJSON_CreateArray();
     for (int i = 0; i < NUM_PROFILES; i++) {
         if (config.profiles[i].enabled) {
-            cJSON* profileJSON = ProfileCommandHandler::buildProfileJSON(&config.profiles[i]);
+            cJSON* profileJSON = ProfileCommandHandler::buildProfileJSON(STORAGE_MANAGER.getProfileAt(i));
             if (profileJSON) {
                 cJSON_AddItemToArray(profilesJSON, profileJSON);
             }
@@ -301,8 +309,10 @@ bool fromJSON(Config& config, cJSON* json) {
                  bool profileFound = false;
                  for (int i=0; i < NUM_PROFILES; i++) {
                      if (strncmp(config.profiles[i].id, idItem->valuestring, sizeof(config.profiles[i].id)) == 0) {
-                         ProfileCommandHandler::parseProfileJSON(profileItem, &config.profiles[i]);
-                         config.profiles[i].enabled = true;
+                         GamepadProfile* profile = STORAGE_MANAGER.getProfileAt(i);
+                         if (!profile) break;
+                         ProfileCommandHandler::parseProfileJSON(profileItem, profile);
+                         profile->enabled = true;
                          profileFound = true;
                          break;
                      }
@@ -354,6 +364,9 @@ bool fromJSON(Config& config, cJSON* json) {
             if (v > 65535) v = 65535;
             config.screenControl.currentPageId = (uint16_t)v;
         }
+        if ((item = cJSON_GetObjectItem(screenControl, "tournamentScreenOff")) && cJSON_IsBool(item)) {
+            config.screenControl.tournamentScreenOff = cJSON_IsTrue(item) ? 1u : 0u;
+        }
 
         cJSON* features = cJSON_GetObjectItem(screenControl, "features");
         if (features && cJSON_IsObject(features)) {
@@ -369,6 +382,7 @@ bool fromJSON(Config& config, cJSON* json) {
                 {"screenBrightnessAdjust", SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST},
                 {"webConfigEntry", SCREEN_FEATURE_WEB_CONFIG_ENTRY},
                 {"calibrationModeSwitch", SCREEN_FEATURE_CALIBRATION_MODE_SWITCH},
+                {"inputMonitor", SCREEN_FEATURE_INPUT_MONITOR},
             };
             for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
                 cJSON* b = cJSON_GetObjectItem(features, map[i].key);
@@ -392,6 +406,7 @@ bool fromJSON(Config& config, cJSON* json) {
             {"screenBrightnessAdjust", 8},
             {"webConfigEntry", 9},
             {"calibrationModeSwitch", 10},
+            {"inputMonitor", 12},
         };
         if (featuresOrder && cJSON_IsArray(featuresOrder)) {
             bool used[SCREEN_FEATURE_COUNT] = {false};
@@ -437,7 +452,7 @@ void ConfigUtils::makeDefaultProfile(GamepadProfile& profile, const char* id, bo
 {
     // 设置profile id, name, enabled
     sprintf(profile.id, id);
-    sprintf(profile.name, "Profile-1");
+    sprintf(profile.name, CONFIG_DEFAULT_PROFILE_NAME);
     profile.enabled = isEnabled;
     profile.isCompetitionProfile = false;
     
@@ -521,148 +536,225 @@ void ConfigUtils::makeDefaultProfile(GamepadProfile& profile, const char* id, bo
     profile.ledsConfigs.aroundLedColor3 = 0x0000ff;  // 蓝色
     profile.ledsConfigs.aroundLedBrightness = 50;
     profile.ledsConfigs.aroundLedAnimationSpeed = 3;
+    profile.ledsConfigs.ledReactiveFadeMs = LEDS_REACTIVE_FADE_MS;
 
     APP_DBG("ConfigUtils::makeDefaultProfile - ledsConfigs init done");
 }
 
-bool ConfigUtils::load(Config& config)
+void ConfigUtils::makeDefaultScreenControl(ScreenControlConfig& screen)
 {
-    bool fjResult;
-    fjResult = fromStorage(config);
-
-    if(fjResult == true && config.version == CONFIG_VERSION) { // 版本号一致
-        uint32_t ver = config.version;
-        APP_DBG("Config Version: %d.%d.%d", (ver>>16) & 0xff, (ver>>8) & 0xff, ver & 0xff);
-        return true;
-    } else {
+    screen.brightness = 100;
+    screen.standbyDisplay = 0;
+    screen.tournamentScreenOff = 0;
+    memset(screen.reserved0, 0, sizeof(screen.reserved0));
+    screen.backgroundColor = 0x000000;
+    screen.textColor = 0xFFFFFF;
+    screen.backgroundImageId[0] = '\0';
+    screen.currentPageId = 0;
+    screen.reserved1 = 0;
+    screen.featuresMask =
+        SCREEN_FEATURE_INPUT_MODE_SWITCH |
+        SCREEN_FEATURE_PROFILES_SWITCH |
+        SCREEN_FEATURE_SOCD_MODE_SWITCH |
+        SCREEN_FEATURE_LED_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_LED_EFFECT_SWITCH |
+        SCREEN_FEATURE_AMBIENT_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_AMBIENT_EFFECT_SWITCH |
+        SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_WEB_CONFIG_ENTRY |
+        SCREEN_FEATURE_CALIBRATION_MODE_SWITCH |
+        SCREEN_FEATURE_BUTTONS_PERFORMANCE_QUICK_SET |
+        SCREEN_FEATURE_INPUT_MONITOR;
+    for (uint32_t i = 0; i < SCREEN_FEATURE_COUNT; i++) {
+        screen.featuresOrder[i] = (uint8_t)i;
+    }
+    screen.reserved2 = 0;
+}
 
-        APP_DBG("init config, version: %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
-        // 设置基础配置
-        config.version = CONFIG_VERSION;
-        config.bootMode = BOOT_MODE_WEB_CONFIG;
-        config.inputMode = InputMode::INPUT_MODE_XINPUT;
-        strcpy(config.defaultProfileId, "profile-0");
-        config.numProfilesMax = NUM_PROFILES;
-        config.autoCalibrationEnabled = false; // 默认关闭自动校准
-        memset(config.reserved0, 0, sizeof(config.reserved0));
-        config.screenControl.brightness = 100;
-        config.screenControl.standbyDisplay = 0;
-        memset(config.screenControl.reserved0, 0, sizeof(config.screenControl.reserved0));
-        config.screenControl.backgroundColor = 0x000000;
-        config.screenControl.textColor = 0xFFFFFF;
-        config.screenControl.backgroundImageId[0] = '\0';
-        config.screenControl.currentPageId = 0;
-        config.screenControl.reserved1 = 0;
-        config.screenControl.featuresMask =
-            SCREEN_FEATURE_INPUT_MODE_SWITCH |
-            SCREEN_FEATURE_PROFILES_SWITCH |
-            SCREEN_FEATURE_SOCD_MODE_SWITCH |
-            SCREEN_FEATURE_LED_BRIGHTNESS_ADJUST |
-            SCREEN_FEATURE_LED_EFFECT_SWITCH |
-            SCREEN_FEATURE_AMBIENT_BRIGHTNESS_ADJUST |
-            SCREEN_FEATURE_AMBIENT_EFFECT_SWITCH |
-            SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST |
-            SCREEN_FEATURE_WEB_CONFIG_ENTRY |
-            SCREEN_FEATURE_CALIBRATION_MODE_SWITCH |
-            SCREEN_FEATURE_BUTTONS_PERFORMANCE_QUICK_SET;
-        for (uint32_t i = 0; i < SCREEN_FEATURE_COUNT; i++) {
-            config.screenControl.featuresOrder[i] = (uint8_t)i;
-        }
-        config.screenControl.reserved2 = 0;
-
-        APP_DBG("ConfigUtils::load - base config init done");
-
-        // 设置profiles
-        for(uint8_t k = 0; k < NUM_PROFILES; k++) {
-            // 设置profile id, name, enabled
-            char profileId[16];
-            sprintf(profileId, "profile-%d", k);
-            APP_DBG("ConfigUtils::load - make default profile %d id: %s", k, profileId);
-            ConfigUtils::makeDefaultProfile(config.profiles[k], profileId, k == 0);
-            APP_DBG("ConfigUtils::load - make profile %d init done", k);
+void ConfigUtils::makeDefaultHotkeys(GamepadHotkeyEntry* hotkeys)
+{
+    // 设置hotkeys 默认快捷键
+    for(uint8_t m = 0; m < NUM_GAMEPAD_HOTKEYS; m++) {
+        if(m < sizeof(DEFAULT_HOTKEY_LIST) / sizeof(DefaultHotkeyConfig)) {
+            hotkeys[m].isLocked = DEFAULT_HOTKEY_LIST[m].isLocked;
+            hotkeys[m].action = DEFAULT_HOTKEY_LIST[m].action;
+            hotkeys[m].isHold = DEFAULT_HOTKEY_LIST[m].isHold;
+            hotkeys[m].virtualPin = DEFAULT_HOTKEY_LIST[m].virtualPin;
+        } else {
+            hotkeys[m].isLocked = false;
+            hotkeys[m].action = GamepadHotkey::HOTKEY_NONE;
+            hotkeys[m].virtualPin = -1;
+            hotkeys[m].isHold = false;
         }
+    }
+}
 
-        APP_DBG("ConfigUtils::load - profiles init done");
+/**
+ * @brief 第 index 个配置文件的默认值（先清零，结构体填充也是确定的值）
+ */
+void ConfigUtils::makeDefaultProfileAt(GamepadProfile& profile, uint8_t index)
+{
+    char profileId[16];
+    memset(&profile, 0, sizeof(GamepadProfile));
+    sprintf(profileId, "profile-%d", index);
+    makeDefaultProfile(profile, profileId, index == 0);
+}
 
-        // 设置hotkeys 默认快捷键
-        for(uint8_t m = 0; m < NUM_GAMEPAD_HOTKEYS; m++) {
-            if(m < sizeof(DEFAULT_HOTKEY_LIST) / sizeof(DefaultHotkeyConfig)) {
-                config.hotkeys[m].isLocked = DEFAULT_HOTKEY_LIST[m].isLocked;
-                config.hotkeys[m].action = DEFAULT_HOTKEY_LIST[m].action;
-                config.hotkeys[m].isHold = DEFAULT_HOTKEY_LIST[m].isHold;
-                config.hotkeys[m].virtualPin = DEFAULT_HOTKEY_LIST[m].virtualPin;
-            } else {
-                config.hotkeys[m].isLocked = false;
-                config.hotkeys[m].action = GamepadHotkey::HOTKEY_NONE;
-                config.hotkeys[m].virtualPin = -1;
-                config.hotkeys[m].isHold = false;
-            }
-        }
+void ConfigUtils::makeDefaultConfig(Config& config)
+{
+    // 先清零：字符串尾部、结构体填充也是确定的值，和默认值比较时不会因此多存字节
+    memset(&config, 0, sizeof(Config));
+
+    // 设置基础配置
+    config.version = CONFIG_VERSION;
+    config.bootMode = BOOT_MODE_WEB_CONFIG;
+    config.inputMode = InputMode::INPUT_MODE_XINPUT;
+    strcpy(config.defaultProfileId, "profile-0");
+    config.numProfilesMax = NUM_PROFILES;
+    config.autoCalibrationEnabled = false; // 默认关闭自动校准
+    makeDefaultScreenControl(config.screenControl);
+
+    APP_DBG("ConfigUtils::makeDefaultConfig - base config init done");
+
+    // 设置profiles 名片，与 makeDefaultProfileAt 一致；完整内容由 Storage 按需读取
+    for(uint8_t k = 0; k < NUM_PROFILES; k++) {
+        sprintf(config.profiles[k].id, "profile-%d", k);
+        sprintf(config.profiles[k].name, CONFIG_DEFAULT_PROFILE_NAME);
+        config.profiles[k].enabled = k == 0;
+        config.profiles[k].isCompetitionProfile = false;
+        config.profileSlots[k] = k;
+    }
 
-        APP_DBG("ConfigUtils::load - success.");
+    APP_DBG("ConfigUtils::makeDefaultConfig - profiles init done");
 
-        return save(config);
-    } 
+    makeDefaultHotkeys(config.hotkeys);
 }
 
-static uint32_t align_up_u32(uint32_t v, uint32_t a) {
-    return (v + (a - 1)) & ~(a - 1);
+bool ConfigUtils::load(Config& config)
+{
+    if (fromStorage(config)) {
+        uint32_t ver = config.version;
+        APP_DBG("Config Version: %d.%d.%d", (ver>>16) & 0xff, (ver>>8) & 0xff, ver & 0xff);
+        return true;
+    }
+
+    APP_DBG("init config, version: %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
+    makeDefaultConfig(config);
+    APP_DBG("ConfigUtils::load - success.");
+    // 配置文件都是默认值，不用写出：缺少的分区读出来就是默认值
+    return save(config, nullptr);
 }
 
-static int8_t qspi_write_buffer_no_erase(uint8_t* pBuffer, uint32_t writeAddr, uint32_t numBytes) {
-    writeAddr &= 0x00FFFFFF;
-    int8_t status = QSPI_W25Qxx_OK;
-    while (numBytes > 0) {
-        uint32_t current_addr = writeAddr;
-        uint32_t current_size = W25Qxx_PageSize - (current_addr % W25Qxx_PageSize);
-        if (current_size > numBytes) current_size = numBytes;
-        status = QSPI_W25Qxx_WritePage(pBuffer, current_addr, (uint16_t)current_size);
-        if (status != QSPI_W25Qxx_OK) return status;
-        writeAddr += current_size;
-        pBuffer += current_size;
-        numBytes -= current_size;
-    }
-    return status;
+/**
+ * 旧格式：整个 Config 原样保存，那时配置文件完整地放在 Config 里。只用于升级时读取。
+ * 布局只能和当时的 Config 一致，不能再改。
+ */
+typedef struct
+{
+    uint32_t version;
+    BootMode bootMode;
+    InputMode inputMode;
+    char defaultProfileId[16];
+    uint8_t numProfilesMax;
+    GamepadProfile profiles[NUM_PROFILES];
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+    uint8_t reserved0[3];
+    ScreenControlConfig screenControl;
+} ConfigLegacy;
+
+/**
+ * 切块格式：ConfigLegacy 按 CONFIG_STORE_PAYLOAD_SIZE 切块存进配置日志，块号即键
+ */
+#define CONFIG_LEGACY_CHUNK_SIZE    CONFIG_STORE_PAYLOAD_SIZE
+#define CONFIG_LEGACY_CHUNK_COUNT   ((sizeof(ConfigLegacy) + CONFIG_LEGACY_CHUNK_SIZE - 1) / CONFIG_LEGACY_CHUNK_SIZE)
+
+static_assert(CONFIG_LEGACY_CHUNK_COUNT <= CONFIG_STORE_MAX_KEYS, "Config has more chunks than CONFIG_STORE_MAX_KEYS");
+
+static uint16_t config_legacy_chunk_len(uint16_t chunk) {
+    const uint32_t offset = (uint32_t)chunk * CONFIG_LEGACY_CHUNK_SIZE;
+    const uint32_t remain = (uint32_t)sizeof(ConfigLegacy) - offset;
+    return (uint16_t)(remain < CONFIG_LEGACY_CHUNK_SIZE ? remain : CONFIG_LEGACY_CHUNK_SIZE);
 }
 
-static int8_t qspi_erase_and_write_config(uint8_t* pBuffer, uint32_t addr, uint32_t size) {
-    const bool was_mmap = QSPI_W25Qxx_IsMemoryMappedMode();
-    if (was_mmap) {
-        QSPI_W25Qxx_ExitMemoryMappedMode();
+/**
+ * @brief 读取旧格式：切块的配置日志，或更早的整块写在 CONFIG_ADDR 的 Config
+ * 结构体原样保存，只有版本号与当前一致（布局相同）时才能使用
+ */
+static bool config_read_legacy(ConfigLegacy& legacy) {
+    if (CONFIG_STORE.isMounted()) {
+        uint8_t* raw = (uint8_t*)&legacy;
+        for (uint16_t k = 0; k < CONFIG_LEGACY_CHUNK_COUNT; k++) {
+            if (!CONFIG_STORE.read(k, raw + (uint32_t)k * CONFIG_LEGACY_CHUNK_SIZE, config_legacy_chunk_len(k))) {
+                APP_ERR("ConfigUtils::fromStorage - missing chunk %d.", k);
+                return false;
+            }
+        }
+    } else if (QSPI_W25Qxx_ReadBuffer_WithXIPOrNot((uint8_t*)&legacy, CONFIG_ADDR_ORIGIN, sizeof(ConfigLegacy)) != QSPI_W25Qxx_OK) {
+        APP_ERR("ConfigUtils::fromStorage - Read failure.");
+        return false;
     }
+    return legacy.version == CONFIG_VERSION;
+}
 
-    const uint32_t erase_size = align_up_u32(size, W25Qxx_SECTOR_SIZE);
-    int8_t er = QSPI_W25Qxx_BufferErase(addr, erase_size);
-    if (er != QSPI_W25Qxx_OK) {
-        if (was_mmap) QSPI_W25Qxx_EnterMemoryMappedMode();
-        return er;
+/**
+ * @brief 把旧格式转成带标签的格式：读出后立即格式化区域、整份写入
+ * 旧格式要一次读出全部配置文件，借用堆上的临时缓冲区，转换完释放
+ */
+static bool config_migrate_legacy(Config& config) {
+    ConfigLegacy* legacy = (ConfigLegacy*)malloc(sizeof(ConfigLegacy));
+    if (!legacy) {
+        APP_ERR("ConfigUtils::fromStorage - no memory for legacy config.");
+        return false;
     }
-
-    int8_t wr = qspi_write_buffer_no_erase(pBuffer, addr, size);
-    if (was_mmap) {
-        QSPI_W25Qxx_EnterMemoryMappedMode();
+    bool ok = config_read_legacy(*legacy);
+    if (ok) {
+        APP_DBG("ConfigUtils::fromStorage - migrate legacy config.");
+        config.version = legacy->version;
+        config.bootMode = legacy->bootMode;
+        config.inputMode = legacy->inputMode;
+        memcpy(config.defaultProfileId, legacy->defaultProfileId, sizeof(config.defaultProfileId));
+        config.numProfilesMax = legacy->numProfilesMax;
+        memcpy(config.hotkeys, legacy->hotkeys, sizeof(config.hotkeys));
+        config.autoCalibrationEnabled = legacy->autoCalibrationEnabled;
+        config.screenControl = legacy->screenControl;
+
+        GamepadProfile* profiles[NUM_PROFILES];
+        for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+            memcpy(&config.profiles[i], &legacy->profiles[i], sizeof(GamepadProfileHeader));
+            profiles[i] = &legacy->profiles[i];
+        }
+        ok = ConfigUtils::save(config, profiles);
     }
-    return wr;
+    free(legacy);
+    return ok;
 }
 
-bool ConfigUtils::save(Config& config)
+bool ConfigUtils::save(Config& config, GamepadProfile* const* profiles, ConfigSectionMask sections)
 {
     APP_DBG("ConfigUtils::save begin");
-    sanitize_competition_profiles(config);
+    sanitize_competition_profiles(profiles);
 
-    const uint32_t cfgSize = (uint32_t)sizeof(Config);
-    int8_t result = qspi_erase_and_write_config((uint8_t*)&config, CONFIG_ADDR_ORIGIN, cfgSize);
-    if(result == QSPI_W25Qxx_OK) {
-        APP_DBG("ConfigUtils::save - success.");
-        return true;
-    } else {
+    // 区域里还是旧格式或从未写过：格式化成日志，之后整份写入
+    if (!CONFIG_STORE.isMounted() || !ConfigSchema::isPresent()) {
+        if (!CONFIG_STORE.format()) {
+            APP_ERR("ConfigUtils::save - format failure.");
+            return false;
+        }
+        sections = CONFIG_SECTION_ALL;
+    }
+
+    if (!ConfigSchema::save(config, profiles, sections)) {
         APP_ERR("ConfigUtils::save - Write failure.");
         return false;
     }
+    APP_DBG("ConfigUtils::save - success.");
+    return true;
 }
 
 /**
  * @brief 重置配置
+ * 配置文件的分区随格式化一起清掉，之后读出的都是默认值
  * 
  * @param config 
  * @return true 
@@ -670,16 +762,17 @@ bool ConfigUtils::save(Config& config)
  */
 bool ConfigUtils::reset(Config& config)
 {
-    int8_t result = QSPI_W25Qxx_BufferErase(CONFIG_ADDR_ORIGIN, 64*1024);
-    if(result != QSPI_W25Qxx_OK) {
-        APP_ERR("ConfigUtils::reset - block erase failure.");
+    if(!CONFIG_STORE.format()) {
+        APP_ERR("ConfigUtils::reset - erase failure.");
         return false;
     }
-    return ConfigUtils::load(config);
+    makeDefaultConfig(config);
+    return ConfigSchema::save(config, nullptr, CONFIG_SECTION_ALL);
 }
 
 /**
  * @brief 从存储中读取配置
+ * 先填默认值，再叠加存储中与默认值不同的字段；配置文件只读名片。旧格式读出后就地转换
  * 
  * @param config 
  * @return true 
@@ -687,15 +780,25 @@ bool ConfigUtils::reset(Config& config)
  */
 bool ConfigUtils::fromStorage(Config& config)
 {
-    int8_t result;
     APP_DBG("ConfigUtils::fromStorage begin. CONFIG_ADDR_ORIGIN: %p", (void*)CONFIG_ADDR_ORIGIN);
-    
-    result = QSPI_W25Qxx_ReadBuffer_WithXIPOrNot((uint8_t*)&config, CONFIG_ADDR_ORIGIN, sizeof(Config));
-    if(result == QSPI_W25Qxx_OK) {
+
+    CONFIG_STORE.mount();
+    makeDefaultConfig(config);
+    if (ConfigSchema::load(config)) {
+        config.version = CONFIG_VERSION;
         APP_DBG("ConfigUtils::fromStorage - success.");
         return true;
-    } else {
-        APP_ERR("ConfigUtils::fromStorage - Read failure.");
+    }
+    if (ConfigSchema::isPresent()) {
+        APP_ERR("ConfigUtils::fromStorage - no sections.");
         return false;
     }
+
+    // 还没有新格式：按旧格式读取并转换
+    if (config_migrate_legacy(config)) {
+        APP_DBG("ConfigUtils::fromStorage - legacy config.");
+        return true;
+    }
+    makeDefaultConfig(config);
+    return false;
 }
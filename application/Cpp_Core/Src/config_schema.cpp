@@ -0,0 +1,641 @@
+#include "config_schema.hpp"
+#include "config_store.hpp"
+#include "board_cfg.h"
+#include <string.h>
+#include <stddef.h>
+
+#define CONFIG_SCHEMA_HEADER_SIZE   4
+#define CONFIG_SCHEMA_KEY_MARKER    0
+
+struct ConfigSchemaField {
+    uint8_t tag;
+    uint16_t offset;        // 相对分区所在结构体
+    uint16_t size;          // 单个元素的字节数
+    uint8_t count;          // 数组按元素存储，标量为 1
+    uint16_t stride;        // 相邻元素的间距
+};
+
+struct ConfigSchemaMarker {
+    uint32_t magic;         // CONFIG_SCHEMA_MAGIC
+    uint8_t version;        // 写入标记时的 CONFIG_SCHEMA_VERSION
+    uint8_t defaultsVersion;    // 日志里省略的字段按哪一版默认值（CONFIG_SCHEMA_DEFAULTS_VERSION）
+    uint8_t reserved[2];
+};
+
+#define SCHEMA_FIELD(tag, type, member) \
+    { tag, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type*)0)->member), 1, 0 }
+#define SCHEMA_ARRAY(tag, type, member, count, stride) \
+    { tag, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type*)0)->member), (uint8_t)(count), (uint16_t)(stride) }
+
+/*
+ * 字段表。标签在同一类分区内唯一，一经使用不再改作他用。
+ * 保留字节不存；全局分区没有默认值可比，每次整段写出（只有几十字节）。
+ */
+
+// 全局：相对 Config；version 不存，读出后置为 CONFIG_VERSION
+static constexpr ConfigSchemaField GLOBAL_FIELDS[] = {
+    SCHEMA_FIELD(1, Config, bootMode),
+    SCHEMA_FIELD(2, Config, inputMode),
+    SCHEMA_FIELD(3, Config, defaultProfileId),
+    SCHEMA_FIELD(4, Config, numProfilesMax),
+    SCHEMA_FIELD(5, Config, autoCalibrationEnabled),
+    SCHEMA_FIELD(6, Config, profileSlots),
+};
+
+// 快捷键：相对 Config::hotkeys
+static constexpr ConfigSchemaField HOTKEY_FIELDS[] = {
+    SCHEMA_ARRAY(1, GamepadHotkeyEntry, virtualPin, NUM_GAMEPAD_HOTKEYS, sizeof(GamepadHotkeyEntry)),
+    SCHEMA_ARRAY(2, GamepadHotkeyEntry, action,     NUM_GAMEPAD_HOTKEYS, sizeof(GamepadHotkeyEntry)),
+    SCHEMA_ARRAY(3, GamepadHotkeyEntry, isHold,     NUM_GAMEPAD_HOTKEYS, sizeof(GamepadHotkeyEntry)),
+    SCHEMA_ARRAY(4, GamepadHotkeyEntry, isLocked,   NUM_GAMEPAD_HOTKEYS, sizeof(GamepadHotkeyEntry)),
+};
+
+// 屏幕：相对 Config::screenControl
+static constexpr ConfigSchemaField SCREEN_FIELDS[] = {
+    SCHEMA_FIELD(1, ScreenControlConfig, brightness),
+    SCHEMA_FIELD(2, ScreenControlConfig, standbyDisplay),
+    SCHEMA_FIELD(3, ScreenControlConfig, tournamentScreenOff),
+    SCHEMA_FIELD(4, ScreenControlConfig, backgroundColor),
+    SCHEMA_FIELD(5, ScreenControlConfig, textColor),
+    SCHEMA_FIELD(6, ScreenControlConfig, backgroundImageId),
+    SCHEMA_FIELD(7, ScreenControlConfig, currentPageId),
+    SCHEMA_FIELD(8, ScreenControlConfig, featuresMask),
+    SCHEMA_FIELD(9, ScreenControlConfig, featuresOrder),
+};
+
+// 配置文件中灯效以外的部分：相对 GamepadProfile。前 PROFILE_HEADER_FIELDS 项是名片，排在最前面
+static constexpr ConfigSchemaField PROFILE_FIELDS[] = {
+    SCHEMA_FIELD(1,  GamepadProfile, id),
+    SCHEMA_FIELD(2,  GamepadProfile, name),
+    SCHEMA_FIELD(3,  GamepadProfile, enabled),
+    SCHEMA_FIELD(4,  GamepadProfile, isCompetitionProfile),
+
+    SCHEMA_FIELD(10, GamepadProfile, keysConfig.socdMode),
+    SCHEMA_FIELD(11, GamepadProfile, keysConfig.fourWayMode),
+    SCHEMA_FIELD(12, GamepadProfile, keysConfig.invertXAxis),
+    SCHEMA_FIELD(13, GamepadProfile, keysConfig.invertYAxis),
+    SCHEMA_FIELD(14, GamepadProfile, keysConfig.keysEnableTag),
+    SCHEMA_ARRAY(15, GamepadProfile, keysConfig.keyMapping[0], NUM_GAME_CONTROLLER_BUTTONS, sizeof(uint32_t)),
+    SCHEMA_ARRAY(16, GamepadProfile, keysConfig.keyCombinations[0], MAX_KEY_COMBINATION, sizeof(KeyCombination)),
+
+    SCHEMA_ARRAY(20, GamepadProfile, keysConfig.macros[0].numSteps,       MAX_NUM_MACROS, sizeof(MacroConfig)),
+    SCHEMA_ARRAY(21, GamepadProfile, keysConfig.macros[0].numTriggerKeys, MAX_NUM_MACROS, sizeof(MacroConfig)),
+    SCHEMA_ARRAY(22, GamepadProfile, keysConfig.macros[0].triggerKeys,    MAX_NUM_MACROS, sizeof(MacroConfig)),
+    SCHEMA_ARRAY(23, GamepadProfile, keysConfig.macros[0].steps,          MAX_NUM_MACROS, sizeof(MacroConfig)),
+
+    SCHEMA_FIELD(30, GamepadProfile, triggerConfigs.isAllBtnsConfiguring),
+    SCHEMA_FIELD(31, GamepadProfile, triggerConfigs.debounceAlgorithm),
+    SCHEMA_ARRAY(32, GamepadProfile, triggerConfigs.triggerConfigs[0], NUM_ADC_BUTTONS, sizeof(RapidTriggerProfile)),
+};
+
+// 配置文件的灯效：相对 GamepadProfile
+static constexpr ConfigSchemaField LEDS_FIELDS[] = {
+    SCHEMA_FIELD(1,  GamepadProfile, ledsConfigs.ledEnabled),
+    SCHEMA_FIELD(2,  GamepadProfile, ledsConfigs.ledEffect),
+    SCHEMA_FIELD(3,  GamepadProfile, ledsConfigs.ledColor1),
+    SCHEMA_FIELD(4,  GamepadProfile, ledsConfigs.ledColor2),
+    SCHEMA_FIELD(5,  GamepadProfile, ledsConfigs.ledColor3),
+    SCHEMA_FIELD(6,  GamepadProfile, ledsConfigs.ledBrightness),
+    SCHEMA_FIELD(7,  GamepadProfile, ledsConfigs.ledAnimationSpeed),
+    SCHEMA_FIELD(8,  GamepadProfile, ledsConfigs.aroundLedEnabled),
+    SCHEMA_FIELD(9,  GamepadProfile, ledsConfigs.aroundLedSyncToMainLed),
+    SCHEMA_FIELD(10, GamepadProfile, ledsConfigs.aroundLedTriggerByButton),
+    SCHEMA_FIELD(11, GamepadProfile, ledsConfigs.aroundLedEffect),
+    SCHEMA_FIELD(12, GamepadProfile, ledsConfigs.aroundLedColor1),
+    SCHEMA_FIELD(13, GamepadProfile, ledsConfigs.aroundLedColor2),
+    SCHEMA_FIELD(14, GamepadProfile, ledsConfigs.aroundLedColor3),
+    SCHEMA_FIELD(15, GamepadProfile, ledsConfigs.aroundLedBrightness),
+    SCHEMA_FIELD(16, GamepadProfile, ledsConfigs.aroundLedAnimationSpeed),
+    SCHEMA_FIELD(17, GamepadProfile, ledsConfigs.ledReactiveFadeMs),
+};
+
+#define SCHEMA_COUNT(fields)    ((uint8_t)(sizeof(fields) / sizeof(fields[0])))
+
+// 名片字段（GamepadProfileHeader）的个数
+#define PROFILE_HEADER_FIELDS   4
+
+/**
+ * @brief 所有字段都不是默认值时的编码长度（含分区头）
+ */
+static constexpr uint32_t schema_max_size(const ConfigSchemaField* fields, uint8_t numFields) {
+    uint32_t n = CONFIG_SCHEMA_HEADER_SIZE;
+    for (uint8_t i = 0; i < numFields; i++) {
+        n += (uint32_t)fields[i].count * (3u + (fields[i].size >= 0x80 ? 1u : 0u) + fields[i].size);
+    }
+    return n;
+}
+
+static constexpr uint16_t schema_parts(uint32_t size) {
+    return (uint16_t)((size + CONFIG_STORE_PAYLOAD_SIZE - 1) / CONFIG_STORE_PAYLOAD_SIZE);
+}
+
+#define SCHEMA_MAX_SIZE(fields) schema_max_size(fields, SCHEMA_COUNT(fields))
+
+static constexpr uint16_t GLOBAL_PARTS  = schema_parts(SCHEMA_MAX_SIZE(GLOBAL_FIELDS));
+static constexpr uint16_t HOTKEY_PARTS  = schema_parts(SCHEMA_MAX_SIZE(HOTKEY_FIELDS));
+static constexpr uint16_t SCREEN_PARTS  = schema_parts(SCHEMA_MAX_SIZE(SCREEN_FIELDS));
+static constexpr uint16_t PROFILE_PARTS = schema_parts(SCHEMA_MAX_SIZE(PROFILE_FIELDS));
+static constexpr uint16_t LEDS_PARTS    = schema_parts(SCHEMA_MAX_SIZE(LEDS_FIELDS));
+
+// 键 0 是格式标记，之后依次是全局、快捷键、屏幕、各配置文件、各配置文件的灯效
+#define SCHEMA_KEY_GLOBAL       1
+#define SCHEMA_KEY_HOTKEYS      (SCHEMA_KEY_GLOBAL + GLOBAL_PARTS)
+#define SCHEMA_KEY_SCREEN       (SCHEMA_KEY_HOTKEYS + HOTKEY_PARTS)
+#define SCHEMA_KEY_PROFILES     (SCHEMA_KEY_SCREEN + SCREEN_PARTS)
+#define SCHEMA_KEY_LEDS         (SCHEMA_KEY_PROFILES + NUM_PROFILES * PROFILE_PARTS)
+#define SCHEMA_KEY_COUNT        (SCHEMA_KEY_LEDS + NUM_PROFILES * LEDS_PARTS)
+
+// 分区编号：0 全局，1 快捷键，2 屏幕，之后每个配置文件两个分区（灯效以外 / 灯效）
+#define SCHEMA_SECTION_GLOBAL       0
+#define SCHEMA_SECTION_HOTKEYS      1
+#define SCHEMA_SECTION_SCREEN       2
+#define SCHEMA_SECTION_PROFILE(i)   (3 + (i))
+#define SCHEMA_SECTION_LEDS(i)      (3 + NUM_PROFILES + (i))
+#define SCHEMA_SECTION_COUNT        (3 + 2 * NUM_PROFILES)
+
+#define SCHEMA_BUFFER_SIZE      (PROFILE_PARTS * CONFIG_STORE_PAYLOAD_SIZE)
+
+static_assert(GLOBAL_PARTS <= PROFILE_PARTS && HOTKEY_PARTS <= PROFILE_PARTS
+    && SCREEN_PARTS <= PROFILE_PARTS && LEDS_PARTS <= PROFILE_PARTS, "profile section must be the largest");
+static_assert(SCHEMA_KEY_COUNT <= CONFIG_STORE_MAX_KEYS, "config schema has more keys than CONFIG_STORE_MAX_KEYS");
+static_assert(SCHEMA_KEY_COUNT + CONFIG_STORE_RECORDS_PER_SECTOR * (CONFIG_STORE_RESERVE_SECTORS + 1)
+    <= CONFIG_STORE_SECTORS * CONFIG_STORE_RECORDS_PER_SECTOR, "Config does not fit in the config store");
+static_assert(SCHEMA_SECTION_COUNT <= 0xFF, "section number must fit in the section header");
+static_assert(schema_max_size(PROFILE_FIELDS, PROFILE_HEADER_FIELDS) <= CONFIG_STORE_PAYLOAD_SIZE,
+    "profile header must fit in the first part of its section");
+static_assert(NUM_ADC_BUTTONS <= 0xFF && NUM_GAME_CONTROLLER_BUTTONS <= 0xFF, "array index must fit in one byte");
+
+/*
+ * 迁移表：s_migrations[v] 把刚读出的版本 v 的分区改成版本 v + 1 的含义，不需要时为 nullptr。
+ * base 是分区所在的结构体（见 schema_base）。版本 0 是旧的整块格式，由 ConfigUtils::fromStorage 处理，不经过这里。
+ * 启动时只读名片，不经过迁移：名片字段的含义不能变。
+ */
+typedef void (*ConfigSchemaMigration)(uint8_t section, uint8_t* base);
+
+static const ConfigSchemaMigration s_migrations[CONFIG_SCHEMA_VERSION] = {
+    nullptr,
+};
+
+/*
+ * 默认值回退表：s_defaultsRollback[v] 把版本 v + 1 的默认值改回版本 v 的，默认值没变时为 nullptr。
+ * defaults 与 schema_base 同样的结构。旧日志省略的字段按这样重建出的默认值解码。
+ */
+typedef void (*ConfigSchemaDefaultsRollback)(uint8_t section, uint8_t* defaults);
+
+static const ConfigSchemaDefaultsRollback s_defaultsRollback[CONFIG_SCHEMA_DEFAULTS_VERSION] = {
+    nullptr,    // 版本 0：格式标记里还没有默认值版本，默认值与版本 1 相同
+};
+
+// 日志按哪一版默认值编码；读取时由格式标记更新，格式化后是当前版本
+static uint8_t s_defaultsVersion = CONFIG_SCHEMA_DEFAULTS_VERSION;
+
+// 一个分区的编码；保存时也作比较用
+static uint8_t s_buffer[SCHEMA_BUFFER_SIZE];
+
+// 编码时比较用的默认值
+static union {
+    GamepadProfile profile;
+    ScreenControlConfig screen;
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+} s_defaults;
+
+struct ConfigSchemaSection {
+    const ConfigSchemaField* fields;
+    uint8_t numFields;
+    uint16_t key;
+    uint16_t parts;
+};
+
+static ConfigSchemaSection schema_section(uint8_t section) {
+    if (section == SCHEMA_SECTION_GLOBAL) {
+        return { GLOBAL_FIELDS, SCHEMA_COUNT(GLOBAL_FIELDS), SCHEMA_KEY_GLOBAL, GLOBAL_PARTS };
+    }
+    if (section == SCHEMA_SECTION_HOTKEYS) {
+        return { HOTKEY_FIELDS, SCHEMA_COUNT(HOTKEY_FIELDS), SCHEMA_KEY_HOTKEYS, HOTKEY_PARTS };
+    }
+    if (section == SCHEMA_SECTION_SCREEN) {
+        return { SCREEN_FIELDS, SCHEMA_COUNT(SCREEN_FIELDS), SCHEMA_KEY_SCREEN, SCREEN_PARTS };
+    }
+    if (section < SCHEMA_SECTION_LEDS(0)) {
+        const uint16_t i = section - SCHEMA_SECTION_PROFILE(0);
+        return { PROFILE_FIELDS, SCHEMA_COUNT(PROFILE_FIELDS), (uint16_t)(SCHEMA_KEY_PROFILES + i * PROFILE_PARTS), PROFILE_PARTS };
+    }
+    const uint16_t i = section - SCHEMA_SECTION_LEDS(0);
+    return { LEDS_FIELDS, SCHEMA_COUNT(LEDS_FIELDS), (uint16_t)(SCHEMA_KEY_LEDS + i * LEDS_PARTS), LEDS_PARTS };
+}
+
+/**
+ * @brief 配置文件分区所在的分区组
+ */
+static uint8_t schema_profile_slot(uint8_t section) {
+    return section < SCHEMA_SECTION_LEDS(0) ? section - SCHEMA_SECTION_PROFILE(0) : section - SCHEMA_SECTION_LEDS(0);
+}
+
+/**
+ * @brief 存放在第 slot 组分区里的是第几个配置文件
+ */
+static uint8_t schema_profile_index(const Config& config, uint8_t slot) {
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        if (config.profileSlots[i] == slot) return i;
+    }
+    return slot;
+}
+
+static ConfigSectionMask schema_section_mask(const Config& config, uint8_t section) {
+    if (section == SCHEMA_SECTION_GLOBAL) return CONFIG_SECTION_GLOBAL;
+    if (section == SCHEMA_SECTION_HOTKEYS) return CONFIG_SECTION_HOTKEYS;
+    if (section == SCHEMA_SECTION_SCREEN) return CONFIG_SECTION_SCREEN;
+    const uint8_t index = schema_profile_index(config, schema_profile_slot(section));
+    return section < SCHEMA_SECTION_LEDS(0) ? CONFIG_SECTION_PROFILE(index) : CONFIG_SECTION_PROFILE_LEDS(index);
+}
+
+/**
+ * @brief 分区字段所在的结构体；配置文件的分区取 profiles 中的一项，不在内存中时返回 nullptr
+ */
+static const uint8_t* schema_base(const Config& config, const GamepadProfile* const* profiles, uint8_t section) {
+    if (section == SCHEMA_SECTION_GLOBAL) return (const uint8_t*)&config;
+    if (section == SCHEMA_SECTION_HOTKEYS) return (const uint8_t*)config.hotkeys;
+    if (section == SCHEMA_SECTION_SCREEN) return (const uint8_t*)&config.screenControl;
+    return profiles ? (const uint8_t*)profiles[schema_profile_index(config, schema_profile_slot(section))] : nullptr;
+}
+
+/**
+ * @brief 分区组对应表必须是 0..NUM_PROFILES-1 的一个排列，否则按下标对应
+ */
+static void schema_check_slots(Config& config) {
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        const uint8_t slot = config.profileSlots[i];
+        if (slot >= NUM_PROFILES || (seen & (1u << slot))) {
+            APP_ERR("ConfigSchema: bad profile slot table, reset.");
+            for (uint8_t k = 0; k < NUM_PROFILES; k++) config.profileSlots[k] = k;
+            return;
+        }
+        seen |= 1u << slot;
+    }
+}
+
+/**
+ * @brief 第 version 版的分区默认值，与 schema_base 同样的结构；全局分区返回 nullptr
+ */
+static const uint8_t* schema_defaults(uint8_t section, uint8_t version) {
+    memset(&s_defaults, 0, sizeof(s_defaults));
+    if (section == SCHEMA_SECTION_GLOBAL) {
+        return nullptr;
+    }
+    if (section == SCHEMA_SECTION_HOTKEYS) {
+        ConfigUtils::makeDefaultHotkeys(s_defaults.hotkeys);
+    } else if (section == SCHEMA_SECTION_SCREEN) {
+        ConfigUtils::makeDefaultScreenControl(s_defaults.screen);
+    } else {
+        ConfigUtils::makeDefaultProfileAt(s_defaults.profile, schema_profile_slot(section));
+    }
+    for (uint8_t v = CONFIG_SCHEMA_DEFAULTS_VERSION; v > version; v--) {
+        if (s_defaultsRollback[v - 1]) s_defaultsRollback[v - 1](section, (uint8_t*)&s_defaults);
+    }
+    return (const uint8_t*)&s_defaults;
+}
+
+/**
+ * @brief 编码一个分区；elide 为 true 时省略和当前默认值相同的元素，否则全部写出
+ * @return 编码长度（含分区头），out 不够大时返回 0
+ */
+static uint16_t schema_encode(const uint8_t* base, uint8_t section, uint8_t* out, uint16_t capacity, bool elide) {
+    const ConfigSchemaSection desc = schema_section(section);
+    const uint8_t* defaults = elide ? schema_defaults(section, CONFIG_SCHEMA_DEFAULTS_VERSION) : nullptr;
+
+    uint16_t pos = CONFIG_SCHEMA_HEADER_SIZE;
+    for (uint8_t f = 0; f < desc.numFields; f++) {
+        const ConfigSchemaField& field = desc.fields[f];
+        for (uint8_t i = 0; i < field.count; i++) {
+            const uint32_t offset = field.offset + (uint32_t)i * field.stride;
+            const uint8_t* value = base + offset;
+            const uint16_t len = field.size;
+            // 只省略整个元素：部分省略的字节读取时会落到新固件的默认值上
+            if (defaults && memcmp(value, defaults + offset, len) == 0) continue;
+            const uint16_t headerLen = len >= 0x80 ? 4 : 3;
+            if ((uint32_t)pos + headerLen + len > capacity) return 0;
+            out[pos++] = field.tag;
+            out[pos++] = i;
+            if (len >= 0x80) {
+                out[pos++] = (uint8_t)(0x80 | (len >> 8));
+            }
+            out[pos++] = (uint8_t)len;
+            memcpy(out + pos, value, len);
+            pos = (uint16_t)(pos + len);
+        }
+    }
+    const uint16_t body = (uint16_t)(pos - CONFIG_SCHEMA_HEADER_SIZE);
+    out[0] = CONFIG_SCHEMA_VERSION;
+    out[1] = section;
+    out[2] = (uint8_t)body;
+    out[3] = (uint8_t)(body >> 8);
+    return pos;
+}
+
+/**
+ * @brief 遍历分区正文；apply 为 false 时只检查格式
+ */
+static bool schema_walk(const ConfigSchemaSection& desc, uint8_t* base, const uint8_t* in, uint16_t end, bool apply) {
+    uint16_t pos = CONFIG_SCHEMA_HEADER_SIZE;
+    while (pos < end) {
+        if (pos + 3 > end) return false;
+        const uint8_t tag = in[pos++];
+        const uint8_t index = in[pos++];
+        uint16_t len = in[pos++];
+        if (len & 0x80) {
+            if (pos >= end) return false;
+            len = (uint16_t)(((len & 0x7F) << 8) | in[pos++]);
+        }
+        if (pos + len > end) return false;
+        if (apply) {
+            for (uint8_t f = 0; f < desc.numFields; f++) {
+                const ConfigSchemaField& field = desc.fields[f];
+                if (field.tag != tag) continue;
+                // 新固件加长的数组、变长的字段：超出部分丢弃
+                if (index < field.count) {
+                    memcpy(base + field.offset + (uint32_t)index * field.stride, in + pos, len < field.size ? len : field.size);
+                }
+                break;
+            }
+        }
+        pos = (uint16_t)(pos + len);
+    }
+    return true;
+}
+
+static uint16_t schema_encoded_length(const uint8_t* header) {
+    return (uint16_t)(CONFIG_SCHEMA_HEADER_SIZE + (header[2] | (header[3] << 8)));
+}
+
+static bool schema_decode(uint8_t* base, uint8_t section, const uint8_t* in, uint16_t len) {
+    if (len < CONFIG_SCHEMA_HEADER_SIZE || in[1] != section || schema_encoded_length(in) > len) return false;
+    const ConfigSchemaSection desc = schema_section(section);
+    const uint16_t end = schema_encoded_length(in);
+    if (!schema_walk(desc, base, in, end, false)) return false;
+    schema_walk(desc, base, in, end, true);
+
+    const uint8_t version = in[0];
+    if (version > CONFIG_SCHEMA_VERSION) {
+        APP_DBG("ConfigSchema: section %d is version %d, newer fields ignored", section, version);
+    }
+    for (uint8_t v = version; v < CONFIG_SCHEMA_VERSION; v++) {
+        if (s_migrations[v]) s_migrations[v](section, base);
+    }
+    return true;
+}
+
+/**
+ * @brief 读出一个分区的全部部分
+ * @return 编码长度，分区不存在或不完整时返回 0
+ */
+static uint16_t schema_read(uint8_t section) {
+    const ConfigSchemaSection desc = schema_section(section);
+    uint16_t n;
+    if (!CONFIG_STORE.read(desc.key, s_buffer, CONFIG_STORE_PAYLOAD_SIZE, &n) || n < CONFIG_SCHEMA_HEADER_SIZE) return 0;
+    // 分区变短后多出来的部分仍留在日志里，按分区头的长度只读需要的部分
+    const uint16_t total = schema_encoded_length(s_buffer);
+    if (total > (uint32_t)desc.parts * CONFIG_STORE_PAYLOAD_SIZE) return 0;
+    uint16_t pos = n;
+    for (uint16_t p = 1; pos < total && p < desc.parts; p++) {
+        if (!CONFIG_STORE.read((uint16_t)(desc.key + p), s_buffer + pos, CONFIG_STORE_PAYLOAD_SIZE, &n)) return 0;
+        pos = (uint16_t)(pos + n);
+    }
+    return pos >= total ? total : 0;
+}
+
+/**
+ * @brief 只读配置文件分区的第一部分，把名片字段叠加到 header 上
+ * 名片编码在分区最前面，不用读出整个分区
+ */
+static bool schema_read_header(uint8_t section, GamepadProfileHeader& header) {
+    const ConfigSchemaSection desc = schema_section(section);
+    uint16_t n;
+    if (!CONFIG_STORE.read(desc.key, s_buffer, CONFIG_STORE_PAYLOAD_SIZE, &n) || n < CONFIG_SCHEMA_HEADER_SIZE || s_buffer[1] != section) {
+        return false;
+    }
+    const uint16_t total = schema_encoded_length(s_buffer);
+    const uint16_t limit = total < n ? total : n;
+    // 截到第一部分里最后一条完整的记录
+    uint16_t end = CONFIG_SCHEMA_HEADER_SIZE;
+    while (end + 3 <= limit) {
+        uint16_t pos = (uint16_t)(end + 2);
+        uint16_t len = s_buffer[pos++];
+        if (len & 0x80) {
+            if (pos >= limit) break;
+            len = (uint16_t)(((len & 0x7F) << 8) | s_buffer[pos++]);
+        }
+        if (pos + len > limit) break;
+        end = (uint16_t)(pos + len);
+    }
+    const ConfigSchemaSection headerDesc = { desc.fields, PROFILE_HEADER_FIELDS, desc.key, desc.parts };
+    return schema_walk(headerDesc, (uint8_t*)&header, s_buffer, end, true);
+}
+
+static bool schema_read_marker(ConfigSchemaMarker& marker) {
+    if (!CONFIG_STORE.isMounted()) return false;
+    // 旧格式的键 0 是整块配置的第一块，长度不同，读取直接失败
+    return CONFIG_STORE.read(CONFIG_SCHEMA_KEY_MARKER, &marker, sizeof(marker)) && marker.magic == CONFIG_SCHEMA_MAGIC;
+}
+
+/**
+ * @brief 在当前事务里写入格式标记
+ */
+static bool schema_write_marker() {
+    ConfigSchemaMarker marker = {};
+    marker.magic = CONFIG_SCHEMA_MAGIC;
+    marker.version = CONFIG_SCHEMA_VERSION;
+    marker.defaultsVersion = CONFIG_SCHEMA_DEFAULTS_VERSION;
+    return CONFIG_STORE.write(CONFIG_SCHEMA_KEY_MARKER, &marker, sizeof(marker));
+}
+
+/**
+ * @brief 日志还按旧版默认值编码时（重写没有完成），解码前把 base 换成那一版的默认值
+ */
+static void schema_fill_stored_defaults(uint8_t* base, uint8_t section, uint16_t size) {
+    if (s_defaultsVersion == CONFIG_SCHEMA_DEFAULTS_VERSION) return;
+    const uint8_t* defaults = schema_defaults(section, s_defaultsVersion);
+    if (defaults) memcpy(base, defaults, size);
+}
+
+/**
+ * @brief 日志按旧版默认值编码：各分区按当时的默认值解码后不省略字段整段重写，最后更新格式标记
+ * 整段写出的分区和默认值无关，中途断电时新旧分区混在一起也能正确读出，下次启动接着重写
+ */
+static bool schema_upgrade_defaults() {
+    bool changed = false;
+    for (uint8_t v = s_defaultsVersion; v < CONFIG_SCHEMA_DEFAULTS_VERSION; v++) {
+        if (s_defaultsRollback[v]) changed = true;
+    }
+    for (uint8_t s = SCHEMA_SECTION_HOTKEYS; changed && s < SCHEMA_SECTION_COUNT; s++) {
+        const uint16_t stored = schema_read(s);
+        uint8_t* value = const_cast<uint8_t*>(schema_defaults(s, s_defaultsVersion));
+        if (stored > 0 && !schema_decode(value, s, s_buffer, stored)) {
+            APP_ERR("ConfigSchema: bad section %d, defaults kept.", s);
+        }
+        const uint16_t len = schema_encode(value, s, s_buffer, sizeof(s_buffer), false);
+        const uint16_t parts = schema_parts(len);
+        const uint16_t key = schema_section(s).key;
+        if (len == 0 || CONFIG_STORE.reserve(parts) < parts || !CONFIG_STORE.begin()) return false;
+        for (uint16_t p = 0; p < parts; p++) {
+            const uint16_t offset = (uint16_t)(p * CONFIG_STORE_PAYLOAD_SIZE);
+            const uint16_t partLen = (uint16_t)(len - offset < CONFIG_STORE_PAYLOAD_SIZE ? len - offset : CONFIG_STORE_PAYLOAD_SIZE);
+            if (!CONFIG_STORE.write((uint16_t)(key + p), s_buffer + offset, partLen)) return false;
+        }
+        if (!CONFIG_STORE.commit()) return false;
+    }
+    if (CONFIG_STORE.reserve(1) < 1 || !CONFIG_STORE.begin() || !schema_write_marker() || !CONFIG_STORE.commit()) {
+        return false;
+    }
+    s_defaultsVersion = CONFIG_SCHEMA_DEFAULTS_VERSION;
+    return true;
+}
+
+bool ConfigSchema::isPresent()
+{
+    ConfigSchemaMarker marker;
+    return schema_read_marker(marker);
+}
+
+bool ConfigSchema::load(Config& config)
+{
+    ConfigSchemaMarker marker;
+    if (!schema_read_marker(marker)) return false;
+    s_defaultsVersion = marker.defaultsVersion;
+    if (s_defaultsVersion > CONFIG_SCHEMA_DEFAULTS_VERSION) {
+        // 新固件写的日志：省略的字段只能按本固件的默认值读
+        APP_DBG("ConfigSchema: defaults version %d is newer", s_defaultsVersion);
+        s_defaultsVersion = CONFIG_SCHEMA_DEFAULTS_VERSION;
+    } else if (s_defaultsVersion < CONFIG_SCHEMA_DEFAULTS_VERSION && !schema_upgrade_defaults()) {
+        APP_ERR("ConfigSchema::load - defaults upgrade failure.");
+    }
+
+    uint8_t loaded = 0;
+    for (uint8_t s = SCHEMA_SECTION_GLOBAL; s < SCHEMA_SECTION_PROFILE(0); s++) {
+        uint8_t* base = const_cast<uint8_t*>(schema_base(config, nullptr, s));
+        schema_fill_stored_defaults(base, s, s == SCHEMA_SECTION_HOTKEYS ? sizeof(config.hotkeys) : sizeof(config.screenControl));
+        const uint16_t len = schema_read(s);
+        if (len == 0) continue;
+        if (schema_decode(base, s, s_buffer, len)) {
+            loaded++;
+        } else {
+            APP_ERR("ConfigSchema::load - bad section %d.", s);
+        }
+    }
+    schema_check_slots(config);
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        // 名片按所在分区组的默认值解码
+        const uint8_t slot = config.profileSlots[i];
+        memcpy(&config.profiles[i], schema_defaults(SCHEMA_SECTION_PROFILE(slot), s_defaultsVersion), sizeof(GamepadProfileHeader));
+        if (schema_read_header(SCHEMA_SECTION_PROFILE(slot), config.profiles[i])) {
+            loaded++;
+        }
+    }
+    APP_DBG("ConfigSchema::load - %d sections.", loaded);
+    return loaded > 0;
+}
+
+bool ConfigSchema::loadProfile(uint8_t slot, GamepadProfile& profile)
+{
+    ConfigUtils::makeDefaultProfileAt(profile, slot);
+    if (slot >= NUM_PROFILES) return false;
+    schema_fill_stored_defaults((uint8_t*)&profile, (uint8_t)SCHEMA_SECTION_PROFILE(slot), sizeof(GamepadProfile));
+    bool found = false;
+    const uint8_t sections[] = { (uint8_t)SCHEMA_SECTION_PROFILE(slot), (uint8_t)SCHEMA_SECTION_LEDS(slot) };
+    for (uint8_t s : sections) {
+        const uint16_t len = schema_read(s);
+        if (len == 0) continue;
+        if (schema_decode((uint8_t*)&profile, s, s_buffer, len)) {
+            found = true;
+        } else {
+            APP_ERR("ConfigSchema::loadProfile - bad section %d.", s);
+        }
+    }
+    return found;
+}
+
+bool ConfigSchema::save(const Config& config, const GamepadProfile* const* profiles, ConfigSectionMask sections)
+{
+    // 第一遍找出和日志不同的部分，第二遍写入时重新编码（编码是确定的），不用同时缓存所有分区
+    uint16_t dirtyKey[SCHEMA_KEY_COUNT];
+    uint8_t dirtySection[SCHEMA_KEY_COUNT];
+    uint16_t numDirty = 0;
+
+    if (!isPresent()) {
+        // 刚格式化的日志：缺少的分区就是当前版本的默认值
+        s_defaultsVersion = CONFIG_SCHEMA_DEFAULTS_VERSION;
+        dirtyKey[numDirty] = CONFIG_SCHEMA_KEY_MARKER;
+        dirtySection[numDirty] = 0xFF;
+        numDirty++;
+    }
+    // 日志还按旧版默认值编码时不省略字段，写出的分区在哪一版默认值下都读出同样的内容
+    const bool elide = s_defaultsVersion == CONFIG_SCHEMA_DEFAULTS_VERSION;
+    for (uint8_t s = 0; s < SCHEMA_SECTION_COUNT; s++) {
+        if ((sections & schema_section_mask(config, s)) == 0) continue;
+        const uint8_t* base = schema_base(config, profiles, s);
+        if (!base) continue;
+        const ConfigSchemaSection desc = schema_section(s);
+        const uint16_t len = schema_encode(base, s, s_buffer, sizeof(s_buffer), elide);
+        if (len == 0) {
+            APP_ERR("ConfigSchema::save - section %d too large.", s);
+            return false;
+        }
+        for (uint16_t p = 0; (uint32_t)p * CONFIG_STORE_PAYLOAD_SIZE < len; p++) {
+            const uint16_t offset = (uint16_t)(p * CONFIG_STORE_PAYLOAD_SIZE);
+            const uint16_t partLen = (uint16_t)(len - offset < CONFIG_STORE_PAYLOAD_SIZE ? len - offset : CONFIG_STORE_PAYLOAD_SIZE);
+            if (!CONFIG_STORE.matches((uint16_t)(desc.key + p), s_buffer + offset, partLen)) {
+                dirtyKey[numDirty] = (uint16_t)(desc.key + p);
+                dirtySection[numDirty] = s;
+                numDirty++;
+            }
+        }
+    }
+    if (numDirty == 0) {
+        APP_DBG("ConfigSchema::save - no changes.");
+        return true;
+    }
+
+    // 所有变化放在一个事务里提交；空间不够时分批提交，只在分区边界断开，保证分区各自完整
+    int16_t encoded = -1;
+    uint16_t encodedLen = 0;
+    uint16_t done = 0;
+    while (done < numDirty) {
+        uint16_t batch = (uint16_t)(numDirty - done);
+        const uint16_t space = CONFIG_STORE.reserve(batch);
+        if (space < batch) {
+            batch = space;
+            while (batch > 0 && dirtySection[done + batch] == dirtySection[done + batch - 1]) batch--;
+        }
+        if (batch == 0 || !CONFIG_STORE.begin()) {
+            APP_ERR("ConfigSchema::save - no space for section %d.", dirtySection[done]);
+            return false;
+        }
+        for (uint16_t i = 0; i < batch; i++) {
+            const uint16_t key = dirtyKey[done + i];
+            const uint8_t s = dirtySection[done + i];
+            bool ok;
+            if (key == CONFIG_SCHEMA_KEY_MARKER) {
+                ok = schema_write_marker();
+            } else {
+                if (encoded != s) {
+                    encodedLen = schema_encode(schema_base(config, profiles, s), s, s_buffer, sizeof(s_buffer), elide);
+                    encoded = s;
+                }
+                const uint16_t offset = (uint16_t)((key - schema_section(s).key) * CONFIG_STORE_PAYLOAD_SIZE);
+                const uint16_t partLen = (uint16_t)(encodedLen - offset < CONFIG_STORE_PAYLOAD_SIZE ? encodedLen - offset : CONFIG_STORE_PAYLOAD_SIZE);
+                ok = CONFIG_STORE.write(key, s_buffer + offset, partLen);
+            }
+            if (!ok) {
+                APP_ERR("ConfigSchema::save - Write failure.");
+                return false;
+            }
+        }
+        if (!CONFIG_STORE.commit()) {
+            APP_ERR("ConfigSchema::save - Write failure.");
+            return false;
+        }
+        done = (uint16_t)(done + batch);
+    }
+    APP_DBG("ConfigSchema::save - success, records: %d", numDirty);
+    return true;
+}
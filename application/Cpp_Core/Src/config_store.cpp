@@ -0,0 +1,559 @@
+#include "config_store.hpp"
+#include "flash_writer.hpp"
+#include "CRC32.hpp"
+#include "system_logger.h"
+#include <cstring>
+#include <cstddef>
+
+// 距离上一次保存超过这个时间才在主循环里整理，连续修改配置时不插入擦除
+#ifndef CONFIG_STORE_IDLE_MS
+#define CONFIG_STORE_IDLE_MS            3000u
+#endif
+
+// 已擦除扇区少于这个数量时开始后台整理
+#ifndef CONFIG_STORE_GC_FREE_SECTORS
+#define CONFIG_STORE_GC_FREE_SECTORS    3u
+#endif
+
+// 最旧扇区的擦除次数落后最大值这么多时，即使其中全是有效记录也搬走，让静态数据所在的扇区也参与轮换
+#ifndef CONFIG_STORE_WEAR_SPREAD
+#define CONFIG_STORE_WEAR_SPREAD        64u
+#endif
+
+#pragma pack(push, 1)
+struct ConfigStoreSectorHeader {
+    uint32_t magic;         // CONFIG_STORE_SECTOR_MAGIC
+    uint32_t seq;           // 扇区序号，越大越新
+    uint32_t eraseCount;
+    uint32_t crc;           // 前 12 字节的 CRC32
+};
+
+struct ConfigStoreRecordHeader {
+    uint16_t magic;         // CONFIG_STORE_RECORD_MAGIC
+    uint16_t key;
+    uint32_t seq;           // 全局记录序号
+    uint32_t txn;           // 所属事务首条记录的序号
+    uint16_t len;
+    uint8_t flags;          // CONFIG_STORE_FLAG_COMMIT：事务的最后一条记录
+    uint8_t state;          // 0xFF 未确认，事务提交后原地改写为 CONFIG_STORE_STATE_COMMITTED；不参与 CRC
+    uint32_t crc;           // state 之前的记录头 + len 字节数据的 CRC32
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ConfigStoreRecordHeader) == CONFIG_STORE_RECORD_HEADER_SIZE, "record header size mismatch");
+
+/*
+ * 多条记录的事务在 COMMIT 记录写完后，再把前面每条记录的 state 改写为已确认（NOR 只把 1 写成 0，不用擦除）。
+ * 之后整理擦掉 COMMIT 记录所在的扇区，留在更旧扇区里的同一事务的记录仍然有效。
+ * 改写在后台队列里失败时 state 仍是 0xFF，整理擦除 COMMIT 所在扇区前把这些记录搬到头部。
+ */
+#define CONFIG_STORE_STATE_COMMITTED    0x00
+
+// 页读写缓冲与 write() 暂存的最后一条记录
+static uint8_t s_page[W25Qxx_PageSize];
+static uint8_t s_held[CONFIG_STORE_PAYLOAD_SIZE];
+
+// 擦写都进后台队列；读取时队列里还没执行的擦写会叠加到结果上，和已经落到 flash 上一样
+static bool flash_read(uint32_t addr, void* out, uint32_t len) {
+    return FLASH_WRITER.read(addr, out, len);
+}
+
+static bool flash_program(uint32_t addr, const void* data, uint16_t len) {
+    return FLASH_WRITER.program(addr, data, len);
+}
+
+static uint32_t record_crc(const ConfigStoreRecordHeader& hdr, const uint8_t* data) {
+    CRC32 crc;
+    crc.update((const uint8_t*)&hdr, (uint16_t)offsetof(ConfigStoreRecordHeader, state));
+    crc.update(data, hdr.len);
+    return crc.finalize();
+}
+
+static bool mark_committed(uint16_t page) {
+    const uint8_t state = CONFIG_STORE_STATE_COMMITTED;
+    const uint32_t addr = CONFIG_ADDR + (uint32_t)page * W25Qxx_PageSize + offsetof(ConfigStoreRecordHeader, state);
+    return flash_program(addr, &state, 1);
+}
+
+static bool all_erased(const uint8_t* p, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+uint8_t ConfigStore::countSectors(SectorState state) const {
+    uint8_t n = 0;
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        if (sectors[s].state == state) n++;
+    }
+    return n;
+}
+
+uint16_t ConfigStore::liveRecords(uint8_t sector) const {
+    uint16_t n = 0;
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        if (index[k] != CONFIG_STORE_NO_PAGE && index[k] / CONFIG_STORE_PAGES_PER_SECTOR == sector) n++;
+    }
+    return n;
+}
+
+uint16_t ConfigStore::getFreeRecords() const {
+    if (!mounted) return 0;
+    // 待擦除的扇区也算空闲：打开时再擦
+    uint8_t freeSectors = countSectors(SECTOR_ERASED) + countSectors(SECTOR_DIRTY);
+    // 备用扇区已被整理开成头部、还没收回（整理中途重新挂载等）：头部剩下的页留给整理
+    if (freeSectors < CONFIG_STORE_RESERVE_SECTORS) return 0;
+    uint16_t n = (uint16_t)(CONFIG_STORE_PAGES_PER_SECTOR - headNext);
+    n += (uint16_t)((freeSectors - CONFIG_STORE_RESERVE_SECTORS) * CONFIG_STORE_RECORDS_PER_SECTOR);
+    return n;
+}
+
+uint32_t ConfigStore::getMaxEraseCount() const {
+    uint32_t n = 0;
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        if (sectors[s].eraseCount > n) n = sectors[s].eraseCount;
+    }
+    return n;
+}
+
+bool ConfigStore::mount()
+{
+    mounted = false;
+    txnOpen = false;
+    held = false;
+    gcVictim = -1;
+    nextSectorSeq = 1;
+    nextRecordSeq = 1;
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        index[k] = CONFIG_STORE_NO_PAGE;
+        pending[k] = CONFIG_STORE_NO_PAGE;
+        commitSector[k] = CONFIG_STORE_NO_SECTOR;
+    }
+
+    // 读扇区头，按序号排出日志顺序
+    uint8_t order[CONFIG_STORE_SECTORS];
+    uint8_t used = 0;
+    uint32_t maxErase = 0;
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        ConfigStoreSectorHeader sh;
+        sectors[s].seq = 0;
+        sectors[s].eraseCount = 0;
+        sectors[s].state = SECTOR_DIRTY;
+        if (!flash_read(sectorAddress(s), &sh, sizeof(sh))) return false;
+        if (sh.magic != CONFIG_STORE_SECTOR_MAGIC) continue;
+        if (CRC32::calculate((const uint8_t*)&sh, (uint16_t)offsetof(ConfigStoreSectorHeader, crc)) != sh.crc) continue;
+        sectors[s].seq = sh.seq;
+        sectors[s].eraseCount = sh.eraseCount;
+        sectors[s].state = SECTOR_USED;
+        if (sh.eraseCount > maxErase) maxErase = sh.eraseCount;
+        if (sh.seq >= nextSectorSeq) nextSectorSeq = sh.seq + 1;
+        uint8_t i = used++;
+        while (i > 0 && sectors[order[i - 1]].seq > sh.seq) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = s;
+    }
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        // 没有扇区头的扇区擦除次数未知，按最大值记
+        if (sectors[s].state == SECTOR_DIRTY) sectors[s].eraseCount = maxErase;
+    }
+    if (used == 0) {
+        return false;
+    }
+
+    // 按写入顺序回放记录
+    uint32_t pendingTxn = 0;
+    uint8_t headLast = 0;
+    for (uint8_t i = 0; i < used; i++) {
+        const uint8_t s = order[i];
+        for (uint8_t p = 1; p < CONFIG_STORE_PAGES_PER_SECTOR; p++) {
+            const uint16_t page = (uint16_t)(s * CONFIG_STORE_PAGES_PER_SECTOR + p);
+            if (!flash_read(pageAddress(page), s_page, W25Qxx_PageSize)) return false;
+            if (all_erased(s_page, W25Qxx_PageSize)) continue;
+            headLast = p;
+            ConfigStoreRecordHeader hdr;
+            memcpy(&hdr, s_page, sizeof(hdr));
+            const uint8_t* data = s_page + sizeof(hdr);
+            if (hdr.magic != CONFIG_STORE_RECORD_MAGIC || hdr.key >= CONFIG_STORE_MAX_KEYS
+                || hdr.len > CONFIG_STORE_PAYLOAD_SIZE || record_crc(hdr, data) != hdr.crc) {
+                // 写了一半的页：所在事务不可能再提交
+                pendingTxn = 0;
+                continue;
+            }
+            if (hdr.seq >= nextRecordSeq) nextRecordSeq = hdr.seq + 1;
+            if (hdr.txn != pendingTxn) {
+                // 新事务开始，之前没提交的记录作废
+                for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) pending[k] = CONFIG_STORE_NO_PAGE;
+                pendingTxn = hdr.txn;
+            }
+            // 改写一半的 state 也只可能发生在 COMMIT 记录写完之后
+            if (hdr.state != 0xFF && !(hdr.flags & CONFIG_STORE_FLAG_COMMIT)) {
+                index[hdr.key] = page;
+                commitSector[hdr.key] = CONFIG_STORE_NO_SECTOR;
+                continue;
+            }
+            pending[hdr.key] = page;
+            if (hdr.flags & CONFIG_STORE_FLAG_COMMIT) {
+                // 上次提交后没来得及确认的记录在这里补上
+                for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+                    if (pending[k] == CONFIG_STORE_NO_PAGE) continue;
+                    if (pending[k] != page) mark_committed(pending[k]);
+                    commitSector[k] = (pending[k] != page) ? s : (uint8_t)CONFIG_STORE_NO_SECTOR;
+                    index[k] = pending[k];
+                    pending[k] = CONFIG_STORE_NO_PAGE;
+                }
+                pendingTxn = 0;
+            }
+        }
+        if (i == used - 1) {
+            // 头部扇区从最后一个非空页之后继续追加
+            head = s;
+            headNext = (uint8_t)(headLast + 1);
+        }
+        headLast = 0;
+    }
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) pending[k] = CONFIG_STORE_NO_PAGE;
+    sectors[head].state = SECTOR_HEAD;
+
+    mounted = true;
+    APP_DBG("ConfigStore::mount - sectors: %d, free records: %d", used, getFreeRecords());
+    return true;
+}
+
+bool ConfigStore::format()
+{
+    mounted = false;
+    txnOpen = false;
+    held = false;
+    gcVictim = -1;
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        if (!FLASH_WRITER.erase(sectorAddress(s))) {
+            LOG_ERROR("ConfigStore", "Failed to erase config region");
+            return false;
+        }
+    }
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        sectors[s].seq = 0;
+        sectors[s].eraseCount++;
+        sectors[s].state = SECTOR_ERASED;
+    }
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        index[k] = CONFIG_STORE_NO_PAGE;
+        pending[k] = CONFIG_STORE_NO_PAGE;
+        commitSector[k] = CONFIG_STORE_NO_SECTOR;
+    }
+    nextSectorSeq = 1;
+    nextRecordSeq = 1;
+    // 从 0 号扇区开始；立即写扇区头，之后 mount() 能认出这是空日志
+    head = CONFIG_STORE_SECTORS - 1;
+    headNext = CONFIG_STORE_PAGES_PER_SECTOR;
+    mounted = true;
+    if (!openHead()) {
+        mounted = false;
+        return false;
+    }
+    return true;
+}
+
+bool ConfigStore::eraseSector(uint8_t sector)
+{
+    if (!FLASH_WRITER.erase(sectorAddress(sector))) {
+        LOG_ERROR("ConfigStore", "Failed to erase sector %d", sector);
+        sectors[sector].state = SECTOR_DIRTY;
+        return false;
+    }
+    sectors[sector].seq = 0;
+    sectors[sector].eraseCount++;
+    sectors[sector].state = SECTOR_ERASED;
+    return true;
+}
+
+bool ConfigStore::openHead()
+{
+    // 按环形顺序取头部之后的第一个空闲扇区，各扇区轮流使用
+    int16_t next = -1;
+    for (uint8_t i = 1; i <= CONFIG_STORE_SECTORS; i++) {
+        uint8_t s = (uint8_t)((head + i) % CONFIG_STORE_SECTORS);
+        if (sectors[s].state == SECTOR_ERASED || sectors[s].state == SECTOR_DIRTY) {
+            next = s;
+            break;
+        }
+    }
+    if (next < 0) {
+        LOG_ERROR("ConfigStore", "No free sector");
+        return false;
+    }
+    if (sectors[next].state == SECTOR_DIRTY && !eraseSector((uint8_t)next)) {
+        return false;
+    }
+
+    ConfigStoreSectorHeader sh;
+    sh.magic = CONFIG_STORE_SECTOR_MAGIC;
+    sh.seq = nextSectorSeq++;
+    sh.eraseCount = sectors[next].eraseCount;
+    sh.crc = CRC32::calculate((const uint8_t*)&sh, (uint16_t)offsetof(ConfigStoreSectorHeader, crc));
+    if (!flash_program(sectorAddress((uint8_t)next), &sh, sizeof(sh))) {
+        LOG_ERROR("ConfigStore", "Failed to write sector header %d", next);
+        sectors[next].state = SECTOR_DIRTY;
+        return false;
+    }
+    if (sectors[head].state == SECTOR_HEAD) {
+        sectors[head].state = SECTOR_USED;
+    }
+    head = (uint8_t)next;
+    headNext = 1;
+    sectors[head].seq = sh.seq;
+    sectors[head].state = SECTOR_HEAD;
+    return true;
+}
+
+bool ConfigStore::appendRecord(uint16_t key, const uint8_t* data, uint16_t len, uint32_t txn, uint8_t flags, uint16_t* outPage)
+{
+    if (headNext >= CONFIG_STORE_PAGES_PER_SECTOR && !openHead()) {
+        return false;
+    }
+    const uint16_t page = (uint16_t)(head * CONFIG_STORE_PAGES_PER_SECTOR + headNext);
+
+    ConfigStoreRecordHeader hdr;
+    hdr.magic = CONFIG_STORE_RECORD_MAGIC;
+    hdr.key = key;
+    hdr.seq = nextRecordSeq++;
+    hdr.txn = txn ? txn : hdr.seq;
+    hdr.len = len;
+    hdr.flags = flags;
+    hdr.state = (flags & CONFIG_STORE_FLAG_COMMIT) ? CONFIG_STORE_STATE_COMMITTED : 0xFF;
+    hdr.crc = record_crc(hdr, data);
+    memcpy(s_page, &hdr, sizeof(hdr));
+    memcpy(s_page + sizeof(hdr), data, len);
+
+    // 无论成功与否这一页都已经用掉，写坏的页挂载时按 CRC 跳过
+    headNext++;
+    if (!flash_program(pageAddress(page), s_page, (uint16_t)(sizeof(hdr) + len))) {
+        LOG_ERROR("ConfigStore", "Failed to write record %d", key);
+        return false;
+    }
+    if (outPage) *outPage = page;
+    return true;
+}
+
+int8_t ConfigStore::pickVictim(bool forSpace) const
+{
+    // 有效记录最少的扇区回收得最多，数量相同取最旧的；全是有效记录的扇区搬走也腾不出空间，不参与
+    int8_t best = -1;
+    uint16_t bestLive = CONFIG_STORE_RECORDS_PER_SECTOR;
+    int8_t oldest = -1;
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        if (sectors[s].state != SECTOR_USED) continue;
+        if (oldest < 0 || sectors[s].seq < sectors[oldest].seq) oldest = (int8_t)s;
+        uint16_t live = liveRecords(s);
+        if (live < bestLive || (live == bestLive && best >= 0 && sectors[s].seq < sectors[best].seq)) {
+            best = (int8_t)s;
+            bestLive = live;
+        }
+    }
+    if (forSpace || oldest < 0) {
+        return best;
+    }
+    if (sectors[oldest].eraseCount + CONFIG_STORE_WEAR_SPREAD <= getMaxEraseCount()) {
+        return oldest;
+    }
+    return -1;
+}
+
+bool ConfigStore::moveRecord(uint16_t key)
+{
+    ConfigStoreRecordHeader hdr;
+    if (!flash_read(pageAddress(index[key]), s_page, W25Qxx_PageSize)) return false;
+    memcpy(&hdr, s_page, sizeof(hdr));
+    // 搬移的记录各自成为一个已提交的事务
+    uint16_t page;
+    memcpy(s_held, s_page + sizeof(hdr), hdr.len);
+    if (!appendRecord(key, s_held, hdr.len, 0, CONFIG_STORE_FLAG_COMMIT, &page)) return false;
+    index[key] = page;
+    commitSector[key] = CONFIG_STORE_NO_SECTOR;
+    return true;
+}
+
+bool ConfigStore::moveOneRecord(uint8_t sector)
+{
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        if (index[k] == CONFIG_STORE_NO_PAGE || index[k] / CONFIG_STORE_PAGES_PER_SECTOR != sector) continue;
+        return moveRecord(k);
+    }
+    return true;
+}
+
+int16_t ConfigStore::unconfirmedRecord(uint8_t sector)
+{
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        if (commitSector[k] != sector) continue;
+        if (index[k] == CONFIG_STORE_NO_PAGE) {
+            commitSector[k] = CONFIG_STORE_NO_SECTOR;
+            continue;
+        }
+        // 确认标记的写入结果要等队列执行完才能从 flash 上读到
+        if (FLASH_WRITER.isBusy() && !FLASH_WRITER.flush()) {
+            LOG_ERROR("ConfigStore", "Flash queue reported an error");
+        }
+        ConfigStoreRecordHeader hdr;
+        if (!flash_read(pageAddress(index[k]), &hdr, sizeof(hdr)) || hdr.state == 0xFF) {
+            return (int16_t)k;
+        }
+        commitSector[k] = CONFIG_STORE_NO_SECTOR;
+    }
+    return -1;
+}
+
+bool ConfigStore::collectVictim(uint8_t sector)
+{
+    while (liveRecords(sector) > 0) {
+        if (!moveOneRecord(sector)) return false;
+    }
+    for (int16_t k = unconfirmedRecord(sector); k >= 0; k = unconfirmedRecord(sector)) {
+        if (!moveRecord((uint16_t)k)) return false;
+    }
+    gcVictim = -1;
+    return eraseSector(sector);
+}
+
+uint16_t ConfigStore::reserve(uint16_t records)
+{
+    if (!mounted || txnOpen) return 0;
+    // 后台整理做到一半的扇区先收尾，否则它需要的空间可能被这次事务占掉
+    if (gcVictim >= 0 && !collectVictim((uint8_t)gcVictim)) return 0;
+    while (getFreeRecords() < records) {
+        int8_t victim = pickVictim(true);
+        if (victim < 0 || !collectVictim((uint8_t)victim)) break;
+    }
+    uint16_t n = getFreeRecords();
+    return n < records ? n : records;
+}
+
+bool ConfigStore::begin()
+{
+    if (!mounted || txnOpen) return false;
+    txnOpen = true;
+    txnId = 0;
+    held = false;
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) pending[k] = CONFIG_STORE_NO_PAGE;
+    return true;
+}
+
+void ConfigStore::abortTxn()
+{
+    txnOpen = false;
+    held = false;
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) pending[k] = CONFIG_STORE_NO_PAGE;
+}
+
+bool ConfigStore::flushHeld(uint8_t flags)
+{
+    if (txnId == 0) txnId = nextRecordSeq;
+    uint16_t page;
+    if (!appendRecord(heldKey, s_held, heldLen, txnId, flags, &page)) return false;
+    pending[heldKey] = page;
+    held = false;
+    return true;
+}
+
+bool ConfigStore::write(uint16_t key, const void* data, uint16_t len)
+{
+    if (!txnOpen || key >= CONFIG_STORE_MAX_KEYS || len > CONFIG_STORE_PAYLOAD_SIZE) return false;
+    if (held && !flushHeld(0)) {
+        abortTxn();
+        return false;
+    }
+    memcpy(s_held, data, len);
+    heldKey = key;
+    heldLen = len;
+    held = true;
+    return true;
+}
+
+bool ConfigStore::commit()
+{
+    if (!txnOpen) return false;
+    const uint16_t commitKey = heldKey;
+    if (held && !flushHeld(CONFIG_STORE_FLAG_COMMIT)) {
+        abortTxn();
+        return false;
+    }
+    const uint8_t commitSec = (uint8_t)(pending[commitKey] / CONFIG_STORE_PAGES_PER_SECTOR);
+    for (uint16_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++) {
+        if (pending[k] == CONFIG_STORE_NO_PAGE) continue;
+        // 确认失败不影响这次提交：COMMIT 记录还在日志中，下次挂载时补上，整理擦掉它之前先把这条记录搬走
+        if (k != commitKey && !mark_committed(pending[k])) {
+            LOG_ERROR("ConfigStore", "Failed to confirm record %d", k);
+        }
+        commitSector[k] = (k != commitKey) ? commitSec : (uint8_t)CONFIG_STORE_NO_SECTOR;
+        index[k] = pending[k];
+        pending[k] = CONFIG_STORE_NO_PAGE;
+    }
+    txnOpen = false;
+    lastWriteMs = HAL_GetTick();
+    return true;
+}
+
+bool ConfigStore::read(uint16_t key, void* out, uint16_t len)
+{
+    if (!mounted || key >= CONFIG_STORE_MAX_KEYS || index[key] == CONFIG_STORE_NO_PAGE) return false;
+    ConfigStoreRecordHeader hdr;
+    if (!flash_read(pageAddress(index[key]), &hdr, sizeof(hdr)) || hdr.len != len) return false;
+    return flash_read(pageAddress(index[key]) + sizeof(hdr), out, len);
+}
+
+bool ConfigStore::read(uint16_t key, void* out, uint16_t maxLen, uint16_t* outLen)
+{
+    if (!mounted || key >= CONFIG_STORE_MAX_KEYS || index[key] == CONFIG_STORE_NO_PAGE) return false;
+    ConfigStoreRecordHeader hdr;
+    if (!flash_read(pageAddress(index[key]), &hdr, sizeof(hdr)) || hdr.len > maxLen) return false;
+    if (!flash_read(pageAddress(index[key]) + sizeof(hdr), out, hdr.len)) return false;
+    *outLen = hdr.len;
+    return true;
+}
+
+bool ConfigStore::matches(uint16_t key, const void* data, uint16_t len)
+{
+    if (!mounted || key >= CONFIG_STORE_MAX_KEYS || index[key] == CONFIG_STORE_NO_PAGE) return false;
+    if (len > CONFIG_STORE_PAYLOAD_SIZE) return false;
+    if (!flash_read(pageAddress(index[key]), s_page, sizeof(ConfigStoreRecordHeader) + len)) return false;
+    ConfigStoreRecordHeader hdr;
+    memcpy(&hdr, s_page, sizeof(hdr));
+    return hdr.len == len && memcmp(s_page + sizeof(hdr), data, len) == 0;
+}
+
+void ConfigStore::service()
+{
+    if (!mounted || txnOpen) return;
+    if ((uint32_t)(HAL_GetTick() - lastWriteMs) < CONFIG_STORE_IDLE_MS) return;
+    // 上一步的擦写还在后台执行时不再排新的，读记录也不用等器件
+    if (FLASH_WRITER.isBusy()) return;
+
+    // 每次只排一步：搬一条记录或擦一个扇区
+    if (gcVictim >= 0) {
+        int16_t k;
+        if (liveRecords((uint8_t)gcVictim) > 0) {
+            moveOneRecord((uint8_t)gcVictim);
+        } else if ((k = unconfirmedRecord((uint8_t)gcVictim)) >= 0) {
+            moveRecord((uint16_t)k);
+        } else {
+            eraseSector((uint8_t)gcVictim);
+            gcVictim = -1;
+        }
+        return;
+    }
+    // 待擦除的扇区提前擦好，保存时打开新扇区不用再等
+    for (uint8_t s = 0; s < CONFIG_STORE_SECTORS; s++) {
+        if (sectors[s].state == SECTOR_DIRTY) {
+            eraseSector(s);
+            return;
+        }
+    }
+    if (countSectors(SECTOR_ERASED) < CONFIG_STORE_GC_FREE_SECTORS) {
+        gcVictim = pickVictim(true);
+        if (gcVictim >= 0) return;
+    }
+    gcVictim = pickVictim(false);
+}
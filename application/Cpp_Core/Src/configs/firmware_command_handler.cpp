@@ -595,7 +595,7 @@ WebSocketDownstreamMessage FirmwareCommandHandler::handleCompleteFirmwareUpgrade
         cJSON_AddStringToObject(dataJSON, "message", "Firmware upgrade completed successfully. System will restart in 2 seconds.");
         
         STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_WEB_CONFIG);
-        STORAGE_MANAGER.saveConfig(); // 保存配置
+        STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
 
         // 设置需要重启 2秒后重启
         WebSocketCommandHandler::rebootTick = HAL_GetTick() + 2000;
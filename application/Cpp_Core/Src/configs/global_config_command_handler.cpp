@@ -73,7 +73,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateGlobalConfig(
     }
 
     // 保存配置
-    if (!STORAGE_MANAGER.saveConfig()) {
+    if (!STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL)) {
         LOG_ERROR("WebSocket", "update_global_config: Failed to save configuration");
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
@@ -146,7 +146,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateHotkeysConfig
     }
 
     // 保存配置
-    if (!STORAGE_MANAGER.saveConfig()) {
+    if (!STORAGE_MANAGER.saveConfig(CONFIG_SECTION_HOTKEYS)) {
         LOG_ERROR("WebSocket", "update_hotkeys_config: Failed to save configuration");
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
@@ -173,6 +173,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleGetScreenControlCon
     cJSON_AddNumberToObject(screenControlJSON, "textColor", config.screenControl.textColor);
     cJSON_AddStringToObject(screenControlJSON, "backgroundImageId", config.screenControl.backgroundImageId);
     cJSON_AddNumberToObject(screenControlJSON, "currentPageId", config.screenControl.currentPageId);
+    cJSON_AddBoolToObject(screenControlJSON, "tournamentScreenOff", config.screenControl.tournamentScreenOff != 0);
 
     cJSON* featuresJSON = cJSON_CreateObject();
     cJSON_AddBoolToObject(featuresJSON, "inputModeSwitch", (config.screenControl.featuresMask & SCREEN_FEATURE_INPUT_MODE_SWITCH) != 0);
@@ -186,6 +187,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleGetScreenControlCon
     cJSON_AddBoolToObject(featuresJSON, "screenBrightnessAdjust", (config.screenControl.featuresMask & SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST) != 0);
     cJSON_AddBoolToObject(featuresJSON, "webConfigEntry", (config.screenControl.featuresMask & SCREEN_FEATURE_WEB_CONFIG_ENTRY) != 0);
     cJSON_AddBoolToObject(featuresJSON, "calibrationModeSwitch", (config.screenControl.featuresMask & SCREEN_FEATURE_CALIBRATION_MODE_SWITCH) != 0);
+    cJSON_AddBoolToObject(featuresJSON, "inputMonitor", (config.screenControl.featuresMask & SCREEN_FEATURE_INPUT_MONITOR) != 0);
     cJSON_AddItemToObject(screenControlJSON, "features", featuresJSON);
 
     cJSON* featuresOrderJSON = cJSON_CreateArray();
@@ -201,6 +203,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleGetScreenControlCon
         {8, "screenBrightnessAdjust"},
         {9, "webConfigEntry"},
         {10, "calibrationModeSwitch"},
+        {12, "inputMonitor"},
     };
     for (uint32_t i = 0; i < SCREEN_FEATURE_COUNT; i++) {
         uint8_t id = config.screenControl.featuresOrder[i];
@@ -262,6 +265,9 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateScreenControl
         if (v > 65535) v = 65535;
         config.screenControl.currentPageId = (uint16_t)v;
     }
+    if ((item = cJSON_GetObjectItem(screenControl, "tournamentScreenOff")) && cJSON_IsBool(item)) {
+        config.screenControl.tournamentScreenOff = cJSON_IsTrue(item) ? 1u : 0u;
+    }
 
     cJSON* features = cJSON_GetObjectItem(screenControl, "features");
     if (features && cJSON_IsObject(features)) {
@@ -277,6 +283,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateScreenControl
             {"screenBrightnessAdjust", SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST},
             {"webConfigEntry", SCREEN_FEATURE_WEB_CONFIG_ENTRY},
             {"calibrationModeSwitch", SCREEN_FEATURE_CALIBRATION_MODE_SWITCH},
+            {"inputMonitor", SCREEN_FEATURE_INPUT_MONITOR},
         };
         for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
             cJSON* b = cJSON_GetObjectItem(features, map[i].key);
@@ -301,6 +308,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateScreenControl
             {"screenBrightnessAdjust", 8},
             {"webConfigEntry", 9},
             {"calibrationModeSwitch", 10},
+            {"inputMonitor", 12},
         };
         bool used[SCREEN_FEATURE_COUNT] = {false};
         uint32_t pos = 0;
@@ -331,7 +339,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleUpdateScreenControl
         }
     }
 
-    if (!STORAGE_MANAGER.saveConfig()) {
+    if (!STORAGE_MANAGER.saveConfig(CONFIG_SECTION_SCREEN)) {
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
 
@@ -391,7 +399,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleExportAllConfig(con
     // 4. 发送 Profiles
     for (int i = 0; i < NUM_PROFILES; i++) {
         if (config.profiles[i].enabled) {
-            cJSON* profileJSON = ProfileCommandHandler::buildProfileJSON(&config.profiles[i]);
+            cJSON* profileJSON = ProfileCommandHandler::buildProfileJSON(STORAGE_MANAGER.getProfileAt(i));
             if (profileJSON) {
                 sendPart("profile", profileJSON);
                 // 简单的延时以防止发送缓冲区溢出
@@ -495,8 +503,10 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleImportConfigPart(co
              // Find profile by ID
              for (int i=0; i < NUM_PROFILES; i++) {
                  if (strncmp(config.profiles[i].id, idItem->valuestring, sizeof(config.profiles[i].id)) == 0) {
-                     ProfileCommandHandler::parseProfileJSON(profileItem, &config.profiles[i]);
-                     config.profiles[i].enabled = true;
+                     GamepadProfile* profile = STORAGE_MANAGER.getProfileAt(i);
+                     if (!profile) break;
+                     ProfileCommandHandler::parseProfileJSON(profileItem, profile);
+                     profile->enabled = true;
                      break;
                  }
              }
@@ -526,6 +536,9 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleImportConfigPart(co
             if (v > 65535) v = 65535;
             config.screenControl.currentPageId = (uint16_t)v;
         }
+        if ((item = cJSON_GetObjectItem(screenControl, "tournamentScreenOff")) && cJSON_IsBool(item)) {
+            config.screenControl.tournamentScreenOff = cJSON_IsTrue(item) ? 1u : 0u;
+        }
         if ((item = cJSON_GetObjectItem(screenControl, "standbyDisplay")) && cJSON_IsString(item)) {
             if (strcmp(item->valuestring, "backgroundImage") == 0) config.screenControl.standbyDisplay = 1;
             else if (strcmp(item->valuestring, "buttonLayout") == 0) config.screenControl.standbyDisplay = 2;
@@ -545,6 +558,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleImportConfigPart(co
                 {"screenBrightnessAdjust", SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST},
                 {"webConfigEntry", SCREEN_FEATURE_WEB_CONFIG_ENTRY},
                 {"calibrationModeSwitch", SCREEN_FEATURE_CALIBRATION_MODE_SWITCH},
+                {"inputMonitor", SCREEN_FEATURE_INPUT_MONITOR},
             };
             for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
                 cJSON* b = cJSON_GetObjectItem(features, map[i].key);
@@ -568,6 +582,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleImportConfigPart(co
                 {"screenBrightnessAdjust", 8},
                 {"webConfigEntry", 9},
                 {"calibrationModeSwitch", 10},
+                {"inputMonitor", 12},
             };
             bool used[SCREEN_FEATURE_COUNT] = {false};
             uint32_t pos = 0;
@@ -621,7 +636,7 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handleReboot(const WebSoc
     cJSON_AddStringToObject(dataJSON, "message", "System is rebooting");
     
     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-    STORAGE_MANAGER.saveConfig();
+    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
 
     // 设置延迟重启时间
     WebSocketCommandHandler::rebootTick = HAL_GetTick() + 2000;
@@ -743,6 +758,13 @@ WebSocketDownstreamMessage GlobalConfigCommandHandler::handlePushLedsConfig(cons
     if ((item = cJSON_GetObjectItem(params, "aroundLedAnimationSpeed"))) {
         tempLedsConfig.aroundLedAnimationSpeed = item->valueint;
     }
+
+    if ((item = cJSON_GetObjectItem(params, "ledReactiveFadeMs")) && cJSON_IsNumber(item)) {
+        int val = item->valueint;
+        if (val < 0) val = 0;
+        if (val > LEDS_REACTIVE_FADE_MAX_MS) val = LEDS_REACTIVE_FADE_MAX_MS;
+        tempLedsConfig.ledReactiveFadeMs = (uint16_t)val;
+    }
     
     // 通过WebConfigLedsManager应用预览配置
     WEBCONFIG_LEDS_MANAGER.applyPreviewConfig(tempLedsConfig);
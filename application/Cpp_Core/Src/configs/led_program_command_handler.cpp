@@ -0,0 +1,138 @@
+#include "configs/led_program_command_handler.hpp"
+#include "configs/websocket_server.hpp"
+#include "leds/led_program_store.hpp"
+#include "leds/leds_manager.hpp"
+#include "system_logger.h"
+#include <cstring>
+
+static const uint8_t BINARY_CMD_LED_PROGRAM_UPLOAD = 0x50;
+static const uint8_t BINARY_CMD_LED_PROGRAM_DELETE = 0x51;
+static const uint8_t BINARY_CMD_LED_PROGRAM_SELECT = 0x52;
+static const uint8_t BINARY_CMD_LED_PROGRAM_LIST = 0x53;
+
+static const uint8_t BINARY_CMD_LED_PROGRAM_UPLOAD_RESP = 0xD0;
+static const uint8_t BINARY_CMD_LED_PROGRAM_DELETE_RESP = 0xD1;
+static const uint8_t BINARY_CMD_LED_PROGRAM_SELECT_RESP = 0xD2;
+static const uint8_t BINARY_CMD_LED_PROGRAM_LIST_RESP = 0xD3;
+
+#pragma pack(push, 1)
+// 上传：头部之后紧跟完整程序（LedVmProgramHeader + 字节码）
+struct BinaryLedProgramHeader {
+    uint8_t command;
+    uint8_t slot;
+};
+
+struct BinaryLedProgramResponse {
+    uint8_t command;
+    uint8_t success;
+    uint8_t slot;
+    uint8_t error;          // LedVmError
+};
+
+struct BinaryLedProgramSlotInfo {
+    uint8_t valid;
+    uint8_t reserved;
+    uint16_t code_size;
+    uint16_t step_budget;
+    char name[16];
+};
+
+struct BinaryLedProgramListResponse {
+    uint8_t command;
+    uint8_t active_slot;    // LED_PROGRAM_NO_SLOT 表示未选择
+    uint8_t num_slots;
+    uint8_t reserved;
+    uint16_t max_code_size;
+    uint16_t max_steps_per_led;
+    BinaryLedProgramSlotInfo slots[LED_PROGRAM_MAX_SLOTS];
+};
+#pragma pack(pop)
+
+static void send_led_program_response(WebSocketConnection* conn, uint8_t resp_cmd, uint8_t slot, LedVmError error) {
+    if (!conn) return;
+    BinaryLedProgramResponse resp = {0};
+    resp.command = resp_cmd;
+    resp.success = (error == LED_VM_OK) ? 1 : 0;
+    resp.slot = slot;
+    resp.error = error;
+    conn->send_binary((const uint8_t*)&resp, sizeof(resp));
+}
+
+static void send_led_program_list(WebSocketConnection* conn) {
+    if (!conn) return;
+    BinaryLedProgramListResponse resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.command = BINARY_CMD_LED_PROGRAM_LIST_RESP;
+    resp.active_slot = LED_PROGRAM_STORE.getActiveSlot();
+    resp.num_slots = LED_PROGRAM_MAX_SLOTS;
+    resp.max_code_size = LEDS_VM_MAX_CODE_SIZE;
+    resp.max_steps_per_led = LEDS_VM_MAX_STEPS_PER_LED;
+    for (uint8_t i = 0; i < LED_PROGRAM_MAX_SLOTS; i++) {
+        LedVmProgramHeader header;
+        if (!LED_PROGRAM_STORE.readHeader(i, header)) continue;
+        resp.slots[i].valid = 1;
+        resp.slots[i].code_size = header.codeSize;
+        resp.slots[i].step_budget = header.stepBudget;
+        memcpy(resp.slots[i].name, header.name, sizeof(resp.slots[i].name));
+    }
+    conn->send_binary((const uint8_t*)&resp, sizeof(resp));
+}
+
+void LedProgramCommandHandler::handleBinaryMessage(WebSocketConnection* conn, const uint8_t* data, size_t length) {
+    if (!data || length < 1) {
+        return;
+    }
+    uint8_t command = data[0];
+
+    if (command == BINARY_CMD_LED_PROGRAM_LIST) {
+        send_led_program_list(conn);
+        return;
+    }
+
+    if (length < sizeof(BinaryLedProgramHeader)) {
+        send_led_program_response(conn, (uint8_t)(command | 0x80), LED_PROGRAM_NO_SLOT, LED_VM_ERR_SIZE);
+        return;
+    }
+    const BinaryLedProgramHeader* h = reinterpret_cast<const BinaryLedProgramHeader*>(data);
+    const uint8_t slot = h->slot;
+
+    switch (command) {
+        case BINARY_CMD_LED_PROGRAM_UPLOAD: {
+            LedVmError err = LED_PROGRAM_STORE.save(slot, data + sizeof(BinaryLedProgramHeader), length - sizeof(BinaryLedProgramHeader));
+            if (err == LED_VM_OK) {
+                LOG_INFO("LedProgram", "Program uploaded to slot %d", slot);
+                // 覆盖的是当前使用的程序时立即生效
+                if (LED_PROGRAM_STORE.getActiveSlot() == slot) {
+                    LEDS_MANAGER.reloadCustomProgram();
+                }
+            } else {
+                LOG_WARN("LedProgram", "Program rejected for slot %d, error: %d", slot, err);
+            }
+            send_led_program_response(conn, BINARY_CMD_LED_PROGRAM_UPLOAD_RESP, slot, err);
+            break;
+        }
+        case BINARY_CMD_LED_PROGRAM_DELETE: {
+            bool ok = LED_PROGRAM_STORE.remove(slot);
+            if (ok) {
+                LEDS_MANAGER.reloadCustomProgram();
+            }
+            send_led_program_response(conn, BINARY_CMD_LED_PROGRAM_DELETE_RESP, slot, ok ? LED_VM_OK : LED_VM_ERR_STORAGE);
+            break;
+        }
+        case BINARY_CMD_LED_PROGRAM_SELECT: {
+            LedVmProgramHeader header;
+            if (slot != LED_PROGRAM_NO_SLOT && !LED_PROGRAM_STORE.readHeader(slot, header)) {
+                send_led_program_response(conn, BINARY_CMD_LED_PROGRAM_SELECT_RESP, slot, LED_VM_ERR_HEADER);
+                break;
+            }
+            bool ok = LED_PROGRAM_STORE.select(slot);
+            if (ok) {
+                LEDS_MANAGER.reloadCustomProgram();
+            }
+            send_led_program_response(conn, BINARY_CMD_LED_PROGRAM_SELECT_RESP, slot, ok ? LED_VM_OK : LED_VM_ERR_STORAGE);
+            break;
+        }
+        default:
+            break;
+    }
+}
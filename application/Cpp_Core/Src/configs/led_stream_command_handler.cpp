@@ -0,0 +1,81 @@
+#include "configs/led_stream_command_handler.hpp"
+#include "configs/websocket_server.hpp"
+#include "leds/led_stream.hpp"
+#include "system_logger.h"
+#include <cstring>
+
+static const uint8_t BINARY_CMD_LED_STREAM_BEGIN = 0x40;
+static const uint8_t BINARY_CMD_LED_STREAM_FRAME = 0x41;
+static const uint8_t BINARY_CMD_LED_STREAM_END = 0x42;
+
+static const uint8_t BINARY_CMD_LED_STREAM_BEGIN_RESP = 0xC0;
+static const uint8_t BINARY_CMD_LED_STREAM_FRAME_RESP = 0xC1;
+static const uint8_t BINARY_CMD_LED_STREAM_END_RESP = 0xC2;
+
+#pragma pack(push, 1)
+struct BinaryLedStreamBeginHeader {
+    uint8_t command;
+    uint8_t brightness;     // 0-100
+};
+
+struct BinaryLedStreamResponse {
+    uint8_t command;
+    uint8_t result;         // LedStreamResult
+    uint16_t expected_seq;  // 下一个增量帧应使用的序号
+    uint16_t num_led;
+    uint32_t received;
+    uint32_t dropped;
+};
+#pragma pack(pop)
+
+static void send_led_stream_response(WebSocketConnection* conn, uint8_t resp_cmd, LedStreamResult result) {
+    if (!conn) return;
+    BinaryLedStreamResponse resp = {0};
+    resp.command = resp_cmd;
+    resp.result = result;
+    resp.expected_seq = LED_STREAM.getExpectedSeq();
+    resp.num_led = NUM_LED;
+    resp.received = LED_STREAM.getReceivedFrames();
+    resp.dropped = LED_STREAM.getDroppedFrames();
+    conn->send_binary((const uint8_t*)&resp, sizeof(resp));
+}
+
+void LedStreamCommandHandler::handleBinaryMessage(WebSocketConnection* conn, const uint8_t* data, size_t length) {
+    // 连接断开时结束灯光流
+    if (!data || length < 1) {
+        LED_STREAM.end();
+        return;
+    }
+    uint8_t command = data[0];
+
+    switch (command) {
+        case BINARY_CMD_LED_STREAM_BEGIN: {
+            if (length < sizeof(BinaryLedStreamBeginHeader)) {
+                send_led_stream_response(conn, BINARY_CMD_LED_STREAM_BEGIN_RESP, LED_STREAM_ERR_LENGTH);
+                break;
+            }
+            const BinaryLedStreamBeginHeader* h = reinterpret_cast<const BinaryLedStreamBeginHeader*>(data);
+            LED_STREAM.begin(h->brightness);
+            LOG_INFO("LedStream", "LED stream started, brightness: %d", h->brightness);
+            send_led_stream_response(conn, BINARY_CMD_LED_STREAM_BEGIN_RESP, LED_STREAM_OK);
+            break;
+        }
+        case BINARY_CMD_LED_STREAM_FRAME: {
+            // 正常帧不回复，避免每帧占用发送缓冲；出错时回复以便上位机重发关键帧
+            LedStreamResult result = LED_STREAM.submitFrame(data + 1, length - 1);
+            if (result != LED_STREAM_OK) {
+                send_led_stream_response(conn, BINARY_CMD_LED_STREAM_FRAME_RESP, result);
+            }
+            break;
+        }
+        case BINARY_CMD_LED_STREAM_END: {
+            LED_STREAM.end();
+            LOG_INFO("LedStream", "LED stream stopped, received: %lu, dropped: %lu",
+                LED_STREAM.getReceivedFrames(), LED_STREAM.getDroppedFrames());
+            send_led_stream_response(conn, BINARY_CMD_LED_STREAM_END_RESP, LED_STREAM_OK);
+            break;
+        }
+        default:
+            break;
+    }
+}
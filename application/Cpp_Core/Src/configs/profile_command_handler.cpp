@@ -1,5 +1,6 @@
 #include "configs/websocket_command_handler.hpp"
 #include "storagemanager.hpp"
+#include "profile_runtime.hpp"
 #include "system_logger.h"
 #include "board_cfg.h"
 #include "cpp_utils.hpp"
@@ -16,6 +17,13 @@ ProfileCommandHandler& ProfileCommandHandler::getInstance() {
     return instance;
 }
 
+// 按键映射、SOCD、宏、触发参数都编译在运行时镜像里：改的是默认配置文件时重新编译
+static void refresh_runtime_if_default(const GamepadProfile* profile) {
+    if (profile && strcmp(profile->id, STORAGE_MANAGER.config.defaultProfileId) == 0) {
+        PROFILE_RUNTIME.request(*profile);
+    }
+}
+
 cJSON* ProfileCommandHandler::buildKeyMappingJSON(uint32_t virtualMask) {
     cJSON* keyMappingJSON = cJSON_CreateArray();
     
@@ -331,6 +339,7 @@ cJSON* ProfileCommandHandler::buildProfileJSON(GamepadProfile* profile) {
     cJSON_AddItemToObject(ledsConfigJSON, "ledColors", ledColorsJSON);
     cJSON_AddNumberToObject(ledsConfigJSON, "ledBrightness", profile->ledsConfigs.ledBrightness);
     cJSON_AddNumberToObject(ledsConfigJSON, "ledAnimationSpeed", profile->ledsConfigs.ledAnimationSpeed);
+    cJSON_AddNumberToObject(ledsConfigJSON, "ledReactiveFadeMs", profile->ledsConfigs.ledReactiveFadeMs);
 
     // 氛围灯配置
     cJSON_AddBoolToObject(ledsConfigJSON, "hasAroundLed", g_has_led_around); // 是否包含氛围灯，由主板决定
@@ -403,7 +412,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleGetProfileList(const Web
     GamepadProfile* defaultProfile = nullptr;
     for(uint8_t i = 0; i < NUM_PROFILES; i++) {
         if(strcmp(config.defaultProfileId, config.profiles[i].id) == 0) {
-            defaultProfile = &config.profiles[i];
+            defaultProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -426,7 +435,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleGetDefaultProfile(const
     GamepadProfile* defaultProfile = nullptr;
     for(uint8_t i = 0; i < NUM_PROFILES; i++) {
         if(strcmp(config.defaultProfileId, config.profiles[i].id) == 0) {
-            defaultProfile = &config.profiles[i];
+            defaultProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -727,6 +736,13 @@ void ProfileCommandHandler::parseProfileJSON(cJSON* profileJSON, GamepadProfile*
             if(val > 255) val = 255;
             targetProfile->ledsConfigs.aroundLedAnimationSpeed = (uint8_t)val;
         }
+
+        if((item = cJSON_GetObjectItem(ledsConfig, "ledReactiveFadeMs")) && cJSON_IsNumber(item)) {
+            int val = item->valueint;
+            if(val < 0) val = 0;
+            if(val > LEDS_REACTIVE_FADE_MAX_MS) val = LEDS_REACTIVE_FADE_MAX_MS;
+            targetProfile->ledsConfigs.ledReactiveFadeMs = (uint16_t)val;
+        }
     }
 
     // 更新按键行程配置
@@ -814,7 +830,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleUpdateProfile(const WebS
     GamepadProfile* targetProfile = nullptr;
     for(uint8_t i = 0; i < NUM_PROFILES; i++) {
         if(strcmp(idItem->valuestring, config.profiles[i].id) == 0) {
-            targetProfile = &config.profiles[i];
+            targetProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -826,9 +842,10 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleUpdateProfile(const WebS
 
     // 更新配置
     parseProfileJSON(details, targetProfile);
+    refresh_runtime_if_default(targetProfile);
 
     // 保存配置
-    if(!STORAGE_MANAGER.saveConfig()) {
+    if(!STORAGE_MANAGER.saveConfig(STORAGE_MANAGER.getProfileSections(targetProfile, false) | STORAGE_MANAGER.getProfileSections(targetProfile, true))) {
         LOG_ERROR("WebSocket", "update_profile: Failed to save configuration");
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
@@ -852,7 +869,7 @@ static GamepadProfile* find_profile_by_id(Config& config, const char* id) {
     if (!id) return nullptr;
     for (uint8_t i = 0; i < NUM_PROFILES; i++) {
         if (strcmp(id, config.profiles[i].id) == 0) {
-            return &config.profiles[i];
+            return STORAGE_MANAGER.getProfileAt(i);
         }
     }
     return nullptr;
@@ -1251,8 +1268,9 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleUpdateMacro(const WebSoc
 
     MacroConfig& out = profile->keysConfig.macros[index];
     out = decoded;
+    refresh_runtime_if_default(profile);
 
-    if(!STORAGE_MANAGER.saveConfig()) {
+    if(!STORAGE_MANAGER.saveConfig(STORAGE_MANAGER.getProfileSections(profile, false))) {
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
 
@@ -1304,8 +1322,9 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleUpdateProfileMacros(cons
             return create_error_response(request.getCid(), request.getCommand(), 1, "Invalid macros data");
         }
     }
+    refresh_runtime_if_default(profile);
 
-    if (!STORAGE_MANAGER.saveConfig()) {
+    if (!STORAGE_MANAGER.saveConfig(STORAGE_MANAGER.getProfileSections(profile, false))) {
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
 
@@ -1341,18 +1360,15 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleCreateProfile(const WebS
 
     // 整理配置文件列表，将所有已启用的配置文件移动到前面
     // 这样新创建的配置文件就会被添加到所有启用配置文件的后面
+    bool reordered = false;
     for (uint8_t dest = 0; dest < NUM_PROFILES; dest++) {
         if (!config.profiles[dest].enabled) {
             // 如果当前位置为空，查找后面第一个启用的配置文件
             for (uint8_t src = dest + 1; src < NUM_PROFILES; src++) {
                 if (config.profiles[src].enabled) {
-                    // 移动配置文件
-                    config.profiles[dest] = config.profiles[src];
-                    
-                    // 清空源位置
-                    config.profiles[src].enabled = false;
-                    memset(config.profiles[src].id, 0, sizeof(config.profiles[src].id));
-                    memset(config.profiles[src].name, 0, sizeof(config.profiles[src].name));
+                    // 移动配置文件：只调整顺序表，中间未启用的配置文件整体后移一位
+                    STORAGE_MANAGER.moveProfile(src, dest);
+                    reordered = true;
                     
                     break; // 找到一个移动后，重新检查当前dest位置（其实不需要，因为刚移过来的是启用的，直接进行下一个dest即可? 不，刚移过来的就是启用的，所以dest位置填满了，可以继续）
                 }
@@ -1360,11 +1376,16 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleCreateProfile(const WebS
         }
     }
 
+    // 默认配置文件可能被移动过，重新固定并通知各模块
+    if (reordered) {
+        STORAGE_MANAGER.refreshDefaultProfile();
+    }
+
     // 查找第一个未启用的配置文件（现在应该是在所有启用配置文件的末尾）
     GamepadProfile* targetProfile = nullptr;
     for(uint8_t i = 0; i < NUM_PROFILES; i++) {
         if(!config.profiles[i].enabled) {
-            targetProfile = &config.profiles[i];
+            targetProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -1387,7 +1408,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleCreateProfile(const WebS
     }
 
     // 保存配置
-    if(!STORAGE_MANAGER.saveConfig()) {
+    if(!STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL | STORAGE_MANAGER.getProfileSections(targetProfile, false) | STORAGE_MANAGER.getProfileSections(targetProfile, true))) {
         LOG_ERROR("WebSocket", "create_profile: Failed to save configuration");
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
@@ -1437,7 +1458,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleDeleteProfile(const WebS
         if(config.profiles[i].enabled) {
             numEnabledProfiles++;
             if(strcmp(profileIdItem->valuestring, config.profiles[i].id) == 0) {
-                targetProfile = &config.profiles[i];
+                targetProfile = STORAGE_MANAGER.getProfileAt(i);
                 targetIndex = i;
             }
         }
@@ -1456,24 +1477,13 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleDeleteProfile(const WebS
     }
 
     // 禁用配置文件（相当于删除）
-    config.profiles[targetIndex].enabled = false;
-
-    // 为了保持内存连续性，将目标配置文件之后的配置文件向前移动一位
-    // 保存目标配置文件的副本
-    GamepadProfile* tempProfile = (GamepadProfile*)malloc(sizeof(GamepadProfile));
-    if(!tempProfile) {
-        LOG_ERROR("WebSocket", "delete_profile: Failed to allocate memory");
-        return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to allocate memory");
-    }
-    // 保存目标配置文件
-    memcpy(tempProfile, &config.profiles[targetIndex], sizeof(GamepadProfile));
-    // 将目标配置文件之后的配置文件向前移动一位
-    memmove(&config.profiles[targetIndex], 
-            &config.profiles[targetIndex + 1], 
-            (NUM_PROFILES - targetIndex - 1) * sizeof(GamepadProfile));
-    // 将目标配置文件放到最后一个
-    memcpy(&config.profiles[NUM_PROFILES - 1], tempProfile, sizeof(GamepadProfile));
-    free(tempProfile);
+    targetProfile->enabled = false;
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(targetProfile, false));
+
+    // 为了保持列表连续，把目标配置文件移到最后，之后的配置文件各前移一位（只调整顺序表，随下面的保存一起写入）
+    STORAGE_MANAGER.moveProfile(targetIndex, NUM_PROFILES - 1);
+    // 默认配置文件若在被删除的之后，它已前移一位，重新固定并通知各模块
+    STORAGE_MANAGER.refreshDefaultProfile();
 
     // 设置下一个启用的配置文件为默认配置文件
     for(uint8_t i = targetIndex; i >= 0; i --) {
@@ -1501,7 +1511,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleDeleteProfile(const WebS
     GamepadProfile* defaultProfile = nullptr;
     for(uint8_t i = targetIndex; i >= 0; i --) {
         if(strcmp(config.defaultProfileId, config.profiles[i].id) == 0) {
-            defaultProfile = &config.profiles[i];
+            defaultProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -1541,7 +1551,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleSwitchDefaultProfile(con
     GamepadProfile* targetProfile = nullptr;
     for(uint8_t i = 0; i < NUM_PROFILES; i++) {
         if(strcmp(profileIdItem->valuestring, config.profiles[i].id) == 0) {
-            targetProfile = &config.profiles[i];
+            targetProfile = STORAGE_MANAGER.getProfileAt(i);
             break;
         }
     }
@@ -1560,7 +1570,7 @@ WebSocketDownstreamMessage ProfileCommandHandler::handleSwitchDefaultProfile(con
     STORAGE_MANAGER.setDefaultProfileId(targetProfile->id);
 
     // 保存配置
-    if(!STORAGE_MANAGER.saveConfig()) {
+    if(!STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL)) {
         LOG_ERROR("WebSocket", "switch_default_profile: Failed to save configuration");
         return create_error_response(request.getCid(), request.getCommand(), 1, "Failed to save configuration");
     }
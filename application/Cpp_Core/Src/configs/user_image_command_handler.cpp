@@ -199,16 +199,13 @@ static void clear_user_image_upload_session() {
     memset(&g_user_image_upload_session, 0, sizeof(g_user_image_upload_session));
 }
 
+// 作用域内持有 QSPI 间接模式会话，嵌套的读写不再反复切换内存映射
 struct QSPIXipGuard {
-    bool was_xip;
-    QSPIXipGuard() : was_xip(QSPI_W25Qxx_IsMemoryMappedMode()) {
-        if (was_xip) {
-            QSPI_W25Qxx_ExitMemoryMappedMode();
-        }
-    }
+    bool held;
+    QSPIXipGuard() : held(QSPI_W25Qxx_BeginIndirect() == QSPI_W25Qxx_OK) {}
     ~QSPIXipGuard() {
-        if (was_xip) {
-            QSPI_W25Qxx_EnterMemoryMappedMode();
+        if (held) {
+            QSPI_W25Qxx_EndIndirect();
         }
     }
 };
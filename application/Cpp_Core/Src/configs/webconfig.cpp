@@ -13,6 +13,8 @@
 #include "firmware/firmware_manager.hpp"
 #include "storagemanager.hpp"
 #include "configs/user_image_command_handler.hpp"
+#include "configs/led_stream_command_handler.hpp"
+#include "configs/led_program_command_handler.hpp"
 #include <cctype>
 #include <cstring>
 #include <cstdlib>
@@ -387,6 +389,7 @@ void onWebSocketDisconnect(WebSocketConnection* conn) {
         g_websocket_connection_count = 0;
         APP_DBG("WebSocket: Current connection closed, total connections: %d", g_websocket_connection_count);
         UserImageCommandHandler::handleBinaryMessage(conn, nullptr, 0); // trigger cleanup
+        LedStreamCommandHandler::handleBinaryMessage(conn, nullptr, 0); // 结束灯光流
         
         // 如果校准正在进行中，自动停止校准
         if (ADCCalibrationManager::getInstance().isCalibrationActive()) {
@@ -456,6 +459,19 @@ void onWebSocketBinaryMessage(WebSocketConnection* conn, const uint8_t* data, si
             UserImageCommandHandler::handleBinaryMessage(conn, data, length);
             break;
         }
+        case 0x40:
+        case 0x41:
+        case 0x42: {
+            LedStreamCommandHandler::handleBinaryMessage(conn, data, length);
+            break;
+        }
+        case 0x50:
+        case 0x51:
+        case 0x52:
+        case 0x53: {
+            LedProgramCommandHandler::handleBinaryMessage(conn, data, length);
+            break;
+        }
         default:
             LOG_WARN("WebSocket", "Unknown binary command: %d", command);
             // 可以在这里发送错误响应
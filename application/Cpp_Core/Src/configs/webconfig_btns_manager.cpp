@@ -4,6 +4,7 @@
 #include "gpio_btns/gpio_btns_worker.hpp"
 #include "board_cfg.h"
 #include "storagemanager.hpp"
+#include "profile_runtime.hpp"
 #include "stm32h7xx_hal.h"  // 为HAL_GetTick()
 #include "configs/common_command_handler.hpp"  // 为WebSocket推送
 
@@ -141,6 +142,9 @@ void WebConfigBtnsManager::update() {
         return;
     }
 
+    // 网页配置模式没有输入循环，在这里换上 setup() 编译好的配置文件镜像
+    PROFILE_RUNTIME.commit();
+
     // 技术测试模式下，只处理ADC按键，并且每一次循环都send websocket 传输当前的状态和值
 
     if(isTestModeEnabled_) {
@@ -11,7 +11,7 @@ WebConfigLedsManager& WebConfigLedsManager::getInstance() {
 }
 
 WebConfigLedsManager::WebConfigLedsManager() 
-    : previewMode(false), lastButtonMask(0) {
+    : previewMode(false), lastButtonMask(0), streamActive(false) {
     
     
     // 初始化预览配置为默认值
@@ -91,9 +91,19 @@ bool WebConfigLedsManager::isInPreviewMode() const {
 }
 
 void WebConfigLedsManager::update(uint32_t buttonMask) {
+    // 灯光流不依赖预览模式
+    bool streaming = LED_STREAM.isActive(HAL_GetTick());
     if (!previewMode) {
+        if (streaming) {
+            LEDS_MANAGER.loop(buttonMask);
+        } else if (streamActive) {
+            // 网页配置模式下不预览时保持灯光关闭，流结束后直接关灯，不先恢复本地灯效
+            LEDS_MANAGER.stopStream();
+        }
+        streamActive = streaming;
         return;
     }
+    streamActive = streaming;
     
     // 只保留启用按键的状态，禁用的按键强制为未按下状态
     uint32_t filteredButtonMask = buttonMask & enabledKeysMask;
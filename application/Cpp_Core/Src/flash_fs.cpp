@@ -0,0 +1,513 @@
+#include "flash_fs.hpp"
+#include "flash_writer.hpp"
+#include "CRC32.hpp"
+#include "system_logger.h"
+#include <stddef.h>
+#include <string.h>
+
+#pragma pack(push, 1)
+struct FlashFsBlockHeader {
+    // 擦除后写入
+    uint32_t magic;             // FLASH_FS_MAGIC
+    uint32_t eraseCount;
+    uint32_t eraseCrc;          // magic、eraseCount 的 CRC32
+    // 分配时写入
+    uint32_t seq;               // 文件版本号，全局递增
+    uint16_t blockIndex;
+    uint16_t reserved0;
+    char name[FLASH_FS_NAME_LEN];
+    uint32_t allocCrc;          // seq 到 name 的 CRC32
+    // 提交时写入，只在第 0 块
+    uint32_t size;
+    uint16_t blockCount;
+    uint16_t reserved1;
+    uint32_t commitCrc;         // size 到 reserved1 的 CRC32
+    // 删除时写 0，只在第 0 块
+    uint32_t removed;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FlashFsBlockHeader) <= FLASH_FS_HEADER_SIZE, "block header exceeds FLASH_FS_HEADER_SIZE");
+static_assert(FLASH_FS_HEADER_SIZE <= W25Qxx_PageSize, "block header must stay in the first page");
+
+#define HEADER_ERASE_OFFSET         offsetof(FlashFsBlockHeader, magic)
+#define HEADER_ERASE_LEN            offsetof(FlashFsBlockHeader, seq)
+#define HEADER_ALLOC_OFFSET         offsetof(FlashFsBlockHeader, seq)
+#define HEADER_ALLOC_LEN            (offsetof(FlashFsBlockHeader, size) - offsetof(FlashFsBlockHeader, seq))
+#define HEADER_COMMIT_OFFSET        offsetof(FlashFsBlockHeader, size)
+#define HEADER_COMMIT_LEN           (offsetof(FlashFsBlockHeader, removed) - offsetof(FlashFsBlockHeader, size))
+
+static bool all_erased(const void* data, uint32_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static uint32_t name_hash(const char* name)
+{
+    return CRC32::calculate((const uint8_t*)name, (uint16_t)strnlen(name, FLASH_FS_NAME_LEN));
+}
+
+static bool name_valid(const char* name)
+{
+    if (!name) return false;
+    const size_t len = strnlen(name, FLASH_FS_NAME_LEN);
+    return len > 0 && len < FLASH_FS_NAME_LEN;
+}
+
+uint32_t FlashFs::blockAddress(uint16_t block)
+{
+    for (uint8_t r = 0; r < FlashFsLayout::NUM_REGIONS; r++) {
+        const uint16_t n = (uint16_t)(FlashFsLayout::REGIONS[r].size / FLASH_FS_BLOCK_SIZE);
+        if (block < n) {
+            return FlashFsLayout::REGIONS[r].addr + (uint32_t)block * FLASH_FS_BLOCK_SIZE;
+        }
+        block -= n;
+    }
+    return 0;
+}
+
+bool FlashFs::programBytes(uint32_t addr, const void* data, uint32_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    while (len > 0) {
+        uint32_t n = W25Qxx_PageSize - (addr % W25Qxx_PageSize);
+        if (n > len) n = len;
+        if (!FLASH_WRITER.program(addr, p, (uint16_t)n)) return false;
+        addr += n;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool FlashFs::readName(uint16_t block, char* name)
+{
+    if (!FLASH_WRITER.read(blockAddress(block) + offsetof(FlashFsBlockHeader, name), name, FLASH_FS_NAME_LEN)) {
+        return false;
+    }
+    name[FLASH_FS_NAME_LEN - 1] = '\0';
+    return true;
+}
+
+bool FlashFs::nameMatches(uint16_t block, const char* name, uint32_t hash)
+{
+    if (blocks[block].nameHash != hash) return false;
+    char stored[FLASH_FS_NAME_LEN];
+    return readName(block, stored) && strncmp(stored, name, FLASH_FS_NAME_LEN) == 0;
+}
+
+int16_t FlashFs::findBlock(uint32_t seq, uint16_t index, BlockState state) const
+{
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if (blocks[b].state == state && blocks[b].seq == seq && blocks[b].index == index) {
+            return (int16_t)b;
+        }
+    }
+    return -1;
+}
+
+bool FlashFs::isComplete(uint16_t head) const
+{
+    // 挂载时各块都还是 STALE
+    for (uint16_t i = 1; i < blocks[head].count; i++) {
+        if (findBlock(blocks[head].seq, i, BLOCK_STALE) < 0) return false;
+    }
+    return true;
+}
+
+void FlashFs::setVersionState(uint32_t seq, BlockState state)
+{
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if ((blocks[b].state == BLOCK_LIVE || blocks[b].state == BLOCK_WRITING) && blocks[b].seq == seq) {
+            blocks[b].state = state;
+        }
+    }
+}
+
+int16_t FlashFs::findHead(const char* name)
+{
+    if (!mount() || !name_valid(name)) return -1;
+    const uint32_t hash = name_hash(name);
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if (blocks[b].state == BLOCK_LIVE && blocks[b].index == 0 && nameMatches(b, name, hash)) {
+            return (int16_t)b;
+        }
+    }
+    return -1;
+}
+
+bool FlashFs::mount()
+{
+    if (mounted) return true;
+
+    bool eraseKnown[FlashFsLayout::NUM_BLOCKS];
+    bool authoritative[FlashFsLayout::NUM_BLOCKS];     // 块齐全、决定了所属文件名的提交
+    uint32_t maxErase = 0;
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        BlockInfo& info = blocks[b];
+        memset(&info, 0, sizeof(BlockInfo));
+        info.state = BLOCK_STALE;
+        eraseKnown[b] = false;
+        authoritative[b] = false;
+
+        FlashFsBlockHeader h;
+        if (!FLASH_WRITER.read(blockAddress(b), &h, sizeof(h))) {
+            APP_ERR("FlashFs: read block %u failed", b);
+            return false;
+        }
+        // 没有块头（新片子、其他格式的旧数据或擦除中掉电）：分配时重新擦除
+        if (h.magic != FLASH_FS_MAGIC || CRC32::calculate((const uint8_t*)&h, (uint16_t)(HEADER_ERASE_LEN - sizeof(uint32_t))) != h.eraseCrc) {
+            continue;
+        }
+        eraseKnown[b] = true;
+        info.eraseCount = h.eraseCount;
+        if (h.eraseCount > maxErase) maxErase = h.eraseCount;
+
+        const uint8_t* alloc = (const uint8_t*)&h + HEADER_ALLOC_OFFSET;
+        if (all_erased(alloc, HEADER_ALLOC_LEN)) {
+            info.state = BLOCK_FREE;
+            continue;
+        }
+        if (CRC32::calculate(alloc, (uint16_t)(HEADER_ALLOC_LEN - sizeof(uint32_t))) != h.allocCrc) {
+            continue;
+        }
+        info.seq = h.seq;
+        info.index = h.blockIndex;
+        h.name[FLASH_FS_NAME_LEN - 1] = '\0';
+        info.nameHash = name_hash(h.name);
+        if (h.seq >= nextSeq) nextSeq = h.seq + 1;
+
+        const uint8_t* commit = (const uint8_t*)&h + HEADER_COMMIT_OFFSET;
+        if (h.blockIndex == 0 && h.blockCount > 0
+            && CRC32::calculate(commit, (uint16_t)(HEADER_COMMIT_LEN - sizeof(uint32_t))) == h.commitCrc) {
+            info.size = h.size;
+            info.count = h.blockCount;
+            info.removed = h.removed != 0xFFFFFFFFu;
+        }
+    }
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if (!eraseKnown[b]) blocks[b].eraseCount = maxErase;
+    }
+
+    // 从版本号最大的提交开始，每个文件名取第一个块齐全的版本；它是删除标记时文件不存在
+    uint32_t below = UINT32_MAX;
+    while (true) {
+        int16_t head = -1;
+        for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+            const BlockInfo& info = blocks[b];
+            if (info.state == BLOCK_STALE && info.index == 0 && info.count > 0 && info.seq < below
+                && (head < 0 || info.seq > blocks[head].seq)) {
+                head = (int16_t)b;
+            }
+        }
+        if (head < 0) break;
+        below = blocks[head].seq;
+        // 删除标记不看块是否齐全：删除后其余块随时可能被回收
+        if (!blocks[head].removed && !isComplete((uint16_t)head)) continue;
+
+        char name[FLASH_FS_NAME_LEN];
+        if (!readName((uint16_t)head, name)) continue;
+        bool decided = false;
+        for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS && !decided; b++) {
+            decided = authoritative[b] && nameMatches(b, name, blocks[head].nameHash);
+        }
+        if (decided) continue;
+        authoritative[head] = true;
+        if (blocks[head].removed) continue;
+        for (uint16_t i = 0; i < blocks[head].count; i++) {
+            blocks[findBlock(blocks[head].seq, i, BLOCK_STALE)].state = BLOCK_LIVE;
+        }
+    }
+
+    mounted = true;
+    return true;
+}
+
+bool FlashFs::open(const char* name, FlashFsFile& file)
+{
+    const int16_t head = findHead(name);
+    if (head < 0) return false;
+    file.seq = blocks[head].seq;
+    file.size = blocks[head].size;
+    file.pos = 0;
+    return true;
+}
+
+uint32_t FlashFs::read(FlashFsFile& file, void* out, uint32_t len)
+{
+    if (!mounted || file.pos >= file.size) return 0;
+    if (len > file.size - file.pos) len = file.size - file.pos;
+
+    uint8_t* p = (uint8_t*)out;
+    uint32_t done = 0;
+    while (done < len) {
+        const uint16_t index = (uint16_t)(file.pos / FLASH_FS_BLOCK_PAYLOAD);
+        const uint32_t offset = file.pos % FLASH_FS_BLOCK_PAYLOAD;
+        // 文件已被替换或删除时找不到块
+        const int16_t block = findBlock(file.seq, index, BLOCK_LIVE);
+        if (block < 0) break;
+        uint32_t n = FLASH_FS_BLOCK_PAYLOAD - offset;
+        if (n > len - done) n = len - done;
+        if (!FLASH_WRITER.read(blockAddress((uint16_t)block) + FLASH_FS_HEADER_SIZE + offset, p + done, n)) break;
+        done += n;
+        file.pos += n;
+    }
+    return done;
+}
+
+bool FlashFs::seek(FlashFsFile& file, uint32_t pos)
+{
+    if (pos > file.size) return false;
+    file.pos = pos;
+    return true;
+}
+
+bool FlashFs::stat(const char* name, uint32_t* size)
+{
+    const int16_t head = findHead(name);
+    if (head < 0) return false;
+    if (size) *size = blocks[head].size;
+    return true;
+}
+
+int16_t FlashFs::allocBlock(uint16_t index)
+{
+    // 擦除次数最少的优先，相同时优先不用擦除的块；从上次分配的位置往后找，让写入轮流落在各块上
+    int16_t best = -1;
+    for (uint16_t i = 0; i < FlashFsLayout::NUM_BLOCKS; i++) {
+        const uint16_t b = (uint16_t)((allocCursor + i) % FlashFsLayout::NUM_BLOCKS);
+        const BlockInfo& info = blocks[b];
+        if (info.state != BLOCK_FREE && info.state != BLOCK_STALE) continue;
+        if (best < 0 || info.eraseCount < blocks[best].eraseCount
+            || (info.eraseCount == blocks[best].eraseCount && info.state == BLOCK_FREE && blocks[best].state != BLOCK_FREE)) {
+            best = (int16_t)b;
+        }
+    }
+    if (best < 0) return -1;
+    allocCursor = (uint16_t)((best + 1) % FlashFsLayout::NUM_BLOCKS);
+
+    BlockInfo& info = blocks[best];
+    const uint32_t addr = blockAddress((uint16_t)best);
+    FlashFsBlockHeader h;
+    memset(&h, 0xFF, sizeof(h));
+    if (info.state == BLOCK_STALE) {
+        // 擦除后马上写回擦除次数
+        info.eraseCount++;
+        h.magic = FLASH_FS_MAGIC;
+        h.eraseCount = info.eraseCount;
+        h.eraseCrc = CRC32::calculate((const uint8_t*)&h, (uint16_t)(HEADER_ERASE_LEN - sizeof(uint32_t)));
+        if (!FLASH_WRITER.erase(addr) || !programBytes(addr, &h, HEADER_ERASE_LEN)) return -1;
+    }
+
+    h.seq = writeSeq;
+    h.blockIndex = index;
+    memset(h.name, 0, sizeof(h.name));
+    memcpy(h.name, writeName, strnlen(writeName, sizeof(h.name) - 1));
+    h.allocCrc = CRC32::calculate((const uint8_t*)&h + HEADER_ALLOC_OFFSET, (uint16_t)(HEADER_ALLOC_LEN - sizeof(uint32_t)));
+    if (!programBytes(addr + HEADER_ALLOC_OFFSET, (const uint8_t*)&h + HEADER_ALLOC_OFFSET, HEADER_ALLOC_LEN)) return -1;
+
+    info.seq = writeSeq;
+    info.index = index;
+    info.nameHash = name_hash(writeName);
+    info.size = 0;
+    info.count = 0;
+    info.removed = false;
+    info.state = BLOCK_WRITING;
+    return best;
+}
+
+bool FlashFs::beginWrite(const char* name)
+{
+    if (!name_valid(name) || !mount()) return false;
+    if (writing) abort();
+    memset(writeName, 0, sizeof(writeName));
+    strncpy(writeName, name, sizeof(writeName) - 1);
+    writeSeq = nextSeq++;
+    writeSize = 0;
+    writeBlocks = 0;
+    writeBlock = -1;
+    writing = true;
+    return true;
+}
+
+bool FlashFs::write(const void* data, uint32_t len)
+{
+    if (!writing) return false;
+    const uint8_t* p = (const uint8_t*)data;
+    while (len > 0) {
+        uint32_t used = writeBlocks > 0 ? writeSize - (uint32_t)(writeBlocks - 1) * FLASH_FS_BLOCK_PAYLOAD : 0;
+        if (writeBlock < 0 || used >= FLASH_FS_BLOCK_PAYLOAD) {
+            writeBlock = allocBlock(writeBlocks);
+            if (writeBlock < 0) {
+                APP_ERR("FlashFs: no space for %s", writeName);
+                abort();
+                return false;
+            }
+            writeBlocks++;
+            used = 0;
+        }
+        uint32_t n = FLASH_FS_BLOCK_PAYLOAD - used;
+        if (n > len) n = len;
+        if (!programBytes(blockAddress((uint16_t)writeBlock) + FLASH_FS_HEADER_SIZE + used, p, n)) {
+            abort();
+            return false;
+        }
+        writeSize += n;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool FlashFs::commit()
+{
+    if (!writing) return false;
+    if (writeBlocks == 0) {
+        // 空文件也要占一块放提交记录
+        writeBlock = allocBlock(0);
+        if (writeBlock < 0) {
+            abort();
+            return false;
+        }
+        writeBlocks = 1;
+    }
+    // 数据全部落盘之后才写提交记录
+    if (!FLASH_WRITER.flush()) {
+        APP_ERR("FlashFs: write %s failed", writeName);
+        abort();
+        return false;
+    }
+
+    const int16_t head = findBlock(writeSeq, 0, BLOCK_WRITING);
+    FlashFsBlockHeader h;
+    memset(&h, 0xFF, sizeof(h));
+    h.size = writeSize;
+    h.blockCount = writeBlocks;
+    h.commitCrc = CRC32::calculate((const uint8_t*)&h + HEADER_COMMIT_OFFSET, (uint16_t)(HEADER_COMMIT_LEN - sizeof(uint32_t)));
+    if (head < 0
+        || !programBytes(blockAddress((uint16_t)head) + HEADER_COMMIT_OFFSET, (const uint8_t*)&h + HEADER_COMMIT_OFFSET, HEADER_COMMIT_LEN)
+        || !FLASH_WRITER.flush()) {
+        APP_ERR("FlashFs: commit %s failed", writeName);
+        abort();
+        return false;
+    }
+
+    const int16_t old = findHead(writeName);
+    if (old >= 0) {
+        setVersionState(blocks[old].seq, BLOCK_STALE);
+    }
+    setVersionState(writeSeq, BLOCK_LIVE);
+    blocks[head].size = writeSize;
+    blocks[head].count = writeBlocks;
+    writing = false;
+
+    levelWear();
+    return true;
+}
+
+void FlashFs::abort()
+{
+    if (!writing) return;
+    // 已经写下的块没有提交记录，挂载时同样当作不再使用
+    setVersionState(writeSeq, BLOCK_STALE);
+    writing = false;
+}
+
+bool FlashFs::writeFile(const char* name, const void* data, uint32_t len)
+{
+    return beginWrite(name) && write(data, len) && commit();
+}
+
+bool FlashFs::remove(const char* name)
+{
+    const int16_t head = findHead(name);
+    if (head < 0) return false;
+
+    // 同名的旧提交可能还没被回收，一起打上删除标记，免得当前版本的块被回收后旧版本复活。
+    // 当前版本最后标记，它是删除的提交点：之前断电时文件原样保留，之后旧提交都已标记
+    const uint32_t hash = blocks[head].nameHash;
+    const uint32_t removed = 0;
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        const BlockInfo& info = blocks[b];
+        if (b == head || info.state != BLOCK_STALE || info.index != 0 || info.count == 0 || info.removed) {
+            continue;
+        }
+        if (!nameMatches(b, name, hash)) continue;
+        if (!programBytes(blockAddress(b) + offsetof(FlashFsBlockHeader, removed), &removed, sizeof(removed))) return false;
+        blocks[b].removed = true;
+    }
+    if (!programBytes(blockAddress((uint16_t)head) + offsetof(FlashFsBlockHeader, removed), &removed, sizeof(removed))) return false;
+    blocks[head].removed = true;
+    const bool ok = FLASH_WRITER.flush();
+    setVersionState(blocks[head].seq, BLOCK_STALE);
+
+    levelWear();
+    return ok;
+}
+
+void FlashFs::list(void (*callback)(const char* name, uint32_t size, void* context), void* context)
+{
+    if (!callback || !mount()) return;
+    char name[FLASH_FS_NAME_LEN];
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if (blocks[b].state != BLOCK_LIVE || blocks[b].index != 0) continue;
+        if (readName(b, name)) {
+            callback(name, blocks[b].size, context);
+        }
+    }
+}
+
+uint32_t FlashFs::freeBytes()
+{
+    if (!mount()) return 0;
+    uint32_t free = 0;
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        if (blocks[b].state == BLOCK_FREE || blocks[b].state == BLOCK_STALE) {
+            free += FLASH_FS_BLOCK_PAYLOAD;
+        }
+    }
+    return free;
+}
+
+void FlashFs::levelWear()
+{
+    if (leveling || writing) return;
+
+    // 找擦除次数最少的在用块，和最多的差得太远时把它所在的文件整个搬走，腾出这块给以后的写入
+    uint32_t maxErase = 0;
+    int16_t coldest = -1;
+    uint16_t freeBlocks = 0;
+    for (uint16_t b = 0; b < FlashFsLayout::NUM_BLOCKS; b++) {
+        const BlockInfo& info = blocks[b];
+        if (info.eraseCount > maxErase) maxErase = info.eraseCount;
+        if (info.state == BLOCK_FREE || info.state == BLOCK_STALE) {
+            freeBlocks++;
+        } else if (info.state == BLOCK_LIVE && (coldest < 0 || info.eraseCount < blocks[coldest].eraseCount)) {
+            coldest = (int16_t)b;
+        }
+    }
+    if (coldest < 0 || maxErase - blocks[coldest].eraseCount <= FLASH_FS_WEAR_LEVEL_DELTA) return;
+
+    const int16_t head = findBlock(blocks[coldest].seq, 0, BLOCK_LIVE);
+    char name[FLASH_FS_NAME_LEN];
+    if (head < 0 || blocks[head].count > freeBlocks || !readName((uint16_t)head, name)) return;
+
+    leveling = true;
+    FlashFsFile source = { blocks[head].seq, blocks[head].size, 0 };
+    uint8_t buffer[W25Qxx_PageSize];
+    bool ok = beginWrite(name);
+    while (ok && source.pos < source.size) {
+        const uint32_t n = read(source, buffer, sizeof(buffer));
+        ok = n > 0 && write(buffer, n);
+    }
+    if (ok) {
+        commit();
+    } else {
+        abort();
+    }
+    leveling = false;
+}
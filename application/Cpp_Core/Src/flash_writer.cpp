@@ -0,0 +1,192 @@
+#include "flash_writer.hpp"
+#include "micro_timer.hpp"
+#include "system_logger.h"
+#include <string.h>
+
+// 超过这个时间没有 SOF（未连接、挂起或不在低延迟模式）就不再按帧安排命令
+#ifndef FLASH_WRITER_SOF_TIMEOUT_US
+#define FLASH_WRITER_SOF_TIMEOUT_US     3000u
+#endif
+
+#define FLASH_WRITER_ADDR_MASK          0x00FFFFFFu
+
+bool FlashWriter::erase(uint32_t addr)
+{
+    return submit(JOB_ERASE, addr & ~(uint32_t)(W25Qxx_SECTOR_SIZE - 1), nullptr, 0);
+}
+
+bool FlashWriter::program(uint32_t addr, const void* data, uint16_t len)
+{
+    if (!data || len == 0 || (addr % W25Qxx_PageSize) + len > W25Qxx_PageSize) {
+        return false;
+    }
+    return submit(JOB_PROGRAM, addr, data, len);
+}
+
+bool FlashWriter::submit(JobType type, uint32_t addr, const void* data, uint16_t len)
+{
+    // 队列满：同步执行最早的操作腾出位置，执行中的错误留给 flush() 报告
+    while (count >= FLASH_WRITER_QUEUE_DEPTH) {
+        if (inFlight) {
+            waitInFlight();
+        } else {
+            issueHead();
+        }
+    }
+    Job& job = jobs[(first + count) % FLASH_WRITER_QUEUE_DEPTH];
+    job.type = type;
+    job.addr = addr & FLASH_WRITER_ADDR_MASK;
+    job.len = len;
+    if (data) {
+        memcpy(job.data, data, len);
+    }
+    count++;
+    return true;
+}
+
+bool FlashWriter::read(uint32_t addr, void* out, uint32_t len)
+{
+    const uint32_t offset = addr & FLASH_WRITER_ADDR_MASK;
+    // 器件擦写期间不响应读命令
+    waitInFlight();
+
+    bool ok;
+    if (QSPI_W25Qxx_IsMemoryMappedMode()) {
+        memcpy(out, (const void*)(uintptr_t)(W25Qxx_Mem_Addr + offset), len);
+        ok = true;
+    } else {
+        ok = QSPI_W25Qxx_ReadBuffer((uint8_t*)out, offset, len) == QSPI_W25Qxx_OK;
+    }
+    if (ok) {
+        overlay(offset, (uint8_t*)out, len);
+    }
+    return ok;
+}
+
+void FlashWriter::overlay(uint32_t offset, uint8_t* out, uint32_t len) const
+{
+    // 按执行顺序模拟 NOR：擦除置 0xFF，编程只能把 1 写成 0
+    for (uint8_t i = 0; i < count; i++) {
+        const Job& job = jobs[(first + i) % FLASH_WRITER_QUEUE_DEPTH];
+        const uint32_t lo = job.addr;
+        const uint32_t hi = lo + (job.type == JOB_ERASE ? W25Qxx_SECTOR_SIZE : job.len);
+        const uint32_t from = lo > offset ? lo : offset;
+        const uint32_t to = hi < offset + len ? hi : offset + len;
+        for (uint32_t a = from; a < to; a++) {
+            if (job.type == JOB_ERASE) {
+                out[a - offset] = 0xFF;
+            } else {
+                out[a - offset] &= job.data[a - lo];
+            }
+        }
+    }
+}
+
+bool FlashWriter::acquireBus()
+{
+    if (holdingBus) return true;
+    // 会话期间别处进入映射的请求由驱动推迟到会话结束
+    if (QSPI_W25Qxx_BeginIndirect() != QSPI_W25Qxx_OK) return false;
+    holdingBus = true;
+    return true;
+}
+
+void FlashWriter::releaseBus()
+{
+    if (!holdingBus || inFlight || count > 0) return;
+    holdingBus = false;
+    QSPI_W25Qxx_EndIndirect();
+}
+
+bool FlashWriter::issueHead()
+{
+    Job& job = jobs[first];
+    int8_t result = W25Qxx_ERROR_MemoryMapped;
+    if (acquireBus()) {
+        if (job.type == JOB_ERASE) {
+            result = QSPI_W25Qxx_SectorErase_Start(job.addr);
+        } else {
+            result = QSPI_W25Qxx_WritePage_Start(job.data, job.addr, job.len);
+        }
+    }
+    inFlight = true;
+    if (result != QSPI_W25Qxx_OK) {
+        finishHead(false);
+        return false;
+    }
+    return true;
+}
+
+bool FlashWriter::waitInFlight()
+{
+    if (!inFlight) return true;
+    const bool ok = QSPI_W25Qxx_WaitReady() == QSPI_W25Qxx_OK;
+    finishHead(ok);
+    return ok;
+}
+
+void FlashWriter::finishHead(bool ok)
+{
+    const Job& job = jobs[first];
+    if (!ok) {
+        failed = true;
+        APP_ERR("FlashWriter: %s failed at 0x%08lx", job.type == JOB_ERASE ? "erase" : "program", (unsigned long)job.addr);
+    }
+    first = (uint8_t)((first + 1) % FLASH_WRITER_QUEUE_DEPTH);
+    count--;
+    inFlight = false;
+}
+
+bool FlashWriter::flush()
+{
+    while (count > 0) {
+        if (inFlight) {
+            waitInFlight();
+        } else {
+            issueHead();
+        }
+    }
+    releaseBus();
+    const bool ok = !failed;
+    failed = false;
+    return ok;
+}
+
+void FlashWriter::onSof()
+{
+    sofUs = MICROS_TIMER.micros();
+    frameDone = false;
+}
+
+bool FlashWriter::inSofSlice() const
+{
+    // 本帧回报发出后到下一帧采样完成前 CPU 没有急事，发命令的十几微秒放在这段里
+    if ((uint32_t)(MICROS_TIMER.micros() - sofUs) >= FLASH_WRITER_SOF_TIMEOUT_US) return true;
+    return frameDone;
+}
+
+void FlashWriter::poll()
+{
+    if (!background) {
+        if (isBusy()) flush();
+        return;
+    }
+
+    if (inFlight) {
+        bool ready = false;
+        if (QSPI_W25Qxx_PollReady(&ready) != QSPI_W25Qxx_OK) {
+            finishHead(false);
+        } else if (!ready) {
+            return;
+        } else {
+            finishHead(true);
+        }
+    }
+    if (count == 0) {
+        releaseBus();
+        return;
+    }
+    if (inSofSlice()) {
+        issueHead();
+    }
+}
@@ -3,124 +3,27 @@
 #include "drivermanager.hpp"
 #include "micro_timer.hpp"
 
-static void on_default_profile_changed_gamepad(void) {
-    Gamepad::getInstance().refreshDefaultProfile();
-}
-
 Gamepad::Gamepad()
 {
-	options = Storage::getInstance().getDefaultGamepadProfile();
-    mapDpadUp = nullptr;
-    mapDpadDown = nullptr;
-    mapDpadLeft = nullptr;
-    mapDpadRight = nullptr;
-    mapButtonB1 = nullptr;
-    mapButtonB2 = nullptr;
-    mapButtonB3 = nullptr;
-    mapButtonB4 = nullptr;
-    mapButtonL1 = nullptr;
-    mapButtonR1 = nullptr;
-    mapButtonL2 = nullptr;
-    mapButtonR2 = nullptr;
-    mapButtonS1 = nullptr;
-    mapButtonS2 = nullptr;
-    mapButtonL3 = nullptr;
-    mapButtonR3 = nullptr;
-    mapButtonA1 = nullptr;
-    mapButtonA2 = nullptr;
-    mapButtonFn = nullptr;
-
-    Storage::getInstance().registerDefaultProfileChangedCallback(on_default_profile_changed_gamepad);
+    runtime = &PROFILE_RUNTIME.current();
 }
 
 void Gamepad::setup()
 {
 	APP_DBG("Gamepad setup: start");
-    options = Storage::getInstance().getDefaultGamepadProfile();
-    memset(macroTriggerMask, 0, sizeof(macroTriggerMask));
-    memset(macroTriggerLatched, 0, sizeof(macroTriggerLatched));
-    macroPlaying = false;
-    macroFinishPending = false;
-    macroFinishPendingStartMs = 0;
-    macroPlayingIndex = 0;
-    macroPlayingStepIndex = 0;
-    macroStepStartMs = 0;
-    macroOutputMask = 0;
-    macroDynamicCommandMask = 0;
-    lastButtonCommandMask = 0;
-    prevPhysicalMacroMask = 0;
-
-    // 将 std::map 访问改为数组访问
-    mapDpadUp    = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_DPAD_UP], GAMEPAD_MASK_UP);
-    mapDpadDown  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_DPAD_DOWN], GAMEPAD_MASK_DOWN);
-    mapDpadLeft  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_DPAD_LEFT], GAMEPAD_MASK_LEFT);
-    mapDpadRight = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_DPAD_RIGHT], GAMEPAD_MASK_RIGHT);
-    mapButtonB1  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_B1], GAMEPAD_MASK_B1);
-    mapButtonB2  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_B2], GAMEPAD_MASK_B2);
-    mapButtonB3  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_B3], GAMEPAD_MASK_B3);
-    mapButtonB4  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_B4], GAMEPAD_MASK_B4);
-    mapButtonL1  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_L1], GAMEPAD_MASK_L1);
-    mapButtonR1  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_R1], GAMEPAD_MASK_R1);
-    mapButtonL2  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_L2], GAMEPAD_MASK_L2);
-    mapButtonR2  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_R2], GAMEPAD_MASK_R2);
-    mapButtonS1  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_S1], GAMEPAD_MASK_S1);
-    mapButtonS2  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_S2], GAMEPAD_MASK_S2);
-    mapButtonL3  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_L3], GAMEPAD_MASK_L3);
-    mapButtonR3  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_R3], GAMEPAD_MASK_R3);
-    mapButtonA1  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_A1], GAMEPAD_MASK_A1);
-    mapButtonA2  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_A2], GAMEPAD_MASK_A2);
-    mapButtonFn  = new GamepadButtonMapping(options->keysConfig.keyMapping[GameControllerButton::GAME_CONTROLLER_BUTTON_FN], AUX_MASK_FUNCTION);
-
-	APP_DBG("Gamepad setup: keyMapping init done");
-
-	for(int i = 0; i < MAX_KEY_COMBINATION; i++) {
-		KeyCombination& combo = options->keysConfig.keyCombinations[i];
-		if(combo.gameControllerButtonMask == 0 || combo.virtualPinMask == 0) {
-			continue;
-		}
-		
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_DPAD_UP))  mapDpadUp->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_DPAD_DOWN))  mapDpadDown->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_DPAD_LEFT))  mapDpadLeft->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_DPAD_RIGHT))  mapDpadRight->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_B1))  mapButtonB1->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_B2))  mapButtonB2->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_B3))  mapButtonB3->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_B4))  mapButtonB4->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_L1))  mapButtonL1->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_R1))  mapButtonR1->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_L2))  mapButtonL2->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_R2))  mapButtonR2->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_S1))  mapButtonS1->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_S2))  mapButtonS2->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_L3))  mapButtonL3->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_R3))  mapButtonR3->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_A1))  mapButtonA1->virtualPinMask |= combo.virtualPinMask;
-		if(combo.gameControllerButtonMask & (1U << GameControllerButton::GAME_CONTROLLER_BUTTON_A2))  mapButtonA2->virtualPinMask |= combo.virtualPinMask;
-	}
-	
-	APP_DBG("Gamepad setup: keyCombinations init done");
-
-    for (uint8_t i = 0; i < MAX_NUM_MACROS; i++) {
-        const MacroConfig& macro = options->keysConfig.macros[i];
-        uint32_t triggerMask = 0;
-        for (uint8_t t = 0; t < macro.numTriggerKeys && t < MAX_MACRO_TRIGGER_KEYS; t++) {
-            uint8_t key = macro.triggerKeys[t];
-            if (key < 32) triggerMask |= (1UL << key);
-        }
-        macroTriggerMask[i] = triggerMask;
-    }
-
+    // 映射、组合键和宏已经由 ProfileCompiler 编译进镜像
+    runtime = &PROFILE_RUNTIME.current();
+    clearState();
 }
 
 bool Gamepad::isMacroTriggerPressed(uint8_t macroIndex, Mask_t virtualPinMask) const {
-    uint32_t triggerMask = macroTriggerMask[macroIndex];
+    uint32_t triggerMask = runtime->macroTriggerMask[macroIndex];
     if (triggerMask == 0) return false;
     return (virtualPinMask & triggerMask) != 0;
 }
 
 void Gamepad::startMacroPlayback(uint8_t macroIndex, uint32_t nowMs) {
-    const MacroConfig& macro = options->keysConfig.macros[macroIndex];
+    const MacroConfig& macro = runtime->macros[macroIndex];
     if (macro.numSteps == 0) return;
 
     macroPlaying = true;
@@ -142,7 +45,7 @@ void Gamepad::startMacroPlayback(uint8_t macroIndex, uint32_t nowMs) {
 void Gamepad::updateMacroPlayback(uint32_t nowMs) {
     if (!macroPlaying) return;
 
-    const MacroConfig& macro = options->keysConfig.macros[macroPlayingIndex];
+    const MacroConfig& macro = runtime->macros[macroPlayingIndex];
     if (macro.numSteps == 0) {
         macroPlaying = false;
         macroFinishPending = false;
@@ -249,99 +152,65 @@ void Gamepad::process()
 	memcpy(&rawState, &state, sizeof(GamepadState));
 
 	// NOTE: Inverted X/Y-axis must run before SOCD and Dpad processing
-	if (options->keysConfig.invertXAxis) {
-		bool left = (state.dpad & mapDpadLeft->buttonMask) != 0;
-		bool right = (state.dpad & mapDpadRight->buttonMask) != 0;
-		state.dpad &= ~(mapDpadLeft->buttonMask | mapDpadRight->buttonMask);
+	if (runtime->invertXAxis) {
+		bool left = (state.dpad & GAMEPAD_MASK_LEFT) != 0;
+		bool right = (state.dpad & GAMEPAD_MASK_RIGHT) != 0;
+		state.dpad &= ~(GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
 		if (left)
-			state.dpad |= mapDpadRight->buttonMask;
+			state.dpad |= GAMEPAD_MASK_RIGHT;
 		if (right)
-			state.dpad |= mapDpadLeft->buttonMask;
+			state.dpad |= GAMEPAD_MASK_LEFT;
 	}
 
-	if (options->keysConfig.invertYAxis) {
-		bool up = (state.dpad & mapDpadUp->buttonMask) != 0;
-		bool down = (state.dpad & mapDpadDown->buttonMask) != 0;
-		state.dpad &= ~(mapDpadUp->buttonMask | mapDpadDown->buttonMask);
+	if (runtime->invertYAxis) {
+		bool up = (state.dpad & GAMEPAD_MASK_UP) != 0;
+		bool down = (state.dpad & GAMEPAD_MASK_DOWN) != 0;
+		state.dpad &= ~(GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
 		if (up)
-			state.dpad |= mapDpadDown->buttonMask;
+			state.dpad |= GAMEPAD_MASK_DOWN;
 		if (down)
-			state.dpad |= mapDpadUp->buttonMask;
+			state.dpad |= GAMEPAD_MASK_UP;
 	}
 
 	// 4-way before SOCD, might have better history without losing any coherent functionality
-	if (options->keysConfig.fourWayMode) {
+	if (runtime->fourWayMode) {
 		state.dpad = filterToFourWayMode(state.dpad);
 	}
 
-	state.dpad = runSOCDCleaner(resolveSOCDMode(*options), state.dpad);
+	state.dpad = runSOCDCleaner(runtime->socdMode, state.dpad);
 }
 
 void Gamepad::deinit()
 {
-    delete mapDpadUp;
-	delete mapDpadDown;
-	delete mapDpadLeft;
-	delete mapDpadRight;
-	delete mapButtonB1;
-	delete mapButtonB2;
-	delete mapButtonB3;
-	delete mapButtonB4;
-	delete mapButtonL1;
-	delete mapButtonR1;
-	delete mapButtonL2;
-	delete mapButtonR2;
-	delete mapButtonS1;
-	delete mapButtonS2;
-	delete mapButtonL3;
-	delete mapButtonR3;
-	delete mapButtonA1;
-	delete mapButtonA2;
-	delete mapButtonFn;
-	
 	this->clearState();
-    memset(macroTriggerMask, 0, sizeof(macroTriggerMask));
-    memset(macroTriggerLatched, 0, sizeof(macroTriggerLatched));
-    macroPlaying = false;
-    macroFinishPending = false;
-    macroFinishPendingStartMs = 0;
-    macroOutputMask = 0;
-    macroDynamicCommandMask = 0;
-    lastButtonCommandMask = 0;
-    prevPhysicalMacroMask = 0;
-
 }
 
 
 void Gamepad::read(Mask_t values)
 {
 	
-	state.aux = 0
-		| (values & mapButtonFn->virtualPinMask)   ? mapButtonFn->buttonMask : 0;
-
-	state.dpad = 0
-		| ((values & mapDpadUp->virtualPinMask)    ? mapDpadUp->buttonMask : 0)
-		| ((values & mapDpadDown->virtualPinMask)  ? mapDpadDown->buttonMask : 0)
-		| ((values & mapDpadLeft->virtualPinMask)  ? mapDpadLeft->buttonMask  : 0)
-		| ((values & mapDpadRight->virtualPinMask) ? mapDpadRight->buttonMask : 0)
-	;
+	// 配置文件在帧之间切换：换上新镜像，旧配置文件的宏不再继续
+	const ProfileRuntime* const latest = &PROFILE_RUNTIME.current();
+	if (latest != runtime) {
+		runtime = latest;
+		clearState();
+	}
 
-	state.buttons = 0
-		| ((values & mapButtonB1->virtualPinMask)  ? mapButtonB1->buttonMask  : 0)
-		| ((values & mapButtonB2->virtualPinMask)  ? mapButtonB2->buttonMask  : 0)
-		| ((values & mapButtonB3->virtualPinMask)  ? mapButtonB3->buttonMask  : 0)
-		| ((values & mapButtonB4->virtualPinMask)  ? mapButtonB4->buttonMask  : 0)
-		| ((values & mapButtonL1->virtualPinMask)  ? mapButtonL1->buttonMask  : 0)
-		| ((values & mapButtonR1->virtualPinMask)  ? mapButtonR1->buttonMask  : 0)
-		| ((values & mapButtonL2->virtualPinMask)  ? mapButtonL2->buttonMask  : 0)
-		| ((values & mapButtonR2->virtualPinMask)  ? mapButtonR2->buttonMask  : 0)
-		| ((values & mapButtonS1->virtualPinMask)  ? mapButtonS1->buttonMask  : 0)
-		| ((values & mapButtonS2->virtualPinMask)  ? mapButtonS2->buttonMask  : 0)
-		| ((values & mapButtonL3->virtualPinMask)  ? mapButtonL3->buttonMask  : 0)
-		| ((values & mapButtonR3->virtualPinMask)  ? mapButtonR3->buttonMask  : 0)
-		| ((values & mapButtonA1->virtualPinMask)  ? mapButtonA1->buttonMask  : 0)
-		| ((values & mapButtonA2->virtualPinMask)  ? mapButtonA2->buttonMask  : 0)
-	;
+	// 查找表按虚拟引脚索引，只遍历按下且有映射的引脚
+	uint8_t dpad = 0;
+	uint32_t buttons = 0;
+	uint16_t aux = 0;
+	Mask_t pins = values & runtime->mappedPinMask;
+	while (pins) {
+		const ProfileRuntimePin& pin = runtime->pins[__builtin_ctz(pins)];
+		pins &= pins - 1;
+		dpad |= pin.dpad;
+		buttons |= pin.buttons;
+		aux |= pin.aux;
+	}
+	state.dpad = dpad;
+	state.buttons = buttons;
+	state.aux = aux;
 
 	state.lx = GAMEPAD_JOYSTICK_MID;
 	state.ly = GAMEPAD_JOYSTICK_MID;
@@ -355,7 +224,7 @@ void Gamepad::read(Mask_t values)
 
     if (!macroPlaying) {
         for (uint8_t i = 0; i < MAX_NUM_MACROS; i++) {
-            const MacroConfig& macro = options->keysConfig.macros[i];
+            const MacroConfig& macro = runtime->macros[i];
             bool pressed = isMacroTriggerPressed(i, values);
             if (!pressed) {
                 macroTriggerLatched[i] = false;
@@ -398,12 +267,8 @@ void Gamepad::clearState()
 }
 
 void Gamepad::setSOCDMode(SOCDMode socdMode) {
-    options->keysConfig.socdMode = socdMode;
+    GamepadProfile* profile = STORAGE_MANAGER.getDefaultGamepadProfile();
+    if (!profile) return;
+    profile->keysConfig.socdMode = socdMode;
+    PROFILE_RUNTIME.request(*profile);
 }
-
-void Gamepad::refreshDefaultProfile() {
-    deinit();
-    setup();
-}
-
-
@@ -199,43 +199,43 @@ void HotkeysManager::runAction(GamepadHotkey hotkeyAction) {
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_WEBCONFIG:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_WEB_CONFIG);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_CALIBRATION:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_CALIBRATION);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             ADC_CALIBRATION_MANAGER.resetAllCalibration();
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_XINPUT:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
             STORAGE_MANAGER.setInputMode(InputMode::INPUT_MODE_XINPUT);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_PS4:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
             STORAGE_MANAGER.setInputMode(InputMode::INPUT_MODE_PS4);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_PS5:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
             STORAGE_MANAGER.setInputMode(InputMode::INPUT_MODE_PS5);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_XBOX:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
             STORAGE_MANAGER.setInputMode(InputMode::INPUT_MODE_XBOX);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_INPUT_MODE_SWITCH:
             STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
             STORAGE_MANAGER.setInputMode(InputMode::INPUT_MODE_SWITCH);
-            STORAGE_MANAGER.saveConfig();
+            STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
             rebootSystem();
             break;
         case GamepadHotkey::HOTKEY_SYSTEM_REBOOT:
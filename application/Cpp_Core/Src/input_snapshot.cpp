@@ -0,0 +1,72 @@
+#include "input_snapshot.hpp"
+#include <string.h>
+#include "adc_btns/adc_btns_worker.hpp"
+
+void InputSnapshot::publish(uint32_t virtualPinMask, uint8_t dpad) {
+    const uint32_t now = HAL_GetTick();
+
+    // 回报率：按固定窗口计数，窗口结束时按实际时长换算
+    if (windowCount == 0) {
+        windowStartMs = now;
+    }
+    windowCount++;
+    lastPublishMs = now;
+    const uint32_t elapsed = now - windowStartMs;
+    if (elapsed >= INPUT_SNAPSHOT_RATE_WINDOW_MS) {
+        reportRateHz = (uint32_t)((uint64_t)(windowCount - 1) * 1000u / elapsed);
+        windowStartMs = now;
+        windowCount = 1;
+    }
+
+    if (!leased) return;
+    if ((int32_t)(now - leaseUntilMs) >= 0) {
+        leased = false;
+        return;
+    }
+
+    // 写后台缓冲，写完再翻转前台索引
+    InputSnapshotFrame& f = frames[front ^ 1u];
+    f.virtualPinMask = virtualPinMask;
+    f.dpad = dpad;
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        InputSnapshotKey& k = f.keys[i];
+        k.value = 0;
+        k.pressThreshold = 0;
+        k.releaseThreshold = 0;
+        k.buttonIndex = 0xFF;
+        k.flags = (virtualPinMask & (1U << i)) ? INPUT_SNAPSHOT_KEY_PRESSED : 0;
+    }
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        const ADCBtn* btn = ADC_BTNS_WORKER.getButtonState(i);
+        if (btn == nullptr || btn->virtualPin >= NUM_ADC_BUTTONS) continue;
+        InputSnapshotKey& k = f.keys[btn->virtualPin];
+        k.value = btn->currentValue;
+        k.pressThreshold = btn->cachedPressThreshold;
+        k.releaseThreshold = btn->cachedReleaseThreshold;
+        k.buttonIndex = i;
+        k.flags = INPUT_SNAPSHOT_KEY_ANALOG | ((btn->state == ButtonState::PRESSED) ? INPUT_SNAPSHOT_KEY_PRESSED : 0);
+    }
+    f.seq = ++seq;
+    front ^= 1u;
+}
+
+bool InputSnapshot::read(InputSnapshotFrame* out, uint32_t nowMs) {
+    // 租约过期期间前台缓冲没有更新，续租后等下一次发布
+    const bool wasLeased = leased && (int32_t)(nowMs - leaseUntilMs) < 0;
+    leaseUntilMs = nowMs + INPUT_SNAPSHOT_LEASE_MS;
+    leased = true;
+    if (out == nullptr || !wasLeased || seq == 0) return false;
+
+    // 拷贝期间若发布了新帧（发布方移入中断后可能发生），前台已经换了一块，重新拷贝
+    for (uint8_t tries = 0; tries < 2; tries++) {
+        const uint8_t idx = front;
+        memcpy(out, &frames[idx], sizeof(*out));
+        if (idx == front) return true;
+    }
+    return true;
+}
+
+uint32_t InputSnapshot::getReportRateHz(uint32_t nowMs) const {
+    if (windowCount == 0 || nowMs - lastPublishMs >= INPUT_SNAPSHOT_RATE_WINDOW_MS) return 0;
+    return reportRateHz;
+}
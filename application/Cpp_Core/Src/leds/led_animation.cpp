@@ -16,9 +16,6 @@ static uint8_t starButtons1Count = 0;
 static uint8_t starButtons2Count = 0;
 static bool isFirstHalf = true;
 
-static Ripple ripples[5];
-static uint8_t rippleCount = 0;
-
 static uint8_t transformPassedPositions[NUM_LED + NUM_LED_AROUND] = {0}; // 0: 未经过, 1: 已经过
 static uint32_t transformCycleCount = 0;
 static float lastTransformProgress = 0.0f;
@@ -364,37 +361,10 @@ RGBColor rippleAnimation(const LedAnimationParams& params) {
         return color;
     }
     
+    // 涟漪强度由 LedRipplePool 每帧统一计算
     float t = 0.0f;
-    
-    // 处理涟漪效果
-    for (uint8_t i = 0; i < params.global.rippleCount && i < 5; i++) {
-        uint8_t centerIndex = params.global.rippleCenters[i];
-        float progress = params.global.rippleProgress[i];
-        
-        float centerX = MAIN_LED_POS_LIST[centerIndex].x;
-        float centerY = MAIN_LED_POS_LIST[centerIndex].y;
-        float btnX = MAIN_LED_POS_LIST[params.index].x;
-        float btnY = MAIN_LED_POS_LIST[params.index].y;
-        
-        // 计算最大距离
-        float maxDist = 0.0f;
-        for (uint8_t j = 0; j < NUM_LED; j++) {
-            float dx = MAIN_LED_POS_LIST[j].x - centerX;
-            float dy = MAIN_LED_POS_LIST[j].y - centerY;
-            float dist = sqrtf(dx * dx + dy * dy);
-            if (dist > maxDist) maxDist = dist;
-        }
-        
-        float rippleRadius = progress * maxDist * 1.1f;
-        float rippleWidth = 80.0f;
-        float dx = btnX - centerX;
-        float dy = btnY - centerY;
-        float dist = sqrtf(dx * dx + dy * dy);
-        
-        if (fabsf(rippleRadius - dist) < rippleWidth) {
-            float tt = cosf((fabsf(rippleRadius - dist) / rippleWidth) * M_PI / 2.0f);
-            t = fmaxf(t, tt);
-        }
+    if (params.global.rippleIntensity != nullptr) {
+        t = params.global.rippleIntensity[params.index] / 255.0f;
     }
     
     RGBColor result = lerpColor(params.backColor1, params.backColor2, t);
@@ -494,6 +464,8 @@ LedAnimationAlgorithm getLedAnimation(LEDEffect effect) {
             return rippleAnimation;
         case LEDEffect::TRANSFORM:
             return transformAnimation;
+        // 自定义效果由 LEDsManager 交给字节码虚拟机执行，程序不可用时按静态效果显示
+        case LEDEffect::CUSTOM:
         default:
             return staticAnimation;
     }
@@ -0,0 +1,158 @@
+#include "leds/led_compositor.hpp"
+
+// 8位乘法归一化：a * b / 255，结果四舍五入
+static inline uint8_t mul8(uint8_t a, uint8_t b) {
+    uint16_t t = (uint16_t)a * b + 128;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+static inline uint8_t blendChannel(uint8_t d, uint8_t s, LedBlendMode mode) {
+    switch (mode) {
+        case LED_BLEND_ADD: {
+            uint16_t v = (uint16_t)d + s;
+            return v > 255 ? 255 : (uint8_t)v;
+        }
+        case LED_BLEND_MULTIPLY:
+            return mul8(d, s);
+        case LED_BLEND_SCREEN:
+            return 255 - mul8(255 - d, 255 - s);
+        case LED_BLEND_LIGHTEN:
+            return d > s ? d : s;
+        case LED_BLEND_NORMAL:
+        default:
+            return s;
+    }
+}
+
+LedCompositor::LedCompositor()
+{
+    reset();
+}
+
+void LedCompositor::reset()
+{
+    for (uint8_t i = 0; i < NUM_LED_LAYERS; i++) {
+        layers[i].active = false;
+        layers[i].blendMode = LED_BLEND_NORMAL;
+        layers[i].opacity = 255;
+        layers[i].mask.clear();
+        layers[i].render = nullptr;
+        layers[i].userData = nullptr;
+        layers[i].expireTime = 0;
+    }
+    activeMask = 0;
+}
+
+void LedCompositor::configureLayer(LedLayerId id, LedLayerRenderer render, void* userData,
+                                   LedBlendMode blendMode, uint8_t opacity)
+{
+    if (id >= NUM_LED_LAYERS) return;
+    layers[id].render = render;
+    layers[id].userData = userData;
+    layers[id].blendMode = blendMode;
+    layers[id].opacity = opacity;
+}
+
+void LedCompositor::setLayerMask(LedLayerId id, const LedMask& mask)
+{
+    if (id >= NUM_LED_LAYERS) return;
+    layers[id].mask = mask;
+}
+
+void LedCompositor::setLayerOpacity(LedLayerId id, uint8_t opacity)
+{
+    if (id >= NUM_LED_LAYERS) return;
+    layers[id].opacity = opacity;
+}
+
+void LedCompositor::setLayerBlendMode(LedLayerId id, LedBlendMode blendMode)
+{
+    if (id >= NUM_LED_LAYERS) return;
+    layers[id].blendMode = blendMode;
+}
+
+void LedCompositor::setLayerActive(LedLayerId id, bool active, uint32_t durationMs)
+{
+    if (id >= NUM_LED_LAYERS) return;
+    // 没有渲染函数的图层无法激活
+    if (active && layers[id].render == nullptr) return;
+
+    layers[id].active = active;
+    if (active) {
+        // expireTime 为 0 表示常驻，因此到期时间恰好为 0 时顺延 1ms
+        uint32_t expire = (durationMs > 0) ? (HAL_GetTick() + durationMs) : 0;
+        layers[id].expireTime = (durationMs > 0 && expire == 0) ? 1 : expire;
+        activeMask |= (uint8_t)(1u << id);
+    } else {
+        layers[id].expireTime = 0;
+        activeMask &= (uint8_t)~(1u << id);
+    }
+}
+
+bool LedCompositor::isLayerActive(LedLayerId id) const
+{
+    if (id >= NUM_LED_LAYERS) return false;
+    return (activeMask >> id) & 1u;
+}
+
+uint8_t LedCompositor::getActiveLayerCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t m = activeMask; m; m &= (uint8_t)(m - 1)) count++;
+    return count;
+}
+
+RGBColor LedCompositor::blend(const RGBColor& dst, const RGBColor& src, LedBlendMode mode, uint8_t opacity)
+{
+    RGBColor mixed;
+    mixed.r = blendChannel(dst.r, src.r, mode);
+    mixed.g = blendChannel(dst.g, src.g, mode);
+    mixed.b = blendChannel(dst.b, src.b, mode);
+
+    if (opacity == 255) {
+        return mixed;
+    }
+
+    // 按不透明度在原色与混合结果之间插值
+    RGBColor result;
+    result.r = (uint8_t)(dst.r + (((int16_t)mixed.r - dst.r) * opacity) / 255);
+    result.g = (uint8_t)(dst.g + (((int16_t)mixed.g - dst.g) * opacity) / 255);
+    result.b = (uint8_t)(dst.b + (((int16_t)mixed.b - dst.b) * opacity) / 255);
+    return result;
+}
+
+void LedCompositor::compose(const LedLayerFrame& frame, RGBColor* buffer)
+{
+    if (activeMask == 0 || buffer == nullptr) {
+        return;
+    }
+
+    for (uint8_t id = 0; id < NUM_LED_LAYERS; id++) {
+        if (((activeMask >> id) & 1u) == 0) continue;
+
+        LedLayer& layer = layers[id];
+
+        // 到期的临时图层自动失活
+        if (layer.expireTime != 0 && (int32_t)(frame.now - layer.expireTime) >= 0) {
+            setLayerActive((LedLayerId)id, false);
+            continue;
+        }
+
+        if (layer.opacity == 0) continue;
+
+        for (uint8_t w = 0; w < LED_MASK_WORDS; w++) {
+            uint32_t bits = layer.mask.bits[w];
+            while (bits) {
+                uint8_t bit = (uint8_t)__builtin_ctz(bits);
+                bits &= bits - 1;
+                uint8_t index = (uint8_t)(w * 32 + bit);
+                if (index >= NUM_LED) break;
+
+                RGBColor src;
+                uint8_t coverage = layer.render(frame, index, src, layer.userData);
+                if (coverage == 0) continue;
+                buffer[index] = blend(buffer[index], src, layer.blendMode, mul8(coverage, layer.opacity));
+            }
+        }
+    }
+}
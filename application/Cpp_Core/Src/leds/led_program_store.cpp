@@ -0,0 +1,114 @@
+#include "leds/led_program_store.hpp"
+#include "system_logger.h"
+#include <cstdio>
+#include <cstring>
+
+#define LED_PROGRAM_ACTIVE_FILE         "led/active"
+
+// 程序读写缓冲，只在上传和切换效果时使用
+static uint8_t s_programBuffer[sizeof(LedVmProgramHeader) + LEDS_VM_MAX_CODE_SIZE];
+
+static void program_file_name(uint8_t slot, char* name)
+{
+    snprintf(name, FLASH_FS_NAME_LEN, "led/%u", (unsigned)slot);
+}
+
+static bool header_valid(const LedVmProgramHeader& header)
+{
+    return header.magic == LED_VM_MAGIC && header.version == LED_VM_VERSION
+        && header.codeSize > 0 && header.codeSize <= LEDS_VM_MAX_CODE_SIZE;
+}
+
+LedVmError LedProgramStore::save(uint8_t slot, const uint8_t* blob, size_t length)
+{
+    if (slot >= LED_PROGRAM_MAX_SLOTS || length > sizeof(s_programBuffer)) {
+        return LED_VM_ERR_SIZE;
+    }
+    LedVmError err = LedVm::verify(blob, length);
+    if (err != LED_VM_OK) {
+        return err;
+    }
+
+    char name[FLASH_FS_NAME_LEN];
+    program_file_name(slot, name);
+    if (!FLASH_FS.writeFile(name, blob, (uint32_t)length)) {
+        LOG_ERROR("LedProgram", "Failed to write program slot %d", slot);
+        return LED_VM_ERR_STORAGE;
+    }
+    return LED_VM_OK;
+}
+
+bool LedProgramStore::remove(uint8_t slot)
+{
+    if (slot >= LED_PROGRAM_MAX_SLOTS) {
+        return false;
+    }
+    char name[FLASH_FS_NAME_LEN];
+    program_file_name(slot, name);
+    if (FLASH_FS.stat(name, nullptr) && !FLASH_FS.remove(name)) {
+        return false;
+    }
+    if (getActiveSlot() == slot) {
+        select(LED_PROGRAM_NO_SLOT);
+    }
+    return true;
+}
+
+bool LedProgramStore::select(uint8_t slot)
+{
+    if (slot != LED_PROGRAM_NO_SLOT && slot >= LED_PROGRAM_MAX_SLOTS) {
+        return false;
+    }
+    if (getActiveSlot() == slot && FLASH_FS.stat(LED_PROGRAM_ACTIVE_FILE, nullptr)) {
+        return true;
+    }
+    return FLASH_FS.writeFile(LED_PROGRAM_ACTIVE_FILE, &slot, sizeof(slot));
+}
+
+uint8_t LedProgramStore::getActiveSlot()
+{
+    FlashFsFile file;
+    uint8_t slot = LED_PROGRAM_NO_SLOT;
+    if (!FLASH_FS.open(LED_PROGRAM_ACTIVE_FILE, file) || FLASH_FS.read(file, &slot, sizeof(slot)) != sizeof(slot)) {
+        return LED_PROGRAM_NO_SLOT;
+    }
+    return slot < LED_PROGRAM_MAX_SLOTS ? slot : LED_PROGRAM_NO_SLOT;
+}
+
+bool LedProgramStore::readHeader(uint8_t slot, LedVmProgramHeader& header)
+{
+    if (slot >= LED_PROGRAM_MAX_SLOTS) {
+        return false;
+    }
+    char name[FLASH_FS_NAME_LEN];
+    program_file_name(slot, name);
+    FlashFsFile file;
+    if (!FLASH_FS.open(name, file) || FLASH_FS.read(file, &header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    return header_valid(header);
+}
+
+LedVmError LedProgramStore::loadActive(LedVm& vm)
+{
+    uint8_t slot = getActiveSlot();
+    LedVmProgramHeader header;
+    if (slot == LED_PROGRAM_NO_SLOT || !readHeader(slot, header)) {
+        vm.unload();
+        return LED_VM_ERR_HEADER;
+    }
+
+    char name[FLASH_FS_NAME_LEN];
+    program_file_name(slot, name);
+    FlashFsFile file;
+    size_t length = sizeof(LedVmProgramHeader) + header.codeSize;
+    if (!FLASH_FS.open(name, file) || FLASH_FS.read(file, s_programBuffer, (uint32_t)length) != length) {
+        vm.unload();
+        return LED_VM_ERR_STORAGE;
+    }
+    LedVmError err = vm.load(s_programBuffer, length);
+    if (err != LED_VM_OK) {
+        LOG_ERROR("LedProgram", "Invalid program in slot %d, error: %d", slot, err);
+    }
+    return err;
+}
@@ -0,0 +1,132 @@
+#include "leds/led_ripple_pool.hpp"
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 按距离升序排列的 LED 索引及对应距离（定点数），每个按键一行
+static uint8_t s_sortedIndex[LED_RIPPLE_NUM_CENTERS][NUM_LED];
+static uint16_t s_sortedDist[LED_RIPPLE_NUM_CENTERS][NUM_LED];
+// 涟漪最终半径：最远 LED 距离的 1.1 倍
+static uint16_t s_maxRadius[LED_RIPPLE_NUM_CENTERS];
+// 环带衰减：cos(d / width * PI / 2)
+static uint8_t s_falloff[LED_RIPPLE_FALLOFF_STEPS];
+static bool s_tablesBuilt = false;
+
+static const uint32_t RIPPLE_WIDTH = (uint32_t)LEDS_RIPPLE_WIDTH << LED_RIPPLE_DIST_SHIFT;
+
+LedRipplePool::LedRipplePool()
+{
+    buildTables();
+    clear();
+    replacedCount = 0;
+}
+
+void LedRipplePool::buildTables()
+{
+    if (s_tablesBuilt) {
+        return;
+    }
+
+    for (uint8_t c = 0; c < LED_RIPPLE_NUM_CENTERS; c++) {
+        const Position& center = HITBOX_LED_POS_LIST[c];
+        uint16_t maxDist = 0;
+
+        // 插入排序，只在启动时执行一次
+        for (uint8_t i = 0; i < NUM_LED; i++) {
+            float dx = HITBOX_LED_POS_LIST[i].x - center.x;
+            float dy = HITBOX_LED_POS_LIST[i].y - center.y;
+            uint16_t dist = (uint16_t)(sqrtf(dx * dx + dy * dy) * (1 << LED_RIPPLE_DIST_SHIFT) + 0.5f);
+            if (dist > maxDist) maxDist = dist;
+
+            uint8_t k = i;
+            while (k > 0 && s_sortedDist[c][k - 1] > dist) {
+                s_sortedDist[c][k] = s_sortedDist[c][k - 1];
+                s_sortedIndex[c][k] = s_sortedIndex[c][k - 1];
+                k--;
+            }
+            s_sortedDist[c][k] = dist;
+            s_sortedIndex[c][k] = i;
+        }
+        s_maxRadius[c] = (uint16_t)((uint32_t)maxDist * 11 / 10);
+    }
+
+    for (uint8_t i = 0; i < LED_RIPPLE_FALLOFF_STEPS; i++) {
+        s_falloff[i] = (uint8_t)(cosf((float)i / LED_RIPPLE_FALLOFF_STEPS * M_PI / 2.0f) * 255.0f + 0.5f);
+    }
+
+    s_tablesBuilt = true;
+}
+
+void LedRipplePool::clear()
+{
+    count = 0;
+    memset(intensity, 0, sizeof(intensity));
+}
+
+void LedRipplePool::emit(uint8_t centerIndex, uint32_t now)
+{
+    if (centerIndex >= LED_RIPPLE_NUM_CENTERS) {
+        return;
+    }
+
+    // 池满时丢弃最老的涟漪，保证新的按键一定可见
+    if (count == LEDS_RIPPLE_POOL_SIZE) {
+        memmove(&emitters[0], &emitters[1], sizeof(Emitter) * (LEDS_RIPPLE_POOL_SIZE - 1));
+        count--;
+        replacedCount++;
+    }
+
+    emitters[count].startTime = now;
+    emitters[count].centerIndex = centerIndex;
+    count++;
+}
+
+void LedRipplePool::update(uint32_t now, uint32_t duration)
+{
+    memset(intensity, 0, sizeof(intensity));
+    if (duration == 0) {
+        count = 0;
+        return;
+    }
+
+    uint8_t newCount = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const Emitter& e = emitters[i];
+        const uint32_t elapsed = now - e.startTime;
+        if (elapsed >= duration) {
+            continue;
+        }
+        if (newCount != i) {
+            emitters[newCount] = e;
+        }
+        newCount++;
+
+        const uint8_t c = e.centerIndex;
+        const uint16_t* dist = s_sortedDist[c];
+        const uint8_t* index = s_sortedIndex[c];
+        const uint32_t radius = elapsed * s_maxRadius[c] / duration;
+        const uint32_t outer = radius + RIPPLE_WIDTH;
+
+        // 二分查找环带内第一个 LED（距离严格大于 radius - width）
+        uint8_t lo = 0;
+        uint8_t hi = (radius >= RIPPLE_WIDTH) ? NUM_LED : 0;
+        const uint32_t inner = (radius >= RIPPLE_WIDTH) ? radius - RIPPLE_WIDTH : 0;
+        while (lo < hi) {
+            uint8_t mid = (lo + hi) >> 1;
+            if (dist[mid] <= inner) lo = mid + 1;
+            else hi = mid;
+        }
+
+        for (uint8_t k = lo; k < NUM_LED && dist[k] < outer; k++) {
+            const uint32_t diff = dist[k] > radius ? dist[k] - radius : radius - dist[k];
+            const uint8_t level = s_falloff[diff * LED_RIPPLE_FALLOFF_STEPS / RIPPLE_WIDTH];
+            if (level > intensity[index[k]]) {
+                intensity[index[k]] = level;
+            }
+        }
+    }
+    count = newCount;
+}
@@ -0,0 +1,134 @@
+#include "leds/led_stream.hpp"
+#include <cstring>
+
+LedStream::LedStream()
+{
+    memset(buffers, 0, sizeof(buffers));
+    frontIndex = 0;
+    pending = false;
+    active = false;
+    needKeyframe = true;
+    brightnessChanged = false;
+    brightness = 100;
+    expectedSeq = 0;
+    lastFrameTime = 0;
+    receivedFrames = 0;
+    droppedFrames = 0;
+}
+
+void LedStream::begin(uint8_t brightness)
+{
+    memset(buffers, 0, sizeof(buffers));
+    frontIndex = 0;
+    pending = false;
+    active = true;
+    needKeyframe = true;
+    this->brightness = brightness > 100 ? 100 : brightness;
+    brightnessChanged = true;
+    lastFrameTime = HAL_GetTick();
+    receivedFrames = 0;
+    droppedFrames = 0;
+}
+
+void LedStream::end()
+{
+    active = false;
+    pending = false;
+    needKeyframe = true;
+}
+
+bool LedStream::isActive(uint32_t now)
+{
+    if (active && (now - lastFrameTime) > LEDS_STREAM_TIMEOUT_MS) {
+        end();
+    }
+    return active;
+}
+
+LedStreamResult LedStream::submitFrame(const uint8_t* payload, size_t length)
+{
+    if (payload == nullptr || length < sizeof(LedStreamFrameHeader) || length > LEDS_STREAM_MAX_PACKET_SIZE) {
+        return LED_STREAM_ERR_LENGTH;
+    }
+
+    const LedStreamFrameHeader* header = reinterpret_cast<const LedStreamFrameHeader*>(payload);
+    const bool keyframe = (header->flags & LED_STREAM_FLAG_KEYFRAME) != 0;
+    const uint32_t now = HAL_GetTick();
+
+    // 增量帧依赖上一帧，序号不连续时只能等待关键帧
+    if (!keyframe && (!active || needKeyframe || header->seq != expectedSeq)) {
+        droppedFrames++;
+        needKeyframe = true;
+        return LED_STREAM_ERR_NEED_KEYFRAME;
+    }
+
+    // 限制帧率，避免解码占用输入处理的时间。丢弃增量帧会破坏帧链，因此同时要求关键帧
+    if (active && receivedFrames > 0 && (now - lastFrameTime) < LEDS_STREAM_MIN_INTERVAL_MS) {
+        droppedFrames++;
+        if (!keyframe) needKeyframe = true;
+        return LED_STREAM_ERR_RATE;
+    }
+
+    // 先完整校验所有颜色段，非法的数据包不能写坏后台缓冲
+    const uint8_t* segments = payload + sizeof(LedStreamFrameHeader);
+    const size_t segmentsLength = length - sizeof(LedStreamFrameHeader);
+    size_t offset = 0;
+    for (uint8_t i = 0; i < header->segmentCount; i++) {
+        if (offset + 2 > segmentsLength) return LED_STREAM_ERR_LENGTH;
+        const uint8_t start = segments[offset];
+        const uint8_t count = segments[offset + 1];
+        if ((uint16_t)start + count > NUM_LED) return LED_STREAM_ERR_RANGE;
+        offset += 2 + (size_t)count * 3;
+        if (offset > segmentsLength) return LED_STREAM_ERR_LENGTH;
+    }
+
+    if (!active) {
+        begin(100);
+    }
+
+    RGBColor* back = buffers[frontIndex ^ 1];
+    if (keyframe) {
+        memset(back, 0, sizeof(buffers[0]));
+    } else if (!pending) {
+        // 上一帧已经显示，后台缓冲从前台缓冲继承
+        memcpy(back, buffers[frontIndex], sizeof(buffers[0]));
+    }
+
+    offset = 0;
+    for (uint8_t i = 0; i < header->segmentCount; i++) {
+        const uint8_t start = segments[offset];
+        const uint8_t count = segments[offset + 1];
+        const uint8_t* rgb = segments + offset + 2;
+        for (uint8_t j = 0; j < count; j++) {
+            back[start + j].r = rgb[j * 3];
+            back[start + j].g = rgb[j * 3 + 1];
+            back[start + j].b = rgb[j * 3 + 2];
+        }
+        offset += 2 + (size_t)count * 3;
+    }
+
+    if (header->brightness != LED_STREAM_BRIGHTNESS_KEEP) {
+        uint8_t b = header->brightness > 100 ? 100 : header->brightness;
+        if (b != brightness) {
+            brightness = b;
+            brightnessChanged = true;
+        }
+    }
+
+    pending = true;
+    needKeyframe = false;
+    expectedSeq = (uint16_t)(header->seq + 1);
+    lastFrameTime = now;
+    receivedFrames++;
+    return LED_STREAM_OK;
+}
+
+bool LedStream::swapBuffers()
+{
+    if (!pending) {
+        return false;
+    }
+    frontIndex ^= 1;
+    pending = false;
+    return true;
+}
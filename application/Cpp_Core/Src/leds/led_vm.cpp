@@ -0,0 +1,533 @@
+#include "leds/led_vm.hpp"
+#include <cstring>
+
+// 正弦表：128 + 127 * sin(2π * i / 256)
+static const uint8_t SIN8_TABLE[256] = {
+    128, 131, 134, 137, 140, 144, 147, 150, 153, 156, 159, 162, 165, 168, 171, 174,
+    177, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 239, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 239, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+    177, 174, 171, 168, 165, 162, 159, 156, 153, 150, 147, 144, 140, 137, 134, 131,
+    128, 125, 122, 119, 116, 112, 109, 106, 103, 100,  97,  94,  91,  88,  85,  82,
+     79,  77,  74,  71,  68,  65,  63,  60,  57,  55,  52,  50,  47,  45,  43,  40,
+     38,  36,  34,  32,  30,  28,  26,  24,  22,  21,  19,  17,  16,  15,  13,  12,
+     11,  10,   8,   7,   6,   6,   5,   4,   3,   3,   2,   2,   2,   1,   1,   1,
+      1,   1,   1,   1,   2,   2,   2,   3,   3,   4,   5,   6,   6,   7,   8,  10,
+     11,  12,  13,  15,  16,  17,  19,  21,  22,  24,  26,  28,  30,  32,  34,  36,
+     38,  40,  43,  45,  47,  50,  52,  55,  57,  60,  63,  65,  68,  71,  74,  77,
+     79,  82,  85,  88,  91,  94,  97, 100, 103, 106, 109, 112, 116, 119, 122, 125,
+};
+
+// 指令类型
+enum LedOpKind : uint8_t
+{
+    OP_KIND_INVALID = 0,
+    OP_KIND_NORMAL,
+    OP_KIND_JUMP,           // 无条件跳转
+    OP_KIND_BRANCH,         // 条件跳转
+    OP_KIND_TERMINAL,       // 结束执行
+};
+
+struct LedOpSpec {
+    uint8_t kind;
+    uint8_t immSize;
+    uint8_t pops;
+    uint8_t pushes;
+};
+
+static LedOpSpec getOpSpec(uint8_t op) {
+    switch (op) {
+        case LED_OP_END:    return { OP_KIND_TERMINAL, 0, 0, 0 };
+        case LED_OP_PUSH8:  return { OP_KIND_NORMAL, 1, 0, 1 };
+        case LED_OP_PUSH16: return { OP_KIND_NORMAL, 2, 0, 1 };
+        case LED_OP_PUSH32: return { OP_KIND_NORMAL, 4, 0, 1 };
+        case LED_OP_IN:     return { OP_KIND_NORMAL, 1, 0, 1 };
+        case LED_OP_LOAD:   return { OP_KIND_NORMAL, 1, 0, 1 };
+        case LED_OP_STORE:  return { OP_KIND_NORMAL, 1, 1, 0 };
+        case LED_OP_DUP:    return { OP_KIND_NORMAL, 0, 1, 2 };
+        case LED_OP_DROP:   return { OP_KIND_NORMAL, 0, 1, 0 };
+        case LED_OP_SWAP:   return { OP_KIND_NORMAL, 0, 2, 2 };
+        case LED_OP_OVER:   return { OP_KIND_NORMAL, 0, 2, 3 };
+        case LED_OP_ADD:
+        case LED_OP_SUB:
+        case LED_OP_MUL:
+        case LED_OP_DIV:
+        case LED_OP_MOD:
+        case LED_OP_MIN:
+        case LED_OP_MAX:
+        case LED_OP_AND:
+        case LED_OP_OR:
+        case LED_OP_XOR:
+        case LED_OP_SHL:
+        case LED_OP_SHR:
+        case LED_OP_LT:
+        case LED_OP_LE:
+        case LED_OP_EQ:
+        case LED_OP_SCALE8:
+        case LED_OP_DIST8:  return { OP_KIND_NORMAL, 0, 2, 1 };
+        case LED_OP_NEG:
+        case LED_OP_ABS:
+        case LED_OP_NOT:
+        case LED_OP_SIN8:
+        case LED_OP_TRI8:
+        case LED_OP_CLAMP8: return { OP_KIND_NORMAL, 0, 1, 1 };
+        case LED_OP_JMP:    return { OP_KIND_JUMP, 2, 0, 0 };
+        case LED_OP_JZ:     return { OP_KIND_BRANCH, 2, 1, 0 };
+        case LED_OP_LERP8:  return { OP_KIND_NORMAL, 0, 3, 1 };
+        case LED_OP_HSV:    return { OP_KIND_NORMAL, 0, 3, 3 };
+        case LED_OP_RAND8:  return { OP_KIND_NORMAL, 0, 0, 1 };
+        case LED_OP_COLOR:  return { OP_KIND_NORMAL, 1, 0, 3 };
+        case LED_OP_OUT:    return { OP_KIND_TERMINAL, 0, 3, 0 };
+        default:            return { OP_KIND_INVALID, 0, 0, 0 };
+    }
+}
+
+static inline int16_t readI16(const uint8_t* p) {
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+static inline int32_t readI32(const uint8_t* p) {
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static inline int32_t clamp8(int32_t v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// 整数 HSV 转 RGB，h/s/v 均为 0-255
+static void hsvToRgb(int32_t h, int32_t s, int32_t v, int32_t* rgb) {
+    h &= 255;
+    s = clamp8(s);
+    v = clamp8(v);
+    if (s == 0) {
+        rgb[0] = rgb[1] = rgb[2] = v;
+        return;
+    }
+    int32_t region = h / 43;
+    int32_t rem = (h - region * 43) * 6;
+    int32_t p = (v * (255 - s)) >> 8;
+    int32_t q = (v * (255 - ((s * rem) >> 8))) >> 8;
+    int32_t t = (v * (255 - ((s * (255 - rem)) >> 8))) >> 8;
+    switch (region) {
+        case 0:  rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+        case 1:  rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+        case 2:  rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+        case 3:  rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+        case 4:  rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+        default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+    }
+}
+
+LedVm::LedVm()
+{
+    unload();
+
+    // 预先把浮点坐标归一化为 0-255 的整数坐标
+    float minX = HITBOX_LED_POS_LIST[0].x, maxX = minX;
+    float minY = HITBOX_LED_POS_LIST[0].y, maxY = minY;
+    for (uint8_t i = 1; i < NUM_LED; i++) {
+        if (HITBOX_LED_POS_LIST[i].x < minX) minX = HITBOX_LED_POS_LIST[i].x;
+        if (HITBOX_LED_POS_LIST[i].x > maxX) maxX = HITBOX_LED_POS_LIST[i].x;
+        if (HITBOX_LED_POS_LIST[i].y < minY) minY = HITBOX_LED_POS_LIST[i].y;
+        if (HITBOX_LED_POS_LIST[i].y > maxY) maxY = HITBOX_LED_POS_LIST[i].y;
+    }
+    float rangeX = (maxX - minX) > 0.0f ? (maxX - minX) : 1.0f;
+    float rangeY = (maxY - minY) > 0.0f ? (maxY - minY) : 1.0f;
+    for (uint8_t i = 0; i < NUM_LED; i++) {
+        posX[i] = (uint8_t)((HITBOX_LED_POS_LIST[i].x - minX) * 255.0f / rangeX + 0.5f);
+        posY[i] = (uint8_t)((HITBOX_LED_POS_LIST[i].y - minY) * 255.0f / rangeY + 0.5f);
+    }
+
+    memset(&frameInputs, 0, sizeof(frameInputs));
+    frameSteps = 0;
+    memset(inputValues, 0, sizeof(inputValues));
+    randState = 1;
+}
+
+uint32_t LedVm::checksum(const uint8_t* data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+LedVmError LedVm::verify(const uint8_t* blob, size_t length)
+{
+    if (blob == nullptr || length < sizeof(LedVmProgramHeader)) {
+        return LED_VM_ERR_SIZE;
+    }
+    LedVmProgramHeader header;
+    memcpy(&header, blob, sizeof(header));
+    if (header.magic != LED_VM_MAGIC || header.version != LED_VM_VERSION) {
+        return LED_VM_ERR_HEADER;
+    }
+    if (header.codeSize == 0 || header.codeSize > LEDS_VM_MAX_CODE_SIZE
+        || length < sizeof(LedVmProgramHeader) + header.codeSize) {
+        return LED_VM_ERR_SIZE;
+    }
+    const uint8_t* code = blob + sizeof(LedVmProgramHeader);
+    const uint16_t size = header.codeSize;
+    if (checksum(code, size) != header.checksum) {
+        return LED_VM_ERR_CHECKSUM;
+    }
+
+    // 校验只在上传和加载时执行，使用静态缓冲避免占用栈空间
+    // depth[ip]：-2 表示不是指令起点，-1 表示尚未到达，其他为进入该指令时的栈深度
+    static int8_t depth[LEDS_VM_MAX_CODE_SIZE];
+    static uint16_t worklist[LEDS_VM_MAX_CODE_SIZE];
+
+    // 第一遍：线性解码，检查操作码和操作数
+    for (uint16_t i = 0; i < size; i++) depth[i] = -2;
+    for (uint16_t ip = 0; ip < size; ) {
+        const uint8_t op = code[ip];
+        const LedOpSpec spec = getOpSpec(op);
+        if (spec.kind == OP_KIND_INVALID) return LED_VM_ERR_OPCODE;
+        if ((uint32_t)ip + 1 + spec.immSize > size) return LED_VM_ERR_OPCODE;
+        if (op == LED_OP_IN && code[ip + 1] >= NUM_LED_VM_INPUTS) return LED_VM_ERR_OPCODE;
+        if ((op == LED_OP_LOAD || op == LED_OP_STORE) && code[ip + 1] >= LED_VM_NUM_REGS) return LED_VM_ERR_OPCODE;
+        if (op == LED_OP_COLOR && code[ip + 1] >= 3) return LED_VM_ERR_OPCODE;
+        depth[ip] = -1;
+        ip += 1 + spec.immSize;
+    }
+
+    // 第二遍：沿所有执行路径传播栈深度
+    uint16_t pending = 0;
+    depth[0] = 0;
+    worklist[pending++] = 0;
+    while (pending > 0) {
+        const uint16_t ip = worklist[--pending];
+        const uint8_t op = code[ip];
+        const LedOpSpec spec = getOpSpec(op);
+        const int32_t d = depth[ip];
+
+        if (d < spec.pops) return LED_VM_ERR_STACK;
+        const int32_t next = d - spec.pops + spec.pushes;
+        if (next > LED_VM_STACK_SIZE) return LED_VM_ERR_STACK;
+        if (spec.kind == OP_KIND_TERMINAL) continue;
+
+        // 后继指令：顺序执行和跳转目标
+        int32_t successors[2];
+        uint8_t numSuccessors = 0;
+        const int32_t fallthrough = ip + 1 + spec.immSize;
+        if (spec.kind == OP_KIND_JUMP || spec.kind == OP_KIND_BRANCH) {
+            successors[numSuccessors++] = fallthrough + readI16(&code[ip + 1]);
+        }
+        if (spec.kind != OP_KIND_JUMP) {
+            if (fallthrough >= size) return LED_VM_ERR_FALLTHROUGH;
+            successors[numSuccessors++] = fallthrough;
+        }
+
+        for (uint8_t s = 0; s < numSuccessors; s++) {
+            const int32_t target = successors[s];
+            if (target < 0 || target >= size || depth[target] == -2) return LED_VM_ERR_JUMP;
+            if (depth[target] == -1) {
+                depth[target] = (int8_t)next;
+                worklist[pending++] = (uint16_t)target;
+            } else if (depth[target] != next) {
+                return LED_VM_ERR_STACK;
+            }
+        }
+    }
+
+    return LED_VM_OK;
+}
+
+LedVmError LedVm::load(const uint8_t* blob, size_t length)
+{
+    LedVmError err = verify(blob, length);
+    if (err != LED_VM_OK) {
+        unload();
+        return err;
+    }
+
+    LedVmProgramHeader header;
+    memcpy(&header, blob, sizeof(header));
+    const uint8_t* code = blob + sizeof(LedVmProgramHeader);
+    const uint16_t size = header.codeSize;
+
+    // 译码：先给每个指令起点编号，再解码操作数并把跳转偏移换成指令下标
+    static uint16_t insnIndex[LEDS_VM_MAX_CODE_SIZE];
+    uint16_t n = 0;
+    for (uint16_t ip = 0; ip < size; ip += 1 + getOpSpec(code[ip]).immSize) {
+        insnIndex[ip] = n++;
+    }
+    n = 0;
+    for (uint16_t ip = 0; ip < size; ) {
+        const uint8_t op = code[ip];
+        const uint8_t* imm = &code[ip + 1];
+        const uint16_t next = (uint16_t)(ip + 1 + getOpSpec(op).immSize);
+        Insn& insn = insns[n++];
+        insn.op = op;
+        insn.arg = 0;
+        insn.imm = 0;
+        switch (op) {
+            case LED_OP_PUSH8:  insn.imm = imm[0]; break;
+            case LED_OP_PUSH16: insn.imm = readI16(imm); break;
+            case LED_OP_PUSH32: insn.imm = readI32(imm); break;
+            case LED_OP_IN:
+            case LED_OP_LOAD:
+            case LED_OP_STORE:
+            case LED_OP_COLOR:  insn.arg = imm[0]; break;
+            case LED_OP_JMP:
+            case LED_OP_JZ:     insn.imm = insnIndex[next + readI16(imm)]; break;
+            default: break;
+        }
+        ip = next;
+    }
+    numInsns = n;
+
+    // 倒序计算直线段长度；校验已保证最后一条是跳转或结束指令
+    for (int32_t i = (int32_t)n - 1; i >= 0; i--) {
+        const bool endsRun = getOpSpec(insns[i].op).kind != OP_KIND_NORMAL || i == (int32_t)n - 1;
+        insns[i].runLength = endsRun ? 1 : (uint16_t)(insns[i + 1].runLength + 1);
+    }
+
+    stepBudget = (header.stepBudget == 0 || header.stepBudget > LEDS_VM_MAX_STEPS_PER_LED)
+        ? LEDS_VM_MAX_STEPS_PER_LED : header.stepBudget;
+    memcpy(name, header.name, sizeof(header.name));
+    name[sizeof(header.name)] = '\0';
+    loaded = true;
+    faulted = false;
+    frameOverrun = false;
+    overrunScore = 0;
+    return LED_VM_OK;
+}
+
+void LedVm::unload()
+{
+    numInsns = 0;
+    stepBudget = 0;
+    name[0] = '\0';
+    loaded = false;
+    faulted = false;
+    frameOverrun = false;
+    overrunScore = 0;
+}
+
+void LedVm::beginFrame(const LedVmFrameInputs& inputs)
+{
+    frameInputs = inputs;
+    frameSteps = 0;
+    frameOverrun = false;
+    uint32_t numPressed = 0;
+    for (uint32_t m = inputs.virtualPinMask; m; m &= m - 1) numPressed++;
+    randState = (inputs.frame * 2654435761u) | 1u;
+
+    inputValues[LED_IN_TIME] = (int32_t)(inputs.time & 0x7FFFFFFF);
+    inputValues[LED_IN_SPEED] = inputs.speed;
+    inputValues[LED_IN_FRAME] = (int32_t)(inputs.frame & 0x7FFFFFFF);
+    inputValues[LED_IN_NUM_PRESSED] = (int32_t)numPressed;
+    inputValues[LED_IN_NUM_LED] = NUM_LED;
+}
+
+bool LedVm::endFrame()
+{
+    if (!loaded || faulted) {
+        return false;
+    }
+    if (!frameOverrun) {
+        if (overrunScore > 0) overrunScore--;
+        return true;
+    }
+    // 偶尔一帧超预算只保持上一帧，持续超预算才判定程序失效
+    if (++overrunScore >= LEDS_VM_MAX_OVERRUN_FRAMES) {
+        faulted = true;
+    }
+    return false;
+}
+
+bool LedVm::run(uint8_t index, RGBColor& out)
+{
+    out.r = out.g = out.b = 0;
+    if (!loaded || faulted || frameOverrun || index >= NUM_LED) {
+        return false;
+    }
+
+    // 预算取单 LED 上限与本帧剩余预算中较小者
+    uint32_t budget = stepBudget;
+    const uint32_t frameRemaining = frameSteps < LEDS_VM_FRAME_BUDGET ? LEDS_VM_FRAME_BUDGET - frameSteps : 0;
+    if (budget > frameRemaining) budget = frameRemaining;
+
+    // 栈深度已在加载时校验，运行时无需检查
+    int32_t stack[LED_VM_STACK_SIZE];
+    int32_t regs[LED_VM_NUM_REGS] = {0};
+    int32_t* sp = stack;
+    const Insn* pc = insns;
+
+    // 逐 LED 的输入，其余输入在 beginFrame() 中填好
+    const bool isButton = index < (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+    const bool pressed = isButton && ((frameInputs.virtualPinMask >> index) & 1u);
+    inputValues[LED_IN_INDEX] = index;
+    inputValues[LED_IN_X] = posX[index];
+    inputValues[LED_IN_Y] = posY[index];
+    inputValues[LED_IN_PRESSED] = pressed ? 1 : 0;
+    inputValues[LED_IN_TRAVEL] = (isButton && frameInputs.travel) ? frameInputs.travel[index] : (pressed ? 255 : 0);
+    inputValues[LED_IN_IS_AROUND] = isButton ? 0 : 1;
+
+    // 进入一段直线代码时按整段扣预算，段内不再检查
+    uint32_t steps = pc->runLength;
+    auto overrun = [&]() {
+        frameOverrun = true;
+        frameSteps += steps;
+        return false;
+    };
+    if (steps > budget) return overrun();
+
+    // 分派表按操作码编号排列，每条指令末尾各自跳转，分支预测比单一 switch 跳转准确；
+    // 未知操作码在校验阶段已排除
+    static const void* const DISPATCH[64] = {
+        &&op_end,   &&op_push,  &&op_push,  &&op_push,  &&op_in,    &&op_load,  &&op_store, &&op_dup,       // 0x00
+        &&op_drop,  &&op_swap,  &&op_over,  &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,       // 0x08
+        &&op_add,   &&op_sub,   &&op_mul,   &&op_div,   &&op_mod,   &&op_neg,   &&op_abs,   &&op_min,       // 0x10
+        &&op_max,   &&op_and,   &&op_or,    &&op_xor,   &&op_shl,   &&op_shr,   &&op_not,   &&op_bad,       // 0x18
+        &&op_lt,    &&op_le,    &&op_eq,    &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,       // 0x20
+        &&op_jmp,   &&op_jz,    &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,       // 0x28
+        &&op_sin8,  &&op_tri8,  &&op_scale8, &&op_lerp8, &&op_clamp8, &&op_hsv, &&op_rand8, &&op_dist8,     // 0x30
+        &&op_color, &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_bad,   &&op_out,       // 0x38
+    };
+    const Insn* insn;
+#define LED_VM_NEXT()   do { insn = pc++; goto *DISPATCH[insn->op & 63]; } while (0)
+
+    LED_VM_NEXT();
+
+op_end:
+    frameSteps += steps;
+    return true;
+op_push:
+    *sp++ = insn->imm;
+    LED_VM_NEXT();
+op_in:
+    *sp++ = inputValues[insn->arg];
+    LED_VM_NEXT();
+op_load:
+    *sp++ = regs[insn->arg];
+    LED_VM_NEXT();
+op_store:
+    regs[insn->arg] = *--sp;
+    LED_VM_NEXT();
+op_dup:
+    sp[0] = sp[-1];
+    sp++;
+    LED_VM_NEXT();
+op_drop:
+    sp--;
+    LED_VM_NEXT();
+op_swap: {
+    int32_t t = sp[-1];
+    sp[-1] = sp[-2];
+    sp[-2] = t;
+    LED_VM_NEXT();
+}
+op_over:
+    sp[0] = sp[-2];
+    sp++;
+    LED_VM_NEXT();
+
+op_add: sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] + (uint32_t)sp[0]); LED_VM_NEXT();
+op_sub: sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] - (uint32_t)sp[0]); LED_VM_NEXT();
+op_mul: sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] * (uint32_t)sp[0]); LED_VM_NEXT();
+op_div:
+    sp--;
+    // INT32_MIN / -1 会触发硬件异常，按 0 处理
+    sp[-1] = (sp[0] == 0 || (sp[0] == -1 && sp[-1] == INT32_MIN)) ? 0 : sp[-1] / sp[0];
+    LED_VM_NEXT();
+op_mod:
+    sp--;
+    sp[-1] = (sp[0] == 0 || sp[0] == -1) ? 0 : sp[-1] % sp[0];
+    LED_VM_NEXT();
+op_neg: sp[-1] = (int32_t)(0u - (uint32_t)sp[-1]); LED_VM_NEXT();
+op_abs: if (sp[-1] < 0) sp[-1] = (int32_t)(0u - (uint32_t)sp[-1]); LED_VM_NEXT();
+op_min: sp--; if (sp[0] < sp[-1]) sp[-1] = sp[0]; LED_VM_NEXT();
+op_max: sp--; if (sp[0] > sp[-1]) sp[-1] = sp[0]; LED_VM_NEXT();
+op_and: sp--; sp[-1] &= sp[0]; LED_VM_NEXT();
+op_or:  sp--; sp[-1] |= sp[0]; LED_VM_NEXT();
+op_xor: sp--; sp[-1] ^= sp[0]; LED_VM_NEXT();
+op_shl: sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] << (sp[0] & 31)); LED_VM_NEXT();
+op_shr: sp--; sp[-1] >>= (sp[0] & 31); LED_VM_NEXT();
+op_not: sp[-1] = (sp[-1] == 0) ? 1 : 0; LED_VM_NEXT();
+
+op_lt: sp--; sp[-1] = (sp[-1] < sp[0]) ? 1 : 0; LED_VM_NEXT();
+op_le: sp--; sp[-1] = (sp[-1] <= sp[0]) ? 1 : 0; LED_VM_NEXT();
+op_eq: sp--; sp[-1] = (sp[-1] == sp[0]) ? 1 : 0; LED_VM_NEXT();
+
+op_jmp:
+    pc = insns + insn->imm;
+    steps += pc->runLength;
+    if (steps > budget) return overrun();
+    LED_VM_NEXT();
+op_jz:
+    if (*--sp == 0) pc = insns + insn->imm;
+    steps += pc->runLength;
+    if (steps > budget) return overrun();
+    LED_VM_NEXT();
+
+op_sin8:
+    sp[-1] = SIN8_TABLE[sp[-1] & 255];
+    LED_VM_NEXT();
+op_tri8: {
+    int32_t x = sp[-1] & 255;
+    sp[-1] = x < 128 ? (x << 1) : ((255 - x) << 1) + 1;
+    LED_VM_NEXT();
+}
+op_scale8:
+    sp--;
+    sp[-1] = (clamp8(sp[-1]) * clamp8(sp[0])) >> 8;
+    LED_VM_NEXT();
+op_lerp8: {
+    sp -= 2;
+    int64_t a = sp[-1];
+    int64_t b = sp[0];
+    int64_t t = clamp8(sp[1]);
+    sp[-1] = (int32_t)(a + (((b - a) * t) >> 8));
+    LED_VM_NEXT();
+}
+op_clamp8:
+    sp[-1] = clamp8(sp[-1]);
+    LED_VM_NEXT();
+op_hsv:
+    hsvToRgb(sp[-3], sp[-2], sp[-1], &sp[-3]);
+    LED_VM_NEXT();
+op_rand8:
+    randState ^= randState << 13;
+    randState ^= randState >> 17;
+    randState ^= randState << 5;
+    *sp++ = (int32_t)(randState & 255);
+    LED_VM_NEXT();
+op_dist8: {
+    // 八边形近似：max + min * 3 / 8
+    sp--;
+    int32_t dx = sp[-1] < -1024 ? -1024 : (sp[-1] > 1024 ? 1024 : sp[-1]);
+    int32_t dy = sp[0] < -1024 ? -1024 : (sp[0] > 1024 ? 1024 : sp[0]);
+    if (dx < 0) dx = -dx;
+    if (dy < 0) dy = -dy;
+    int32_t hi = dx > dy ? dx : dy;
+    int32_t lo = dx > dy ? dy : dx;
+    sp[-1] = clamp8(hi + ((lo * 3) >> 3));
+    LED_VM_NEXT();
+}
+op_color: {
+    const RGBColor& c = frameInputs.colors[insn->arg];
+    sp[0] = c.r;
+    sp[1] = c.g;
+    sp[2] = c.b;
+    sp += 3;
+    LED_VM_NEXT();
+}
+op_out:
+    out.r = (uint8_t)clamp8(sp[-3]);
+    out.g = (uint8_t)clamp8(sp[-2]);
+    out.b = (uint8_t)clamp8(sp[-1]);
+    frameSteps += steps;
+    return true;
+op_bad:
+    faulted = true;
+    frameSteps += steps;
+    return false;
+#undef LED_VM_NEXT
+}
@@ -1,5 +1,7 @@
 #include "leds/leds_manager.hpp"
+#include "leds/led_program_store.hpp"
 #include <algorithm>
+#include <cstring>
 #include "board_cfg.h"
 
 #ifndef M_PI
@@ -33,12 +35,6 @@ LEDsManager::LEDsManager()
     usingTemporaryConfig = false;
     animationStartTime = 0;
     lastButtonState = 0;
-    rippleCount = 0;
-    for (int i = 0; i < 5; i++) {
-        ripples[i].centerIndex = 0;
-        ripples[i].startTime = 0;
-    }
-    
     aroundLedAnimationStartTime = 0;
     aroundLedRippleCount = 0;
     for (int i = 0; i < 5; i++) {
@@ -50,6 +46,22 @@ LEDsManager::LEDsManager()
     lastQuakeTriggerTime = 0;
     lastButtonPressTime = 0;
 
+    // 初始化图层合成
+    memset(frameBuffer, 0, sizeof(frameBuffer));
+    memset(releaseTimes, 0, sizeof(releaseTimes));
+    notification = LED_NOTIFY_NONE;
+    notificationStartTime = 0;
+    memcpy(notifiedProfileId, STORAGE_MANAGER.getDefaultGamepadProfile()->id, sizeof(notifiedProfileId));
+    hotkeyPinMask = 0;
+    setupLayers();
+    streaming = false;
+
+    // 初始化自定义灯效
+    ledVmFrame = 0;
+    memset(keyTravel, 0, sizeof(keyTravel));
+    memset(customFrame, 0, sizeof(customFrame));
+    travelProvider = nullptr;
+
     STORAGE_MANAGER.registerDefaultProfileChangedCallback(on_default_profile_changed_leds);
 };
 
@@ -72,6 +84,12 @@ void LEDsManager::setup()
         // 初始化动画
         animationStartTime = HAL_GetTick();
 
+        // 自定义效果从QSPI加载当前程序
+        if (opts->ledEffect == LEDEffect::CUSTOM) {
+            LED_PROGRAM_STORE.loadActive(ledVm);
+            ledVmFrame = 0;
+        }
+
         // 对于静态效果，直接设置颜色
         if (opts->ledEffect == LEDEffect::STATIC) {
             WS2812B_SetAllLEDColor(backgroundColor1.r, backgroundColor1.g, backgroundColor1.b);
@@ -120,6 +138,12 @@ void LEDsManager::refreshDefaultProfile()
 
     deinit();
     setup();
+
+    const char* profileId = STORAGE_MANAGER.getDefaultGamepadProfile()->id;
+    if (strncmp(notifiedProfileId, profileId, sizeof(notifiedProfileId)) != 0) {
+        memcpy(notifiedProfileId, profileId, sizeof(notifiedProfileId));
+        notify(LED_NOTIFY_PROFILE_SWITCHED);
+    }
 }
 
 /**
@@ -128,7 +152,16 @@ void LEDsManager::refreshDefaultProfile()
  */
 void LEDsManager::loop(uint32_t virtualPinMask)
 {
-    if(!opts->ledEnabled) {
+    // 灯光流由上位机主动开启，不受本地 LED 开关限制
+    if (LED_STREAM.isActive(HAL_GetTick()) != streaming) {
+        if (streaming) {
+            exitStream();
+        } else {
+            enterStream();
+        }
+    }
+
+    if(!streaming && !opts->ledEnabled) {
         return;
     }
 
@@ -138,6 +171,11 @@ void LEDsManager::loop(uint32_t virtualPinMask)
     }
     lastLoopTime = HAL_GetTick();
 
+    if (streaming) {
+        processStreamFrame(virtualPinMask);
+        return;
+    }
+
     // 处理按钮按下事件（用于涟漪效果）
     processButtonPress(virtualPinMask);
 
@@ -162,18 +200,13 @@ void LEDsManager::loop(uint32_t virtualPinMask)
     params.progress = progress;
     
     // 设置涟漪参数
-    params.global.rippleCount = rippleCount;
+    params.global.rippleIntensity = ripplePool.getIntensities();
     uint32_t now = HAL_GetTick();
-    for (uint8_t i = 0; i < rippleCount && i < 5; i++) {
-        params.global.rippleCenters[i] = ripples[i].centerIndex;
-        uint32_t elapsed = now - ripples[i].startTime;
-        // 涟漪持续时间根据动画速度调整（与 TypeScript 版本保持一致）
-        const uint32_t rippleDuration = 3000 / opts->ledAnimationSpeed; // 毫秒
-        params.global.rippleProgress[i] = (float)elapsed / rippleDuration;
-        if (params.global.rippleProgress[i] > 1.0f) {
-            params.global.rippleProgress[i] = 1.0f;
-        }
-    }
+
+    // 自定义效果：程序可用时由字节码虚拟机整帧计算颜色，否则按 algorithm 的静态效果显示
+    const bool customAround = g_has_led_around && opts->aroundLedEnabled && opts->aroundLedSyncToMainLed;
+    const bool useCustom = (opts->ledEffect == LEDEffect::CUSTOM)
+        && renderCustomFrame(virtualPinMask, now, customAround ? NUM_LED : (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS));
     
     if (g_has_led_around) {
         // 设置环绕灯同步模式参数
@@ -183,7 +216,7 @@ void LEDsManager::loop(uint32_t virtualPinMask)
         if (!opts->aroundLedEnabled) {
             // 模式1：环绕灯关闭 - 设置为黑色，亮度为0
             for (uint8_t i = (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i < NUM_LED; i++) {
-                WS2812B_SetLEDColor(0, 0, 0, i);
+                frameBuffer[i] = {0, 0, 0};
             }
             setAmbientLightBrightness(0);
         } else if (opts->aroundLedSyncToMainLed) {
@@ -195,8 +228,7 @@ void LEDsManager::loop(uint32_t virtualPinMask)
                 params.index = (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) + i; // 环绕LED在全局数组中的索引
                 params.pressed = false; // 环绕LED没有按钮状态
                 
-                RGBColor color = algorithm(params);
-                WS2812B_SetLEDColor(color.r, color.g, color.b, (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) + i);
+                frameBuffer[(NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) + i] = useCustom ? customFrame[params.index] : algorithm(params);
             }
             setAmbientLightBrightness(opts->aroundLedBrightness);
         } else {
@@ -210,31 +242,38 @@ void LEDsManager::loop(uint32_t virtualPinMask)
         params.index = i;
         params.pressed = (virtualPinMask & (1 << i)) != 0;
         
-        RGBColor color = algorithm(params);
-        WS2812B_SetLEDColor(color.r, color.g, color.b, i);
+        frameBuffer[i] = useCustom ? customFrame[i] : algorithm(params);
     }
+
+    // 叠加图层并输出到LED
+    updateLayers(virtualPinMask);
+    flushFrame(virtualPinMask);
 }
 
 void LEDsManager::processButtonPress(uint32_t virtualPinMask)
 {
     // 检测新按下的按钮（用于涟漪效果）
     uint32_t newPressed = virtualPinMask & ~lastButtonState;
+
+    // 记录新释放的按钮，激活按键反馈图层；渐隐时长为 0 的配置文件不启用
+    uint32_t newReleased = lastButtonState & ~virtualPinMask;
+    if (newReleased != 0 && opts->ledReactiveFadeMs > 0) {
+        uint32_t releaseTime = HAL_GetTick();
+        for (uint8_t i = 0; i < (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i++) {
+            if (newReleased & (1 << i)) {
+                releaseTimes[i] = releaseTime;
+            }
+        }
+        // 每次释放都会顺延图层的到期时间，最后一个按键渐隐结束后图层自动失活
+        compositor.setLayerActive(LED_LAYER_REACTIVE, true, opts->ledReactiveFadeMs);
+    }
     
     if (newPressed != 0 && opts->ledEffect == LEDEffect::RIPPLE) {
-        // 查找按下的按钮并添加涟漪
+        // 同一帧内新按下的每个按钮都添加涟漪，池满时替换最老的涟漪
+        const uint32_t pressTime = HAL_GetTick();
         for (uint8_t i = 0; i < (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i++) {
             if (newPressed & (1 << i)) {
-                // 添加新的涟漪
-                if (rippleCount < 5) {
-                    ripples[rippleCount].centerIndex = i;
-                    ripples[rippleCount].startTime = HAL_GetTick();
-                    rippleCount++;
-                } else {
-                    // 如果已满，替换最老的涟漪
-                    ripples[0].centerIndex = i;
-                    ripples[0].startTime = HAL_GetTick();
-                }
-                break;
+                ripplePool.emit(i, pressTime);
             }
         }
     }
@@ -262,25 +301,17 @@ void LEDsManager::processButtonPress(uint32_t virtualPinMask)
 void LEDsManager::updateRipples()
 {
     if (opts->ledEffect != LEDEffect::RIPPLE) {
-        rippleCount = 0;
+        if (ripplePool.getActiveCount() > 0) {
+            ripplePool.clear();
+        }
         return;
     }
     
-    uint32_t now = HAL_GetTick();
     // 涟漪持续时间根据动画速度调整（与 TypeScript 版本保持一致）
     const uint32_t rippleDuration = 3000 / opts->ledAnimationSpeed; // 毫秒
     
-    // 移除过期的涟漪
-    uint8_t newCount = 0;
-    for (uint8_t i = 0; i < rippleCount; i++) {
-        if ((now - ripples[i].startTime) < rippleDuration) {
-            if (newCount != i) {
-                ripples[newCount] = ripples[i];
-            }
-            newCount++;
-        }
-    }
-    rippleCount = newCount;
+    // 移除过期的涟漪并计算每个 LED 的强度
+    ripplePool.update(HAL_GetTick(), rippleDuration);
 }
 
 float LEDsManager::getAnimationProgress()
@@ -304,12 +335,19 @@ void LEDsManager::deinit()
     WS2812B_Stop();
 }
 
+/**
+ * @brief 灯效设置改动后合并保存：只写当前配置文件的灯效分区，连续调节只写一次
+ */
+void LEDsManager::saveOptions() {
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(STORAGE_MANAGER.getDefaultGamepadProfile(), true));
+}
+
 void LEDsManager::effectStyleNext() {
     opts->ledEffect = static_cast<LEDEffect>((opts->ledEffect + 1) % LEDEffect::NUM_EFFECTS);
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -321,7 +359,7 @@ void LEDsManager::effectStylePrev() {
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -336,8 +374,7 @@ void LEDsManager::brightnessUp() {
         setLedsBrightness(opts->ledBrightness);
         // 只有在使用默认配置时才保存到存储
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            saveOptions();
         }
         
         
@@ -352,8 +389,7 @@ void LEDsManager::brightnessDown() {
         setLedsBrightness(opts->ledBrightness);
         // 只有在使用默认配置时才保存到存储
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            saveOptions();
         }
         
         
@@ -365,7 +401,7 @@ void LEDsManager::enableSwitch() {
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -505,6 +541,289 @@ bool LEDsManager::isUsingTemporaryConfig() const
     return usingTemporaryConfig;
 }
 
+/**
+ * @brief 注册叠加图层
+ */
+void LEDsManager::setupLayers()
+{
+    compositor.reset();
+
+    // 按键反馈：仅作用于按钮LED，按键释放后前景色渐隐
+    LedMask buttonsMask;
+    buttonsMask.clear();
+    buttonsMask.setRange(0, NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+    compositor.configureLayer(LED_LAYER_REACTIVE, renderReactiveLayer, this, LED_BLEND_NORMAL, 255);
+    compositor.setLayerMask(LED_LAYER_REACTIVE, buttonsMask);
+
+    // 通知：掩码在 notify() 中按通知类型设置
+    compositor.configureLayer(LED_LAYER_NOTIFICATION, renderNotificationLayer, this, LED_BLEND_SCREEN, 255);
+
+    // 快捷键反馈：掩码在 updateLayers() 中根据快捷键配置设置
+    compositor.configureLayer(LED_LAYER_HOTKEY, renderHotkeyLayer, this, LED_BLEND_NORMAL, 220);
+}
+
+/**
+ * @brief 触发通知图层
+ * @param notification 通知类型
+ */
+void LEDsManager::notify(LedNotification notification)
+{
+    uint32_t duration = 0;
+    LedMask mask;
+    mask.clear();
+
+    switch (notification) {
+        case LED_NOTIFY_PROFILE_SWITCHED:
+            duration = LEDS_NOTIFY_PROFILE_SWITCH_MS;
+            mask.setRange(0, NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+            break;
+        case LED_NOTIFY_LOW_LATENCY_WARNING:
+            duration = LEDS_NOTIFY_LOW_LATENCY_MS;
+            // 有环绕灯时用环绕灯提示，避免遮挡按键灯效
+            if (g_has_led_around) {
+                mask.setRange(NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS, NUM_LED_AROUND);
+            } else {
+                mask.setRange(0, NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+            }
+            break;
+        default:
+            compositor.setLayerActive(LED_LAYER_NOTIFICATION, false);
+            this->notification = LED_NOTIFY_NONE;
+            return;
+    }
+
+    this->notification = notification;
+    notificationStartTime = HAL_GetTick();
+    compositor.setLayerMask(LED_LAYER_NOTIFICATION, mask);
+    compositor.setLayerActive(LED_LAYER_NOTIFICATION, true, duration);
+}
+
+/**
+ * @brief 根据按键状态更新常驻图层的激活状态
+ * @param virtualPinMask 按钮虚拟引脚掩码
+ */
+void LEDsManager::updateLayers(uint32_t virtualPinMask)
+{
+    // FN 按下时提示已绑定快捷键的按键
+    bool fnPressed = (virtualPinMask & FN_BUTTON_VIRTUAL_PIN) != 0;
+    if (fnPressed && !compositor.isLayerActive(LED_LAYER_HOTKEY)) {
+        const GamepadHotkeyEntry* hotkeys = STORAGE_MANAGER.getGamepadHotkeyEntry();
+        LedMask mask;
+        mask.clear();
+        hotkeyPinMask = FN_BUTTON_VIRTUAL_PIN;
+        for (uint8_t i = 0; i < NUM_GAMEPAD_HOTKEYS; i++) {
+            if (hotkeys[i].action == GamepadHotkey::HOTKEY_NONE) continue;
+            if (hotkeys[i].virtualPin < 0 || hotkeys[i].virtualPin >= (int32_t)(NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)) continue;
+            hotkeyPinMask |= (1U << hotkeys[i].virtualPin);
+        }
+        for (uint8_t i = 0; i < (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i++) {
+            if (hotkeyPinMask & (1U << i)) mask.set(i);
+        }
+        compositor.setLayerMask(LED_LAYER_HOTKEY, mask);
+        compositor.setLayerActive(LED_LAYER_HOTKEY, true);
+    } else if (!fnPressed && compositor.isLayerActive(LED_LAYER_HOTKEY)) {
+        compositor.setLayerActive(LED_LAYER_HOTKEY, false);
+    }
+}
+
+/**
+ * @brief 合成激活的图层并写入LED数据
+ * @param virtualPinMask 按钮虚拟引脚掩码
+ */
+void LEDsManager::flushFrame(uint32_t virtualPinMask)
+{
+    LedLayerFrame frame;
+    frame.now = HAL_GetTick();
+    frame.virtualPinMask = virtualPinMask;
+
+    compositor.compose(frame, frameBuffer);
+
+    uint8_t count = g_has_led_around ? NUM_LED : (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+    for (uint8_t i = 0; i < count; i++) {
+        WS2812B_SetLEDColor(frameBuffer[i].r, frameBuffer[i].g, frameBuffer[i].b, i);
+    }
+}
+
+/**
+ * @brief 进入灯光流模式
+ */
+void LEDsManager::enterStream()
+{
+    streaming = true;
+    WS2812B_Start();
+    LED_STREAM.clearBrightnessChanged();
+    const uint8_t b = (uint8_t)((float_t)(LED_STREAM.getBrightness()) * LEDS_BRIGHTNESS_RATIO * 255.0 / 100.0);
+    WS2812B_SetAllLEDBrightness(b);
+    // 按键反馈图层依赖本地灯效的前景色，流模式下关闭
+    compositor.setLayerActive(LED_LAYER_REACTIVE, false);
+}
+
+/**
+ * @brief 退出灯光流模式，恢复本地灯效
+ */
+void LEDsManager::exitStream()
+{
+    streaming = false;
+    // 流模式下驱动仍在运行，直接按当前配置重建本地灯效，灯效关闭时 setup 会停止输出
+    setup();
+}
+
+/**
+ * @brief 结束灯光流并直接关闭灯光输出，不恢复本地灯效（网页配置模式未预览时使用）
+ */
+void LEDsManager::stopStream()
+{
+    streaming = false;
+    WS2812B_Stop();
+}
+
+/**
+ * @brief 显示灯光流的前台帧，通知与快捷键图层仍然叠加在上面
+ * @param virtualPinMask 按钮虚拟引脚掩码
+ */
+void LEDsManager::processStreamFrame(uint32_t virtualPinMask)
+{
+    LED_STREAM.swapBuffers();
+
+    if (LED_STREAM.isBrightnessChanged()) {
+        LED_STREAM.clearBrightnessChanged();
+        const uint8_t b = (uint8_t)((float_t)(LED_STREAM.getBrightness()) * LEDS_BRIGHTNESS_RATIO * 255.0 / 100.0);
+        WS2812B_SetAllLEDBrightness(b);
+    }
+
+    // 合成会改写帧缓冲，因此每帧都从前台缓冲复制
+    memcpy(frameBuffer, LED_STREAM.getFrontBuffer(), sizeof(frameBuffer));
+    lastButtonState = virtualPinMask;
+
+    updateLayers(virtualPinMask);
+    flushFrame(virtualPinMask);
+}
+
+/**
+ * @brief 重新加载自定义灯效程序，上传或切换程序后调用
+ */
+void LEDsManager::reloadCustomProgram()
+{
+    if (opts->ledEffect == LEDEffect::CUSTOM) {
+        LED_PROGRAM_STORE.loadActive(ledVm);
+        ledVmFrame = 0;
+        memset(customFrame, 0, sizeof(customFrame));
+    } else {
+        ledVm.unload();
+    }
+}
+
+/**
+ * @brief 执行自定义灯效程序，计算一帧写入 customFrame
+ * @param virtualPinMask 按钮虚拟引脚掩码
+ * @param now 当前时间 ms
+ * @param numLeds 需要计算的 LED 数量（环绕灯不同步时只算按键灯）
+ * @return 程序是否可用
+ */
+bool LEDsManager::renderCustomFrame(uint32_t virtualPinMask, uint32_t now, uint8_t numLeds)
+{
+    if (!ledVm.isLoaded() || ledVm.isFaulted()) {
+        return false;
+    }
+
+    // 行程只在自定义效果下读取，避免其他效果承担换算开销
+    if (travelProvider != nullptr) {
+        for (uint8_t i = 0; i < (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i++) {
+            keyTravel[i] = travelProvider(i);
+        }
+    }
+
+    LedVmFrameInputs inputs;
+    inputs.time = now - animationStartTime;
+    inputs.frame = ledVmFrame++;
+    inputs.virtualPinMask = virtualPinMask;
+    inputs.travel = (travelProvider != nullptr) ? keyTravel : nullptr;
+    inputs.speed = opts->ledAnimationSpeed;
+    inputs.colors[0] = frontColor;
+    inputs.colors[1] = backgroundColor1;
+    inputs.colors[2] = backgroundColor2;
+    ledVm.beginFrame(inputs);
+
+    RGBColor next[NUM_LED];
+    for (uint8_t i = 0; i < numLeds; i++) {
+        if (!ledVm.run(i, next[i])) break;
+    }
+    // 超出预算的帧丢弃，保持上一帧；持续超预算时程序失效，之后按静态效果显示
+    if (ledVm.endFrame()) {
+        memcpy(customFrame, next, numLeds * sizeof(RGBColor));
+    }
+    return !ledVm.isFaulted();
+}
+
+/**
+ * @brief 按键反馈图层：释放后前景色线性渐隐
+ */
+uint8_t LEDsManager::renderReactiveLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData)
+{
+    LEDsManager* self = static_cast<LEDsManager*>(userData);
+    const uint32_t fadeMs = self->opts->ledReactiveFadeMs;
+
+    // 按下中的按钮由底层效果显示前景色
+    if (fadeMs == 0 || (frame.virtualPinMask & (1U << index))) return 0;
+
+    uint32_t elapsed = frame.now - self->releaseTimes[index];
+    if (self->releaseTimes[index] == 0 || elapsed >= fadeMs) return 0;
+
+    out = self->frontColor;
+    return (uint8_t)(255 - (elapsed * 255) / fadeMs);
+}
+
+/**
+ * @brief 通知图层：切换配置时闪烁两次前景色，低延迟模式警告时以警告色脉冲三次
+ */
+uint8_t LEDsManager::renderNotificationLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData)
+{
+    LEDsManager* self = static_cast<LEDsManager*>(userData);
+    uint32_t elapsed = frame.now - self->notificationStartTime;
+    uint32_t duration;
+    uint32_t pulses;
+
+    switch (self->notification) {
+        case LED_NOTIFY_PROFILE_SWITCHED:
+            out = self->frontColor;
+            duration = LEDS_NOTIFY_PROFILE_SWITCH_MS;
+            pulses = 2;
+            break;
+        case LED_NOTIFY_LOW_LATENCY_WARNING:
+            out = hexToRGB(LEDS_NOTIFY_WARNING_COLOR);
+            duration = LEDS_NOTIFY_LOW_LATENCY_MS;
+            pulses = 3;
+            break;
+        default:
+            return 0;
+    }
+
+    if (elapsed >= duration) return 0;
+
+    // 三角波：每个脉冲先渐亮再渐暗
+    uint32_t period = duration / pulses;
+    uint32_t phase = elapsed % period;
+    uint32_t half = period / 2;
+    if (half == 0) return 255;
+    uint32_t level = (phase < half) ? phase : (period - phase);
+    return (uint8_t)std::min<uint32_t>((level * 255) / half, 255);
+}
+
+/**
+ * @brief 快捷键反馈图层：FN 按下时，已绑定快捷键的按键显示前景色
+ */
+uint8_t LEDsManager::renderHotkeyLayer(const LedLayerFrame& frame, uint8_t index, RGBColor& out, void* userData)
+{
+    LEDsManager* self = static_cast<LEDsManager*>(userData);
+    // 正在按下的快捷键反色显示，便于确认
+    if (frame.virtualPinMask & (1U << index)) {
+        out = self->backgroundColor1;
+    } else {
+        out = self->frontColor;
+    }
+    return 255;
+}
+
 /**
  * @brief 从当前配置更新颜色值
  */
@@ -530,7 +849,7 @@ void LEDsManager::processAroundLedAnimation()
                 RGBColor color = hexToRGB(opts->aroundLedColor1);
                 
                 for (uint8_t i = (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i < NUM_LED; i++) {
-                    WS2812B_SetLEDColor(color.r, color.g, color.b, i);
+                    frameBuffer[i] = color;
                 }
                 setAmbientLightBrightness(opts->aroundLedBrightness);
             }
@@ -548,7 +867,7 @@ void LEDsManager::processAroundLedAnimation()
                                                               opts->aroundLedAnimationSpeed,
                                                               0); // triggerTime参数已废弃，传入0
                     
-                    WS2812B_SetLEDColor(color.r, color.g, color.b, i);
+                    frameBuffer[i] = color;
                 }
                 setAmbientLightBrightness(opts->aroundLedBrightness);
             }
@@ -566,7 +885,7 @@ void LEDsManager::processAroundLedAnimation()
                                                            opts->aroundLedAnimationSpeed,
                                                            0); // triggerTime参数已废弃，传入0
                     
-                    WS2812B_SetLEDColor(color.r, color.g, color.b, i);
+                    frameBuffer[i] = color;
                 }
                 setAmbientLightBrightness(opts->aroundLedBrightness);
             }
@@ -584,7 +903,7 @@ void LEDsManager::processAroundLedAnimation()
                                                             opts->aroundLedAnimationSpeed,
                                                             0); // triggerTime参数已废弃，传入0
                     
-                    WS2812B_SetLEDColor(color.r, color.g, color.b, i);
+                    frameBuffer[i] = color;
                 }
                 setAmbientLightBrightness(opts->aroundLedBrightness);   
             }
@@ -593,7 +912,7 @@ void LEDsManager::processAroundLedAnimation()
         default:
             // 默认情况：关闭环绕灯
             for (uint8_t i = (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i < NUM_LED; i++) {
-                WS2812B_SetLEDColor(0, 0, 0, i);
+                frameBuffer[i] = {0, 0, 0};
             }
             setAmbientLightBrightness(0);
             break;
@@ -646,6 +965,9 @@ void LEDsManager::updateAroundLedColors()
     
     // 独立模式下更新环绕灯
     processAroundLedAnimation();
+    for (uint8_t i = (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS); i < NUM_LED; i++) {
+        WS2812B_SetLEDColor(frameBuffer[i].r, frameBuffer[i].g, frameBuffer[i].b, i);
+    }
 }
 
 
@@ -657,7 +979,7 @@ void LEDsManager::ambientLightEffectStyleNext() {
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -672,7 +994,7 @@ void LEDsManager::ambientLightEffectStylePrev() {
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -691,8 +1013,7 @@ void LEDsManager::ambientLightBrightnessUp() {
 
         // 只有在使用默认配置时才保存到存储
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            saveOptions();
         }
     }
 }
@@ -708,8 +1029,7 @@ void LEDsManager::ambientLightBrightnessDown() {
         setAmbientLightBrightness(opts->aroundLedBrightness);
         // 只有在使用默认配置时才保存到存储
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            saveOptions();
         }
         
     }
@@ -723,7 +1043,7 @@ void LEDsManager::ambientLightEnableSwitch() {
     
     // 只有在使用默认配置时才保存到存储
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        saveOptions();
     }
     
     deinit();
@@ -3,6 +3,8 @@
 #include "system_logger.h"
 #include "adc_btns/adc_manager.hpp"
 #include "screen_control/spi_screen_manager.hpp"
+#include "config_store.hpp"
+#include "flash_writer.hpp"
 #include "tusb.h"
 
 #if APPLICATION_DEBUG_PRINT
@@ -59,7 +61,10 @@ void MainStateMachine::setup()
         uint32_t t0_cycles = DWT->CYCCNT;
 #endif
 
-        SPIScreenManager::getInstance().loop();
+        // 后台擦写占用 QSPI 期间映射区不可读，屏幕的图片资源在映射区，这几帧先不画
+        if (!FLASH_WRITER.isBusy()) {
+            SPIScreenManager::getInstance().loop();
+        }
 
 #if APPLICATION_DEBUG_PRINT
         uint32_t dt_cycles = DWT->CYCCNT - t0_cycles;
@@ -75,6 +80,11 @@ void MainStateMachine::setup()
             screen_loop_last_log_ms = now_ms;
         }
 #endif
+
+        // 合并后的延迟保存，以及配置日志的后台整理（空闲时才动作）
+        STORAGE_MANAGER.loop();
+        CONFIG_STORE.service();
+        FLASH_WRITER.poll();
     }
 
 }
@@ -0,0 +1,147 @@
+#include "profile_runtime.hpp"
+#include "storagemanager.hpp"
+#include "gamepad/GamepadState.hpp"
+#include "CRC32.hpp"
+#include "board_cfg.h"
+#include <string.h>
+
+static_assert(sizeof(GamepadProfile) <= UINT16_MAX, "CRC32::calculate takes a 16-bit length");
+static_assert(NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS <= PROFILE_RUNTIME_NUM_PINS, "virtual pins must fit the lookup table");
+
+// 每个 GameControllerButton 对应的手柄输出，下标与枚举一致
+static const ProfileRuntimePin CONTROLLER_BUTTON_OUTPUTS[NUM_GAME_CONTROLLER_BUTTONS] = {
+    { 0, 0, 0 },                                // GAME_CONTROLLER_NONE
+    { 0, 0, GAMEPAD_MASK_UP },
+    { 0, 0, GAMEPAD_MASK_DOWN },
+    { 0, 0, GAMEPAD_MASK_LEFT },
+    { 0, 0, GAMEPAD_MASK_RIGHT },
+    { GAMEPAD_MASK_B1, 0, 0 },
+    { GAMEPAD_MASK_B2, 0, 0 },
+    { GAMEPAD_MASK_B3, 0, 0 },
+    { GAMEPAD_MASK_B4, 0, 0 },
+    { GAMEPAD_MASK_L1, 0, 0 },
+    { GAMEPAD_MASK_R1, 0, 0 },
+    { GAMEPAD_MASK_L2, 0, 0 },
+    { GAMEPAD_MASK_R2, 0, 0 },
+    { GAMEPAD_MASK_S1, 0, 0 },
+    { GAMEPAD_MASK_S2, 0, 0 },
+    { GAMEPAD_MASK_L3, 0, 0 },
+    { GAMEPAD_MASK_R3, 0, 0 },
+    { GAMEPAD_MASK_A1, 0, 0 },
+    { GAMEPAD_MASK_A2, 0, 0 },
+    { 0, AUX_MASK_FUNCTION, 0 },                // GAME_CONTROLLER_BUTTON_FN
+};
+
+/**
+ * @brief 给 pinMask 里的每个虚拟引脚加上 output
+ */
+static void add_pin_output(ProfileRuntime& image, Mask_t pinMask, const ProfileRuntimePin& output)
+{
+    pinMask &= (Mask_t)((1ULL << PROFILE_RUNTIME_NUM_PINS) - 1);
+    while (pinMask) {
+        const uint8_t pin = (uint8_t)__builtin_ctz(pinMask);
+        pinMask &= pinMask - 1;
+        image.pins[pin].buttons |= output.buttons;
+        image.pins[pin].aux |= output.aux;
+        image.pins[pin].dpad |= output.dpad;
+        image.mappedPinMask |= (1U << pin);
+    }
+}
+
+/**
+ * @brief 毫米换算成整数微米，四舍五入并限制在 uint16_t 范围内
+ */
+static uint16_t mm_to_um(float mm)
+{
+    if (!(mm > 0.0f)) return 0;
+    const float um = mm * 1000.0f + 0.5f;
+    return um >= (float)UINT16_MAX ? UINT16_MAX : (uint16_t)um;
+}
+
+void ProfileCompiler::compile(const GamepadProfile& profile, ProfileRuntime& image)
+{
+    const KeysConfig& keys = profile.keysConfig;
+
+    memset(&image, 0, sizeof(ProfileRuntime));
+    image.sourceCrc = CRC32::calculate((const uint8_t*)&profile, (uint16_t)sizeof(GamepadProfile));
+
+    // 映射和组合键并成按虚拟引脚索引的查找表；组合键不包含 Fn
+    for (uint8_t b = GAME_CONTROLLER_DPAD_UP; b < NUM_GAME_CONTROLLER_BUTTONS; b++) {
+        add_pin_output(image, keys.keyMapping[b], CONTROLLER_BUTTON_OUTPUTS[b]);
+    }
+    for (uint8_t i = 0; i < MAX_KEY_COMBINATION; i++) {
+        const KeyCombination& combo = keys.keyCombinations[i];
+        if (combo.gameControllerButtonMask == 0 || combo.virtualPinMask == 0) {
+            continue;
+        }
+        for (uint8_t b = GAME_CONTROLLER_DPAD_UP; b < GAME_CONTROLLER_BUTTON_FN; b++) {
+            if (combo.gameControllerButtonMask & (1U << b)) {
+                add_pin_output(image, combo.virtualPinMask, CONTROLLER_BUTTON_OUTPUTS[b]);
+            }
+        }
+    }
+
+    // 输入模式切换需要重启，BYPASS 的处理可以提前做掉
+    const InputMode inputMode = STORAGE_MANAGER.getInputMode();
+    image.socdMode = (keys.socdMode == SOCD_MODE_BYPASS &&
+                      (inputMode == INPUT_MODE_SWITCH || inputMode == INPUT_MODE_PS4)) ?
+        SOCD_MODE_NEUTRAL : keys.socdMode;
+    image.invertXAxis = keys.invertXAxis;
+    image.invertYAxis = keys.invertYAxis;
+    image.fourWayMode = keys.fourWayMode;
+
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        image.enabledKeysMask |= (keys.keysEnableTag[i] ? (1U << i) : 0);
+    }
+
+    // 宏：步数超出上限的按上限截断，播放时不用再检查
+    for (uint8_t i = 0; i < MAX_NUM_MACROS; i++) {
+        const MacroConfig& macro = keys.macros[i];
+        uint32_t triggerMask = 0;
+        for (uint8_t t = 0; t < macro.numTriggerKeys && t < MAX_MACRO_TRIGGER_KEYS; t++) {
+            const uint8_t key = macro.triggerKeys[t];
+            if (key < 32) triggerMask |= (1UL << key);
+        }
+        image.macroTriggerMask[i] = triggerMask;
+        memcpy(&image.macros[i], &macro, sizeof(MacroConfig));
+        if (image.macros[i].numSteps > MAX_MACRO_STEPS) {
+            image.macros[i].numSteps = MAX_MACRO_STEPS;
+        }
+    }
+
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        const RapidTriggerProfile& trigger = profile.triggerConfigs.triggerConfigs[i];
+        ProfileRuntimeTrigger& out = image.triggers[i];
+        out.pressAccuracyUm = mm_to_um(trigger.pressAccuracy);
+        out.highPrecisionReleaseAccuracyUm = mm_to_um(trigger.releaseAccuracy);
+        out.releaseAccuracyUm = mm_to_um(trigger.releaseAccuracy < MIN_ADC_RELEASE_ACCURACY ? MIN_ADC_RELEASE_ACCURACY : trigger.releaseAccuracy);
+        out.topDeadzoneUm = mm_to_um(trigger.topDeadzone < MIN_ADC_TOP_DEADZONE ? MIN_ADC_TOP_DEADZONE : trigger.topDeadzone);
+        out.bottomDeadzoneUm = mm_to_um(trigger.bottomDeadzone < MIN_ADC_BOTTOM_DEADZONE ? MIN_ADC_BOTTOM_DEADZONE : trigger.bottomDeadzone);
+    }
+}
+
+void ProfileRuntimeManager::request(const GamepadProfile& profile)
+{
+    const uint32_t crc = CRC32::calculate((const uint8_t*)&profile, (uint16_t)sizeof(GamepadProfile));
+    if (activeValid && images[active].sourceCrc == crc) {
+        pending = false;
+        return;
+    }
+    ProfileRuntime& back = images[active ^ 1];
+    if (!backValid || back.sourceCrc != crc) {
+        ProfileCompiler::compile(profile, back);
+        backValid = true;
+    }
+    pending = true;
+}
+
+bool ProfileRuntimeManager::commit()
+{
+    if (!pending) return false;
+    // 旧镜像留在后台，切回去时不用重新编译
+    active ^= 1;
+    backValid = activeValid;
+    activeValid = true;
+    pending = false;
+    return true;
+}
@@ -30,7 +30,7 @@ void ScreenDetailAmbientBrightness_Rotate(uint8_t* ioIndex, int8_t det) {
     if (p) p->ledsConfigs.aroundLedBrightness = *ioIndex;
     if (p && !p->ledsConfigs.aroundLedEnabled) LEDS_MANAGER.ambientLightEnableSwitch();
     LEDS_MANAGER.setAmbientLightBrightness(*ioIndex);
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(default_profile(), true));
 }
 
 void ScreenDetailAmbientBrightness_Render(ST7789_Handle* lcd, uint8_t index, const ScreenUiStyle& style) {
@@ -40,5 +40,5 @@ void ScreenDetailAmbientBrightness_Render(ST7789_Handle* lcd, uint8_t index, con
 void ScreenDetailAmbientBrightness_OnConfirm(uint8_t index) {
     (void)index;
     LEDS_MANAGER.ambientLightEnableSwitch();
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(default_profile(), true));
 }
@@ -26,6 +26,6 @@ void ScreenDetailCalibration_Render(ST7789_Handle* lcd, uint8_t index, const Scr
 void ScreenDetailCalibration_OnConfirm(uint8_t index) {
     (void)index;
     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-    STORAGE_MANAGER.saveConfig();
+    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
     NVIC_SystemReset();
 }
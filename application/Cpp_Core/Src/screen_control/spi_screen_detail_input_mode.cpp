@@ -42,7 +42,7 @@ void ScreenDetailInputMode_OnConfirm(uint8_t index) {
     if (index < (uint8_t)(sizeof(kInputModes) / sizeof(kInputModes[0]))) {
         STORAGE_MANAGER.setInputMode(kInputModes[index]);
         STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
         NVIC_SystemReset();
     }
 }
@@ -0,0 +1,187 @@
+#include "screen_control/spi_screen_detail_entries.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "adc_btns/adc_btns_worker.hpp"
+#include "gamepad/GamepadState.hpp"
+#include "input_snapshot.hpp"
+#include "screen_control/spi_screen_ui_common.hpp"
+#include "screen_control/spi_screen_widgets.hpp"
+
+/**
+ * 输入监视页：每个 ADC 按键一根行程条（带触发 / 重置刻线），GPIO 按键一个方块，
+ * 顶部显示 SOCD 处理后的方向和回报率。
+ *
+ * 数据来自输入流水线发布的快照，行程换算在这里完成。每帧最多更新
+ * SCREEN_INPUT_MONITOR_BARS_PER_FRAME 根行程条，其余保持上一帧的值留到下一帧，
+ * 按键状态变化的优先更新，单帧绘制量有上限，不会拖长主循环里的输入处理间隔。
+ */
+
+#ifndef SCREEN_INPUT_MONITOR_FRAME_MS
+#define SCREEN_INPUT_MONITOR_FRAME_MS 33u
+#endif
+
+#ifndef SCREEN_INPUT_MONITOR_BARS_PER_FRAME
+#define SCREEN_INPUT_MONITOR_BARS_PER_FRAME 6u
+#endif
+
+#define INPUT_MONITOR_BAR_Y       16u
+#define INPUT_MONITOR_BAR_H       128u
+#define INPUT_MONITOR_SLOT_W      14u
+#define INPUT_MONITOR_GPIO_Y      152u
+#define INPUT_MONITOR_GPIO_W      24u
+#define INPUT_MONITOR_GPIO_H      14u
+#define INPUT_MONITOR_GPIO_GAP    8u
+
+struct InputMonitorBar {
+    uint8_t travel;     // 行程像素，0 为完全释放
+    uint8_t pressMark;  // 触发刻线像素，0 不画
+    uint8_t releaseMark;
+    bool pressed;
+};
+
+static InputMonitorBar g_shown[NUM_ADC_BUTTONS];
+static uint8_t g_cursor = 0;
+static InputSnapshotFrame g_frame;
+
+static ScreenWidgetRect monitor_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    ScreenWidgetRect r = {x, y, w, h};
+    return r;
+}
+
+static uint8_t travel_px(float maxTravel, float distance) {
+    float px = (maxTravel - distance) * (float)INPUT_MONITOR_BAR_H / maxTravel + 0.5f;
+    if (px <= 0.0f) return 0u;
+    if (px >= (float)INPUT_MONITOR_BAR_H) return (uint8_t)INPUT_MONITOR_BAR_H;
+    return (uint8_t)px;
+}
+
+static void compute_bar(const InputSnapshotKey& k, const ADCValuesMapping* mapping, InputMonitorBar* out) {
+    out->pressed = (k.flags & INPUT_SNAPSHOT_KEY_PRESSED) != 0;
+    ADCBtn* btn = (k.flags & INPUT_SNAPSHOT_KEY_ANALOG) ? ADC_BTNS_WORKER.getButtonState(k.buttonIndex) : nullptr;
+    if (!btn || !mapping || mapping->length < 2 || mapping->step <= 0.0f) {
+        // 没有行程数据时只按按下状态画满或清空
+        out->travel = out->pressed ? (uint8_t)INPUT_MONITOR_BAR_H : 0u;
+        out->pressMark = 0u;
+        out->releaseMark = 0u;
+        return;
+    }
+    const float maxTravel = (mapping->length - 1) * mapping->step;
+    out->travel = travel_px(maxTravel, ADC_BTNS_WORKER.getDistanceByValue(btn, k.value));
+    uint8_t pressMark = travel_px(maxTravel, ADC_BTNS_WORKER.getDistanceByValue(btn, k.pressThreshold));
+    uint8_t releaseMark = travel_px(maxTravel, ADC_BTNS_WORKER.getDistanceByValue(btn, k.releaseThreshold));
+    out->pressMark = pressMark ? pressMark : 1u;
+    out->releaseMark = releaseMark ? releaseMark : 1u;
+}
+
+static bool bar_changed(const InputMonitorBar& shown, const InputMonitorBar& next) {
+    if (shown.pressMark != next.pressMark || shown.releaseMark != next.releaseMark) return true;
+    // 1 像素以内的抖动不重画，到顶和到底必须画准
+    int diff = (int)next.travel - (int)shown.travel;
+    if (diff > 1 || diff < -1) return true;
+    return diff != 0 && (next.travel == 0u || next.travel == INPUT_MONITOR_BAR_H);
+}
+
+/**
+ * @brief 按预算把目标值提交到显示值：先提交按下状态变化的按键，再从轮转游标开始提交其余变化
+ * @return 还有未提交的变化时返回 true
+ */
+static bool commit_bars(const InputMonitorBar* next) {
+    uint8_t budget = SCREEN_INPUT_MONITOR_BARS_PER_FRAME;
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS && budget > 0u; i++) {
+        if (g_shown[i].pressed == next[i].pressed) continue;
+        g_shown[i] = next[i];
+        budget--;
+    }
+    uint8_t i = g_cursor;
+    for (uint8_t n = 0; n < NUM_ADC_BUTTONS && budget > 0u; n++) {
+        if (bar_changed(g_shown[i], next[i])) {
+            g_shown[i] = next[i];
+            budget--;
+            g_cursor = (uint8_t)((i + 1u) % NUM_ADC_BUTTONS);
+        }
+        i = (uint8_t)((i + 1u) % NUM_ADC_BUTTONS);
+    }
+    for (uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+        if (g_shown[k].pressed != next[k].pressed || bar_changed(g_shown[k], next[k])) return true;
+    }
+    return false;
+}
+
+static void format_direction(uint8_t dpad, char* out, size_t outSize) {
+    char dir[5];
+    uint8_t n = 0;
+    if (dpad & GAMEPAD_MASK_UP) dir[n++] = 'U';
+    if (dpad & GAMEPAD_MASK_DOWN) dir[n++] = 'D';
+    if (dpad & GAMEPAD_MASK_LEFT) dir[n++] = 'L';
+    if (dpad & GAMEPAD_MASK_RIGHT) dir[n++] = 'R';
+    if (n == 0) dir[n++] = '-';
+    dir[n] = '\0';
+    snprintf(out, outSize, "DIR %s", dir);
+}
+
+uint8_t ScreenDetailInputMonitor_InitIndex(void) {
+    memset(g_shown, 0, sizeof(g_shown));
+    g_cursor = 0;
+    return 0;
+}
+
+void ScreenDetailInputMonitor_Rotate(uint8_t* ioIndex, int8_t det) {
+    (void)ioIndex;
+    (void)det;
+}
+
+void ScreenDetailInputMonitor_Render(ST7789_Handle* lcd, uint8_t index, const ScreenUiStyle& style) {
+    (void)index;
+    if (!lcd) return;
+    const uint32_t nowMs = HAL_GetTick();
+    const uint16_t listX = SPI_SCREEN_LEFT_BAR_W;
+    const uint16_t listW = (uint16_t)(ST7789_WIDTH - SPI_SCREEN_LEFT_BAR_W - SPI_SCREEN_RIGHT_BAR_W);
+    const uint16_t statusH = ScreenUI_CharCellH(1);
+    const uint16_t halfW = (uint16_t)(listW / 2u);
+    const uint32_t muted = ScreenUI_MutedTextForBg(style.text, style.bg, 50u);
+    ScreenWidgetTree* tree = ScreenWidgets_Content();
+
+    // 读快照同时续租；刚续租还没有新快照时沿用上一帧
+    (void)INPUT_SNAPSHOT.read(&g_frame, nowMs);
+
+    char text[24];
+    format_direction(g_frame.dpad, text, sizeof(text));
+    ScreenWidget_Label(tree, monitor_rect(listX, 4u, halfW, statusH), text, style.text, style.bg, style.bg, 1, SCREEN_ALIGN_CENTER);
+    const uint32_t rateHz = INPUT_SNAPSHOT.getReportRateHz(nowMs);
+    if (rateHz) snprintf(text, sizeof(text), "%luHz", (unsigned long)rateHz);
+    else snprintf(text, sizeof(text), "--Hz");
+    ScreenWidget_Label(tree, monitor_rect((uint16_t)(listX + halfW), 4u, (uint16_t)(listW - halfW), statusH), text, style.text, style.bg, style.bg, 1, SCREEN_ALIGN_CENTER);
+
+    InputMonitorBar next[NUM_ADC_BUTTONS];
+    const ADCValuesMapping* mapping = ADC_BTNS_WORKER.getCurrentMapping();
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        compute_bar(g_frame.keys[i], mapping, &next[i]);
+    }
+    const bool pending = commit_bars(next);
+
+    const uint16_t barsX = (uint16_t)(listX + (listW - NUM_ADC_BUTTONS * INPUT_MONITOR_SLOT_W) / 2u);
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        const InputMonitorBar& b = g_shown[i];
+        const ScreenWidgetRect r = monitor_rect((uint16_t)(barsX + i * INPUT_MONITOR_SLOT_W), INPUT_MONITOR_BAR_Y, INPUT_MONITOR_SLOT_W, INPUT_MONITOR_BAR_H);
+        ScreenWidget_Meter(tree, r, b.travel, INPUT_MONITOR_BAR_H, b.pressMark, b.releaseMark,
+            b.pressed ? style.okBg : style.text, style.selBg, style.bg, style.okBg, muted);
+    }
+
+    const uint16_t gpioW = (uint16_t)(NUM_GPIO_BUTTONS * INPUT_MONITOR_GPIO_W + (NUM_GPIO_BUTTONS - 1u) * INPUT_MONITOR_GPIO_GAP);
+    const uint16_t gpioX = (uint16_t)(listX + (listW - gpioW) / 2u);
+    for (uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        const bool pressed = (g_frame.virtualPinMask & (1U << (NUM_ADC_BUTTONS + i))) != 0;
+        const ScreenWidgetRect r = monitor_rect((uint16_t)(gpioX + i * (INPUT_MONITOR_GPIO_W + INPUT_MONITOR_GPIO_GAP)), INPUT_MONITOR_GPIO_Y, INPUT_MONITOR_GPIO_W, INPUT_MONITOR_GPIO_H);
+        ScreenWidget_Panel(tree, r, pressed ? style.okBg : style.selBg);
+    }
+
+    // 页面打开期间按固定间隔刷新；有按预算推迟的行程条时下一轮主循环就补上
+    ScreenUI_RequestFrameAt(pending ? nowMs : nowMs + SCREEN_INPUT_MONITOR_FRAME_MS);
+}
+
+bool ScreenDetailInputMonitor_OnConfirm(uint8_t index) {
+    (void)index;
+    return true;
+}
@@ -30,7 +30,7 @@ void ScreenDetailLightBrightness_Rotate(uint8_t* ioIndex, int8_t det) {
     if (p) p->ledsConfigs.ledBrightness = *ioIndex;
     if (p && !p->ledsConfigs.ledEnabled) LEDS_MANAGER.enableSwitch();
     LEDS_MANAGER.setLedsBrightness(*ioIndex);
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(default_profile(), true));
 }
 
 void ScreenDetailLightBrightness_Render(ST7789_Handle* lcd, uint8_t index, const ScreenUiStyle& style) {
@@ -40,5 +40,5 @@ void ScreenDetailLightBrightness_Render(ST7789_Handle* lcd, uint8_t index, const
 void ScreenDetailLightBrightness_OnConfirm(uint8_t index) {
     (void)index;
     LEDS_MANAGER.enableSwitch();
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(STORAGE_MANAGER.getProfileSections(default_profile(), true));
 }
@@ -10,6 +10,7 @@ static const char* kLightEffectLabels[] = {
     "Flowing",
     "Ripple",
     "Transform",
+    "Custom",
 };
 
 static GamepadProfile* default_profile(void) {
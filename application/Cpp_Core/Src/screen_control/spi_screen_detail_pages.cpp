@@ -18,6 +18,7 @@ ScreenDetailKind ScreenDetail_Kind(uint8_t menuId) {
         case 9:
         case 10:
         case 3:
+        case 12:
             return SCREEN_DETAIL_INFO;
         default:
             return SCREEN_DETAIL_NONE;
@@ -38,6 +39,7 @@ uint8_t ScreenDetail_InitIndex(uint8_t menuId) {
         case 9: return ScreenDetailWebConfig_InitIndex();
         case 10: return ScreenDetailCalibration_InitIndex();
         case 3: return ScreenDetailTournament_InitIndex();
+        case 12: return ScreenDetailInputMonitor_InitIndex();
         default: return 0;
     }
 }
@@ -56,6 +58,7 @@ void ScreenDetail_OnRotate(uint8_t menuId, uint8_t* ioIndex, int8_t det) {
         case 9: ScreenDetailWebConfig_Rotate(ioIndex, det); break;
         case 10: ScreenDetailCalibration_Rotate(ioIndex, det); break;
         case 3: ScreenDetailTournament_Rotate(ioIndex, det); break;
+        case 12: ScreenDetailInputMonitor_Rotate(ioIndex, det); break;
         default: break;
     }
 }
@@ -74,6 +77,7 @@ bool ScreenDetail_OnConfirm(uint8_t menuId, uint8_t index) {
         case 9: ScreenDetailWebConfig_OnConfirm(index); return true;
         case 10: ScreenDetailCalibration_OnConfirm(index); return true;
         case 3: ScreenDetailTournament_OnConfirm(index); return true;
+        case 12: return ScreenDetailInputMonitor_OnConfirm(index);
         default: return false;
     }
 }
@@ -92,6 +96,7 @@ void ScreenDetail_Render(ST7789_Handle* lcd, uint8_t menuId, uint8_t index, cons
         case 9: ScreenDetailWebConfig_Render(lcd, index, style); break;
         case 10: ScreenDetailCalibration_Render(lcd, index, style); break;
         case 3: ScreenDetailTournament_Render(lcd, index, style); break;
+        case 12: ScreenDetailInputMonitor_Render(lcd, index, style); break;
         default: break;
     }
 }
@@ -78,5 +78,7 @@ void ScreenDetailProfiles_OnConfirm(uint8_t index) {
     uint8_t count = build_enabled_profile_map();
     if (index >= count) return;
     uint8_t pi = g_enabledProfileIdx[index];
-    STORAGE_MANAGER.setDefaultProfileId(STORAGE_MANAGER.config.profiles[pi].id);
+    if (STORAGE_MANAGER.setDefaultProfileId(STORAGE_MANAGER.config.profiles[pi].id)) {
+        STORAGE_MANAGER.requestSave(CONFIG_SECTION_GLOBAL);
+    }
 }
@@ -3,6 +3,12 @@
 #include <stdio.h>
 
 #include "screen_control/spi_screen_ui_common.hpp"
+#include "screen_control/spi_screen_widgets.hpp"
+
+static ScreenWidgetRect content_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    ScreenWidgetRect r = {x, y, w, h};
+    return r;
+}
 
 void ScreenDetailRender_List(ST7789_Handle* lcd, const char* title, const char* const* labels, uint8_t count, uint8_t index, uint8_t selectedConfigIndex, const ScreenUiStyle& style, uint16_t itemH, bool animActive, int animDir, uint32_t animStartMs, uint32_t nowMs) {
     (void)title;
@@ -12,12 +18,7 @@ void ScreenDetailRender_List(ST7789_Handle* lcd, const char* title, const char*
     const uint16_t h = ST7789_HEIGHT;
     const uint16_t listX = SPI_SCREEN_LEFT_BAR_W;
     const uint16_t listW = (uint16_t)(w - SPI_SCREEN_LEFT_BAR_W - SPI_SCREEN_RIGHT_BAR_W);
-    const uint16_t centerY = (uint16_t)(h / 2u);
-    const uint16_t anchorY = (uint16_t)(centerY - itemH / 2u);
     const uint32_t normalText = ScreenUI_MutedTextForBg(style.text, style.bg, 80u);
-    const uint16_t charH = ScreenUI_CharCellH(SPI_SCREEN_MENU_TEXT_SCALE);
-
-    ST7789_FillRect(lcd, listX, 0, listW, h, style.bg);
 
     int offsetPx = 0;
     if (animActive) {
@@ -26,33 +27,7 @@ void ScreenDetailRender_List(ST7789_Handle* lcd, const char* title, const char*
         offsetPx = -animDir * signedPx;
     }
 
-    for (uint8_t i = 0; i < count; i++) {
-        int dy = (int)((int)i - (int)index) * (int)itemH;
-        int y0 = (int)anchorY + dy + offsetPx;
-        int y1 = y0 + (int)itemH;
-        if (y1 <= 0 || y0 >= (int)h) continue;
-
-        int clipY0 = (y0 < 0) ? 0 : y0;
-        int clipY1 = (y1 > (int)h) ? (int)h : y1;
-        uint16_t yy = (uint16_t)clipY0;
-        uint16_t hh = (uint16_t)(clipY1 - clipY0);
-
-        int textY = y0 + (int)((itemH - charH) / 2u);
-        bool textVisible = (textY >= 0) && ((textY + (int)charH) <= (int)h);
-        uint16_t ty = (uint16_t)((textY < 0) ? 0 : textY);
-        const char* label = labels[i] ? labels[i] : "";
-        const uint32_t itemText = (i == selectedConfigIndex) ? style.text : normalText;
-        if (i == index) {
-            ST7789_FillRect(lcd, listX, yy, listW, hh, style.selBg);
-            if (textVisible) {
-                ST7789_DrawString(lcd, (uint16_t)(listX + 4), ty, label, itemText, style.selBg, SPI_SCREEN_MENU_TEXT_SCALE);
-            }
-        } else {
-            if (textVisible) {
-                ST7789_DrawString(lcd, (uint16_t)(listX + 4), ty, label, itemText, style.bg, SPI_SCREEN_MENU_TEXT_SCALE);
-            }
-        }
-    }
+    ScreenWidget_List(ScreenWidgets_Content(), content_rect(listX, 0, listW, h), labels, count, index, selectedConfigIndex, itemH, (int16_t)offsetPx, style, normalText);
 }
 
 void ScreenDetailRender_Slider(ST7789_Handle* lcd, const char* title, uint8_t value, const ScreenUiStyle& style) {
@@ -70,17 +45,14 @@ void ScreenDetailRender_Slider(ST7789_Handle* lcd, const char* title, uint8_t va
     const uint16_t barH = (uint16_t)(14u * 2u);
     const uint16_t barX = (uint16_t)(listX + 10u);
     const uint16_t barY = (uint16_t)(h / 2u - barH / 2u);
-    const uint16_t fillW = (uint16_t)((barW * (uint16_t)value) / 100u);
-
-    ST7789_FillRect(lcd, listX, 0, listW, h, style.bg);
-    ST7789_DrawString(lcd, barX, (uint16_t)(barY - titleH - 10u), title, style.text, style.bg, titleScale);
+    ScreenWidgetTree* tree = ScreenWidgets_Content();
 
-    ST7789_FillRect(lcd, barX, barY, barW, barH, style.selBg);
-    ST7789_FillRect(lcd, barX, barY, fillW, barH, style.text);
+    ScreenWidget_Label(tree, content_rect(barX, (uint16_t)(barY - titleH - 10u), barW, titleH), title, style.text, style.bg, style.bg, titleScale, SCREEN_ALIGN_LEFT);
+    ScreenWidget_Progress(tree, content_rect(barX, barY, barW, barH), value, 0u, 100u, style.text, style.selBg);
 
     char val[8];
     snprintf(val, sizeof(val), "%u%%", (unsigned)value);
-    ScreenUI_DrawStringCenteredInBox(lcd, listX, (uint16_t)(barY + barH + 8u), listW, valueH, val, style.text, style.bg, valueScale);
+    ScreenWidget_Label(tree, content_rect(listX, (uint16_t)(barY + barH + 8u), listW, valueH), val, style.text, style.bg, style.bg, valueScale, SCREEN_ALIGN_CENTER);
 }
 
 void ScreenDetailRender_Info(ST7789_Handle* lcd, const char* title, const char* text, const ScreenUiStyle& style) {
@@ -90,10 +62,10 @@ void ScreenDetailRender_Info(ST7789_Handle* lcd, const char* title, const char*
     const uint16_t listX = SPI_SCREEN_LEFT_BAR_W;
     const uint16_t listW = (uint16_t)(w - SPI_SCREEN_LEFT_BAR_W - SPI_SCREEN_RIGHT_BAR_W);
     const uint16_t titleH = 20u;
+    ScreenWidgetTree* tree = ScreenWidgets_Content();
 
-    ST7789_FillRect(lcd, listX, 0, listW, h, style.bg);
-    ScreenUI_DrawStringCenteredInBox(lcd, listX, 0, listW, titleH, title, style.text, style.bg, 1);
-    ScreenUI_DrawStringCenteredInBox(lcd, listX, titleH, listW, (uint16_t)(h - titleH), text, style.text, style.bg, SPI_SCREEN_MENU_TEXT_SCALE);
+    ScreenWidget_Label(tree, content_rect(listX, 0, listW, titleH), title, style.text, style.bg, style.bg, 1, SCREEN_ALIGN_CENTER);
+    ScreenWidget_Label(tree, content_rect(listX, titleH, listW, (uint16_t)(h - titleH)), text, style.text, style.bg, style.bg, SPI_SCREEN_MENU_TEXT_SCALE, SCREEN_ALIGN_CENTER);
 }
 
 void ScreenDetailRender_TitleLines(ST7789_Handle* lcd, const char* title, const char* const* lines, uint8_t lineCount, const ScreenUiStyle& style) {
@@ -103,6 +75,7 @@ void ScreenDetailRender_TitleLines(ST7789_Handle* lcd, const char* title, const
     const uint16_t listX = SPI_SCREEN_LEFT_BAR_W;
     const uint16_t listW = (uint16_t)(w - SPI_SCREEN_LEFT_BAR_W - SPI_SCREEN_RIGHT_BAR_W);
     const uint16_t x = (uint16_t)(listX + 8u);
+    const uint16_t textW = (uint16_t)(listW - 8u);
     const uint8_t titleScale = 2u;
     const uint8_t textScale = 1u;
     const uint16_t titleY = 8u;
@@ -110,15 +83,15 @@ void ScreenDetailRender_TitleLines(ST7789_Handle* lcd, const char* title, const
     const uint16_t textStartY = (uint16_t)(titleY + titleH + 10u);
     const uint16_t lineH = ScreenUI_CharCellH(textScale);
     const uint16_t gap = 2u;
+    ScreenWidgetTree* tree = ScreenWidgets_Content();
 
-    ST7789_FillRect(lcd, listX, 0, listW, h, style.bg);
-    ST7789_DrawString(lcd, x, titleY, title ? title : "", style.text, style.bg, titleScale);
+    ScreenWidget_Label(tree, content_rect(x, titleY, textW, titleH), title ? title : "", style.text, style.bg, style.bg, titleScale, SCREEN_ALIGN_LEFT);
 
     uint16_t y = textStartY;
     for (uint8_t i = 0; i < lineCount; i++) {
         if (!lines || !lines[i]) continue;
         if (y + lineH > h) break;
-        ST7789_DrawString(lcd, x, y, lines[i], style.text, style.bg, textScale);
+        ScreenWidget_Label(tree, content_rect(x, y, textW, lineH), lines[i], style.text, style.bg, style.bg, textScale, SCREEN_ALIGN_LEFT);
         y = (uint16_t)(y + lineH + gap);
     }
 }
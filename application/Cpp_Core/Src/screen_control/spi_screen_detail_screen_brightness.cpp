@@ -20,7 +20,7 @@ void ScreenDetailScreenBrightness_Rotate(uint8_t* ioIndex, int8_t det) {
     *ioIndex = clamp_u8_i32(next, 0, 100);
     if (*ioIndex == prev) return;
     STORAGE_MANAGER.config.screenControl.brightness = *ioIndex;
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(CONFIG_SECTION_SCREEN);
 }
 
 void ScreenDetailScreenBrightness_Render(ST7789_Handle* lcd, uint8_t index, const ScreenUiStyle& style) {
@@ -33,5 +33,5 @@ void ScreenDetailScreenBrightness_OnConfirm(uint8_t index) {
     if (restore == 0) restore = 50;
     if (current > 0) STORAGE_MANAGER.config.screenControl.brightness = 0;
     else STORAGE_MANAGER.config.screenControl.brightness = restore;
-    ScreenUI_RequestDeferredSave(2000u);
+    STORAGE_MANAGER.requestSave(CONFIG_SECTION_SCREEN);
 }
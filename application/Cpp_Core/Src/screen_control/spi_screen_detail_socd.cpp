@@ -1,6 +1,7 @@
 #include "screen_control/spi_screen_detail_entries.hpp"
 
 #include "storagemanager.hpp"
+#include "profile_runtime.hpp"
 #include "screen_control/spi_screen_detail_render_helpers.hpp"
 #include "screen_control/spi_screen_timed_popup.hpp"
 
@@ -87,7 +88,10 @@ void ScreenDetailSocd_OnConfirm(uint8_t index) {
         return;
     }
     GamepadProfile* p = default_profile();
-    if (p && index < (uint8_t)NUM_SOCD_MODES) p->keysConfig.socdMode = (SOCDMode)index;
+    if (!p || index >= (uint8_t)NUM_SOCD_MODES) return;
+    p->keysConfig.socdMode = (SOCDMode)index;
+    // 输入按编译好的镜像处理 SOCD，重新编译后下一帧生效
+    PROFILE_RUNTIME.request(*p);
 }
 
 bool ScreenDetailSocd_ShouldExitAfterConfirm(void) {
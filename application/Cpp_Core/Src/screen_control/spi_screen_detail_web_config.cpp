@@ -25,12 +25,12 @@ void ScreenDetailWebConfig_Render(ST7789_Handle* lcd, uint8_t index, const Scree
 void ScreenDetailWebConfig_OnConfirm(uint8_t index) {
     (void)index;
     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-    STORAGE_MANAGER.saveConfig();
+    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
     NVIC_SystemReset();
 }
 
 void ScreenDetailWebConfig_OnBack(void) {
     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-    STORAGE_MANAGER.saveConfig();
+    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
     NVIC_SystemReset();
 }
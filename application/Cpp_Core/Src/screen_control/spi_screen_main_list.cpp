@@ -15,6 +15,7 @@ static const ScreenMenuMeta kMenuMeta[] = {
     {8, SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST, "Screen Brightness"},
     {9, SCREEN_FEATURE_WEB_CONFIG_ENTRY, "Web Config"},
     {10, SCREEN_FEATURE_CALIBRATION_MODE_SWITCH, "Calibration Mode"},
+    {12, SCREEN_FEATURE_INPUT_MONITOR, "Input Monitor"},
 };
 
 const ScreenMenuMeta* ScreenMain_FindMenuMeta(uint8_t id) {
@@ -77,7 +78,8 @@ void ScreenMain_RenderList(ST7789_Handle* lcd,
                            uint32_t animStartMs,
                            uint32_t nowMs) {
     if (!lcd || !menuIds || menuCount == 0) return;
-    const char* labels[32] = {0};
+    // 列表控件在 ScreenWidgetTree_End 时才绘制，文字指针需要活到那时
+    static const char* labels[32] = {0};
     uint8_t renderCount = menuCount;
     if (renderCount > (uint8_t)(sizeof(labels) / sizeof(labels[0]))) renderCount = (uint8_t)(sizeof(labels) / sizeof(labels[0]));
     for (uint8_t i = 0; i < renderCount; i++) {
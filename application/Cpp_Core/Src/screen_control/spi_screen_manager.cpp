@@ -13,6 +13,7 @@
 #include "screen_control/spi_screen_detail_entries.hpp"
 #include "screen_control/spi_screen_detail_pages.hpp"
 #include "screen_control/spi_screen_standby.hpp"
+#include "screen_control/spi_screen_widgets.hpp"
 #include "adc_btns/adc_calibration.hpp"
 #include "adc_btns/adc_manager.hpp"
 #include "adc_btns/adc_btns_worker.hpp"
@@ -43,8 +44,6 @@ static bool g_firstDrawPending = true;
 static bool g_inDetail = false;
 static uint8_t g_detailMenuId = 0;
 static uint8_t g_detailIndex = 0;
-static bool g_deferredSavePending = false;
-static uint32_t g_deferredSaveDueMs = 0;
 static uint32_t g_bl_boot_ms = 0;
 static bool g_bl_ramp_active = false;
 static bool g_menu_full_refresh_pending = false;
@@ -57,15 +56,89 @@ static uint64_t g_perfAccFlushUs = 0;
 static uint32_t g_perfCalls = 0;
 static uint32_t g_perfFrames = 0;
 static uint32_t g_perfBlocked = 0;
+static uint32_t g_perfTotalFrames = 0;
+static uint32_t g_perfTotalBlocked = 0;
+static SPIScreenPerf g_perfLast = {0, 0, 0, 0, 0};
+// 左右状态栏的控件树，内容区使用 ScreenWidgets_Content()
+static ScreenWidgetSlot g_leftBarSlots[2];
+static ScreenWidgetSlot g_rightBarSlots[3];
+static ScreenWidgetTree g_leftBarTree;
+static ScreenWidgetTree g_rightBarTree;
+// 按需出帧：只有界面状态可能变化时才进入 FrameBegin，空闲时 loop 只做几次比较
+static bool g_frameRequested = true;     // 下一次 loop 无条件出帧
+static bool g_frameContinuous = false;   // 动画进行中，按动画帧率连续出帧
+static bool g_nextDuePending = false;    // 最近的定时事件（弹窗关闭、延迟保存、进入待机等）
+static uint32_t g_nextDueMs = 0;
+static bool g_frameAtPending = false;    // 页面通过 ScreenUI_RequestFrameAt 登记的时间点
+static uint32_t g_frameAtMs = 0;
+static uint32_t g_seenConfigRevision = 0;
+static uint32_t g_seenInputMask = 0;
+static uint32_t g_lastActivityMs = 0;
+static bool g_dimmed = false;
+static bool g_playBlanked = false;       // 比赛游戏中熄屏：背光关闭，loop 只检查旋钮
+static uint8_t g_blApplied = 0xFF;
+static uint32_t g_perfIdle = 0;
+
+#ifndef SPI_SCREEN_PERF_LOG_INTERVAL_MS
+#define SPI_SCREEN_PERF_LOG_INTERVAL_MS 5000u
+#endif
+
+// 有输入或配置变化时的帧率上限
+#ifndef SPI_SCREEN_FPS_INTERACTIVE
+#define SPI_SCREEN_FPS_INTERACTIVE ST7789_DEFAULT_FPS
+#endif
+
+// 动画、惯性滚动等短间隔定时刷新时的帧率上限
+#ifndef SPI_SCREEN_FPS_ANIM
+#define SPI_SCREEN_FPS_ANIM 30u
+#endif
+
+// 无旋钮、按键和配置变化超过此时间后降低背光，0 表示不降低
+#ifndef SPI_SCREEN_IDLE_DIM_MS
+#define SPI_SCREEN_IDLE_DIM_MS 30000u
+#endif
+
+// 降低后的背光相对配置亮度的百分比
+#ifndef SPI_SCREEN_IDLE_DIM_PERCENT
+#define SPI_SCREEN_IDLE_DIM_PERCENT 30u
+#endif
 
 static bool ok_flash_active(void) {
     return (uint32_t)(HAL_GetTick() - g_okFlashUntilMs) > 0x80000000u ? false : (HAL_GetTick() < g_okFlashUntilMs);
 }
 
+static void invalidate_widgets(void) {
+    ScreenWidgetTree_Invalidate(&g_leftBarTree);
+    ScreenWidgetTree_Invalidate(&g_rightBarTree);
+    ScreenWidgetTree_Invalidate(ScreenWidgets_Content());
+}
+
 static bool tick_expired(uint32_t now, uint32_t due) {
     return (int32_t)(now - due) >= 0;
 }
 
+// 每个统计周期输出一次各阶段平均耗时
+static void perf_report(uint32_t nowMs) {
+    if (!tick_expired(nowMs, g_perfLastMs + SPI_SCREEN_PERF_LOG_INTERVAL_MS)) return;
+    if (g_perfFrames > 0u) {
+        LOG_DEBUG("SCREEN", "perf calls=%lu idle=%lu frames=%lu blocked=%lu avg us: pre=%lu begin=%lu prep=%lu render=%lu flush=%lu",
+            (unsigned long)g_perfCalls, (unsigned long)g_perfIdle, (unsigned long)g_perfFrames, (unsigned long)g_perfBlocked,
+            (unsigned long)(g_perfAccPreUs / g_perfCalls), (unsigned long)(g_perfAccFrameBeginUs / g_perfCalls),
+            (unsigned long)(g_perfAccPrepUs / g_perfFrames), (unsigned long)(g_perfAccRenderUs / g_perfFrames),
+            (unsigned long)(g_perfAccFlushUs / g_perfFrames));
+    }
+    g_perfLastMs = nowMs;
+    g_perfAccPreUs = 0;
+    g_perfAccFrameBeginUs = 0;
+    g_perfAccPrepUs = 0;
+    g_perfAccRenderUs = 0;
+    g_perfAccFlushUs = 0;
+    g_perfCalls = 0;
+    g_perfIdle = 0;
+    g_perfFrames = 0;
+    g_perfBlocked = 0;
+}
+
 static inline void bkp_write(uint32_t idx, uint32_t val) {
     volatile uint32_t* base = &RTC->BKP0R;
     base[idx] = val;
@@ -83,9 +156,11 @@ void ScreenUI_RequestRebootTo(uint8_t menuId, uint8_t index) {
     NVIC_SystemReset();
 }
 
-void ScreenUI_RequestDeferredSave(uint32_t delayMs) {
-    g_deferredSavePending = true;
-    g_deferredSaveDueMs = HAL_GetTick() + delayMs;
+void ScreenUI_RequestFrameAt(uint32_t dueMs) {
+    if (!g_frameAtPending || (int32_t)(dueMs - g_frameAtMs) < 0) {
+        g_frameAtMs = dueMs;
+    }
+    g_frameAtPending = true;
 }
 
 static uint8_t clamp_brightness(uint8_t v) {
@@ -101,6 +176,7 @@ static uint8_t clamp_brightness(uint8_t v) {
 #endif
 
 static uint8_t compute_backlight_percent(uint32_t nowMs) {
+    if (g_dimmed) return (uint8_t)(((uint32_t)g_cfgBrightness * SPI_SCREEN_IDLE_DIM_PERCENT) / 100u);
     if (!g_bl_ramp_active) return g_cfgBrightness;
     uint32_t elapsed = nowMs - g_bl_boot_ms;
     if (elapsed < SPI_SCREEN_BL_INIT_HOLD_MS) return 0u;
@@ -113,10 +189,107 @@ static uint8_t compute_backlight_percent(uint32_t nowMs) {
     return (uint8_t)(((uint32_t)g_cfgBrightness * elapsed) / SPI_SCREEN_BL_RAMP_MS);
 }
 
+static void apply_backlight(uint8_t percent) {
+    if (percent == g_blApplied) return;
+    g_blApplied = percent;
+    ST7789_SetBacklight(&g_lcd, percent);
+}
+
 static uint32_t get_gamepad_activity_mask() {
     return GPIO_BTNS_WORKER.getVirtualPinMask() | ADC_BTNS_WORKER.getVirtualPinMask();
 }
 
+// 比赛配置文件下开启“游戏中关闭屏幕”时，开始游戏即熄屏
+static bool play_blank_enabled(void) {
+    if (!STORAGE_MANAGER.config.screenControl.tournamentScreenOff) return false;
+    if (STORAGE_MANAGER.getBootMode() != BootMode::BOOT_MODE_INPUT) return false;
+    const GamepadProfile* p = STORAGE_MANAGER.getDefaultGamepadProfile();
+    return p && p->isCompetitionProfile;
+}
+
+static void due_consider(uint32_t dueMs) {
+    if (!g_nextDuePending || (int32_t)(dueMs - g_nextDueMs) < 0) {
+        g_nextDueMs = dueMs;
+    }
+    g_nextDuePending = true;
+}
+
+/**
+ * @brief 空闲时判断本次 loop 是否需要出帧
+ * 只读取旋钮中断累计值、配置版本号、按键位图和最近的定时事件，不做任何绘制
+ */
+static bool frame_wanted(uint32_t nowMs) {
+    if (g_frameRequested || g_frameContinuous) return true;
+    if (RotEnc_HasPendingInput()) return true;
+    if (STORAGE_MANAGER.getConfigRevision() != g_seenConfigRevision) return true;
+    uint32_t inputMask = get_gamepad_activity_mask();
+    if (inputMask != g_seenInputMask) {
+        g_seenInputMask = inputMask;
+        g_lastActivityMs = nowMs;
+        // 待机计时只需更新时间戳，按键布局待机画面才需要重画
+        ScreenStandby_NotifyInput(nowMs, inputMask, true, false);
+        // 位图已记录，FrameBegin 暂时被拒绝时靠 g_frameRequested 保证稍后出帧
+        if (g_dimmed || ScreenStandby_NeedsRender() || (inputMask != 0u && play_blank_enabled())) {
+            g_frameRequested = true;
+            return true;
+        }
+    }
+    return g_nextDuePending && tick_expired(nowMs, g_nextDueMs);
+}
+
+/**
+ * @brief 一帧结束后安排下一帧：有动画时连续出帧，否则只登记最近的定时事件
+ */
+static void schedule_next_frame(uint32_t nowMs, bool animating, bool standbyAllowed) {
+    g_nextDuePending = false;
+    if (g_frameAtPending) due_consider(g_frameAtMs);
+    if (ok_flash_active()) due_consider(g_okFlashUntilMs);
+    if (!g_dimmed && SPI_SCREEN_IDLE_DIM_MS != 0u) due_consider(g_lastActivityMs + SPI_SCREEN_IDLE_DIM_MS);
+    uint32_t standbyDueMs = 0;
+    if (standbyAllowed && ScreenStandby_NextEventMs(&standbyDueMs)) due_consider(standbyDueMs);
+
+    // 定时事件间隔小于交互帧间隔时（惯性补步、动画）提高帧率，保证时间点准确
+    const uint32_t interactiveIntervalMs = 1000u / (uint32_t)SPI_SCREEN_FPS_INTERACTIVE;
+    bool dueSoon = g_nextDuePending && (int32_t)(g_nextDueMs - nowMs) <= (int32_t)interactiveIntervalMs;
+    g_frameContinuous = animating;
+    ST7789_SetFrameRate(&g_lcd, (animating || dueSoon) ? SPI_SCREEN_FPS_ANIM : SPI_SCREEN_FPS_INTERACTIVE);
+}
+
+static void enter_play_blank(void) {
+    ScreenStandby_Deactivate();
+    apply_backlight(0u);
+    g_playBlanked = true;
+    g_frameContinuous = false;
+    g_nextDuePending = false;
+}
+
+/**
+ * @brief 熄屏期间只检查旋钮：转动或按下旋钮唤醒（本次输入只用于唤醒），
+ * 关闭选项或切换到非比赛配置文件也会恢复显示
+ */
+static bool play_blank_poll(uint32_t nowMs) {
+    bool wake = false;
+    if (RotEnc_HasPendingInput()) {
+        RotEnc_Update();
+        int8_t det = RotEnc_GetDetentDelta();
+        bool clicked = RotEnc_WasButtonClicked();
+        bool longPressed = RotEnc_WasButtonLongPressed();
+        wake = (det != 0) || clicked || longPressed;
+    }
+    if (!wake && STORAGE_MANAGER.getConfigRevision() != g_seenConfigRevision) {
+        g_seenConfigRevision = STORAGE_MANAGER.getConfigRevision();
+        wake = !play_blank_enabled();
+    }
+    if (!wake) return false;
+    g_playBlanked = false;
+    g_dimmed = false;
+    g_lastActivityMs = nowMs;
+    g_menu_full_refresh_pending = true;
+    g_frameRequested = true;
+    ScreenStandby_NotifyInput(nowMs, get_gamepad_activity_mask(), true, false);
+    return true;
+}
+
 static void refresh_screen_cfg_cache(void) {
     const ScreenControlConfig& sc = STORAGE_MANAGER.config.screenControl;
 
@@ -177,7 +350,7 @@ void SPIScreenManager::setup() {
     cfg.color_mode = ST7789_COLOR_MODE_RGB565;
     cfg.rotation = ST7789_ROTATION_270;
     cfg.invert = true;
-    cfg.fps = 12;
+    cfg.fps = SPI_SCREEN_FPS_INTERACTIVE;
     cfg.use_framebuffer = true;
     // cfg.bl_htim = NULL;
     // cfg.bl_tim_channel = 0;
@@ -186,13 +359,19 @@ void SPIScreenManager::setup() {
     g_inited = true;
     g_okFlashUntilMs = 0;
     g_firstDrawPending = true;
+    g_frameRequested = true;
+    g_seenConfigRevision = STORAGE_MANAGER.getConfigRevision();
+    g_lastActivityMs = HAL_GetTick();
+    ScreenWidgetTree_Init(&g_leftBarTree, g_leftBarSlots, (uint8_t)(sizeof(g_leftBarSlots) / sizeof(g_leftBarSlots[0])));
+    ScreenWidgetTree_Init(&g_rightBarTree, g_rightBarSlots, (uint8_t)(sizeof(g_rightBarSlots) / sizeof(g_rightBarSlots[0])));
     RotEnc_Init();
 
     refresh_screen_cfg_cache();
     g_bl_boot_ms = HAL_GetTick();
     g_bl_ramp_active = true;
-    ST7789_SetBacklight(&g_lcd, 0);
-    ScreenStandby_Init(HAL_GetTick(), get_gamepad_activity_mask());
+    apply_backlight(0u);
+    g_seenInputMask = get_gamepad_activity_mask();
+    ScreenStandby_Init(HAL_GetTick(), g_seenInputMask);
     ScreenStandby_Configure(g_cfgStandbyDisplay, g_cfgBackgroundImageId, g_cfgBg, g_cfgText);
     rebuildMenu();
     {
@@ -279,12 +458,12 @@ void SPIScreenManager::handleInput(uint32_t nowMs, int8_t det, bool clicked, boo
                 uint8_t id = menuIds[menuIndex];
                 if (id == 9u) {
                     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_WEB_CONFIG);
-                    STORAGE_MANAGER.saveConfig();
+                    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
                     NVIC_SystemReset();
                 } else if (id == 10u) {
                     ADC_CALIBRATION_MANAGER.resetAllCalibration();
                     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_CALIBRATION);
-                    STORAGE_MANAGER.saveConfig();
+                    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
                     NVIC_SystemReset();
                 } else {
                     enter_detail(id);
@@ -297,7 +476,7 @@ void SPIScreenManager::handleInput(uint32_t nowMs, int8_t det, bool clicked, boo
         if (g_inDetail) {
             if (g_detailMenuId == 9u || g_detailMenuId == 10u) {
                 STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-                STORAGE_MANAGER.saveConfig();
+                STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
                 NVIC_SystemReset();
             } else if (g_detailMenuId == 11u) {
                 if (!ScreenDetailButtonsPerformance_OnBack()) {
@@ -310,14 +489,40 @@ void SPIScreenManager::handleInput(uint32_t nowMs, int8_t det, bool clicked, boo
     }
 }
 
+const SPIScreenPerf& SPIScreenManager::getLastFramePerf(uint32_t* frames, uint32_t* blocked) const {
+    if (frames) *frames = g_perfTotalFrames;
+    if (blocked) *blocked = g_perfTotalBlocked;
+    return g_perfLast;
+}
+
 void SPIScreenManager::loop() {
     if (!g_inited) return;
+    uint32_t t0 = MICROS_TIMER.micros();
     SPIST7789_Service();
+    // GIF 按自己的帧延时解码和刷新，不受屏幕帧率限制
+    ST7789_GIF_Service();
+    uint32_t nowMs = HAL_GetTick();
+    if (g_playBlanked && !play_blank_poll(nowMs)) return;
+    if (!frame_wanted(nowMs)) {
+        g_perfIdle++;
+        return;
+    }
+    uint32_t t1 = MICROS_TIMER.micros();
     bool frameOk = ST7789_FrameBegin(&g_lcd);
-    if (!frameOk) return;
+    uint32_t t2 = MICROS_TIMER.micros();
+    g_perfCalls++;
+    g_perfAccPreUs += (uint32_t)(t1 - t0);
+    g_perfAccFrameBeginUs += (uint32_t)(t2 - t1);
+    if (!frameOk) {
+        g_perfBlocked++;
+        g_perfTotalBlocked++;
+        return;
+    }
 
+    g_frameRequested = false;
+    g_frameAtPending = false;
     RotEnc_Update();
-    uint32_t nowMs = HAL_GetTick();
+    nowMs = HAL_GetTick();
     int8_t det = RotEnc_GetDetentDelta();
     bool clicked = RotEnc_WasButtonClicked();
     bool longPressed = RotEnc_WasButtonLongPressed();
@@ -330,6 +535,18 @@ void SPIScreenManager::loop() {
     bool standbyWasActive = ScreenStandby_IsActive();
     bool encoderEvent = (det != 0) || clicked || longPressed;
     bool anyActivity = encoderEvent || (inputMask != 0u);
+    bool configChanged = STORAGE_MANAGER.getConfigRevision() != g_seenConfigRevision;
+    g_seenConfigRevision = STORAGE_MANAGER.getConfigRevision();
+    g_seenInputMask = inputMask;
+    if (anyActivity || configChanged) {
+        g_lastActivityMs = nowMs;
+    }
+    g_dimmed = SPI_SCREEN_IDLE_DIM_MS != 0u && tick_expired(nowMs, g_lastActivityMs + SPI_SCREEN_IDLE_DIM_MS);
+    if (inputMask != 0u && play_blank_enabled()) {
+        enter_play_blank();
+        ST7789_FrameEnd(&g_lcd);
+        return;
+    }
     if (!standbyAllowed) {
         if (ScreenStandby_Deactivate()) {
             g_menu_full_refresh_pending = true;
@@ -360,40 +577,50 @@ void SPIScreenManager::loop() {
         g_menuCfgDirty = false;
     }
 
-    if (g_deferredSavePending && tick_expired(nowMs, g_deferredSaveDueMs)) {
-        STORAGE_MANAGER.saveConfig();
-        g_deferredSavePending = false;
-    }
-
     if (g_firstDrawPending) {
         ST7789_FillScreen(&g_lcd, g_cfgBg);
-        g_lcd.dirty_valid = true;
-        g_lcd.dirty_x0 = 0;
-        g_lcd.dirty_y0 = 0;
-        g_lcd.dirty_x1 = (uint16_t)(ST7789_WIDTH - 1u);
-        g_lcd.dirty_y1 = (uint16_t)(ST7789_HEIGHT - 1u);
+        ST7789_InvalidateAll(&g_lcd);
+        invalidate_widgets();
         g_firstDrawPending = false;
     }
     if (g_menu_full_refresh_pending && !standbyNowActive) {
         ST7789_FillScreen(&g_lcd, g_cfgBg);
-        g_lcd.dirty_valid = true;
-        g_lcd.dirty_x0 = 0;
-        g_lcd.dirty_y0 = 0;
-        g_lcd.dirty_x1 = (uint16_t)(ST7789_WIDTH - 1u);
-        g_lcd.dirty_y1 = (uint16_t)(ST7789_HEIGHT - 1u);
+        ST7789_InvalidateAll(&g_lcd);
+        invalidate_widgets();
         g_menu_full_refresh_pending = false;
     }
-    ST7789_SetBacklight(&g_lcd, compute_backlight_percent(nowMs));
+    apply_backlight(compute_backlight_percent(nowMs));
+    uint32_t t3 = MICROS_TIMER.micros();
     if (standbyNowActive) {
         ScreenStandby_Render(&g_lcd, inputMask);
     } else {
         renderFrame();
     }
+    uint32_t t4 = MICROS_TIMER.micros();
     ST7789_FrameEnd(&g_lcd);
+    uint32_t t5 = MICROS_TIMER.micros();
+    schedule_next_frame(nowMs, g_bl_ramp_active || animActive, standbyAllowed);
+
+    g_perfLast.preUs = (uint32_t)(t1 - t0);
+    g_perfLast.frameBeginUs = (uint32_t)(t2 - t1);
+    g_perfLast.prepUs = (uint32_t)(t3 - t2);
+    g_perfLast.renderUs = (uint32_t)(t4 - t3);
+    g_perfLast.flushUs = (uint32_t)(t5 - t4);
+    g_perfAccPrepUs += g_perfLast.prepUs;
+    g_perfAccRenderUs += g_perfLast.renderUs;
+    g_perfAccFlushUs += g_perfLast.flushUs;
+    g_perfFrames++;
+    g_perfTotalFrames++;
+    perf_report(nowMs);
 }
 
 void SPIScreenManager::renderFrame() {
     renderBars();
+    // 内容区按页面标识重建控件树，页面切换时整块清空
+    const uint32_t pageKey = g_inDetail ? (0x100u | g_detailMenuId) : 0u;
+    const ScreenWidgetRect contentArea = {SPI_SCREEN_LEFT_BAR_W, 0, (uint16_t)(ST7789_WIDTH - SPI_SCREEN_LEFT_BAR_W - SPI_SCREEN_RIGHT_BAR_W), ST7789_HEIGHT};
+    ScreenWidgetTree* content = ScreenWidgets_Content();
+    ScreenWidgetTree_Begin(content, &g_lcd, contentArea, pageKey, g_cfgBg);
     if (g_inDetail) {
         ScreenUiStyle style = {g_cfgBg, g_cfgText, g_cfgSelBg, g_cfgOkBg};
         ScreenDetail_Render(&g_lcd, g_detailMenuId, g_detailIndex, style);
@@ -401,6 +628,7 @@ void SPIScreenManager::renderFrame() {
         ScreenUiStyle style = {g_cfgBg, g_cfgText, g_cfgSelBg, g_cfgOkBg};
         ScreenMain_RenderList(&g_lcd, style, menuIds, menuCount, menuIndex, false, 0, 0u, HAL_GetTick());
     }
+    ScreenWidgetTree_End(content);
 }
 
 void SPIScreenManager::renderBars() {
@@ -412,8 +640,10 @@ void SPIScreenManager::renderBars() {
     const uint32_t barBg = g_cfgBg;
     const uint32_t textColor = g_cfgText;
 
-    ST7789_FillRect(&g_lcd, 0, 0, leftW, h, barBg);
-    ST7789_FillRect(&g_lcd, rightX, 0, rightW, h, barBg);
+    const ScreenWidgetRect leftArea = {0, 0, leftW, h};
+    const ScreenWidgetRect rightArea = {rightX, 0, rightW, h};
+    ScreenWidgetTree_Begin(&g_leftBarTree, &g_lcd, leftArea, 0u, barBg);
+    ScreenWidgetTree_Begin(&g_rightBarTree, &g_lcd, rightArea, 0u, barBg);
 
     const char* mode = ScreenMain_InputModeAbbrev(STORAGE_MANAGER.getInputMode());
 
@@ -445,15 +675,19 @@ void SPIScreenManager::renderBars() {
 
     char token[6] = "P?";
     if (currentProfileIdx != 0xFF) snprintf(token, sizeof(token), "P%u", (unsigned)(currentProfileIdx + 1u));
-    ScreenUI_DrawStringCenteredInBox(&g_lcd, 0, startY, leftW, tokenH, token, textColor, barBg, tokenScale);
-    ScreenUI_DrawStringCenteredInBox(&g_lcd, 0, (uint16_t)(startY + tokenH + profileModeGap), leftW, tokenH, mode, textColor, barBg, tokenScale);
+    const ScreenWidgetRect tokenRect = {0, startY, leftW, tokenH};
+    const ScreenWidgetRect modeRect = {0, (uint16_t)(startY + tokenH + profileModeGap), leftW, tokenH};
+    ScreenWidget_Label(&g_leftBarTree, tokenRect, token, textColor, barBg, barBg, tokenScale, SCREEN_ALIGN_CENTER);
+    ScreenWidget_Label(&g_leftBarTree, modeRect, mode, textColor, barBg, barBg, tokenScale, SCREEN_ALIGN_CENTER);
 
-    if (g_inDetail) ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, topY, rightW, areaH, "Back", textColor, barBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
-    else if (prev && prev->label) ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, topY, rightW, areaH, prev->label, textColor, barBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
+    const char* topLabel = "";
+    if (g_inDetail) topLabel = "Back";
+    else if (prev && prev->label) topLabel = prev->label;
 
     const uint32_t okBg = ok_flash_active() ? g_cfgOkBg : barBg;
+    const char* midLabel = "OK";
     if (g_inDetail && (g_detailMenuId == 9 || g_detailMenuId == 10)) {
-        ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, midY, rightW, areaH, "Quit", textColor, okBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
+        midLabel = "Quit";
     } else if (g_inDetail && (g_detailMenuId == 4 || g_detailMenuId == 6 || g_detailMenuId == 8)) {
         bool on = false;
         if (g_detailMenuId == 4) {
@@ -465,12 +699,18 @@ void SPIScreenManager::renderBars() {
         } else if (g_detailMenuId == 8) {
             on = STORAGE_MANAGER.config.screenControl.brightness > 0;
         }
-
-        const char* label = on ? "OFF" : "ON";
-        ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, midY, rightW, areaH, label, textColor, okBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
-    } else {
-        ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, midY, rightW, areaH, "OK", textColor, okBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
+        midLabel = on ? "OFF" : "ON";
     }
 
-    if (!g_inDetail && next && next->label) ScreenUI_DrawStringCenteredInBox(&g_lcd, rightX, botY, rightW, botH, next->label, textColor, barBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE);
+    const char* botLabel = (!g_inDetail && next && next->label) ? next->label : "";
+
+    const ScreenWidgetRect topRect = {rightX, topY, rightW, areaH};
+    const ScreenWidgetRect midRect = {rightX, midY, rightW, areaH};
+    const ScreenWidgetRect botRect = {rightX, botY, rightW, botH};
+    ScreenWidget_Label(&g_rightBarTree, topRect, topLabel, textColor, barBg, barBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE, SCREEN_ALIGN_CENTER);
+    ScreenWidget_Label(&g_rightBarTree, midRect, midLabel, textColor, barBg, okBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE, SCREEN_ALIGN_CENTER);
+    ScreenWidget_Label(&g_rightBarTree, botRect, botLabel, textColor, barBg, barBg, SPI_SCREEN_STATUS_BAR_TEXT_SCALE, SCREEN_ALIGN_CENTER);
+
+    ScreenWidgetTree_End(&g_leftBarTree);
+    ScreenWidgetTree_End(&g_rightBarTree);
 }
@@ -26,6 +26,7 @@ static uint8_t g_image_kind = 0;
 static const uint8_t* g_image_pixels = nullptr;
 static uint16_t g_image_w = 0;
 static uint16_t g_image_h = 0;
+static ST7789_AssetInfo g_himg_info;
 static uint8_t g_anim_frame_count = 1;
 static uint8_t g_anim_fps = 0;
 static uint32_t g_anim_frame_size = 0;
@@ -36,7 +37,8 @@ static uint32_t g_anim_next_ms = 0;
 enum : uint8_t {
     STANDBY_IMAGE_NONE = 0u,
     STANDBY_IMAGE_HIMG_RGB565 = 1u,
-    STANDBY_IMAGE_UIMG = 2u
+    STANDBY_IMAGE_UIMG = 2u,
+    STANDBY_IMAGE_HIMG_GIF = 3u
 };
 
 static const uint32_t UIMG_MAGIC = 0x474D4955u;
@@ -92,16 +94,9 @@ static bool tick_reached(uint32_t nowMs, uint32_t targetMs)
     return (int32_t)(nowMs - targetMs) >= 0;
 }
 
-static bool ensure_qspi_mmap(void)
-{
-    if (QSPI_W25Qxx_IsMemoryMappedMode()) return true;
-    int8_t r = QSPI_W25Qxx_EnterMemoryMappedMode();
-    if (r != QSPI_W25Qxx_OK) return false;
-    return QSPI_W25Qxx_IsMemoryMappedMode();
-}
-
 static void reset_image_runtime(void)
 {
+    ST7789_GIF_Stop();
     g_image_source_ready = false;
     g_image_source_valid = false;
     g_image_kind = STANDBY_IMAGE_NONE;
@@ -223,9 +218,23 @@ static bool resolve_himg_source(const char* imageId)
     ST7789_AssetInfo info;
     memset(&info, 0, sizeof(info));
     if (!ST7789_Assets_Find(imageId, &info)) return false;
-    if (info.type != ST7789_ASSET_TYPE_RGB565LE) return false;
+    if (info.type == ST7789_ASSET_TYPE_GIF) {
+        if (!info.data || info.size == 0u) return false;
+        uint16_t w = info.width, h = info.height;
+        if ((w == 0u || h == 0u) && !ST7789_GIF_GetCanvasSize((const uint8_t*)info.data, (size_t)info.size, &w, &h)) return false;
+        g_image_kind = STANDBY_IMAGE_HIMG_GIF;
+        g_image_pixels = (const uint8_t*)info.data;
+        g_image_w = w;
+        g_image_h = h;
+        g_anim_frame_count = 1u;
+        g_anim_fps = 0u;
+        g_anim_frame_size = info.size;
+        return true;
+    }
+    if (info.type != ST7789_ASSET_TYPE_RGB565LE && info.type != ST7789_ASSET_TYPE_RGB565LE_PACKED) return false;
     if (!info.data || info.width == 0u || info.height == 0u) return false;
 
+    g_himg_info = info;
     g_image_kind = STANDBY_IMAGE_HIMG_RGB565;
     g_image_pixels = (const uint8_t*)info.data;
     g_image_w = info.width;
@@ -236,6 +245,16 @@ static bool resolve_himg_source(const char* imageId)
     return true;
 }
 
+static void resolve_image_source(void* context)
+{
+    (void)context;
+    if (!g_image_source_ready || g_image_source_valid) return;
+    if (resolve_uimg_source(g_bg_image_id) || resolve_himg_source(g_bg_image_id)) {
+        g_image_source_valid = true;
+        g_need_redraw = true;
+    }
+}
+
 static void ensure_image_source(void)
 {
     if (g_image_source_ready) return;
@@ -249,17 +268,8 @@ static void ensure_image_source(void)
     g_anim_fps = 0u;
     g_anim_frame_size = 0u;
     memset(g_anim_frame_offsets, 0, sizeof(g_anim_frame_offsets));
-    if (!ensure_qspi_mmap()) {
-        return;
-    }
-
-    if (resolve_uimg_source(g_bg_image_id)) {
-        g_image_source_valid = true;
-        return;
-    }
-    if (resolve_himg_source(g_bg_image_id)) {
-        g_image_source_valid = true;
-    }
+    // 图片头直接从映射区读取；QSPI 正在擦写时推迟到恢复映射之后
+    QSPI_W25Qxx_RunWhenMapped(resolve_image_source, nullptr);
 }
 
 static void draw_image_frame(ST7789_Handle* lcd, uint8_t frameIndex)
@@ -275,7 +285,13 @@ static void draw_image_frame(ST7789_Handle* lcd, uint8_t frameIndex)
 
     if (g_image_kind == STANDBY_IMAGE_HIMG_RGB565) {
         if (!g_image_pixels) return;
-        ST7789_DrawBitmap(lcd, x, y, g_image_w, g_image_h, g_image_pixels, ST7789_BITMAP_RGB565_LE, (uint32_t)g_image_w * 2u);
+        (void)ST7789_Assets_DrawInfo(lcd, x, y, &g_himg_info, g_bg);
+        return;
+    }
+    if (g_image_kind == STANDBY_IMAGE_HIMG_GIF) {
+        // 由 ST7789_GIF_Service 在主循环中逐帧解码显示
+        if (!g_image_pixels) return;
+        (void)ST7789_GIF_Start(lcd, x, y, g_image_pixels, (size_t)g_anim_frame_size, g_bg, ST7789_GIF_REPEAT_FOREVER);
         return;
     }
     if (g_image_kind == STANDBY_IMAGE_UIMG) {
@@ -328,6 +344,7 @@ void ScreenStandby_Configure(uint8_t standbyDisplay, const char* backgroundImage
     if (g_display != standbyDisplay) {
         g_display = standbyDisplay;
         g_need_redraw = true;
+        ST7789_GIF_Stop();
     }
     if (strncmp(g_bg_image_id, backgroundImageId ? backgroundImageId : "", sizeof(g_bg_image_id)) != 0) {
         memset(g_bg_image_id, 0, sizeof(g_bg_image_id));
@@ -341,6 +358,7 @@ void ScreenStandby_Configure(uint8_t standbyDisplay, const char* backgroundImage
         g_bg = bgRgb888;
         g_fg = fgRgb888;
         g_need_redraw = true;
+        ST7789_GIF_Stop();
     }
 }
 
@@ -360,6 +378,7 @@ void ScreenStandby_NotifyInput(uint32_t nowMs, uint32_t inputMask, bool activity
     if (g_active && wakeEvent) {
         g_active = false;
         g_need_redraw = true;
+        ST7789_GIF_Stop();
     }
 }
 
@@ -372,6 +391,25 @@ void ScreenStandby_Tick(uint32_t nowMs)
     g_need_redraw = true;
 }
 
+bool ScreenStandby_NeedsRender(void)
+{
+    return g_active && g_need_redraw;
+}
+
+bool ScreenStandby_NextEventMs(uint32_t* outDueMs)
+{
+    if (!outDueMs) return false;
+    if (!g_active) {
+        if (g_display == 0u) return false;
+        *outDueMs = g_last_activity_ms + SPI_SCREEN_STANDBY_TIMEOUT_MS;
+        return true;
+    }
+    bool animated = g_image_source_valid && g_image_kind == STANDBY_IMAGE_UIMG && g_anim_frame_count > 1u && g_anim_fps > 0u;
+    if (g_display != 1u || !animated) return false;
+    *outDueMs = g_anim_next_ms;
+    return true;
+}
+
 bool ScreenStandby_IsActive(void)
 {
     return g_active;
@@ -384,6 +422,7 @@ bool ScreenStandby_Deactivate(void)
     g_need_redraw = true;
     g_anim_frame_index = 0u;
     g_anim_next_ms = 0u;
+    ST7789_GIF_Stop();
     return true;
 }
 
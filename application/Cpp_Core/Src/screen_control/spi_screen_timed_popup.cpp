@@ -1,6 +1,8 @@
 #include "screen_control/spi_screen_timed_popup.hpp"
 
+#include "screen_control/spi_screen_detail_entries.hpp"
 #include "screen_control/spi_screen_ui_common.hpp"
+#include "screen_control/spi_screen_widgets.hpp"
 
 static bool tick_reached(uint32_t nowMs, uint32_t targetMs) {
     return (int32_t)(nowMs - targetMs) >= 0;
@@ -33,7 +35,10 @@ void ScreenTimedPopup_Update(ScreenTimedPopup* popup, uint32_t nowMs) {
     if (!popup || !popup->visible) return;
     if (tick_reached(nowMs, popup->closeAtMs)) {
         popup->visible = false;
+        return;
     }
+    // 屏幕空闲时不再逐帧刷新，需要在关闭时刻补一帧
+    ScreenUI_RequestFrameAt(popup->closeAtMs);
 }
 
 bool ScreenTimedPopup_IsVisible(const ScreenTimedPopup* popup) {
@@ -60,13 +65,15 @@ void ScreenTimedPopup_Render(const ScreenTimedPopup* popup, ST7789_Handle* lcd,
     const uint16_t startY = (blockH < h) ? (uint16_t)((h - blockH) / 2u) : 0u;
     const uint32_t mutedText = ScreenUI_MutedTextForBg(style.text, style.bg, 96u);
 
-    ST7789_FillRect(lcd, listX, 0, listW, h, style.bg);
-    ScreenUI_DrawStringCenteredInBox(lcd, listX, startY, listW, titleH, popup->title ? popup->title : "", style.text, style.bg, titleScale);
+    ScreenWidgetTree* tree = ScreenWidgets_Content();
+    ScreenWidgetRect titleRect = {listX, startY, listW, titleH};
+    ScreenWidget_Label(tree, titleRect, popup->title ? popup->title : "", style.text, style.bg, style.bg, titleScale, SCREEN_ALIGN_CENTER);
 
     uint16_t y = (uint16_t)(startY + titleH + titleGap);
     for (uint8_t i = 0; i < popup->lineCount; i++) {
         const char* line = (popup->lines && popup->lines[i]) ? popup->lines[i] : "";
-        ScreenUI_DrawStringCenteredInBox(lcd, listX, y, listW, lineH, line, mutedText, style.bg, textScale);
+        ScreenWidgetRect lineRect = {listX, y, listW, lineH};
+        ScreenWidget_Label(tree, lineRect, line, mutedText, style.bg, style.bg, textScale, SCREEN_ALIGN_CENTER);
         y = (uint16_t)(y + lineH + lineGap);
     }
 }
@@ -1,5 +1,6 @@
 #include "screen_control/spi_screen_ui_common.hpp"
 
+#include <stdio.h>
 #include <string.h>
 
 #include "screen_control/spi_screen_layout.hpp"
@@ -68,19 +69,57 @@ uint16_t ScreenUI_CharCellH(uint8_t scale) {
     return (uint16_t)(8u * scale);
 }
 
+bool ScreenUI_FontForScale(uint8_t scale, ST7789_Font* out) {
+    if (!out || scale == 0) return false;
+    char name[12];
+    snprintf(name, sizeof(name), "font%u", (unsigned)ScreenUI_CharCellH(scale));
+    return ST7789_Font_Find(name, out);
+}
+
 uint16_t ScreenUI_TextPxW(const char* s, uint8_t scale) {
     if (!s || scale == 0) return 0;
+    ST7789_Font font;
+    if (ScreenUI_FontForScale(scale, &font)) return ST7789_Font_TextWidth(&font, s);
     uint16_t len = (uint16_t)strlen(s);
     return (uint16_t)(len * ScreenUI_CharCellW(scale));
 }
 
 uint16_t ScreenUI_TextPxH(uint8_t scale) {
     if (scale == 0) return 0;
+    ST7789_Font font;
+    if (ScreenUI_FontForScale(scale, &font)) return font.line_height;
     return ScreenUI_CharCellH(scale);
 }
 
+static void screenui_draw_font_centered(ST7789_Handle* lcd, const ST7789_Font* font, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char* s, uint32_t fg, uint32_t bg) {
+    if (h < font->line_height) return;
+    uint16_t tw = 0;
+    size_t n = ST7789_Font_Fit(font, s, w, &tw);
+    if (n == 0) return;
+    char tmp[64];
+    if (s[n] != '\0') {
+        // 放不下时截断到整字符
+        if (n >= sizeof(tmp)) {
+            n = sizeof(tmp) - 1u;
+            while (n > 0 && ((uint8_t)s[n] & 0xC0u) == 0x80u) n--;
+        }
+        memcpy(tmp, s, n);
+        tmp[n] = '\0';
+        s = tmp;
+        tw = ST7789_Font_TextWidth(font, s);
+    }
+    const uint16_t cx = (uint16_t)(x + (w - tw) / 2u);
+    const uint16_t cy = (uint16_t)(y + (h - font->line_height) / 2u);
+    ST7789_DrawText(lcd, font, cx, cy, s, fg, bg);
+}
+
 void ScreenUI_DrawStringCenteredInBox(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char* s, uint32_t fg, uint32_t bg, uint8_t scale) {
     if (!lcd || !s || scale == 0) return;
+    ST7789_Font font;
+    if (ScreenUI_FontForScale(scale, &font)) {
+        screenui_draw_font_centered(lcd, &font, x, y, w, h, s, fg, bg);
+        return;
+    }
     const uint16_t tw = ScreenUI_TextPxW(s, scale);
     const uint16_t th = ScreenUI_TextPxH(scale);
 
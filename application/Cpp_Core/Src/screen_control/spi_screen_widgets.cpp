@@ -0,0 +1,422 @@
+#include "screen_control/spi_screen_widgets.hpp"
+
+#include <string.h>
+
+#include "screen_control/spi_screen_ui_common.hpp"
+
+#define SCREEN_WIDGET_CONTENT_SLOTS 24u
+
+static ScreenWidgetSlot g_contentSlots[SCREEN_WIDGET_CONTENT_SLOTS];
+static ScreenWidgetTree g_contentTree;
+
+const ScreenValueEditTuning kScreenValueEditDefaultTuning = {
+    1u,     // mulBase
+    40u,    // accelDtFastMs
+    80u,    // accelDtMedMs
+    140u,   // accelDtSlowMs
+    10u,    // mulFast
+    6u,     // mulMed
+    3u,     // mulSlow
+    90u,    // inertiaDtFastMs
+    170u,   // inertiaDtMedMs
+    50u,    // inertiaStepsMaxFast
+    10u,    // inertiaStepsAddFast
+    12u,    // inertiaIntervalFastMs
+    35u,    // inertiaStepsMaxMed
+    6u,     // inertiaStepsAddMed
+    16u,    // inertiaIntervalMedMs
+    22u,    // inertiaIntervalSlowMs
+    7u,     // inertiaAppliedPerFrameMax
+    8u,     // inertiaIntervalAddMs
+    180u,   // inertiaIntervalMaxMs
+    110u,   // mulDecayIntervalMs
+};
+
+ScreenWidgetTree* ScreenWidgets_Content(void) {
+    if (!g_contentTree.slots) ScreenWidgetTree_Init(&g_contentTree, g_contentSlots, (uint8_t)SCREEN_WIDGET_CONTENT_SLOTS);
+    return &g_contentTree;
+}
+
+static bool rect_equal(const ScreenWidgetRect& a, const ScreenWidgetRect& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static bool rect_overlap(const ScreenWidgetRect& a, const ScreenWidgetRect& b) {
+    if (a.w == 0u || a.h == 0u || b.w == 0u || b.h == 0u) return false;
+    if ((uint32_t)a.x + a.w <= b.x || (uint32_t)b.x + b.w <= a.x) return false;
+    if ((uint32_t)a.y + a.h <= b.y || (uint32_t)b.y + b.h <= a.y) return false;
+    return true;
+}
+
+static void fill_rect(ST7789_Handle* lcd, const ScreenWidgetRect& r, uint32_t color) {
+    ST7789_FillRect(lcd, r.x, r.y, r.w, r.h, color);
+}
+
+static uint32_t hash_items(const char* const* items, uint8_t count) {
+    // FNV-1a，每项结尾再混合一次，以区分 "ab","c" 与 "a","bc"
+    uint32_t h = 2166136261u;
+    if (!items) return h;
+    for (uint8_t i = 0; i < count; i++) {
+        const char* s = items[i] ? items[i] : "";
+        while (*s) {
+            h = (h ^ (uint8_t)*s++) * 16777619u;
+        }
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void widget_init(ScreenWidget* w, ScreenWidgetKind kind, ScreenWidgetRect rect) {
+    memset(w, 0, sizeof(*w));
+    w->kind = (uint8_t)kind;
+    w->rect = rect;
+}
+
+static void widget_set_text(ScreenWidget* w, const char* text) {
+    if (!text) return;
+    size_t n = strlen(text);
+    if (n >= sizeof(w->text)) n = sizeof(w->text) - 1u;
+    memcpy(w->text, text, n);
+}
+
+static void tree_add_erase(ScreenWidgetTree* tree, const ScreenWidgetRect& r) {
+    if (tree->eraseCount >= SCREEN_WIDGET_ERASE_MAX) {
+        tree->clearPending = true;
+        return;
+    }
+    tree->erase[tree->eraseCount++] = r;
+}
+
+static void tree_declare(ScreenWidgetTree* tree, const ScreenWidget& w) {
+    if (!tree || !tree->slots || tree->count >= tree->capacity) return;
+    uint8_t i = tree->count++;
+    ScreenWidgetSlot& slot = tree->slots[i];
+    const bool painted = i < tree->paintedCount;
+    if (painted && memcmp(&slot.props, &w, sizeof(w)) == 0) return;
+    if (painted && !rect_equal(slot.props.rect, w.rect)) tree_add_erase(tree, slot.props.rect);
+    memcpy(&slot.props, &w, sizeof(w));
+    slot.dirty = true;
+}
+
+static void paint_list(ST7789_Handle* lcd, const ScreenWidget& w) {
+    const uint16_t listX = w.rect.x;
+    const uint16_t listW = w.rect.w;
+    const int top = (int)w.rect.y;
+    const int bottom = (int)w.rect.y + (int)w.rect.h;
+    const uint16_t itemH = w.itemH;
+    const int anchorY = top + (int)(w.rect.h / 2u) - (int)(itemH / 2u);
+    const uint16_t charH = ScreenUI_CharCellH(w.scale);
+
+    fill_rect(lcd, w.rect, w.bg);
+    if (!w.items) return;
+
+    for (uint8_t i = 0; i < w.count; i++) {
+        int dy = (int)((int)i - (int)w.index) * (int)itemH;
+        int y0 = anchorY + dy + (int)w.offsetPx;
+        int y1 = y0 + (int)itemH;
+        if (y1 <= top || y0 >= bottom) continue;
+
+        int clipY0 = (y0 < top) ? top : y0;
+        int clipY1 = (y1 > bottom) ? bottom : y1;
+        uint16_t yy = (uint16_t)clipY0;
+        uint16_t hh = (uint16_t)(clipY1 - clipY0);
+
+        int textY = y0 + (int)((itemH - charH) / 2u);
+        bool textVisible = (textY >= top) && ((textY + (int)charH) <= bottom);
+        uint16_t ty = (uint16_t)((textY < top) ? top : textY);
+        const char* label = w.items[i] ? w.items[i] : "";
+        const uint32_t itemText = (i == w.selected) ? w.fg : w.muted;
+        uint32_t rowBg = w.bg;
+        if (i == w.index) {
+            rowBg = w.accent;
+            ST7789_FillRect(lcd, listX, yy, listW, hh, rowBg);
+        }
+        if (textVisible) {
+            ST7789_DrawString(lcd, (uint16_t)(listX + 4), ty, label, itemText, rowBg, w.scale);
+        }
+    }
+}
+
+static uint16_t meter_px(uint16_t v, uint16_t max, uint16_t h) {
+    if (max == 0u) return 0u;
+    if (v > max) v = max;
+    return (uint16_t)((uint32_t)h * v / max);
+}
+
+static void paint_meter(ST7789_Handle* lcd, const ScreenWidget& w) {
+    fill_rect(lcd, w.rect, w.bg);
+    if (w.rect.w <= 4u || w.rect.h < 2u) return;
+    const uint16_t barX = (uint16_t)(w.rect.x + 2u);
+    const uint16_t barW = (uint16_t)(w.rect.w - 4u);
+    ST7789_FillRect(lcd, barX, w.rect.y, barW, w.rect.h, w.muted);
+    ST7789_FillRect(lcd, barX, w.rect.y, barW, meter_px(w.value, w.max, w.rect.h), w.fg);
+    // 先画重置刻线，两者重合时触发刻线在上
+    for (int8_t m = 1; m >= 0; m--) {
+        if (w.marks[m] == 0u) continue;
+        uint16_t y = meter_px(w.marks[m], w.max, w.rect.h);
+        if (y > w.rect.h - 2u) y = (uint16_t)(w.rect.h - 2u);
+        ST7789_FillRect(lcd, w.rect.x, (uint16_t)(w.rect.y + y), w.rect.w, 2u, w.markColors[m]);
+    }
+}
+
+static void paint_widget(ST7789_Handle* lcd, const ScreenWidget& w) {
+    switch (w.kind) {
+        case SCREEN_WIDGET_PANEL:
+            fill_rect(lcd, w.rect, w.bg);
+            break;
+        case SCREEN_WIDGET_LABEL:
+            fill_rect(lcd, w.rect, w.bg);
+            if (w.text[0] == '\0') break;
+            if (w.align == SCREEN_ALIGN_CENTER) {
+                ScreenUI_DrawStringCenteredInBox(lcd, w.rect.x, w.rect.y, w.rect.w, w.rect.h, w.text, w.fg, w.accent, w.scale);
+            } else {
+                ST7789_DrawString(lcd, w.rect.x, w.rect.y, w.text, w.fg, w.accent, w.scale);
+            }
+            break;
+        case SCREEN_WIDGET_PROGRESS: {
+            uint16_t fillW = 0u;
+            if (w.max > w.min) {
+                uint16_t v = w.value;
+                if (v < w.min) v = w.min;
+                if (v > w.max) v = w.max;
+                fillW = (uint16_t)((uint32_t)w.rect.w * (uint32_t)(v - w.min) / (uint32_t)(w.max - w.min));
+            }
+            fill_rect(lcd, w.rect, w.bg);
+            ST7789_FillRect(lcd, w.rect.x, w.rect.y, fillW, w.rect.h, w.fg);
+            break;
+        }
+        case SCREEN_WIDGET_METER:
+            paint_meter(lcd, w);
+            break;
+        case SCREEN_WIDGET_LIST:
+            paint_list(lcd, w);
+            break;
+        case SCREEN_WIDGET_ICON:
+            fill_rect(lcd, w.rect, w.bg);
+            (void)ST7789_Assets_Draw(lcd, w.rect.x, w.rect.y, w.text, w.bg);
+            break;
+        default:
+            break;
+    }
+}
+
+void ScreenWidgetTree_Init(ScreenWidgetTree* tree, ScreenWidgetSlot* slots, uint8_t capacity) {
+    if (!tree) return;
+    memset(tree, 0, sizeof(*tree));
+    tree->slots = slots;
+    tree->capacity = slots ? capacity : 0u;
+}
+
+void ScreenWidgetTree_Invalidate(ScreenWidgetTree* tree) {
+    if (!tree) return;
+    tree->clearPending = true;
+}
+
+void ScreenWidgetTree_Begin(ScreenWidgetTree* tree, ST7789_Handle* lcd, ScreenWidgetRect area, uint32_t key, uint32_t bg) {
+    if (!tree) return;
+    if (!tree->valid || tree->key != key || tree->bg != bg || tree->lcd != lcd || !rect_equal(tree->area, area)) {
+        tree->clearPending = true;
+    }
+    tree->valid = true;
+    tree->lcd = lcd;
+    tree->area = area;
+    tree->key = key;
+    tree->bg = bg;
+    tree->count = 0u;
+}
+
+uint8_t ScreenWidgetTree_End(ScreenWidgetTree* tree) {
+    if (!tree || !tree->lcd) return 0u;
+    ST7789_Handle* lcd = tree->lcd;
+
+    // 本帧已经重画过的区域，后声明且与之重叠的控件需要重新叠上去
+    ScreenWidgetRect damage[SCREEN_WIDGET_ERASE_MAX];
+    uint8_t damageCount = 0u;
+    bool damageAll = false;
+
+    if (tree->clearPending) {
+        fill_rect(lcd, tree->area, tree->bg);
+        for (uint8_t i = 0; i < tree->count; i++) tree->slots[i].dirty = true;
+        tree->clearPending = false;
+    } else {
+        for (uint8_t i = tree->count; i < tree->paintedCount; i++) {
+            tree_add_erase(tree, tree->slots[i].props.rect);
+        }
+        if (tree->clearPending) {
+            // 擦除矩形太多，直接整块重画
+            fill_rect(lcd, tree->area, tree->bg);
+            for (uint8_t i = 0; i < tree->count; i++) tree->slots[i].dirty = true;
+            tree->clearPending = false;
+        } else {
+            for (uint8_t e = 0; e < tree->eraseCount; e++) {
+                fill_rect(lcd, tree->erase[e], tree->bg);
+                damage[damageCount++] = tree->erase[e];
+            }
+        }
+    }
+    tree->eraseCount = 0u;
+
+    uint8_t repainted = 0u;
+    for (uint8_t i = 0; i < tree->count; i++) {
+        ScreenWidgetSlot& slot = tree->slots[i];
+        bool dirty = slot.dirty || damageAll;
+        for (uint8_t d = 0; !dirty && d < damageCount; d++) {
+            dirty = rect_overlap(slot.props.rect, damage[d]);
+        }
+        if (!dirty) continue;
+        paint_widget(lcd, slot.props);
+        slot.dirty = false;
+        repainted++;
+        if (damageCount < SCREEN_WIDGET_ERASE_MAX) damage[damageCount++] = slot.props.rect;
+        else damageAll = true;
+    }
+    for (uint8_t i = tree->count; i < tree->paintedCount; i++) {
+        tree->slots[i].props.kind = SCREEN_WIDGET_NONE;
+    }
+    tree->paintedCount = tree->count;
+    return repainted;
+}
+
+void ScreenWidget_Panel(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint32_t bg) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_PANEL, rect);
+    w.bg = bg;
+    tree_declare(tree, w);
+}
+
+void ScreenWidget_Label(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* text, uint32_t fg, uint32_t bg, uint32_t textBg, uint8_t scale, ScreenWidgetAlign align) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_LABEL, rect);
+    w.fg = fg;
+    w.bg = bg;
+    w.accent = textBg;
+    w.scale = scale;
+    w.align = (uint8_t)align;
+    widget_set_text(&w, text);
+    tree_declare(tree, w);
+}
+
+void ScreenWidget_Progress(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint16_t value, uint16_t min, uint16_t max, uint32_t fill, uint32_t track) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_PROGRESS, rect);
+    w.value = value;
+    w.min = min;
+    w.max = max;
+    w.fg = fill;
+    w.bg = track;
+    tree_declare(tree, w);
+}
+
+void ScreenWidget_Meter(ScreenWidgetTree* tree, ScreenWidgetRect rect, uint16_t value, uint16_t max, uint16_t pressMark, uint16_t releaseMark, uint32_t fill, uint32_t track, uint32_t bg, uint32_t pressColor, uint32_t releaseColor) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_METER, rect);
+    w.value = value;
+    w.max = max;
+    w.marks[0] = pressMark;
+    w.marks[1] = releaseMark;
+    w.fg = fill;
+    w.muted = track;
+    w.bg = bg;
+    w.markColors[0] = pressColor;
+    w.markColors[1] = releaseColor;
+    tree_declare(tree, w);
+}
+
+void ScreenWidget_List(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* const* items, uint8_t count, uint8_t index, uint8_t selected, uint16_t itemH, int16_t offsetPx, const ScreenUiStyle& style, uint32_t muted) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_LIST, rect);
+    w.items = items;
+    w.count = count;
+    w.index = index;
+    w.selected = selected;
+    w.itemH = itemH;
+    w.offsetPx = offsetPx;
+    w.scale = SPI_SCREEN_MENU_TEXT_SCALE;
+    w.fg = style.text;
+    w.bg = style.bg;
+    w.accent = style.selBg;
+    w.muted = muted;
+    w.itemsHash = hash_items(items, count);
+    tree_declare(tree, w);
+}
+
+void ScreenWidget_Icon(ScreenWidgetTree* tree, ScreenWidgetRect rect, const char* assetName, uint32_t bg) {
+    ScreenWidget w;
+    widget_init(&w, SCREEN_WIDGET_ICON, rect);
+    w.bg = bg;
+    widget_set_text(&w, assetName);
+    tree_declare(tree, w);
+}
+
+void ScreenValueEdit_Init(ScreenValueEdit* edit, const ScreenValueEditTuning* tuning) {
+    if (!edit) return;
+    edit->tuning = tuning ? tuning : &kScreenValueEditDefaultTuning;
+    edit->lastDetMs = 0u;
+    ScreenValueEdit_Stop(edit);
+}
+
+void ScreenValueEdit_Stop(ScreenValueEdit* edit) {
+    if (!edit) return;
+    if (!edit->tuning) edit->tuning = &kScreenValueEditDefaultTuning;
+    edit->inertiaSteps = 0u;
+    edit->inertiaDir = 0;
+    edit->mul = edit->tuning->mulBase;
+    edit->inertiaIntervalMs = edit->tuning->inertiaIntervalSlowMs;
+}
+
+void ScreenValueEdit_Rotate(ScreenValueEdit* edit, int8_t det, bool accelerate, uint32_t nowMs, ScreenValueEditStepFn step) {
+    if (!edit || det == 0) return;
+    if (!edit->tuning) edit->tuning = &kScreenValueEditDefaultTuning;
+    const ScreenValueEditTuning& t = *edit->tuning;
+    const uint32_t dt = nowMs - edit->lastDetMs;
+    edit->lastDetMs = nowMs;
+
+    if (accelerate) {
+        // 编辑加速（dt 越小代表滚得越快）
+        if (dt < t.accelDtFastMs) edit->mul = t.mulFast;
+        else if (dt < t.accelDtMedMs) edit->mul = t.mulMed;
+        else if (dt < t.accelDtSlowMs) edit->mul = t.mulSlow;
+        else edit->mul = t.mulBase;
+    } else {
+        edit->mul = t.mulBase;
+    }
+
+    if (step) step(det, edit->mul);
+
+    if (!accelerate) {
+        edit->inertiaSteps = 0u;
+        edit->inertiaDir = 0;
+        return;
+    }
+
+    // 惯性强度（dt 越小惯性越强）
+    if (dt < t.inertiaDtFastMs) {
+        if (edit->inertiaSteps < t.inertiaStepsMaxFast) edit->inertiaSteps = (uint8_t)(edit->inertiaSteps + t.inertiaStepsAddFast);
+        edit->inertiaIntervalMs = t.inertiaIntervalFastMs;
+    } else if (dt < t.inertiaDtMedMs) {
+        if (edit->inertiaSteps < t.inertiaStepsMaxMed) edit->inertiaSteps = (uint8_t)(edit->inertiaSteps + t.inertiaStepsAddMed);
+        edit->inertiaIntervalMs = t.inertiaIntervalMedMs;
+    } else {
+        edit->inertiaSteps = 0u;
+        edit->inertiaIntervalMs = t.inertiaIntervalSlowMs;
+    }
+    edit->inertiaDir = (det > 0) ? 1 : -1;
+    edit->inertiaNextMs = nowMs + edit->inertiaIntervalMs;
+}
+
+uint8_t ScreenValueEdit_Tick(ScreenValueEdit* edit, uint32_t nowMs, ScreenValueEditStepFn step) {
+    if (!edit || edit->inertiaSteps == 0u || !edit->tuning) return 0u;
+    const ScreenValueEditTuning& t = *edit->tuning;
+    uint8_t applied = 0u;
+    // 每帧最多补 inertiaAppliedPerFrameMax 次，避免一次性跳太多；补步间隔逐步变大实现减速
+    while (edit->inertiaSteps > 0u && (int32_t)(nowMs - edit->inertiaNextMs) >= 0 && applied < t.inertiaAppliedPerFrameMax) {
+        if (step) step(edit->inertiaDir, edit->mul);
+        edit->inertiaSteps--;
+        applied++;
+        edit->inertiaIntervalMs += t.inertiaIntervalAddMs;
+        if (edit->inertiaIntervalMs > t.inertiaIntervalMaxMs) edit->inertiaIntervalMs = t.inertiaIntervalMaxMs;
+        edit->inertiaNextMs += edit->inertiaIntervalMs;
+        if (edit->inertiaIntervalMs >= t.mulDecayIntervalMs && edit->mul > t.mulBase) edit->mul--;
+    }
+    return applied;
+}
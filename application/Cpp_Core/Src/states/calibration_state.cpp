@@ -15,7 +15,7 @@ void CalibrationState::allCalibrationCompletedCallback(uint8_t totalButtons, uin
     
     ADC_CALIBRATION_MANAGER.stopCalibration();
     STORAGE_MANAGER.setBootMode(BootMode::BOOT_MODE_INPUT);
-    STORAGE_MANAGER.saveConfig();
+    STORAGE_MANAGER.saveConfig(CONFIG_SECTION_GLOBAL);
     
     LOG_INFO("CALIBRATION", "Boot mode changed to INPUT, system will reboot in 1 second");
     rebootTime = HAL_GetTick();
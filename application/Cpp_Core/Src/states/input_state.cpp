@@ -12,13 +12,34 @@
 #include "gpdriver.hpp"
 #include "system_logger.h"
 #include "latency_monitor.hpp"
+#include "input_snapshot.hpp"
 #include "storagemanager.hpp"
+#include "flash_writer.hpp"
+#include "profile_runtime.hpp"
 
 static void on_default_profile_changed_input_workers(void) {
-    ADC_BTNS_WORKER.setup();
+    // ADC 按键的触发参数跟随配置文件镜像，在下一帧 commit() 之后由 ADC_BTNS_WORKER.read() 换上
     GPIO_BTNS_WORKER.setup();
 }
 
+#if HAS_LED == 1
+// 自定义灯效读取按键行程：ADC 按键按物理行程换算，GPIO 按键只有按下/释放
+static uint8_t led_travel_provider(uint8_t virtualPin) {
+    uint8_t buttonIndex = ADC_BTNS_WORKER.getButtonIndexFromVirtualPin(virtualPin);
+    const ADCValuesMapping* mapping = ADC_BTNS_WORKER.getCurrentMapping();
+    if (buttonIndex == 0xFF || mapping == nullptr || mapping->length < 2) {
+        return (GPIO_BTNS_WORKER.getVirtualPinMask() & (1U << virtualPin)) ? 255 : 0;
+    }
+    // 距离以完全按下为 0，完全释放为最大行程
+    float maxTravel = (mapping->length - 1) * mapping->step;
+    float distance = ADC_BTNS_WORKER.getCurrentDistance(buttonIndex);
+    float travel = (maxTravel - distance) * 255.0f / maxTravel;
+    if (travel <= 0.0f) return 0;
+    if (travel >= 255.0f) return 255;
+    return (uint8_t)travel;
+}
+#endif
+
 void InputState::setup()
 {
     LOG_INFO("INPUT", "Starting input state setup");
@@ -79,11 +100,19 @@ void InputState::setup()
 
 #if HAS_LED == 1
     LOG_DEBUG("INPUT", "Initializing LED manager");
+    LEDS_MANAGER.setTravelProvider(led_travel_provider);
     LEDS_MANAGER.setup();
+    // 输入模式下ADC应运行在低延迟模式，否则通过灯效提示
+    if (ADCManager::getInstance().getADCMode() != ADC_MODE_LOW_LATENCY) {
+        LEDS_MANAGER.notify(LED_NOTIFY_LOW_LATENCY_WARNING);
+    }
 #endif
 
     
 
+    // 游戏中保存配置走后台擦写，不阻塞输入
+    FLASH_WRITER.setBackground(true);
+
     isRunning = true;
     LOG_INFO("INPUT", "Input state setup completed successfully");
 
@@ -97,6 +126,9 @@ void InputState::loop()
     // 检查采样是否完成 (由SOF触发)
     if (ADCManager::getInstance().isSamplingDone())
     {
+        // 切换配置文件时编译好的镜像在这里换上，整帧都用同一个配置文件
+        PROFILE_RUNTIME.commit();
+
         virtualPinMask = GPIO_BTNS_WORKER.read() | ADC_BTNS_WORKER.read();
 
         // 只有在没有按下FN键时才处理游戏手柄数据
@@ -122,8 +154,14 @@ void InputState::loop()
 
         lastVirtualPinMask = virtualPinMask;
 
+        // 报告已经提交，再发布给屏幕输入监视页，不推迟本次回报
+        INPUT_SNAPSHOT.publish(virtualPinMask, GAMEPAD.state.dpad);
+
         // 清除标志，等待下一次SOF
         ADCManager::getInstance().clearSamplingDone();
+
+        // 本帧回报已经发出，到下一帧采样完成前可以给 flash 发命令
+        FLASH_WRITER.onFrameDone();
     }
 
     // 处理USB任务
@@ -1,16 +1,36 @@
 #include "storagemanager.hpp"
 #include "config.hpp"
+#include "flash_writer.hpp"
+#include "config_schema.hpp"
+#include "profile_runtime.hpp"
 #include "stm32h750xx.h"
 #include <stdio.h>
 #include <string.h>
 #include "board_cfg.h"
 
+// 最后一次修改之后等待这么久再保存，期间的修改合并成一次写入
+#ifndef CONFIG_SAVE_COALESCE_MS
+#define CONFIG_SAVE_COALESCE_MS		1000u
+#endif
+
+// 持续修改时，距第一次修改最多等待这么久
+#ifndef CONFIG_SAVE_MAX_DELAY_MS
+#define CONFIG_SAVE_MAX_DELAY_MS	5000u
+#endif
+
 static Storage::DefaultProfileChangedCallback g_defaultProfileChangedCbs[8] = {0};
 static uint8_t g_defaultProfileChangedCbCount = 0;
 
 void Storage::initConfig() {
 	APP_DBG("Storage::init begin.");
 	ConfigUtils::load(config);
+	// 默认配置文件马上要用，先读进缓存并编译成运行时镜像
+	const GamepadProfile* profile = getDefaultGamepadProfile();
+	if (profile) {
+		PROFILE_RUNTIME.request(*profile);
+		PROFILE_RUNTIME.commit();
+	}
+	FLASH_WRITER.flush();
 	// APP_DBG("Storage::initConfig - hotkeys: %d", config.hotkeys[0].virtualPin);
 	// ConfigUtils::reset(config);
 }
@@ -30,15 +50,272 @@ bool Storage::setDefaultProfileId(const char* id) {
 	if (strncmp(config.defaultProfileId, id, sizeof(config.defaultProfileId)) == 0) return false;
 	strncpy(config.defaultProfileId, id, sizeof(config.defaultProfileId) - 1);
 	config.defaultProfileId[sizeof(config.defaultProfileId) - 1] = '\0';
+	configRevision++;
+	notifyDefaultProfileChanged();
+	return true;
+}
+
+void Storage::refreshDefaultProfile() {
+	configRevision++;
+	notifyDefaultProfileChanged();
+}
+
+void Storage::notifyDefaultProfileChanged() {
+	// 先编译好新镜像，输入循环在下一帧开始前换上；跟随镜像的参数（如 ADC 触发参数）在 commit() 之后才切换
+	const GamepadProfile* profile = getDefaultGamepadProfile();
+	if (profile) {
+		PROFILE_RUNTIME.request(*profile);
+	}
 	for (uint8_t i = 0; i < g_defaultProfileChangedCbCount; i++) {
 		if (g_defaultProfileChangedCbs[i]) g_defaultProfileChangedCbs[i]();
 	}
-	return true;
 }
 
 bool Storage::saveConfig()
 {
-	return ConfigUtils::save(config);
+	return saveConfig(CONFIG_SECTION_ALL);
+}
+
+bool Storage::saveConfig(ConfigSectionMask sections)
+{
+	configRevision++;
+	sections |= pendingSections;
+	pendingSections = 0;
+	GamepadProfile* profiles[NUM_PROFILES];
+	getCachedProfiles(profiles);
+	const bool saved = ConfigUtils::save(config, profiles, sections);
+	writeBackIndex = -1;
+	// 调用者接着重启或回复网页端，等写入真正落到 flash
+	return FLASH_WRITER.flush() && saved;
+}
+
+void Storage::requestSave(ConfigSectionMask sections)
+{
+	const uint32_t now = HAL_GetTick();
+	configRevision++;
+	if (pendingSections == 0) {
+		pendingSinceMs = now;
+	}
+	pendingSections |= sections;
+	syncProfileHeaders();
+	pendingDueMs = now + CONFIG_SAVE_COALESCE_MS;
+	if ((int32_t)(pendingDueMs - (pendingSinceMs + CONFIG_SAVE_MAX_DELAY_MS)) > 0) {
+		pendingDueMs = pendingSinceMs + CONFIG_SAVE_MAX_DELAY_MS;
+	}
+}
+
+void Storage::loop()
+{
+	if (pendingSections == 0 || (int32_t)(HAL_GetTick() - pendingDueMs) < 0) {
+		return;
+	}
+	// 上一批擦写还在后台执行时先不比较，读 flash 要等器件空闲
+	if (FLASH_WRITER.isBusy()) {
+		return;
+	}
+	const ConfigSectionMask sections = pendingSections;
+	pendingSections = 0;
+	GamepadProfile* profiles[NUM_PROFILES];
+	getCachedProfiles(profiles);
+	if (!ConfigUtils::save(config, profiles, sections)) {
+		APP_ERR("Storage::loop - deferred save failure.");
+	}
+	writeBackIndex = -1;
+}
+
+ConfigSectionMask Storage::getProfileSections(const GamepadProfile* profile, bool leds)
+{
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (profile == &profileCache[s] && profileCacheIndex[s] >= 0) {
+			const uint8_t i = (uint8_t)profileCacheIndex[s];
+			return leds ? CONFIG_SECTION_PROFILE_LEDS(i) : CONFIG_SECTION_PROFILE(i);
+		}
+	}
+	return CONFIG_SECTION_ALL;
+}
+
+int8_t Storage::findProfileIndex(const char* id) const
+{
+	if (!id) return -1;
+	const uint8_t numProfilesMax = config.numProfilesMax < NUM_PROFILES ? config.numProfilesMax : NUM_PROFILES;
+	for (uint8_t i = 0; i < numProfilesMax; i++) {
+		if (strcmp(config.profiles[i].id, id) == 0) {
+			return (int8_t)i;
+		}
+	}
+	return -1;
+}
+
+int8_t Storage::findCachedSlot(uint8_t index) const
+{
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (profileCacheIndex[s] == (int8_t)index) return (int8_t)s;
+	}
+	return -1;
+}
+
+/**
+ * @brief 名片以缓存中的内容为准：网页端、屏幕改的都是完整的配置文件
+ */
+void Storage::syncProfileHeaders()
+{
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (profileCacheIndex[s] < 0) continue;
+		memcpy(&config.profiles[profileCacheIndex[s]], &profileCache[s], sizeof(GamepadProfileHeader));
+	}
+}
+
+void Storage::getCachedProfiles(GamepadProfile** profiles)
+{
+	syncProfileHeaders();
+	memset(profiles, 0, sizeof(GamepadProfile*) * NUM_PROFILES);
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (profileCacheIndex[s] >= 0) profiles[profileCacheIndex[s]] = &profileCache[s];
+	}
+	if (writeBackIndex >= 0 && !profiles[writeBackIndex]) profiles[writeBackIndex] = &writeBack;
+}
+
+/**
+ * @brief 立即写入写回缓冲里的配置文件
+ */
+bool Storage::flushWriteBack()
+{
+	if (writeBackIndex < 0) return true;
+	const uint8_t i = (uint8_t)writeBackIndex;
+	const ConfigSectionMask sections = CONFIG_SECTION_PROFILE(i) | CONFIG_SECTION_PROFILE_LEDS(i);
+	GamepadProfile* profiles[NUM_PROFILES] = {0};
+	profiles[i] = &writeBack;
+	writeBackIndex = -1;
+	pendingSections &= ~sections;
+	return ConfigUtils::save(config, profiles, sections);
+}
+
+/**
+ * @brief 腾出一个槽位：空槽优先，否则换出最久没用的非默认配置文件
+ * 有挂起分区的放进写回缓冲，由 loop() 在 FlashWriter 空闲时写入，换出本身不访问 flash
+ */
+uint8_t Storage::evictProfileSlot()
+{
+	int8_t victim = -1;
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (s == defaultSlot) continue;
+		if (profileCacheIndex[s] < 0) return s;
+		if (victim < 0 || profileCacheUse[s] < profileCacheUse[victim]) victim = (int8_t)s;
+	}
+
+	const uint8_t i = (uint8_t)profileCacheIndex[victim];
+	const ConfigSectionMask sections = CONFIG_SECTION_PROFILE(i) | CONFIG_SECTION_PROFILE_LEDS(i);
+	syncProfileHeaders();
+	if (pendingSections & sections) {
+		// 缓冲里的上一个还没写入（短时间内换出了两个改过的配置文件），只能先把它写掉
+		if (!flushWriteBack()) {
+			APP_ERR("Storage::evictProfileSlot - write back failure.");
+		}
+		writeBack = profileCache[victim];
+		writeBackIndex = (int8_t)i;
+	}
+	profileCacheIndex[victim] = -1;
+	return (uint8_t)victim;
+}
+
+GamepadProfile* Storage::getProfileAt(uint8_t index)
+{
+	if (index >= NUM_PROFILES) return nullptr;
+	int8_t slot = findCachedSlot(index);
+	if (slot < 0) {
+		slot = (int8_t)evictProfileSlot();
+		if (writeBackIndex == (int8_t)index) {
+			// 还没写入的修改以写回缓冲为准，挂起的分区不变
+			profileCache[slot] = writeBack;
+			writeBackIndex = -1;
+		} else {
+			ConfigSchema::loadProfile(config.profileSlots[index], profileCache[slot]);
+		}
+		profileCacheIndex[slot] = (int8_t)index;
+	}
+	profileCacheUse[slot] = ++profileCacheClock;
+	return &profileCache[slot];
+}
+
+bool Storage::storeProfileAt(uint8_t index, const GamepadProfile& profile)
+{
+	if (index >= NUM_PROFILES) return false;
+	const int8_t slot = findCachedSlot(index);
+	if (slot >= 0 && &profileCache[slot] != &profile) {
+		profileCache[slot] = profile;
+	}
+	syncProfileHeaders();
+	memcpy(&config.profiles[index], &profile, sizeof(GamepadProfileHeader));
+
+	const ConfigSectionMask sections = CONFIG_SECTION_PROFILE(index) | CONFIG_SECTION_PROFILE_LEDS(index);
+	GamepadProfile* profiles[NUM_PROFILES] = {0};
+	profiles[index] = slot >= 0 ? &profileCache[slot] : const_cast<GamepadProfile*>(&profile);
+	pendingSections &= ~sections;
+	if (writeBackIndex == (int8_t)index) writeBackIndex = -1;
+	configRevision++;
+	return ConfigUtils::save(config, profiles, sections);
+}
+
+/**
+ * @brief 第 i 个配置文件在 from 移到 to 之后的下标
+ */
+static uint8_t moved_profile_index(uint8_t i, uint8_t from, uint8_t to)
+{
+	if (i == from) return to;
+	if (from < to && i > from && i <= to) return (uint8_t)(i - 1);
+	if (from > to && i >= to && i < from) return (uint8_t)(i + 1);
+	return i;
+}
+
+void Storage::moveProfile(uint8_t from, uint8_t to)
+{
+	if (from >= NUM_PROFILES || to >= NUM_PROFILES || from == to) return;
+	syncProfileHeaders();
+
+	const GamepadProfileHeader header = config.profiles[from];
+	const uint8_t profileSlot = config.profileSlots[from];
+	const int8_t dir = from < to ? 1 : -1;
+	for (uint8_t i = from; i != to; i = (uint8_t)(i + dir)) {
+		config.profiles[i] = config.profiles[i + dir];
+		config.profileSlots[i] = config.profileSlots[i + dir];
+	}
+	config.profiles[to] = header;
+	config.profileSlots[to] = profileSlot;
+
+	// 缓存、写回缓冲和挂起的分区跟着内容走
+	for (uint8_t s = 0; s < STORAGE_PROFILE_CACHE_SLOTS; s++) {
+		if (profileCacheIndex[s] >= 0) {
+			profileCacheIndex[s] = (int8_t)moved_profile_index((uint8_t)profileCacheIndex[s], from, to);
+		}
+	}
+	if (writeBackIndex >= 0) {
+		writeBackIndex = (int8_t)moved_profile_index((uint8_t)writeBackIndex, from, to);
+	}
+	ConfigSectionMask moved = pendingSections;
+	for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+		moved &= ~(CONFIG_SECTION_PROFILE(i) | CONFIG_SECTION_PROFILE_LEDS(i));
+	}
+	for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+		const uint8_t j = moved_profile_index(i, from, to);
+		if (pendingSections & CONFIG_SECTION_PROFILE(i)) moved |= CONFIG_SECTION_PROFILE(j);
+		if (pendingSections & CONFIG_SECTION_PROFILE_LEDS(i)) moved |= CONFIG_SECTION_PROFILE_LEDS(j);
+	}
+	pendingSections = moved;
+	configRevision++;
+}
+
+/**
+ * @brief 默认配置文件：固定的槽位里仍是它时直接返回，否则按 ID 重新查找并固定所在槽位
+ */
+GamepadProfile* Storage::getDefaultGamepadProfile() {
+	if (defaultSlot >= 0 && profileCacheIndex[defaultSlot] >= 0
+		&& strncmp(profileCache[defaultSlot].id, config.defaultProfileId, sizeof(config.defaultProfileId)) == 0) {
+		profileCacheUse[defaultSlot] = ++profileCacheClock;
+		return &profileCache[defaultSlot];
+	}
+	GamepadProfile* profile = getGamepadProfile(config.defaultProfileId);
+	defaultSlot = profile ? (int8_t)(profile - profileCache) : -1;
+	return profile;
 }
 
 /**
@@ -48,29 +325,36 @@ bool Storage::saveConfig()
  * @return 游戏手柄配置
  */
 GamepadProfile* Storage::getGamepadProfile(char* id) {
-	GamepadProfile* gamepadProfiles = config.profiles;
-	uint8_t numProfilesMax = config.numProfilesMax;
-	for (size_t i = 0; i < numProfilesMax; i++) {
-		if (strcmp(gamepadProfiles[i].id, id) == 0) {
-			return &gamepadProfiles[i];
-		}
-	}
-	return nullptr;
+	const int8_t index = findProfileIndex(id);
+	return index < 0 ? nullptr : getProfileAt((uint8_t)index);
 }
 
 void Storage::setBootMode(BootMode bootMode) {
 	config.bootMode = bootMode;
+	configRevision++;
 }
 
 bool Storage::resetConfig()
 {
 	APP_DBG("Storage::resettings begin.");
-	return ConfigUtils::reset(config);
+	const bool reset = ConfigUtils::reset(config);
+	// 缓存里的配置文件随之作废，默认配置文件重新读入（都是默认值）
+	memset(profileCacheIndex, 0xFF, sizeof(profileCacheIndex));
+	defaultSlot = -1;
+	writeBackIndex = -1;
+	pendingSections = 0;
+	const GamepadProfile* profile = getDefaultGamepadProfile();
+	if (profile) {
+		PROFILE_RUNTIME.request(*profile);
+		PROFILE_RUNTIME.commit();
+	}
+	return FLASH_WRITER.flush() && reset;
 	// NVIC_SystemReset();				//reboot
 }
 
 void Storage::setInputMode(InputMode inputMode) {
 	config.inputMode = inputMode;
+	configRevision++;
 }
 
 
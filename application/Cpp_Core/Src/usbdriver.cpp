@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include "adc_btns/adc_manager.hpp"
 #include "latency_monitor.hpp"
+#include "flash_writer.hpp"
 
 static bool usb_mounted;
 static bool usb_suspended;
@@ -96,6 +97,7 @@ void tud_resume_cb(void)
 // Invoked when a new (micro) frame started
 void tud_sof_cb(uint32_t frame_count)
 {
+	FLASH_WRITER.onSof();
 	// 双重保险：只有在低延迟模式下才执行ADC逻辑
 	if (ADCManager::getInstance().getADCMode() == ADC_MODE_LOW_LATENCY)
 	{
@@ -16,7 +16,7 @@
 	*
 	*  1.例程参考于官方驱动文件 stm32h743i_eval_qspi.c
 	*	2.例程使用的是 QUADSPI_BK1
-	*	3.提供的读写函数均使用HAL库函数直接操作，没有用到DMA和中断
+	*	3.长度较大的读取使用 MDMA（QUADSPI/MDMA 中断通知结束），其余读写函数使用HAL库函数直接操作
 	*	4.默认配置QSPI驱动时钟为120M
 	*
 >>>>> 重要说明：
@@ -51,6 +51,64 @@
 
 QSPI_HandleTypeDef hqspi;
 static bool xip_enabled = false;  // 跟踪XIP模式状态
+static volatile bool op_pending = false;	// 已发出擦除/编程命令，尚未确认结束
+static uint8_t sector_cache[W25Qxx_SECTOR_SIZE] __attribute__((aligned(W25Qxx_DMA_ALIGN)));	// 写入/擦除前读出的扇区原内容
+
+#define W25Qxx_RESET_RECOVERY_US	50	// 复位后恢复时间，手册 tRST 最大 30us
+
+#ifndef QSPI_W25Qxx_DMA_MIN_SIZE
+#define QSPI_W25Qxx_DMA_MIN_SIZE	64		// 短于这个长度直接由 CPU 读 FIFO，省掉 MDMA 启动和缓存维护
+#endif
+
+#ifndef QSPI_W25Qxx_READAHEAD_SIZE
+#define QSPI_W25Qxx_READAHEAD_SIZE	2048	// 顺序小块读取的预读缓冲大小
+#endif
+
+static MDMA_HandleTypeDef hmdma_qspi;
+static volatile bool dma_busy = false;		// MDMA 读取进行中
+static volatile int8_t dma_status = QSPI_W25Qxx_OK;
+static uint8_t* dma_buffer = NULL;
+static uint32_t dma_length = 0;
+static QSPI_W25Qxx_ReadCallback dma_callback = NULL;
+static void* dma_context = NULL;
+
+// 预读缓冲：连续两次读取首尾相接时按 QSPI_W25Qxx_READAHEAD_SIZE 整块读入，之后的小块读取直接复制
+static uint8_t readahead_buf[QSPI_W25Qxx_READAHEAD_SIZE] __attribute__((aligned(W25Qxx_DMA_ALIGN)));
+static uint32_t readahead_addr = 0;
+static uint32_t readahead_len = 0;				// 0 表示缓冲无效
+static uint32_t readahead_next = 0xFFFFFFFF;	// 上一次读取的结束地址
+
+#ifndef QSPI_W25Qxx_DEFER_DEPTH
+#define QSPI_W25Qxx_DEFER_DEPTH		4		// 等待恢复内存映射的读者个数
+#endif
+
+// 访问仲裁：间接模式会话可以嵌套，只有最外层切换模式
+static uint8_t indirect_depth = 0;
+static bool remap_on_release = false;		// 会话结束时进入内存映射
+static uint32_t dirty_lo = 0xFFFFFFFF;		// 上次进入内存映射以来擦写过的范围 [dirty_lo, dirty_hi)
+static uint32_t dirty_hi = 0;
+static struct {
+	QSPI_W25Qxx_MappedCallback callback;
+	void* context;
+} deferred[QSPI_W25Qxx_DEFER_DEPTH];
+static uint8_t deferred_count = 0;
+
+static void qspi_mpu_init(void);
+
+/**
+ * @brief 微秒级忙等，DWT 计数器未开启时退化为 HAL_Delay(1)
+ */
+static void qspi_delay_us(uint32_t us)
+{
+	if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0u) {
+		HAL_Delay(1);
+		return;
+	}
+	const uint32_t start = DWT->CYCCNT;
+	const uint32_t cycles = us * (SystemCoreClock / 1000000u);
+	while ((uint32_t)(DWT->CYCCNT - start) < cycles) {
+	}
+}
 
 /**
  * @brief 
@@ -111,6 +169,32 @@ void HAL_QSPI_MspInit(QSPI_HandleTypeDef* hqspi)
 		GPIO_InitStruct.Pin 		= QUADSPI_BK1_IO3_PIN;			// QUADSPI_BK1_IO3 引脚
 		GPIO_InitStruct.Alternate 	= QUADSPI_BK1_IO3_AF;			// QUADSPI_BK1_IO3 复用
 		HAL_GPIO_Init(QUADSPI_BK1_IO3_PORT, &GPIO_InitStruct);		// 初始化 QUADSPI_BK1_IO3 引脚
+
+		/* 间接读使用的 MDMA：FIFO 达到阈值时搬运一次，源地址固定为 QUADSPI->DR */
+		__HAL_RCC_MDMA_CLK_ENABLE();
+		hmdma_qspi.Instance 						= QUADSPI_MDMA_INSTANCE;
+		hmdma_qspi.Init.Request 					= MDMA_REQUEST_QUADSPI_FIFO_TH;
+		hmdma_qspi.Init.TransferTriggerMode 		= MDMA_BUFFER_TRANSFER;
+		hmdma_qspi.Init.Priority 					= MDMA_PRIORITY_HIGH;
+		hmdma_qspi.Init.Endianness 				= MDMA_LITTLE_ENDIANNESS_PRESERVE;
+		hmdma_qspi.Init.SourceInc 				= MDMA_SRC_INC_DISABLE;
+		hmdma_qspi.Init.DestinationInc 			= MDMA_DEST_INC_BYTE;
+		hmdma_qspi.Init.SourceDataSize 			= MDMA_SRC_DATASIZE_BYTE;
+		hmdma_qspi.Init.DestDataSize 				= MDMA_DEST_DATASIZE_BYTE;
+		hmdma_qspi.Init.DataAlignment 			= MDMA_DATAALIGN_PACKENABLE;
+		hmdma_qspi.Init.BufferTransferLength 		= 4;							// 与 FifoThreshold 一致
+		hmdma_qspi.Init.SourceBurst 				= MDMA_SOURCE_BURST_SINGLE;
+		hmdma_qspi.Init.DestBurst 				= MDMA_DEST_BURST_SINGLE;
+		hmdma_qspi.Init.SourceBlockAddressOffset 	= 0;
+		hmdma_qspi.Init.DestBlockAddressOffset 	= 0;
+		HAL_MDMA_DeInit(&hmdma_qspi);
+		HAL_MDMA_Init(&hmdma_qspi);
+		__HAL_LINKDMA(hqspi, hmdma, hmdma_qspi);
+
+		HAL_NVIC_SetPriority(MDMA_IRQn, QUADSPI_MDMA_IRQn_PRIO, 0);
+		HAL_NVIC_EnableIRQ(MDMA_IRQn);
+		HAL_NVIC_SetPriority(QUADSPI_IRQn, QUADSPI_IRQn_PRIO, 0);
+		HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
 	}
 }
 
@@ -163,6 +247,8 @@ int8_t QSPI_W25Qxx_Init(void)
     uint32_t Device_ID;
     
     MX_QUADSPI_Init();
+    xip_enabled = false;	// 控制器已复位，bootloader 留下的内存映射不再有效
+    qspi_mpu_init();
     QSPI_W25Qxx_Reset();
     Device_ID = QSPI_W25Qxx_ReadID();
     
@@ -182,6 +268,250 @@ int8_t QSPI_W25Qxx_Init(void)
     }
 }
 
+/**
+ * @brief 记录即将擦写的范围：预读缓冲作废，重新进入内存映射时失效对应的 D-Cache 行
+ */
+static void qspi_note_modified(uint32_t addr, uint32_t len)
+{
+	addr &= 0x00FFFFFF;
+	readahead_len = 0;
+	if (addr < dirty_lo) {
+		dirty_lo = addr;
+	}
+	if (addr + len > dirty_hi) {
+		dirty_hi = addr + len;
+	}
+}
+
+/**
+ * @brief 切换映射窗口的 MPU 属性
+ * 说    明: 映射时为 Normal、Write-Through、只读、不可执行，读取走 D-Cache；
+ *			 间接模式下禁止访问，CPU 的推测读取不会落到 QSPI 上，误读映射区直接进 MemManage 而不是卡住总线
+ */
+static void qspi_mpu_window(bool mapped)
+{
+	MPU_Region_InitTypeDef MPU_InitStruct = {0};
+
+	MPU_InitStruct.Enable           = MPU_REGION_ENABLE;
+	MPU_InitStruct.Number           = QUADSPI_MPU_REGION_WINDOW;
+	MPU_InitStruct.BaseAddress      = W25Qxx_Mem_Addr;
+	MPU_InitStruct.Size             = MPU_REGION_SIZE_8MB;
+	MPU_InitStruct.SubRegionDisable = 0x00;
+	MPU_InitStruct.TypeExtField     = MPU_TEX_LEVEL0;
+	MPU_InitStruct.DisableExec      = MPU_INSTRUCTION_ACCESS_DISABLE;
+	MPU_InitStruct.IsShareable      = MPU_ACCESS_NOT_SHAREABLE;
+	MPU_InitStruct.IsBufferable     = MPU_ACCESS_NOT_BUFFERABLE;
+	if (mapped) {
+		MPU_InitStruct.AccessPermission = MPU_REGION_PRIV_RO_URO;
+		MPU_InitStruct.IsCacheable      = MPU_ACCESS_CACHEABLE;
+	} else {
+		MPU_InitStruct.AccessPermission = MPU_REGION_NO_ACCESS;
+		MPU_InitStruct.IsCacheable      = MPU_ACCESS_NOT_CACHEABLE;
+	}
+	// 改写期间窗口区域短暂关闭，落在下面的 BANK 区域（禁止访问），不需要关闭整个 MPU
+	HAL_MPU_ConfigRegion(&MPU_InitStruct);
+	__DSB();
+	__ISB();
+}
+
+/**
+ * @brief 配置 QSPI 地址段的 MPU 区域，不依赖 bootloader 留下的设置
+ * 说    明: BANK 覆盖整个 256MB QSPI 地址段，Strongly-ordered 且禁止访问；WINDOW 是器件实际的 8MB，随模式切换
+ */
+static void qspi_mpu_init(void)
+{
+	MPU_Region_InitTypeDef MPU_InitStruct = {0};
+
+	MPU_InitStruct.Enable           = MPU_REGION_ENABLE;
+	MPU_InitStruct.Number           = QUADSPI_MPU_REGION_BANK;
+	MPU_InitStruct.BaseAddress      = W25Qxx_Mem_Addr;
+	MPU_InitStruct.Size             = MPU_REGION_SIZE_256MB;
+	MPU_InitStruct.SubRegionDisable = 0x00;
+	MPU_InitStruct.TypeExtField     = MPU_TEX_LEVEL0;
+	MPU_InitStruct.AccessPermission = MPU_REGION_NO_ACCESS;
+	MPU_InitStruct.DisableExec      = MPU_INSTRUCTION_ACCESS_DISABLE;
+	MPU_InitStruct.IsShareable      = MPU_ACCESS_SHAREABLE;
+	MPU_InitStruct.IsCacheable      = MPU_ACCESS_NOT_CACHEABLE;
+	MPU_InitStruct.IsBufferable     = MPU_ACCESS_NOT_BUFFERABLE;
+	HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+	qspi_mpu_window(false);
+
+	if ((MPU->CTRL & MPU_CTRL_ENABLE_Msk) == 0u) {
+		HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+	}
+}
+
+/**
+ * @brief MDMA 读取结束：丢掉传输期间推测读取带进缓存的旧数据，再通知调用者
+ */
+static void qspi_dma_finish(int8_t status)
+{
+	QSPI_W25Qxx_ReadCallback callback = dma_callback;
+	void* context = dma_context;
+
+	SCB_InvalidateDCache_by_Addr((uint32_t*)dma_buffer, (int32_t)dma_length);
+	dma_callback = NULL;
+	dma_context = NULL;
+	dma_status = status;
+	dma_busy = false;
+	if (callback != NULL) {
+		callback(status, context);
+	}
+}
+
+void HAL_QSPI_RxCpltCallback(QSPI_HandleTypeDef* hqspi)
+{
+	(void)hqspi;
+	if (dma_busy) {
+		qspi_dma_finish(QSPI_W25Qxx_OK);
+	}
+}
+
+void HAL_QSPI_ErrorCallback(QSPI_HandleTypeDef* hqspi)
+{
+	(void)hqspi;
+	if (dma_busy) {
+		qspi_dma_finish(W25Qxx_ERROR_TRANSMIT);
+	}
+}
+
+void QSPI_W25Qxx_IRQHandler(void)
+{
+	HAL_QSPI_IRQHandler(&hqspi);
+}
+
+void QSPI_W25Qxx_MDMA_IRQHandler(void)
+{
+	HAL_MDMA_IRQHandler(&hmdma_qspi);
+}
+
+/**
+ * @brief 等待 MDMA 读取结束，超时则中止传输
+ * @return QSPI_W25Qxx_OK - 没有进行中的读取，W25Qxx_ERROR_TRANSMIT - 超时
+ */
+static int8_t qspi_wait_dma(void)
+{
+	const uint32_t start = HAL_GetTick();
+	while (dma_busy) {
+		if (HAL_GetTick() - start > HAL_QPSI_TIMEOUT_DEFAULT_VALUE) {
+			QSPI_W25Qxx_ERR("MDMA read timeout");
+			HAL_QSPI_Abort(&hqspi);
+			if (dma_busy) {
+				qspi_dma_finish(W25Qxx_ERROR_TRANSMIT);
+			}
+			return W25Qxx_ERROR_TRANSMIT;
+		}
+	}
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 发送 Fast Read Quad I/O (0xEB) 间接读命令
+ * 说    明: 1-4-4 模式，地址后的模式字节固定发 W25Qxx_FastReadQuad_IO_MODE，器件不会进入连续读模式，
+ *			 之后的复位、擦写命令照常识别
+ */
+static int8_t qspi_read_command(uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+	QSPI_CommandTypeDef s_command;
+
+	s_command.InstructionMode    = QSPI_INSTRUCTION_1_LINE;		// 1线指令
+	s_command.Instruction        = W25Qxx_CMD_FastReadQuad_IO;	// Fast Read Quad I/O
+	s_command.AddressMode        = QSPI_ADDRESS_4_LINES;		// 4线地址
+	s_command.AddressSize        = QSPI_ADDRESS_24_BITS;
+	s_command.Address            = ReadAddr;
+	s_command.AlternateByteMode  = QSPI_ALTERNATE_BYTES_4_LINES;	// 模式字节 M7-0
+	s_command.AlternateBytesSize = QSPI_ALTERNATE_BYTES_8_BITS;
+	s_command.AlternateBytes     = W25Qxx_FastReadQuad_IO_MODE;
+	s_command.DataMode           = QSPI_DATA_4_LINES;			// 4线数据
+	s_command.DummyCycles        = W25Qxx_FastReadQuad_IO_DUMMY;
+	s_command.NbData             = NumByteToRead;
+	s_command.DdrMode            = QSPI_DDR_MODE_DISABLE;
+	s_command.DdrHoldHalfCycle   = QSPI_DDR_HHC_ANALOG_DELAY;
+	s_command.SIOOMode           = QSPI_SIOO_INST_EVERY_CMD;
+
+	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+		QSPI_W25Qxx_ERR("Command failed");
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief CPU 读 FIFO 的间接读取
+ */
+static int8_t qspi_receive(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+	if (qspi_read_command(ReadAddr, NumByteToRead) != QSPI_W25Qxx_OK) {
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	if (HAL_QSPI_Receive(&hqspi, pBuffer, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+		QSPI_W25Qxx_ERR("Receive failed");
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 发出 MDMA 间接读取后立即返回，pBuffer 和长度必须按 W25Qxx_DMA_ALIGN 对齐
+ * 说    明: 传输前先丢掉目标区域的缓存行，避免传输期间被换出的脏行覆盖 MDMA 写入的数据
+ */
+static int8_t qspi_receive_dma_start(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead,
+									 QSPI_W25Qxx_ReadCallback callback, void* context)
+{
+	SCB_InvalidateDCache_by_Addr((uint32_t*)pBuffer, (int32_t)NumByteToRead);
+
+	dma_buffer = pBuffer;
+	dma_length = NumByteToRead;
+	dma_callback = callback;
+	dma_context = context;
+	dma_status = QSPI_W25Qxx_OK;
+	dma_busy = true;
+
+	if (qspi_read_command(ReadAddr, NumByteToRead) != QSPI_W25Qxx_OK
+		|| HAL_QSPI_Receive_DMA(&hqspi, pBuffer) != HAL_OK) {
+		QSPI_W25Qxx_ERR("Receive DMA failed");
+		dma_callback = NULL;
+		dma_context = NULL;
+		dma_busy = false;
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 阻塞读取：长数据的对齐部分走 MDMA，首尾不满一个缓存行的部分由 CPU 读
+ */
+static int8_t qspi_read(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+	int8_t status;
+
+	if (NumByteToRead < QSPI_W25Qxx_DMA_MIN_SIZE) {
+		return qspi_receive(pBuffer, ReadAddr, NumByteToRead);
+	}
+
+	const uint32_t head = (uint32_t)(-(uintptr_t)pBuffer) & (W25Qxx_DMA_ALIGN - 1);
+	const uint32_t body = (NumByteToRead - head) & ~(uint32_t)(W25Qxx_DMA_ALIGN - 1);
+	const uint32_t tail = NumByteToRead - head - body;
+
+	if (head > 0 && (status = qspi_receive(pBuffer, ReadAddr, head)) != QSPI_W25Qxx_OK) {
+		return status;
+	}
+	if ((status = qspi_receive_dma_start(pBuffer + head, ReadAddr + head, body, NULL, NULL)) != QSPI_W25Qxx_OK) {
+		return status;
+	}
+	if ((status = qspi_wait_dma()) != QSPI_W25Qxx_OK) {
+		return status;
+	}
+	if (dma_status != QSPI_W25Qxx_OK) {
+		return dma_status;
+	}
+	if (tail > 0) {
+		return qspi_receive(pBuffer + head + body, ReadAddr + head + body, tail);
+	}
+	return QSPI_W25Qxx_OK;
+}
+
 /**
  * @brief 
  * 函数功能: 使用自动轮询标志查询，等待通信结束
@@ -222,10 +552,89 @@ int8_t QSPI_W25Qxx_AutoPollingMemReady(void)
 	{
 		return W25Qxx_ERROR_AUTOPOLLING; // 轮询等待无响应
 	}
+	op_pending = false;
 	return QSPI_W25Qxx_OK; // 通信正常结束
 
 }
 
+/**
+ * @brief 
+ * 函数功能: 等待进行中的 MDMA 读取和之前用 _Start 函数发出的擦除/编程结束，没有未完成的操作时立即返回
+ * 说    明: 器件忙时只响应读状态命令，其它读写、复位和进入内存映射之前都要先调用
+ * 
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 器件空闲，W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应或读取超时
+ */
+int8_t QSPI_W25Qxx_WaitReady(void)
+{
+	if (qspi_wait_dma() != QSPI_W25Qxx_OK)
+	{
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+	if (!op_pending)
+	{
+		return QSPI_W25Qxx_OK;
+	}
+	return QSPI_W25Qxx_AutoPollingMemReady();
+}
+
+/**
+ * @brief 
+ * 函数功能: 读一次状态寄存器1，查询之前发出的擦除/编程是否结束，不等待
+ * 说    明: 只发一条读状态命令，耗时几微秒，可以在主循环里每轮调用
+ * 
+ * @param ready 	输出：器件空闲为 true
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 查询成功，W25Qxx_ERROR_TRANSMIT - 传输失败
+ */
+int8_t QSPI_W25Qxx_PollReady(bool* ready)
+{
+	QSPI_CommandTypeDef s_command;	// QSPI传输配置
+	uint8_t status = 0;
+
+	if (!op_pending)
+	{
+		*ready = true;
+		return QSPI_W25Qxx_OK;
+	}
+
+	s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;			// 1线指令模式
+	s_command.AddressMode       = QSPI_ADDRESS_NONE;				// 无地址模式
+	s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;		//	无交替字节 
+	s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;	     	// 禁止DDR模式
+	s_command.DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;	   	// DDR模式中数据延迟，这里用不到
+	s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;	   		//	每次传输数据都发送指令	
+	s_command.DataMode          = QSPI_DATA_1_LINE;					// 1线数据模式
+	s_command.DummyCycles       = 0;								//	空周期个数
+	s_command.NbData            = 1;								// 读1个字节
+	s_command.Instruction       = W25Qxx_CMD_ReadStatus_REG1;	   	// 读状态信息寄存器
+
+	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+	{
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	if (HAL_QSPI_Receive(&hqspi, &status, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+	{
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+
+	*ready = (status & W25Qxx_Status_REG1_BUSY) == 0;
+	if (*ready)
+	{
+		op_pending = false;
+	}
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 
+ * 函数功能: 是否有已发出但尚未确认结束的擦除/编程
+ */
+bool QSPI_W25Qxx_IsOperationPending(void)
+{
+	return op_pending;
+}
+
 /**
  * @brief 
  * 函数功能: 复位器件
@@ -239,6 +648,12 @@ int8_t QSPI_W25Qxx_Reset(void)
 
 	QSPI_CommandTypeDef s_command;	// QSPI传输配置
 
+	// 复位会打断正在进行的擦除/编程
+	if (QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK)
+	{
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+
 	s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;   	// 1线指令模式
 	s_command.AddressMode 		= QSPI_ADDRESS_NONE;   			// 无地址模式
 	s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE; 	// 无交替字节 
@@ -344,6 +759,12 @@ int8_t QSPI_W25Qxx_WriteEnable(void)
 	s_command.DummyCycles 			= 0;                   	         // 空周期个数
 	s_command.Instruction	 		= W25Qxx_CMD_WriteEnable;      	// 发送写使能命令
 
+	// 器件忙时不接受写使能，先等之前发出的擦除/编程结束
+	if (QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK)
+	{
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+
 	// 发送写使能命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) 
 	{
@@ -386,6 +807,33 @@ int8_t QSPI_W25Qxx_WriteEnable(void)
  * W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应
  */
 int8_t QSPI_W25Qxx_SectorErase(uint32_t SectorAddress)	
+{
+	int8_t result = QSPI_W25Qxx_SectorErase_Start(SectorAddress);
+	if (result != QSPI_W25Qxx_OK)
+	{
+		return result;
+	}
+	// 使用自动轮询标志位，等待擦除的结束 
+	if (QSPI_W25Qxx_AutoPollingMemReady() != QSPI_W25Qxx_OK)
+	{
+		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase: QSPI_W25Qxx_AutoPollingMemReady failure!");
+		return W25Qxx_ERROR_AUTOPOLLING;		// 轮询等待无响应
+	}
+	return QSPI_W25Qxx_OK; // 擦除成功
+}
+
+/**
+ * @brief 
+ * 函数功能: 发出扇区擦除命令后立即返回，不等待擦除结束
+ * 说    明: 之后用 QSPI_W25Qxx_PollReady 查询结束；结束前的其它读写会先等待
+ * 
+ * @param SectorAddress 		要擦除的地址
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 命令已发出
+ * W25Qxx_ERROR_WriteEnable - 写使能失败
+ * W25Qxx_ERROR_Erase - 命令发送失败
+ */
+int8_t QSPI_W25Qxx_SectorErase_Start(uint32_t SectorAddress)
 {
 		// 定义QSPI句柄，这里保留使用cubeMX生成的变量命名，方便用户参考和移植
 
@@ -409,19 +857,15 @@ int8_t QSPI_W25Qxx_SectorErase(uint32_t SectorAddress)
 		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase: QSPI_W25Qxx_WriteEnable failure!");
 		return W25Qxx_ERROR_WriteEnable;		// 写使能失败
 	}
+	qspi_note_modified(SectorAddress & ~(uint32_t)(W25Qxx_SECTOR_SIZE - 1), W25Qxx_SECTOR_SIZE);
 	// 发出擦除命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
 		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase: HAL_QSPI_Command failure!");
 		return W25Qxx_ERROR_Erase;				// 擦除失败
 	}
-	// 使用自动轮询标志位，等待擦除的结束 
-	if (QSPI_W25Qxx_AutoPollingMemReady() != QSPI_W25Qxx_OK)
-	{
-		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase: QSPI_W25Qxx_AutoPollingMemReady failure!");
-		return W25Qxx_ERROR_AUTOPOLLING;		// 轮询等待无响应
-	}
-	return QSPI_W25Qxx_OK; // 擦除成功
+	op_pending = true;
+	return QSPI_W25Qxx_OK; // 命令已发出
 }
 
 /**
@@ -460,6 +904,7 @@ int8_t QSPI_W25Qxx_BlockErase_32K (uint32_t SectorAddress)
 	{
 		return W25Qxx_ERROR_WriteEnable;		// 写使能失败
 	}
+	qspi_note_modified(SectorAddress & ~(uint32_t)(0x8000 - 1), 0x8000);
 	// 发出擦除命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
@@ -510,6 +955,7 @@ int8_t QSPI_W25Qxx_BlockErase_64K (uint32_t SectorAddress)
 	{
 		return W25Qxx_ERROR_WriteEnable;	// 写使能失败
 	}
+	qspi_note_modified(SectorAddress & ~(uint32_t)(0x10000 - 1), 0x10000);
 	// 发出擦除命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
@@ -555,6 +1001,7 @@ int8_t QSPI_W25Qxx_ChipErase (void)
 	{
 		return W25Qxx_ERROR_WriteEnable;	// 写使能失败
 	}
+	qspi_note_modified(0, W25Qxx_FlashSize);
 	// 发出擦除命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
@@ -601,6 +1048,33 @@ int8_t QSPI_W25Qxx_ChipErase (void)
  *				 			W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应
  */
 int8_t QSPI_W25Qxx_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite)
+{
+	int8_t result = QSPI_W25Qxx_WritePage_Start(pBuffer, WriteAddr, NumByteToWrite);
+	if (result != QSPI_W25Qxx_OK)
+	{
+		return result;
+	}
+	// 使用自动轮询标志位，等待写入的结束 
+	if (QSPI_W25Qxx_AutoPollingMemReady() != QSPI_W25Qxx_OK)
+	{
+		return W25Qxx_ERROR_AUTOPOLLING; // 轮询等待无响应
+	}
+	return QSPI_W25Qxx_OK;	// 写数据成功
+}
+
+/**
+ * @brief 
+ * 函数功能: 发出页编程命令并传完数据后立即返回，不等待编程结束
+ * 说    明: 数据已经送进器件的页缓冲，返回后 pBuffer 可以复用；之后用 QSPI_W25Qxx_PollReady 查询结束
+ * 
+ * @param pBuffer 			要写入的数据
+ * @param WriteAddr 		要写入 W25Qxx 的地址
+ * @param NumByteToWrite 	数据长度，最大只能256字节
+ * @return int8_t  			QSPI_W25Qxx_OK 		     - 命令已发出
+ *			    			W25Qxx_ERROR_WriteEnable - 写使能失败
+ *				 			W25Qxx_ERROR_TRANSMIT	 - 传输失败
+ */
+int8_t QSPI_W25Qxx_WritePage_Start(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite)
 {
 		// 定义QSPI句柄，这里保留使用cubeMX生成的变量命名，方便用户参考和移植
 
@@ -624,32 +1098,29 @@ int8_t QSPI_W25Qxx_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumB
 	{
 		return W25Qxx_ERROR_WriteEnable;	// 写使能失败
 	}
+	qspi_note_modified(WriteAddr, NumByteToWrite);
 	// 写命令
 	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
 		return W25Qxx_ERROR_TRANSMIT;		// 传输数据错误
 	}
 	// 开始传输数据
+	op_pending = true;
 	if (HAL_QSPI_Transmit(&hqspi, pBuffer, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
 	{
 		return W25Qxx_ERROR_TRANSMIT;		// 传输数据错误
 	}
-	// 使用自动轮询标志位，等待写入的结束 
-	if (QSPI_W25Qxx_AutoPollingMemReady() != QSPI_W25Qxx_OK)
-	{
-		return W25Qxx_ERROR_AUTOPOLLING; // 轮询等待无响应
-	}
-	return QSPI_W25Qxx_OK;	// 写数据成功
+	return QSPI_W25Qxx_OK;	// 命令已发出
 }
 
 /**
  * @brief 
- *	函数功能: 写入数据，最大不能超过flash芯片的大小，请务必完成擦除操作
+ *	函数功能: 写入数据，最大不能超过flash芯片的大小，涉及的扇区中写入范围以外的字节变为 0xFF
  *	说    明: 	1.Flash的写入时间和擦除时间一样，是有限定的，并不是说QSPI驱动时钟133M就可以以这个速度进行写入
  *				2.按照 W25Q64JV 数据手册给出的 页 写入参考时间，典型值为 0.4ms，最大值为3ms
  *				3.实际的写入速度可能大于0.4ms，也可小于0.4ms
  *				4.Flash使用的时间越长，写入所需时间也会越长
- *				5.在数据写入之前，请务必完成擦除操作
+ *				5.每个扇区先读出比较：内容相同则跳过；只需把 1 写成 0 时不擦除，只编程有变化的页；否则擦除后重写
  *				6.该函数移植于 stm32h743i_eval_qspi.c
  * 
  * @param pBuffer 			要写入的数据
@@ -666,49 +1137,71 @@ int8_t QSPI_W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t Nu
 
 	int8_t status;
 
-	// 计算需要擦除的扇区范围
+	if (NumByteToWrite == 0) {
+		return QSPI_W25Qxx_OK;
+	}
+
+	// 计算涉及的扇区范围
 	uint32_t start_sector = WriteAddr & ~(W25Qxx_SECTOR_SIZE - 1);
 	uint32_t end_sector = (WriteAddr + NumByteToWrite - 1) & ~(W25Qxx_SECTOR_SIZE - 1);
+	uint32_t end_addr = WriteAddr + NumByteToWrite;
 
 	QSPI_W25Qxx_DBG("start_sector: 0x%x, WriteAddr: 0x%x", start_sector, WriteAddr);
 	QSPI_W25Qxx_DBG("end_sector: 0x%x", end_sector);
-	
-	// 擦除所需的扇区
+
 	for(uint32_t sector = start_sector; sector <= end_sector; sector += W25Qxx_SECTOR_SIZE) {
-		QSPI_W25Qxx_DBG("Erasing sector at address 0x%X", (unsigned int)sector);
-		if((status = QSPI_W25Qxx_SectorErase(sector)) != QSPI_W25Qxx_OK) {
-			QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase failed, status: %d", status);
+		// 本扇区内写入的范围 [lo, hi)；范围外的字节写完后为 0xFF，与先擦后写的结果一致
+		uint32_t lo = (WriteAddr > sector) ? WriteAddr : sector;
+		uint32_t hi = (end_addr < sector + W25Qxx_SECTOR_SIZE) ? end_addr : sector + W25Qxx_SECTOR_SIZE;
+		const uint8_t* src = pBuffer + (lo - WriteAddr);
+
+		// 先读出原内容：完全相同的扇区跳过；只需把 1 写成 0 时不擦除，直接编程
+		if((status = QSPI_W25Qxx_ReadBuffer(sector_cache, sector, W25Qxx_SECTOR_SIZE)) != QSPI_W25Qxx_OK) {
+			QSPI_W25Qxx_ERR("QSPI_W25Qxx_ReadBuffer failed, status: %d", status);
 			return status;
 		}
-	}
-
-	// 执行写入操作
-	uint32_t current_addr = WriteAddr;
-	uint32_t end_addr = WriteAddr + NumByteToWrite;
-	uint32_t current_size;
-	uint8_t* write_data = pBuffer;
-
-	while(current_addr < end_addr) {
-		current_size = W25Qxx_PageSize - (current_addr % W25Qxx_PageSize);
-		if(current_size > (end_addr - current_addr)) {
-			current_size = end_addr - current_addr;
+		bool changed = false;
+		bool need_erase = false;
+		for(uint32_t i = 0; i < W25Qxx_SECTOR_SIZE; i++) {
+			uint32_t addr = sector + i;
+			uint8_t want = (addr >= lo && addr < hi) ? src[addr - lo] : 0xFF;
+			uint8_t have = sector_cache[i];
+			if(have != want) {
+				changed = true;
+				if((have & want) != want) {
+					need_erase = true;
+					break;
+				}
+			}
 		}
-
-		// 写使能
-		if (QSPI_W25Qxx_WriteEnable() != QSPI_W25Qxx_OK) {
-			status = W25Qxx_ERROR_WriteEnable;
-			QSPI_W25Qxx_ERR("QSPI_W25Qxx_WriteEnable failed, status: %d", status);
-			return status;
+		if(!changed) {
+			QSPI_W25Qxx_DBG("Sector 0x%X unchanged, skipped", (unsigned int)sector);
+			continue;
 		}
-
-		// 写入数据
-		if((status = QSPI_W25Qxx_WritePage(write_data, current_addr, current_size)) != QSPI_W25Qxx_OK) {
-			QSPI_W25Qxx_ERR("QSPI_W25Qxx_WritePage failed, status: %d", status);
-			return status;
+		if(need_erase) {
+			QSPI_W25Qxx_DBG("Erasing sector at address 0x%X", (unsigned int)sector);
+			if((status = QSPI_W25Qxx_SectorErase(sector)) != QSPI_W25Qxx_OK) {
+				QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorErase failed, status: %d", status);
+				return status;
+			}
+			memset(sector_cache, 0xFF, W25Qxx_SECTOR_SIZE);
 		}
 
-		current_addr += current_size;
-		write_data += current_size;
+		// 只写有变化的页
+		for(uint32_t page = sector; page < sector + W25Qxx_SECTOR_SIZE; page += W25Qxx_PageSize) {
+			uint32_t page_lo = (lo > page) ? lo : page;
+			uint32_t page_hi = (hi < page + W25Qxx_PageSize) ? hi : page + W25Qxx_PageSize;
+			if(page_lo >= page_hi) {
+				continue;
+			}
+			if(memcmp(sector_cache + (page_lo - sector), src + (page_lo - lo), page_hi - page_lo) == 0) {
+				continue;
+			}
+			if((status = QSPI_W25Qxx_WritePage((uint8_t*)src + (page_lo - lo), page_lo, (uint16_t)(page_hi - page_lo))) != QSPI_W25Qxx_OK) {
+				QSPI_W25Qxx_ERR("QSPI_W25Qxx_WritePage failed, status: %d", status);
+				return status;
+			}
+		}
 	}
 
 	status = QSPI_W25Qxx_OK;
@@ -719,12 +1212,12 @@ int8_t QSPI_W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t Nu
  * @brief 
  * 函数功能: 读取数据，最大不能超过flash芯片的大小
  * 说    明: 1.Flash的读取速度取决于QSPI的通信时钟，最大不能超过133M
- *			2.这里使用的是1-4-4模式下(1线指令4线地址4线数据)，快速读取指令 Fast Read Quad I/O
- *			3.使用快速读取指令是有空周期的，具体参考W25Q64JV的手册  Fast Read Quad I/O  （0xEB）指令
- *			4.实际使用中，是否使用DMA、编译器的优化等以及数据存储区的位置(内部 TCM SRAM 或 AXI SRAM)都会影响读取的速度
- *			5.在本例程中，使用的是库函数进行直接读写，keil版本5.30，编译器AC6.14，编译等级Oz image size，读取速度为 7M字节/S ，数据放在 TCM SRAM 或者 AXI SRAM 都是差不多的结果
- *		    6.因为CPU直接访问外设寄存器的效率很低，直接使用HAL库进行读写的话，速度很慢，使用MDMA进行读取，可以达到 58M字节/S
- *	        7. W25Q64JV 所允许的最高驱动频率为133MHz，750的QSPI最高驱动频率也是133MHz ，但是对于HAL库函数直接读取而言，驱动时钟超过15M已经不会对性能有提升，对速度要求高的场合可以用MDMA的方式
+ *			2.这里使用的是1-4-4模式下(1线指令4线地址4线数据)，快速读取指令 Fast Read Quad I/O  （0xEB），模式字节之后 4 个空周期
+ *			3.长度不小于 QSPI_W25Qxx_DMA_MIN_SIZE 时由 MDMA 搬运 FIFO 数据，首尾不满一个缓存行的部分由 CPU 读，
+ *			  CPU直接读外设寄存器的方式大约 7M字节/S，MDMA 可以跑满QSPI时钟
+ *			4.与上一次读取首尾相接、且短于 QSPI_W25Qxx_READAHEAD_SIZE 的读取按顺序流处理：整块预读进缓冲，
+ *			  之后落在缓冲内的读取不再访问器件；任何擦除/编程都会让预读缓冲作废
+ *			5.函数返回前等待传输结束，不想等待时用 QSPI_W25Qxx_ReadBuffer_DMA
  * @param pBuffer 			要读取的数据
  * @param ReadAddr 			要读取 W25Qxx 的地址
  * @param NumByteToRead 	数据长度，最大不能超过flash芯片的大小
@@ -734,72 +1227,124 @@ int8_t QSPI_W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t Nu
  */
 int8_t QSPI_W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
 {
+	int8_t status;
 
 	ReadAddr &= 0x00FFFFFF;
 
-    QSPI_CommandTypeDef s_command;
-    
-    /* 使用 Fast Read Quad Output 命令配置 */
-    s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;    // 1线指令
-    s_command.Instruction       = 0x6B;                       // Fast Read Quad Output
-    s_command.AddressMode      = QSPI_ADDRESS_1_LINE;        // 1线地址
-    s_command.AddressSize      = QSPI_ADDRESS_24_BITS;
-    s_command.Address         = ReadAddr;
-    s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE; // 无交替字节
-    s_command.DataMode         = QSPI_DATA_4_LINES;          // 4线数据输出
-    s_command.DummyCycles      = 8;                          // 8个dummy cycles
-    s_command.NbData          = NumByteToRead;
-    s_command.DdrMode         = QSPI_DDR_MODE_DISABLE;
-    s_command.DdrHoldHalfCycle = QSPI_DDR_HHC_ANALOG_DELAY;
-    s_command.SIOOMode        = QSPI_SIOO_INST_EVERY_CMD;
+	// 擦除/编程期间器件不响应读命令
+	if (QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK) {
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+	if (NumByteToRead == 0) {
+		return QSPI_W25Qxx_OK;
+	}
 
-    // 添加调试信息
-    QSPI_W25Qxx_DBG("Reading with Quad Output: Addr=0x%08X, Size=%d", ReadAddr, NumByteToRead);
+	QSPI_W25Qxx_DBG("Reading with Quad I/O: Addr=0x%08X, Size=%d", ReadAddr, NumByteToRead);
+
+	if (NumByteToRead < QSPI_W25Qxx_READAHEAD_SIZE) {
+		bool hit = readahead_len > 0 && ReadAddr >= readahead_addr
+				   && ReadAddr + NumByteToRead <= readahead_addr + readahead_len;
+		if (!hit && ReadAddr == readahead_next) {
+			// 顺序读取：从这里开始整块读进预读缓冲
+			uint32_t fill = W25Qxx_FlashSize - ReadAddr;
+			if (fill > QSPI_W25Qxx_READAHEAD_SIZE) {
+				fill = QSPI_W25Qxx_READAHEAD_SIZE;
+			}
+			if (fill >= NumByteToRead) {
+				readahead_len = 0;
+				if ((status = qspi_read(readahead_buf, ReadAddr, fill)) != QSPI_W25Qxx_OK) {
+					return status;
+				}
+				readahead_addr = ReadAddr;
+				readahead_len = fill;
+				hit = true;
+			}
+		}
+		if (hit) {
+			memcpy(pBuffer, readahead_buf + (ReadAddr - readahead_addr), NumByteToRead);
+			readahead_next = ReadAddr + NumByteToRead;
+			return QSPI_W25Qxx_OK;
+		}
+	}
 
-    // 发送读取命令
-    if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
-        QSPI_W25Qxx_ERR("Command failed");
-        return W25Qxx_ERROR_TRANSMIT;
-    }
+	status = qspi_read(pBuffer, ReadAddr, NumByteToRead);
+	readahead_next = ReadAddr + NumByteToRead;
+	return status;
+}
 
-    // 接收数据
-    if (HAL_QSPI_Receive(&hqspi, pBuffer, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
-        QSPI_W25Qxx_ERR("Receive failed");
-        return W25Qxx_ERROR_TRANSMIT;
-    }
+/**
+ * @brief 
+ * 函数功能: 用 MDMA 读取数据，发出命令后立即返回，传输结束后在 QSPI 中断里调用 callback
+ * 说    明: 1.pBuffer 地址和 NumByteToRead 都必须是 W25Qxx_DMA_ALIGN 的整数倍，传输期间缓冲区所在的缓存行不能被 CPU 写入
+ *			2.传输结束前调用其它读写函数、进入/退出内存映射都会先等待本次读取结束
+ *			3.内存映射模式下不能使用
+ * @param pBuffer 			接收缓冲区
+ * @param ReadAddr 			要读取 W25Qxx 的地址
+ * @param NumByteToRead 	数据长度
+ * @param callback 			传输结束回调，可以为 NULL（用 QSPI_W25Qxx_IsReadBusy 查询）
+ * @param context 			原样传给 callback
+ * @return int8_t 			QSPI_W25Qxx_OK 		     - 已发出读取
+ *				 			W25Qxx_ERROR_TRANSMIT	 - 参数不对齐或传输启动失败
+ *				 			W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应
+ *				 			W25Qxx_ERROR_MemoryMapped - 处于内存映射模式
+ */
+int8_t QSPI_W25Qxx_ReadBuffer_DMA(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead,
+								  QSPI_W25Qxx_ReadCallback callback, void* context)
+{
+	ReadAddr &= 0x00FFFFFF;
 
-    return QSPI_W25Qxx_OK;
+	if (NumByteToRead == 0 || (((uintptr_t)pBuffer | NumByteToRead) & (W25Qxx_DMA_ALIGN - 1)) != 0) {
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+	if (xip_enabled) {
+		return W25Qxx_ERROR_MemoryMapped;
+	}
+	if (QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK) {
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+	return qspi_receive_dma_start(pBuffer, ReadAddr, NumByteToRead, callback, context);
+}
+
+/**
+ * @brief 
+ * 函数功能: MDMA 读取是否还在进行
+ */
+bool QSPI_W25Qxx_IsReadBusy(void)
+{
+	return dma_busy;
 }
 
 int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite)
 {
-	bool is_xip = xip_enabled;
-	if(is_xip == true) {
-		QSPI_W25Qxx_ExitMemoryMappedMode();
+	int8_t result = QSPI_W25Qxx_BeginIndirect();
+	if (result != QSPI_W25Qxx_OK) {
+		return result;
 	}
 
-	bool result = QSPI_W25Qxx_WriteBuffer(pData, WriteAddr, NumByteToWrite);
-	
-	if(is_xip == true) {
-		QSPI_W25Qxx_EnterMemoryMappedMode();
-	}
+	result = QSPI_W25Qxx_WriteBuffer(pData, WriteAddr, NumByteToWrite);
 
+	QSPI_W25Qxx_EndIndirect();
 	return result;
 }
 
 int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
 {
-	bool is_xip = xip_enabled;
-	if(is_xip == true) {
-		QSPI_W25Qxx_ExitMemoryMappedMode();
-	}
+	ReadAddr &= 0x00FFFFFF;
 
-	bool result = QSPI_W25Qxx_ReadBuffer(pBuffer, ReadAddr, NumByteToRead);	
+	// 已处于内存映射时直接从映射窗口复制（经过 D-Cache），不必退出映射再复位器件
+	if (xip_enabled && ReadAddr + NumByteToRead <= W25Qxx_FlashSize) {
+		memcpy(pBuffer, (const void*)(uintptr_t)(W25Qxx_Mem_Addr + ReadAddr), NumByteToRead);
+		return QSPI_W25Qxx_OK;
+	}
 
-	if(is_xip == true) {	
-		QSPI_W25Qxx_EnterMemoryMappedMode();
+	int8_t result = QSPI_W25Qxx_BeginIndirect();
+	if (result != QSPI_W25Qxx_OK) {
+		return result;
 	}
 
+	result = QSPI_W25Qxx_ReadBuffer(pBuffer, ReadAddr, NumByteToRead);
+
+	QSPI_W25Qxx_EndIndirect();
 	return result;
 }
 
@@ -867,6 +1412,17 @@ int8_t QSPI_W25Qxx_ExitMemoryMappedMode(void)
 
 	QSPI_W25Qxx_DBG("Exiting XIP mode start...");
 
+	/* 下面的复位会打断正在进行的擦除/编程；处于映射模式时不会有未完成的操作 */
+	if (!xip_enabled && QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK) {
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
+
+	if (xip_enabled) {
+		/* 等读映射区的 DMA 结束，再禁止 CPU 访问窗口 */
+		QSPI_W25Qxx_ExitMappedCallback();
+		qspi_mpu_window(false);
+	}
+
 	/* 中止当前QSPI操作 */
 	if(HAL_QSPI_Abort(&hqspi) != HAL_OK) {
 		QSPI_W25Qxx_ERR("Exit XIP mode failed!");
@@ -901,7 +1457,7 @@ int8_t QSPI_W25Qxx_ExitMemoryMappedMode(void)
 	}
 	
 	/* 等待复位完成 */
-	HAL_Delay(5);
+	qspi_delay_us(W25Qxx_RESET_RECOVERY_US);
 	
 	/* 重新初始化QSPI控制器 */
 	// 可以调用您的QSPI初始化函数，或者在这里添加必要的初始化代码
@@ -926,7 +1482,16 @@ int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void)
 		return QSPI_W25Qxx_OK;
 	}
 
-	xip_enabled = true;
+	// 有人持有间接模式会话：记下来，会话结束时再进入
+	if (indirect_depth > 0) {
+		remap_on_release = true;
+		return W25Qxx_ERROR_MemoryMapped;
+	}
+
+	// 擦除/编程结束前映射读到的是无效数据
+	if (QSPI_W25Qxx_WaitReady() != QSPI_W25Qxx_OK) {
+		return W25Qxx_ERROR_AUTOPOLLING;
+	}
 
 	QSPI_CommandTypeDef      s_command;
 	QSPI_MemoryMappedTypeDef s_mem_mapped_cfg;
@@ -949,7 +1514,131 @@ int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void)
 	QSPI_W25Qxx_DBG("QSPI CR: 0x%08X", QUADSPI->CR);
 	QSPI_W25Qxx_DBG("QSPI DCR: 0x%08X", QUADSPI->DCR);
 	
-	return HAL_QSPI_MemoryMapped(&hqspi, &s_command, &s_mem_mapped_cfg);
+	if (HAL_QSPI_MemoryMapped(&hqspi, &s_command, &s_mem_mapped_cfg) != HAL_OK) {
+		return W25Qxx_ERROR_MemoryMapped;
+	}
+	xip_enabled = true;
+
+	// 窗口改为可缓存；Write-Through 不会有脏行，退出映射期间擦写过的范围直接失效
+	qspi_mpu_window(true);
+	if (dirty_hi > dirty_lo) {
+		const uint32_t start = (W25Qxx_Mem_Addr + dirty_lo) & ~31u;
+		const uint32_t end = (W25Qxx_Mem_Addr + (dirty_hi < W25Qxx_FlashSize ? dirty_hi : W25Qxx_FlashSize) + 31u) & ~31u;
+		SCB_InvalidateDCache_by_Addr((uint32_t*)start, (int32_t)(end - start));
+	}
+	dirty_lo = 0xFFFFFFFF;
+	dirty_hi = 0;
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 
+ * 函数功能: 开始一次间接模式会话，擦写和间接读取之前调用，与 QSPI_W25Qxx_EndIndirect 成对使用
+ * 说    明: 会话可以嵌套，只有最外层在处于内存映射时退出映射；会话期间 QSPI_W25Qxx_EnterMemoryMappedMode
+ *			 不会切换模式，只记下需要在会话结束时恢复
+ * 
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 已处于间接模式，其它 - 退出内存映射失败（会话未建立）
+ */
+int8_t QSPI_W25Qxx_BeginIndirect(void)
+{
+	if (indirect_depth > 0) {
+		indirect_depth++;
+		return QSPI_W25Qxx_OK;
+	}
+	if (xip_enabled) {
+		int8_t status = QSPI_W25Qxx_ExitMemoryMappedMode();
+		if (status != QSPI_W25Qxx_OK) {
+			return status;
+		}
+		remap_on_release = true;
+	}
+	indirect_depth = 1;
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 
+ * 函数功能: 结束间接模式会话，最外层按需恢复内存映射，并执行排队等待映射的读者
+ * 
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 成功，其它 - 进入内存映射失败
+ */
+int8_t QSPI_W25Qxx_EndIndirect(void)
+{
+	int8_t status = QSPI_W25Qxx_OK;
+
+	if (indirect_depth == 0 || --indirect_depth > 0) {
+		return QSPI_W25Qxx_OK;
+	}
+	if (remap_on_release || deferred_count > 0) {
+		remap_on_release = false;
+		status = QSPI_W25Qxx_EnterMemoryMappedMode();
+	}
+	if (xip_enabled) {
+		// 回调里可能再次排队，先取出当前队列
+		const uint8_t count = deferred_count;
+		QSPI_W25Qxx_MappedCallback callbacks[QSPI_W25Qxx_DEFER_DEPTH];
+		void* contexts[QSPI_W25Qxx_DEFER_DEPTH];
+		for (uint8_t i = 0; i < count; i++) {
+			callbacks[i] = deferred[i].callback;
+			contexts[i] = deferred[i].context;
+		}
+		deferred_count = 0;
+		for (uint8_t i = 0; i < count; i++) {
+			callbacks[i](contexts[i]);
+		}
+	}
+	return status;
+}
+
+/**
+ * @brief 
+ * 函数功能: 是否有间接模式会话（映射区此时不可读）
+ */
+bool QSPI_W25Qxx_IsIndirectHeld(void)
+{
+	return indirect_depth > 0;
+}
+
+/**
+ * @brief 
+ * 函数功能: 在映射区可读时执行 callback
+ * 说    明: 没有间接模式会话时（必要时先进入内存映射）立即执行；否则排队，会话结束恢复映射后执行。
+ *			 同一 callback/context 只排一次
+ * 
+ * @return bool true - 已执行或已排队，false - 进入内存映射失败或队列已满
+ */
+bool QSPI_W25Qxx_RunWhenMapped(QSPI_W25Qxx_MappedCallback callback, void* context)
+{
+	if (indirect_depth == 0) {
+		if (!xip_enabled && QSPI_W25Qxx_EnterMemoryMappedMode() != QSPI_W25Qxx_OK) {
+			return false;
+		}
+		callback(context);
+		return true;
+	}
+	for (uint8_t i = 0; i < deferred_count; i++) {
+		if (deferred[i].callback == callback && deferred[i].context == context) {
+			return true;
+		}
+	}
+	if (deferred_count >= QSPI_W25Qxx_DEFER_DEPTH) {
+		return false;
+	}
+	deferred[deferred_count].callback = callback;
+	deferred[deferred_count].context = context;
+	deferred_count++;
+	return true;
+}
+
+/**
+ * @brief 
+ * 函数功能: 退出内存映射前调用，默认为空
+ * 说    明: 会在后台读映射区的 DMA（例如屏幕的 DMA2D）在这里等待传输结束
+ */
+__weak void QSPI_W25Qxx_ExitMappedCallback(void)
+{
 }
 
 /**
@@ -1018,6 +1707,25 @@ int8_t QSPI_W25Qxx_ReadString(char* buffer, uint32_t ReadAddr)
 	}
 }
 
+/**
+ * @brief  读出判断 [addr, addr + size) 是否已全部为 0xFF，遇到非 0xFF 立即返回
+ * 读 4KB 不到 1ms，擦除一个扇区约 45ms，空白的扇区不必再擦
+ */
+static bool qspi_is_erased(uint32_t addr, uint32_t size)
+{
+	for (uint32_t off = 0; off < size; off += W25Qxx_SECTOR_SIZE) {
+		if (QSPI_W25Qxx_ReadBuffer(sector_cache, addr + off, W25Qxx_SECTOR_SIZE) != QSPI_W25Qxx_OK) {
+			return false;
+		}
+		for (uint32_t i = 0; i < W25Qxx_SECTOR_SIZE; i++) {
+			if (sector_cache[i] != 0xFF) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 /**
  * @brief  擦除指定地址范围的数据
  * @param  StartAddr 起始地址
@@ -1051,34 +1759,40 @@ int8_t QSPI_W25Qxx_BufferErase(uint32_t StartAddr, uint32_t Size)
 
     CurrentAddr = StartAddr;
     
-    // 按照64K块、32K块和4K扇区依次擦除
+    // 按照64K块、32K块和4K扇区依次擦除，已经是空白的块跳过
     while(CurrentAddr <= EndAddr) {
         uint32_t remainSize = EndAddr - CurrentAddr + 1;
 
         // 如果剩余大小>=64K且地址对齐64K，使用64K块擦除
         if(remainSize >= 64*1024 && (CurrentAddr & (64*1024-1)) == 0) {
-            result = QSPI_W25Qxx_BlockErase_64K(CurrentAddr);
-            if(result != QSPI_W25Qxx_OK) {
-                QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase 64K block erase failure. error: %d", result);
-                return result;
+            if(!qspi_is_erased(CurrentAddr, 64*1024)) {
+                result = QSPI_W25Qxx_BlockErase_64K(CurrentAddr);
+                if(result != QSPI_W25Qxx_OK) {
+                    QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase 64K block erase failure. error: %d", result);
+                    return result;
+                }
             }
             CurrentAddr += 64*1024;
         }
         // 如果剩余大小>=32K且地址对齐32K，使用32K块擦除
         else if(remainSize >= 32*1024 && (CurrentAddr & (32*1024-1)) == 0) {
-            result = QSPI_W25Qxx_BlockErase_32K(CurrentAddr);
-            if(result != QSPI_W25Qxx_OK) {
-				QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase 32K block erase failure. error: %d", result);
-                return result;
+            if(!qspi_is_erased(CurrentAddr, 32*1024)) {
+                result = QSPI_W25Qxx_BlockErase_32K(CurrentAddr);
+                if(result != QSPI_W25Qxx_OK) {
+                    QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase 32K block erase failure. error: %d", result);
+                    return result;
+                }
             }
             CurrentAddr += 32*1024;
         }
         // 否则使用4K扇区擦除
         else {
-            result = QSPI_W25Qxx_SectorErase(CurrentAddr);
-            if(result != QSPI_W25Qxx_OK) {
-                QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase sector erase failure. error: %d", result);
-                return result;
+            if(!qspi_is_erased(CurrentAddr & ~(W25Qxx_SECTOR_SIZE - 1), W25Qxx_SECTOR_SIZE)) {
+                result = QSPI_W25Qxx_SectorErase(CurrentAddr);
+                if(result != QSPI_W25Qxx_OK) {
+                    QSPI_W25Qxx_ERR("QSPI_W25Qxx_BufferErase sector erase failure. error: %d", result);
+                    return result;
+                }
             }
             CurrentAddr += 4*1024;
         }
@@ -44,6 +44,8 @@ extern "C" {
 
 #define W25Qxx_CMD_QuadInputPageProgram  	0x32  		// 1-1-4模式下(1线指令1线地址4线数据)，页编程指令，参考写入时间 0.4ms 
 #define W25Qxx_CMD_FastReadQuad_IO       	0xEB  		// 1-4-4模式下(1线指令4线地址4线数据)，快速读取指令
+#define W25Qxx_FastReadQuad_IO_MODE			0xFF		// 0xEB 地址后的 M7-0，M5-4 不为 10b 时不进入连续读模式
+#define W25Qxx_FastReadQuad_IO_DUMMY		4			// 0xEB 模式字节之后的空周期个数
 
 #define W25Qxx_CMD_ReadStatus_REG1			0X05			// 读状态寄存器1
 #define W25Qxx_Status_REG1_BUSY  			0x01			// 读状态寄存器1的第0位（只读），Busy标志位，当正在擦除/写入数据/写命令时会被置1
@@ -55,6 +57,7 @@ extern "C" {
 #define W25Qxx_ChipErase_TIMEOUT_MAX		100000U		// 超时等待时间，W25Q64整片擦除所需最大时间是100S
 #define W25Qxx_Mem_Addr							0x90000000 	// 内存映射模式的地址
 #define W25Qxx_SECTOR_SIZE     0x1000      // 4KB
+#define W25Qxx_DMA_ALIGN       32          // MDMA 读取的缓冲区对齐（D-Cache 行大小）
 
 #define W25Qxx_CMD_PageProgram           0x02  // 标准页编程指令
 #define W25Qxx_CMD_QuadPageProgram       0x32  // 四线页编程指令
@@ -99,8 +102,32 @@ int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void); // 进入内存映射模式
 int8_t QSPI_W25Qxx_ExitMemoryMappedMode(void);  // 退出内存映射模式
 bool QSPI_W25Qxx_IsMemoryMappedMode(void);       // 判断是否处于内存映射模式
 
+// 访问仲裁：擦写和间接读取放在间接模式会话里，会话可以嵌套，只有最外层切换模式；
+// 会话期间进入内存映射的请求推迟到会话结束，等待映射的读者排队到那时执行
+typedef void (*QSPI_W25Qxx_MappedCallback)(void* context);
+int8_t QSPI_W25Qxx_BeginIndirect(void);			// 开始间接模式会话，必要时退出内存映射
+int8_t QSPI_W25Qxx_EndIndirect(void);			// 结束会话，最外层恢复内存映射并执行排队的读者
+bool QSPI_W25Qxx_IsIndirectHeld(void);			// 有会话时映射区不可读
+bool QSPI_W25Qxx_RunWhenMapped(QSPI_W25Qxx_MappedCallback callback, void* context);	// 映射区可读时执行 callback，否则排队
+void QSPI_W25Qxx_ExitMappedCallback(void);		// 弱函数：退出内存映射前等待读映射区的 DMA
+
 int8_t QSPI_W25Qxx_QuadEnable(void);
 
+// 后台擦写：只发命令不等待，由调用者轮询结束；结束前调用其它读写函数会先等待
+int8_t QSPI_W25Qxx_SectorErase_Start(uint32_t SectorAddress);	// 发出扇区擦除后立即返回
+int8_t QSPI_W25Qxx_WritePage_Start(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite);	// 发出页编程后立即返回
+int8_t QSPI_W25Qxx_PollReady(bool* ready);	// 读一次状态寄存器，不等待
+int8_t QSPI_W25Qxx_WaitReady(void);			// 等待已发出的擦写结束
+bool QSPI_W25Qxx_IsOperationPending(void);
+
+// MDMA 异步读取：回调在 QSPI 中断里执行，status 为 QSPI_W25Qxx_OK 或错误码
+typedef void (*QSPI_W25Qxx_ReadCallback)(int8_t status, void* context);
+int8_t QSPI_W25Qxx_ReadBuffer_DMA(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead,
+								  QSPI_W25Qxx_ReadCallback callback, void* context);	// 发出读取后立即返回，缓冲区和长度按 W25Qxx_DMA_ALIGN 对齐
+bool QSPI_W25Qxx_IsReadBusy(void);				// MDMA 读取进行中
+void QSPI_W25Qxx_IRQHandler(void);				// QUADSPI_IRQHandler 中调用
+void QSPI_W25Qxx_MDMA_IRQHandler(void);			// MDMA_IRQHandler 中调用
+
 #ifdef __cplusplus
 }
 #endif
@@ -216,6 +216,13 @@ int8_t RotEnc_GetDetentDelta(void) {
     return v;
 }
 
+bool RotEnc_HasPendingInput(void) {
+    if (g_rotenc.bootIgnoreActive) return false;
+    if (g_rotenc.detentDeltaAcc != 0) return true;
+    if (g_rotenc.btnDown || g_rotenc.btnPressed || g_rotenc.btnReleased || g_rotenc.btnClicked || g_rotenc.btnLongPressed) return true;
+    return rotenc_read_button_raw_down() != g_rotenc.btnStable;
+}
+
 bool RotEnc_IsButtonDown(void) {
     return g_rotenc.btnDown;
 }
@@ -30,6 +30,12 @@ void RotEnc_Init(void);
 void RotEnc_Update(void);
 void RotEnc_OnEdgeIRQ(void);
 
+/**
+ * @brief 是否有尚未被 RotEnc_Update 处理或尚未被读取的旋转、按键输入
+ * 只读取中断累计值和按键引脚，供屏幕空闲时低成本地判断是否需要唤醒
+ */
+bool RotEnc_HasPendingInput(void);
+
 int16_t RotEnc_GetDelta(void);
 int8_t RotEnc_GetDetentDelta(void);
 
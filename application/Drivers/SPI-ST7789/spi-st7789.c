@@ -23,6 +23,21 @@ static volatile uint8_t g_test_phase = 0;
 static bool g_bl_tim_ready = false;
 static uint16_t g_fill_color565 = 0xFFFFu;
 
+/* 帧缓冲刷新：像素已按面板字节序存放，DMA 直接从帧缓冲逐段发送，段与段之间在 TxCplt 中断里衔接。
+ * 多个矩形依次刷新，切换矩形需要发送 CASET/RASET 命令，由 SPIST7789_Service 在主循环中完成 */
+static volatile bool g_flush_active = false;
+static volatile bool g_flush_window_pending = false;
+static const uint16_t* g_flush_fb = NULL;
+static uint16_t g_flush_fb_stride = 0;
+static SPIST7789_Rect g_flush_rects[ST7789_DIRTY_MAX_RECTS];
+static uint8_t g_flush_rect_count = 0;
+static volatile uint8_t g_flush_rect_index = 0;
+static const uint8_t* g_flush_ptr = NULL;
+static uint32_t g_flush_stride_bytes = 0;
+static uint16_t g_flush_rows_per_chunk = 0;
+static uint16_t g_flush_row_bytes = 0;
+static volatile uint16_t g_flush_rows_left = 0;
+
 static inline void gpio_write(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state)
 {
     HAL_GPIO_WritePin(port, pin, state);
@@ -227,6 +242,83 @@ static bool start_fill_async(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uin
     return true;
 }
 
+static bool start_flush_chunk(void)
+{
+    uint16_t rows = g_flush_rows_left;
+    if (rows > g_flush_rows_per_chunk) rows = g_flush_rows_per_chunk;
+    uint16_t len = (uint16_t)(rows * g_flush_row_bytes);
+    const uint8_t* ptr = g_flush_ptr;
+    g_flush_ptr += g_flush_stride_bytes;
+    g_flush_rows_left = (uint16_t)(g_flush_rows_left - rows);
+    return (HAL_SPI_Transmit_DMA(&g_hspi, (uint8_t*)ptr, len) == HAL_OK);
+}
+
+static void finish_flush(bool ok)
+{
+    cs_high();
+    g_flush_active = false;
+    g_flush_window_pending = false;
+    g_busy = false;
+    if (ok) g_dma_done_flag = 1;
+    else g_dma_err_flag = 1;
+}
+
+static bool begin_flush_rect(const SPIST7789_Rect* r)
+{
+    const uint32_t stride_bytes = (uint32_t)g_flush_fb_stride * 2u;
+    const uint8_t* first = (const uint8_t*)(g_flush_fb + (uint32_t)r->y * g_flush_fb_stride + r->x);
+
+    /* 整行宽度的区域在内存中连续，可以多行合并为一次 DMA；否则每行一次 */
+    g_flush_row_bytes = (uint16_t)(r->w * 2u);
+    if (r->w == g_flush_fb_stride) {
+        g_flush_rows_per_chunk = (uint16_t)(SPIST7789_FLUSH_MAX_DMA_BYTES / g_flush_row_bytes);
+        if (g_flush_rows_per_chunk == 0u) return false;
+    } else {
+        g_flush_rows_per_chunk = 1u;
+    }
+    g_flush_stride_bytes = stride_bytes * g_flush_rows_per_chunk;
+    g_flush_ptr = first;
+    g_flush_rows_left = r->h;
+
+    /* DMA 不经过 D-Cache，发送前把 CPU 写入的像素写回内存 */
+    dcache_clean(first, (size_t)(r->h - 1u) * stride_bytes + g_flush_row_bytes);
+
+    if (!set_window(r->x, r->y, r->w, r->h)) return false;
+    return start_flush_chunk();
+}
+
+static bool start_flush_async(const uint16_t* fb, uint16_t fb_stride, const SPIST7789_Rect* rects, uint8_t count)
+{
+    if (!fb || !rects || count == 0u || count > ST7789_DIRTY_MAX_RECTS) return false;
+    if (g_busy) return false;
+    if (!spi_wait_ready(50)) return false;
+
+    g_flush_rect_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const SPIST7789_Rect* r = &rects[i];
+        if (r->w == 0u || r->h == 0u) continue;
+        if (r->x >= ST7789_WIDTH || r->y >= ST7789_HEIGHT) continue;
+        SPIST7789_Rect* dst = &g_flush_rects[g_flush_rect_count++];
+        *dst = *r;
+        if ((uint32_t)dst->x + dst->w > ST7789_WIDTH) dst->w = (uint16_t)(ST7789_WIDTH - dst->x);
+        if ((uint32_t)dst->y + dst->h > ST7789_HEIGHT) dst->h = (uint16_t)(ST7789_HEIGHT - dst->y);
+    }
+    if (g_flush_rect_count == 0u) return true;
+
+    g_flush_fb = fb;
+    g_flush_fb_stride = fb_stride;
+    g_flush_rect_index = 0;
+    g_busy = true;
+    g_flush_active = true;
+    g_flush_window_pending = false;
+    g_spi_txc_flag = false;
+    if (!begin_flush_rect(&g_flush_rects[0])) {
+        finish_flush(false);
+        return false;
+    }
+    return true;
+}
+
 static bool backlight_tim12_init(void)
 {
     if (g_bl_tim_ready) return true;
@@ -276,15 +368,31 @@ void SPIST7789_SPI_IRQHandler(void)
 
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
 {
-    if (hspi == &g_hspi) {
-        g_spi_txc_flag = true;
+    if (hspi != &g_hspi) return;
+    if (g_flush_active) {
+        /* 帧缓冲刷新在中断内直接衔接下一段，不依赖主循环调用 SPIST7789_Service */
+        if (g_flush_rows_left == 0u) {
+            if ((uint8_t)(g_flush_rect_index + 1u) < g_flush_rect_count) {
+                cs_high();
+                g_flush_rect_index++;
+                g_flush_window_pending = true;
+            } else {
+                finish_flush(true);
+            }
+        } else if (!start_flush_chunk()) {
+            finish_flush(false);
+        }
+        return;
     }
+    g_spi_txc_flag = true;
 }
 
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
 {
     if (hspi != &g_hspi) return;
     cs_high();
+    g_flush_active = false;
+    g_flush_window_pending = false;
     g_busy = false;
     g_dma_err_flag = 1;
 }
@@ -385,9 +493,27 @@ bool SPIST7789_FillRectColor565Async(uint16_t x, uint16_t y, uint16_t w, uint16_
     return start_fill_async(x, y, w, h, color565);
 }
 
+bool SPIST7789_FlushRectsAsync(const uint16_t* fb, uint16_t fb_stride, const SPIST7789_Rect* rects, uint8_t count)
+{
+    return start_flush_async(fb, fb_stride, rects, count);
+}
+
+bool SPIST7789_FlushRectAsync(const uint16_t* fb, uint16_t fb_stride, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    SPIST7789_Rect r = {x, y, w, h};
+    return start_flush_async(fb, fb_stride, &r, 1u);
+}
+
 void SPIST7789_Service(void)
 {
     if (!g_busy) return;
+    if (g_flush_window_pending) {
+        g_flush_window_pending = false;
+        if (!begin_flush_rect(&g_flush_rects[g_flush_rect_index])) {
+            finish_flush(false);
+        }
+        return;
+    }
     if (!g_spi_txc_flag) return;
 
     g_spi_txc_flag = false;
@@ -442,7 +568,7 @@ bool SPIST7789_ConsumeDmaErrFlag(void)
 
 void SPIST7789_OnSpiTxCplt(SPI_HandleTypeDef* hspi)
 {
-    if (hspi == &g_hspi) g_spi_txc_flag = true;
+    HAL_SPI_TxCpltCallback(hspi);
 }
 
 void SPIST7789_GetDebug(uint32_t* out_ndtr, uint32_t* out_dma_cr, uint32_t* out_dma_isr, uint32_t* out_spi_sr, uint32_t* out_spi_cfg1, uint32_t* out_spi_cr1, uint32_t* out_spi_cr2)
@@ -460,1046 +586,3 @@ void SPIST7789_GetDebug(uint32_t* out_ndtr, uint32_t* out_dma_cr, uint32_t* out_
     if (out_spi_cr1) *out_spi_cr1 = g_hspi.Instance ? g_hspi.Instance->CR1 : 0;
     if (out_spi_cr2) *out_spi_cr2 = g_hspi.Instance ? g_hspi.Instance->CR2 : 0;
 }
-
-static int st7789_abs_i(int v) { return (v < 0) ? -v : v; }
-static uint16_t st7789_fb[ST7789_WIDTH * ST7789_HEIGHT] __attribute__((section(".DMA_Section"), aligned(32)));
-
-static uint16_t st7789_rgb888_to_565(uint32_t rgb888)
-{
-    uint8_t r = (uint8_t)((rgb888 >> 16) & 0xFFu);
-    uint8_t g = (uint8_t)((rgb888 >> 8) & 0xFFu);
-    uint8_t b = (uint8_t)(rgb888 & 0xFFu);
-    return (uint16_t)(((uint16_t)(r & 0xF8u) << 8) | ((uint16_t)(g & 0xFCu) << 3) | (uint16_t)(b >> 3));
-}
-
-static inline uint32_t st7789_fb_index(uint16_t x, uint16_t y)
-{
-    return (uint32_t)y * (uint32_t)ST7789_WIDTH + (uint32_t)x;
-}
-
-static void st7789_mark_dirty_xy(ST7789_Handle* lcd, uint16_t x, uint16_t y)
-{
-    if (!lcd) return;
-    if (!lcd->dirty_valid) {
-        lcd->dirty_valid = true;
-        lcd->dirty_x0 = x;
-        lcd->dirty_y0 = y;
-        lcd->dirty_x1 = x;
-        lcd->dirty_y1 = y;
-        return;
-    }
-    if (x < lcd->dirty_x0) lcd->dirty_x0 = x;
-    if (y < lcd->dirty_y0) lcd->dirty_y0 = y;
-    if (x > lcd->dirty_x1) lcd->dirty_x1 = x;
-    if (y > lcd->dirty_y1) lcd->dirty_y1 = y;
-}
-
-static void st7789_fb_clear(ST7789_Handle* lcd, uint16_t c565)
-{
-    if (!lcd || !lcd->framebuffer_enabled || !lcd->fb_back) return;
-    uint32_t pixels = (uint32_t)ST7789_WIDTH * (uint32_t)ST7789_HEIGHT;
-    bool changed = false;
-    for (uint32_t i = 0; i < pixels; i++) {
-        if (lcd->fb_back[i] != c565) {
-            lcd->fb_back[i] = c565;
-            changed = true;
-        }
-    }
-    if (changed) {
-        lcd->dirty_valid = true;
-        lcd->dirty_x0 = 0;
-        lcd->dirty_y0 = 0;
-        lcd->dirty_x1 = (uint16_t)(ST7789_WIDTH - 1u);
-        lcd->dirty_y1 = (uint16_t)(ST7789_HEIGHT - 1u);
-    }
-}
-
-static void st7789_fb_fill_rect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c565)
-{
-    if (!lcd || !lcd->framebuffer_enabled || !lcd->fb_back) return;
-    if (w == 0u || h == 0u) return;
-    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
-    uint16_t x1 = (uint16_t)(x + w - 1u);
-    uint16_t y1 = (uint16_t)(y + h - 1u);
-    if (x1 >= ST7789_WIDTH) x1 = (uint16_t)(ST7789_WIDTH - 1u);
-    if (y1 >= ST7789_HEIGHT) y1 = (uint16_t)(ST7789_HEIGHT - 1u);
-    for (uint16_t yy = y; yy <= y1; yy++) {
-        uint32_t row = (uint32_t)yy * (uint32_t)ST7789_WIDTH;
-        for (uint16_t xx = x; xx <= x1; xx++) {
-            uint32_t idx = row + xx;
-            if (lcd->fb_back[idx] != c565) {
-                lcd->fb_back[idx] = c565;
-                st7789_mark_dirty_xy(lcd, xx, yy);
-            }
-        }
-    }
-}
-
-static void st7789_flush_rect(ST7789_Handle* lcd, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
-{
-    if (!lcd || !lcd->fb_back) return;
-    if (x0 > x1 || y0 > y1) return;
-    if (x1 >= ST7789_WIDTH) x1 = (uint16_t)(ST7789_WIDTH - 1u);
-    if (y1 >= ST7789_HEIGHT) y1 = (uint16_t)(ST7789_HEIGHT - 1u);
-    uint16_t w = (uint16_t)(x1 - x0 + 1u);
-    uint16_t h = (uint16_t)(y1 - y0 + 1u);
-    if (!set_window(x0, y0, w, h)) return;
-    uint8_t out[512];
-    for (uint16_t y = y0; y <= y1; y++) {
-        const uint16_t* row = lcd->fb_back + ((uint32_t)y * (uint32_t)ST7789_WIDTH + x0);
-        uint16_t remaining = w;
-        while (remaining) {
-            uint16_t chunkPixels = remaining;
-            if (chunkPixels > (uint16_t)(sizeof(out) / 2u)) chunkPixels = (uint16_t)(sizeof(out) / 2u);
-            for (uint16_t i = 0; i < chunkPixels; i++) {
-                uint16_t c = row[i];
-                out[(uint32_t)i * 2u] = (uint8_t)(c >> 8);
-                out[(uint32_t)i * 2u + 1u] = (uint8_t)(c & 0xFFu);
-            }
-            if (!spi_tx_blocking(out, (uint16_t)(chunkPixels * 2u))) {
-                cs_high();
-                return;
-            }
-            row += chunkPixels;
-            remaining = (uint16_t)(remaining - chunkPixels);
-        }
-    }
-    cs_high();
-}
-
-uint32_t ST7789_RGB(uint8_t r, uint8_t g, uint8_t b)
-{
-    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
-}
-
-void ST7789_Init(ST7789_Handle* lcd, const ST7789_Config* cfg)
-{
-    if (!lcd) return;
-    memset(lcd, 0, sizeof(*lcd));
-    lcd->cfg.width = ST7789_WIDTH;
-    lcd->cfg.height = ST7789_HEIGHT;
-    lcd->cfg.x_offset = 0;
-    lcd->cfg.y_offset = SPIST7789_Y_OFFSET;
-    lcd->cfg.color_mode = ST7789_COLOR_MODE_RGB565;
-    lcd->cfg.rotation = ST7789_ROTATION_270;
-    lcd->cfg.invert = true;
-    lcd->cfg.fps = ST7789_DEFAULT_FPS;
-    lcd->cfg.use_framebuffer = false;
-    if (cfg) lcd->cfg = *cfg;
-    lcd->framebuffer_enabled = lcd->cfg.use_framebuffer;
-    lcd->dirty_valid = false;
-    lcd->fb_front = NULL;
-    lcd->fb_back = NULL;
-    if (lcd->framebuffer_enabled) {
-        lcd->fb_back = st7789_fb;
-        memset(st7789_fb, 0, sizeof(st7789_fb));
-    }
-    SPIST7789_Init();
-    lcd->inited = true;
-}
-
-bool ST7789_IsInited(const ST7789_Handle* lcd)
-{
-    return lcd && lcd->inited;
-}
-
-bool ST7789_IsFrameBlocked(const ST7789_Handle* lcd)
-{
-    return lcd ? lcd->frame_blocked : true;
-}
-
-bool ST7789_FrameBegin(ST7789_Handle* lcd)
-{
-    SPIST7789_Service();
-    if (!lcd || !lcd->inited) return false;
-    if (lcd->cfg.fps == 0) {
-        lcd->frame_blocked = false;
-        return true;
-    }
-    uint32_t intervalMs = 1000u / (uint32_t)lcd->cfg.fps;
-    if (intervalMs == 0u) intervalMs = 1u;
-    uint32_t nowMs = HAL_GetTick();
-    if (lcd->last_frame_ms != 0u && (uint32_t)(nowMs - lcd->last_frame_ms) < intervalMs) {
-        lcd->frame_blocked = true;
-        return false;
-    }
-    lcd->last_frame_ms = nowMs;
-    lcd->frame_blocked = false;
-    return true;
-}
-
-void ST7789_FrameEnd(ST7789_Handle* lcd)
-{
-    if (!lcd || !lcd->inited) return;
-    if (lcd->frame_blocked) return;
-    if (!lcd->framebuffer_enabled) return;
-    if (!lcd->dirty_valid) return;
-    st7789_flush_rect(lcd, lcd->dirty_x0, lcd->dirty_y0, lcd->dirty_x1, lcd->dirty_y1);
-    lcd->dirty_valid = false;
-}
-
-void ST7789_AttachBacklightPWM(ST7789_Handle* lcd, TIM_HandleTypeDef* htim, uint32_t channel)
-{
-    if (!lcd) return;
-    lcd->cfg.bl_htim = htim;
-    lcd->cfg.bl_tim_channel = channel;
-}
-
-void ST7789_SetRotation(ST7789_Handle* lcd, ST7789_Rotation rotation)
-{
-    if (!lcd) return;
-    lcd->cfg.rotation = rotation;
-}
-
-void ST7789_SetOffset(ST7789_Handle* lcd, uint16_t x_offset, uint16_t y_offset)
-{
-    if (!lcd) return;
-    lcd->cfg.x_offset = x_offset;
-    lcd->cfg.y_offset = y_offset;
-}
-
-void ST7789_SetBacklight(ST7789_Handle* lcd, uint8_t percent)
-{
-    (void)lcd;
-    SPIST7789_SetBacklight(percent);
-}
-
-bool ST7789_IsTransferBusy(const ST7789_Handle* lcd)
-{
-    (void)lcd;
-    return SPIST7789_IsBusy();
-}
-
-bool ST7789_FillScreenAsync(ST7789_Handle* lcd, uint32_t rgb888)
-{
-    uint16_t c = st7789_rgb888_to_565(rgb888);
-    if (lcd && lcd->framebuffer_enabled) {
-        st7789_fb_clear(lcd, c);
-        return true;
-    }
-    return SPIST7789_FillRectColor565Async(0u, 0u, ST7789_WIDTH, ST7789_HEIGHT, c);
-}
-
-void ST7789_FillScreen(ST7789_Handle* lcd, uint32_t rgb888)
-{
-    (void)ST7789_FillScreenAsync(lcd, rgb888);
-    (void)SPIST7789_WaitDone(500u);
-}
-
-void ST7789_FillRect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t rgb888)
-{
-    uint16_t c = st7789_rgb888_to_565(rgb888);
-    if (lcd && lcd->framebuffer_enabled) {
-        st7789_fb_fill_rect(lcd, x, y, w, h, c);
-        return;
-    }
-    if (!SPIST7789_FillRectColor565Async(x, y, w, h, c)) return;
-    (void)SPIST7789_WaitDone(200u);
-}
-
-void ST7789_DrawPixel(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint32_t rgb888)
-{
-    if (lcd && lcd->framebuffer_enabled) {
-        if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
-        uint16_t c = st7789_rgb888_to_565(rgb888);
-        uint32_t idx = st7789_fb_index(x, y);
-        if (lcd->fb_back[idx] == c) return;
-        lcd->fb_back[idx] = c;
-        st7789_mark_dirty_xy(lcd, x, y);
-        return;
-    }
-    ST7789_FillRect(lcd, x, y, 1u, 1u, rgb888);
-}
-
-void ST7789_DrawLine(ST7789_Handle* lcd, int x0, int y0, int x1, int y1, uint32_t rgb888)
-{
-    int dx = st7789_abs_i(x1 - x0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int dy = -st7789_abs_i(y1 - y0);
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx + dy;
-    while (1)
-    {
-        if (x0 >= 0 && y0 >= 0 && x0 < (int)ST7789_WIDTH && y0 < (int)ST7789_HEIGHT) {
-            ST7789_DrawPixel(lcd, (uint16_t)x0, (uint16_t)y0, rgb888);
-        }
-        if (x0 == x1 && y0 == y1) break;
-        int e2 = 2 * err;
-        if (e2 >= dy) { err += dy; x0 += sx; }
-        if (e2 <= dx) { err += dx; y0 += sy; }
-    }
-}
-
-void ST7789_DrawRect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t rgb888)
-{
-    if (w == 0u || h == 0u) return;
-    ST7789_DrawLine(lcd, x, y, (int)(x + w - 1u), y, rgb888);
-    ST7789_DrawLine(lcd, x, (int)(y + h - 1u), (int)(x + w - 1u), (int)(y + h - 1u), rgb888);
-    ST7789_DrawLine(lcd, x, y, x, (int)(y + h - 1u), rgb888);
-    ST7789_DrawLine(lcd, (int)(x + w - 1u), y, (int)(x + w - 1u), (int)(y + h - 1u), rgb888);
-}
-
-static const uint8_t st7789_font5x7[95][5] = {
-    {0x00,0x00,0x00,0x00,0x00},{0x00,0x00,0x5F,0x00,0x00},{0x00,0x07,0x00,0x07,0x00},{0x14,0x7F,0x14,0x7F,0x14},
-    {0x24,0x2A,0x7F,0x2A,0x12},{0x23,0x13,0x08,0x64,0x62},{0x36,0x49,0x55,0x22,0x50},{0x00,0x05,0x03,0x00,0x00},
-    {0x00,0x1C,0x22,0x41,0x00},{0x00,0x41,0x22,0x1C,0x00},{0x14,0x08,0x3E,0x08,0x14},{0x08,0x08,0x3E,0x08,0x08},
-    {0x00,0x50,0x30,0x00,0x00},{0x08,0x08,0x08,0x08,0x08},{0x00,0x60,0x60,0x00,0x00},{0x20,0x10,0x08,0x04,0x02},
-    {0x3E,0x51,0x49,0x45,0x3E},{0x00,0x42,0x7F,0x40,0x00},{0x42,0x61,0x51,0x49,0x46},{0x21,0x41,0x45,0x4B,0x31},
-    {0x18,0x14,0x12,0x7F,0x10},{0x27,0x45,0x45,0x45,0x39},{0x3C,0x4A,0x49,0x49,0x30},{0x01,0x71,0x09,0x05,0x03},
-    {0x36,0x49,0x49,0x49,0x36},{0x06,0x49,0x49,0x29,0x1E},{0x00,0x36,0x36,0x00,0x00},{0x00,0x56,0x36,0x00,0x00},
-    {0x08,0x14,0x22,0x41,0x00},{0x14,0x14,0x14,0x14,0x14},{0x00,0x41,0x22,0x14,0x08},{0x02,0x01,0x51,0x09,0x06},
-    {0x32,0x49,0x79,0x41,0x3E},{0x7E,0x11,0x11,0x11,0x7E},{0x7F,0x49,0x49,0x49,0x36},{0x3E,0x41,0x41,0x41,0x22},
-    {0x7F,0x41,0x41,0x22,0x1C},{0x7F,0x49,0x49,0x49,0x41},{0x7F,0x09,0x09,0x09,0x01},{0x3E,0x41,0x49,0x49,0x7A},
-    {0x7F,0x08,0x08,0x08,0x7F},{0x00,0x41,0x7F,0x41,0x00},{0x20,0x40,0x41,0x3F,0x01},{0x7F,0x08,0x14,0x22,0x41},
-    {0x7F,0x40,0x40,0x40,0x40},{0x7F,0x02,0x0C,0x02,0x7F},{0x7F,0x04,0x08,0x10,0x7F},{0x3E,0x41,0x41,0x41,0x3E},
-    {0x7F,0x09,0x09,0x09,0x06},{0x3E,0x41,0x51,0x21,0x5E},{0x7F,0x09,0x19,0x29,0x46},{0x46,0x49,0x49,0x49,0x31},
-    {0x01,0x01,0x7F,0x01,0x01},{0x3F,0x40,0x40,0x40,0x3F},{0x1F,0x20,0x40,0x20,0x1F},{0x3F,0x40,0x38,0x40,0x3F},
-    {0x63,0x14,0x08,0x14,0x63},{0x07,0x08,0x70,0x08,0x07},{0x61,0x51,0x49,0x45,0x43},{0x00,0x7F,0x41,0x41,0x00},
-    {0x02,0x04,0x08,0x10,0x20},{0x00,0x41,0x41,0x7F,0x00},{0x04,0x02,0x01,0x02,0x04},{0x40,0x40,0x40,0x40,0x40},
-    {0x00,0x01,0x02,0x04,0x00},{0x20,0x54,0x54,0x54,0x78},{0x7F,0x48,0x44,0x44,0x38},{0x38,0x44,0x44,0x44,0x20},
-    {0x38,0x44,0x44,0x48,0x7F},{0x38,0x54,0x54,0x54,0x18},{0x08,0x7E,0x09,0x01,0x02},{0x0C,0x52,0x52,0x52,0x3E},
-    {0x7F,0x08,0x04,0x04,0x78},{0x00,0x44,0x7D,0x40,0x00},{0x20,0x40,0x44,0x3D,0x00},{0x7F,0x10,0x28,0x44,0x00},
-    {0x00,0x41,0x7F,0x40,0x00},{0x7C,0x04,0x18,0x04,0x78},{0x7C,0x08,0x04,0x04,0x78},{0x38,0x44,0x44,0x44,0x38},
-    {0x7C,0x14,0x14,0x14,0x08},{0x08,0x14,0x14,0x18,0x7C},{0x7C,0x08,0x04,0x04,0x08},{0x48,0x54,0x54,0x54,0x20},
-    {0x04,0x3F,0x44,0x40,0x20},{0x3C,0x40,0x40,0x20,0x7C},{0x1C,0x20,0x40,0x20,0x1C},{0x3C,0x40,0x30,0x40,0x3C},
-    {0x44,0x28,0x10,0x28,0x44},{0x0C,0x50,0x50,0x50,0x3C},{0x44,0x64,0x54,0x4C,0x44},{0x00,0x08,0x36,0x41,0x00},
-    {0x00,0x00,0x7F,0x00,0x00},{0x00,0x41,0x36,0x08,0x00},{0x10,0x08,0x08,0x10,0x08}
-};
-
-static uint16_t st7789_char_cell_w(uint8_t scale)
-{
-    if (scale == 0u) scale = 1u;
-    if (scale == 3u) return 9u;
-    return (uint16_t)(6u * scale);
-}
-
-static uint16_t st7789_char_cell_h(uint8_t scale)
-{
-    if (scale == 0u) scale = 1u;
-    if (scale == 3u) return 12u;
-    return (uint16_t)(8u * scale);
-}
-
-void ST7789_DrawChar(ST7789_Handle* lcd, uint16_t x, uint16_t y, char c, uint32_t fg_rgb888, uint32_t bg_rgb888, uint8_t scale)
-{
-    if (scale == 0u) scale = 1u;
-    if (c < 32 || c > 126) c = '?';
-    const uint8_t* glyph = st7789_font5x7[(uint8_t)(c - 32)];
-    uint16_t w = st7789_char_cell_w(scale);
-    uint16_t h = st7789_char_cell_h(scale);
-    ST7789_FillRect(lcd, x, y, w, h, bg_rgb888);
-    if (scale == 3u)
-    {
-        for (uint8_t dy = 0; dy < 12u; dy++) {
-            uint8_t sy = (uint8_t)(((uint16_t)dy * 2u) / 3u);
-            if (sy >= 7u) continue;
-            for (uint8_t dx = 0; dx < 9u; dx++) {
-                uint8_t sx = (uint8_t)(((uint16_t)dx * 2u) / 3u);
-                if (sx >= 5u) continue;
-                if (glyph[sx] & (uint8_t)(1u << sy)) ST7789_DrawPixel(lcd, (uint16_t)(x + dx), (uint16_t)(y + dy), fg_rgb888);
-            }
-        }
-        return;
-    }
-    for (uint8_t col = 0; col < 5u; col++) {
-        uint8_t line = glyph[col];
-        for (uint8_t row = 0; row < 7u; row++) {
-            if (line & 0x01u) ST7789_FillRect(lcd, (uint16_t)(x + col * scale), (uint16_t)(y + row * scale), scale, scale, fg_rgb888);
-            line >>= 1u;
-        }
-    }
-}
-
-void ST7789_DrawString(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* s, uint32_t fg_rgb888, uint32_t bg_rgb888, uint8_t scale)
-{
-    if (!s) return;
-    if (scale == 0u) scale = 1u;
-    uint16_t cx = x;
-    uint16_t cy = y;
-    uint16_t step_x = st7789_char_cell_w(scale);
-    uint16_t step_y = st7789_char_cell_h(scale);
-    while (*s)
-    {
-        char c = *s++;
-        if (c == '\n') { cx = x; cy = (uint16_t)(cy + step_y); continue; }
-        if (c == '\r') continue;
-        if (cx + step_x > ST7789_WIDTH) { cx = x; cy = (uint16_t)(cy + step_y); }
-        if (cy + step_y > ST7789_HEIGHT) break;
-        ST7789_DrawChar(lcd, cx, cy, c, fg_rgb888, bg_rgb888, scale);
-        cx = (uint16_t)(cx + step_x);
-    }
-}
-
-void ST7789_SPI_DMA_IRQHandler(void)
-{
-    SPIST7789_DMA_IRQHandler();
-}
-
-void ST7789_SPI_IRQHandler(void)
-{
-    SPIST7789_SPI_IRQHandler();
-}
-
-void ST7789_DrawCircle(ST7789_Handle* lcd, int x0, int y0, int r, uint32_t rgb888)
-{
-    if (r < 0) return;
-    int x = -r;
-    int y = 0;
-    int err = 2 - 2 * r;
-    do {
-        ST7789_DrawPixel(lcd, (uint16_t)(x0 - x), (uint16_t)(y0 + y), rgb888);
-        ST7789_DrawPixel(lcd, (uint16_t)(x0 - y), (uint16_t)(y0 - x), rgb888);
-        ST7789_DrawPixel(lcd, (uint16_t)(x0 + x), (uint16_t)(y0 - y), rgb888);
-        ST7789_DrawPixel(lcd, (uint16_t)(x0 + y), (uint16_t)(y0 + x), rgb888);
-        int e2 = err;
-        if (e2 <= y) {
-            y++;
-            err += y * 2 + 1;
-            if (-x == y && e2 <= x) e2 = 0;
-        }
-        if (e2 > x) {
-            x++;
-            err += x * 2 + 1;
-        }
-    } while (x <= 0);
-}
-
-void ST7789_FillCircle(ST7789_Handle* lcd, int x0, int y0, int r, uint32_t rgb888)
-{
-    if (r < 0) return;
-    int x = -r;
-    int y = 0;
-    int err = 2 - 2 * r;
-    do {
-        ST7789_DrawLine(lcd, x0 + x, y0 - y, x0 - x, y0 - y, rgb888);
-        ST7789_DrawLine(lcd, x0 + x, y0 + y, x0 - x, y0 + y, rgb888);
-        int e2 = err;
-        if (e2 <= y) {
-            y++;
-            err += y * 2 + 1;
-            if (-x == y && e2 <= x) e2 = 0;
-        }
-        if (e2 > x) {
-            x++;
-            err += x * 2 + 1;
-        }
-    } while (x <= 0);
-}
-
-void ST7789_DrawBitmap(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const void* pixels, ST7789_BitmapFormat format, uint32_t stride_bytes)
-{
-    if (!lcd || !lcd->inited || !pixels) return;
-    if (w == 0u || h == 0u) return;
-    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
-    if (stride_bytes == 0u) {
-        if (format == ST7789_BITMAP_RGB565_BE || format == ST7789_BITMAP_RGB565_LE) stride_bytes = (uint32_t)w * 2u;
-        else if (format == ST7789_BITMAP_RGB888) stride_bytes = (uint32_t)w * 3u;
-        else stride_bytes = (uint32_t)w * 4u;
-    }
-    uint16_t draw_w = w;
-    uint16_t draw_h = h;
-    if ((uint32_t)x + draw_w > ST7789_WIDTH) draw_w = (uint16_t)(ST7789_WIDTH - x);
-    if ((uint32_t)y + draw_h > ST7789_HEIGHT) draw_h = (uint16_t)(ST7789_HEIGHT - y);
-
-    const uint8_t* src = (const uint8_t*)pixels;
-    for (uint16_t row = 0; row < draw_h; row++) {
-        const uint8_t* row_ptr = src + (size_t)row * (size_t)stride_bytes;
-        for (uint16_t col = 0; col < draw_w; col++) {
-            uint32_t rgb = 0;
-            if (format == ST7789_BITMAP_RGB565_BE) {
-                const uint8_t* p = row_ptr + (size_t)col * 2u;
-                uint16_t c = (uint16_t)((uint16_t)p[0] << 8 | (uint16_t)p[1]);
-                uint8_t r5 = (uint8_t)((c >> 11) & 0x1Fu);
-                uint8_t g6 = (uint8_t)((c >> 5) & 0x3Fu);
-                uint8_t b5 = (uint8_t)(c & 0x1Fu);
-                rgb = ST7789_RGB((uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)));
-            } else if (format == ST7789_BITMAP_RGB565_LE) {
-                const uint8_t* p = row_ptr + (size_t)col * 2u;
-                uint16_t c = (uint16_t)((uint16_t)p[1] << 8 | (uint16_t)p[0]);
-                uint8_t r5 = (uint8_t)((c >> 11) & 0x1Fu);
-                uint8_t g6 = (uint8_t)((c >> 5) & 0x3Fu);
-                uint8_t b5 = (uint8_t)(c & 0x1Fu);
-                rgb = ST7789_RGB((uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)));
-            } else if (format == ST7789_BITMAP_RGB888) {
-                const uint8_t* p = row_ptr + (size_t)col * 3u;
-                rgb = ST7789_RGB(p[0], p[1], p[2]);
-            } else {
-                const uint8_t* p = row_ptr + (size_t)col * 4u;
-                if (p[0] == 0u) continue;
-                rgb = ST7789_RGB(p[1], p[2], p[3]);
-            }
-            ST7789_DrawPixel(lcd, (uint16_t)(x + col), (uint16_t)(y + row), rgb);
-        }
-    }
-}
-
-void ST7789_DrawBitmap1BPP(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* bits, uint32_t stride_bytes, uint32_t fg_rgb888, uint32_t bg_rgb888)
-{
-    if (!lcd || !lcd->inited || !bits) return;
-    if (w == 0u || h == 0u) return;
-    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
-    if (stride_bytes == 0u) stride_bytes = (uint32_t)((w + 7u) >> 3);
-    uint16_t draw_w = w;
-    uint16_t draw_h = h;
-    if ((uint32_t)x + draw_w > ST7789_WIDTH) draw_w = (uint16_t)(ST7789_WIDTH - x);
-    if ((uint32_t)y + draw_h > ST7789_HEIGHT) draw_h = (uint16_t)(ST7789_HEIGHT - y);
-
-    for (uint16_t row = 0; row < draw_h; row++) {
-        const uint8_t* row_ptr = bits + (size_t)row * (size_t)stride_bytes;
-        for (uint16_t col = 0; col < draw_w; col++) {
-            uint8_t byte = row_ptr[col >> 3];
-            uint8_t bit = (uint8_t)((byte >> (7u - (col & 7u))) & 0x01u);
-            ST7789_DrawPixel(lcd, (uint16_t)(x + col), (uint16_t)(y + row), bit ? fg_rgb888 : bg_rgb888);
-        }
-    }
-}
-
-typedef struct
-{
-    const uint8_t* data;
-    size_t len;
-    size_t pos;
-} st7789_gif_stream_t;
-
-typedef struct
-{
-    bool transparent;
-    uint8_t transparent_index;
-    uint16_t delay_cs;
-    uint8_t disposal;
-} st7789_gif_gce_t;
-
-typedef struct
-{
-    st7789_gif_stream_t* s;
-    uint8_t subblock_remaining;
-    bool terminator_seen;
-    uint32_t datum;
-    uint8_t bits;
-} st7789_gif_lzw_reader_t;
-
-static uint16_t st7789_gif_prefix[4096];
-static uint8_t st7789_gif_suffix[4096];
-static uint8_t st7789_gif_stack[4096];
-static uint8_t st7789_gif_gct[256 * 3];
-static uint8_t st7789_gif_lct[256 * 3];
-static uint8_t st7789_gif_line_idx[ST7789_WIDTH];
-
-static bool st7789_gif_read_u8(st7789_gif_stream_t* s, uint8_t* out)
-{
-    if (!s || !out || s->pos >= s->len) return false;
-    *out = s->data[s->pos++];
-    return true;
-}
-
-static bool st7789_gif_read_u16le(st7789_gif_stream_t* s, uint16_t* out)
-{
-    uint8_t lo = 0, hi = 0;
-    if (!st7789_gif_read_u8(s, &lo)) return false;
-    if (!st7789_gif_read_u8(s, &hi)) return false;
-    *out = (uint16_t)((uint16_t)lo | ((uint16_t)hi << 8));
-    return true;
-}
-
-static bool st7789_gif_skip(st7789_gif_stream_t* s, size_t n)
-{
-    if (!s) return false;
-    if (s->pos + n > s->len) return false;
-    s->pos += n;
-    return true;
-}
-
-static bool st7789_gif_skip_subblocks(st7789_gif_stream_t* s)
-{
-    uint8_t sz = 0;
-    while (1) {
-        if (!st7789_gif_read_u8(s, &sz)) return false;
-        if (sz == 0u) return true;
-        if (!st7789_gif_skip(s, sz)) return false;
-    }
-}
-
-static bool st7789_gif_read_color_table(st7789_gif_stream_t* s, uint8_t* pal, uint16_t count)
-{
-    if (!s || !pal || count > 256u) return false;
-    for (uint16_t i = 0; i < count; i++) {
-        if (!st7789_gif_read_u8(s, &pal[i * 3u + 0u])) return false;
-        if (!st7789_gif_read_u8(s, &pal[i * 3u + 1u])) return false;
-        if (!st7789_gif_read_u8(s, &pal[i * 3u + 2u])) return false;
-    }
-    return true;
-}
-
-static bool st7789_gif_read_gce(st7789_gif_stream_t* s, st7789_gif_gce_t* gce)
-{
-    uint8_t block_size = 0;
-    if (!st7789_gif_read_u8(s, &block_size)) return false;
-    if (block_size != 4u) return false;
-    uint8_t packed = 0, trans = 0, terminator = 0;
-    uint16_t delay_cs = 0;
-    if (!st7789_gif_read_u8(s, &packed)) return false;
-    if (!st7789_gif_read_u16le(s, &delay_cs)) return false;
-    if (!st7789_gif_read_u8(s, &trans)) return false;
-    if (!st7789_gif_read_u8(s, &terminator)) return false;
-    if (terminator != 0u) return false;
-    if (gce) {
-        gce->transparent = (packed & 0x01u) ? true : false;
-        gce->transparent_index = trans;
-        gce->delay_cs = delay_cs;
-        gce->disposal = (uint8_t)((packed >> 2) & 0x07u);
-    }
-    return true;
-}
-
-static bool st7789_gif_lzw_next_data_byte(st7789_gif_lzw_reader_t* r, uint8_t* out)
-{
-    if (!r || !out) return false;
-    if (r->terminator_seen) return false;
-    if (r->subblock_remaining == 0u) {
-        uint8_t sz = 0;
-        if (!st7789_gif_read_u8(r->s, &sz)) return false;
-        if (sz == 0u) {
-            r->terminator_seen = true;
-            return false;
-        }
-        r->subblock_remaining = sz;
-    }
-    if (!st7789_gif_read_u8(r->s, out)) return false;
-    r->subblock_remaining--;
-    return true;
-}
-
-static bool st7789_gif_lzw_drain_to_terminator(st7789_gif_lzw_reader_t* r)
-{
-    if (!r) return false;
-    if (r->terminator_seen) return true;
-    if (r->subblock_remaining) {
-        if (!st7789_gif_skip(r->s, r->subblock_remaining)) return false;
-        r->subblock_remaining = 0;
-    }
-    if (!st7789_gif_skip_subblocks(r->s)) return false;
-    r->terminator_seen = true;
-    return true;
-}
-
-static int st7789_gif_lzw_read_code(st7789_gif_lzw_reader_t* r, int code_size)
-{
-    while (r->bits < (uint8_t)code_size) {
-        uint8_t byte = 0;
-        if (!st7789_gif_lzw_next_data_byte(r, &byte)) return -1;
-        r->datum |= ((uint32_t)byte << r->bits);
-        r->bits = (uint8_t)(r->bits + 8u);
-    }
-    int mask = (1 << code_size) - 1;
-    int code = (int)(r->datum & (uint32_t)mask);
-    r->datum >>= code_size;
-    r->bits = (uint8_t)(r->bits - (uint8_t)code_size);
-    return code;
-}
-
-static void st7789_gif_palette_color(const uint8_t* pal, uint16_t count, uint8_t index, uint8_t* r, uint8_t* g, uint8_t* b)
-{
-    if (!pal || !r || !g || !b || count == 0u || index >= count) {
-        *r = 0u; *g = 0u; *b = 0u;
-        return;
-    }
-    *r = pal[index * 3u + 0u];
-    *g = pal[index * 3u + 1u];
-    *b = pal[index * 3u + 2u];
-}
-
-static void st7789_gif_write_scanline(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* idx, uint16_t w, const uint8_t* pal, uint16_t pal_count, const st7789_gif_gce_t* gce, uint32_t bg_rgb888)
-{
-    if (!lcd || !idx || w == 0u) return;
-    for (uint16_t i = 0; i < w; i++) {
-        uint8_t px = idx[i];
-        if (gce && gce->transparent && px == gce->transparent_index) {
-            ST7789_DrawPixel(lcd, (uint16_t)(x + i), y, bg_rgb888);
-        } else {
-            uint8_t r = 0, g = 0, b = 0;
-            st7789_gif_palette_color(pal, pal_count, px, &r, &g, &b);
-            ST7789_DrawPixel(lcd, (uint16_t)(x + i), y, ST7789_RGB(r, g, b));
-        }
-    }
-}
-
-static bool st7789_gif_decode_image(ST7789_Handle* lcd, uint16_t base_x, uint16_t base_y, st7789_gif_stream_t* s, uint16_t left, uint16_t top, uint16_t w, uint16_t h, bool interlaced, const uint8_t* pal, uint16_t pal_count, const st7789_gif_gce_t* gce, uint32_t bg_rgb888, uint16_t* out_delay_ms, uint8_t* out_disposal)
-{
-    uint8_t lzw_min = 0;
-    if (!st7789_gif_read_u8(s, &lzw_min)) return false;
-    if (lzw_min < 2u || lzw_min > 8u) return false;
-    if (w > ST7789_WIDTH) return false;
-
-    st7789_gif_lzw_reader_t r = {0};
-    r.s = s;
-    int clear_code = 1 << lzw_min;
-    int end_code = clear_code + 1;
-    int code_size = lzw_min + 1;
-    int next_code = end_code + 1;
-    int old_code = -1;
-    uint8_t first = 0;
-
-    for (int i = 0; i < clear_code; i++) {
-        st7789_gif_prefix[i] = 0xFFFFu;
-        st7789_gif_suffix[i] = (uint8_t)i;
-    }
-
-    uint16_t row_actual = 0;
-    uint8_t pass = 0;
-    uint16_t interlace_row = 0;
-    uint16_t col = 0;
-    uint16_t rows_written = 0;
-
-    while (rows_written < h) {
-        int code = st7789_gif_lzw_read_code(&r, code_size);
-        if (code < 0) break;
-        if (code == clear_code) {
-            code_size = lzw_min + 1;
-            next_code = end_code + 1;
-            old_code = -1;
-            continue;
-        }
-        if (code == end_code) break;
-
-        if (old_code == -1) {
-            uint8_t px = (uint8_t)code;
-            st7789_gif_line_idx[col++] = px;
-            old_code = code;
-            first = (uint8_t)code;
-        } else {
-            int in_code = code;
-            int stack_top = 0;
-            if (code >= next_code) {
-                st7789_gif_stack[stack_top++] = first;
-                code = old_code;
-            }
-            while (code >= clear_code) {
-                st7789_gif_stack[stack_top++] = st7789_gif_suffix[code];
-                code = st7789_gif_prefix[code];
-            }
-            first = (uint8_t)code;
-            st7789_gif_stack[stack_top++] = first;
-            if (next_code < 4096) {
-                st7789_gif_prefix[next_code] = (uint16_t)old_code;
-                st7789_gif_suffix[next_code] = first;
-                next_code++;
-                if (next_code == (1 << code_size) && code_size < 12) code_size++;
-            }
-            old_code = in_code;
-            while (stack_top) {
-                st7789_gif_line_idx[col++] = st7789_gif_stack[--stack_top];
-                if (col == w) break;
-            }
-        }
-
-        if (col == w) {
-            uint16_t sx = (uint16_t)(base_x + left);
-            uint16_t sy = (uint16_t)(base_y + top + row_actual);
-            if (sx < ST7789_WIDTH && sy < ST7789_HEIGHT) {
-                uint16_t vis_w = w;
-                if ((uint32_t)sx + vis_w > ST7789_WIDTH) vis_w = (uint16_t)(ST7789_WIDTH - sx);
-                st7789_gif_write_scanline(lcd, sx, sy, st7789_gif_line_idx, vis_w, pal, pal_count, gce, bg_rgb888);
-            }
-            col = 0;
-            rows_written++;
-            if (interlaced) {
-                static const uint8_t start[4] = {0, 4, 2, 1};
-                static const uint8_t step[4] = {8, 8, 4, 2};
-                interlace_row = (uint16_t)(interlace_row + step[pass]);
-                while (pass < 3u && interlace_row >= h) {
-                    pass++;
-                    interlace_row = start[pass];
-                }
-                row_actual = interlace_row;
-            } else {
-                row_actual++;
-            }
-        }
-    }
-
-    if (!st7789_gif_lzw_drain_to_terminator(&r)) return false;
-    if (rows_written != h) return false;
-    if (out_delay_ms) {
-        uint16_t d = gce ? gce->delay_cs : 0u;
-        uint16_t ms = (uint16_t)(d * 10u);
-        if (ms == 0u) ms = 10u;
-        *out_delay_ms = ms;
-    }
-    if (out_disposal) *out_disposal = gce ? gce->disposal : 0u;
-    return true;
-}
-
-static bool st7789_gif_has_signature(const uint8_t* gif, size_t gif_len)
-{
-    if (!gif || gif_len < 6u) return false;
-    if (gif[0] != 'G' || gif[1] != 'I' || gif[2] != 'F') return false;
-    if (gif[3] != '8') return false;
-    if (gif[4] != '7' && gif[4] != '9') return false;
-    if (gif[5] != 'a') return false;
-    return true;
-}
-
-bool ST7789_GIF_GetCanvasSize(const uint8_t* gif, size_t gif_len, uint16_t* out_w, uint16_t* out_h)
-{
-    if (!st7789_gif_has_signature(gif, gif_len)) return false;
-    st7789_gif_stream_t s = {0};
-    s.data = gif;
-    s.len = gif_len;
-    s.pos = 6;
-    uint16_t w = 0, h = 0;
-    uint8_t packed = 0, bg = 0, aspect = 0;
-    if (!st7789_gif_read_u16le(&s, &w)) return false;
-    if (!st7789_gif_read_u16le(&s, &h)) return false;
-    if (!st7789_gif_read_u8(&s, &packed)) return false;
-    if (!st7789_gif_read_u8(&s, &bg)) return false;
-    if (!st7789_gif_read_u8(&s, &aspect)) return false;
-    if (out_w) *out_w = w;
-    if (out_h) *out_h = h;
-    return true;
-}
-
-bool ST7789_GIF_RenderFirstFrame(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888)
-{
-    if (!lcd || !lcd->inited) return false;
-    if (!st7789_gif_has_signature(gif, gif_len)) return false;
-    st7789_gif_stream_t s = {0};
-    s.data = gif;
-    s.len = gif_len;
-    s.pos = 6;
-
-    uint16_t canvas_w = 0, canvas_h = 0;
-    uint8_t packed = 0, bg_index = 0, aspect = 0;
-    if (!st7789_gif_read_u16le(&s, &canvas_w)) return false;
-    if (!st7789_gif_read_u16le(&s, &canvas_h)) return false;
-    if (!st7789_gif_read_u8(&s, &packed)) return false;
-    if (!st7789_gif_read_u8(&s, &bg_index)) return false;
-    if (!st7789_gif_read_u8(&s, &aspect)) return false;
-
-    bool gct_flag = (packed & 0x80u) ? true : false;
-    uint16_t gct_count = 0;
-    if (gct_flag) {
-        uint8_t sz = (uint8_t)(packed & 0x07u);
-        gct_count = (uint16_t)(1u << (sz + 1u));
-        if (!st7789_gif_read_color_table(&s, st7789_gif_gct, gct_count)) return false;
-    }
-
-    st7789_gif_gce_t gce = {0};
-    while (s.pos < s.len) {
-        uint8_t sep = 0;
-        if (!st7789_gif_read_u8(&s, &sep)) return false;
-        if (sep == 0x3Bu) return false;
-        if (sep == 0x21u) {
-            uint8_t label = 0;
-            if (!st7789_gif_read_u8(&s, &label)) return false;
-            if (label == 0xF9u) {
-                if (!st7789_gif_read_gce(&s, &gce)) return false;
-            } else {
-                if (!st7789_gif_skip_subblocks(&s)) return false;
-            }
-            continue;
-        }
-        if (sep == 0x2Cu) {
-            uint16_t left = 0, top = 0, w = 0, h = 0;
-            uint8_t ipacked = 0;
-            if (!st7789_gif_read_u16le(&s, &left)) return false;
-            if (!st7789_gif_read_u16le(&s, &top)) return false;
-            if (!st7789_gif_read_u16le(&s, &w)) return false;
-            if (!st7789_gif_read_u16le(&s, &h)) return false;
-            if (!st7789_gif_read_u8(&s, &ipacked)) return false;
-            bool lct_flag = (ipacked & 0x80u) ? true : false;
-            bool interlaced = (ipacked & 0x40u) ? true : false;
-            uint16_t lct_count = 0;
-            const uint8_t* pal = st7789_gif_gct;
-            uint16_t pal_count = gct_count;
-            if (lct_flag) {
-                uint8_t sz = (uint8_t)(ipacked & 0x07u);
-                lct_count = (uint16_t)(1u << (sz + 1u));
-                if (!st7789_gif_read_color_table(&s, st7789_gif_lct, lct_count)) return false;
-                pal = st7789_gif_lct;
-                pal_count = lct_count;
-            }
-            uint16_t delay_ms = 0;
-            uint8_t disposal = 0;
-            bool ok = st7789_gif_decode_image(lcd, x, y, &s, left, top, w, h, interlaced, pal, pal_count, &gce, bg_rgb888, &delay_ms, &disposal);
-            (void)canvas_w; (void)canvas_h; (void)bg_index; (void)aspect; (void)delay_ms; (void)disposal;
-            return ok;
-        }
-        return false;
-    }
-    return false;
-}
-
-bool ST7789_GIF_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888, uint16_t repeat)
-{
-    if (!lcd || !lcd->inited) return false;
-    if (!st7789_gif_has_signature(gif, gif_len)) return false;
-    if (repeat == 0u) repeat = 1u;
-
-    for (uint16_t rep = 0; rep < repeat; rep++) {
-        st7789_gif_stream_t s = {0};
-        s.data = gif;
-        s.len = gif_len;
-        s.pos = 6;
-        uint16_t canvas_w = 0, canvas_h = 0;
-        uint8_t packed = 0, bg_index = 0, aspect = 0;
-        if (!st7789_gif_read_u16le(&s, &canvas_w)) return false;
-        if (!st7789_gif_read_u16le(&s, &canvas_h)) return false;
-        if (!st7789_gif_read_u8(&s, &packed)) return false;
-        if (!st7789_gif_read_u8(&s, &bg_index)) return false;
-        if (!st7789_gif_read_u8(&s, &aspect)) return false;
-        bool gct_flag = (packed & 0x80u) ? true : false;
-        uint16_t gct_count = 0;
-        if (gct_flag) {
-            uint8_t sz = (uint8_t)(packed & 0x07u);
-            gct_count = (uint16_t)(1u << (sz + 1u));
-            if (!st7789_gif_read_color_table(&s, st7789_gif_gct, gct_count)) return false;
-        }
-        st7789_gif_gce_t gce = {0};
-        while (s.pos < s.len) {
-            uint8_t sep = 0;
-            if (!st7789_gif_read_u8(&s, &sep)) return false;
-            if (sep == 0x3Bu) break;
-            if (sep == 0x21u) {
-                uint8_t label = 0;
-                if (!st7789_gif_read_u8(&s, &label)) return false;
-                if (label == 0xF9u) {
-                    if (!st7789_gif_read_gce(&s, &gce)) return false;
-                } else {
-                    if (!st7789_gif_skip_subblocks(&s)) return false;
-                }
-                continue;
-            }
-            if (sep == 0x2Cu) {
-                uint16_t left = 0, top = 0, w = 0, h = 0;
-                uint8_t ipacked = 0;
-                if (!st7789_gif_read_u16le(&s, &left)) return false;
-                if (!st7789_gif_read_u16le(&s, &top)) return false;
-                if (!st7789_gif_read_u16le(&s, &w)) return false;
-                if (!st7789_gif_read_u16le(&s, &h)) return false;
-                if (!st7789_gif_read_u8(&s, &ipacked)) return false;
-                bool lct_flag = (ipacked & 0x80u) ? true : false;
-                bool interlaced = (ipacked & 0x40u) ? true : false;
-                uint16_t lct_count = 0;
-                const uint8_t* pal = st7789_gif_gct;
-                uint16_t pal_count = gct_count;
-                if (lct_flag) {
-                    uint8_t sz = (uint8_t)(ipacked & 0x07u);
-                    lct_count = (uint16_t)(1u << (sz + 1u));
-                    if (!st7789_gif_read_color_table(&s, st7789_gif_lct, lct_count)) return false;
-                    pal = st7789_gif_lct;
-                    pal_count = lct_count;
-                }
-                uint16_t delay_ms = 0;
-                uint8_t disposal = 0;
-                if (!st7789_gif_decode_image(lcd, x, y, &s, left, top, w, h, interlaced, pal, pal_count, &gce, bg_rgb888, &delay_ms, &disposal)) return false;
-                ST7789_FrameEnd(lcd);
-                HAL_Delay(delay_ms);
-                if (disposal == 2u) {
-                    uint16_t fx = (uint16_t)(x + left);
-                    uint16_t fy = (uint16_t)(y + top);
-                    if (fx < ST7789_WIDTH && fy < ST7789_HEIGHT) {
-                        uint16_t fw = w, fh = h;
-                        if ((uint32_t)fx + fw > ST7789_WIDTH) fw = (uint16_t)(ST7789_WIDTH - fx);
-                        if ((uint32_t)fy + fh > ST7789_HEIGHT) fh = (uint16_t)(ST7789_HEIGHT - fy);
-                        ST7789_FillRect(lcd, fx, fy, fw, fh, bg_rgb888);
-                    }
-                }
-                gce.transparent = false;
-                gce.transparent_index = 0;
-                gce.delay_cs = 0;
-                gce.disposal = 0;
-                (void)canvas_w; (void)canvas_h; (void)bg_index; (void)aspect;
-                continue;
-            }
-            return false;
-        }
-    }
-    return true;
-}
-
-static const uint8_t* st7789_assets_base = (const uint8_t*)0x905B0000u;
-
-const void* ST7789_Assets_GetBaseAddress(void)
-{
-    return st7789_assets_base;
-}
-
-void ST7789_Assets_SetBaseAddress(const void* base)
-{
-    if (base) st7789_assets_base = (const uint8_t*)base;
-}
-
-static uint16_t st7789_u16le(const uint8_t* p)
-{
-    return (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
-}
-
-static uint32_t st7789_u32le(const uint8_t* p)
-{
-    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
-}
-
-static bool st7789_assets_header_ok(const uint8_t* base, uint32_t* out_count, uint32_t* out_index_size)
-{
-    if (!base) return false;
-    if (base[0] != 'H' || base[1] != 'I' || base[2] != 'M' || base[3] != 'G') return false;
-    uint16_t ver = st7789_u16le(base + 4);
-    if (ver != 1u) return false;
-    uint32_t count = st7789_u32le(base + 16);
-    uint32_t index_size = st7789_u32le(base + 20);
-    if (count > 4096u) return false;
-    if ((index_size & 0x0Fu) != 0u) return false;
-    if (out_count) *out_count = count;
-    if (out_index_size) *out_index_size = index_size;
-    return true;
-}
-
-bool ST7789_Assets_Find(const char* name, ST7789_AssetInfo* out)
-{
-    if (!name || !out) return false;
-    const uint8_t* base = st7789_assets_base;
-    uint32_t count = 0, index_size = 0;
-    if (!st7789_assets_header_ok(base, &count, &index_size)) return false;
-    const uint8_t* index = base + 64;
-    for (uint32_t i = 0; i < count; i++) {
-        const uint8_t* e = index + i * 64u;
-        char nbuf[33];
-        memcpy(nbuf, e, 32);
-        nbuf[32] = '\0';
-        for (int j = 0; j < 32; j++) {
-            if (nbuf[j] == '\0') break;
-            if ((unsigned char)nbuf[j] < 0x20u) { nbuf[j] = '\0'; break; }
-        }
-        if (strncmp(nbuf, name, 32) != 0) continue;
-        out->type = (ST7789_AssetType)e[32];
-        out->data = base + st7789_u32le(e + 36);
-        out->size = st7789_u32le(e + 40);
-        out->width = st7789_u16le(e + 44);
-        out->height = st7789_u16le(e + 46);
-        return true;
-    }
-    (void)index_size;
-    return false;
-}
-
-bool ST7789_Assets_Draw(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888)
-{
-    if (!lcd || !lcd->inited) return false;
-    ST7789_AssetInfo info = {0};
-    if (!ST7789_Assets_Find(name, &info)) return false;
-    if (info.type == ST7789_ASSET_TYPE_GIF) return ST7789_GIF_RenderFirstFrame(lcd, x, y, (const uint8_t*)info.data, (size_t)info.size, bg_rgb888);
-    if (info.type == ST7789_ASSET_TYPE_RGB565LE) {
-        ST7789_DrawBitmap(lcd, x, y, info.width, info.height, info.data, ST7789_BITMAP_RGB565_LE, (uint32_t)info.width * 2u);
-        return true;
-    }
-    return false;
-}
-
-bool ST7789_Assets_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888, uint16_t repeat)
-{
-    if (!lcd || !lcd->inited) return false;
-    ST7789_AssetInfo info = {0};
-    if (!ST7789_Assets_Find(name, &info)) return false;
-    if (info.type == ST7789_ASSET_TYPE_GIF) return ST7789_GIF_Play(lcd, x, y, (const uint8_t*)info.data, (size_t)info.size, bg_rgb888, repeat);
-    return ST7789_Assets_Draw(lcd, x, y, name, bg_rgb888);
-}
@@ -8,11 +8,21 @@
 extern "C" {
 #endif
 
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} SPIST7789_Rect;
+
 void SPIST7789_Init(void);
 void SPIST7789_SetBacklight100(void);
 void SPIST7789_SetBacklight(uint8_t percent);
 bool SPIST7789_FillBlueAsync(void);
 bool SPIST7789_FillRectColor565Async(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color565);
+bool SPIST7789_FlushRectAsync(const uint16_t* fb, uint16_t fb_stride, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+bool SPIST7789_FlushRectsAsync(const uint16_t* fb, uint16_t fb_stride, const SPIST7789_Rect* rects, uint8_t count);
 bool SPIST7789_WaitDone(uint32_t timeout_ms);
 bool SPIST7789_IsBusy(void);
 void SPIST7789_DMA_IRQHandler(void);
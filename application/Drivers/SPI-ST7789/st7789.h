@@ -10,6 +10,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 #include "board_cfg.h"
+#include "st7789_dirty.h"
 
 typedef enum
 {
@@ -50,11 +51,7 @@ typedef struct
     bool framebuffer_enabled;
     uint16_t* fb_front;
     uint16_t* fb_back;
-    bool dirty_valid;
-    uint16_t dirty_x0;
-    uint16_t dirty_y0;
-    uint16_t dirty_x1;
-    uint16_t dirty_y1;
+    ST7789_DirtyRegion dirty;
 } ST7789_Handle;
 
 typedef enum
@@ -70,8 +67,12 @@ uint32_t ST7789_RGB(uint8_t r, uint8_t g, uint8_t b);
 void ST7789_Init(ST7789_Handle* lcd, const ST7789_Config* cfg);
 bool ST7789_IsInited(const ST7789_Handle* lcd);
 bool ST7789_IsFrameBlocked(const ST7789_Handle* lcd);
+/* 运行时调整 FrameBegin 的帧率上限，0 表示不限速 */
+void ST7789_SetFrameRate(ST7789_Handle* lcd, uint8_t fps);
 bool ST7789_FrameBegin(ST7789_Handle* lcd);
 void ST7789_FrameEnd(ST7789_Handle* lcd);
+void ST7789_Invalidate(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void ST7789_InvalidateAll(ST7789_Handle* lcd);
 void ST7789_SPI_DMA_IRQHandler(void);
 void ST7789_SPI_IRQHandler(void);
 
@@ -102,17 +103,46 @@ bool ST7789_GIF_GetCanvasSize(const uint8_t* gif, size_t gif_len, uint16_t* out_
 bool ST7789_GIF_RenderFirstFrame(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888);
 bool ST7789_GIF_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888, uint16_t repeat);
 
+/* 非阻塞 GIF 播放器：Start 只解析文件头，之后每次主循环调用 ST7789_GIF_Service，
+ * 每次最多解码 ST7789_GIF_DECODE_ROWS_PER_SLICE 行，按帧延时的截止时间显示。需要启用帧缓冲。 */
+#define ST7789_GIF_REPEAT_FOREVER 0xFFFFu
+
+typedef enum
+{
+    ST7789_GIF_IDLE = 0,
+    ST7789_GIF_PLAYING = 1,
+    ST7789_GIF_DONE = 2,
+    ST7789_GIF_ERROR = 3
+} ST7789_GifState;
+
+bool ST7789_GIF_Start(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888, uint16_t repeat);
+void ST7789_GIF_Stop(void);
+ST7789_GifState ST7789_GIF_Service(void);
+ST7789_GifState ST7789_GIF_GetState(void);
+
 typedef enum
 {
     ST7789_ASSET_TYPE_GIF = 1,
-    ST7789_ASSET_TYPE_RGB565LE = 2
+    ST7789_ASSET_TYPE_RGB565LE = 2,
+    ST7789_ASSET_TYPE_RGB565LE_PACKED = 3,
+    ST7789_ASSET_TYPE_FONT = 4
 } ST7789_AssetType;
 
+/* ST7789_ASSET_TYPE_RGB565LE_PACKED 的压缩方式，由 tools/pack_assets.py 按体积选择 */
+typedef enum
+{
+    ST7789_ASSET_CODEC_NONE = 0,
+    ST7789_ASSET_CODEC_RLE = 1,     /* 适合大块纯色的界面图 */
+    ST7789_ASSET_CODEC_LZ = 2       /* 适合照片类图片 */
+} ST7789_AssetCodec;
+
 typedef struct
 {
     ST7789_AssetType type;
+    ST7789_AssetCodec codec;
     const void* data;
-    uint32_t size;
+    uint32_t size;          /* data 的字节数（压缩后） */
+    uint32_t raw_size;      /* 解压后的字节数 */
     uint16_t width;
     uint16_t height;
 } ST7789_AssetInfo;
@@ -121,8 +151,29 @@ const void* ST7789_Assets_GetBaseAddress(void);
 void ST7789_Assets_SetBaseAddress(const void* base);
 bool ST7789_Assets_Find(const char* name, ST7789_AssetInfo* out);
 bool ST7789_Assets_Draw(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888);
+bool ST7789_Assets_DrawInfo(ST7789_Handle* lcd, uint16_t x, uint16_t y, const ST7789_AssetInfo* info, uint32_t bg_rgb888);
 bool ST7789_Assets_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888, uint16_t repeat);
 
+/* 比例宽度抗锯齿字体，数据直接引用资源包（ST7789_ASSET_TYPE_FONT），文本为 UTF-8 */
+typedef struct
+{
+    const uint8_t* glyphs;      /* 字形表，按码点升序 */
+    const uint8_t* bitmaps;     /* 4 bpp 位图区 */
+    uint32_t glyph_count;
+    uint32_t bitmap_size;
+    uint16_t line_height;
+    uint16_t baseline;          /* 基线到行顶的距离 */
+} ST7789_Font;
+
+bool ST7789_Font_Load(const ST7789_AssetInfo* info, ST7789_Font* out);
+bool ST7789_Font_Find(const char* name, ST7789_Font* out);
+uint16_t ST7789_Font_TextWidth(const ST7789_Font* font, const char* utf8);
+/** @brief 返回首行中宽度不超过 max_w 的前缀字节数，out_w 为该前缀的像素宽度 */
+size_t ST7789_Font_Fit(const ST7789_Font* font, const char* utf8, uint16_t max_w, uint16_t* out_w);
+void ST7789_Font_ResetCache(void);
+/** @brief 绘制文本，y 为行顶，字符格内的空白填充背景色，'\n' 换行，超出屏幕右侧的部分裁掉；返回最宽一行的像素宽度 */
+uint16_t ST7789_DrawText(ST7789_Handle* lcd, const ST7789_Font* font, uint16_t x, uint16_t y, const char* utf8, uint32_t fg_rgb888, uint32_t bg_rgb888);
+
 #ifdef __cplusplus
 }
 #endif
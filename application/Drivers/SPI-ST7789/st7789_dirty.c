@@ -0,0 +1,119 @@
+#include "st7789_dirty.h"
+
+static inline uint32_t rect_area(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    return (uint32_t)(x1 - x0 + 1u) * (uint32_t)(y1 - y0 + 1u);
+}
+
+static inline uint32_t union_area(const ST7789_DirtyRect* a, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    uint16_t ux0 = (a->x0 < x0) ? a->x0 : x0;
+    uint16_t uy0 = (a->y0 < y0) ? a->y0 : y0;
+    uint16_t ux1 = (a->x1 > x1) ? a->x1 : x1;
+    uint16_t uy1 = (a->y1 > y1) ? a->y1 : y1;
+    return rect_area(ux0, uy0, ux1, uy1);
+}
+
+static inline void rect_grow(ST7789_DirtyRect* a, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    if (x0 < a->x0) a->x0 = x0;
+    if (y0 < a->y0) a->y0 = y0;
+    if (x1 > a->x1) a->x1 = x1;
+    if (y1 > a->y1) a->y1 = y1;
+}
+
+static inline bool rect_contains(const ST7789_DirtyRect* a, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    return x0 >= a->x0 && y0 >= a->y0 && x1 <= a->x1 && y1 <= a->y1;
+}
+
+void ST7789_Dirty_Clear(ST7789_DirtyRegion* d)
+{
+    if (!d) return;
+    d->count = 0;
+    d->last = 0;
+}
+
+void ST7789_Dirty_AddPoint(ST7789_DirtyRegion* d, uint16_t x, uint16_t y)
+{
+    ST7789_Dirty_AddRect(d, x, y, x, y);
+}
+
+void ST7789_Dirty_AddRect(ST7789_DirtyRegion* d, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    if (!d || x0 > x1 || y0 > y1) return;
+
+    if (d->count > 0u && rect_contains(&d->rects[d->last], x0, y0, x1, y1)) return;
+
+    // 找到扩大后多发送像素最少的矩形
+    const uint32_t area = rect_area(x0, y0, x1, y1);
+    uint32_t bestExtra = UINT32_MAX;
+    uint8_t best = 0;
+    for (uint8_t i = 0; i < d->count; i++) {
+        ST7789_DirtyRect* r = &d->rects[i];
+        if (rect_contains(r, x0, y0, x1, y1)) {
+            d->last = i;
+            return;
+        }
+        uint32_t grown = union_area(r, x0, y0, x1, y1);
+        uint32_t extra = grown - rect_area(r->x0, r->y0, r->x1, r->y1);
+        extra = (extra > area) ? extra - area : 0u;
+        if (extra < bestExtra) {
+            bestExtra = extra;
+            best = i;
+        }
+    }
+
+    // 多发送的像素比一次窗口切换便宜，或者矩形已用完时，扩大已有矩形
+    if (d->count > 0u && (bestExtra <= ST7789_DIRTY_WINDOW_COST_PX || d->count >= ST7789_DIRTY_MAX_RECTS)) {
+        rect_grow(&d->rects[best], x0, y0, x1, y1);
+        d->last = best;
+        return;
+    }
+
+    ST7789_DirtyRect* r = &d->rects[d->count];
+    r->x0 = x0;
+    r->y0 = y0;
+    r->x1 = x1;
+    r->y1 = y1;
+    d->last = d->count;
+    d->count++;
+}
+
+void ST7789_Dirty_Coalesce(ST7789_DirtyRegion* d)
+{
+    if (!d) return;
+
+    // 矩形扩大后可能彼此重叠或相邻，合并所有合并后总开销更低的矩形对，直到没有可合并的
+    bool merged = true;
+    while (merged && d->count > 1u) {
+        merged = false;
+        for (uint8_t i = 0; i < d->count && !merged; i++) {
+            ST7789_DirtyRect* a = &d->rects[i];
+            const uint32_t areaA = rect_area(a->x0, a->y0, a->x1, a->y1);
+            for (uint8_t j = (uint8_t)(i + 1u); j < d->count; j++) {
+                ST7789_DirtyRect* b = &d->rects[j];
+                const uint32_t areaB = rect_area(b->x0, b->y0, b->x1, b->y1);
+                if (union_area(a, b->x0, b->y0, b->x1, b->y1) <= areaA + areaB + ST7789_DIRTY_WINDOW_COST_PX) {
+                    rect_grow(a, b->x0, b->y0, b->x1, b->y1);
+                    d->count--;
+                    if (j != d->count) d->rects[j] = d->rects[d->count];
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    d->last = 0;
+}
+
+uint32_t ST7789_Dirty_PixelCount(const ST7789_DirtyRegion* d)
+{
+    if (!d) return 0u;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < d->count; i++) {
+        const ST7789_DirtyRect* r = &d->rects[i];
+        total += rect_area(r->x0, r->y0, r->x1, r->y1);
+    }
+    return total;
+}
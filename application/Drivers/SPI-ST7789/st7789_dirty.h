@@ -0,0 +1,48 @@
+#ifndef __ST7789_DIRTY_H
+#define __ST7789_DIRTY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board_cfg.h"
+
+/*
+ * 帧缓冲脏区：最多 ST7789_DIRTY_MAX_RECTS 个矩形（坐标含端点）。
+ * 每个矩形单独刷新需要一次窗口切换，开销按 ST7789_DIRTY_WINDOW_COST_PX 个像素计：
+ * 扩大已有矩形多发送的像素少于该值时直接扩大，否则新建矩形；刷新前再合并代价更低的矩形对。
+ */
+
+typedef struct
+{
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+} ST7789_DirtyRect;
+
+typedef struct
+{
+    ST7789_DirtyRect rects[ST7789_DIRTY_MAX_RECTS];
+    uint8_t count;
+    uint8_t last;       // 最近一次命中的矩形，连续绘制时优先检查
+} ST7789_DirtyRegion;
+
+void ST7789_Dirty_Clear(ST7789_DirtyRegion* d);
+void ST7789_Dirty_AddPoint(ST7789_DirtyRegion* d, uint16_t x, uint16_t y);
+void ST7789_Dirty_AddRect(ST7789_DirtyRegion* d, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void ST7789_Dirty_Coalesce(ST7789_DirtyRegion* d);
+uint32_t ST7789_Dirty_PixelCount(const ST7789_DirtyRegion* d);
+
+static inline bool ST7789_Dirty_IsEmpty(const ST7789_DirtyRegion* d)
+{
+    return d->count == 0u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,188 @@
+#include "st7789_dma2d.h"
+#include "qspi-w25q64.h"
+#include <string.h>
+
+/* DMA2D 寄存器级驱动（工程未引入 HAL DMA2D），轮询完成，不占用中断 */
+
+#define ST7789_DMA2D_MODE_M2M       (0u << DMA2D_CR_MODE_Pos)
+#define ST7789_DMA2D_MODE_M2M_PFC   (1u << DMA2D_CR_MODE_Pos)
+#define ST7789_DMA2D_MODE_R2M       (3u << DMA2D_CR_MODE_Pos)
+#define ST7789_DMA2D_CM_RGB888      1u
+#define ST7789_DMA2D_CM_RGB565      2u
+#define ST7789_DMA2D_TIMEOUT_MS     50u
+
+typedef struct
+{
+    bool ready;
+    bool active;
+    uintptr_t dst_lo;       /* 进行中传输的目标与源范围，已按缓存行取整 */
+    uintptr_t dst_hi;
+    uintptr_t src_lo;
+    uintptr_t src_hi;
+} st7789_dma2d_t;
+
+static st7789_dma2d_t st7789_dma2d;
+
+/* DMA2D 挂在 AXI 总线上，访问不到 DTCM（栈与堆所在） */
+static inline bool st7789_dma2d_reachable(const void* p)
+{
+    uintptr_t a = (uintptr_t)p;
+    return !(a >= D1_DTCMRAM_BASE && a < D1_DTCMRAM_BASE + 0x20000u);
+}
+
+static inline uintptr_t st7789_dma2d_line_lo(uintptr_t a)
+{
+    return a & ~(uintptr_t)31u;
+}
+
+static inline uintptr_t st7789_dma2d_line_hi(uintptr_t a)
+{
+    return (a + 31u) & ~(uintptr_t)31u;
+}
+
+/* 二维区域占用的连续字节范围：从首像素到末像素，含行间不属于区域的部分 */
+static void st7789_dma2d_span(const void* base, uint32_t stride_bytes, uint32_t row_bytes, uint16_t h, uintptr_t* lo, uintptr_t* hi)
+{
+    uintptr_t start = (uintptr_t)base;
+    uintptr_t end = start + (uintptr_t)stride_bytes * (uint32_t)(h - 1u) + row_bytes;
+    *lo = st7789_dma2d_line_lo(start);
+    *hi = st7789_dma2d_line_hi(end);
+}
+
+static void st7789_dma2d_finish(void)
+{
+    DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+#if (__DCACHE_PRESENT == 1U)
+    /* 传输期间 CPU 可能推测性地把目标行读进缓存，完成后再失效一次 */
+    SCB_InvalidateDCache_by_Addr((uint32_t*)st7789_dma2d.dst_lo, (int32_t)(st7789_dma2d.dst_hi - st7789_dma2d.dst_lo));
+#endif
+    st7789_dma2d.active = false;
+}
+
+static bool st7789_dma2d_poll(void)
+{
+    if (!st7789_dma2d.active) return false;
+    if (DMA2D->CR & DMA2D_CR_START) return true;
+    st7789_dma2d_finish();
+    return false;
+}
+
+static void st7789_dma2d_start(uint16_t* dst, uint16_t dst_stride, uint16_t w, uint16_t h, const void* src, uint32_t src_stride_bytes, uint32_t src_bpp)
+{
+    st7789_dma2d_span(dst, (uint32_t)dst_stride * 2u, (uint32_t)w * 2u, h, &st7789_dma2d.dst_lo, &st7789_dma2d.dst_hi);
+    st7789_dma2d.src_lo = 0;
+    st7789_dma2d.src_hi = 0;
+    if (src) st7789_dma2d_span(src, src_stride_bytes, (uint32_t)w * src_bpp, h, &st7789_dma2d.src_lo, &st7789_dma2d.src_hi);
+#if (__DCACHE_PRESENT == 1U)
+    /* 源在可缓存内存中可能还有未写回的数据；目标先写回并失效，避免之后的脏行覆盖 DMA2D 的结果 */
+    if (src) SCB_CleanDCache_by_Addr((uint32_t*)st7789_dma2d.src_lo, (int32_t)(st7789_dma2d.src_hi - st7789_dma2d.src_lo));
+    SCB_CleanInvalidateDCache_by_Addr((uint32_t*)st7789_dma2d.dst_lo, (int32_t)(st7789_dma2d.dst_hi - st7789_dma2d.dst_lo));
+#endif
+    DMA2D->OMAR = (uint32_t)(uintptr_t)dst;
+    DMA2D->OOR = (uint32_t)(dst_stride - w);
+    DMA2D->NLR = ((uint32_t)w << DMA2D_NLR_PL_Pos) | (uint32_t)h;
+    st7789_dma2d.active = true;
+    DMA2D->CR |= DMA2D_CR_START;
+}
+
+void ST7789_DMA2D_Init(void)
+{
+    memset(&st7789_dma2d, 0, sizeof(st7789_dma2d));
+#if ST7789_DMA2D_ENABLE
+    __HAL_RCC_DMA2D_CLK_ENABLE();
+    DMA2D->CR = 0;
+    DMA2D->AMTCR = 0;
+    DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+    st7789_dma2d.ready = true;
+#endif
+}
+
+bool ST7789_DMA2D_IsBusy(void)
+{
+    return st7789_dma2d_poll();
+}
+
+void ST7789_DMA2D_Wait(void)
+{
+    if (!st7789_dma2d.active) return;
+    uint32_t start = HAL_GetTick();
+    while (st7789_dma2d_poll()) {
+        if ((uint32_t)(HAL_GetTick() - start) >= ST7789_DMA2D_TIMEOUT_MS) {
+            DMA2D->CR |= DMA2D_CR_ABORT;
+            while (DMA2D->CR & DMA2D_CR_START) {
+            }
+            st7789_dma2d_finish();
+            return;
+        }
+    }
+}
+
+void ST7789_DMA2D_Sync(const void* addr, uint32_t bytes)
+{
+    if (!st7789_dma2d_poll() || bytes == 0u) return;
+    uintptr_t lo = st7789_dma2d_line_lo((uintptr_t)addr);
+    uintptr_t hi = st7789_dma2d_line_hi((uintptr_t)addr + bytes);
+    bool hit_dst = lo < st7789_dma2d.dst_hi && st7789_dma2d.dst_lo < hi;
+    bool hit_src = lo < st7789_dma2d.src_hi && st7789_dma2d.src_lo < hi;
+    if (hit_dst || hit_src) ST7789_DMA2D_Wait();
+}
+
+bool ST7789_DMA2D_Fill(uint16_t* dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t value)
+{
+    if (!st7789_dma2d.ready || !dst || w == 0u || h == 0u) return false;
+    if (!st7789_dma2d_reachable(dst)) return false;
+    if (st7789_dma2d_poll()) return false;
+    DMA2D->CR = ST7789_DMA2D_MODE_R2M;
+    DMA2D->OPFCCR = ST7789_DMA2D_CM_RGB565;
+    /* 输出颜色寄存器按 RGB565 原样写入内存，value 已是帧缓冲字节序 */
+    DMA2D->OCOLR = value;
+    st7789_dma2d_start(dst, dst_stride, w, h, NULL, 0u, 0u);
+    return true;
+}
+
+bool ST7789_DMA2D_Copy(uint16_t* dst, uint16_t dst_stride, const void* src, uint32_t src_stride_bytes, uint16_t w, uint16_t h, ST7789_BitmapFormat format)
+{
+    if (!st7789_dma2d.ready || !dst || !src || w == 0u || h == 0u) return false;
+    if (!st7789_dma2d_reachable(dst) || !st7789_dma2d_reachable(src)) return false;
+    uint32_t bpp;
+    uint32_t mode;
+    uint32_t fg;
+    uint32_t out = ST7789_DMA2D_CM_RGB565;
+    if (format == ST7789_BITMAP_RGB565_BE) {
+        /* 与帧缓冲字节序相同，直接拷贝 */
+        bpp = 2u;
+        mode = ST7789_DMA2D_MODE_M2M;
+        fg = ST7789_DMA2D_CM_RGB565;
+    } else if (format == ST7789_BITMAP_RGB565_LE) {
+        bpp = 2u;
+        mode = ST7789_DMA2D_MODE_M2M_PFC;
+        fg = ST7789_DMA2D_CM_RGB565;
+        out |= DMA2D_OPFCCR_SB;
+    } else if (format == ST7789_BITMAP_RGB888) {
+        /* 源字节顺序为 R、G、B，DMA2D 的 RGB888 低字节为蓝色 */
+        bpp = 3u;
+        mode = ST7789_DMA2D_MODE_M2M_PFC;
+        fg = ST7789_DMA2D_CM_RGB888 | DMA2D_FGPFCCR_RBS;
+        out |= DMA2D_OPFCCR_SB;
+    } else {
+        /* ARGB8888 的字节顺序为 A、R、G、B，DMA2D 没有对应格式 */
+        return false;
+    }
+    if (src_stride_bytes % bpp != 0u || src_stride_bytes / bpp < w) return false;
+    /* 输出字节交换按像素对进行，行宽为奇数或目标未按 4 字节对齐时保守地交给 CPU */
+    if ((out & DMA2D_OPFCCR_SB) && ((w & 1u) != 0u || ((uintptr_t)dst & 3u) != 0u)) return false;
+    if (st7789_dma2d_poll()) return false;
+    DMA2D->CR = mode;
+    DMA2D->FGPFCCR = fg;
+    DMA2D->FGMAR = (uint32_t)(uintptr_t)src;
+    DMA2D->FGOR = src_stride_bytes / bpp - w;
+    DMA2D->OPFCCR = out;
+    st7789_dma2d_start(dst, dst_stride, w, h, src, src_stride_bytes, bpp);
+    return true;
+}
+
+/* 资源图与 GIF 帧可能直接从 QSPI 映射区读取：退出内存映射前等本次传输结束（覆盖 QSPI 驱动里的弱函数） */
+void QSPI_W25Qxx_ExitMappedCallback(void)
+{
+    ST7789_DMA2D_Wait();
+}
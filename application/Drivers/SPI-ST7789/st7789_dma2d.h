@@ -0,0 +1,37 @@
+#ifndef __ST7789_DMA2D_H
+#define __ST7789_DMA2D_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "st7789.h"
+
+/*
+ * 帧缓冲的 DMA2D 后端：大块填充与位图拷贝（含 RGB565 小端 / RGB888 到面板字节序的转换）。
+ * 同一时间只有一次传输在进行，提交后立即返回，CPU 可以继续做不涉及这段内存的工作。
+ *
+ * 提交接口在 DMA2D 忙、未启用或格式不支持时返回 false，由调用方改走 CPU 路径；
+ * CPU 访问任何可能被 DMA2D 读写的内存之前先调用 ST7789_DMA2D_Sync，
+ * 范围与进行中的传输重叠（按 32 字节缓存行取整）时等待完成，不重叠时直接返回。
+ * 数据缓存的清理与失效由后端负责，调用方只需遵守上面的同步规则。
+ */
+
+void ST7789_DMA2D_Init(void);
+bool ST7789_DMA2D_IsBusy(void);
+void ST7789_DMA2D_Wait(void);
+void ST7789_DMA2D_Sync(const void* addr, uint32_t bytes);
+
+/** @brief 用 value（已是帧缓冲字节序）填充 w x h 区域，dst_stride 以像素计 */
+bool ST7789_DMA2D_Fill(uint16_t* dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t value);
+
+/** @brief 把 src 的 w x h 像素拷贝到 dst 并转换为帧缓冲字节序；ARGB8888 不支持 */
+bool ST7789_DMA2D_Copy(uint16_t* dst, uint16_t dst_stride, const void* src, uint32_t src_stride_bytes, uint16_t w, uint16_t h, ST7789_BitmapFormat format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
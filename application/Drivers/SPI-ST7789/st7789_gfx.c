@@ -0,0 +1,1878 @@
+#include "st7789.h"
+#include <string.h>
+#include "spi-st7789.h"
+#include "st7789_dma2d.h"
+
+/* 帧缓冲、绘图、GIF、资源包与字体；只通过 spi-st7789.h 的接口访问 SPI 传输层 */
+
+static int st7789_abs_i(int v) { return (v < 0) ? -v : v; }
+static uint16_t st7789_fb[ST7789_WIDTH * ST7789_HEIGHT] __attribute__((section(".DMA_Section"), aligned(32)));
+
+static uint16_t st7789_rgb888_to_565(uint32_t rgb888)
+{
+    uint8_t r = (uint8_t)((rgb888 >> 16) & 0xFFu);
+    uint8_t g = (uint8_t)((rgb888 >> 8) & 0xFFu);
+    uint8_t b = (uint8_t)(rgb888 & 0xFFu);
+    return (uint16_t)(((uint16_t)(r & 0xF8u) << 8) | ((uint16_t)(g & 0xFCu) << 3) | (uint16_t)(b >> 3));
+}
+
+/* 帧缓冲按面板字节序（高字节在前）存放，刷新时可由 DMA 直接发送 */
+static inline uint16_t st7789_fb_color(uint16_t c565)
+{
+    return (uint16_t)((c565 >> 8) | (c565 << 8));
+}
+
+static inline uint32_t st7789_fb_index(uint16_t x, uint16_t y)
+{
+    return (uint32_t)y * (uint32_t)ST7789_WIDTH + (uint32_t)x;
+}
+
+/* CPU 读写帧缓冲第 y0..y1 行之前调用：与进行中的 DMA2D 传输重叠时等它完成 */
+static inline void st7789_fb_sync(const ST7789_Handle* lcd, uint16_t y0, uint16_t y1)
+{
+    ST7789_DMA2D_Sync(&lcd->fb_back[st7789_fb_index(0u, y0)], (uint32_t)(y1 - y0 + 1u) * ST7789_WIDTH * 2u);
+}
+
+static inline void st7789_mark_dirty_xy(ST7789_Handle* lcd, uint16_t x, uint16_t y)
+{
+    if (!lcd) return;
+    ST7789_Dirty_AddPoint(&lcd->dirty, x, y);
+}
+
+static void st7789_fb_clear(ST7789_Handle* lcd, uint16_t c565)
+{
+    if (!lcd || !lcd->framebuffer_enabled || !lcd->fb_back) return;
+    c565 = st7789_fb_color(c565);
+    uint32_t pixels = (uint32_t)ST7789_WIDTH * (uint32_t)ST7789_HEIGHT;
+    st7789_fb_sync(lcd, 0u, (uint16_t)(ST7789_HEIGHT - 1u));
+    bool changed = false;
+    for (uint32_t i = 0; i < pixels; i++) {
+        if (lcd->fb_back[i] != c565) {
+            lcd->fb_back[i] = c565;
+            changed = true;
+        }
+    }
+    if (changed) {
+        ST7789_InvalidateAll(lcd);
+    }
+}
+
+static void st7789_fb_fill_rect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c565)
+{
+    if (!lcd || !lcd->framebuffer_enabled || !lcd->fb_back) return;
+    if (w == 0u || h == 0u) return;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+    c565 = st7789_fb_color(c565);
+    uint16_t x1 = (uint16_t)(x + w - 1u);
+    uint16_t y1 = (uint16_t)(y + h - 1u);
+    if (x1 >= ST7789_WIDTH) x1 = (uint16_t)(ST7789_WIDTH - 1u);
+    if (y1 >= ST7789_HEIGHT) y1 = (uint16_t)(ST7789_HEIGHT - 1u);
+    /* 只把实际改变的像素的包围盒加入脏区，整块只登记一次。
+     * 不交给 DMA2D：重绘区域多数像素不变，逐像素比较省下的 SPI 流量比填充本身更值 */
+    st7789_fb_sync(lcd, y, y1);
+    uint16_t cx0 = x1, cy0 = y1, cx1 = x, cy1 = y;
+    bool changed = false;
+    for (uint16_t yy = y; yy <= y1; yy++) {
+        uint32_t row = (uint32_t)yy * (uint32_t)ST7789_WIDTH;
+        for (uint16_t xx = x; xx <= x1; xx++) {
+            uint32_t idx = row + xx;
+            if (lcd->fb_back[idx] != c565) {
+                lcd->fb_back[idx] = c565;
+                if (xx < cx0) cx0 = xx;
+                if (xx > cx1) cx1 = xx;
+                if (yy < cy0) cy0 = yy;
+                if (yy > cy1) cy1 = yy;
+                changed = true;
+            }
+        }
+    }
+    if (changed) {
+        ST7789_Dirty_AddRect(&lcd->dirty, cx0, cy0, cx1, cy1);
+    }
+}
+
+static bool st7789_flush_dirty(ST7789_Handle* lcd)
+{
+    if (!lcd || !lcd->fb_back) return true;
+    ST7789_DMA2D_Wait();
+    ST7789_Dirty_Coalesce(&lcd->dirty);
+    SPIST7789_Rect rects[ST7789_DIRTY_MAX_RECTS];
+    uint8_t count = lcd->dirty.count;
+    for (uint8_t i = 0; i < count; i++) {
+        const ST7789_DirtyRect* r = &lcd->dirty.rects[i];
+        rects[i].x = r->x0;
+        rects[i].y = r->y0;
+        rects[i].w = (uint16_t)(r->x1 - r->x0 + 1u);
+        rects[i].h = (uint16_t)(r->y1 - r->y0 + 1u);
+    }
+    return SPIST7789_FlushRectsAsync(lcd->fb_back, ST7789_WIDTH, rects, count);
+}
+
+uint32_t ST7789_RGB(uint8_t r, uint8_t g, uint8_t b)
+{
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+void ST7789_Init(ST7789_Handle* lcd, const ST7789_Config* cfg)
+{
+    if (!lcd) return;
+    memset(lcd, 0, sizeof(*lcd));
+    lcd->cfg.width = ST7789_WIDTH;
+    lcd->cfg.height = ST7789_HEIGHT;
+    lcd->cfg.x_offset = 0;
+    lcd->cfg.y_offset = SPIST7789_Y_OFFSET;
+    lcd->cfg.color_mode = ST7789_COLOR_MODE_RGB565;
+    lcd->cfg.rotation = ST7789_ROTATION_270;
+    lcd->cfg.invert = true;
+    lcd->cfg.fps = ST7789_DEFAULT_FPS;
+    lcd->cfg.use_framebuffer = false;
+    if (cfg) lcd->cfg = *cfg;
+    lcd->framebuffer_enabled = lcd->cfg.use_framebuffer;
+    ST7789_Dirty_Clear(&lcd->dirty);
+    lcd->fb_front = NULL;
+    lcd->fb_back = NULL;
+    if (lcd->framebuffer_enabled) {
+        lcd->fb_back = st7789_fb;
+        memset(st7789_fb, 0, sizeof(st7789_fb));
+    }
+    ST7789_DMA2D_Init();
+    SPIST7789_Init();
+    lcd->inited = true;
+}
+
+bool ST7789_IsInited(const ST7789_Handle* lcd)
+{
+    return lcd && lcd->inited;
+}
+
+bool ST7789_IsFrameBlocked(const ST7789_Handle* lcd)
+{
+    return lcd ? lcd->frame_blocked : true;
+}
+
+void ST7789_SetFrameRate(ST7789_Handle* lcd, uint8_t fps)
+{
+    if (!lcd) return;
+    lcd->cfg.fps = fps;
+}
+
+bool ST7789_FrameBegin(ST7789_Handle* lcd)
+{
+    SPIST7789_Service();
+    if (!lcd || !lcd->inited) return false;
+    /* 上一帧仍在由 DMA 从帧缓冲发送，此时绘制会撕裂画面 */
+    if (lcd->framebuffer_enabled && SPIST7789_IsBusy()) {
+        lcd->frame_blocked = true;
+        return false;
+    }
+    if (lcd->cfg.fps == 0) {
+        lcd->frame_blocked = false;
+        return true;
+    }
+    uint32_t intervalMs = 1000u / (uint32_t)lcd->cfg.fps;
+    if (intervalMs == 0u) intervalMs = 1u;
+    uint32_t nowMs = HAL_GetTick();
+    if (lcd->last_frame_ms != 0u && (uint32_t)(nowMs - lcd->last_frame_ms) < intervalMs) {
+        lcd->frame_blocked = true;
+        return false;
+    }
+    lcd->last_frame_ms = nowMs;
+    lcd->frame_blocked = false;
+    return true;
+}
+
+void ST7789_FrameEnd(ST7789_Handle* lcd)
+{
+    if (!lcd || !lcd->inited) return;
+    if (lcd->frame_blocked) return;
+    if (!lcd->framebuffer_enabled) return;
+    if (ST7789_Dirty_IsEmpty(&lcd->dirty)) return;
+    /* 启动失败（例如仍有填充在进行）时保留脏区，下一帧重试 */
+    if (!st7789_flush_dirty(lcd)) return;
+    ST7789_Dirty_Clear(&lcd->dirty);
+}
+
+void ST7789_Invalidate(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (!lcd || w == 0u || h == 0u) return;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+    uint16_t x1 = ((uint32_t)x + w > ST7789_WIDTH) ? (uint16_t)(ST7789_WIDTH - 1u) : (uint16_t)(x + w - 1u);
+    uint16_t y1 = ((uint32_t)y + h > ST7789_HEIGHT) ? (uint16_t)(ST7789_HEIGHT - 1u) : (uint16_t)(y + h - 1u);
+    ST7789_Dirty_AddRect(&lcd->dirty, x, y, x1, y1);
+}
+
+void ST7789_InvalidateAll(ST7789_Handle* lcd)
+{
+    if (!lcd) return;
+    ST7789_Dirty_Clear(&lcd->dirty);
+    ST7789_Dirty_AddRect(&lcd->dirty, 0u, 0u, (uint16_t)(ST7789_WIDTH - 1u), (uint16_t)(ST7789_HEIGHT - 1u));
+}
+
+void ST7789_AttachBacklightPWM(ST7789_Handle* lcd, TIM_HandleTypeDef* htim, uint32_t channel)
+{
+    if (!lcd) return;
+    lcd->cfg.bl_htim = htim;
+    lcd->cfg.bl_tim_channel = channel;
+}
+
+void ST7789_SetRotation(ST7789_Handle* lcd, ST7789_Rotation rotation)
+{
+    if (!lcd) return;
+    lcd->cfg.rotation = rotation;
+}
+
+void ST7789_SetOffset(ST7789_Handle* lcd, uint16_t x_offset, uint16_t y_offset)
+{
+    if (!lcd) return;
+    lcd->cfg.x_offset = x_offset;
+    lcd->cfg.y_offset = y_offset;
+}
+
+void ST7789_SetBacklight(ST7789_Handle* lcd, uint8_t percent)
+{
+    (void)lcd;
+    SPIST7789_SetBacklight(percent);
+}
+
+bool ST7789_IsTransferBusy(const ST7789_Handle* lcd)
+{
+    (void)lcd;
+    return SPIST7789_IsBusy();
+}
+
+bool ST7789_FillScreenAsync(ST7789_Handle* lcd, uint32_t rgb888)
+{
+    uint16_t c = st7789_rgb888_to_565(rgb888);
+    if (lcd && lcd->framebuffer_enabled) {
+        st7789_fb_clear(lcd, c);
+        return true;
+    }
+    return SPIST7789_FillRectColor565Async(0u, 0u, ST7789_WIDTH, ST7789_HEIGHT, c);
+}
+
+void ST7789_FillScreen(ST7789_Handle* lcd, uint32_t rgb888)
+{
+    (void)ST7789_FillScreenAsync(lcd, rgb888);
+    (void)SPIST7789_WaitDone(500u);
+}
+
+void ST7789_FillRect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t rgb888)
+{
+    uint16_t c = st7789_rgb888_to_565(rgb888);
+    if (lcd && lcd->framebuffer_enabled) {
+        st7789_fb_fill_rect(lcd, x, y, w, h, c);
+        return;
+    }
+    if (!SPIST7789_FillRectColor565Async(x, y, w, h, c)) return;
+    (void)SPIST7789_WaitDone(200u);
+}
+
+void ST7789_DrawPixel(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint32_t rgb888)
+{
+    if (lcd && lcd->framebuffer_enabled) {
+        if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+        uint16_t c = st7789_fb_color(st7789_rgb888_to_565(rgb888));
+        uint32_t idx = st7789_fb_index(x, y);
+        st7789_fb_sync(lcd, y, y);
+        if (lcd->fb_back[idx] == c) return;
+        lcd->fb_back[idx] = c;
+        st7789_mark_dirty_xy(lcd, x, y);
+        return;
+    }
+    ST7789_FillRect(lcd, x, y, 1u, 1u, rgb888);
+}
+
+void ST7789_DrawLine(ST7789_Handle* lcd, int x0, int y0, int x1, int y1, uint32_t rgb888)
+{
+    int dx = st7789_abs_i(x1 - x0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int dy = -st7789_abs_i(y1 - y0);
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+    while (1)
+    {
+        if (x0 >= 0 && y0 >= 0 && x0 < (int)ST7789_WIDTH && y0 < (int)ST7789_HEIGHT) {
+            ST7789_DrawPixel(lcd, (uint16_t)x0, (uint16_t)y0, rgb888);
+        }
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void ST7789_DrawRect(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t rgb888)
+{
+    if (w == 0u || h == 0u) return;
+    ST7789_DrawLine(lcd, x, y, (int)(x + w - 1u), y, rgb888);
+    ST7789_DrawLine(lcd, x, (int)(y + h - 1u), (int)(x + w - 1u), (int)(y + h - 1u), rgb888);
+    ST7789_DrawLine(lcd, x, y, x, (int)(y + h - 1u), rgb888);
+    ST7789_DrawLine(lcd, (int)(x + w - 1u), y, (int)(x + w - 1u), (int)(y + h - 1u), rgb888);
+}
+
+static const uint8_t st7789_font5x7[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00},{0x00,0x00,0x5F,0x00,0x00},{0x00,0x07,0x00,0x07,0x00},{0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12},{0x23,0x13,0x08,0x64,0x62},{0x36,0x49,0x55,0x22,0x50},{0x00,0x05,0x03,0x00,0x00},
+    {0x00,0x1C,0x22,0x41,0x00},{0x00,0x41,0x22,0x1C,0x00},{0x14,0x08,0x3E,0x08,0x14},{0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x50,0x30,0x00,0x00},{0x08,0x08,0x08,0x08,0x08},{0x00,0x60,0x60,0x00,0x00},{0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E},{0x00,0x42,0x7F,0x40,0x00},{0x42,0x61,0x51,0x49,0x46},{0x21,0x41,0x45,0x4B,0x31},
+    {0x18,0x14,0x12,0x7F,0x10},{0x27,0x45,0x45,0x45,0x39},{0x3C,0x4A,0x49,0x49,0x30},{0x01,0x71,0x09,0x05,0x03},
+    {0x36,0x49,0x49,0x49,0x36},{0x06,0x49,0x49,0x29,0x1E},{0x00,0x36,0x36,0x00,0x00},{0x00,0x56,0x36,0x00,0x00},
+    {0x08,0x14,0x22,0x41,0x00},{0x14,0x14,0x14,0x14,0x14},{0x00,0x41,0x22,0x14,0x08},{0x02,0x01,0x51,0x09,0x06},
+    {0x32,0x49,0x79,0x41,0x3E},{0x7E,0x11,0x11,0x11,0x7E},{0x7F,0x49,0x49,0x49,0x36},{0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x22,0x1C},{0x7F,0x49,0x49,0x49,0x41},{0x7F,0x09,0x09,0x09,0x01},{0x3E,0x41,0x49,0x49,0x7A},
+    {0x7F,0x08,0x08,0x08,0x7F},{0x00,0x41,0x7F,0x41,0x00},{0x20,0x40,0x41,0x3F,0x01},{0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40},{0x7F,0x02,0x0C,0x02,0x7F},{0x7F,0x04,0x08,0x10,0x7F},{0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06},{0x3E,0x41,0x51,0x21,0x5E},{0x7F,0x09,0x19,0x29,0x46},{0x46,0x49,0x49,0x49,0x31},
+    {0x01,0x01,0x7F,0x01,0x01},{0x3F,0x40,0x40,0x40,0x3F},{0x1F,0x20,0x40,0x20,0x1F},{0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63},{0x07,0x08,0x70,0x08,0x07},{0x61,0x51,0x49,0x45,0x43},{0x00,0x7F,0x41,0x41,0x00},
+    {0x02,0x04,0x08,0x10,0x20},{0x00,0x41,0x41,0x7F,0x00},{0x04,0x02,0x01,0x02,0x04},{0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x01,0x02,0x04,0x00},{0x20,0x54,0x54,0x54,0x78},{0x7F,0x48,0x44,0x44,0x38},{0x38,0x44,0x44,0x44,0x20},
+    {0x38,0x44,0x44,0x48,0x7F},{0x38,0x54,0x54,0x54,0x18},{0x08,0x7E,0x09,0x01,0x02},{0x0C,0x52,0x52,0x52,0x3E},
+    {0x7F,0x08,0x04,0x04,0x78},{0x00,0x44,0x7D,0x40,0x00},{0x20,0x40,0x44,0x3D,0x00},{0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00},{0x7C,0x04,0x18,0x04,0x78},{0x7C,0x08,0x04,0x04,0x78},{0x38,0x44,0x44,0x44,0x38},
+    {0x7C,0x14,0x14,0x14,0x08},{0x08,0x14,0x14,0x18,0x7C},{0x7C,0x08,0x04,0x04,0x08},{0x48,0x54,0x54,0x54,0x20},
+    {0x04,0x3F,0x44,0x40,0x20},{0x3C,0x40,0x40,0x20,0x7C},{0x1C,0x20,0x40,0x20,0x1C},{0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44},{0x0C,0x50,0x50,0x50,0x3C},{0x44,0x64,0x54,0x4C,0x44},{0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x7F,0x00,0x00},{0x00,0x41,0x36,0x08,0x00},{0x10,0x08,0x08,0x10,0x08}
+};
+
+static uint16_t st7789_char_cell_w(uint8_t scale)
+{
+    if (scale == 0u) scale = 1u;
+    if (scale == 3u) return 9u;
+    return (uint16_t)(6u * scale);
+}
+
+static uint16_t st7789_char_cell_h(uint8_t scale)
+{
+    if (scale == 0u) scale = 1u;
+    if (scale == 3u) return 12u;
+    return (uint16_t)(8u * scale);
+}
+
+void ST7789_DrawChar(ST7789_Handle* lcd, uint16_t x, uint16_t y, char c, uint32_t fg_rgb888, uint32_t bg_rgb888, uint8_t scale)
+{
+    if (scale == 0u) scale = 1u;
+    if (c < 32 || c > 126) c = '?';
+    const uint8_t* glyph = st7789_font5x7[(uint8_t)(c - 32)];
+    uint16_t w = st7789_char_cell_w(scale);
+    uint16_t h = st7789_char_cell_h(scale);
+    ST7789_FillRect(lcd, x, y, w, h, bg_rgb888);
+    if (scale == 3u)
+    {
+        for (uint8_t dy = 0; dy < 12u; dy++) {
+            uint8_t sy = (uint8_t)(((uint16_t)dy * 2u) / 3u);
+            if (sy >= 7u) continue;
+            for (uint8_t dx = 0; dx < 9u; dx++) {
+                uint8_t sx = (uint8_t)(((uint16_t)dx * 2u) / 3u);
+                if (sx >= 5u) continue;
+                if (glyph[sx] & (uint8_t)(1u << sy)) ST7789_DrawPixel(lcd, (uint16_t)(x + dx), (uint16_t)(y + dy), fg_rgb888);
+            }
+        }
+        return;
+    }
+    for (uint8_t col = 0; col < 5u; col++) {
+        uint8_t line = glyph[col];
+        for (uint8_t row = 0; row < 7u; row++) {
+            if (line & 0x01u) ST7789_FillRect(lcd, (uint16_t)(x + col * scale), (uint16_t)(y + row * scale), scale, scale, fg_rgb888);
+            line >>= 1u;
+        }
+    }
+}
+
+void ST7789_DrawString(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* s, uint32_t fg_rgb888, uint32_t bg_rgb888, uint8_t scale)
+{
+    if (!s) return;
+    if (scale == 0u) scale = 1u;
+    uint16_t cx = x;
+    uint16_t cy = y;
+    uint16_t step_x = st7789_char_cell_w(scale);
+    uint16_t step_y = st7789_char_cell_h(scale);
+    while (*s)
+    {
+        char c = *s++;
+        if (c == '\n') { cx = x; cy = (uint16_t)(cy + step_y); continue; }
+        if (c == '\r') continue;
+        if (cx + step_x > ST7789_WIDTH) { cx = x; cy = (uint16_t)(cy + step_y); }
+        if (cy + step_y > ST7789_HEIGHT) break;
+        ST7789_DrawChar(lcd, cx, cy, c, fg_rgb888, bg_rgb888, scale);
+        cx = (uint16_t)(cx + step_x);
+    }
+}
+
+void ST7789_SPI_DMA_IRQHandler(void)
+{
+    SPIST7789_DMA_IRQHandler();
+}
+
+void ST7789_SPI_IRQHandler(void)
+{
+    SPIST7789_SPI_IRQHandler();
+}
+
+void ST7789_DrawCircle(ST7789_Handle* lcd, int x0, int y0, int r, uint32_t rgb888)
+{
+    if (r < 0) return;
+    int x = -r;
+    int y = 0;
+    int err = 2 - 2 * r;
+    do {
+        ST7789_DrawPixel(lcd, (uint16_t)(x0 - x), (uint16_t)(y0 + y), rgb888);
+        ST7789_DrawPixel(lcd, (uint16_t)(x0 - y), (uint16_t)(y0 - x), rgb888);
+        ST7789_DrawPixel(lcd, (uint16_t)(x0 + x), (uint16_t)(y0 - y), rgb888);
+        ST7789_DrawPixel(lcd, (uint16_t)(x0 + y), (uint16_t)(y0 + x), rgb888);
+        int e2 = err;
+        if (e2 <= y) {
+            y++;
+            err += y * 2 + 1;
+            if (-x == y && e2 <= x) e2 = 0;
+        }
+        if (e2 > x) {
+            x++;
+            err += x * 2 + 1;
+        }
+    } while (x <= 0);
+}
+
+void ST7789_FillCircle(ST7789_Handle* lcd, int x0, int y0, int r, uint32_t rgb888)
+{
+    if (r < 0) return;
+    int x = -r;
+    int y = 0;
+    int err = 2 - 2 * r;
+    do {
+        ST7789_DrawLine(lcd, x0 + x, y0 - y, x0 - x, y0 - y, rgb888);
+        ST7789_DrawLine(lcd, x0 + x, y0 + y, x0 - x, y0 + y, rgb888);
+        int e2 = err;
+        if (e2 <= y) {
+            y++;
+            err += y * 2 + 1;
+            if (-x == y && e2 <= x) e2 = 0;
+        }
+        if (e2 > x) {
+            x++;
+            err += x * 2 + 1;
+        }
+    } while (x <= 0);
+}
+
+void ST7789_DrawBitmap(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const void* pixels, ST7789_BitmapFormat format, uint32_t stride_bytes)
+{
+    if (!lcd || !lcd->inited || !pixels) return;
+    if (w == 0u || h == 0u) return;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+    if (stride_bytes == 0u) {
+        if (format == ST7789_BITMAP_RGB565_BE || format == ST7789_BITMAP_RGB565_LE) stride_bytes = (uint32_t)w * 2u;
+        else if (format == ST7789_BITMAP_RGB888) stride_bytes = (uint32_t)w * 3u;
+        else stride_bytes = (uint32_t)w * 4u;
+    }
+    uint16_t draw_w = w;
+    uint16_t draw_h = h;
+    if ((uint32_t)x + draw_w > ST7789_WIDTH) draw_w = (uint16_t)(ST7789_WIDTH - x);
+    if ((uint32_t)y + draw_h > ST7789_HEIGHT) draw_h = (uint16_t)(ST7789_HEIGHT - y);
+
+    if (lcd->framebuffer_enabled && (uint32_t)draw_w * draw_h >= ST7789_DMA2D_MIN_PIXELS &&
+        ST7789_DMA2D_Copy(&lcd->fb_back[st7789_fb_index(x, y)], ST7789_WIDTH, pixels, stride_bytes, draw_w, draw_h, format)) {
+        ST7789_Dirty_AddRect(&lcd->dirty, x, y, (uint16_t)(x + draw_w - 1u), (uint16_t)(y + draw_h - 1u));
+        return;
+    }
+
+    const uint8_t* src = (const uint8_t*)pixels;
+    for (uint16_t row = 0; row < draw_h; row++) {
+        const uint8_t* row_ptr = src + (size_t)row * (size_t)stride_bytes;
+        for (uint16_t col = 0; col < draw_w; col++) {
+            uint32_t rgb = 0;
+            if (format == ST7789_BITMAP_RGB565_BE) {
+                const uint8_t* p = row_ptr + (size_t)col * 2u;
+                uint16_t c = (uint16_t)((uint16_t)p[0] << 8 | (uint16_t)p[1]);
+                uint8_t r5 = (uint8_t)((c >> 11) & 0x1Fu);
+                uint8_t g6 = (uint8_t)((c >> 5) & 0x3Fu);
+                uint8_t b5 = (uint8_t)(c & 0x1Fu);
+                rgb = ST7789_RGB((uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)));
+            } else if (format == ST7789_BITMAP_RGB565_LE) {
+                const uint8_t* p = row_ptr + (size_t)col * 2u;
+                uint16_t c = (uint16_t)((uint16_t)p[1] << 8 | (uint16_t)p[0]);
+                uint8_t r5 = (uint8_t)((c >> 11) & 0x1Fu);
+                uint8_t g6 = (uint8_t)((c >> 5) & 0x3Fu);
+                uint8_t b5 = (uint8_t)(c & 0x1Fu);
+                rgb = ST7789_RGB((uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)));
+            } else if (format == ST7789_BITMAP_RGB888) {
+                const uint8_t* p = row_ptr + (size_t)col * 3u;
+                rgb = ST7789_RGB(p[0], p[1], p[2]);
+            } else {
+                const uint8_t* p = row_ptr + (size_t)col * 4u;
+                if (p[0] == 0u) continue;
+                rgb = ST7789_RGB(p[1], p[2], p[3]);
+            }
+            ST7789_DrawPixel(lcd, (uint16_t)(x + col), (uint16_t)(y + row), rgb);
+        }
+    }
+}
+
+void ST7789_DrawBitmap1BPP(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* bits, uint32_t stride_bytes, uint32_t fg_rgb888, uint32_t bg_rgb888)
+{
+    if (!lcd || !lcd->inited || !bits) return;
+    if (w == 0u || h == 0u) return;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+    if (stride_bytes == 0u) stride_bytes = (uint32_t)((w + 7u) >> 3);
+    uint16_t draw_w = w;
+    uint16_t draw_h = h;
+    if ((uint32_t)x + draw_w > ST7789_WIDTH) draw_w = (uint16_t)(ST7789_WIDTH - x);
+    if ((uint32_t)y + draw_h > ST7789_HEIGHT) draw_h = (uint16_t)(ST7789_HEIGHT - y);
+
+    for (uint16_t row = 0; row < draw_h; row++) {
+        const uint8_t* row_ptr = bits + (size_t)row * (size_t)stride_bytes;
+        for (uint16_t col = 0; col < draw_w; col++) {
+            uint8_t byte = row_ptr[col >> 3];
+            uint8_t bit = (uint8_t)((byte >> (7u - (col & 7u))) & 0x01u);
+            ST7789_DrawPixel(lcd, (uint16_t)(x + col), (uint16_t)(y + row), bit ? fg_rgb888 : bg_rgb888);
+        }
+    }
+}
+
+typedef struct
+{
+    const uint8_t* data;
+    size_t len;
+    size_t pos;
+} st7789_gif_stream_t;
+
+typedef struct
+{
+    bool transparent;
+    uint8_t transparent_index;
+    uint16_t delay_cs;
+    uint8_t disposal;
+} st7789_gif_gce_t;
+
+typedef struct
+{
+    st7789_gif_stream_t* s;
+    uint8_t subblock_remaining;
+    bool terminator_seen;
+    uint32_t datum;
+    uint8_t bits;
+} st7789_gif_lzw_reader_t;
+
+static uint16_t st7789_gif_prefix[4096];
+static uint8_t st7789_gif_suffix[4096];
+static uint8_t st7789_gif_stack[4096];
+static uint8_t st7789_gif_gct[256 * 3];
+static uint8_t st7789_gif_lct[256 * 3];
+static uint8_t st7789_gif_line_idx[ST7789_WIDTH];
+
+static bool st7789_gif_read_u8(st7789_gif_stream_t* s, uint8_t* out)
+{
+    if (!s || !out || s->pos >= s->len) return false;
+    *out = s->data[s->pos++];
+    return true;
+}
+
+static bool st7789_gif_read_u16le(st7789_gif_stream_t* s, uint16_t* out)
+{
+    uint8_t lo = 0, hi = 0;
+    if (!st7789_gif_read_u8(s, &lo)) return false;
+    if (!st7789_gif_read_u8(s, &hi)) return false;
+    *out = (uint16_t)((uint16_t)lo | ((uint16_t)hi << 8));
+    return true;
+}
+
+static bool st7789_gif_skip(st7789_gif_stream_t* s, size_t n)
+{
+    if (!s) return false;
+    if (s->pos + n > s->len) return false;
+    s->pos += n;
+    return true;
+}
+
+static bool st7789_gif_skip_subblocks(st7789_gif_stream_t* s)
+{
+    uint8_t sz = 0;
+    while (1) {
+        if (!st7789_gif_read_u8(s, &sz)) return false;
+        if (sz == 0u) return true;
+        if (!st7789_gif_skip(s, sz)) return false;
+    }
+}
+
+static bool st7789_gif_read_color_table(st7789_gif_stream_t* s, uint8_t* pal, uint16_t count)
+{
+    if (!s || !pal || count > 256u) return false;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!st7789_gif_read_u8(s, &pal[i * 3u + 0u])) return false;
+        if (!st7789_gif_read_u8(s, &pal[i * 3u + 1u])) return false;
+        if (!st7789_gif_read_u8(s, &pal[i * 3u + 2u])) return false;
+    }
+    return true;
+}
+
+static bool st7789_gif_read_gce(st7789_gif_stream_t* s, st7789_gif_gce_t* gce)
+{
+    uint8_t block_size = 0;
+    if (!st7789_gif_read_u8(s, &block_size)) return false;
+    if (block_size != 4u) return false;
+    uint8_t packed = 0, trans = 0, terminator = 0;
+    uint16_t delay_cs = 0;
+    if (!st7789_gif_read_u8(s, &packed)) return false;
+    if (!st7789_gif_read_u16le(s, &delay_cs)) return false;
+    if (!st7789_gif_read_u8(s, &trans)) return false;
+    if (!st7789_gif_read_u8(s, &terminator)) return false;
+    if (terminator != 0u) return false;
+    if (gce) {
+        gce->transparent = (packed & 0x01u) ? true : false;
+        gce->transparent_index = trans;
+        gce->delay_cs = delay_cs;
+        gce->disposal = (uint8_t)((packed >> 2) & 0x07u);
+    }
+    return true;
+}
+
+static bool st7789_gif_lzw_next_data_byte(st7789_gif_lzw_reader_t* r, uint8_t* out)
+{
+    if (!r || !out) return false;
+    if (r->terminator_seen) return false;
+    if (r->subblock_remaining == 0u) {
+        uint8_t sz = 0;
+        if (!st7789_gif_read_u8(r->s, &sz)) return false;
+        if (sz == 0u) {
+            r->terminator_seen = true;
+            return false;
+        }
+        r->subblock_remaining = sz;
+    }
+    if (!st7789_gif_read_u8(r->s, out)) return false;
+    r->subblock_remaining--;
+    return true;
+}
+
+static bool st7789_gif_lzw_drain_to_terminator(st7789_gif_lzw_reader_t* r)
+{
+    if (!r) return false;
+    if (r->terminator_seen) return true;
+    if (r->subblock_remaining) {
+        if (!st7789_gif_skip(r->s, r->subblock_remaining)) return false;
+        r->subblock_remaining = 0;
+    }
+    if (!st7789_gif_skip_subblocks(r->s)) return false;
+    r->terminator_seen = true;
+    return true;
+}
+
+static int st7789_gif_lzw_read_code(st7789_gif_lzw_reader_t* r, int code_size)
+{
+    while (r->bits < (uint8_t)code_size) {
+        uint8_t byte = 0;
+        if (!st7789_gif_lzw_next_data_byte(r, &byte)) return -1;
+        r->datum |= ((uint32_t)byte << r->bits);
+        r->bits = (uint8_t)(r->bits + 8u);
+    }
+    int mask = (1 << code_size) - 1;
+    int code = (int)(r->datum & (uint32_t)mask);
+    r->datum >>= code_size;
+    r->bits = (uint8_t)(r->bits - (uint8_t)code_size);
+    return code;
+}
+
+/* 当前图像块的调色板，已转换为帧缓冲字节序的 RGB565，每帧只转换一次 */
+static uint16_t st7789_gif_pal565[256];
+/* 无帧缓冲时的行暂存，SPI DMA 直接读取 */
+static uint16_t st7789_gif_row565[ST7789_WIDTH] __attribute__((section(".DMA_Section"), aligned(32)));
+
+/* 可分片执行的 LZW 解码状态：每次调用解码若干行后返回，下次从断点继续 */
+typedef struct
+{
+    st7789_gif_lzw_reader_t r;
+    uint16_t left;
+    uint16_t top;
+    uint16_t w;
+    uint16_t h;
+    bool interlaced;
+    int16_t transparent;        /* 透明色索引，-1 表示无 */
+    uint16_t delay_ms;
+    uint8_t disposal;
+    int clear_code;
+    int end_code;
+    int code_size;
+    int next_code;
+    int old_code;
+    uint8_t lzw_min;
+    uint8_t first;
+    uint16_t stack_top;         /* 跨行的像素串留在栈中，下一行继续输出 */
+    uint8_t pass;
+    uint16_t interlace_row;
+    uint16_t row_actual;
+    uint16_t col;
+    uint16_t rows_written;
+} st7789_gif_decoder_t;
+
+static void st7789_gif_build_palette(const uint8_t* pal, uint16_t count)
+{
+    for (uint16_t i = 0; i < 256u; i++) {
+        uint16_t c = 0u;
+        if (pal && i < count) {
+            c = (uint16_t)(((uint16_t)(pal[i * 3u + 0u] & 0xF8u) << 8) |
+                           ((uint16_t)(pal[i * 3u + 1u] & 0xFCu) << 3) |
+                           (uint16_t)(pal[i * 3u + 2u] >> 3));
+        }
+        st7789_gif_pal565[i] = st7789_fb_color(c);
+    }
+}
+
+/* 写入一行像素，透明像素保留下层内容。不登记脏区，由调用方在整帧完成后统一登记 */
+static void st7789_gif_write_row(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* idx, uint16_t w, int16_t transparent)
+{
+    if (!lcd || !idx || w == 0u) return;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return;
+    if ((uint32_t)x + w > ST7789_WIDTH) w = (uint16_t)(ST7789_WIDTH - x);
+    if (lcd->framebuffer_enabled) {
+        st7789_fb_sync(lcd, y, y);
+        uint16_t* dst = &lcd->fb_back[st7789_fb_index(x, y)];
+        for (uint16_t i = 0; i < w; i++) {
+            if ((int16_t)idx[i] == transparent) continue;
+            dst[i] = st7789_gif_pal565[idx[i]];
+        }
+        return;
+    }
+    /* 调色板已是面板字节序，原样拼成不透明连续段后直接 DMA 发送 */
+    for (uint16_t i = 0; i < w;) {
+        if ((int16_t)idx[i] == transparent) {
+            i++;
+            continue;
+        }
+        uint16_t start = i;
+        while (i < w && (int16_t)idx[i] != transparent) {
+            st7789_gif_row565[i] = st7789_gif_pal565[idx[i]];
+            i++;
+        }
+        if (SPIST7789_FlushRectAsync(&st7789_gif_row565[start], ST7789_WIDTH, (uint16_t)(x + start), y, (uint16_t)(i - start), 1u)) {
+            (void)SPIST7789_WaitDone(200u);
+        }
+    }
+}
+
+static bool st7789_gif_decoder_begin(st7789_gif_decoder_t* d, st7789_gif_stream_t* s, uint16_t left, uint16_t top, uint16_t w, uint16_t h, bool interlaced, const st7789_gif_gce_t* gce)
+{
+    memset(d, 0, sizeof(*d));
+    if (!st7789_gif_read_u8(s, &d->lzw_min)) return false;
+    if (d->lzw_min < 2u || d->lzw_min > 8u) return false;
+    if (w > ST7789_WIDTH) return false;
+
+    d->r.s = s;
+    d->left = left;
+    d->top = top;
+    d->w = w;
+    d->h = h;
+    d->interlaced = interlaced;
+    d->transparent = (gce && gce->transparent) ? (int16_t)gce->transparent_index : (int16_t)-1;
+    uint16_t ms = (uint16_t)((gce ? gce->delay_cs : 0u) * 10u);
+    d->delay_ms = (ms == 0u) ? 10u : ms;
+    d->disposal = gce ? gce->disposal : 0u;
+    d->clear_code = 1 << d->lzw_min;
+    d->end_code = d->clear_code + 1;
+    d->code_size = d->lzw_min + 1;
+    d->next_code = d->end_code + 1;
+    d->old_code = -1;
+
+    for (int i = 0; i < d->clear_code; i++) {
+        st7789_gif_prefix[i] = 0xFFFFu;
+        st7789_gif_suffix[i] = (uint8_t)i;
+    }
+    return true;
+}
+
+/* 最多解码 max_rows 行写入屏幕，返回 1 表示图像块完成，0 表示尚未完成，-1 表示数据错误 */
+static int st7789_gif_decode_rows(ST7789_Handle* lcd, uint16_t base_x, uint16_t base_y, st7789_gif_decoder_t* d, uint16_t max_rows)
+{
+    uint16_t rows = 0;
+    while (d->rows_written < d->h && rows < max_rows) {
+        if (d->stack_top == 0u) {
+            int code = st7789_gif_lzw_read_code(&d->r, d->code_size);
+            if (code < 0 || code == d->end_code) return -1;
+            if (code == d->clear_code) {
+                d->code_size = d->lzw_min + 1;
+                d->next_code = d->end_code + 1;
+                d->old_code = -1;
+                continue;
+            }
+            if (d->old_code == -1) {
+                d->first = (uint8_t)code;
+                d->old_code = code;
+                st7789_gif_stack[d->stack_top++] = d->first;
+            } else {
+                int in_code = code;
+                if (code >= d->next_code) {
+                    st7789_gif_stack[d->stack_top++] = d->first;
+                    code = d->old_code;
+                }
+                while (code >= d->clear_code) {
+                    if (d->stack_top >= sizeof(st7789_gif_stack)) return -1;
+                    st7789_gif_stack[d->stack_top++] = st7789_gif_suffix[code];
+                    code = st7789_gif_prefix[code];
+                }
+                if (d->stack_top >= sizeof(st7789_gif_stack)) return -1;
+                d->first = (uint8_t)code;
+                st7789_gif_stack[d->stack_top++] = d->first;
+                if (d->next_code < 4096) {
+                    st7789_gif_prefix[d->next_code] = (uint16_t)d->old_code;
+                    st7789_gif_suffix[d->next_code] = d->first;
+                    d->next_code++;
+                    if (d->next_code == (1 << d->code_size) && d->code_size < 12) d->code_size++;
+                }
+                d->old_code = in_code;
+            }
+        }
+
+        while (d->stack_top && d->col < d->w) {
+            st7789_gif_line_idx[d->col++] = st7789_gif_stack[--d->stack_top];
+        }
+
+        if (d->col == d->w) {
+            uint16_t sx = (uint16_t)(base_x + d->left);
+            uint16_t sy = (uint16_t)(base_y + d->top + d->row_actual);
+            st7789_gif_write_row(lcd, sx, sy, st7789_gif_line_idx, d->w, d->transparent);
+            d->col = 0;
+            d->rows_written++;
+            rows++;
+            if (d->interlaced) {
+                static const uint8_t start[4] = {0, 4, 2, 1};
+                static const uint8_t step[4] = {8, 8, 4, 2};
+                d->interlace_row = (uint16_t)(d->interlace_row + step[d->pass]);
+                while (d->pass < 3u && d->interlace_row >= d->h) {
+                    d->pass++;
+                    d->interlace_row = start[d->pass];
+                }
+                d->row_actual = d->interlace_row;
+            } else {
+                d->row_actual++;
+            }
+        }
+    }
+
+    if (d->rows_written < d->h) return 0;
+    if (!st7789_gif_lzw_drain_to_terminator(&d->r)) return -1;
+    return 1;
+}
+
+static bool st7789_gif_has_signature(const uint8_t* gif, size_t gif_len)
+{
+    if (!gif || gif_len < 6u) return false;
+    if (gif[0] != 'G' || gif[1] != 'I' || gif[2] != 'F') return false;
+    if (gif[3] != '8') return false;
+    if (gif[4] != '7' && gif[4] != '9') return false;
+    if (gif[5] != 'a') return false;
+    return true;
+}
+
+/* 读取逻辑屏幕描述符和全局调色板，完成后流位于第一个块 */
+static bool st7789_gif_open(st7789_gif_stream_t* s, const uint8_t* gif, size_t gif_len, uint16_t* out_w, uint16_t* out_h, uint16_t* out_gct_count)
+{
+    if (!st7789_gif_has_signature(gif, gif_len)) return false;
+    s->data = gif;
+    s->len = gif_len;
+    s->pos = 6;
+    uint16_t w = 0, h = 0;
+    uint8_t packed = 0, bg = 0, aspect = 0;
+    if (!st7789_gif_read_u16le(s, &w)) return false;
+    if (!st7789_gif_read_u16le(s, &h)) return false;
+    if (!st7789_gif_read_u8(s, &packed)) return false;
+    if (!st7789_gif_read_u8(s, &bg)) return false;
+    if (!st7789_gif_read_u8(s, &aspect)) return false;
+    uint16_t gct_count = 0;
+    if (packed & 0x80u) {
+        uint8_t sz = (uint8_t)(packed & 0x07u);
+        gct_count = (uint16_t)(1u << (sz + 1u));
+        if (!st7789_gif_read_color_table(s, st7789_gif_gct, gct_count)) return false;
+    }
+    if (out_w) *out_w = w;
+    if (out_h) *out_h = h;
+    if (out_gct_count) *out_gct_count = gct_count;
+    return true;
+}
+
+/* 跳过扩展块直到下一个图像块，转换调色板并初始化解码器。返回 1 找到图像，0 到达结尾，-1 数据错误 */
+static int st7789_gif_next_image(st7789_gif_stream_t* s, uint16_t gct_count, st7789_gif_gce_t* gce, st7789_gif_decoder_t* d)
+{
+    while (s->pos < s->len) {
+        uint8_t sep = 0;
+        if (!st7789_gif_read_u8(s, &sep)) return -1;
+        if (sep == 0x3Bu) return 0;
+        if (sep == 0x21u) {
+            uint8_t label = 0;
+            if (!st7789_gif_read_u8(s, &label)) return -1;
+            if (label == 0xF9u) {
+                if (!st7789_gif_read_gce(s, gce)) return -1;
+            } else {
+                if (!st7789_gif_skip_subblocks(s)) return -1;
+            }
+            continue;
+        }
+        if (sep != 0x2Cu) return -1;
+
+        uint16_t left = 0, top = 0, w = 0, h = 0;
+        uint8_t ipacked = 0;
+        if (!st7789_gif_read_u16le(s, &left)) return -1;
+        if (!st7789_gif_read_u16le(s, &top)) return -1;
+        if (!st7789_gif_read_u16le(s, &w)) return -1;
+        if (!st7789_gif_read_u16le(s, &h)) return -1;
+        if (!st7789_gif_read_u8(s, &ipacked)) return -1;
+        bool interlaced = (ipacked & 0x40u) ? true : false;
+        if (ipacked & 0x80u) {
+            uint8_t sz = (uint8_t)(ipacked & 0x07u);
+            uint16_t lct_count = (uint16_t)(1u << (sz + 1u));
+            if (!st7789_gif_read_color_table(s, st7789_gif_lct, lct_count)) return -1;
+            st7789_gif_build_palette(st7789_gif_lct, lct_count);
+        } else {
+            st7789_gif_build_palette(st7789_gif_gct, gct_count);
+        }
+        if (!st7789_gif_decoder_begin(d, s, left, top, w, h, interlaced, gce)) return -1;
+        /* 图形控制扩展只作用于紧随其后的一个图像块 */
+        memset(gce, 0, sizeof(*gce));
+        return 1;
+    }
+    return 0;
+}
+
+/* 把 (x, y, w, h) 裁剪到屏幕范围内，转换为闭区间矩形 */
+static bool st7789_gif_clip(uint32_t x, uint32_t y, uint32_t w, uint32_t h, ST7789_DirtyRect* out)
+{
+    if (w == 0u || h == 0u || x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return false;
+    uint32_t x1 = x + w - 1u;
+    uint32_t y1 = y + h - 1u;
+    if (x1 >= ST7789_WIDTH) x1 = ST7789_WIDTH - 1u;
+    if (y1 >= ST7789_HEIGHT) y1 = ST7789_HEIGHT - 1u;
+    out->x0 = (uint16_t)x;
+    out->y0 = (uint16_t)y;
+    out->x1 = (uint16_t)x1;
+    out->y1 = (uint16_t)y1;
+    return true;
+}
+
+bool ST7789_GIF_GetCanvasSize(const uint8_t* gif, size_t gif_len, uint16_t* out_w, uint16_t* out_h)
+{
+    if (!st7789_gif_has_signature(gif, gif_len)) return false;
+    st7789_gif_stream_t s = {0};
+    s.data = gif;
+    s.len = gif_len;
+    s.pos = 6;
+    uint16_t w = 0, h = 0;
+    if (!st7789_gif_read_u16le(&s, &w)) return false;
+    if (!st7789_gif_read_u16le(&s, &h)) return false;
+    if (out_w) *out_w = w;
+    if (out_h) *out_h = h;
+    return true;
+}
+
+bool ST7789_GIF_RenderFirstFrame(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888)
+{
+    if (!lcd || !lcd->inited) return false;
+    /* 与播放器共用 LZW 表和调色板 */
+    ST7789_GIF_Stop();
+    st7789_gif_stream_t s = {0};
+    uint16_t gct_count = 0;
+    if (!st7789_gif_open(&s, gif, gif_len, NULL, NULL, &gct_count)) return false;
+    st7789_gif_gce_t gce = {0};
+    st7789_gif_decoder_t d;
+    if (st7789_gif_next_image(&s, gct_count, &gce, &d) != 1) return false;
+    ST7789_DirtyRect r;
+    if (st7789_gif_clip((uint32_t)x + d.left, (uint32_t)y + d.top, d.w, d.h, &r)) {
+        ST7789_FillRect(lcd, r.x0, r.y0, (uint16_t)(r.x1 - r.x0 + 1u), (uint16_t)(r.y1 - r.y0 + 1u), bg_rgb888);
+    }
+    if (st7789_gif_decode_rows(lcd, x, y, &d, d.h) != 1) return false;
+    if (lcd->framebuffer_enabled) {
+        ST7789_Invalidate(lcd, (uint16_t)(x + d.left), (uint16_t)(y + d.top), d.w, d.h);
+    }
+    return true;
+}
+
+typedef enum
+{
+    ST7789_GIF_PHASE_SEEK = 0,      /* 定位下一个图像块 */
+    ST7789_GIF_PHASE_DECODE,        /* 分片解码 */
+    ST7789_GIF_PHASE_READY,         /* 已解码完成，等待显示时间 */
+    ST7789_GIF_PHASE_CACHED         /* 整段动画已缓存，到时间直接拷贝 */
+} st7789_gif_phase_t;
+
+typedef struct
+{
+    ST7789_GifState state;
+    st7789_gif_phase_t phase;
+    ST7789_Handle* lcd;
+    uint16_t x;
+    uint16_t y;
+    uint16_t canvas_w;              /* 已裁剪到屏幕范围 */
+    uint16_t canvas_h;
+    uint16_t bg;                    /* 帧缓冲字节序 */
+    bool canvas_cleared;
+    uint16_t repeat;
+    uint16_t loops_done;
+    uint16_t loop_frames;           /* 当前这一轮已解码的帧数 */
+    st7789_gif_stream_t s;
+    size_t frames_pos;              /* 第一个块的偏移，每轮从这里重新开始 */
+    uint16_t gct_count;
+    st7789_gif_gce_t gce;
+    st7789_gif_decoder_t dec;
+    uint8_t disposal;               /* 上一帧的处置方式，解码下一帧前执行 */
+    ST7789_DirtyRect disposal_rect;
+    bool disposal_valid;
+    ST7789_DirtyRegion changed;     /* 上次显示以来帧缓冲中被改写的区域 */
+    bool shown_any;
+    uint32_t deadline_ms;           /* 下一帧最早的显示时间 */
+    uint16_t cache_capacity;
+    uint16_t cache_frames;
+    uint16_t cache_index;
+    bool cache_failed;
+    uint16_t cache_delay_ms[ST7789_GIF_CACHE_MAX_FRAMES];
+} st7789_gif_player_t;
+
+static st7789_gif_player_t st7789_gif_player;
+#if ST7789_GIF_CACHE_BYTES > 0
+/* 位于 AXI SRAM（.bss），按画布大小依次存放完整合成后的帧，帧缓冲字节序 */
+static uint16_t st7789_gif_cache[ST7789_GIF_CACHE_BYTES / 2u] __attribute__((aligned(32)));
+#endif
+
+static bool st7789_gif_tick_reached(uint32_t now, uint32_t due)
+{
+    return (int32_t)(now - due) >= 0;
+}
+
+static void st7789_gif_fill(st7789_gif_player_t* p, const ST7789_DirtyRect* r)
+{
+    ST7789_Dirty_AddRect(&p->changed, r->x0, r->y0, r->x1, r->y1);
+    uint16_t w = (uint16_t)(r->x1 - r->x0 + 1u);
+    uint16_t h = (uint16_t)(r->y1 - r->y0 + 1u);
+    if (ST7789_DMA2D_Fill(&p->lcd->fb_back[st7789_fb_index(r->x0, r->y0)], ST7789_WIDTH, w, h, p->bg)) return;
+    st7789_fb_sync(p->lcd, r->y0, r->y1);
+    for (uint16_t yy = r->y0; yy <= r->y1; yy++) {
+        uint16_t* dst = &p->lcd->fb_back[st7789_fb_index(r->x0, yy)];
+        for (uint16_t xx = r->x0; xx <= r->x1; xx++) *dst++ = p->bg;
+    }
+}
+
+/* 把本帧改写的区域交给屏幕脏区并立即刷新，刷新启动失败时留给下一次 ST7789_FrameEnd */
+static void st7789_gif_present(st7789_gif_player_t* p, uint32_t now, uint16_t delay_ms)
+{
+    for (uint8_t i = 0; i < p->changed.count; i++) {
+        const ST7789_DirtyRect* r = &p->changed.rects[i];
+        ST7789_Dirty_AddRect(&p->lcd->dirty, r->x0, r->y0, r->x1, r->y1);
+    }
+    ST7789_Dirty_Clear(&p->changed);
+    if (st7789_flush_dirty(p->lcd)) ST7789_Dirty_Clear(&p->lcd->dirty);
+    p->deadline_ms = now + delay_ms;
+    p->shown_any = true;
+}
+
+static uint16_t* st7789_gif_cache_frame(const st7789_gif_player_t* p, uint16_t index)
+{
+#if ST7789_GIF_CACHE_BYTES > 0
+    return &st7789_gif_cache[(uint32_t)index * p->canvas_w * p->canvas_h];
+#else
+    (void)p; (void)index;
+    return NULL;
+#endif
+}
+
+static void st7789_gif_cache_store(st7789_gif_player_t* p)
+{
+    if (p->loops_done != 0u || p->cache_failed) return;
+    if (p->cache_frames >= p->cache_capacity) {
+        /* 放不下整段动画，之后每轮都重新解码 */
+        p->cache_failed = true;
+        return;
+    }
+    uint16_t* dst = st7789_gif_cache_frame(p, p->cache_frames);
+    p->cache_delay_ms[p->cache_frames++] = p->dec.delay_ms;
+    const uint16_t* src = &p->lcd->fb_back[st7789_fb_index(p->x, p->y)];
+    if (ST7789_DMA2D_Copy(dst, p->canvas_w, src, ST7789_WIDTH * 2u, p->canvas_w, p->canvas_h, ST7789_BITMAP_RGB565_BE)) return;
+    ST7789_DMA2D_Sync(dst, (uint32_t)p->canvas_w * p->canvas_h * 2u);
+    st7789_fb_sync(p->lcd, p->y, (uint16_t)(p->y + p->canvas_h - 1u));
+    for (uint16_t row = 0; row < p->canvas_h; row++) {
+        memcpy(dst, &p->lcd->fb_back[st7789_fb_index(p->x, (uint16_t)(p->y + row))], (size_t)p->canvas_w * 2u);
+        dst += p->canvas_w;
+    }
+}
+
+static void st7789_gif_cache_blit(st7789_gif_player_t* p, uint16_t index)
+{
+    const uint16_t* src = st7789_gif_cache_frame(p, index);
+    ST7789_Dirty_AddRect(&p->changed, p->x, p->y, (uint16_t)(p->x + p->canvas_w - 1u), (uint16_t)(p->y + p->canvas_h - 1u));
+    uint16_t* dst = &p->lcd->fb_back[st7789_fb_index(p->x, p->y)];
+    if (ST7789_DMA2D_Copy(dst, ST7789_WIDTH, src, (uint32_t)p->canvas_w * 2u, p->canvas_w, p->canvas_h, ST7789_BITMAP_RGB565_BE)) return;
+    ST7789_DMA2D_Sync(src, (uint32_t)p->canvas_w * p->canvas_h * 2u);
+    st7789_fb_sync(p->lcd, p->y, (uint16_t)(p->y + p->canvas_h - 1u));
+    for (uint16_t row = 0; row < p->canvas_h; row++) {
+        memcpy(&p->lcd->fb_back[st7789_fb_index(p->x, (uint16_t)(p->y + row))], src, (size_t)p->canvas_w * 2u);
+        src += p->canvas_w;
+    }
+}
+
+/* 一轮播放结束，返回 false 表示播放结束 */
+static bool st7789_gif_end_loop(st7789_gif_player_t* p)
+{
+    p->loops_done++;
+    if (p->repeat != ST7789_GIF_REPEAT_FOREVER && p->loops_done >= p->repeat) {
+        p->state = ST7789_GIF_DONE;
+        return false;
+    }
+    return true;
+}
+
+static void st7789_gif_seek(st7789_gif_player_t* p)
+{
+    int r = st7789_gif_next_image(&p->s, p->gct_count, &p->gce, &p->dec);
+    if (r == 0) {
+        bool first_loop = (p->loops_done == 0u);
+        if (first_loop && p->loop_frames <= 1u) {
+            /* 静态图只需显示一次 */
+            p->state = (p->loop_frames == 1u) ? ST7789_GIF_DONE : ST7789_GIF_ERROR;
+            return;
+        }
+        if (!st7789_gif_end_loop(p)) return;
+        if (first_loop && !p->cache_failed && p->cache_frames > 1u) {
+            p->phase = ST7789_GIF_PHASE_CACHED;
+            p->cache_index = 0;
+            return;
+        }
+        p->s.pos = p->frames_pos;
+        p->loop_frames = 0;
+        memset(&p->gce, 0, sizeof(p->gce));
+        r = st7789_gif_next_image(&p->s, p->gct_count, &p->gce, &p->dec);
+        if (r == 0) r = -1;
+    }
+    if (r < 0) {
+        p->state = ST7789_GIF_ERROR;
+        return;
+    }
+
+    /* 处置方式 2：下一帧绘制前把上一帧区域恢复为背景色 */
+    if (p->disposal == 2u && p->disposal_valid) st7789_gif_fill(p, &p->disposal_rect);
+    p->disposal_valid = st7789_gif_clip((uint32_t)p->x + p->dec.left, (uint32_t)p->y + p->dec.top, p->dec.w, p->dec.h, &p->disposal_rect);
+    p->disposal = p->dec.disposal;
+    p->loop_frames++;
+    if (p->disposal_valid) {
+        ST7789_Dirty_AddRect(&p->changed, p->disposal_rect.x0, p->disposal_rect.y0, p->disposal_rect.x1, p->disposal_rect.y1);
+    }
+    p->phase = ST7789_GIF_PHASE_DECODE;
+}
+
+bool ST7789_GIF_Start(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888, uint16_t repeat)
+{
+    ST7789_GIF_Stop();
+    if (!lcd || !lcd->inited || !lcd->framebuffer_enabled || !lcd->fb_back) return false;
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return false;
+    st7789_gif_player_t* p = &st7789_gif_player;
+    memset(p, 0, sizeof(*p));
+    uint16_t canvas_w = 0, canvas_h = 0;
+    if (!st7789_gif_open(&p->s, gif, gif_len, &canvas_w, &canvas_h, &p->gct_count)) return false;
+    if ((uint32_t)x + canvas_w > ST7789_WIDTH) canvas_w = (uint16_t)(ST7789_WIDTH - x);
+    if ((uint32_t)y + canvas_h > ST7789_HEIGHT) canvas_h = (uint16_t)(ST7789_HEIGHT - y);
+    if (canvas_w == 0u || canvas_h == 0u) return false;
+
+    p->lcd = lcd;
+    p->x = x;
+    p->y = y;
+    p->canvas_w = canvas_w;
+    p->canvas_h = canvas_h;
+    p->bg = st7789_fb_color(st7789_rgb888_to_565(bg_rgb888));
+    p->repeat = (repeat == 0u) ? 1u : repeat;
+    p->frames_pos = p->s.pos;
+    ST7789_Dirty_Clear(&p->changed);
+    uint32_t frame_px = (uint32_t)canvas_w * (uint32_t)canvas_h;
+    uint32_t capacity = (uint32_t)(ST7789_GIF_CACHE_BYTES / 2u) / frame_px;
+    p->cache_capacity = (uint16_t)(capacity > ST7789_GIF_CACHE_MAX_FRAMES ? ST7789_GIF_CACHE_MAX_FRAMES : capacity);
+    p->phase = ST7789_GIF_PHASE_SEEK;
+    p->state = ST7789_GIF_PLAYING;
+    return true;
+}
+
+bool ST7789_GIF_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const uint8_t* gif, size_t gif_len, uint32_t bg_rgb888, uint16_t repeat)
+{
+    return ST7789_GIF_Start(lcd, x, y, gif, gif_len, bg_rgb888, repeat);
+}
+
+void ST7789_GIF_Stop(void)
+{
+    st7789_gif_player.state = ST7789_GIF_IDLE;
+}
+
+ST7789_GifState ST7789_GIF_GetState(void)
+{
+    return st7789_gif_player.state;
+}
+
+ST7789_GifState ST7789_GIF_Service(void)
+{
+    st7789_gif_player_t* p = &st7789_gif_player;
+    if (p->state != ST7789_GIF_PLAYING) return p->state;
+    SPIST7789_Service();
+    /* DMA 正在从帧缓冲发送时不能改写帧缓冲 */
+    if (SPIST7789_IsBusy()) return p->state;
+    uint32_t now = HAL_GetTick();
+
+    if (!p->canvas_cleared) {
+        /* 画布先填充背景色，透明像素保留下层内容 */
+        ST7789_DirtyRect r = {p->x, p->y, (uint16_t)(p->x + p->canvas_w - 1u), (uint16_t)(p->y + p->canvas_h - 1u)};
+        st7789_gif_fill(p, &r);
+        p->canvas_cleared = true;
+    }
+
+    if (p->phase == ST7789_GIF_PHASE_SEEK) {
+        st7789_gif_seek(p);
+        if (p->state != ST7789_GIF_PLAYING) return p->state;
+    }
+
+    if (p->phase == ST7789_GIF_PHASE_DECODE) {
+        int r = st7789_gif_decode_rows(p->lcd, p->x, p->y, &p->dec, ST7789_GIF_DECODE_ROWS_PER_SLICE);
+        if (r < 0) {
+            p->state = ST7789_GIF_ERROR;
+            return p->state;
+        }
+        if (r == 0) return p->state;
+        st7789_gif_cache_store(p);
+        p->phase = ST7789_GIF_PHASE_READY;
+    }
+
+    if (p->phase == ST7789_GIF_PHASE_READY) {
+        if (p->shown_any && !st7789_gif_tick_reached(now, p->deadline_ms)) return p->state;
+        st7789_gif_present(p, now, p->dec.delay_ms);
+        p->phase = ST7789_GIF_PHASE_SEEK;
+        return p->state;
+    }
+
+    if (p->phase == ST7789_GIF_PHASE_CACHED) {
+        if (p->shown_any && !st7789_gif_tick_reached(now, p->deadline_ms)) return p->state;
+        st7789_gif_cache_blit(p, p->cache_index);
+        st7789_gif_present(p, now, p->cache_delay_ms[p->cache_index]);
+        if (++p->cache_index >= p->cache_frames) {
+            p->cache_index = 0;
+            (void)st7789_gif_end_loop(p);
+        }
+    }
+    return p->state;
+}
+
+static const uint8_t* st7789_assets_base = (const uint8_t*)0x905B0000u;
+
+/* HIMG 资源包：64 字节文件头 + 每项 64 字节的索引 + 数据。
+ * 版本 2 的索引按名称哈希（FNV-1a）升序排列，查找用二分；版本 1 为无序索引，只能线性扫描。 */
+#define ST7789_ASSETS_HEADER_SIZE       64u
+#define ST7789_ASSETS_ENTRY_SIZE        64u
+#define ST7789_ASSETS_NAME_LEN          32u
+#define ST7789_ASSETS_VERSION_LINEAR    1u
+#define ST7789_ASSETS_VERSION_HASHED    2u
+/* LZ 编码以像素为单位，回溯窗口与 tools/pack_assets.py 中 LZ_WINDOW 一致 */
+#define ST7789_ASSETS_LZ_WINDOW         4096u
+#define ST7789_ASSETS_LZ_MIN_MATCH      2u
+
+const void* ST7789_Assets_GetBaseAddress(void)
+{
+    return st7789_assets_base;
+}
+
+void ST7789_Assets_SetBaseAddress(const void* base)
+{
+    if (!base) return;
+    st7789_assets_base = (const uint8_t*)base;
+    /* 字形缓存以字形表地址为键，换资源包后必须失效 */
+    ST7789_Font_ResetCache();
+}
+
+static uint16_t st7789_u16le(const uint8_t* p)
+{
+    return (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t st7789_u32le(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool st7789_assets_header_ok(const uint8_t* base, uint16_t* out_version, uint32_t* out_count)
+{
+    if (!base) return false;
+    if (base[0] != 'H' || base[1] != 'I' || base[2] != 'M' || base[3] != 'G') return false;
+    uint16_t ver = st7789_u16le(base + 4);
+    if (ver != ST7789_ASSETS_VERSION_LINEAR && ver != ST7789_ASSETS_VERSION_HASHED) return false;
+    /* 文件头：magic[4] version u16 flags u16 total_size u32 count u32 index_size u32 */
+    uint32_t count = st7789_u32le(base + 12);
+    uint32_t index_size = st7789_u32le(base + 16);
+    if (count > 4096u) return false;
+    if ((index_size & 0x0Fu) != 0u) return false;
+    if (index_size < count * ST7789_ASSETS_ENTRY_SIZE) return false;
+    if (out_version) *out_version = ver;
+    if (out_count) *out_count = count;
+    return true;
+}
+
+static uint32_t st7789_assets_name_hash(const char* name)
+{
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < ST7789_ASSETS_NAME_LEN && name[i] != '\0'; i++) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool st7789_assets_name_equal(const uint8_t* e, const char* name)
+{
+    char nbuf[ST7789_ASSETS_NAME_LEN + 1u];
+    memcpy(nbuf, e, ST7789_ASSETS_NAME_LEN);
+    nbuf[ST7789_ASSETS_NAME_LEN] = '\0';
+    for (uint32_t j = 0; j < ST7789_ASSETS_NAME_LEN; j++) {
+        if (nbuf[j] == '\0') break;
+        if ((unsigned char)nbuf[j] < 0x20u) { nbuf[j] = '\0'; break; }
+    }
+    return strncmp(nbuf, name, ST7789_ASSETS_NAME_LEN) == 0;
+}
+
+static void st7789_assets_fill_info(const uint8_t* base, const uint8_t* e, uint16_t version, ST7789_AssetInfo* out)
+{
+    out->type = (ST7789_AssetType)e[32];
+    out->codec = (out->type == ST7789_ASSET_TYPE_RGB565LE_PACKED) ? (ST7789_AssetCodec)e[33] : ST7789_ASSET_CODEC_NONE;
+    out->data = base + st7789_u32le(e + 36);
+    out->size = st7789_u32le(e + 40);
+    out->width = st7789_u16le(e + 44);
+    out->height = st7789_u16le(e + 46);
+    out->raw_size = (version >= ST7789_ASSETS_VERSION_HASHED) ? st7789_u32le(e + 56) : out->size;
+}
+
+bool ST7789_Assets_Find(const char* name, ST7789_AssetInfo* out)
+{
+    if (!name || !out) return false;
+    const uint8_t* base = st7789_assets_base;
+    uint16_t version = 0;
+    uint32_t count = 0;
+    if (!st7789_assets_header_ok(base, &version, &count)) return false;
+    const uint8_t* index = base + ST7789_ASSETS_HEADER_SIZE;
+
+    if (version >= ST7789_ASSETS_VERSION_HASHED) {
+        /* 先二分定位第一个哈希不小于目标的条目，再逐个比较同哈希的名称 */
+        uint32_t hash = st7789_assets_name_hash(name);
+        uint32_t lo = 0, hi = count;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) >> 1;
+            if (st7789_u32le(index + mid * ST7789_ASSETS_ENTRY_SIZE + 52u) < hash) lo = mid + 1u;
+            else hi = mid;
+        }
+        for (uint32_t i = lo; i < count; i++) {
+            const uint8_t* e = index + i * ST7789_ASSETS_ENTRY_SIZE;
+            if (st7789_u32le(e + 52u) != hash) break;
+            if (!st7789_assets_name_equal(e, name)) continue;
+            st7789_assets_fill_info(base, e, version, out);
+            return true;
+        }
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* e = index + i * ST7789_ASSETS_ENTRY_SIZE;
+        if (!st7789_assets_name_equal(e, name)) continue;
+        st7789_assets_fill_info(base, e, version, out);
+        return true;
+    }
+    return false;
+}
+
+/* 解压输出：按行攒像素，整行写入屏幕；同时保存在 LZ 回溯窗口中 */
+typedef struct
+{
+    ST7789_Handle* lcd;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t vis_w;
+    uint32_t total;
+    uint32_t n;
+    uint16_t col;
+    uint16_t row;
+    bool dma2d;         /* 整张图达到 ST7789_DMA2D_MIN_PIXELS 时逐行交给 DMA2D */
+} st7789_assets_sink_t;
+
+/* 行缓冲两块轮换：提交 DMA2D 后立即换块，CPU 解压下一行时不会写到正在被读取的那块 */
+static uint16_t st7789_assets_rows[2][ST7789_WIDTH] __attribute__((aligned(32)));
+static uint8_t st7789_assets_row_sel = 0;
+static uint16_t* st7789_assets_row = st7789_assets_rows[0];
+static uint16_t st7789_assets_window[ST7789_ASSETS_LZ_WINDOW];
+
+static void st7789_assets_flush_row(st7789_assets_sink_t* k)
+{
+    uint16_t sy = (uint16_t)(k->y + k->row);
+    if (sy >= ST7789_HEIGHT || k->vis_w == 0u) return;
+    ST7789_Handle* lcd = k->lcd;
+    if (!lcd->framebuffer_enabled) {
+        ST7789_DrawBitmap(lcd, k->x, sy, k->vis_w, 1u, st7789_assets_row, ST7789_BITMAP_RGB565_LE, 0u);
+        return;
+    }
+    uint16_t* dst = &lcd->fb_back[st7789_fb_index(k->x, sy)];
+    if (k->dma2d && ST7789_DMA2D_Copy(dst, ST7789_WIDTH, st7789_assets_row, (uint32_t)k->vis_w * 2u, k->vis_w, 1u, ST7789_BITMAP_RGB565_LE)) {
+        ST7789_Dirty_AddRect(&lcd->dirty, k->x, sy, (uint16_t)(k->x + k->vis_w - 1u), sy);
+        st7789_assets_row_sel ^= 1u;
+        st7789_assets_row = st7789_assets_rows[st7789_assets_row_sel];
+        return;
+    }
+    st7789_fb_sync(lcd, sy, sy);
+    uint16_t cx0 = k->vis_w, cx1 = 0;
+    for (uint16_t i = 0; i < k->vis_w; i++) {
+        uint16_t c = st7789_fb_color(st7789_assets_row[i]);
+        if (dst[i] == c) continue;
+        dst[i] = c;
+        if (i < cx0) cx0 = i;
+        cx1 = i;
+    }
+    if (cx0 <= cx1) ST7789_Dirty_AddRect(&lcd->dirty, (uint16_t)(k->x + cx0), sy, (uint16_t)(k->x + cx1), sy);
+}
+
+static inline void st7789_assets_put(st7789_assets_sink_t* k, uint16_t px)
+{
+    st7789_assets_window[k->n & (ST7789_ASSETS_LZ_WINDOW - 1u)] = px;
+    k->n++;
+    if (k->col < k->vis_w) st7789_assets_row[k->col] = px;
+    if (++k->col == k->w) {
+        st7789_assets_flush_row(k);
+        k->col = 0;
+        k->row++;
+    }
+}
+
+/* RLE：控制字节最高位为 1 时，后跟 1 个像素重复 (c & 0x7F) + 1 次；否则后跟 c + 1 个原样像素 */
+static bool st7789_assets_unpack_rle(st7789_assets_sink_t* k, const uint8_t* p, const uint8_t* end)
+{
+    while (k->n < k->total) {
+        if (p >= end) return false;
+        uint8_t c = *p++;
+        uint32_t cnt = (uint32_t)(c & 0x7Fu) + 1u;
+        if (k->n + cnt > k->total) return false;
+        if (c & 0x80u) {
+            if (end - p < 2) return false;
+            uint16_t px = st7789_u16le(p);
+            p += 2;
+            while (cnt--) st7789_assets_put(k, px);
+        } else {
+            if ((uint32_t)(end - p) < cnt * 2u) return false;
+            while (cnt--) {
+                st7789_assets_put(k, st7789_u16le(p));
+                p += 2;
+            }
+        }
+    }
+    return true;
+}
+
+static bool st7789_assets_lz_length(const uint8_t** pp, const uint8_t* end, uint32_t* len)
+{
+    const uint8_t* p = *pp;
+    uint8_t b;
+    do {
+        if (p >= end) return false;
+        b = *p++;
+        *len += b;
+    } while (b == 255u);
+    *pp = p;
+    return true;
+}
+
+/* LZ：与 LZ4 块格式相同的令牌结构，长度和偏移以像素为单位。
+ * 令牌高 4 位为原样像素数，低 4 位为匹配长度 - 2，取 15 时后跟 255 累加的扩展字节；偏移为 16 位小端 */
+static bool st7789_assets_unpack_lz(st7789_assets_sink_t* k, const uint8_t* p, const uint8_t* end)
+{
+    while (k->n < k->total) {
+        if (p >= end) return false;
+        uint8_t token = *p++;
+        uint32_t lit = token >> 4;
+        if (lit == 15u && !st7789_assets_lz_length(&p, end, &lit)) return false;
+        if (k->n + lit > k->total) return false;
+        if ((uint32_t)(end - p) < lit * 2u) return false;
+        while (lit--) {
+            st7789_assets_put(k, st7789_u16le(p));
+            p += 2;
+        }
+        if (k->n >= k->total) break;
+
+        if (end - p < 2) return false;
+        uint32_t off = st7789_u16le(p);
+        p += 2;
+        uint32_t mlen = token & 0x0Fu;
+        if (mlen == 15u && !st7789_assets_lz_length(&p, end, &mlen)) return false;
+        mlen += ST7789_ASSETS_LZ_MIN_MATCH;
+        if (off == 0u || off > k->n || off > ST7789_ASSETS_LZ_WINDOW) return false;
+        if (k->n + mlen > k->total) return false;
+        while (mlen--) {
+            st7789_assets_put(k, st7789_assets_window[(k->n - off) & (ST7789_ASSETS_LZ_WINDOW - 1u)]);
+        }
+    }
+    return true;
+}
+
+static bool st7789_assets_draw_packed(ST7789_Handle* lcd, uint16_t x, uint16_t y, const ST7789_AssetInfo* info)
+{
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return false;
+    if (info->width == 0u || info->height == 0u) return false;
+    st7789_assets_sink_t k;
+    memset(&k, 0, sizeof(k));
+    k.lcd = lcd;
+    k.x = x;
+    k.y = y;
+    k.w = info->width;
+    k.vis_w = ((uint32_t)x + info->width > ST7789_WIDTH) ? (uint16_t)(ST7789_WIDTH - x) : info->width;
+    k.total = (uint32_t)info->width * (uint32_t)info->height;
+    k.dma2d = lcd->framebuffer_enabled && (uint32_t)k.vis_w * info->height >= ST7789_DMA2D_MIN_PIXELS;
+    if (info->raw_size != k.total * 2u) return false;
+    const uint8_t* p = (const uint8_t*)info->data;
+    const uint8_t* end = p + info->size;
+    if (info->codec == ST7789_ASSET_CODEC_RLE) return st7789_assets_unpack_rle(&k, p, end);
+    if (info->codec == ST7789_ASSET_CODEC_LZ) return st7789_assets_unpack_lz(&k, p, end);
+    return false;
+}
+
+bool ST7789_Assets_DrawInfo(ST7789_Handle* lcd, uint16_t x, uint16_t y, const ST7789_AssetInfo* info, uint32_t bg_rgb888)
+{
+    if (!lcd || !lcd->inited || !info || !info->data) return false;
+    if (info->type == ST7789_ASSET_TYPE_GIF) return ST7789_GIF_RenderFirstFrame(lcd, x, y, (const uint8_t*)info->data, (size_t)info->size, bg_rgb888);
+    if (info->type == ST7789_ASSET_TYPE_RGB565LE) {
+        ST7789_DrawBitmap(lcd, x, y, info->width, info->height, info->data, ST7789_BITMAP_RGB565_LE, (uint32_t)info->width * 2u);
+        return true;
+    }
+    if (info->type == ST7789_ASSET_TYPE_RGB565LE_PACKED) return st7789_assets_draw_packed(lcd, x, y, info);
+    return false;
+}
+
+bool ST7789_Assets_Draw(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888)
+{
+    if (!lcd || !lcd->inited) return false;
+    ST7789_AssetInfo info = {0};
+    if (!ST7789_Assets_Find(name, &info)) return false;
+    return ST7789_Assets_DrawInfo(lcd, x, y, &info, bg_rgb888);
+}
+
+bool ST7789_Assets_Play(ST7789_Handle* lcd, uint16_t x, uint16_t y, const char* name, uint32_t bg_rgb888, uint16_t repeat)
+{
+    if (!lcd || !lcd->inited) return false;
+    ST7789_AssetInfo info = {0};
+    if (!ST7789_Assets_Find(name, &info)) return false;
+    if (info.type == ST7789_ASSET_TYPE_GIF) return ST7789_GIF_Play(lcd, x, y, (const uint8_t*)info.data, (size_t)info.size, bg_rgb888, repeat);
+    return ST7789_Assets_DrawInfo(lcd, x, y, &info, bg_rgb888);
+}
+
+/* 字体资源（ST7789_ASSET_TYPE_FONT），由 tools/pack_assets.py 从 TTF/OTF 光栅化：
+ *   16 字节文件头：魔数 "HFN1"、行高 u16、基线 u16、字形数 u32、位图区偏移 u32
+ *   字形表：每项 16 字节，按码点升序：码点 u32、位图偏移 u32、宽、高、左偏移、上偏移、步进、保留 3 字节
+ *   位图：4 bpp 灰度，每行 (宽 + 1) / 2 字节，高半字节在左
+ * 打包时字形已裁剪到 [0, 步进) x [0, 行高) 的字符格内，相邻字符格互不重叠，可以逐格整行写入。 */
+#define ST7789_FONT_MAGIC               0x314E4648u     /* "HFN1" */
+#define ST7789_FONT_HEADER_SIZE         16u
+#define ST7789_FONT_GLYPH_SIZE          16u
+#define ST7789_FONT_FALLBACK_CP         0x3Fu           /* 缺字时显示 '?' */
+
+bool ST7789_Font_Load(const ST7789_AssetInfo* info, ST7789_Font* out)
+{
+    if (!info || !out || !info->data) return false;
+    if (info->type != ST7789_ASSET_TYPE_FONT || info->size < ST7789_FONT_HEADER_SIZE) return false;
+    const uint8_t* p = (const uint8_t*)info->data;
+    if (st7789_u32le(p) != ST7789_FONT_MAGIC) return false;
+    uint16_t line_height = st7789_u16le(p + 4);
+    uint16_t baseline = st7789_u16le(p + 6);
+    uint32_t count = st7789_u32le(p + 8);
+    uint32_t bitmap_offset = st7789_u32le(p + 12);
+    if (line_height == 0u || line_height > ST7789_HEIGHT || count == 0u) return false;
+    if (count > (info->size - ST7789_FONT_HEADER_SIZE) / ST7789_FONT_GLYPH_SIZE) return false;
+    if (bitmap_offset < ST7789_FONT_HEADER_SIZE + count * ST7789_FONT_GLYPH_SIZE || bitmap_offset > info->size) return false;
+    out->glyphs = p + ST7789_FONT_HEADER_SIZE;
+    out->bitmaps = p + bitmap_offset;
+    out->glyph_count = count;
+    out->bitmap_size = info->size - bitmap_offset;
+    out->line_height = line_height;
+    out->baseline = baseline;
+    return true;
+}
+
+bool ST7789_Font_Find(const char* name, ST7789_Font* out)
+{
+    ST7789_AssetInfo info = {0};
+    if (!ST7789_Assets_Find(name, &info)) return false;
+    return ST7789_Font_Load(&info, out);
+}
+
+/* 解码一个 UTF-8 字符，非法序列返回 U+FFFD 并前进 1 字节 */
+static uint32_t st7789_utf8_next(const char** ps)
+{
+    const uint8_t* s = (const uint8_t*)*ps;
+    uint32_t c = s[0];
+    uint32_t n = 0;
+    if (c < 0x80u) { *ps += 1; return c; }
+    if ((c & 0xE0u) == 0xC0u) { c &= 0x1Fu; n = 1; }
+    else if ((c & 0xF0u) == 0xE0u) { c &= 0x0Fu; n = 2; }
+    else if ((c & 0xF8u) == 0xF0u) { c &= 0x07u; n = 3; }
+    else { *ps += 1; return 0xFFFDu; }
+    for (uint32_t i = 1; i <= n; i++) {
+        if ((s[i] & 0xC0u) != 0x80u) { *ps += 1; return 0xFFFDu; }
+        c = (c << 6) | (s[i] & 0x3Fu);
+    }
+    *ps += n + 1u;
+    return c;
+}
+
+static const uint8_t* st7789_font_lookup(const ST7789_Font* font, uint32_t cp)
+{
+    /* 字形表通常从空格开始连续排列 ASCII，先试直接索引 */
+    if (cp >= 0x20u && cp - 0x20u < font->glyph_count) {
+        const uint8_t* g = font->glyphs + (cp - 0x20u) * ST7789_FONT_GLYPH_SIZE;
+        if (st7789_u32le(g) == cp) return g;
+    }
+    uint32_t lo = 0, hi = font->glyph_count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) >> 1;
+        const uint8_t* g = font->glyphs + mid * ST7789_FONT_GLYPH_SIZE;
+        uint32_t v = st7789_u32le(g);
+        if (v == cp) return g;
+        if (v < cp) lo = mid + 1u;
+        else hi = mid;
+    }
+    return NULL;
+}
+
+static const uint8_t* st7789_font_glyph(const ST7789_Font* font, uint32_t cp)
+{
+    const uint8_t* g = st7789_font_lookup(font, cp);
+    if (!g) g = st7789_font_lookup(font, ST7789_FONT_FALLBACK_CP);
+    return g;
+}
+
+/* 字形位图越界或超出字符格时按空白处理，损坏的资源包不会读写越界 */
+static bool st7789_font_glyph_ok(const ST7789_Font* font, const uint8_t* g)
+{
+    uint8_t w = g[8], h = g[9], xoff = g[10], yoff = g[11], adv = g[12];
+    if (w == 0u || h == 0u) return false;
+    if ((uint32_t)xoff + w > adv || (uint32_t)yoff + h > font->line_height) return false;
+    uint32_t off = st7789_u32le(g + 4);
+    uint32_t bytes = (uint32_t)((w + 1u) >> 1) * h;
+    return off <= font->bitmap_size && bytes <= font->bitmap_size - off;
+}
+
+/* 字形缓存：按 (字形表项地址, 前景色, 背景色) 保存与背景预混合好的帧缓冲字节序像素，
+ * 命中时每行只需一次拷贝。缓存满时整体清空，只在一次绘制开始前清，同一行文字引用的缓存像素始终有效 */
+typedef struct
+{
+    const uint8_t* glyph;
+    uint16_t fg;
+    uint16_t bg;
+    uint32_t offset;        /* 在 st7789_font_cache_px 中的像素偏移 */
+} st7789_font_slot_t;
+
+typedef struct
+{
+    const uint8_t* glyph;
+    const uint16_t* px;     /* 缓存中的预混合像素，为空时按位图现场混合 */
+} st7789_font_run_t;
+
+static st7789_font_slot_t st7789_font_slots[ST7789_FONT_CACHE_SLOTS];
+static uint16_t st7789_font_cache_px[ST7789_FONT_CACHE_BYTES / 2u];
+static uint32_t st7789_font_slot_used = 0;
+static uint32_t st7789_font_px_used = 0;
+static uint16_t st7789_font_ramp[16];
+static uint16_t st7789_font_ramp_fg = 0;
+static uint16_t st7789_font_ramp_bg = 0;
+static bool st7789_font_ramp_valid = false;
+static st7789_font_run_t st7789_font_runs[ST7789_FONT_MAX_LINE_GLYPHS];
+static uint16_t st7789_font_row[ST7789_WIDTH];
+
+void ST7789_Font_ResetCache(void)
+{
+    memset(st7789_font_slots, 0, sizeof(st7789_font_slots));
+    st7789_font_slot_used = 0;
+    st7789_font_px_used = 0;
+}
+
+/* 16 级灰度到颜色的渐变表，按 RGB565 分量插值，结果为帧缓冲字节序 */
+static void st7789_font_set_colors(uint16_t fg, uint16_t bg)
+{
+    if (st7789_font_ramp_valid && fg == st7789_font_ramp_fg && bg == st7789_font_ramp_bg) return;
+    int32_t fr = fg >> 11, fgg = (fg >> 5) & 0x3F, fb = fg & 0x1F;
+    int32_t br = bg >> 11, bgg = (bg >> 5) & 0x3F, bb = bg & 0x1F;
+    for (int32_t a = 0; a < 16; a++) {
+        uint16_t r = (uint16_t)(br + ((fr - br) * a + 7) / 15);
+        uint16_t g = (uint16_t)(bgg + ((fgg - bgg) * a + 7) / 15);
+        uint16_t b = (uint16_t)(bb + ((fb - bb) * a + 7) / 15);
+        st7789_font_ramp[a] = st7789_fb_color((uint16_t)((r << 11) | (g << 5) | b));
+    }
+    st7789_font_ramp_fg = fg;
+    st7789_font_ramp_bg = bg;
+    st7789_font_ramp_valid = true;
+}
+
+static void st7789_font_blend_row(const ST7789_Font* font, const uint8_t* g, uint16_t gy, uint16_t* dst, uint16_t n)
+{
+    const uint8_t* src = font->bitmaps + st7789_u32le(g + 4) + (uint32_t)((g[8] + 1u) >> 1) * gy;
+    for (uint16_t i = 0; i < n; i++) {
+        uint8_t v = src[i >> 1];
+        dst[i] = st7789_font_ramp[(i & 1u) ? (v & 0x0Fu) : (v >> 4)];
+    }
+}
+
+static uint32_t st7789_font_slot_hash(const uint8_t* glyph, uint16_t fg, uint16_t bg)
+{
+    uint32_t h = (uint32_t)(uintptr_t)glyph * 2654435761u;
+    h ^= ((uint32_t)fg << 16 | bg) * 2246822519u;
+    return (h >> 16) & (ST7789_FONT_CACHE_SLOTS - 1u);
+}
+
+static const uint16_t* st7789_font_cache_get(const ST7789_Font* font, const uint8_t* g)
+{
+    uint16_t fg = st7789_font_ramp_fg, bg = st7789_font_ramp_bg;
+    uint32_t i = st7789_font_slot_hash(g, fg, bg);
+    while (st7789_font_slots[i].glyph) {
+        const st7789_font_slot_t* s = &st7789_font_slots[i];
+        if (s->glyph == g && s->fg == fg && s->bg == bg) return &st7789_font_cache_px[s->offset];
+        i = (i + 1u) & (ST7789_FONT_CACHE_SLOTS - 1u);
+    }
+    /* 开放寻址至少保留 1/4 空槽，查找一定能停下 */
+    uint32_t px = (uint32_t)g[8] * g[9];
+    if (st7789_font_slot_used + 1u > ST7789_FONT_CACHE_SLOTS * 3u / 4u) return NULL;
+    if (px > ST7789_FONT_CACHE_BYTES / 2u - st7789_font_px_used) return NULL;
+    uint16_t* dst = &st7789_font_cache_px[st7789_font_px_used];
+    for (uint16_t y = 0; y < g[9]; y++) {
+        st7789_font_blend_row(font, g, y, dst + (uint32_t)y * g[8], g[8]);
+    }
+    st7789_font_slots[i].glyph = g;
+    st7789_font_slots[i].fg = fg;
+    st7789_font_slots[i].bg = bg;
+    st7789_font_slots[i].offset = st7789_font_px_used;
+    st7789_font_slot_used++;
+    st7789_font_px_used += px;
+    return dst;
+}
+
+static inline void st7789_font_fill(uint16_t* dst, uint16_t n, uint16_t c)
+{
+    while (n--) *dst++ = c;
+}
+
+/* 拼出一行文字第 r 行像素，每个字符格依次为：左侧背景、字形、右侧背景 */
+static void st7789_font_compose_row(const ST7789_Font* font, uint16_t run_count, uint16_t r, uint16_t vis_w)
+{
+    const uint16_t bg = st7789_font_ramp[0];
+    uint16_t pos = 0;
+    for (uint16_t k = 0; k < run_count && pos < vis_w; k++) {
+        const st7789_font_run_t* run = &st7789_font_runs[k];
+        const uint8_t* g = run->glyph;
+        uint16_t n = g[12];
+        if (n > vis_w - pos) n = (uint16_t)(vis_w - pos);
+        uint16_t* dst = &st7789_font_row[pos];
+        pos = (uint16_t)(pos + n);
+        if (!st7789_font_glyph_ok(font, g) || r < g[11] || r >= (uint16_t)(g[11] + g[9]) || g[10] >= n) {
+            st7789_font_fill(dst, n, bg);
+            continue;
+        }
+        uint16_t gy = (uint16_t)(r - g[11]);
+        uint16_t m = g[8];
+        if (m > n - g[10]) m = (uint16_t)(n - g[10]);
+        st7789_font_fill(dst, g[10], bg);
+        dst += g[10];
+        if (run->px) memcpy(dst, run->px + (uint32_t)gy * g[8], (size_t)m * 2u);
+        else st7789_font_blend_row(font, g, gy, dst, m);
+        st7789_font_fill(dst + m, (uint16_t)(n - g[10] - m), bg);
+    }
+}
+
+/* 把拼好的一行写入帧缓冲，返回是否有像素变化并扩展变化范围 */
+static bool st7789_font_write_row(ST7789_Handle* lcd, uint16_t x, uint16_t y, uint16_t n, uint16_t* cx0, uint16_t* cx1)
+{
+    if (!lcd->framebuffer_enabled) {
+        ST7789_DrawBitmap(lcd, x, y, n, 1u, st7789_font_row, ST7789_BITMAP_RGB565_BE, 0u);
+        return false;
+    }
+    st7789_fb_sync(lcd, y, y);
+    uint16_t* dst = &lcd->fb_back[st7789_fb_index(x, y)];
+    uint16_t i = 0;
+    while (i < n && dst[i] == st7789_font_row[i]) i++;
+    if (i == n) return false;
+    uint16_t j = n;
+    while (dst[j - 1u] == st7789_font_row[j - 1u]) j--;
+    memcpy(&dst[i], &st7789_font_row[i], (size_t)(j - i) * 2u);
+    if (i < *cx0) *cx0 = i;
+    if (j - 1u > *cx1) *cx1 = (uint16_t)(j - 1u);
+    return true;
+}
+
+static uint16_t st7789_font_draw_line(ST7789_Handle* lcd, const ST7789_Font* font, uint16_t x, uint16_t y, const char** ps)
+{
+    const char* s = *ps;
+    uint16_t run_count = 0;
+    uint32_t width = 0;
+    while (*s && *s != '\n') {
+        uint32_t cp = st7789_utf8_next(&s);
+        if (cp == '\r') continue;
+        const uint8_t* g = st7789_font_glyph(font, cp);
+        if (!g || g[12] == 0u) continue;
+        if (x + width >= ST7789_WIDTH || run_count >= ST7789_FONT_MAX_LINE_GLYPHS) continue;
+        st7789_font_runs[run_count].glyph = g;
+        st7789_font_runs[run_count].px = st7789_font_glyph_ok(font, g) ? st7789_font_cache_get(font, g) : NULL;
+        run_count++;
+        width += g[12];
+    }
+    *ps = s;
+    if (run_count == 0u || x >= ST7789_WIDTH || y >= ST7789_HEIGHT) return 0;
+
+    uint16_t vis_w = (x + width > ST7789_WIDTH) ? (uint16_t)(ST7789_WIDTH - x) : (uint16_t)width;
+    uint16_t rows = font->line_height;
+    if ((uint32_t)y + rows > ST7789_HEIGHT) rows = (uint16_t)(ST7789_HEIGHT - y);
+    /* 整行文字的变化只登记一个矩形 */
+    uint16_t cx0 = vis_w, cx1 = 0, cy0 = rows, cy1 = 0;
+    for (uint16_t r = 0; r < rows; r++) {
+        st7789_font_compose_row(font, run_count, r, vis_w);
+        if (!st7789_font_write_row(lcd, x, (uint16_t)(y + r), vis_w, &cx0, &cx1)) continue;
+        if (r < cy0) cy0 = r;
+        cy1 = r;
+    }
+    if (cx0 <= cx1 && cy0 <= cy1) {
+        ST7789_Dirty_AddRect(&lcd->dirty, (uint16_t)(x + cx0), (uint16_t)(y + cy0), (uint16_t)(x + cx1), (uint16_t)(y + cy1));
+    }
+    return vis_w;
+}
+
+uint16_t ST7789_DrawText(ST7789_Handle* lcd, const ST7789_Font* font, uint16_t x, uint16_t y, const char* utf8, uint32_t fg_rgb888, uint32_t bg_rgb888)
+{
+    if (!lcd || !lcd->inited || !font || !utf8) return 0;
+    st7789_font_set_colors(st7789_rgb888_to_565(fg_rgb888), st7789_rgb888_to_565(bg_rgb888));
+    /* 用量过半时清空，保证本次绘制的新字形有空间缓存 */
+    if (st7789_font_slot_used > ST7789_FONT_CACHE_SLOTS / 2u || st7789_font_px_used > ST7789_FONT_CACHE_BYTES / 4u) {
+        ST7789_Font_ResetCache();
+    }
+    uint16_t max_w = 0;
+    const char* s = utf8;
+    for (;;) {
+        uint16_t w = st7789_font_draw_line(lcd, font, x, y, &s);
+        if (w > max_w) max_w = w;
+        if (*s != '\n') break;
+        s++;
+        y = (uint16_t)(y + font->line_height);
+        if (y >= ST7789_HEIGHT) break;
+    }
+    return max_w;
+}
+
+size_t ST7789_Font_Fit(const ST7789_Font* font, const char* utf8, uint16_t max_w, uint16_t* out_w)
+{
+    uint32_t width = 0;
+    const char* s = utf8;
+    if (font && utf8) {
+        while (*s && *s != '\n') {
+            const char* next = s;
+            uint32_t cp = st7789_utf8_next(&next);
+            const uint8_t* g = (cp == '\r') ? NULL : st7789_font_glyph(font, cp);
+            uint32_t adv = g ? g[12] : 0u;
+            if (width + adv > max_w) break;
+            width += adv;
+            s = next;
+        }
+    }
+    if (out_w) *out_w = (uint16_t)width;
+    return utf8 ? (size_t)(s - utf8) : 0u;
+}
+
+uint16_t ST7789_Font_TextWidth(const ST7789_Font* font, const char* utf8)
+{
+    uint16_t w = 0;
+    ST7789_Font_Fit(font, utf8, 0xFFFFu, &w);
+    return w;
+}
@@ -344,4 +344,6 @@ export const ledAnimations: Record<LedsEffectStyle, LedAnimationAlgorithm> = {
 	[LedsEffectStyle.FLOWING]: flowingAnimation,
 	[LedsEffectStyle.RIPPLE]: rippleAnimation,
 	[LedsEffectStyle.TRANSFORM]: transformAnimation,
+	// 自定义程序在固件里执行，预览按静态效果显示
+	[LedsEffectStyle.CUSTOM]: staticAnimation,
 }; 
\ No newline at end of file
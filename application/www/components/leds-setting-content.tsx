@@ -32,7 +32,7 @@ import {
     AroundLedsEffectStyle,
     GameProfile,
 } from "@/types/gamepad-config";
-import { LuSunDim, LuActivity, LuCheck, LuSparkles, LuWaves, LuTarget, LuCloudSunRain, LuAudioLines } from "react-icons/lu";
+import { LuSunDim, LuActivity, LuCheck, LuSparkles, LuWaves, LuTarget, LuCloudSunRain, LuAudioLines, LuCode } from "react-icons/lu";
 import { TbMeteorFilled } from "react-icons/tb";
 import HitboxLeds from "@/components/hitbox/hitbox-leds";
 import { useGamepadConfig } from "@/contexts/gamepad-config-context";
@@ -79,6 +79,7 @@ export function LEDsSettingContent() {
     const [ledBrightness, setLedBrightness] = useState<number>(defaultProfile.ledsConfigs?.ledBrightness ?? 75);
     const [ledAnimationSpeed, setLedAnimationSpeed] = useState<number>(defaultProfile.ledsConfigs?.ledAnimationSpeed ?? 1);
     const [ledEnabled, setLedEnabled] = useState<boolean>(defaultProfile.ledsConfigs?.ledEnabled ?? true);
+    const [ledReactiveFadeMs, setLedReactiveFadeMs] = useState<number>(defaultProfile.ledsConfigs?.ledReactiveFadeMs ?? 0);
 
     // 环绕灯配置
     const [aroundLedEnabled, setAroundLedEnabled] = useState<boolean>(defaultProfile.ledsConfigs?.aroundLedEnabled ?? false);
@@ -189,6 +190,7 @@ export function LEDsSettingContent() {
         'flowing': <LuWaves />,
         'ripple': <LuTarget />,
         'transform': <LuCloudSunRain />,
+        'custom': <LuCode />,
         'quake': <LuAudioLines />,
         'meteor': <TbMeteorFilled />,
     };
@@ -224,6 +226,11 @@ export function LEDsSettingContent() {
             icon: "transform",
             hasBackColor2: true
         }],
+        [LedsEffectStyle.CUSTOM, {
+            label: t.SETTINGS_LEDS_CUSTOM_LABEL,
+            icon: "custom",
+            hasBackColor2: true
+        }],
     ]);
 
     const aroundLedEffectStyleLabelMap = new Map<AroundLedsEffectStyle, { label: string, icon: string, hasBackColor2: boolean }>([
@@ -267,6 +274,7 @@ export function LEDsSettingContent() {
             ledColors: [color1.toString('hex'), color2.toString('hex'), color3.toString('hex')],
             ledBrightness: ledBrightness,
             ledAnimationSpeed: ledAnimationSpeed,
+            ledReactiveFadeMs: ledReactiveFadeMs,
 
             aroundLedEnabled: aroundLedEnabled,
             aroundLedSyncToMainLed: aroundLedSyncToMainLed,
@@ -300,6 +308,7 @@ export function LEDsSettingContent() {
             ledColors: [color1.toString('hex'), color2.toString('hex'), color3.toString('hex')],
             ledBrightness: ledBrightness,
             ledAnimationSpeed: ledAnimationSpeed,
+            ledReactiveFadeMs: ledReactiveFadeMs,
 
             aroundLedEnabled: aroundLedEnabled,
             aroundLedSyncToMainLed: aroundLedSyncToMainLed,
@@ -334,6 +343,7 @@ export function LEDsSettingContent() {
             setLedBrightness(ledsConfigs.ledBrightness ?? 75);
             setLedAnimationSpeed(ledsConfigs.ledAnimationSpeed ?? 3);
             setLedEnabled(ledsConfigs.ledEnabled ?? true);
+            setLedReactiveFadeMs(ledsConfigs.ledReactiveFadeMs ?? 0);
 
             setAroundLedEnabled(ledsConfigs.aroundLedEnabled ?? false);
             setAroundLedSyncToMainLed(ledsConfigs.aroundLedSyncToMainLed ?? false);
@@ -642,6 +652,51 @@ export function LEDsSettingContent() {
                                                     ]} />
                                                 </Slider.Control>
                                             </Slider.Root>
+
+                                            {/* 按键释放余辉 */}
+                                            <Slider.Root
+                                                size={"sm"}
+                                                min={0}
+                                                max={1000}
+                                                step={50}
+                                                colorPalette={"green"}
+                                                disabled={!ledEnabled}
+                                                value={[ledReactiveFadeMs]}
+                                                onValueChange={(e) => {
+                                                    setLedReactiveFadeMs(e.value[0]);
+                                                }}
+
+                                                onValueChangeEnd={() => {
+                                                    setNeedUpdate(true);
+                                                    setNeedPreview(true);
+                                                }}
+
+                                            >
+                                                <HStack justifyContent={"space-between"}>
+                                                    <Slider.Label color={ledEnabled ? "white" : "gray"}>{t.SETTINGS_LEDS_REACTIVE_FADE_LABEL}</Slider.Label>
+                                                    <Slider.ValueText color={ledEnabled ? "white" : "gray"} />
+                                                </HStack>
+                                                <Slider.Control>
+                                                    <Slider.Track>
+                                                        <Slider.Range />
+                                                    </Slider.Track>
+                                                    <Slider.Thumb index={0}>
+                                                        <Slider.DraggingIndicator
+                                                            layerStyle="fill.solid"
+                                                            top="6"
+                                                            rounded="sm"
+                                                            px="1.5"
+                                                        >
+                                                            <Slider.ValueText />
+                                                        </Slider.DraggingIndicator>
+                                                    </Slider.Thumb>
+                                                    <Slider.Marks marks={[
+                                                        { value: 0, label: "0" },
+                                                        { value: 500, label: "500" },
+                                                        { value: 1000, label: "1000" },
+                                                    ]} />
+                                                </Slider.Control>
+                                            </Slider.Root>
                                         </Grid>
                                     </VStack>
                                     <HStack display={hasAroundLed ? "flex" : "none"}>
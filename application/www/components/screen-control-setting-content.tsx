@@ -40,6 +40,7 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
     const [textColor, setTextColor] = useState<Color>(parseColor(toHex6(screenControl.textColor ?? 0xFFFFFF)));
     const [backgroundImageId, setBackgroundImageId] = useState<string>(screenControl.backgroundImageId ?? '');
     const [currentPageId, setCurrentPageId] = useState<string>(String(screenControl.currentPageId ?? 0));
+    const [tournamentScreenOff, setTournamentScreenOff] = useState<boolean>(screenControl.tournamentScreenOff ?? false);
     const [features, setFeatures] = useState(screenControl.features);
     const [featuresOrder, setFeaturesOrder] = useState<ScreenControlFeatureKey[]>(
         screenControl.featuresOrder ?? DEFAULT_SCREEN_CONTROL_CONFIG.featuresOrder
@@ -102,6 +103,7 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
 
         setBackgroundImageId(screenControl.backgroundImageId ?? '');
         setCurrentPageId(String(screenControl.currentPageId ?? 0));
+        setTournamentScreenOff(screenControl.tournamentScreenOff ?? false);
         setFeatures(screenControl.features);
         setFeaturesOrder(normalizeFeaturesOrder(screenControl.featuresOrder));
     }, [screenControl]);
@@ -195,10 +197,11 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
             textColor: fg,
             backgroundImageId,
             currentPageId: pid,
+            tournamentScreenOff,
             features,
             featuresOrder,
         };
-    }, [brightness, standbyDisplay, bgColor, textColor, backgroundImageId, currentPageId, features, featuresOrder, screenControl.backgroundColor, screenControl.textColor]);
+    }, [brightness, standbyDisplay, bgColor, textColor, backgroundImageId, currentPageId, tournamentScreenOff, features, featuresOrder, screenControl.backgroundColor, screenControl.textColor]);
 
     const push = async () => {
         await updateScreenControl(nextConfig, true);
@@ -696,6 +699,7 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
         screenBrightnessAdjust: t.SETTINGS_SCREEN_CONTROL_FEATURE_SCREEN_BRIGHTNESS_ADJUST,
         webConfigEntry: t.SETTINGS_SCREEN_CONTROL_FEATURE_WEB_CONFIG_ENTRY,
         calibrationModeSwitch: t.SETTINGS_SCREEN_CONTROL_FEATURE_CALIBRATION_MODE_SWITCH,
+        inputMonitor: t.SETTINGS_SCREEN_CONTROL_FEATURE_INPUT_MONITOR,
     };
 
     const orderedFeatureItems = featuresOrder.map((key) => ({ key, label: featureLabelMap[key] }));
@@ -712,6 +716,7 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
         screenBrightnessAdjust: 8,
         webConfigEntry: 9,
         calibrationModeSwitch: 10,
+        inputMonitor: 12,
     };
     const idToFeatureKey = (id: number): ScreenControlFeatureKey | null => {
         const entries = Object.entries(featureKeyToId) as [ScreenControlFeatureKey, number][];
@@ -879,6 +884,18 @@ export function ScreenControlSettingContent(props: ScreenControlSettingContentPr
                         </HStack>
                     </RadioCard.Root>
                 </VStack>
+                <TitleLabel title={t.SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_LABEL} />
+                <HStack gap={3}>
+                    <Switch
+                        checked={tournamentScreenOff}
+                        disabled={disabled}
+                        onCheckedChange={(e: { checked: boolean }) => {
+                            setTournamentScreenOff(e.checked);
+                            void updateScreenControl({ ...nextConfig, tournamentScreenOff: e.checked }, true);
+                        }}
+                    />
+                    <Text fontSize="xs" color="gray.400">{t.SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_TIP}</Text>
+                </HStack>
                 <Text fontSize="xs" color="gray.400" whiteSpace="pre-wrap" >{t.SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGE_LIMIT_TIP.replace('{seconds}', (Math.floor(gifMaxFrames/gifTargetFps)).toString())}</Text>
                
 
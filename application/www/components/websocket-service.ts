@@ -14,6 +14,7 @@ export interface LedsConfig {
   ledColors: string[];
   ledBrightness: number;
   ledAnimationSpeed: number;
+  ledReactiveFadeMs?: number;
   hasAroundLed: boolean;
   aroundLedEnabled: boolean;
   aroundLedSyncToMainLed: boolean;
@@ -267,6 +267,7 @@ const converProfileDetails = (profile: any) => {
             ledColors: profile.ledsConfigs?.ledColors as string[] ?? ["#000000", "#000000", "#000000"],
             ledBrightness: profile.ledsConfigs?.ledBrightness as number ?? 100,
             ledAnimationSpeed: profile.ledsConfigs?.ledAnimationSpeed as number ?? 1,
+            ledReactiveFadeMs: profile.ledsConfigs?.ledReactiveFadeMs as number ?? 0,
             // 环绕灯配置
             hasAroundLed: profile.ledsConfigs?.hasAroundLed as boolean ?? false,
             aroundLedEnabled: profile.ledsConfigs?.aroundLedEnabled as boolean ?? false,
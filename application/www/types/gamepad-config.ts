@@ -97,6 +97,7 @@ export interface ScreenControlFeatures {
     screenBrightnessAdjust: boolean;
     webConfigEntry: boolean;
     calibrationModeSwitch: boolean;
+    inputMonitor: boolean;
 }
 
 export type StandbyDisplay = 'none' | 'backgroundImage' | 'buttonLayout';
@@ -109,6 +110,7 @@ export interface ScreenControlConfig {
     textColor: number;
     backgroundImageId: string;
     currentPageId: number;
+    tournamentScreenOff?: boolean;
     features: ScreenControlFeatures;
     featuresOrder: ScreenControlFeatureKey[];
 }
@@ -120,6 +122,7 @@ export const DEFAULT_SCREEN_CONTROL_CONFIG: ScreenControlConfig = {
     textColor: 0xFFFFFF,
     backgroundImageId: "",
     currentPageId: 0,
+    tournamentScreenOff: false,
     features: {
         inputModeSwitch: true,
         profilesSwitch: true,
@@ -132,6 +135,7 @@ export const DEFAULT_SCREEN_CONTROL_CONFIG: ScreenControlConfig = {
         screenBrightnessAdjust: true,
         webConfigEntry: true,
         calibrationModeSwitch: true,
+        inputMonitor: true,
     },
     featuresOrder: [
         'inputModeSwitch',
@@ -145,6 +149,7 @@ export const DEFAULT_SCREEN_CONTROL_CONFIG: ScreenControlConfig = {
         'screenBrightnessAdjust',
         'webConfigEntry',
         'calibrationModeSwitch',
+        'inputMonitor',
     ],
 };
 
@@ -423,6 +428,7 @@ export interface GameProfile {
         ledColors: string[];
         ledBrightness: number;
         ledAnimationSpeed: number;
+        ledReactiveFadeMs?: number; // 0-1000 ms，0 关闭
 
         // 环绕灯配置
         hasAroundLed?: boolean;
@@ -467,6 +473,7 @@ export enum LedsEffectStyle {
     FLOWING = 3,
     RIPPLE = 4,
     TRANSFORM = 5,
+    CUSTOM = 6,         // 自定义灯效程序，未上传程序时固件按静态效果显示
 }
 
 export enum AroundLedsEffectStyle {
@@ -610,6 +617,7 @@ export const UI_TEXT = {
     SETTINGS_LEDS_EFFECT_LABEL: "LED Effect Style",
     SETTINGS_LEDS_BRIGHTNESS_LABEL: "LED Brightness",
     SETTINGS_LEDS_ANIMATION_SPEED_LABEL: "LED Animation Speed",
+    SETTINGS_LEDS_REACTIVE_FADE_LABEL: "Key Release Afterglow (ms)",
     SETTINGS_LEDS_COLOR_FRONT_LABEL: "Front Color",
     SETTINGS_LEDS_COLOR_BACK1_LABEL: "Back Color 1",
     SETTINGS_LEDS_COLOR_BACK2_LABEL: "Back Color 2",
@@ -772,6 +780,7 @@ export const UI_TEXT = {
     SETTINGS_SCREEN_CONTROL_FEATURE_SCREEN_BRIGHTNESS_ADJUST: "Screen Brightness Adjust",
     SETTINGS_SCREEN_CONTROL_FEATURE_WEB_CONFIG_ENTRY: "Web Config Entry",
     SETTINGS_SCREEN_CONTROL_FEATURE_CALIBRATION_MODE_SWITCH: "Calibration Mode Switch",
+    SETTINGS_SCREEN_CONTROL_FEATURE_INPUT_MONITOR: "Input Monitor",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGES_TITLE: "Background Images",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGE_UPLOAD_BUTTON: "Upload Image",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGE_LIMIT_TIP: "- Choose system preset or upload one user image. Max size 320×172. Larger images will be downscaled.\n- GIF animation images will be automatically cropped to the first {seconds} seconds of the animation, and the frame rate will be reduced to adapt to the screen control performance.",
@@ -783,6 +792,8 @@ export const UI_TEXT = {
     SETTINGS_SCREEN_CONTROL_STANDBY_NONE: "None",
     SETTINGS_SCREEN_CONTROL_STANDBY_BACKGROUND_IMAGE: "Background Image",
     SETTINGS_SCREEN_CONTROL_STANDBY_BUTTON_LAYOUT: "Button Layout",
+    SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_LABEL: "Screen Off During Tournament Play",
+    SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_TIP: "When the active profile is a tournament profile, the screen turns off and stops refreshing once play starts. Turn the knob to wake it.",
     SETTINGS_SCREEN_CONTROL_FIRST_SCREEN_LABEL: "First Screen",
 
     // Firmware Settings
@@ -878,6 +889,7 @@ export const UI_TEXT = {
     SETTINGS_LEDS_FLOWING_LABEL: "Flowing",
     SETTINGS_LEDS_RIPPLE_LABEL: "Ripple",
     SETTINGS_LEDS_TRANSFORM_LABEL: "Transform",
+    SETTINGS_LEDS_CUSTOM_LABEL: "Custom",
     SETTINGS_LEDS_QUAKE_LABEL: "Quake",
     SETTINGS_LEDS_METEOR_LABEL: "Meteor",
     SETTINGS_LEDS_COLORS_LABEL: "LED Colors",
@@ -1011,6 +1023,7 @@ export const UI_TEXT_ZH = {
     SETTINGS_LEDS_EFFECT_LABEL: "LED效果样式",
     SETTINGS_LEDS_BRIGHTNESS_LABEL: "LED亮度",
     SETTINGS_LEDS_ANIMATION_SPEED_LABEL: "LED灯效动画速度",
+    SETTINGS_LEDS_REACTIVE_FADE_LABEL: "按键释放余辉 (ms)",
     SETTINGS_LEDS_COLOR_FRONT_LABEL: "LED前置颜色",
     SETTINGS_LEDS_COLOR_BACK1_LABEL: "LED背景颜色1",
     SETTINGS_LEDS_COLOR_BACK2_LABEL: "LED背景颜色2",
@@ -1172,6 +1185,7 @@ export const UI_TEXT_ZH = {
     SETTINGS_SCREEN_CONTROL_FEATURE_SCREEN_BRIGHTNESS_ADJUST: "屏幕亮度调整",
     SETTINGS_SCREEN_CONTROL_FEATURE_WEB_CONFIG_ENTRY: "进入 WebConfig",
     SETTINGS_SCREEN_CONTROL_FEATURE_CALIBRATION_MODE_SWITCH: "进入/退出校准模式",
+    SETTINGS_SCREEN_CONTROL_FEATURE_INPUT_MONITOR: "按键输入监视",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGES_TITLE: "背景图片",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGE_UPLOAD_BUTTON: "上传图片",
     SETTINGS_SCREEN_CONTROL_BACKGROUND_IMAGE_LIMIT_TIP: "- 可选择系统预设或上传 1 张用户图片。最大尺寸 320×172，超过会自动等比缩小。\n- GIF动画图片会自动截取前{seconds}秒的动画，并适当降低帧率，以适应屏控性能。",
@@ -1183,6 +1197,8 @@ export const UI_TEXT_ZH = {
     SETTINGS_SCREEN_CONTROL_STANDBY_NONE: "无",
     SETTINGS_SCREEN_CONTROL_STANDBY_BACKGROUND_IMAGE: "背景图片",
     SETTINGS_SCREEN_CONTROL_STANDBY_BUTTON_LAYOUT: "按键布局",
+    SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_LABEL: "比赛模式游戏中关闭屏幕",
+    SETTINGS_SCREEN_CONTROL_TOURNAMENT_SCREEN_OFF_TIP: "当前配置文件为比赛配置文件时，开始游戏后屏幕熄灭并停止刷新，转动旋钮即可唤醒。",
     SETTINGS_SCREEN_CONTROL_FIRST_SCREEN_LABEL: "首屏显示",
 
     // 固件更新
@@ -1280,6 +1296,7 @@ export const UI_TEXT_ZH = {
     SETTINGS_LEDS_FLOWING_LABEL: "流光",
     SETTINGS_LEDS_RIPPLE_LABEL: "涟漪",
     SETTINGS_LEDS_TRANSFORM_LABEL: "质变",
+    SETTINGS_LEDS_CUSTOM_LABEL: "自定义",
     SETTINGS_LEDS_QUAKE_LABEL: "震颤",
     SETTINGS_LEDS_METEOR_LABEL: "流星",
     SETTINGS_LEDS_COLORS_LABEL: "LED颜色",
@@ -163,8 +163,11 @@ _Static_assert(sizeof(FirmwareMetadata) == METADATA_STRUCT_SIZE,
 #define SYS_IMAGE_RESOURCES_ADDR    0x905B0000  // 256KB
 #define SYS_IMAGE_RESOURCES_SIZE    0x40000
 
-#define USER_IMAGE_RESOURCES_ADDR   0x905F0000  // 2.0625MB
-#define USER_IMAGE_RESOURCES_SIZE   0x210000
+#define USER_IMAGE_RESOURCES_ADDR   0x905F0000  // 2MB
+#define USER_IMAGE_RESOURCES_SIZE   0x200000
+
+#define LED_PROGRAM_ADDR            0x907F0000  // 64KB
+#define LED_PROGRAM_SIZE            0x10000
 
 #ifdef __cplusplus
 }
@@ -73,7 +73,10 @@ SYS_IMAGE_RESOURCES_ADDR = 0x905B0000
 SYS_IMAGE_RESOURCES_SIZE = 0x40000  # 256KB
 
 USER_IMAGE_RESOURCES_ADDR = 0x905F0000
-USER_IMAGE_RESOURCES_SIZE = 0x210000  # 2.0625MB
+USER_IMAGE_RESOURCES_SIZE = 0x200000  # 2MB
+
+LED_PROGRAM_ADDR = 0x907F0000
+LED_PROGRAM_SIZE = 0x10000  # 64KB
 
 # 组件名称映射
 COMPONENT_NAMES = {
@@ -57,7 +57,7 @@ class BuildTool:
             "sys_assets_addr": "0x905B0000",
             "sys_assets_size": "0x00040000",
             "user_image_addr": "0x905F0000",
-            "user_image_size": "0x00210000",
+            "user_image_size": "0x00200000",
         }
 
         board_cfg = self.application_dir / "Core" / "Inc" / "board_cfg.h"
@@ -531,7 +531,7 @@ class BuildTool:
             print(f"错误: assets 打包脚本不存在: {packer}")
             return None
 
-        max_size = self.shared_addresses.get("user_image_size", "0x00210000")
+        max_size = self.shared_addresses.get("user_image_size", "0x00200000")
         cmd = [
             sys.executable,
             str(packer),
@@ -557,7 +557,7 @@ class BuildTool:
             return False
 
         target_address = self.shared_addresses.get("user_image_addr", "0x905F0000")
-        max_size = int(self.shared_addresses.get("user_image_size", "0x00210000"), 16)
+        max_size = int(self.shared_addresses.get("user_image_size", "0x00200000"), 16)
         file_size = out_file.stat().st_size
         if file_size > max_size:
             print(f"错误: sysbg.bin 超过用户图片区大小: {file_size} > {max_size}")
@@ -0,0 +1,235 @@
+#include "image_writer.hpp"
+#include <string.h>
+
+void HostImage::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t r, uint8_t g, uint8_t b)
+{
+    for (int32_t yy = y; yy < y + h; yy++) {
+        for (int32_t xx = x; xx < x + w; xx++) {
+            setPixel(xx, yy, r, g, b);
+        }
+    }
+}
+
+void HostImage::fillCircle(float cx, float cy, float radius, uint8_t r, uint8_t g, uint8_t b)
+{
+    int32_t x0 = (int32_t)(cx - radius);
+    int32_t x1 = (int32_t)(cx + radius + 1.0f);
+    int32_t y0 = (int32_t)(cy - radius);
+    int32_t y1 = (int32_t)(cy + radius + 1.0f);
+    float r2 = radius * radius;
+    for (int32_t y = y0; y <= y1; y++) {
+        for (int32_t x = x0; x <= x1; x++) {
+            float dx = (float)x + 0.5f - cx;
+            float dy = (float)y + 0.5f - cy;
+            if (dx * dx + dy * dy <= r2) {
+                setPixel(x, y, r, g, b);
+            }
+        }
+    }
+}
+
+/******************************** PNG begin ******************************************/
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len)
+{
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void putU32BE(std::vector<uint8_t>& out, uint32_t v)
+{
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+static void writeChunk(FILE* fp, const char* type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> buf;
+    putU32BE(buf, (uint32_t)data.size());
+    buf.insert(buf.end(), type, type + 4);
+    buf.insert(buf.end(), data.begin(), data.end());
+    uint32_t crc = crc32Update(0, buf.data() + 4, buf.size() - 4);
+    putU32BE(buf, crc);
+    fwrite(buf.data(), 1, buf.size(), fp);
+}
+
+bool writePng(const char* path, const HostImage& image)
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), fp);
+
+    std::vector<uint8_t> ihdr;
+    putU32BE(ihdr, image.width);
+    putU32BE(ihdr, image.height);
+    ihdr.push_back(8);      // bit depth
+    ihdr.push_back(2);      // color type: RGB
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    writeChunk(fp, "IHDR", ihdr);
+
+    // 扫描线：每行前加滤波类型 0
+    std::vector<uint8_t> raw;
+    size_t stride = (size_t)image.width * 3;
+    raw.reserve((stride + 1) * image.height);
+    for (uint32_t y = 0; y < image.height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), image.rgb.begin() + y * stride, image.rgb.begin() + (y + 1) * stride);
+    }
+
+    // zlib 流，deflate 使用 stored 块
+    std::vector<uint8_t> z;
+    z.push_back(0x78);
+    z.push_back(0x01);
+    size_t pos = 0;
+    do {
+        size_t len = raw.size() - pos;
+        if (len > 65535) len = 65535;
+        bool final = (pos + len) == raw.size();
+        z.push_back(final ? 1 : 0);
+        z.push_back((uint8_t)len);
+        z.push_back((uint8_t)(len >> 8));
+        z.push_back((uint8_t)~len);
+        z.push_back((uint8_t)(~len >> 8));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    putU32BE(z, (b << 16) | a);
+    writeChunk(fp, "IDAT", z);
+    writeChunk(fp, "IEND", std::vector<uint8_t>());
+
+    bool ok = ferror(fp) == 0;
+    fclose(fp);
+    return ok;
+}
+
+/******************************** PNG end ******************************************/
+
+/******************************** GIF begin ******************************************/
+
+static inline uint8_t quantize6(uint8_t v)
+{
+    return (uint8_t)((v * 5 + 127) / 255);
+}
+
+bool GifWriter::open(const char* path, uint16_t w, uint16_t h)
+{
+    close();
+    fp = fopen(path, "wb");
+    if (!fp) return false;
+    width = w;
+    height = h;
+
+    fwrite("GIF89a", 1, 6, fp);
+    uint8_t lsd[7] = {(uint8_t)w, (uint8_t)(w >> 8), (uint8_t)h, (uint8_t)(h >> 8), 0xF7, 0, 0};
+    fwrite(lsd, 1, sizeof(lsd), fp);
+
+    // 全局调色板：前 216 项为 6x6x6 色立方，其余为黑色
+    uint8_t palette[256 * 3];
+    memset(palette, 0, sizeof(palette));
+    for (int i = 0; i < 216; i++) {
+        palette[i * 3] = (uint8_t)((i / 36) * 51);
+        palette[i * 3 + 1] = (uint8_t)(((i / 6) % 6) * 51);
+        palette[i * 3 + 2] = (uint8_t)((i % 6) * 51);
+    }
+    fwrite(palette, 1, sizeof(palette), fp);
+
+    // 无限循环
+    static const uint8_t loopExt[19] = {
+        0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00
+    };
+    fwrite(loopExt, 1, sizeof(loopExt), fp);
+    return true;
+}
+
+bool GifWriter::addFrame(const HostImage& image, uint16_t delayCs)
+{
+    if (!fp || image.width != width || image.height != height) return false;
+
+    uint8_t gce[8] = {0x21, 0xF9, 0x04, 0x00, (uint8_t)delayCs, (uint8_t)(delayCs >> 8), 0x00, 0x00};
+    fwrite(gce, 1, sizeof(gce), fp);
+
+    uint8_t desc[10] = {0x2C, 0, 0, 0, 0, (uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height, (uint8_t)(height >> 8), 0};
+    fwrite(desc, 1, sizeof(desc), fp);
+
+    // LZW：最小码长 8，码宽固定 9 位，每 128 个字面量插入一次清码，码表永远不会增长到 10 位
+    const uint8_t minCodeSize = 8;
+    const uint16_t clearCode = 256;
+    const uint16_t endCode = 257;
+    fputc(minCodeSize, fp);
+
+    std::vector<uint8_t> bytes;
+    uint32_t bitBuf = 0;
+    uint8_t bitCount = 0;
+    auto emit = [&](uint16_t code) {
+        bitBuf |= (uint32_t)code << bitCount;
+        bitCount += 9;
+        while (bitCount >= 8) {
+            bytes.push_back((uint8_t)bitBuf);
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    };
+
+    uint32_t literals = 0;
+    emit(clearCode);
+    size_t pixels = (size_t)width * height;
+    for (size_t i = 0; i < pixels; i++) {
+        if (literals == 128) {
+            emit(clearCode);
+            literals = 0;
+        }
+        const uint8_t* p = &image.rgb[i * 3];
+        uint16_t index = (uint16_t)(quantize6(p[0]) * 36 + quantize6(p[1]) * 6 + quantize6(p[2]));
+        emit(index);
+        literals++;
+    }
+    emit(endCode);
+    if (bitCount > 0) bytes.push_back((uint8_t)bitBuf);
+
+    for (size_t pos = 0; pos < bytes.size(); pos += 255) {
+        size_t len = bytes.size() - pos;
+        if (len > 255) len = 255;
+        fputc((int)len, fp);
+        fwrite(&bytes[pos], 1, len, fp);
+    }
+    fputc(0, fp);
+    return ferror(fp) == 0;
+}
+
+void GifWriter::close()
+{
+    if (fp) {
+        fputc(0x3B, fp);
+        fclose(fp);
+        fp = nullptr;
+    }
+}
+
+/******************************** GIF end ******************************************/
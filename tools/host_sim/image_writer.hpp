@@ -0,0 +1,54 @@
+/*
+ * 主机端仿真：无第三方依赖的 PNG / GIF 写出
+ * PNG 使用未压缩的 deflate 块；GIF 使用 6x6x6 调色板和不增长码表的 LZW 编码
+ */
+#ifndef _HOST_SIM_IMAGE_WRITER_HPP_
+#define _HOST_SIM_IMAGE_WRITER_HPP_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+struct HostImage {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> rgb;       // RGB888，逐行存放
+
+    HostImage(uint32_t w = 0, uint32_t h = 0) : width(w), height(h), rgb((size_t)w * h * 3, 0) {}
+
+    void setPixel(int32_t x, int32_t y, uint8_t r, uint8_t g, uint8_t b) {
+        if (x < 0 || y < 0 || (uint32_t)x >= width || (uint32_t)y >= height) return;
+        size_t i = ((size_t)y * width + (uint32_t)x) * 3;
+        rgb[i] = r;
+        rgb[i + 1] = g;
+        rgb[i + 2] = b;
+    }
+    void fill(uint8_t r, uint8_t g, uint8_t b) {
+        for (size_t i = 0; i < rgb.size(); i += 3) {
+            rgb[i] = r;
+            rgb[i + 1] = g;
+            rgb[i + 2] = b;
+        }
+    }
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t r, uint8_t g, uint8_t b);
+    void fillCircle(float cx, float cy, float radius, uint8_t r, uint8_t g, uint8_t b);
+};
+
+bool writePng(const char* path, const HostImage& image);
+
+class GifWriter {
+    public:
+        GifWriter() : fp(nullptr), width(0), height(0) {}
+        ~GifWriter() { close(); }
+
+        bool open(const char* path, uint16_t width, uint16_t height);
+        bool addFrame(const HostImage& image, uint16_t delayCs);
+        void close();
+
+    private:
+        FILE* fp;
+        uint16_t width;
+        uint16_t height;
+};
+
+#endif // _HOST_SIM_IMAGE_WRITER_HPP_
@@ -0,0 +1,430 @@
+/*
+ * LED 灯效主机端渲染与基准测试
+ *
+ * 将固件中的 LEDsManager / led_animation.cpp / led_compositor.cpp 与替身驱动链接，
+ * 按 HITBOX_LED_POS_LIST 的真实坐标把任意 LEDProfile 渲染为：
+ *   png  - 灯带条：每行一帧，每列一个 LED
+ *   gif  - 按面板坐标绘制的动画
+ *   raw  - 每帧 NUM_LED * 3 字节 RGB，便于与基准文件逐字节比较
+ * 同时统计每帧 LEDsManager::loop 的指令数（或耗时），用于发现动画代码的性能回退。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "leds/leds_manager.hpp"
+#include "leds/led_program_store.hpp"
+#include "host_sim.h"
+#include "image_writer.hpp"
+#include "perf_counter.hpp"
+
+extern bool g_has_led_around;
+
+// 每帧间隔与 LEDsManager::loop 的节流判断保持一致
+#define PREVIEW_FRAME_INTERVAL_MS   (1000 / FPS_OF_LED_ANIMATION)
+#define PREVIEW_START_TICK          1000u
+
+struct PressEvent {
+    uint32_t timeMs;
+    uint8_t index;
+    uint32_t durationMs;
+};
+
+struct PreviewOptions {
+    const char* format = "png";
+    const char* out = nullptr;
+    const char* program = nullptr;
+    uint32_t frames = 120;
+    uint32_t cell = 6;
+    float scale = 2.0f;
+    uint32_t seed = 1;
+    uint64_t budgetInstructions = 0;
+    uint64_t budgetNanoseconds = 0;
+    bool quiet = false;
+    std::vector<PressEvent> presses;
+};
+
+static const char* LED_EFFECT_NAMES[LEDEffect::NUM_EFFECTS] = {
+    "static", "breathing", "star", "flowing", "ripple", "transform", "custom"
+};
+
+static const char* AROUND_EFFECT_NAMES[AroundLEDEffect::NUM_AROUND_LED_EFFECTS] = {
+    "static", "breathing", "quake", "meteor"
+};
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --effect NAME|N          static|breathing|star|flowing|ripple|transform|custom\n"
+        "  --program FILE.lvm       bytecode for the custom effect (see tools/led_vm)\n"
+        "  --colors C1,C2,C3        hex colours (front, back1, back2)\n"
+        "  --speed 1-5              animation speed\n"
+        "  --reactive-fade MS       afterglow after a key is released, 0 = off\n"
+        "  --brightness 0-100\n"
+        "  --around MODE            off|sync|static|breathing|quake|meteor\n"
+        "  --around-colors C1,C2\n"
+        "  --around-speed 1-5\n"
+        "  --around-brightness 0-100\n"
+        "  --around-trigger         ambient animation triggered by button press\n"
+        "  --no-ambient             board without ambient strip\n"
+        "  --press T:IDX[:DUR]      press LED/button IDX at T ms for DUR ms (repeatable)\n"
+        "  --frames N               number of frames (default 120)\n"
+        "  --format png|gif|raw     output format (default png)\n"
+        "  --out PATH               output file (omit for benchmark only)\n"
+        "  --cell N                 png strip cell size in px (default 6)\n"
+        "  --scale F                gif px per board unit (default 2.0)\n"
+        "  --seed N                 random seed for star effect\n"
+        "  --budget-instr N         fail if average instructions per frame exceeds N\n"
+        "  --budget-ns N            fail if average ns per frame exceeds N\n"
+        "  --quiet\n",
+        prog);
+}
+
+static int parseEnum(const char* value, const char* const* names, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(value, names[i]) == 0) return i;
+    }
+    char* end = nullptr;
+    long v = strtol(value, &end, 10);
+    if (end && *end == '\0' && v >= 0 && v < count) return (int)v;
+    return -1;
+}
+
+static int parseColors(const char* value, uint32_t* colors, int maxCount)
+{
+    int count = 0;
+    const char* p = value;
+    while (*p && count < maxCount) {
+        if (*p == '#') p++;
+        char* end = nullptr;
+        colors[count++] = (uint32_t)strtoul(p, &end, 16) & 0xFFFFFF;
+        if (!end || end == p) return -1;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static void makeDefaultLedProfile(LEDProfile& led)
+{
+    led.ledEnabled = true;
+    led.ledEffect = LEDEffect::BREATHING;
+    led.ledColor1 = 0x00FF00;
+    led.ledColor2 = 0x0000FF;
+    led.ledColor3 = 0x000000;
+    led.ledBrightness = 75;
+    led.ledAnimationSpeed = 3;
+    led.aroundLedEnabled = true;
+    led.aroundLedSyncToMainLed = false;
+    led.aroundLedTriggerByButton = false;
+    led.aroundLedEffect = AroundLEDEffect::AROUND_BREATHING;
+    led.aroundLedColor1 = 0xFF0000;
+    led.aroundLedColor2 = 0x0000FF;
+    led.aroundLedColor3 = 0x000000;
+    led.aroundLedBrightness = 75;
+    led.aroundLedAnimationSpeed = 3;
+    led.ledReactiveFadeMs = 0;
+}
+
+static void setupStorage(const LEDProfile& led)
+{
+    Config& config = STORAGE_MANAGER.config;
+    memset(&config, 0, sizeof(config));
+    config.version = CONFIG_VERSION;
+    config.bootMode = BootMode::BOOT_MODE_INPUT;
+    config.numProfilesMax = 1;
+    strcpy(config.defaultProfileId, "profile-0");
+
+    GamepadProfile profile;
+    memset(&profile, 0, sizeof(profile));
+    strcpy(profile.id, "profile-0");
+    strcpy(profile.name, "Preview");
+    profile.enabled = true;
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        profile.keysConfig.keysEnableTag[i] = true;
+    }
+    profile.ledsConfigs = led;
+    STORAGE_MANAGER.storeProfileAt(0, profile);
+
+    for (uint8_t i = 0; i < NUM_GAMEPAD_HOTKEYS; i++) {
+        config.hotkeys[i].action = DEFAULT_HOTKEY_LIST[i].action;
+        config.hotkeys[i].isHold = DEFAULT_HOTKEY_LIST[i].isHold;
+        config.hotkeys[i].isLocked = DEFAULT_HOTKEY_LIST[i].isLocked;
+        config.hotkeys[i].virtualPin = DEFAULT_HOTKEY_LIST[i].virtualPin;
+    }
+}
+
+static uint32_t pressMaskAt(const std::vector<PressEvent>& presses, uint32_t timeMs)
+{
+    uint32_t mask = 0;
+    for (const PressEvent& e : presses) {
+        if (timeMs >= e.timeMs && timeMs < e.timeMs + e.durationMs) {
+            mask |= (1U << e.index);
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief 把字节码写入程序槽 0 并设为当前程序，流程与网页上传一致
+ */
+static bool installProgram(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    std::vector<uint8_t> blob(sizeof(LedVmProgramHeader) + LEDS_VM_MAX_CODE_SIZE + 1);
+    size_t length = fread(blob.data(), 1, blob.size(), f);
+    fclose(f);
+
+    LedVmError err = LED_PROGRAM_STORE.save(0, blob.data(), length);
+    if (err != LED_VM_OK) {
+        fprintf(stderr, "invalid program %s: error %d\n", path, err);
+        return false;
+    }
+    return LED_PROGRAM_STORE.select(0);
+}
+
+/**
+ * @brief 按面板坐标绘制一帧
+ */
+static void drawBoard(HostImage& image, const std::vector<RGBColor>& leds, float scale, float originX, float originY)
+{
+    image.fill(24, 24, 24);
+    uint8_t count = g_has_led_around ? NUM_LED : (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS);
+    for (uint8_t i = 0; i < count; i++) {
+        const Position& p = HITBOX_LED_POS_LIST[i];
+        float cx = (p.x - originX) * scale;
+        float cy = (p.y - originY) * scale;
+        float radius = p.r * 0.5f * scale;
+        // 按键外圈，便于分辨熄灭的按键
+        image.fillCircle(cx, cy, radius, 56, 56, 56);
+        image.fillCircle(cx, cy, radius - 1.0f, leds[i].r, leds[i].g, leds[i].b);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    PreviewOptions opts;
+    LEDProfile led;
+    makeDefaultLedProfile(led);
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool needsValue = true;
+
+        if (strcmp(arg, "--effect") == 0 && value) {
+            int e = parseEnum(value, LED_EFFECT_NAMES, LEDEffect::NUM_EFFECTS);
+            if (e < 0) { fprintf(stderr, "unknown effect: %s\n", value); return 2; }
+            led.ledEffect = (LEDEffect)e;
+        } else if (strcmp(arg, "--program") == 0 && value) {
+            opts.program = value;
+        } else if (strcmp(arg, "--colors") == 0 && value) {
+            uint32_t c[3] = {led.ledColor1, led.ledColor2, led.ledColor3};
+            if (parseColors(value, c, 3) < 0) { fprintf(stderr, "bad colours: %s\n", value); return 2; }
+            led.ledColor1 = c[0];
+            led.ledColor2 = c[1];
+            led.ledColor3 = c[2];
+        } else if (strcmp(arg, "--speed") == 0 && value) {
+            led.ledAnimationSpeed = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--reactive-fade") == 0 && value) {
+            led.ledReactiveFadeMs = (uint16_t)atoi(value);
+        } else if (strcmp(arg, "--brightness") == 0 && value) {
+            led.ledBrightness = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--around") == 0 && value) {
+            if (strcmp(value, "off") == 0) {
+                led.aroundLedEnabled = false;
+            } else if (strcmp(value, "sync") == 0) {
+                led.aroundLedEnabled = true;
+                led.aroundLedSyncToMainLed = true;
+            } else {
+                int e = parseEnum(value, AROUND_EFFECT_NAMES, AroundLEDEffect::NUM_AROUND_LED_EFFECTS);
+                if (e < 0) { fprintf(stderr, "unknown ambient effect: %s\n", value); return 2; }
+                led.aroundLedEnabled = true;
+                led.aroundLedSyncToMainLed = false;
+                led.aroundLedEffect = (AroundLEDEffect)e;
+            }
+        } else if (strcmp(arg, "--around-colors") == 0 && value) {
+            uint32_t c[2] = {led.aroundLedColor1, led.aroundLedColor2};
+            if (parseColors(value, c, 2) < 0) { fprintf(stderr, "bad colours: %s\n", value); return 2; }
+            led.aroundLedColor1 = c[0];
+            led.aroundLedColor2 = c[1];
+        } else if (strcmp(arg, "--around-speed") == 0 && value) {
+            led.aroundLedAnimationSpeed = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--around-brightness") == 0 && value) {
+            led.aroundLedBrightness = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--press") == 0 && value) {
+            PressEvent e;
+            unsigned t = 0, idx = 0, dur = 100;
+            if (sscanf(value, "%u:%u:%u", &t, &idx, &dur) < 2 || idx >= NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) {
+                fprintf(stderr, "bad press: %s\n", value);
+                return 2;
+            }
+            e.timeMs = t;
+            e.index = (uint8_t)idx;
+            e.durationMs = dur;
+            opts.presses.push_back(e);
+        } else if (strcmp(arg, "--frames") == 0 && value) {
+            opts.frames = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--format") == 0 && value) {
+            opts.format = value;
+        } else if (strcmp(arg, "--out") == 0 && value) {
+            opts.out = value;
+        } else if (strcmp(arg, "--cell") == 0 && value) {
+            opts.cell = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--scale") == 0 && value) {
+            opts.scale = (float)atof(value);
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            opts.seed = (uint32_t)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--budget-instr") == 0 && value) {
+            opts.budgetInstructions = strtoull(value, nullptr, 10);
+        } else if (strcmp(arg, "--budget-ns") == 0 && value) {
+            opts.budgetNanoseconds = strtoull(value, nullptr, 10);
+        } else {
+            needsValue = false;
+            if (strcmp(arg, "--around-trigger") == 0) {
+                led.aroundLedTriggerByButton = true;
+            } else if (strcmp(arg, "--no-ambient") == 0) {
+                g_has_led_around = false;
+            } else if (strcmp(arg, "--quiet") == 0) {
+                opts.quiet = true;
+            } else {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        if (needsValue) i++;
+    }
+
+    if (opts.frames == 0 || opts.cell == 0 || opts.scale <= 0.0f) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (strcmp(opts.format, "png") != 0 && strcmp(opts.format, "gif") != 0 && strcmp(opts.format, "raw") != 0) {
+        fprintf(stderr, "unknown format: %s\n", opts.format);
+        return 2;
+    }
+
+    if (opts.program && !installProgram(opts.program)) {
+        return 1;
+    }
+
+    srand(opts.seed);
+    setupStorage(led);
+    host_sim_set_tick(PREVIEW_START_TICK);
+    LEDS_MANAGER.setup();
+
+    // 面板坐标范围（GIF）
+    float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+    for (uint8_t i = 0; i < NUM_LED; i++) {
+        const Position& p = HITBOX_LED_POS_LIST[i];
+        float r = p.r * 0.5f;
+        if (p.x - r < minX) minX = p.x - r;
+        if (p.y - r < minY) minY = p.y - r;
+        if (p.x + r > maxX) maxX = p.x + r;
+        if (p.y + r > maxY) maxY = p.y + r;
+    }
+    const float margin = 4.0f;
+    minX -= margin;
+    minY -= margin;
+    maxX += margin;
+    maxY += margin;
+
+    HostImage strip(NUM_LED * opts.cell, opts.frames * opts.cell);
+    HostImage board((uint32_t)((maxX - minX) * opts.scale), (uint32_t)((maxY - minY) * opts.scale));
+    GifWriter gif;
+    FILE* raw = nullptr;
+
+    if (opts.out) {
+        if (strcmp(opts.format, "gif") == 0) {
+            if (!gif.open(opts.out, (uint16_t)board.width, (uint16_t)board.height)) {
+                fprintf(stderr, "cannot open %s\n", opts.out);
+                return 1;
+            }
+        } else if (strcmp(opts.format, "raw") == 0) {
+            raw = fopen(opts.out, "wb");
+            if (!raw) {
+                fprintf(stderr, "cannot open %s\n", opts.out);
+                return 1;
+            }
+        }
+    }
+
+    PerfCounter counter;
+    PerfStats instrStats;
+    PerfStats nsStats;
+    std::vector<RGBColor> leds(NUM_LED);
+    const uint16_t gifDelayCs = (uint16_t)((PREVIEW_FRAME_INTERVAL_MS + 5) / 10);
+
+    for (uint32_t f = 0; f < opts.frames; f++) {
+        uint32_t timeMs = f * PREVIEW_FRAME_INTERVAL_MS;
+        host_sim_set_tick(PREVIEW_START_TICK + timeMs);
+        uint32_t mask = pressMaskAt(opts.presses, timeMs);
+
+        counter.begin();
+        LEDS_MANAGER.loop(mask);
+        counter.end();
+
+        instrStats.add(counter.lastInstructions());
+        nsStats.add(counter.lastNanoseconds());
+
+        for (uint8_t i = 0; i < NUM_LED; i++) {
+            leds[i] = host_ws2812b_get_output(i);
+        }
+
+        if (!opts.out) continue;
+
+        if (raw) {
+            for (uint8_t i = 0; i < NUM_LED; i++) {
+                uint8_t px[3] = {leds[i].r, leds[i].g, leds[i].b};
+                fwrite(px, 1, 3, raw);
+            }
+        } else if (strcmp(opts.format, "gif") == 0) {
+            drawBoard(board, leds, opts.scale, minX, minY);
+            gif.addFrame(board, gifDelayCs);
+        } else {
+            for (uint8_t i = 0; i < NUM_LED; i++) {
+                strip.fillRect(i * opts.cell, f * opts.cell, opts.cell, opts.cell, leds[i].r, leds[i].g, leds[i].b);
+            }
+        }
+    }
+
+    if (raw) fclose(raw);
+    gif.close();
+    if (opts.out && strcmp(opts.format, "png") == 0) {
+        if (!writePng(opts.out, strip)) {
+            fprintf(stderr, "cannot write %s\n", opts.out);
+            return 1;
+        }
+    }
+
+    if (!opts.quiet) {
+        printf("effect=%s frames=%u leds=%u\n", LED_EFFECT_NAMES[led.ledEffect], opts.frames,
+               (unsigned)(g_has_led_around ? NUM_LED : (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)));
+        if (counter.hasInstructions()) {
+            printf("instructions/frame: avg=%llu min=%llu max=%llu\n",
+                   (unsigned long long)instrStats.avg(), (unsigned long long)instrStats.min, (unsigned long long)instrStats.max);
+        } else {
+            printf("instructions/frame: unavailable (perf_event_open denied)\n");
+        }
+        printf("ns/frame: avg=%llu min=%llu max=%llu\n",
+               (unsigned long long)nsStats.avg(), (unsigned long long)nsStats.min, (unsigned long long)nsStats.max);
+    }
+
+    int rc = 0;
+    if (opts.budgetInstructions > 0 && counter.hasInstructions() && instrStats.avg() > opts.budgetInstructions) {
+        fprintf(stderr, "over budget: %llu instructions/frame > %llu\n",
+                (unsigned long long)instrStats.avg(), (unsigned long long)opts.budgetInstructions);
+        rc = 1;
+    }
+    if (opts.budgetNanoseconds > 0 && nsStats.avg() > opts.budgetNanoseconds) {
+        fprintf(stderr, "over budget: %llu ns/frame > %llu\n",
+                (unsigned long long)nsStats.avg(), (unsigned long long)opts.budgetNanoseconds);
+        rc = 1;
+    }
+    return rc;
+}
@@ -0,0 +1,53 @@
+#include "perf_counter.hpp"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+PerfCounter::PerfCounter() : fd(-1), startNs(0), instructions(0), nanoseconds(0)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounter::~PerfCounter()
+{
+    if (fd >= 0) close(fd);
+}
+
+void PerfCounter::begin()
+{
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    startNs = monotonicNs();
+}
+
+void PerfCounter::end()
+{
+    nanoseconds = monotonicNs() - startNs;
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(fd, &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+            instructions = value;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * 主机端仿真：单帧开销计数
+ * 优先使用 perf_event 统计用户态指令数（与目标平台的相对开销更接近），
+ * 不可用时（容器、权限限制）退化为单调时钟纳秒
+ */
+#ifndef _HOST_SIM_PERF_COUNTER_HPP_
+#define _HOST_SIM_PERF_COUNTER_HPP_
+
+#include <stdint.h>
+
+class PerfCounter {
+    public:
+        PerfCounter();
+        ~PerfCounter();
+
+        void begin();
+        void end();
+
+        bool hasInstructions() const { return fd >= 0; }
+        uint64_t lastInstructions() const { return instructions; }
+        uint64_t lastNanoseconds() const { return nanoseconds; }
+
+    private:
+        int fd;
+        uint64_t startNs;
+        uint64_t instructions;
+        uint64_t nanoseconds;
+};
+
+struct PerfStats {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    void add(uint64_t v) {
+        count++;
+        sum += v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+    uint64_t avg() const { return count ? sum / count : 0; }
+};
+
+#endif // _HOST_SIM_PERF_COUNTER_HPP_
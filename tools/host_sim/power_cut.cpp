@@ -0,0 +1,604 @@
+/*
+ * 掉电回放：ConfigStore / FlashFs / ConfigSchema 的断电测试
+ *
+ * 每一轮在模型上做一次修改（写几个键、写或删一个文件、保存几个配置分区），然后在写入过程中
+ * 随机的一次擦写处断电（host_flash_cut_after），重新上电后检查读出的内容正好是修改前或修改后的
+ * 完整状态；没有断电的写入必须读到修改后的状态。
+ *
+ * 每次上电是一个 fork 出的子进程：单例从头构造，和真实的重新上电一样；模拟 flash 是共享映射，
+ * 在进程之间保留。父进程只保存模型，从不访问被测模块。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "config_store.hpp"
+#include "config_schema.hpp"
+#include "flash_fs.hpp"
+#include "host_sim.h"
+
+#define POWER_CUT_IDLE_STEP_MS  5000u        // 超过 ConfigStore 的空闲时间，service() 每次都会整理一步
+
+// 子进程通过管道回报的结果
+enum BootState : int32_t {
+    BOOT_OLD = 0,           // 读到修改前的状态
+    BOOT_NEW = 1,           // 读到修改后的状态（修改前后相同时也算这一种）
+    BOOT_MISMATCH = 2,      // 两者都不是
+    BOOT_DONE = 3,          // 写入阶段结束
+};
+
+struct BootResult {
+    int32_t state;
+    uint32_t erases;
+    uint32_t programs;
+    bool cut;               // 写入阶段断电了
+    bool ok;                // 写入阶段被测模块报告成功
+};
+
+struct PowerCutOptions {
+    const char* target = "store";
+    uint32_t seed = 1;
+    uint32_t rounds = 400;
+    bool verbose = false;
+};
+
+static uint32_t g_rng = 1;
+static bool g_verbose = false;
+
+static uint32_t rng_next()
+{
+    // xorshift32
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static uint32_t rng_below(uint32_t n)
+{
+    return n ? rng_next() % n : 0;
+}
+
+static void rng_fill(void* out, uint32_t len)
+{
+    uint8_t* p = (uint8_t*)out;
+    for (uint32_t i = 0; i < len; i++) p[i] = (uint8_t)rng_next();
+}
+
+/*
+ * 被测目标。父进程调用 mutate 生成下一个模型，子进程里 format / apply / verify 访问 flash
+ */
+struct PowerCutTarget {
+    const char* name;
+    void (*reset)();                // 父进程：模型回到空状态
+    bool (*format)();               // 子进程：建立空的存储
+    void (*mutate)();               // 父进程：由当前模型生成下一个模型和对应的写入
+    bool (*apply)();                // 子进程：执行写入
+    BootState (*verify)();          // 子进程：上电读取并与两个模型比较
+    void (*accept)();               // 父进程：采用下一个模型
+};
+
+/* ---------------- ConfigStore：键值和事务 ---------------- */
+
+#define STORE_KEYS              48
+#define STORE_MAX_TXN_KEYS      4
+
+struct StoreModel {
+    uint16_t len[STORE_KEYS];       // 0 表示键不存在
+    uint8_t data[STORE_KEYS][CONFIG_STORE_PAYLOAD_SIZE];
+};
+
+static StoreModel g_storeCur;
+static StoreModel g_storeNext;
+static uint16_t g_storeTxnKeys[STORE_MAX_TXN_KEYS];
+static uint8_t g_storeTxnCount = 0;
+static uint8_t g_storeServiceSteps = 0;
+
+static void store_reset()
+{
+    memset(&g_storeCur, 0, sizeof(g_storeCur));
+}
+
+static bool store_format()
+{
+    return CONFIG_STORE.format();
+}
+
+static void store_mutate()
+{
+    g_storeNext = g_storeCur;
+    g_storeTxnCount = (uint8_t)(1 + rng_below(STORE_MAX_TXN_KEYS));
+    for (uint8_t i = 0; i < g_storeTxnCount; i++) {
+        uint16_t key;
+        bool fresh;
+        do {
+            key = (uint16_t)rng_below(STORE_KEYS);
+            fresh = true;
+            for (uint8_t k = 0; k < i; k++) fresh = fresh && g_storeTxnKeys[k] != key;
+        } while (!fresh);
+        g_storeTxnKeys[i] = key;
+        g_storeNext.len[key] = (uint16_t)(1 + rng_below(CONFIG_STORE_PAYLOAD_SIZE));
+        rng_fill(g_storeNext.data[key], g_storeNext.len[key]);
+    }
+    // 写入之前先让后台整理走几步，断电也可能落在整理里
+    g_storeServiceSteps = (uint8_t)rng_below(4);
+}
+
+static bool store_apply()
+{
+    if (!CONFIG_STORE.mount()) return false;
+    uint32_t tick = 0;
+    for (uint8_t i = 0; i < g_storeServiceSteps; i++) {
+        tick += POWER_CUT_IDLE_STEP_MS;
+        host_sim_set_tick(tick);
+        CONFIG_STORE.service();
+    }
+    if (CONFIG_STORE.reserve(g_storeTxnCount) < g_storeTxnCount || !CONFIG_STORE.begin()) return false;
+    for (uint8_t i = 0; i < g_storeTxnCount; i++) {
+        const uint16_t key = g_storeTxnKeys[i];
+        if (!CONFIG_STORE.write(key, g_storeNext.data[key], g_storeNext.len[key])) return false;
+    }
+    return CONFIG_STORE.commit();
+}
+
+static bool store_matches(const StoreModel& model)
+{
+    uint8_t buffer[CONFIG_STORE_PAYLOAD_SIZE];
+    for (uint16_t key = 0; key < STORE_KEYS; key++) {
+        uint16_t len = 0;
+        const bool found = CONFIG_STORE.read(key, buffer, sizeof(buffer), &len);
+        if (model.len[key] == 0) {
+            if (found) return false;
+        } else if (!found || len != model.len[key] || memcmp(buffer, model.data[key], len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static BootState store_verify()
+{
+    if (!CONFIG_STORE.mount()) return BOOT_MISMATCH;
+    if (store_matches(g_storeNext)) return BOOT_NEW;
+    if (store_matches(g_storeCur)) return BOOT_OLD;
+    return BOOT_MISMATCH;
+}
+
+static void store_accept()
+{
+    g_storeCur = g_storeNext;
+}
+
+/* ---------------- FlashFs：文件替换和删除 ---------------- */
+
+#define FS_FILES                6
+#define FS_MAX_FILE_SIZE        (2 * FLASH_FS_BLOCK_PAYLOAD + 512)
+
+struct FsModel {
+    bool exists[FS_FILES];
+    uint32_t size[FS_FILES];
+    uint8_t data[FS_FILES][FS_MAX_FILE_SIZE];
+};
+
+static FsModel g_fsCur;
+static FsModel g_fsNext;
+static uint8_t g_fsFile = 0;
+
+static void fs_name(uint8_t file, char* name)
+{
+    sprintf(name, "power-cut-%u.bin", file);
+}
+
+static void fs_reset()
+{
+    memset(&g_fsCur, 0, sizeof(g_fsCur));
+}
+
+static bool fs_format()
+{
+    // 空白 flash 就是没有文件的文件系统，分配时再擦除
+    return true;
+}
+
+static void fs_mutate()
+{
+    g_fsNext = g_fsCur;
+    g_fsFile = (uint8_t)rng_below(FS_FILES);
+    if (g_fsNext.exists[g_fsFile] && rng_below(5) == 0) {
+        g_fsNext.exists[g_fsFile] = false;
+        g_fsNext.size[g_fsFile] = 0;
+        return;
+    }
+    g_fsNext.exists[g_fsFile] = true;
+    g_fsNext.size[g_fsFile] = rng_below(FS_MAX_FILE_SIZE + 1);
+    rng_fill(g_fsNext.data[g_fsFile], g_fsNext.size[g_fsFile]);
+}
+
+static bool fs_apply()
+{
+    char name[FLASH_FS_NAME_LEN];
+    fs_name(g_fsFile, name);
+    if (!g_fsNext.exists[g_fsFile]) return FLASH_FS.remove(name);
+    return FLASH_FS.writeFile(name, g_fsNext.data[g_fsFile], g_fsNext.size[g_fsFile]);
+}
+
+static bool fs_matches(const FsModel& model)
+{
+    static uint8_t buffer[FS_MAX_FILE_SIZE];
+    for (uint8_t f = 0; f < FS_FILES; f++) {
+        char name[FLASH_FS_NAME_LEN];
+        fs_name(f, name);
+        FlashFsFile file;
+        const bool found = FLASH_FS.open(name, file);
+        if (found != model.exists[f]) return false;
+        if (!found) continue;
+        if (file.size != model.size[f] || FLASH_FS.read(file, buffer, file.size) != file.size
+            || memcmp(buffer, model.data[f], file.size) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static BootState fs_verify()
+{
+    if (fs_matches(g_fsNext)) return BOOT_NEW;
+    if (fs_matches(g_fsCur)) return BOOT_OLD;
+    return BOOT_MISMATCH;
+}
+
+static void fs_accept()
+{
+    g_fsCur = g_fsNext;
+}
+
+/* ---------------- ConfigSchema：分区保存和配置文件整理 ---------------- */
+
+struct SchemaModel {
+    Config config;
+    GamepadProfile profiles[NUM_PROFILES];
+};
+
+static SchemaModel g_schemaCur;
+static SchemaModel g_schemaNext;
+static ConfigSectionMask g_schemaSections = 0;
+
+static void schema_sync_headers(SchemaModel& model)
+{
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        memcpy(&model.config.profiles[i], &model.profiles[i], sizeof(GamepadProfileHeader));
+    }
+}
+
+static void schema_reset()
+{
+    ConfigUtils::makeDefaultConfig(g_schemaCur.config);
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        ConfigUtils::makeDefaultProfileAt(g_schemaCur.profiles[i], i);
+    }
+    schema_sync_headers(g_schemaCur);
+}
+
+static bool schema_save(const SchemaModel& model, ConfigSectionMask sections)
+{
+    const GamepadProfile* profiles[NUM_PROFILES];
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) profiles[i] = &model.profiles[i];
+    return ConfigSchema::save(model.config, profiles, sections);
+}
+
+static bool schema_format()
+{
+    return CONFIG_STORE.format() && schema_save(g_schemaCur, CONFIG_SECTION_ALL);
+}
+
+/**
+ * @brief 改一个配置文件的几个字段；有时改回默认值，覆盖省略默认字段的编码
+ */
+static void schema_mutate_profile(uint8_t index)
+{
+    GamepadProfile& profile = g_schemaNext.profiles[index];
+    GamepadProfile defaults;
+    ConfigUtils::makeDefaultProfileAt(defaults, g_schemaNext.config.profileSlots[index]);
+    const uint8_t changes = (uint8_t)(1 + rng_below(4));
+    for (uint8_t c = 0; c < changes; c++) {
+        const bool restore = rng_below(4) == 0;
+        switch (rng_below(5)) {
+            case 0:
+                if (restore) {
+                    memcpy(profile.name, defaults.name, sizeof(profile.name));
+                } else {
+                    memset(profile.name, 0, sizeof(profile.name));
+                    for (uint32_t i = rng_below(sizeof(profile.name) - 1); i > 0; i--) {
+                        profile.name[i - 1] = (char)('a' + rng_below(26));
+                    }
+                }
+                g_schemaSections |= CONFIG_SECTION_GLOBAL | CONFIG_SECTION_PROFILE(index);
+                break;
+            case 1:
+                profile.ledsConfigs.ledBrightness = restore ? defaults.ledsConfigs.ledBrightness : (uint8_t)rng_below(101);
+                profile.ledsConfigs.ledColor1 = restore ? defaults.ledsConfigs.ledColor1 : rng_next() & 0xFFFFFF;
+                g_schemaSections |= CONFIG_SECTION_PROFILE_LEDS(index);
+                break;
+            case 2: {
+                const uint8_t k = (uint8_t)rng_below(NUM_GAME_CONTROLLER_BUTTONS);
+                profile.keysConfig.keyMapping[k] = restore ? defaults.keysConfig.keyMapping[k] : rng_next();
+                g_schemaSections |= CONFIG_SECTION_PROFILE(index);
+                break;
+            }
+            case 3: {
+                const uint8_t k = (uint8_t)rng_below(NUM_ADC_BUTTONS);
+                if (restore) {
+                    profile.triggerConfigs.triggerConfigs[k] = defaults.triggerConfigs.triggerConfigs[k];
+                } else {
+                    profile.triggerConfigs.triggerConfigs[k].pressAccuracy = (float)rng_below(100) / 100.0f;
+                    profile.triggerConfigs.triggerConfigs[k].topDeadzone = (float)rng_below(100) / 100.0f;
+                }
+                g_schemaSections |= CONFIG_SECTION_PROFILE(index);
+                break;
+            }
+            default:
+                profile.enabled = restore ? defaults.enabled : !profile.enabled;
+                g_schemaSections |= CONFIG_SECTION_GLOBAL | CONFIG_SECTION_PROFILE(index);
+                break;
+        }
+    }
+}
+
+/**
+ * @brief 和 Storage::moveProfile 一样只调整顺序表和名片
+ */
+static void schema_move_profile(uint8_t from, uint8_t to)
+{
+    Config& config = g_schemaNext.config;
+    const GamepadProfile moved = g_schemaNext.profiles[from];
+    const uint8_t slot = config.profileSlots[from];
+    const int8_t dir = from < to ? 1 : -1;
+    for (uint8_t i = from; i != to; i = (uint8_t)(i + dir)) {
+        g_schemaNext.profiles[i] = g_schemaNext.profiles[i + dir];
+        config.profileSlots[i] = config.profileSlots[i + dir];
+    }
+    g_schemaNext.profiles[to] = moved;
+    config.profileSlots[to] = slot;
+    g_schemaSections |= CONFIG_SECTION_GLOBAL;
+}
+
+static void schema_mutate()
+{
+    g_schemaNext = g_schemaCur;
+    g_schemaSections = 0;
+    switch (rng_below(4)) {
+        case 0: {
+            const uint8_t from = (uint8_t)rng_below(NUM_PROFILES);
+            const uint8_t to = (uint8_t)rng_below(NUM_PROFILES);
+            if (from != to) schema_move_profile(from, to);
+            break;
+        }
+        case 1: {
+            Config& config = g_schemaNext.config;
+            config.screenControl.brightness = (uint8_t)rng_below(101);
+            config.hotkeys[rng_below(NUM_GAMEPAD_HOTKEYS)].virtualPin = (int32_t)rng_below(32);
+            config.inputMode = (InputMode)rng_below(4);
+            g_schemaSections |= CONFIG_SECTION_GLOBAL | CONFIG_SECTION_HOTKEYS | CONFIG_SECTION_SCREEN;
+            break;
+        }
+        default:
+            for (uint8_t n = (uint8_t)(1 + rng_below(3)); n > 0; n--) {
+                schema_mutate_profile((uint8_t)rng_below(NUM_PROFILES));
+            }
+            break;
+    }
+    schema_sync_headers(g_schemaNext);
+}
+
+static bool schema_apply()
+{
+    // 和启动时一样先挂载、读取，再保存
+    static Config loaded;
+    if (!CONFIG_STORE.mount()) return false;
+    ConfigUtils::makeDefaultConfig(loaded);
+    ConfigSchema::load(loaded);
+    return schema_save(g_schemaNext, g_schemaSections);
+}
+
+static bool schema_global_matches(const Config& a, const Config& b)
+{
+    return a.bootMode == b.bootMode && a.inputMode == b.inputMode && a.numProfilesMax == b.numProfilesMax
+        && a.autoCalibrationEnabled == b.autoCalibrationEnabled
+        && strcmp(a.defaultProfileId, b.defaultProfileId) == 0
+        && memcmp(a.profileSlots, b.profileSlots, sizeof(a.profileSlots)) == 0
+        && memcmp(a.profiles, b.profiles, sizeof(a.profiles)) == 0;
+}
+
+static bool schema_matches(const Config& loaded, const SchemaModel& model)
+{
+    static GamepadProfile profile;
+    if (!schema_global_matches(loaded, model.config)
+        || memcmp(loaded.hotkeys, model.config.hotkeys, sizeof(loaded.hotkeys)) != 0
+        || memcmp(&loaded.screenControl, &model.config.screenControl, sizeof(loaded.screenControl)) != 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        ConfigSchema::loadProfile(loaded.profileSlots[i], profile);
+        if (memcmp(&profile, &model.profiles[i], sizeof(profile)) != 0) return false;
+    }
+    return true;
+}
+
+static BootState schema_verify()
+{
+    static Config loaded;
+    if (!CONFIG_STORE.mount()) return BOOT_MISMATCH;
+    ConfigUtils::makeDefaultConfig(loaded);
+    if (!ConfigSchema::load(loaded)) return BOOT_MISMATCH;
+    if (schema_matches(loaded, g_schemaNext)) return BOOT_NEW;
+    if (schema_matches(loaded, g_schemaCur)) return BOOT_OLD;
+    return BOOT_MISMATCH;
+}
+
+static void schema_accept()
+{
+    g_schemaCur = g_schemaNext;
+}
+
+static const PowerCutTarget TARGETS[] = {
+    { "store",  store_reset,  store_format,  store_mutate,  store_apply,  store_verify,  store_accept },
+    { "fs",     fs_reset,     fs_format,     fs_mutate,     fs_apply,     fs_verify,     fs_accept },
+    { "schema", schema_reset, schema_format, schema_mutate, schema_apply, schema_verify, schema_accept },
+};
+
+/* ---------------- 上电 ---------------- */
+
+enum BootPhase {
+    PHASE_FORMAT,
+    PHASE_APPLY,
+    PHASE_VERIFY,
+};
+
+/**
+ * @brief fork 一个子进程完成一次上电；cutAfter 为 0 时不断电
+ */
+static bool boot(const PowerCutTarget& target, BootPhase phase, uint32_t cutAfter, uint32_t partial, BootResult& result)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    fflush(stdout);
+    fflush(stderr);
+    const pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        close(fds[0]);
+        BootResult r = {};
+        // 断电后被测模块的报错是预期的，只在 --verbose 时显示
+        if (!g_verbose) freopen("/dev/null", "w", stderr);
+        host_flash_cut_after(cutAfter, partial);
+        if (phase == PHASE_VERIFY) {
+            r.state = target.verify();
+        } else {
+            r.ok = phase == PHASE_FORMAT ? target.format() : target.apply();
+            r.state = BOOT_DONE;
+        }
+        r.cut = host_flash_is_cut();
+        r.erases = host_flash_take_erases();
+        r.programs = host_flash_take_programs();
+        const bool sent = write(fds[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+        _exit(sent ? 0 : 1);
+    }
+    close(fds[1]);
+    const bool received = read(fds[0], &result, sizeof(result)) == (ssize_t)sizeof(result);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int run(const PowerCutTarget& target, const PowerCutOptions& opts)
+{
+    BootResult r;
+    g_rng = opts.seed ? opts.seed : 1;
+    target.reset();
+    if (!boot(target, PHASE_FORMAT, 0, 0, r) || !r.ok) {
+        fprintf(stderr, "target=%s: format failed\n", target.name);
+        return 1;
+    }
+
+    // 四轮里有三轮断电，断电点在最近一次没断电的写入用掉的擦写次数内均匀选取；其余一轮推进状态并统计写入开销
+    uint32_t opsBudget = 16;
+    uint32_t cuts = 0, kept = 0, taken = 0, failedWrites = 0;
+    uint64_t erases = 0, programs = 0, writes = 0;
+    for (uint32_t round = 0; round < opts.rounds; round++) {
+        target.mutate();
+        const uint32_t cutAfter = rng_below(4) ? 1 + rng_below(opsBudget) : 0;
+        // 断电的那一次只作用到前 partial 字节：页编程和扇区擦除各占一半
+        const uint32_t partial = rng_below(2) ? rng_below(W25Qxx_PageSize) : rng_below(W25Qxx_SECTOR_SIZE);
+        if (!boot(target, PHASE_APPLY, cutAfter, partial, r)) {
+            fprintf(stderr, "target=%s seed=%u round=%u: apply crashed\n", target.name, opts.seed, round);
+            return 1;
+        }
+        const bool cut = r.cut;
+        const bool ok = r.ok;
+        if (!cut) {
+            const uint32_t ops = r.erases + r.programs;
+            if (ok) {
+                erases += r.erases;
+                programs += r.programs;
+                writes++;
+            } else {
+                failedWrites++;
+            }
+            if (ops > 0) opsBudget = ops;
+        }
+
+        if (!boot(target, PHASE_VERIFY, 0, 0, r)) {
+            fprintf(stderr, "target=%s seed=%u round=%u: verify crashed\n", target.name, opts.seed, round);
+            return 1;
+        }
+        if (r.state == BOOT_MISMATCH || (!cut && ok && r.state != BOOT_NEW)) {
+            fprintf(stderr, "target=%s seed=%u round=%u cut=%u partial=%u: %s\n", target.name, opts.seed, round,
+                cut ? cutAfter : 0, partial, r.state == BOOT_MISMATCH ? "neither old nor new state" : "completed write lost");
+            return 1;
+        }
+        if (cut) cuts++;
+        if (r.state == BOOT_NEW) {
+            target.accept();
+            taken++;
+        } else {
+            kept++;
+        }
+        if (opts.verbose) {
+            printf("round=%u cut=%u state=%s\n", round, cut ? cutAfter : 0, r.state == BOOT_NEW ? "new" : "old");
+        }
+    }
+
+    printf("target=%s seed=%u rounds=%u cuts=%u old=%u new=%u failed=%u erases/write=%.2f programs/write=%.2f\n",
+        target.name, opts.seed, opts.rounds, cuts, kept, taken, failedWrites,
+        writes ? (double)erases / writes : 0.0, writes ? (double)programs / writes : 0.0);
+    return 0;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --target store|fs|schema  module under test (default store)\n"
+        "  --seed N                  random seed (default 1)\n"
+        "  --rounds N                writes to interrupt (default 400)\n"
+        "  --verbose                 print every round\n",
+        prog);
+}
+
+int main(int argc, char** argv)
+{
+    PowerCutOptions opts;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool needsValue = true;
+
+        if (strcmp(arg, "--target") == 0 && value) {
+            opts.target = value;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            opts.seed = (uint32_t)strtoul(value, nullptr, 0);
+        } else if (strcmp(arg, "--rounds") == 0 && value) {
+            opts.rounds = (uint32_t)strtoul(value, nullptr, 0);
+        } else if (strcmp(arg, "--verbose") == 0) {
+            opts.verbose = true;
+            needsValue = false;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+        if (needsValue) i++;
+    }
+
+    g_verbose = opts.verbose;
+    if (!host_qspi_is_mapped()) {
+        fprintf(stderr, "power_cut: simulated flash is not shared between boots\n");
+        return 2;
+    }
+    for (const PowerCutTarget& target : TARGETS) {
+        if (strcmp(target.name, opts.target) == 0) return run(target, opts);
+    }
+    fprintf(stderr, "unknown target: %s\n", opts.target);
+    return 2;
+}
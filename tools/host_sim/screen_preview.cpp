@@ -0,0 +1,534 @@
+/*
+ * 屏幕界面主机端渲染与快照
+ *
+ * 将固件中的 SPIScreenManager、主菜单、待机与各详情页和 st7789_gfx.c 与内存面板替身链接，
+ * 按脚本注入旋转编码器与按键事件，以虚拟时钟驱动 SPIScreenManager::loop：
+ *   - 每个实际渲染的帧输出 pre / frameBegin / prep / render / flush 各阶段耗时与发送像素数
+ *   - 脚本中的 snap 把面板显存写成 PNG，并输出 CRC32，可与期望值比较
+ *
+ * 脚本每行一个事件：<时间ms> <动作> [参数]，# 开头为注释
+ *   cw [N] / ccw [N]       旋转 N 格（默认 1）
+ *   click / long           短按 / 长按编码器
+ *   press IDX DUR          按下虚拟引脚 IDX 持续 DUR ms
+ *   set KEY VALUE          修改屏幕配置：standby none|image|layout、bg HEX、text HEX、brightness N、
+ *                          competition 0|1（默认配置是否为比赛配置）、tournament_screen_off 0|1
+ *   snap NAME [CRC]        保存快照 NAME.png，给出 CRC（十六进制）时不一致即失败；同时输出当前背光
+ *   end                    结束仿真
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "screen_control/spi_screen_manager.hpp"
+#include "storagemanager.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "gpio_btns/gpio_btns_worker.hpp"
+#include "input_snapshot.hpp"
+#include "qspi-w25q64.h"
+#include "host_sim.h"
+#include "image_writer.hpp"
+
+#define PREVIEW_START_TICK          1000u
+#define PREVIEW_DEFAULT_STEP_MS     5u
+#define PREVIEW_MAX_TIME_MS         600000u
+
+enum ScriptAction : uint8_t {
+    SCRIPT_TURN,
+    SCRIPT_CLICK,
+    SCRIPT_LONG,
+    SCRIPT_PRESS,
+    SCRIPT_SET,
+    SCRIPT_SNAP,
+    SCRIPT_END,
+};
+
+struct ScriptEvent {
+    uint32_t timeMs;
+    ScriptAction action;
+    int32_t value;          // 旋转格数 / 虚拟引脚
+    uint32_t durationMs;    // press 持续时间
+    std::string name;       // snap 文件名 / set 配置项
+    std::string arg;        // set 配置值
+    bool hasCrc;
+    uint32_t crc;
+};
+
+struct PreviewOptions {
+    const char* script = nullptr;
+    const char* outDir = nullptr;
+    const char* assets = nullptr;
+    uint32_t stepMs = PREVIEW_DEFAULT_STEP_MS;
+    uint32_t durationMs = 0;
+    uint32_t bg = 0x000000;
+    uint32_t text = 0xFFFFFF;
+    uint8_t brightness = 100;
+    uint8_t standby = 0;
+    uint8_t profiles = 3;
+    bool checkStale = false;
+    bool quiet = false;
+    uint32_t budgetRenderUs = 0;
+    uint32_t budgetFlushPx = 0;
+};
+
+static const char* STANDBY_NAMES[] = {"none", "image", "layout"};
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "Usage: %s --script FILE [options]\n"
+        "  --script FILE            event script (see header of screen_preview.cpp)\n"
+        "  --out-dir DIR            directory for snapshot PNGs (omit to only print CRCs)\n"
+        "  --assets PACK.bin        HIMG asset pack written at SYS_IMAGE_RESOURCES_ADDR\n"
+        "  --step MS                virtual time per loop call (default %u)\n"
+        "  --duration MS            stop after MS even without an end event\n"
+        "  --bg HEX / --text HEX    screen colours\n"
+        "  --brightness 0-100       screen brightness\n"
+        "  --standby none|image|layout\n"
+        "  --profiles N             number of enabled profiles (default 3)\n"
+        "  --check-stale            fail if the panel differs from the framebuffer after a frame\n"
+        "  --budget-render-us N     fail if average render time per frame exceeds N us\n"
+        "  --budget-flush-px N      fail if average pixels sent per frame exceeds N\n"
+        "  --quiet                  summary only\n",
+        prog, PREVIEW_DEFAULT_STEP_MS);
+}
+
+static int parseEnum(const char* value, const char* const* names, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(value, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+static bool loadScript(const char* path, std::vector<ScriptEvent>& events)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    char line[256];
+    uint32_t lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char action[16] = {0};
+        char arg1[64] = {0};
+        char arg2[32] = {0};
+        unsigned t = 0;
+        int n = sscanf(line, "%u %15s %63s %31s", &t, action, arg1, arg2);
+        if (n <= 0) continue;
+        if (n < 2) {
+            ok = false;
+            break;
+        }
+
+        ScriptEvent e;
+        e.timeMs = t;
+        e.value = 0;
+        e.durationMs = 0;
+        e.hasCrc = false;
+        e.crc = 0;
+        if (strcmp(action, "cw") == 0 || strcmp(action, "ccw") == 0) {
+            e.action = SCRIPT_TURN;
+            e.value = (n >= 3) ? atoi(arg1) : 1;
+            if (action[1] == 'c') e.value = -e.value;
+        } else if (strcmp(action, "click") == 0) {
+            e.action = SCRIPT_CLICK;
+        } else if (strcmp(action, "long") == 0) {
+            e.action = SCRIPT_LONG;
+        } else if (strcmp(action, "press") == 0 && n >= 4) {
+            e.action = SCRIPT_PRESS;
+            e.value = atoi(arg1);
+            e.durationMs = (uint32_t)strtoul(arg2, nullptr, 10);
+            if (e.value < 0 || e.value >= 32) ok = false;
+        } else if (strcmp(action, "set") == 0 && n >= 4) {
+            e.action = SCRIPT_SET;
+            e.name = arg1;
+            e.arg = arg2;
+        } else if (strcmp(action, "snap") == 0 && n >= 3) {
+            e.action = SCRIPT_SNAP;
+            e.name = arg1;
+            if (n >= 4) {
+                e.hasCrc = true;
+                e.crc = (uint32_t)strtoul(arg2, nullptr, 16);
+            }
+        } else if (strcmp(action, "end") == 0) {
+            e.action = SCRIPT_END;
+        } else {
+            ok = false;
+        }
+        if (ok) events.push_back(e);
+    }
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "%s:%u: bad event\n", path, lineNo);
+    }
+    return ok;
+}
+
+static bool installAssets(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    std::vector<uint8_t> blob;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        blob.insert(blob.end(), buf, buf + n);
+    }
+    fclose(f);
+    if (blob.empty() || QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(blob.data(), SYS_IMAGE_RESOURCES_ADDR, (uint32_t)blob.size()) != QSPI_W25Qxx_OK) {
+        fprintf(stderr, "cannot install %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void makeDefaultProfile(GamepadProfile& profile, uint8_t index)
+{
+    memset(&profile, 0, sizeof(profile));
+    snprintf(profile.id, sizeof(profile.id), "profile-%u", index);
+    snprintf(profile.name, sizeof(profile.name), "Profile-%u", index + 1);
+    profile.enabled = true;
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        profile.keysConfig.keysEnableTag[i] = true;
+    }
+
+    LEDProfile& led = profile.ledsConfigs;
+    led.ledEnabled = true;
+    led.ledEffect = LEDEffect::BREATHING;
+    led.ledColor1 = 0x00FF00;
+    led.ledColor2 = 0x0000FF;
+    led.ledBrightness = 75;
+    led.ledAnimationSpeed = 3;
+    led.aroundLedEnabled = true;
+    led.aroundLedEffect = AroundLEDEffect::AROUND_BREATHING;
+    led.aroundLedColor1 = 0xFF0000;
+    led.aroundLedColor2 = 0x0000FF;
+    led.aroundLedBrightness = 75;
+    led.aroundLedAnimationSpeed = 3;
+}
+
+/**
+ * @brief 按 ConfigUtils::load 的默认值填充配置，只保留屏幕模块会读写的部分
+ */
+static void setupStorage(const PreviewOptions& opts)
+{
+    Config& config = STORAGE_MANAGER.config;
+    memset(&config, 0, sizeof(config));
+    config.version = CONFIG_VERSION;
+    config.bootMode = BootMode::BOOT_MODE_INPUT;
+    config.inputMode = InputMode::INPUT_MODE_XINPUT;
+    config.numProfilesMax = opts.profiles;
+    strcpy(config.defaultProfileId, "profile-0");
+    for (uint8_t i = 0; i < opts.profiles; i++) {
+        GamepadProfile profile;
+        makeDefaultProfile(profile, i);
+        STORAGE_MANAGER.storeProfileAt(i, profile);
+    }
+
+    ScreenControlConfig& sc = config.screenControl;
+    sc.brightness = opts.brightness;
+    sc.standbyDisplay = opts.standby;
+    sc.backgroundColor = opts.bg;
+    sc.textColor = opts.text;
+    sc.featuresMask =
+        SCREEN_FEATURE_INPUT_MODE_SWITCH |
+        SCREEN_FEATURE_PROFILES_SWITCH |
+        SCREEN_FEATURE_SOCD_MODE_SWITCH |
+        SCREEN_FEATURE_TOURNAMENT_MODE_SWITCH |
+        SCREEN_FEATURE_LED_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_LED_EFFECT_SWITCH |
+        SCREEN_FEATURE_AMBIENT_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_AMBIENT_EFFECT_SWITCH |
+        SCREEN_FEATURE_SCREEN_BRIGHTNESS_ADJUST |
+        SCREEN_FEATURE_WEB_CONFIG_ENTRY |
+        SCREEN_FEATURE_CALIBRATION_MODE_SWITCH |
+        SCREEN_FEATURE_BUTTONS_PERFORMANCE_QUICK_SET |
+        SCREEN_FEATURE_INPUT_MONITOR;
+    for (uint32_t i = 0; i < SCREEN_FEATURE_COUNT; i++) {
+        sc.featuresOrder[i] = (uint8_t)i;
+    }
+}
+
+static uint32_t parseHex(const char* value)
+{
+    return (uint32_t)strtoul(value[0] == '#' ? value + 1 : value, nullptr, 16) & 0xFFFFFF;
+}
+
+/**
+ * @brief 运行中修改屏幕配置，与网页端修改后的行为一致
+ */
+static bool applySetting(const std::string& key, const std::string& value)
+{
+    ScreenControlConfig& sc = STORAGE_MANAGER.config.screenControl;
+    if (key == "standby") {
+        int v = parseEnum(value.c_str(), STANDBY_NAMES, 3);
+        if (v < 0) return false;
+        sc.standbyDisplay = (uint8_t)v;
+    } else if (key == "bg") {
+        sc.backgroundColor = parseHex(value.c_str());
+    } else if (key == "text") {
+        sc.textColor = parseHex(value.c_str());
+    } else if (key == "brightness") {
+        sc.brightness = (uint8_t)atoi(value.c_str());
+    } else if (key == "competition") {
+        GamepadProfile* p = STORAGE_MANAGER.getDefaultGamepadProfile();
+        if (!p) return false;
+        p->isCompetitionProfile = atoi(value.c_str()) != 0;
+    } else if (key == "tournament_screen_off") {
+        sc.tournamentScreenOff = atoi(value.c_str()) != 0 ? 1u : 0u;
+    } else {
+        return false;
+    }
+    // 与网页端一样经由 saveConfig 提交，屏幕据此得知配置已变化
+    STORAGE_MANAGER.saveConfig();
+    return true;
+}
+
+static uint32_t crc32(const uint8_t* data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief 保存面板快照，返回面板 RGB565 内容的 CRC32
+ */
+static uint32_t snapshot(const PreviewOptions& opts, const std::string& name)
+{
+    const uint16_t* panel = host_st7789_get_panel();
+    if (opts.outDir) {
+        HostImage image(ST7789_WIDTH, ST7789_HEIGHT);
+        for (uint32_t y = 0; y < ST7789_HEIGHT; y++) {
+            for (uint32_t x = 0; x < ST7789_WIDTH; x++) {
+                uint16_t c = panel[y * ST7789_WIDTH + x];
+                uint8_t r = (uint8_t)((c >> 11) & 0x1F);
+                uint8_t g = (uint8_t)((c >> 5) & 0x3F);
+                uint8_t b = (uint8_t)(c & 0x1F);
+                image.setPixel((int32_t)x, (int32_t)y, (uint8_t)((r << 3) | (r >> 2)), (uint8_t)((g << 2) | (g >> 4)), (uint8_t)((b << 3) | (b >> 2)));
+            }
+        }
+        std::string path = std::string(opts.outDir) + "/" + name + ".png";
+        if (!writePng(path.c_str(), image)) {
+            fprintf(stderr, "cannot write %s\n", path.c_str());
+        }
+    }
+    return crc32((const uint8_t*)panel, (size_t)ST7789_WIDTH * ST7789_HEIGHT * sizeof(uint16_t));
+}
+
+static uint32_t pressMaskAt(const std::vector<ScriptEvent>& events, uint32_t timeMs)
+{
+    uint32_t mask = 0;
+    for (const ScriptEvent& e : events) {
+        if (e.action == SCRIPT_PRESS && timeMs >= e.timeMs && timeMs < e.timeMs + e.durationMs) {
+            mask |= (1U << e.value);
+        }
+    }
+    return mask;
+}
+
+struct PerfSums {
+    uint64_t pre = 0, begin = 0, prep = 0, render = 0, flush = 0, px = 0;
+    uint32_t maxRender = 0, maxFlush = 0;
+};
+
+static PreviewOptions g_opts;
+static PerfSums g_sums;
+static uint32_t g_frames = 0;
+
+static void printSummary(void)
+{
+    uint32_t frames = 0, blocked = 0;
+    SPIScreenManager::getInstance().getLastFramePerf(&frames, &blocked);
+    uint32_t n = g_frames ? g_frames : 1;
+    printf("screen frames=%u blocked=%u avg us: pre=%llu begin=%llu prep=%llu render=%llu flush=%llu max us: render=%u flush=%u avg px=%llu dma2d=%u\n",
+        frames, blocked,
+        (unsigned long long)(g_sums.pre / n), (unsigned long long)(g_sums.begin / n), (unsigned long long)(g_sums.prep / n),
+        (unsigned long long)(g_sums.render / n), (unsigned long long)(g_sums.flush / n),
+        g_sums.maxRender, g_sums.maxFlush, (unsigned long long)(g_sums.px / n), host_dma2d_take_ops());
+}
+
+// 固件在进入网页配置/校准等模式时会复位，仿真到此为止
+static void onReset(void)
+{
+    printf("reset requested at %u ms\n", HAL_GetTick() - PREVIEW_START_TICK);
+    printSummary();
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    PreviewOptions& opts = g_opts;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool needsValue = true;
+
+        if (strcmp(arg, "--script") == 0 && value) {
+            opts.script = value;
+        } else if (strcmp(arg, "--out-dir") == 0 && value) {
+            opts.outDir = value;
+        } else if (strcmp(arg, "--assets") == 0 && value) {
+            opts.assets = value;
+        } else if (strcmp(arg, "--step") == 0 && value) {
+            opts.stepMs = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--duration") == 0 && value) {
+            opts.durationMs = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--bg") == 0 && value) {
+            opts.bg = parseHex(value);
+        } else if (strcmp(arg, "--text") == 0 && value) {
+            opts.text = parseHex(value);
+        } else if (strcmp(arg, "--brightness") == 0 && value) {
+            opts.brightness = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--standby") == 0 && value) {
+            int s = parseEnum(value, STANDBY_NAMES, 3);
+            if (s < 0) { fprintf(stderr, "unknown standby display: %s\n", value); return 2; }
+            opts.standby = (uint8_t)s;
+        } else if (strcmp(arg, "--profiles") == 0 && value) {
+            opts.profiles = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--budget-render-us") == 0 && value) {
+            opts.budgetRenderUs = (uint32_t)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--budget-flush-px") == 0 && value) {
+            opts.budgetFlushPx = (uint32_t)strtoul(value, nullptr, 10);
+        } else {
+            needsValue = false;
+            if (strcmp(arg, "--check-stale") == 0) {
+                opts.checkStale = true;
+            } else if (strcmp(arg, "--quiet") == 0) {
+                opts.quiet = true;
+            } else {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        if (needsValue) i++;
+    }
+
+    if (!opts.script || opts.stepMs == 0 || opts.profiles == 0 || opts.profiles > NUM_PROFILES) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<ScriptEvent> events;
+    if (!loadScript(opts.script, events)) {
+        return 2;
+    }
+    uint32_t endMs = opts.durationMs;
+    for (const ScriptEvent& e : events) {
+        uint32_t last = (e.action == SCRIPT_PRESS) ? e.timeMs + e.durationMs : e.timeMs;
+        if (e.action == SCRIPT_END) { endMs = e.timeMs; break; }
+        if (!opts.durationMs && last > endMs) endMs = last;
+    }
+    if (endMs == 0 || endMs > PREVIEW_MAX_TIME_MS) {
+        fprintf(stderr, "script has no events or runs past %u ms\n", PREVIEW_MAX_TIME_MS);
+        return 2;
+    }
+
+    if (opts.assets && !installAssets(opts.assets)) {
+        return 1;
+    }
+
+    setupStorage(opts);
+    host_sim_set_reset_handler(onReset);
+    host_sim_set_tick(PREVIEW_START_TICK);
+    SPIScreenManager::getInstance().setup();
+
+    size_t next = 0;
+    bool failed = false;
+    uint32_t lastFrames = 0;
+
+    for (uint32_t t = 0; t <= endMs; t += opts.stepMs) {
+        host_sim_set_tick(PREVIEW_START_TICK + t);
+
+        bool snapsDue = false;
+        for (; next < events.size() && events[next].timeMs <= t; next++) {
+            const ScriptEvent& e = events[next];
+            switch (e.action) {
+                case SCRIPT_TURN:   host_rotenc_turn((int16_t)e.value); break;
+                case SCRIPT_CLICK:  host_rotenc_click(); break;
+                case SCRIPT_LONG:   host_rotenc_long_press(); break;
+                case SCRIPT_SET:
+                    if (!applySetting(e.name, e.arg)) {
+                        fprintf(stderr, "unknown setting: %s %s\n", e.name.c_str(), e.arg.c_str());
+                        return 2;
+                    }
+                    break;
+                case SCRIPT_SNAP:   snapsDue = true; break;
+                default: break;
+            }
+            if (snapsDue) break;
+        }
+
+        host_input_set_button_mask(pressMaskAt(events, t));
+        uint32_t virtualPinMask = GPIO_BTNS_WORKER.read() | ADC_BTNS_WORKER.read();
+        INPUT_SNAPSHOT.publish(virtualPinMask, 0);
+        SPIScreenManager::getInstance().loop();
+
+        uint32_t frames = 0;
+        const SPIScreenPerf& perf = SPIScreenManager::getInstance().getLastFramePerf(&frames);
+        if (frames != lastFrames) {
+            lastFrames = frames;
+            uint32_t px = host_st7789_take_sent_pixels();
+            uint32_t rects = host_st7789_take_flush_rects();
+            g_frames++;
+            g_sums.pre += perf.preUs;
+            g_sums.begin += perf.frameBeginUs;
+            g_sums.prep += perf.prepUs;
+            g_sums.render += perf.renderUs;
+            g_sums.flush += perf.flushUs;
+            g_sums.px += px;
+            if (perf.renderUs > g_sums.maxRender) g_sums.maxRender = perf.renderUs;
+            if (perf.flushUs > g_sums.maxFlush) g_sums.maxFlush = perf.flushUs;
+            if (!opts.quiet) {
+                printf("t=%6u pre=%4u begin=%4u prep=%4u render=%5u flush=%4u px=%6u rects=%u\n",
+                    t, perf.preUs, perf.frameBeginUs, perf.prepUs, perf.renderUs, perf.flushUs, px, rects);
+            }
+            if (opts.checkStale) {
+                uint32_t stale = host_st7789_count_stale_pixels();
+                if (stale) {
+                    printf("t=%6u stale pixels=%u\n", t, stale);
+                    failed = true;
+                }
+            }
+        }
+
+        // 快照取本次 loop 之后的面板内容，同一时刻的其余事件留到下一步
+        while (snapsDue) {
+            const ScriptEvent& e = events[next];
+            uint32_t crc = snapshot(opts, e.name);
+            bool match = !e.hasCrc || crc == e.crc;
+            printf("snap %s crc=%08x backlight=%u%s\n", e.name.c_str(), crc, (unsigned)host_st7789_get_backlight(), match ? "" : " MISMATCH");
+            if (!match) failed = true;
+            next++;
+            snapsDue = next < events.size() && events[next].action == SCRIPT_SNAP && events[next].timeMs <= t;
+        }
+    }
+
+    printSummary();
+
+    if (opts.budgetRenderUs && g_frames && g_sums.render / g_frames > opts.budgetRenderUs) {
+        printf("render budget exceeded: %llu > %u us\n", (unsigned long long)(g_sums.render / g_frames), opts.budgetRenderUs);
+        failed = true;
+    }
+    if (opts.budgetFlushPx && g_frames && g_sums.px / g_frames > opts.budgetFlushPx) {
+        printf("flush budget exceeded: %llu > %u px\n", (unsigned long long)(g_sums.px / g_frames), opts.budgetFlushPx);
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}
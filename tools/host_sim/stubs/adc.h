@@ -0,0 +1,26 @@
+/* 主机端仿真用的 adc.h 替身：ADC 采样由 host_input.cpp 替代，只保留句柄声明 */
+#ifndef __HOST_SIM_ADC_H__
+#define __HOST_SIM_ADC_H__
+
+#include "stm32h7xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern ADC_HandleTypeDef hadc1;
+extern ADC_HandleTypeDef hadc2;
+extern ADC_HandleTypeDef hadc3;
+
+typedef enum {
+    ADC_MODE_LOW_LATENCY = 0,
+    ADC_MODE_CONTINUOUS = 1
+} ADC_SamplingMode;
+
+void ADC_SetMode(ADC_SamplingMode mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_ADC_H__ */
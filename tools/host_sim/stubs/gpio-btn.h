@@ -0,0 +1,20 @@
+/* 主机端仿真用的 gpio-btn.h 替身：GPIO 按键状态由 host_input.cpp 提供 */
+#ifndef __HOST_SIM_GPIO_BTN_H__
+#define __HOST_SIM_GPIO_BTN_H__
+
+#include "stm32h7xx_hal.h"
+#include <stdbool.h>
+#include "board_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void GPIO_Btns_Init(void);
+void GPIO_Btns_Iterate( void (*callback)(uint8_t virtualPin, bool isPressed, uint8_t idx) );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_GPIO_BTN_H__ */
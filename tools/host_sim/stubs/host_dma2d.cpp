@@ -0,0 +1,125 @@
+/*
+ * 主机端仿真：ST7789 DMA2D 后端替身
+ * 提交的传输先挂起，直到 Sync 范围重叠、Wait 或第二次新的提交时才由软件执行，期间 IsBusy 为 true。
+ * 这样绘图代码漏掉同步时，读到的是传输前的内容，会表现为快照 CRC 变化或脏区漏报；
+ * 挂起后的第一次新提交被拒绝，走 CPU 回退路径。
+ */
+#include "st7789_dma2d.h"
+#include <string.h>
+
+struct HostDma2dOp {
+    bool active;
+    bool fill;
+    uint16_t* dst;
+    uint16_t dstStride;
+    const uint8_t* src;
+    uint32_t srcStride;
+    uint16_t w;
+    uint16_t h;
+    uint16_t value;
+    ST7789_BitmapFormat format;
+    bool rejected;      // 挂起期间已经拒绝过一次提交
+};
+
+static HostDma2dOp g_op;
+static uint32_t g_ops = 0;
+
+static uintptr_t host_dma2d_span_end(const void* base, uint32_t strideBytes, uint32_t rowBytes, uint16_t h)
+{
+    return (uintptr_t)base + (uintptr_t)strideBytes * (uint32_t)(h - 1u) + rowBytes;
+}
+
+static uint16_t host_dma2d_pixel(const uint8_t* p, ST7789_BitmapFormat format)
+{
+    uint16_t c;
+    if (format == ST7789_BITMAP_RGB565_BE) return (uint16_t)(p[0] | (p[1] << 8));
+    if (format == ST7789_BITMAP_RGB565_LE) c = (uint16_t)(p[0] | (p[1] << 8));
+    else c = (uint16_t)(((p[0] & 0xF8u) << 8) | ((p[1] & 0xFCu) << 3) | (p[2] >> 3));
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+static void host_dma2d_run(void)
+{
+    if (!g_op.active) return;
+    const uint32_t bpp = (g_op.format == ST7789_BITMAP_RGB888) ? 3u : 2u;
+    for (uint16_t y = 0; y < g_op.h; y++) {
+        uint16_t* d = g_op.dst + (uint32_t)y * g_op.dstStride;
+        if (g_op.fill) {
+            for (uint16_t x = 0; x < g_op.w; x++) d[x] = g_op.value;
+            continue;
+        }
+        const uint8_t* s = g_op.src + (size_t)y * g_op.srcStride;
+        for (uint16_t x = 0; x < g_op.w; x++) d[x] = host_dma2d_pixel(s + (size_t)x * bpp, g_op.format);
+    }
+    g_op.active = false;
+    g_ops++;
+}
+
+/* 模拟硬件忙：挂起的传输拒绝第一次新提交，之后视为已完成 */
+static bool host_dma2d_busy_for_submit(void)
+{
+    if (!g_op.active) return false;
+    if (!g_op.rejected) {
+        g_op.rejected = true;
+        return true;
+    }
+    host_dma2d_run();
+    return false;
+}
+
+extern "C" void ST7789_DMA2D_Init(void)
+{
+    memset(&g_op, 0, sizeof(g_op));
+}
+
+extern "C" bool ST7789_DMA2D_IsBusy(void)
+{
+    return g_op.active;
+}
+
+extern "C" void ST7789_DMA2D_Wait(void)
+{
+    host_dma2d_run();
+}
+
+extern "C" void ST7789_DMA2D_Sync(const void* addr, uint32_t bytes)
+{
+    if (!g_op.active || bytes == 0) return;
+    uintptr_t lo = (uintptr_t)addr & ~(uintptr_t)31u;
+    uintptr_t hi = ((uintptr_t)addr + bytes + 31u) & ~(uintptr_t)31u;
+    uintptr_t dlo = (uintptr_t)g_op.dst & ~(uintptr_t)31u;
+    uintptr_t dhi = host_dma2d_span_end(g_op.dst, (uint32_t)g_op.dstStride * 2u, (uint32_t)g_op.w * 2u, g_op.h);
+    bool hit = lo < dhi && dlo < hi;
+    if (!g_op.fill) {
+        uintptr_t slo = (uintptr_t)g_op.src & ~(uintptr_t)31u;
+        uintptr_t shi = host_dma2d_span_end(g_op.src, g_op.srcStride, (uint32_t)g_op.w * ((g_op.format == ST7789_BITMAP_RGB888) ? 3u : 2u), g_op.h);
+        hit = hit || (lo < shi && slo < hi);
+    }
+    if (hit) host_dma2d_run();
+}
+
+extern "C" bool ST7789_DMA2D_Fill(uint16_t* dst, uint16_t dst_stride, uint16_t w, uint16_t h, uint16_t value)
+{
+    if (!dst || w == 0 || h == 0 || host_dma2d_busy_for_submit()) return false;
+    g_op = HostDma2dOp{true, true, dst, dst_stride, nullptr, 0, w, h, value, ST7789_BITMAP_RGB565_BE, false};
+    return true;
+}
+
+extern "C" bool ST7789_DMA2D_Copy(uint16_t* dst, uint16_t dst_stride, const void* src, uint32_t src_stride_bytes, uint16_t w, uint16_t h, ST7789_BitmapFormat format)
+{
+    if (!dst || !src || w == 0 || h == 0) return false;
+    if (format == ST7789_BITMAP_ARGB8888) return false;
+    const uint32_t bpp = (format == ST7789_BITMAP_RGB888) ? 3u : 2u;
+    if (src_stride_bytes % bpp != 0 || src_stride_bytes / bpp < w) return false;
+    if (format != ST7789_BITMAP_RGB565_BE && ((w & 1u) != 0 || ((uintptr_t)dst & 3u) != 0)) return false;
+    if (host_dma2d_busy_for_submit()) return false;
+    g_op = HostDma2dOp{true, false, dst, dst_stride, (const uint8_t*)src, src_stride_bytes, w, h, 0, format, false};
+    return true;
+}
+
+extern "C" uint32_t host_dma2d_take_ops(void)
+{
+    uint32_t n = g_ops;
+    g_ops = 0;
+    return n;
+}
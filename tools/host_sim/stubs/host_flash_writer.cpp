@@ -0,0 +1,123 @@
+/*
+ * 主机端仿真：FlashWriter 替身
+ * 没有后台队列，擦写立即作用在 host_qspi.cpp 的模拟 flash 上；
+ * 编程按 NOR flash 的规则只能把 1 写成 0，便于发现文件系统漏擦的情况。
+ * host_flash_cut_after 模拟掉电：断电的那一次擦写只作用到前一部分字节，之后的擦写都失败
+ */
+#include "flash_writer.hpp"
+#include "host_sim.h"
+#include <cstring>
+
+#define HOST_FLASH_WRITER_SIZE      0x00800000
+
+static uint32_t g_cut_ops = 0;          // 还能完成的擦写次数，0 表示不断电
+static uint32_t g_cut_partial = 0;
+static bool g_cut = false;
+static uint32_t g_erases = 0;
+static uint32_t g_programs = 0;
+
+extern "C" void host_flash_cut_after(uint32_t ops, uint32_t partial)
+{
+    g_cut_ops = ops;
+    g_cut_partial = partial;
+    g_cut = false;
+}
+
+extern "C" bool host_flash_is_cut(void)
+{
+    return g_cut;
+}
+
+extern "C" uint32_t host_flash_take_erases(void)
+{
+    const uint32_t n = g_erases;
+    g_erases = 0;
+    return n;
+}
+
+extern "C" uint32_t host_flash_take_programs(void)
+{
+    const uint32_t n = g_programs;
+    g_programs = 0;
+    return n;
+}
+
+/**
+ * @brief 计入一次擦写；返回这次能作用到的字节数，断电后为 0
+ */
+static uint32_t host_flash_begin_op(uint32_t len)
+{
+    if (g_cut) return 0;
+    if (g_cut_ops > 0 && --g_cut_ops == 0) {
+        g_cut = true;
+        return g_cut_partial < len ? g_cut_partial : len;
+    }
+    return len;
+}
+
+bool FlashWriter::erase(uint32_t addr)
+{
+    uint8_t blank[W25Qxx_SECTOR_SIZE];
+    memset(blank, 0xFF, sizeof(blank));
+    addr = (addr & (HOST_FLASH_WRITER_SIZE - 1)) & ~(uint32_t)(W25Qxx_SECTOR_SIZE - 1);
+    const uint32_t len = host_flash_begin_op(sizeof(blank));
+    if (len > 0) g_erases++;
+    if (len < sizeof(blank)) {
+        if (len > 0) QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(blank, addr, len);
+        failed = true;
+        return false;
+    }
+    if (QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(blank, addr, sizeof(blank)) != QSPI_W25Qxx_OK) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool FlashWriter::program(uint32_t addr, const void* data, uint16_t len)
+{
+    if (len == 0 || (addr % W25Qxx_PageSize) + len > W25Qxx_PageSize) {
+        return false;
+    }
+    uint8_t page[W25Qxx_PageSize];
+    if (QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(page, addr, len) != QSPI_W25Qxx_OK) {
+        failed = true;
+        return false;
+    }
+    const uint8_t* src = (const uint8_t*)data;
+    for (uint16_t i = 0; i < len; i++) {
+        page[i] &= src[i];
+    }
+    const uint32_t done = host_flash_begin_op(len);
+    if (done > 0) g_programs++;
+    if (done < len) {
+        if (done > 0) QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(page, addr, done);
+        failed = true;
+        return false;
+    }
+    if (QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(page, addr, len) != QSPI_W25Qxx_OK) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool FlashWriter::read(uint32_t addr, void* out, uint32_t len)
+{
+    return QSPI_W25Qxx_ReadBuffer_WithXIPOrNot((uint8_t*)out, addr, len) == QSPI_W25Qxx_OK;
+}
+
+bool FlashWriter::flush()
+{
+    const bool ok = !failed;
+    failed = false;
+    return ok;
+}
+
+void FlashWriter::poll()
+{
+}
+
+void FlashWriter::onSof()
+{
+}
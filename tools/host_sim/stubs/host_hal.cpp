@@ -0,0 +1,57 @@
+/*
+ * 主机端仿真：HAL 时钟、复位与 Core/Src/utils.c 中 LED 模块用到的工具函数
+ */
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+#include <stdlib.h>
+
+GPIO_TypeDef host_sim_gpio[11];
+RTC_TypeDef host_sim_rtc;
+
+bool g_has_led_around = true;
+
+static uint32_t g_host_tick = 0;
+static void (*g_host_reset_handler)(void) = nullptr;
+
+extern "C" uint32_t HAL_GetTick(void)
+{
+    return g_host_tick;
+}
+
+extern "C" void HAL_Delay(uint32_t delay)
+{
+    g_host_tick += delay;
+}
+
+extern "C" void host_sim_set_tick(uint32_t tick)
+{
+    g_host_tick = tick;
+}
+
+extern "C" void host_sim_set_reset_handler(void (*handler)(void))
+{
+    g_host_reset_handler = handler;
+}
+
+extern "C" void NVIC_SystemReset(void)
+{
+    if (g_host_reset_handler) {
+        g_host_reset_handler();
+    }
+    fprintf(stderr, "[host_hal] NVIC_SystemReset at tick %u\n", g_host_tick);
+    exit(0);
+}
+
+extern "C" uint32_t RGBToHex(uint8_t red, uint8_t green, uint8_t blue)
+{
+    return ((uint32_t)red << 16) | ((uint32_t)green << 8) | blue;
+}
+
+extern "C" struct RGBColor hexToRGB(uint32_t color)
+{
+    struct RGBColor c;
+    c.r = (uint8_t)((color >> 16) & 0xFF);
+    c.g = (uint8_t)((color >> 8) & 0xFF);
+    c.b = (uint8_t)(color & 0xFF);
+    return c;
+}
@@ -0,0 +1,131 @@
+/*
+ * 主机端仿真：输入与计时相关单例的替身
+ * ADC / GPIO 按键不做采样，按仿真器设置的虚拟引脚掩码返回状态；
+ * MicrosTimer 使用主机单调时钟，屏幕模块的各阶段耗时即为主机上的实际耗时
+ */
+#include "adc_btns/adc_btns_worker.hpp"
+#include "adc_btns/adc_calibration.hpp"
+#include "adc_btns/adc_manager.hpp"
+#include "gpio_btns/gpio_btns_worker.hpp"
+#include "micro_timer.hpp"
+#include "host_sim.h"
+#include <time.h>
+
+ADC_HandleTypeDef hadc1;
+ADC_HandleTypeDef hadc2;
+ADC_HandleTypeDef hadc3;
+
+static uint32_t g_host_button_mask = 0;
+
+extern "C" void host_input_set_button_mask(uint32_t mask)
+{
+    g_host_button_mask = mask;
+}
+
+extern "C" void ADC_SetMode(ADC_SamplingMode mode)
+{
+    (void)mode;
+}
+
+ADCBtnsWorker::ADCBtnsWorker()
+{
+}
+
+ADCBtnsWorker::~ADCBtnsWorker()
+{
+}
+
+ADCBtnsError ADCBtnsWorker::setup()
+{
+    return ADCBtnsError::SUCCESS;
+}
+
+uint32_t ADCBtnsWorker::read()
+{
+    virtualPinMask = g_host_button_mask;
+    return virtualPinMask;
+}
+
+// 没有映射与按键数据：输入监视页按按下状态显示
+ADCBtn* ADCBtnsWorker::getButtonState(uint8_t buttonIndex) const
+{
+    (void)buttonIndex;
+    return nullptr;
+}
+
+const ADCValuesMapping* ADCBtnsWorker::getCurrentMapping() const
+{
+    return nullptr;
+}
+
+float ADCBtnsWorker::getDistanceByValue(ADCBtn* btn, const uint16_t adcValue) const
+{
+    (void)btn;
+    (void)adcValue;
+    return 0.0f;
+}
+
+GPIOBtnsWorker* GPIOBtnsWorker::instance_ = nullptr;
+
+GPIOBtnsWorker::GPIOBtnsWorker()
+{
+}
+
+GPIOBtnsWorker::~GPIOBtnsWorker()
+{
+}
+
+void GPIOBtnsWorker::setup()
+{
+}
+
+uint32_t GPIOBtnsWorker::read()
+{
+    return virtualPinMask;
+}
+
+ADCManager::ADCManager()
+{
+}
+
+ADCManager::~ADCManager()
+{
+}
+
+void ADCManager::setADCMode(ADC_SamplingMode mode)
+{
+    adcMode = mode;
+}
+
+ADC_SamplingMode ADCManager::getADCMode() const
+{
+    return adcMode;
+}
+
+ADCCalibrationManager::ADCCalibrationManager()
+{
+}
+
+ADCCalibrationManager::~ADCCalibrationManager()
+{
+}
+
+ADCBtnsError ADCCalibrationManager::resetAllCalibration()
+{
+    return ADCBtnsError::SUCCESS;
+}
+
+MicrosTimer::MicrosTimer() : overflowCount(0)
+{
+}
+
+uint32_t MicrosTimer::micros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull);
+}
+
+void MicrosTimer::reset()
+{
+}
@@ -0,0 +1,17 @@
+/*
+ * 主机端仿真：配置文件 JSON 转换替身
+ * config.cpp 导入导出 JSON 时用到，仿真工具不经过这条路径
+ */
+#include "configs/websocket_command_handler.hpp"
+
+cJSON* ProfileCommandHandler::buildProfileJSON(GamepadProfile* profile)
+{
+    (void)profile;
+    return nullptr;
+}
+
+void ProfileCommandHandler::parseProfileJSON(cJSON* profileJSON, GamepadProfile* targetProfile)
+{
+    (void)profileJSON;
+    (void)targetProfile;
+}
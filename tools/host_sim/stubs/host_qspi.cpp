@@ -0,0 +1,93 @@
+/*
+ * 主机端仿真：QSPI Flash 替身
+ * 以内存模拟 8MB W25Q64，上电为擦除状态（0xFF）；地址与真实驱动一样只取低位偏移，
+ * 因此 0x90xxxxxx 形式的映射地址可以直接使用。
+ * 模拟区优先映射到真实的 XIP 地址 0x90000000，使资源包、背景图等按映射地址直接读取的代码
+ * 在主机上同样可用；该地址被占用时退回普通数组，此时只能通过读写接口访问。
+ * 映射是共享的：掉电回放每次上电 fork 一个子进程，flash 内容在进程之间保留
+ */
+#include "qspi-w25q64.h"
+#include "host_sim.h"
+#include <cstring>
+#include <cstdio>
+#include <sys/mman.h>
+
+#define HOST_QSPI_FLASH_SIZE    0x00800000
+#define HOST_QSPI_XIP_BASE      0x90000000UL
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE     0x100000
+#endif
+
+static uint8_t g_host_flash_fallback[HOST_QSPI_FLASH_SIZE];
+static uint8_t* g_host_flash = nullptr;
+
+static uint8_t* host_qspi_flash(void)
+{
+    if (g_host_flash) {
+        return g_host_flash;
+    }
+    void* p = mmap((void*)HOST_QSPI_XIP_BASE, HOST_QSPI_FLASH_SIZE, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p == (void*)HOST_QSPI_XIP_BASE) {
+        g_host_flash = (uint8_t*)p;
+    } else {
+        if (p != MAP_FAILED) munmap(p, HOST_QSPI_FLASH_SIZE);
+        fprintf(stderr, "[host_qspi] 0x%08lX unavailable, memory-mapped reads disabled\n", HOST_QSPI_XIP_BASE);
+        g_host_flash = g_host_flash_fallback;
+    }
+    memset(g_host_flash, 0xFF, HOST_QSPI_FLASH_SIZE);
+    return g_host_flash;
+}
+
+// 启动时即建立映射：资源包等代码不经过读写接口，直接按映射地址访问
+static uint8_t* const g_host_flash_init = host_qspi_flash();
+
+extern "C" bool host_qspi_is_mapped(void)
+{
+    return host_qspi_flash() != g_host_flash_fallback;
+}
+
+static bool host_qspi_range(uint32_t& addr, uint32_t length)
+{
+    addr &= (HOST_QSPI_FLASH_SIZE - 1);
+    return (uint64_t)addr + length <= HOST_QSPI_FLASH_SIZE;
+}
+
+extern "C" int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite)
+{
+    if (!host_qspi_range(WriteAddr, NumByteToWrite)) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    memcpy(host_qspi_flash() + WriteAddr, pData, NumByteToWrite);
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+    if (!host_qspi_range(ReadAddr, NumByteToRead)) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    memcpy(pBuffer, host_qspi_flash() + ReadAddr, NumByteToRead);
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void)
+{
+    return (host_qspi_flash() == (uint8_t*)HOST_QSPI_XIP_BASE) ? QSPI_W25Qxx_OK : W25Qxx_ERROR_TRANSMIT;
+}
+
+extern "C" bool QSPI_W25Qxx_IsMemoryMappedMode(void)
+{
+    return host_qspi_flash() == (uint8_t*)HOST_QSPI_XIP_BASE;
+}
+
+// 主机端没有间接模式会话：映射可用就立即执行，否则放弃
+extern "C" bool QSPI_W25Qxx_RunWhenMapped(QSPI_W25Qxx_MappedCallback callback, void* context)
+{
+    if (!QSPI_W25Qxx_IsMemoryMappedMode()) {
+        return false;
+    }
+    callback(context);
+    return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * 主机端仿真：旋转编码器替身
+ * 仿真器注入的旋转与按键事件在 RotEnc_Update 时生效，随后由 Get/Was 接口各消费一次；
+ * 旋转按每次 Update 一格释放，与手动旋转时每帧最多一格的节奏一致
+ */
+#include "rotary-encoder.h"
+#include "host_sim.h"
+
+static int16_t g_pending_detents = 0;
+static bool g_pending_click = false;
+static bool g_pending_long = false;
+
+static int16_t g_detents = 0;
+static bool g_clicked = false;
+static bool g_long_pressed = false;
+
+extern "C" void host_rotenc_turn(int16_t detents) { g_pending_detents = (int16_t)(g_pending_detents + detents); }
+extern "C" void host_rotenc_click(void) { g_pending_click = true; }
+extern "C" void host_rotenc_long_press(void) { g_pending_long = true; }
+
+extern "C" void RotEnc_Init(void)
+{
+    g_pending_detents = g_detents = 0;
+    g_pending_click = g_clicked = false;
+    g_pending_long = g_long_pressed = false;
+}
+
+extern "C" void RotEnc_Update(void)
+{
+    if (g_pending_detents > 0) {
+        g_detents++;
+        g_pending_detents--;
+    } else if (g_pending_detents < 0) {
+        g_detents--;
+        g_pending_detents++;
+    }
+    g_clicked = g_clicked || g_pending_click;
+    g_long_pressed = g_long_pressed || g_pending_long;
+    g_pending_click = false;
+    g_pending_long = false;
+}
+
+extern "C" void RotEnc_OnEdgeIRQ(void) {}
+
+extern "C" bool RotEnc_HasPendingInput(void)
+{
+    return g_pending_detents != 0 || g_pending_click || g_pending_long || g_detents != 0 || g_clicked || g_long_pressed;
+}
+
+extern "C" int16_t RotEnc_GetDelta(void)
+{
+    return (int16_t)(RotEnc_GetDetentDelta() * ROTENC_STEPS_PER_DETENT);
+}
+
+extern "C" int8_t RotEnc_GetDetentDelta(void)
+{
+    int16_t d = g_detents;
+    if (d > 127) d = 127;
+    if (d < -128) d = -128;
+    g_detents = (int16_t)(g_detents - d);
+    return (int8_t)d;
+}
+
+extern "C" bool RotEnc_IsButtonDown(void) { return false; }
+extern "C" bool RotEnc_WasButtonPressed(void) { return false; }
+extern "C" bool RotEnc_WasButtonReleased(void) { return false; }
+
+extern "C" bool RotEnc_WasButtonClicked(void)
+{
+    bool v = g_clicked;
+    g_clicked = false;
+    return v;
+}
+
+extern "C" bool RotEnc_WasButtonLongPressed(void)
+{
+    bool v = g_long_pressed;
+    g_long_pressed = false;
+    return v;
+}
@@ -0,0 +1,52 @@
+/*
+ * 主机端仿真接口
+ * 供仿真工具读取替身驱动的输出状态
+ */
+#ifndef __HOST_SIM_H__
+#define __HOST_SIM_H__
+
+#include "stm32h7xx_hal.h"
+#include "utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* WS2812B：返回按亮度缩放后的实际输出颜色（与 LEDDataToDMABuffer 的计算一致） */
+struct RGBColor host_ws2812b_get_output(uint16_t index);
+bool host_ws2812b_is_running(void);
+
+/* ST7789：面板显存（RGB565，主机字节序，ST7789_WIDTH * ST7789_HEIGHT） */
+const uint16_t* host_st7789_get_panel(void);
+/* 返回并清零自上次调用以来 SPI 发送的像素数（刷新 + 填充） */
+uint32_t host_st7789_take_sent_pixels(void);
+uint32_t host_st7789_take_flush_rects(void);
+uint8_t host_st7789_get_backlight(void);
+/* 比较面板与最近一次刷新所用的帧缓冲，返回不一致的像素数（脏区漏报时不为 0） */
+uint32_t host_st7789_count_stale_pixels(void);
+/* DMA2D 替身：返回并清零已执行的传输次数 */
+uint32_t host_dma2d_take_ops(void);
+
+/* 旋转编码器：事件在下一次 RotEnc_Update 后可见 */
+void host_rotenc_turn(int16_t detents);
+void host_rotenc_click(void);
+void host_rotenc_long_press(void);
+
+/* 游戏按键：按虚拟引脚位设置当前按下状态 */
+void host_input_set_button_mask(uint32_t mask);
+
+/* QSPI flash：模拟区映射在 0x90000000 时为共享映射，fork 出的子进程写入后父进程可见 */
+bool host_qspi_is_mapped(void);
+
+/* FlashWriter 断电：再完成 ops 次擦写后断电，断电的那一次只作用到前 partial 字节，之后的擦写全部失败；ops 为 0 时不断电 */
+void host_flash_cut_after(uint32_t ops, uint32_t partial);
+bool host_flash_is_cut(void);
+/* 返回并清零已执行的擦除 / 页编程次数 */
+uint32_t host_flash_take_erases(void);
+uint32_t host_flash_take_programs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_H__ */
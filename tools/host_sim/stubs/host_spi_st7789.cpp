@@ -0,0 +1,138 @@
+/*
+ * 主机端仿真：ST7789 SPI 传输层替身
+ * 面板显存为内存数组，刷新与填充立即完成，SPIST7789_IsBusy 恒为 false；
+ * 统计发送的像素数，便于评估脏区合并的效果
+ */
+#include "spi-st7789.h"
+#include "board_cfg.h"
+#include "host_sim.h"
+
+static uint16_t g_panel[ST7789_WIDTH * ST7789_HEIGHT];
+static const uint16_t* g_last_fb = nullptr;
+static uint16_t g_last_fb_stride = 0;
+static uint32_t g_sent_pixels = 0;
+static uint32_t g_flush_rects = 0;
+static uint8_t g_backlight = 0;
+
+static bool host_st7789_clip(uint16_t x, uint16_t y, uint16_t& w, uint16_t& h)
+{
+    if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT || w == 0 || h == 0) return false;
+    if (x + w > ST7789_WIDTH) w = (uint16_t)(ST7789_WIDTH - x);
+    if (y + h > ST7789_HEIGHT) h = (uint16_t)(ST7789_HEIGHT - y);
+    return true;
+}
+
+extern "C" void SPIST7789_Init(void)
+{
+    for (uint32_t i = 0; i < ST7789_WIDTH * ST7789_HEIGHT; i++) g_panel[i] = 0;
+}
+
+extern "C" void SPIST7789_SetBacklight100(void)
+{
+    g_backlight = 100;
+}
+
+extern "C" void SPIST7789_SetBacklight(uint8_t percent)
+{
+    g_backlight = percent > 100 ? 100 : percent;
+}
+
+extern "C" bool SPIST7789_FillRectColor565Async(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color565)
+{
+    if (!host_st7789_clip(x, y, w, h)) return false;
+    for (uint16_t r = 0; r < h; r++) {
+        uint16_t* row = &g_panel[(uint32_t)(y + r) * ST7789_WIDTH + x];
+        for (uint16_t c = 0; c < w; c++) row[c] = color565;
+    }
+    g_sent_pixels += (uint32_t)w * h;
+    return true;
+}
+
+extern "C" bool SPIST7789_FillBlueAsync(void)
+{
+    return SPIST7789_FillRectColor565Async(0, 0, ST7789_WIDTH, ST7789_HEIGHT, 0x001Fu);
+}
+
+extern "C" bool SPIST7789_FlushRectsAsync(const uint16_t* fb, uint16_t fb_stride, const SPIST7789_Rect* rects, uint8_t count)
+{
+    if (!fb || !rects || count == 0) return false;
+    g_last_fb = fb;
+    g_last_fb_stride = fb_stride;
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t w = rects[i].w, h = rects[i].h;
+        if (!host_st7789_clip(rects[i].x, rects[i].y, w, h)) continue;
+        for (uint16_t r = 0; r < h; r++) {
+            const uint16_t* src = &fb[(uint32_t)(rects[i].y + r) * fb_stride + rects[i].x];
+            uint16_t* dst = &g_panel[(uint32_t)(rects[i].y + r) * ST7789_WIDTH + rects[i].x];
+            // 帧缓冲按面板字节序存放
+            for (uint16_t c = 0; c < w; c++) dst[c] = (uint16_t)((src[c] >> 8) | (src[c] << 8));
+        }
+        g_sent_pixels += (uint32_t)w * h;
+        g_flush_rects++;
+    }
+    return true;
+}
+
+extern "C" bool SPIST7789_FlushRectAsync(const uint16_t* fb, uint16_t fb_stride, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    SPIST7789_Rect r = {x, y, w, h};
+    return SPIST7789_FlushRectsAsync(fb, fb_stride, &r, 1);
+}
+
+extern "C" bool SPIST7789_WaitDone(uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    return true;
+}
+
+extern "C" bool SPIST7789_IsBusy(void) { return false; }
+extern "C" void SPIST7789_DMA_IRQHandler(void) {}
+extern "C" void SPIST7789_SPI_IRQHandler(void) {}
+extern "C" void SPIST7789_Service(void) {}
+extern "C" void SPIST7789_OnSpiTxCplt(SPI_HandleTypeDef* hspi) { (void)hspi; }
+extern "C" bool SPIST7789_ConsumeDmaIrqFlag(void) { return false; }
+extern "C" bool SPIST7789_ConsumeDmaDoneFlag(void) { return false; }
+extern "C" bool SPIST7789_ConsumeDmaErrFlag(void) { return false; }
+
+extern "C" void SPIST7789_GetDebug(uint32_t* out_ndtr, uint32_t* out_dma_cr, uint32_t* out_dma_isr, uint32_t* out_spi_sr, uint32_t* out_spi_cfg1, uint32_t* out_spi_cr1, uint32_t* out_spi_cr2)
+{
+    uint32_t* outs[] = {out_ndtr, out_dma_cr, out_dma_isr, out_spi_sr, out_spi_cfg1, out_spi_cr1, out_spi_cr2};
+    for (uint32_t* o : outs) if (o) *o = 0;
+}
+
+extern "C" const uint16_t* host_st7789_get_panel(void)
+{
+    return g_panel;
+}
+
+extern "C" uint32_t host_st7789_take_sent_pixels(void)
+{
+    uint32_t n = g_sent_pixels;
+    g_sent_pixels = 0;
+    return n;
+}
+
+extern "C" uint32_t host_st7789_take_flush_rects(void)
+{
+    uint32_t n = g_flush_rects;
+    g_flush_rects = 0;
+    return n;
+}
+
+extern "C" uint8_t host_st7789_get_backlight(void)
+{
+    return g_backlight;
+}
+
+extern "C" uint32_t host_st7789_count_stale_pixels(void)
+{
+    if (!g_last_fb) return 0;
+    uint32_t stale = 0;
+    for (uint32_t y = 0; y < ST7789_HEIGHT; y++) {
+        for (uint32_t x = 0; x < ST7789_WIDTH; x++) {
+            uint16_t v = g_last_fb[y * g_last_fb_stride + x];
+            if (g_panel[y * ST7789_WIDTH + x] != (uint16_t)((v >> 8) | (v << 8))) stale++;
+        }
+    }
+    return stale;
+}
@@ -0,0 +1,142 @@
+/*
+ * 主机端仿真：Storage 替身
+ * 配置只存在于内存中，由仿真工具在启动时填充；saveConfig / requestSave 不做任何持久化
+ * 配置文件全部常驻内存，不经过缓存；名片在保存时同步，与固件一致
+ */
+#include "storagemanager.hpp"
+
+static GamepadProfile g_profiles[NUM_PROFILES];
+
+static Storage::DefaultProfileChangedCallback g_defaultProfileChangedCbs[8] = {0};
+static uint8_t g_defaultProfileChangedCbCount = 0;
+
+void Storage::initConfig() {
+}
+
+bool Storage::saveConfig() {
+    return saveConfig(CONFIG_SECTION_ALL);
+}
+
+void Storage::syncProfileHeaders() {
+    for (uint8_t i = 0; i < NUM_PROFILES; i++) {
+        memcpy(&config.profiles[i], &g_profiles[i], sizeof(GamepadProfileHeader));
+    }
+}
+
+bool Storage::saveConfig(ConfigSectionMask sections) {
+    (void)sections;
+    syncProfileHeaders();
+    configRevision++;
+    pendingSections = 0;
+    return true;
+}
+
+void Storage::requestSave(ConfigSectionMask sections) {
+    (void)sections;
+    syncProfileHeaders();
+    configRevision++;
+}
+
+void Storage::loop() {
+}
+
+ConfigSectionMask Storage::getProfileSections(const GamepadProfile* profile, bool leds) {
+    if (profile < g_profiles || profile >= g_profiles + NUM_PROFILES) {
+        return CONFIG_SECTION_ALL;
+    }
+    const uint8_t i = (uint8_t)(profile - g_profiles);
+    return leds ? CONFIG_SECTION_PROFILE_LEDS(i) : CONFIG_SECTION_PROFILE(i);
+}
+
+GamepadProfile* Storage::getProfileAt(uint8_t index) {
+    return index < NUM_PROFILES ? &g_profiles[index] : nullptr;
+}
+
+bool Storage::storeProfileAt(uint8_t index, const GamepadProfile& profile) {
+    if (index >= NUM_PROFILES) return false;
+    if (&g_profiles[index] != &profile) {
+        g_profiles[index] = profile;
+    }
+    memcpy(&config.profiles[index], &profile, sizeof(GamepadProfileHeader));
+    configRevision++;
+    return true;
+}
+
+void Storage::moveProfile(uint8_t from, uint8_t to) {
+    if (from >= NUM_PROFILES || to >= NUM_PROFILES || from == to) return;
+    const GamepadProfile moved = g_profiles[from];
+    const uint8_t profileSlot = config.profileSlots[from];
+    const int8_t dir = from < to ? 1 : -1;
+    for (uint8_t i = from; i != to; i = (uint8_t)(i + dir)) {
+        g_profiles[i] = g_profiles[i + dir];
+        config.profileSlots[i] = config.profileSlots[i + dir];
+    }
+    g_profiles[to] = moved;
+    config.profileSlots[to] = profileSlot;
+    syncProfileHeaders();
+    configRevision++;
+}
+
+int8_t Storage::findProfileIndex(const char* id) const {
+    if (!id) return -1;
+    for (uint8_t i = 0; i < config.numProfilesMax && i < NUM_PROFILES; i++) {
+        if (strcmp(config.profiles[i].id, id) == 0) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+bool Storage::resetConfig() {
+    return true;
+}
+
+void Storage::setInputMode(InputMode inputMode) {
+    config.inputMode = inputMode;
+    configRevision++;
+}
+
+void Storage::setBootMode(BootMode bootMode) {
+    config.bootMode = bootMode;
+    configRevision++;
+}
+
+GamepadProfile* Storage::getGamepadProfile(char* id) {
+    const int8_t index = findProfileIndex(id);
+    return index < 0 ? nullptr : getProfileAt((uint8_t)index);
+}
+
+GamepadProfile* Storage::getDefaultGamepadProfile() {
+    return getGamepadProfile(config.defaultProfileId);
+}
+
+void Storage::registerDefaultProfileChangedCallback(DefaultProfileChangedCallback cb) {
+    if (!cb) return;
+    for (uint8_t i = 0; i < g_defaultProfileChangedCbCount; i++) {
+        if (g_defaultProfileChangedCbs[i] == cb) return;
+    }
+    if (g_defaultProfileChangedCbCount < 8) {
+        g_defaultProfileChangedCbs[g_defaultProfileChangedCbCount++] = cb;
+    }
+}
+
+bool Storage::setDefaultProfileId(const char* id) {
+    if (!id) return false;
+    if (strncmp(config.defaultProfileId, id, sizeof(config.defaultProfileId)) == 0) return false;
+    strncpy(config.defaultProfileId, id, sizeof(config.defaultProfileId) - 1);
+    config.defaultProfileId[sizeof(config.defaultProfileId) - 1] = '\0';
+    configRevision++;
+    notifyDefaultProfileChanged();
+    return true;
+}
+
+void Storage::refreshDefaultProfile() {
+    configRevision++;
+    notifyDefaultProfileChanged();
+}
+
+void Storage::notifyDefaultProfileChanged() {
+    for (uint8_t i = 0; i < g_defaultProfileChangedCbCount; i++) {
+        if (g_defaultProfileChangedCbs[i]) g_defaultProfileChangedCbs[i]();
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * 主机端仿真：WS2812B 驱动替身
+ * 只保存颜色与亮度缓冲，不生成 PWM/DMA 数据
+ */
+#include "pwm-ws2812b.h"
+#include "host_sim.h"
+
+static WS2812B_StateTypeDef WS2812B_State = WS2812B_STOP;
+static uint8_t LED_Colors[NUM_LED * 3];
+static uint8_t LED_Brightness[NUM_LED];
+
+void WS2812B_Init(void)
+{
+    memset(LED_Colors, 0, sizeof(LED_Colors));
+    memset(LED_Brightness, 128, sizeof(LED_Brightness));
+}
+
+void WS2812B_SetAllLEDBrightness(const uint8_t brightness)
+{
+    memset(LED_Brightness, brightness, sizeof(LED_Brightness));
+}
+
+void WS2812B_SetAllLEDColor(const uint8_t r, const uint8_t g, const uint8_t b)
+{
+    for (int i = 0; i < (int)(NUM_LED * 3); i += 3) {
+        LED_Colors[i] = r;
+        LED_Colors[i + 1] = g;
+        LED_Colors[i + 2] = b;
+    }
+}
+
+void WS2812B_SetLEDBrightness(const uint8_t brightness, const uint16_t index, const uint8_t length)
+{
+    if (index >= NUM_LED) return;
+    uint8_t actualLength = (index + length > NUM_LED) ? (NUM_LED - index) : length;
+    memset(&LED_Brightness[index], brightness, actualLength);
+}
+
+void WS2812B_SetLEDColor(const uint8_t r, const uint8_t g, const uint8_t b, const uint16_t index)
+{
+    if (index >= NUM_LED) return;
+    LED_Colors[index * 3] = r;
+    LED_Colors[index * 3 + 1] = g;
+    LED_Colors[index * 3 + 2] = b;
+}
+
+void WS2812B_SetLEDBrightnessByMask(const uint8_t fontBrightness, const uint8_t backgroundBrightness, const uint32_t mask)
+{
+    uint8_t len = NUM_LED > 32 ? 32 : NUM_LED;
+    for (uint8_t i = 0; i < len; i++) {
+        LED_Brightness[i] = ((mask >> i) & 1) ? fontBrightness : backgroundBrightness;
+    }
+}
+
+void WS2812B_SetLEDColorByMask(const struct RGBColor frontColor, const struct RGBColor backgroundColor, const uint32_t mask)
+{
+    uint8_t len = NUM_LED > 32 ? 32 : NUM_LED;
+    for (uint8_t i = 0; i < len; i++) {
+        const struct RGBColor& c = ((mask >> i) & 1) ? frontColor : backgroundColor;
+        WS2812B_SetLEDColor(c.r, c.g, c.b, i);
+    }
+}
+
+WS2812B_StateTypeDef WS2812B_Start()
+{
+    WS2812B_State = WS2812B_RUNNING;
+    return WS2812B_State;
+}
+
+WS2812B_StateTypeDef WS2812B_Stop()
+{
+    WS2812B_State = WS2812B_STOP;
+    return WS2812B_State;
+}
+
+WS2812B_StateTypeDef WS2812B_GetState()
+{
+    return WS2812B_State;
+}
+
+void WS2812B_Test()
+{
+}
+
+struct RGBColor host_ws2812b_get_output(uint16_t index)
+{
+    struct RGBColor c = {0, 0, 0};
+    if (index >= NUM_LED || WS2812B_State != WS2812B_RUNNING) return c;
+    double brightness = (double)LED_Brightness[index] / 255.0;
+    c.r = (uint8_t)round(LED_Colors[index * 3] * brightness);
+    c.g = (uint8_t)round(LED_Colors[index * 3 + 1] * brightness);
+    c.b = (uint8_t)round(LED_Colors[index * 3 + 2] * brightness);
+    return c;
+}
+
+bool host_ws2812b_is_running(void)
+{
+    return WS2812B_State == WS2812B_RUNNING;
+}
@@ -0,0 +1,9 @@
+/*
+ * 主机端仿真：lwIP 替身，见 tcp.h
+ */
+#ifndef __HOST_LWIP_PBUF_H__
+#define __HOST_LWIP_PBUF_H__
+
+struct pbuf;
+
+#endif /* __HOST_LWIP_PBUF_H__ */
@@ -0,0 +1,15 @@
+/*
+ * 主机端仿真：lwIP 替身
+ * 只提供 websocket_server.hpp 声明里用到的类型，使 config.cpp 等能在主机上编译；仿真工具不联网
+ */
+#ifndef __HOST_LWIP_TCP_H__
+#define __HOST_LWIP_TCP_H__
+
+#include <stdint.h>
+
+typedef int8_t err_t;
+typedef uint16_t u16_t;
+
+struct tcp_pcb;
+
+#endif /* __HOST_LWIP_TCP_H__ */
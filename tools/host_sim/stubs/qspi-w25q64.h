@@ -0,0 +1,30 @@
+/* 主机端仿真用的 qspi-w25q64.h 替身：只声明固件模块用到的读写接口，由 host_qspi.cpp 实现 */
+#ifndef __HOST_SIM_QSPI_W25Q64_H__
+#define __HOST_SIM_QSPI_W25Q64_H__
+
+#include "stm32h7xx_hal.h"
+#include "board_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QSPI_W25Qxx_OK           		0
+#define W25Qxx_ERROR_TRANSMIT         	-5
+
+#define W25Qxx_PageSize       			256
+#define W25Qxx_SECTOR_SIZE    			4096
+
+int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite);
+int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);
+int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void);
+bool QSPI_W25Qxx_IsMemoryMappedMode(void);
+
+typedef void (*QSPI_W25Qxx_MappedCallback)(void* context);
+bool QSPI_W25Qxx_RunWhenMapped(QSPI_W25Qxx_MappedCallback callback, void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_QSPI_W25Q64_H__ */
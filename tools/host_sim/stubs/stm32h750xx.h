@@ -0,0 +1,55 @@
+/*
+ * 主机端仿真用的 stm32h750xx.h 替身
+ * 仅提供 board_cfg.h 及 LED/屏幕模块编译所需的最小外设类型，不访问任何寄存器
+ */
+#ifndef __HOST_SIM_STM32H750XX_H
+#define __HOST_SIM_STM32H750XX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+
+typedef struct {
+    uint32_t dummy;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_sim_gpio[11];
+
+#define GPIOA (&host_sim_gpio[0])
+#define GPIOB (&host_sim_gpio[1])
+#define GPIOC (&host_sim_gpio[2])
+#define GPIOD (&host_sim_gpio[3])
+#define GPIOE (&host_sim_gpio[4])
+#define GPIOF (&host_sim_gpio[5])
+#define GPIOG (&host_sim_gpio[6])
+#define GPIOH (&host_sim_gpio[7])
+#define GPIOI (&host_sim_gpio[8])
+#define GPIOJ (&host_sim_gpio[9])
+#define GPIOK (&host_sim_gpio[10])
+
+/* 备份寄存器：屏幕模块用于跨复位传递菜单位置 */
+typedef struct {
+    __IO uint32_t BKP0R;
+    __IO uint32_t BKP1R;
+    __IO uint32_t BKP2R;
+    __IO uint32_t BKP3R;
+    __IO uint32_t BKP4R;
+    __IO uint32_t BKP5R;
+    __IO uint32_t BKP6R;
+    __IO uint32_t BKP7R;
+} RTC_TypeDef;
+
+extern RTC_TypeDef host_sim_rtc;
+
+#define RTC (&host_sim_rtc)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_STM32H750XX_H */
@@ -0,0 +1,7 @@
+/* 主机端仿真用的 stm32h7xx.h 替身 */
+#ifndef __HOST_SIM_STM32H7XX_H
+#define __HOST_SIM_STM32H7XX_H
+
+#include "stm32h7xx_hal.h"
+
+#endif /* __HOST_SIM_STM32H7XX_H */
@@ -0,0 +1,90 @@
+/*
+ * 主机端仿真用的 HAL 替身
+ * HAL_GetTick 由仿真器驱动的虚拟时钟提供，HAL_Delay 只推进虚拟时钟
+ */
+#ifndef __HOST_SIM_STM32H7XX_HAL_H
+#define __HOST_SIM_STM32H7XX_HAL_H
+
+#include "stm32h750xx.h"
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HAL_OK       = 0x00,
+    HAL_ERROR    = 0x01,
+    HAL_BUSY     = 0x02,
+    HAL_TIMEOUT  = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0                 ((uint16_t)0x0001)
+#define GPIO_PIN_1                 ((uint16_t)0x0002)
+#define GPIO_PIN_2                 ((uint16_t)0x0004)
+#define GPIO_PIN_3                 ((uint16_t)0x0008)
+#define GPIO_PIN_4                 ((uint16_t)0x0010)
+#define GPIO_PIN_5                 ((uint16_t)0x0020)
+#define GPIO_PIN_6                 ((uint16_t)0x0040)
+#define GPIO_PIN_7                 ((uint16_t)0x0080)
+#define GPIO_PIN_8                 ((uint16_t)0x0100)
+#define GPIO_PIN_9                 ((uint16_t)0x0200)
+#define GPIO_PIN_10                ((uint16_t)0x0400)
+#define GPIO_PIN_11                ((uint16_t)0x0800)
+#define GPIO_PIN_12                ((uint16_t)0x1000)
+#define GPIO_PIN_13                ((uint16_t)0x2000)
+#define GPIO_PIN_14                ((uint16_t)0x4000)
+#define GPIO_PIN_15                ((uint16_t)0x8000)
+
+#define ADC_CHANNEL_2              2u
+#define ADC_CHANNEL_3              3u
+#define ADC_CHANNEL_4              4u
+#define ADC_CHANNEL_6              6u
+#define ADC_CHANNEL_7              7u
+#define ADC_CHANNEL_8              8u
+#define ADC_CHANNEL_9              9u
+#define ADC_CHANNEL_11             11u
+#define ADC_CHANNEL_12             12u
+#define ADC_CHANNEL_13             13u
+#define ADC_CHANNEL_14             14u
+#define ADC_CHANNEL_15             15u
+
+#define ADC_REGULAR_RANK_1         1u
+#define ADC_REGULAR_RANK_2         2u
+#define ADC_REGULAR_RANK_3         3u
+#define ADC_REGULAR_RANK_4         4u
+#define ADC_REGULAR_RANK_5         5u
+#define ADC_REGULAR_RANK_6         6u
+
+/* 外设句柄只作为不透明指针传递，替身驱动不访问其成员 */
+typedef struct { void* Instance; } TIM_HandleTypeDef;
+typedef struct { void* Instance; } SPI_HandleTypeDef;
+typedef struct { void* Instance; } ADC_HandleTypeDef;
+
+static inline void SCB_CleanInvalidateDCache_by_Addr(volatile void* addr, int32_t dsize) { (void)addr; (void)dsize; }
+static inline void SCB_CleanDCache_by_Addr(volatile void* addr, int32_t dsize) { (void)addr; (void)dsize; }
+static inline void SCB_InvalidateDCache_by_Addr(volatile void* addr, int32_t dsize) { (void)addr; (void)dsize; }
+
+/* 复位请求交给仿真器处理（见 host_sim_set_reset_handler），未设置时直接退出进程 */
+void NVIC_SystemReset(void);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+
+/* 仿真器接口：设置/推进虚拟时钟 */
+void host_sim_set_tick(uint32_t tick);
+void host_sim_set_reset_handler(void (*handler)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_STM32H7XX_HAL_H */
@@ -0,0 +1,12 @@
+/* 主机端仿真用的 system_logger.h 替身：日志直接输出到 stderr */
+#ifndef __HOST_SIM_SYSTEM_LOGGER_H__
+#define __HOST_SIM_SYSTEM_LOGGER_H__
+
+#include <stdio.h>
+
+#define LOG_DEBUG(component, format, ...)   ((void)0)
+#define LOG_INFO(component, format, ...)    ((void)0)
+#define LOG_WARN(component, format, ...)    fprintf(stderr, "[WARN][%s] " format "\n", component, ##__VA_ARGS__)
+#define LOG_ERROR(component, format, ...)   fprintf(stderr, "[ERROR][%s] " format "\n", component, ##__VA_ARGS__)
+
+#endif /* __HOST_SIM_SYSTEM_LOGGER_H__ */
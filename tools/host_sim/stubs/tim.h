@@ -0,0 +1,7 @@
+/* 主机端仿真用的 tim.h 替身：WS2812B 驱动由 host_ws2812b.cpp 替代，不需要定时器句柄 */
+#ifndef __HOST_SIM_TIM_H__
+#define __HOST_SIM_TIM_H__
+
+#include "stm32h7xx_hal.h"
+
+#endif /* __HOST_SIM_TIM_H__ */
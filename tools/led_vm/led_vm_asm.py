@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+自定义灯效字节码汇编器
+
+将文本汇编（.lvs）编译为固件 LedVm 可加载的程序（.lvm）：LedVmProgramHeader + 字节码。
+指令集与 application/Cpp_Core/Inc/leds/led_vm.hpp 保持一致。
+
+用法:
+    python3 tools/led_vm/led_vm_asm.py examples/rainbow_wave.lvs -o rainbow_wave.lvm
+
+语法:
+    ; 注释
+    .name "rainbow"         程序名称，最长 16 字节
+    .budget 64              单个 LED 的指令预算，省略时使用固件上限
+    label:                  标签，供 jmp / jz 使用
+    push 300                按数值大小自动选择 push8 / push16 / push32
+    in time                 读取输入（见 INPUTS）
+    load r0 / store r0      寄存器 r0-r7
+    color 0                 配置颜色 0-2，压入 r g b
+    out                     弹出 r g b 并结束
+"""
+
+import argparse
+import struct
+import sys
+
+LED_VM_MAGIC = 0x314D564C
+LED_VM_VERSION = 1
+MAX_CODE_SIZE = 1024
+NUM_REGS = 8
+
+OPCODES = {
+    'end': 0x00, 'push8': 0x01, 'push16': 0x02, 'push32': 0x03,
+    'in': 0x04, 'load': 0x05, 'store': 0x06,
+    'dup': 0x07, 'drop': 0x08, 'swap': 0x09, 'over': 0x0A,
+    'add': 0x10, 'sub': 0x11, 'mul': 0x12, 'div': 0x13, 'mod': 0x14,
+    'neg': 0x15, 'abs': 0x16, 'min': 0x17, 'max': 0x18,
+    'and': 0x19, 'or': 0x1A, 'xor': 0x1B, 'shl': 0x1C, 'shr': 0x1D, 'not': 0x1E,
+    'lt': 0x20, 'le': 0x21, 'eq': 0x22,
+    'jmp': 0x28, 'jz': 0x29,
+    'sin8': 0x30, 'tri8': 0x31, 'scale8': 0x32, 'lerp8': 0x33, 'clamp8': 0x34,
+    'hsv': 0x35, 'rand8': 0x36, 'dist8': 0x37, 'color': 0x38,
+    'out': 0x3F,
+}
+
+INPUTS = {
+    'time': 0, 'index': 1, 'x': 2, 'y': 3, 'pressed': 4, 'travel': 5,
+    'speed': 6, 'frame': 7, 'is_around': 8, 'num_pressed': 9, 'num_led': 10,
+}
+
+
+class AsmError(Exception):
+    pass
+
+
+def fnv1a32(data):
+    h = 2166136261
+    for b in data:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def parse_int(text, line_no):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise AsmError(f'line {line_no}: invalid number "{text}"')
+
+
+def instruction_size(mnemonic, operand, line_no):
+    if mnemonic == 'push':
+        value = parse_int(operand, line_no)
+        if 0 <= value <= 0xFF:
+            return 2
+        if -0x8000 <= value <= 0x7FFF:
+            return 3
+        return 5
+    size = {'push8': 2, 'push16': 3, 'push32': 5, 'in': 2, 'load': 2, 'store': 2,
+            'color': 2, 'jmp': 3, 'jz': 3}
+    return size.get(mnemonic, 1)
+
+
+def assemble(source):
+    name = ''
+    budget = 0
+    lines = []
+    labels = {}
+    pc = 0
+
+    # 第一遍：解析并计算标签地址
+    for line_no, raw in enumerate(source.splitlines(), 1):
+        text = raw.split(';', 1)[0].strip()
+        if not text:
+            continue
+        if text.startswith('.name'):
+            name = text[len('.name'):].strip().strip('"')
+            if len(name.encode('utf-8')) > 16:
+                raise AsmError(f'line {line_no}: name longer than 16 bytes')
+            continue
+        if text.startswith('.budget'):
+            budget = parse_int(text[len('.budget'):].strip(), line_no)
+            continue
+        while ':' in text:
+            label, text = text.split(':', 1)
+            label = label.strip()
+            if label in labels:
+                raise AsmError(f'line {line_no}: duplicate label "{label}"')
+            labels[label] = pc
+            text = text.strip()
+        if not text:
+            continue
+        parts = text.split()
+        mnemonic = parts[0].lower()
+        operand = parts[1] if len(parts) > 1 else None
+        if mnemonic not in OPCODES and mnemonic != 'push':
+            raise AsmError(f'line {line_no}: unknown instruction "{mnemonic}"')
+        needs_operand = mnemonic in ('push', 'push8', 'push16', 'push32', 'in', 'load', 'store', 'color', 'jmp', 'jz')
+        if needs_operand != (operand is not None) or len(parts) > 2:
+            raise AsmError(f'line {line_no}: bad operands for "{mnemonic}"')
+        lines.append((line_no, mnemonic, operand, pc))
+        pc += instruction_size(mnemonic, operand, line_no)
+
+    # 第二遍：生成字节码
+    code = bytearray()
+    for line_no, mnemonic, operand, addr in lines:
+        if mnemonic == 'push':
+            value = parse_int(operand, line_no)
+            if 0 <= value <= 0xFF:
+                code += bytes([OPCODES['push8'], value])
+            elif -0x8000 <= value <= 0x7FFF:
+                code += bytes([OPCODES['push16']]) + struct.pack('<h', value)
+            else:
+                code += bytes([OPCODES['push32']]) + struct.pack('<i', value)
+        elif mnemonic == 'push8':
+            code += bytes([OPCODES[mnemonic], parse_int(operand, line_no) & 0xFF])
+        elif mnemonic == 'push16':
+            code += bytes([OPCODES[mnemonic]]) + struct.pack('<h', parse_int(operand, line_no))
+        elif mnemonic == 'push32':
+            code += bytes([OPCODES[mnemonic]]) + struct.pack('<i', parse_int(operand, line_no))
+        elif mnemonic == 'in':
+            if operand.lower() not in INPUTS:
+                raise AsmError(f'line {line_no}: unknown input "{operand}"')
+            code += bytes([OPCODES[mnemonic], INPUTS[operand.lower()]])
+        elif mnemonic in ('load', 'store'):
+            reg = operand.lower()
+            if not reg.startswith('r') or not reg[1:].isdigit() or int(reg[1:]) >= NUM_REGS:
+                raise AsmError(f'line {line_no}: bad register "{operand}"')
+            code += bytes([OPCODES[mnemonic], int(reg[1:])])
+        elif mnemonic == 'color':
+            index = parse_int(operand, line_no)
+            if not 0 <= index <= 2:
+                raise AsmError(f'line {line_no}: color index must be 0-2')
+            code += bytes([OPCODES[mnemonic], index])
+        elif mnemonic in ('jmp', 'jz'):
+            if operand not in labels:
+                raise AsmError(f'line {line_no}: unknown label "{operand}"')
+            offset = labels[operand] - (addr + 3)
+            code += bytes([OPCODES[mnemonic]]) + struct.pack('<h', offset)
+        else:
+            code.append(OPCODES[mnemonic])
+
+    if not code:
+        raise AsmError('empty program')
+    if len(code) > MAX_CODE_SIZE:
+        raise AsmError(f'code size {len(code)} exceeds {MAX_CODE_SIZE}')
+
+    header = struct.pack('<IBBHHHI16s', LED_VM_MAGIC, LED_VM_VERSION, 0, len(code), budget, 0,
+                         fnv1a32(code), name.encode('utf-8'))
+    return header + bytes(code)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='LED 字节码汇编器')
+    parser.add_argument('source', help='汇编源文件 (.lvs)')
+    parser.add_argument('-o', '--output', help='输出文件 (.lvm)，默认与源文件同名')
+    args = parser.parse_args()
+
+    output = args.output or (args.source.rsplit('.', 1)[0] + '.lvm')
+    with open(args.source, 'r', encoding='utf-8') as f:
+        source = f.read()
+    try:
+        program = assemble(source)
+    except AsmError as e:
+        print(f'{args.source}: {e}', file=sys.stderr)
+        return 1
+    with open(output, 'wb') as f:
+        f.write(program)
+    print(f'{output}: {len(program) - 32} bytes of code')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
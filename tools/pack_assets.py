@@ -3,6 +3,7 @@
 
 import argparse
 import binascii
+import json
 import os
 import re
 import struct
@@ -10,10 +11,12 @@ from pathlib import Path
 from typing import Optional, Tuple, List
 
 try:
-    from PIL import Image, ImageSequence
+    from PIL import Image, ImageSequence, ImageDraw, ImageFont
 except Exception:
     Image = None
     ImageSequence = None
+    ImageDraw = None
+    ImageFont = None
 
 sys_path_added = False
 try:
@@ -31,18 +34,35 @@ except Exception:
 try:
     from firmware_metadata import USER_IMAGE_RESOURCES_SIZE
 except Exception:
-    USER_IMAGE_RESOURCES_SIZE = 0x210000
+    USER_IMAGE_RESOURCES_SIZE = 0x200000
 
 
 MAGIC = b'HIMG'
-VERSION = 1
+# 版本 2：索引按名称哈希排序，固件二分查找；条目增加名称哈希和解压后大小
+VERSION = 2
 
 TYPE_GIF = 1
 TYPE_RGB565LE = 2
+TYPE_RGB565LE_PACKED = 3
+TYPE_FONT = 4
+
+# TYPE_RGB565LE_PACKED 的压缩方式，写在条目第 33 字节
+CODEC_RLE = 1
+CODEC_LZ = 2
+
+# LZ 以像素为单位，必须与固件 ST7789_ASSETS_LZ_WINDOW / ST7789_ASSETS_LZ_MIN_MATCH 一致
+LZ_WINDOW = 4096
+LZ_MIN_MATCH = 2
+LZ_MAX_CHAIN = 16
 
 ENTRY_NAME_LEN = 32
 ENTRY_SIZE = 64
 
+# 字体：文件头 "HFN1" + 行高 + 基线 + 字形数 + 位图区偏移，每个字形 16 字节，位图 4 bpp
+FONT_MAGIC = b'HFN1'
+FONT_HEADER_SIZE = 16
+FONT_GLYPH_SIZE = 16
+
 
 def _align_up(v: int, a: int) -> int:
     return (v + (a - 1)) & ~(a - 1)
@@ -60,7 +80,7 @@ def _gif_get_canvas_size(data: bytes):
     return w, h
 
 
-_re_dim = re.compile(r'^(?P<name>.+?)[_\\-](?P<w>\\d{1,4})x(?P<h>\\d{1,4})$', re.IGNORECASE)
+_re_dim = re.compile(r'^(?P<name>.+?)[_\-](?P<w>\d{1,4})x(?P<h>\d{1,4})$', re.IGNORECASE)
 
 
 def _parse_rgb565_name(stem: str):
@@ -73,13 +93,195 @@ def _parse_rgb565_name(stem: str):
     return name, w, h
 
 
+def name_hash(name: str) -> int:
+    """FNV-1a，与固件 st7789_assets_name_hash 一致"""
+    h = 2166136261
+    for b in name.encode('utf-8')[:ENTRY_NAME_LEN]:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def _pixels(data: bytes) -> List[int]:
+    return list(struct.unpack('<%dH' % (len(data) // 2), data))
+
+
+def rle_compress(data: bytes) -> bytes:
+    """控制字节最高位为 1：后跟 1 个像素重复 (c & 0x7F) + 1 次；否则后跟 c + 1 个原样像素"""
+    px = _pixels(data)
+    n = len(px)
+    out = bytearray()
+    i = 0
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and px[i + run] == px[i]:
+            run += 1
+        if run >= 2:
+            out.append(0x80 | (run - 1))
+            out += struct.pack('<H', px[i])
+            i += run
+            continue
+        j = i + 1
+        while j < n and j - i < 128 and not (j + 1 < n and px[j + 1] == px[j]):
+            j += 1
+        out.append(j - i - 1)
+        out += struct.pack('<%dH' % (j - i), *px[i:j])
+        i = j
+    return bytes(out)
+
+
+def _lz_put_length(out: bytearray, v: int):
+    while v >= 255:
+        out.append(255)
+        v -= 255
+    out.append(v)
+
+
+def lz_compress(data: bytes) -> bytes:
+    """LZ4 块格式的令牌结构，长度和偏移以像素为单位，贪心匹配 + 短哈希链"""
+    px = _pixels(data)
+    n = len(px)
+    out = bytearray()
+    chains = {}
+
+    def emit(lit_start: int, lit_end: int, offset: int, match_len: int):
+        lit = lit_end - lit_start
+        m = match_len - LZ_MIN_MATCH if match_len else 0
+        out.append((min(lit, 15) << 4) | min(m, 15))
+        if lit >= 15:
+            _lz_put_length(out, lit - 15)
+        out.extend(struct.pack('<%dH' % lit, *px[lit_start:lit_end]))
+        if match_len:
+            out.extend(struct.pack('<H', offset))
+            if m >= 15:
+                _lz_put_length(out, m - 15)
+
+    def insert(pos: int):
+        if pos + LZ_MIN_MATCH > n:
+            return
+        key = (px[pos], px[pos + 1])
+        chain = chains.setdefault(key, [])
+        chain.append(pos)
+        if len(chain) > LZ_MAX_CHAIN:
+            del chain[0]
+
+    anchor = 0
+    i = 0
+    while i + LZ_MIN_MATCH <= n:
+        best_len = 0
+        best_off = 0
+        for cand in reversed(chains.get((px[i], px[i + 1]), ())):
+            off = i - cand
+            if off > LZ_WINDOW:
+                break
+            length = 0
+            while i + length < n and px[cand + length] == px[i + length]:
+                length += 1
+            if length > best_len:
+                best_len = length
+                best_off = off
+        if best_len >= LZ_MIN_MATCH:
+            emit(anchor, i, best_off, best_len)
+            for k in range(i, i + best_len):
+                insert(k)
+            i += best_len
+            anchor = i
+        else:
+            insert(i)
+            i += 1
+    if anchor < n:
+        emit(anchor, n, 0, 0)
+    return bytes(out)
+
+
+def pack_rgb565(data: bytes, compress: bool):
+    """选择体积最小的编码，返回 (type, codec, payload)"""
+    best = (TYPE_RGB565LE, 0, data)
+    if not compress:
+        return best
+    for codec, fn in ((CODEC_RLE, rle_compress), (CODEC_LZ, lz_compress)):
+        packed = fn(data)
+        if len(packed) < len(best[2]):
+            best = (TYPE_RGB565LE_PACKED, codec, packed)
+    return best
+
+
+def _font_chars(cfg: dict, base: Path) -> List[int]:
+    """字符集：ranges（闭区间，默认可打印 ASCII）+ chars 字符串 + chars_file 文本文件中出现的字符"""
+    cps = set()
+    for lo, hi in cfg.get('ranges', [[0x20, 0x7E]]):
+        cps.update(range(int(lo), int(hi) + 1))
+    cps.update(ord(c) for c in cfg.get('chars', ''))
+    if cfg.get('chars_file'):
+        cps.update(ord(c) for c in (base / cfg['chars_file']).read_text(encoding='utf-8'))
+    return sorted(c for c in cps if c >= 0x20 and c != 0x7F and c <= 0x10FFFF)
+
+
+def build_font(cfg_path: Path):
+    """按 *.font.json 光栅化 TTF/OTF，返回 (name, line_height, max_advance, payload)
+
+    配置字段：file 字体文件（相对配置文件），size 字号像素，line_height 行高（默认取字体上下伸之和），
+    name 资源名（默认为配置文件名去掉 .font.json），ranges / chars / chars_file 字符集。
+    字形裁剪到 [0, 步进) x [0, 行高) 的字符格内，固件可以逐格整行写入而不必处理重叠。
+    """
+    if ImageFont is None:
+        raise RuntimeError("Pillow is required to pack fonts. Please install pillow.")
+    cfg = json.loads(cfg_path.read_text(encoding='utf-8'))
+    base = cfg_path.parent
+    name = cfg.get('name') or cfg_path.name[:-len('.font.json')]
+    font = ImageFont.truetype(str(base / cfg['file']), int(cfg['size']))
+    ascent, descent = font.getmetrics()
+    line_height = int(cfg.get('line_height', ascent + descent))
+    if line_height <= 0 or line_height > 255:
+        raise ValueError(f"Invalid font line height {line_height}: {cfg_path}")
+    baseline = ascent + (line_height - ascent - descent) // 2
+
+    glyphs = []
+    bitmaps = bytearray()
+    for cp in _font_chars(cfg, base):
+        ch = chr(cp)
+        adv = int(round(font.getlength(ch)))
+        if adv <= 0:
+            continue
+        if adv > 255:
+            raise ValueError(f"Glyph U+{cp:04X} too wide ({adv}px): {cfg_path}")
+        pad = line_height
+        img = Image.new('L', (adv + pad * 2, line_height), 0)
+        ImageDraw.Draw(img).text((pad, baseline), ch, font=font, fill=255, anchor='ls')
+        cell = img.crop((pad, 0, pad + adv, line_height))
+        bbox = cell.getbbox()
+        if bbox is None:
+            glyphs.append((cp, 0, 0, 0, 0, 0, adv))
+            continue
+        x0, y0, x1, y1 = bbox
+        w = x1 - x0
+        h = y1 - y0
+        px = cell.crop(bbox).tobytes()
+        offset = len(bitmaps)
+        for y in range(h):
+            row = [(v * 15 + 127) // 255 for v in px[y * w:(y + 1) * w]]
+            if w & 1:
+                row.append(0)
+            bitmaps += bytes((row[i] << 4) | row[i + 1] for i in range(0, len(row), 2))
+        glyphs.append((cp, offset, w, h, x0, y0, adv))
+
+    if not glyphs:
+        raise ValueError(f"Font has no glyphs: {cfg_path}")
+    bitmap_offset = FONT_HEADER_SIZE + len(glyphs) * FONT_GLYPH_SIZE
+    out = bytearray(struct.pack('<4sHHII', FONT_MAGIC, line_height, baseline, len(glyphs), bitmap_offset))
+    for g in glyphs:
+        out += struct.pack('<IIBBBBB3x', *g)
+    out += bitmaps
+    return name, line_height, max(g[6] for g in glyphs), bytes(out)
+
+
 def _iter_files(root: Path):
     for p in sorted(root.rglob('*')):
         if p.is_file():
             yield p
 
 
-def build_pack(input_dir: Path, output_file: Path, max_size: int):
+def build_pack(input_dir: Path, output_file: Path, max_size: int, compress: bool = True):
     assets = []
 
     for p in _iter_files(input_dir):
@@ -94,9 +296,22 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
             assets.append({
                 'name': name,
                 'type': TYPE_GIF,
+                'codec': 0,
                 'width': w,
                 'height': h,
                 'data': data,
+                'raw_size': len(data),
+            })
+        elif p.name.lower().endswith('.font.json'):
+            name, line_height, max_adv, data = build_font(p)
+            assets.append({
+                'name': name,
+                'type': TYPE_FONT,
+                'codec': 0,
+                'width': max_adv,
+                'height': line_height,
+                'data': data,
+                'raw_size': len(data),
             })
         elif ext in ('.rgb565', '.rgb565le', '.raw'):
             parsed = _parse_rgb565_name(p.stem)
@@ -106,12 +321,15 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
             data = p.read_bytes()
             if len(data) != w * h * 2:
                 raise ValueError(f"RGB565 size mismatch for {p}: expect {w*h*2} bytes, got {len(data)}")
+            asset_type, codec, payload = pack_rgb565(data, compress)
             assets.append({
                 'name': name,
-                'type': TYPE_RGB565LE,
+                'type': asset_type,
+                'codec': codec,
                 'width': w,
                 'height': h,
-                'data': data,
+                'data': payload,
+                'raw_size': len(data),
             })
 
     if not assets:
@@ -119,7 +337,7 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
         header = struct.pack('<4sHHIIII', MAGIC, VERSION, 0, 0, 0, 0, 0)
         header = header.ljust(64, b'\x00')
         output_file.write_bytes(header)
-        return {'count': 0, 'total': len(header)}
+        return {'count': 0, 'total': len(header), 'raw': 0}
 
     names = set()
     for a in assets:
@@ -130,6 +348,9 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
             raise ValueError(f"Duplicate asset name: {n}")
         names.add(n)
 
+    # 固件按哈希二分查找，索引必须按 (哈希, 名称) 排序
+    assets.sort(key=lambda a: (name_hash(a['name']), a['name'].encode('utf-8')))
+
     header_size = 64
     index_size = _align_up(len(assets) * ENTRY_SIZE, 16)
     data_offset = header_size + index_size
@@ -147,6 +368,8 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
         entries.append({
             'name': a['name'],
             'type': a['type'],
+            'codec': a['codec'],
+            'raw_size': a['raw_size'],
             'offset': offset,
             'size': size,
             'width': a['width'],
@@ -179,16 +402,18 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
         name_bytes = e['name'].encode('utf-8')
         name_bytes = name_bytes + b'\x00' * (ENTRY_NAME_LEN - len(name_bytes))
         packed = struct.pack(
-            '<32sBBHIIHHI',
+            '<32sBBHIIHHIII',
             name_bytes,
             e['type'],
-            0,
+            e['codec'],
             0,
             e['offset'],
             e['size'],
             e['width'],
             e['height'],
-            e['crc32']
+            e['crc32'],
+            name_hash(e['name']),
+            e['raw_size']
         )
         index += packed
         if len(packed) < ENTRY_SIZE:
@@ -214,7 +439,8 @@ def build_pack(input_dir: Path, output_file: Path, max_size: int):
         out += b'\x00' * (total_size - len(out))
 
     output_file.write_bytes(out)
-    return {'count': len(entries), 'total': total_size}
+    raw_total = sum(e['raw_size'] for e in entries)
+    return {'count': len(entries), 'total': total_size, 'raw': raw_total}
 
 
 def _clamp_int(v: int, lo: int, hi: int) -> int:
@@ -422,6 +648,7 @@ def main():
     parser.add_argument('--icons-dir', help='icons directory to pack into HIMG')
     parser.add_argument('--icons-output', help='output bin for icons pack')
     parser.add_argument('--icons-max-size', type=lambda x: int(x, 0), default=SYS_IMAGE_RESOURCES_SIZE)
+    parser.add_argument('--no-compress', action='store_true', help='store RGB565 assets uncompressed')
     parser.add_argument('--sysbg-dir', help='sysbg directory containing sysbg.(png|jpg|jpeg|gif)')
     parser.add_argument('--sysbg-output', help='output bin for sysbg (UserImageIndexHeader v2 + frames)')
     parser.add_argument('--sysbg-max-size', type=lambda x: int(x, 0), default=USER_IMAGE_RESOURCES_SIZE)
@@ -436,8 +663,8 @@ def main():
     if icons_dir and icons_out:
         if not icons_dir.exists():
             raise SystemExit(f"Icons dir not found: {icons_dir}")
-        res = build_pack(icons_dir, icons_out, int(args.icons_max_size))
-        print(f"Packed {res['count']} assets -> {icons_out} ({res['total']} bytes)")
+        res = build_pack(icons_dir, icons_out, int(args.icons_max_size), not args.no_compress)
+        print(f"Packed {res['count']} assets -> {icons_out} ({res['total']} bytes, {res['raw']} bytes uncompressed)")
 
     if args.sysbg_output:
         sysbg_dir = Path(args.sysbg_dir) if args.sysbg_dir else None